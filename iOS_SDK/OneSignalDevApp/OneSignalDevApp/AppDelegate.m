@@ -31,6 +31,17 @@
 #import "AppDelegate.h"
 #import "ViewController.h"
 #import "OneSignalExample-Swift.h"
+#import <os/signpost.h>
+
+// Launch configuration hooks used by OneSignalExampleLaunchTests.
+// Passed by XCUIApplication as launch arguments / environment so the same build can be
+// measured cold with no cache, warm with a large cached operation queue, and with IAMs on or off.
+#define OS_LAUNCH_ARG_CLEAR_CACHE @"-OSLaunchClearCache"
+#define OS_LAUNCH_ARG_ENABLE_IAMS @"-OSLaunchEnableIAMs"
+#define OS_LAUNCH_ENV_SEED_TAGS @"OS_LAUNCH_SEED_TAGS"
+// Must match the signpost the launch tests measure with XCTOSSignpostMetric.
+#define OS_LAUNCH_SIGNPOST_SUBSYSTEM "com.onesignal.devapp"
+#define OS_LAUNCH_SIGNPOST_CATEGORY "Launch"
 
 @interface OneSignalNotificationCenterDelegate: NSObject<UNUserNotificationCenterDelegate>
 @end
@@ -54,7 +65,22 @@ OneSignalNotificationCenterDelegate *_notificationDelegate;
     [OneSignal.Debug setLogLevel:ONE_S_LL_VERBOSE];
     [OneSignal.Debug setAlertLevel:ONE_S_LL_NONE];
     
+    NSArray<NSString *> *launchArguments = [[NSProcessInfo processInfo] arguments];
+    if ([launchArguments containsObject:OS_LAUNCH_ARG_CLEAR_CACHE]) {
+        [AppDelegate clearOneSignalCache];
+    }
+    
+    // Brackets the SDK's own share of launch so it can be separated from the app's.
+    os_log_t launchLog = os_log_create(OS_LAUNCH_SIGNPOST_SUBSYSTEM, OS_LAUNCH_SIGNPOST_CATEGORY);
+    os_signpost_id_t launchSignpost = os_signpost_id_generate(launchLog);
+    os_signpost_interval_begin(launchLog, launchSignpost, "OneSignalInit");
     [OneSignal initialize:[AppDelegate getOneSignalAppId] withLaunchOptions:launchOptions];
+    os_signpost_interval_end(launchLog, launchSignpost, "OneSignalInit");
+    
+    NSInteger seedTagCount = [[[NSProcessInfo processInfo] environment][OS_LAUNCH_ENV_SEED_TAGS] integerValue];
+    if (seedTagCount > 0) {
+        [AppDelegate seedOperationQueueWithTagCount:seedTagCount];
+    }
     
     _notificationDelegate = [OneSignalNotificationCenterDelegate new];
     
@@ -62,7 +88,7 @@ OneSignalNotificationCenterDelegate *_notificationDelegate;
     [OneSignal setProvidesNotificationSettingsView:NO];
     
     [OneSignal.InAppMessages addLifecycleListener:self];
-    [OneSignal.InAppMessages paused:true];
+    [OneSignal.InAppMessages paused:![launchArguments containsObject:OS_LAUNCH_ARG_ENABLE_IAMS]];
 
     [OneSignal.Notifications addForegroundLifecycleListener:self];
     [OneSignal.Notifications addClickListener:self];
@@ -97,6 +123,22 @@ OneSignalNotificationCenterDelegate *_notificationDelegate;
     return ONESIGNAL_APP_ID_DEFAULT;
 }
 
++ (void)clearOneSignalCache {
+    NSString *appId = [[NSUserDefaults standardUserDefaults] objectForKey:ONESIGNAL_APP_ID_KEY_FOR_TESTING];
+    [[NSUserDefaults standardUserDefaults] removePersistentDomainForName:[[NSBundle mainBundle] bundleIdentifier]];
+    if (appId) {
+        [AppDelegate setOneSignalAppId:appId];
+    }
+}
+
++ (void)seedOperationQueueWithTagCount:(NSInteger)count {
+    NSMutableDictionary *tags = [NSMutableDictionary dictionaryWithCapacity:count];
+    for (NSInteger i = 0; i < count; i++) {
+        tags[[NSString stringWithFormat:@"launch_seed_%ld", (long)i]] = [NSString stringWithFormat:@"%ld", (long)i];
+    }
+    [OneSignal.User addTags:tags];
+}
+
 + (void) setOneSignalAppId:(NSString*)onesignalAppId {
     [[NSUserDefaults standardUserDefaults] setObject:onesignalAppId forKey:ONESIGNAL_APP_ID_KEY_FOR_TESTING];
     [[NSUserDefaults standardUserDefaults] synchronize];
@@ -0,0 +1,87 @@
+/*
+ Modified MIT License
+
+ Copyright 2024 OneSignal
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ 1. The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ 2. All copies of substantial portions of the Software may only be used in connection
+ with services provided by OneSignal.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ */
+
+import XCTest
+
+/**
+ Launch-time benchmarks for the dev app, run under each SDK configuration we care about.
+ `XCTApplicationLaunchMetric` reports total app launch, and the `OneSignalInit` signpost
+ emitted by AppDelegate reports the share of it attributable to `OneSignal.initialize`.
+ Run these against the Release configuration on a device for representative numbers.
+ */
+final class LaunchPerformanceTests: XCTestCase {
+    private let clearCacheArgument = "-OSLaunchClearCache"
+    private let enableIAMsArgument = "-OSLaunchEnableIAMs"
+    private let seedTagsEnvironmentKey = "OS_LAUNCH_SEED_TAGS"
+    private let largeQueueTagCount = 500
+
+    private let sdkInitMetric = XCTOSSignpostMetric(subsystem: "com.onesignal.devapp", category: "Launch", name: "OneSignalInit")
+
+    override func setUpWithError() throws {
+        continueAfterFailure = false
+    }
+
+    /// Cold launch with no cached user, subscription, or operation queue.
+    func testColdLaunchNoCache() throws {
+        measureLaunch(arguments: [clearCacheArgument])
+    }
+
+    /// Cold launch with no cache and IAMs unpaused, so in-app message fetching and evaluation run at startup.
+    func testColdLaunchNoCacheWithIAMs() throws {
+        measureLaunch(arguments: [clearCacheArgument, enableIAMsArgument])
+    }
+
+    /// Warm launch after a previous session left a large queue of tag deltas cached.
+    func testWarmLaunchWithLargeCachedQueue() throws {
+        seedCachedQueue()
+        measureLaunch(arguments: [])
+    }
+
+    /// Warm launch with a large cached queue and IAMs unpaused.
+    func testWarmLaunchWithLargeCachedQueueWithIAMs() throws {
+        seedCachedQueue()
+        measureLaunch(arguments: [enableIAMsArgument])
+    }
+
+    /// Launches the app once to enqueue `largeQueueTagCount` tag deltas, then terminates so they are persisted for the measured launches.
+    private func seedCachedQueue() {
+        let app = XCUIApplication()
+        app.launchArguments = [clearCacheArgument]
+        app.launchEnvironment = [seedTagsEnvironmentKey: String(largeQueueTagCount)]
+        app.launch()
+        app.terminate()
+    }
+
+    private func measureLaunch(arguments: [String]) {
+        let app = XCUIApplication()
+        app.launchArguments = arguments
+        measure(metrics: [XCTApplicationLaunchMetric(), sdkInitMetric]) {
+            app.launch()
+            app.terminate()
+        }
+    }
+}
@@ -0,0 +1,57 @@
+/**
+ * Modified MIT License
+ *
+ * Copyright 2024 OneSignal
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * 2. All copies of substantial portions of the Software may only be used in connection
+ * with services provided by OneSignal.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+typedef void (^OSBackgroundUploadCompletion)(NSData * _Nullable data, NSURLResponse * _Nullable response, NSError * _Nullable error);
+
+/**
+ Sends deferrable requests, such as session time and outcomes, as file-backed uploads on a background NSURLSession.
+ The system finishes these uploads even if the app is suspended or terminated, so they no longer need a
+ background task assertion to beat the end of the background window.
+ Completions are only delivered while the process that made the upload is alive.
+ */
+@interface OSBackgroundUploadSession : NSObject
+
++ (OSBackgroundUploadSession *)sharedSession;
+
+- (void)uploadRequest:(NSURLRequest *)urlRequest completion:(OSBackgroundUploadCompletion)completion;
+
+// The system holds the upload until `earliestBeginDate`, without the process having to stay alive
+- (void)uploadRequest:(NSURLRequest *)urlRequest earliestBeginDate:(NSDate * _Nullable)earliestBeginDate completion:(OSBackgroundUploadCompletion)completion;
+
+// Uploads with a key can be cancelled with cancelUploadsWithKey: until they complete
+- (void)uploadRequest:(NSURLRequest *)urlRequest earliestBeginDate:(NSDate * _Nullable)earliestBeginDate key:(NSString * _Nullable)key completion:(OSBackgroundUploadCompletion)completion;
+
+// Their completion is called with NSURLErrorCancelled
+- (void)cancelUploadsWithKey:(NSString *)key;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,170 @@
+/**
+ * Modified MIT License
+ *
+ * Copyright 2024 OneSignal
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * 2. All copies of substantial portions of the Software may only be used in connection
+ * with services provided by OneSignal.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#import "OSBackgroundUploadSession.h"
+#import "OneSignalCommonDefines.h"
+#import "OneSignalLog.h"
+#import "OneSignalUserDefaults.h"
+
+@interface OSBackgroundUploadSession () <NSURLSessionDataDelegate>
+@property (strong, nonatomic) NSURLSession *session;
+@property (strong, nonatomic) NSURL *uploadsDirectory;
+// Keyed by task identifier. Access is synchronized on `completions`.
+@property (strong, nonatomic) NSMutableDictionary<NSNumber *, OSBackgroundUploadCompletion> *completions;
+@property (strong, nonatomic) NSMutableDictionary<NSNumber *, NSMutableData *> *responseData;
+@property (strong, nonatomic) NSMutableDictionary<NSString *, NSMutableArray<NSURLSessionTask *> *> *keyedTasks;
+@end
+
+@implementation OSBackgroundUploadSession
+
++ (OSBackgroundUploadSession *)sharedSession {
+    static OSBackgroundUploadSession *sharedSession = nil;
+    static dispatch_once_t once;
+    dispatch_once(&once, ^{
+        sharedSession = [OSBackgroundUploadSession new];
+    });
+    return sharedSession;
+}
+
+- (instancetype)init {
+    if (self = [super init]) {
+        _completions = [NSMutableDictionary new];
+        _responseData = [NSMutableDictionary new];
+        _keyedTasks = [NSMutableDictionary new];
+        NSString *appGroupName = [OneSignalUserDefaults appGroupName];
+        // Body files go in the app group container, the system cannot read an extension's own Caches once it exits
+        NSURL *container = [NSFileManager.defaultManager containerURLForSecurityApplicationGroupIdentifier:appGroupName]
+            ?: [NSFileManager.defaultManager URLsForDirectory:NSCachesDirectory inDomains:NSUserDomainMask].firstObject;
+        _uploadsDirectory = [container URLByAppendingPathComponent:OS_BACKGROUND_UPLOAD_DIRECTORY isDirectory:YES];
+        [NSFileManager.defaultManager createDirectoryAtURL:_uploadsDirectory withIntermediateDirectories:YES attributes:nil error:nil];
+        
+        NSString *identifier = OS_BACKGROUND_UPLOAD_SESSION_ID;
+        if ([NSBundle.mainBundle.bundleURL.pathExtension isEqualToString:@"appex"]) {
+            // Extensions need their own identifier, the app and the NSE cannot share one session
+            identifier = [NSString stringWithFormat:@"%@.%@", OS_BACKGROUND_UPLOAD_SESSION_ID, NSBundle.mainBundle.bundleIdentifier];
+        }
+        NSURLSessionConfiguration *configuration = [NSURLSessionConfiguration backgroundSessionConfigurationWithIdentifier:identifier];
+        // Without a shared container the system fails background transfers started from an extension
+        configuration.sharedContainerIdentifier = appGroupName;
+        // Not discretionary, session end data should still go out promptly when the app is in the foreground
+        configuration.discretionary = NO;
+        configuration.sessionSendsLaunchEvents = NO;
+        configuration.timeoutIntervalForResource = OS_BACKGROUND_UPLOAD_TIMEOUT;
+        // Reconnecting to an existing identifier also picks up uploads left over from a previous launch
+        _session = [NSURLSession sessionWithConfiguration:configuration delegate:self delegateQueue:nil];
+    }
+    return self;
+}
+
+- (void)uploadRequest:(NSURLRequest *)urlRequest completion:(OSBackgroundUploadCompletion)completion {
+    [self uploadRequest:urlRequest earliestBeginDate:nil completion:completion];
+}
+
+- (void)uploadRequest:(NSURLRequest *)urlRequest earliestBeginDate:(NSDate *)earliestBeginDate completion:(OSBackgroundUploadCompletion)completion {
+    [self uploadRequest:urlRequest earliestBeginDate:earliestBeginDate key:nil completion:completion];
+}
+
+- (void)uploadRequest:(NSURLRequest *)urlRequest earliestBeginDate:(NSDate *)earliestBeginDate key:(NSString *)key completion:(OSBackgroundUploadCompletion)completion {
+    NSURL *bodyFile = [self.uploadsDirectory URLByAppendingPathComponent:NSUUID.UUID.UUIDString];
+    NSError *error;
+    if (![(urlRequest.HTTPBody ?: [NSData data]) writeToURL:bodyFile options:NSDataWritingAtomic error:&error]) {
+        completion(nil, nil, error);
+        return;
+    }
+    
+    NSMutableURLRequest *uploadRequest = [urlRequest mutableCopy];
+    uploadRequest.HTTPBody = nil;
+    NSURLSessionUploadTask *task = [self.session uploadTaskWithRequest:uploadRequest fromFile:bodyFile];
+    // Lets the body file be cleaned up on completion, even by a later launch
+    task.taskDescription = bodyFile.path;
+    if (earliestBeginDate) {
+        task.earliestBeginDate = earliestBeginDate;
+    }
+    
+    @synchronized (self.completions) {
+        self.completions[@(task.taskIdentifier)] = completion;
+        if (key) {
+            NSMutableArray<NSURLSessionTask *> *tasks = self.keyedTasks[key] ?: [NSMutableArray new];
+            [tasks addObject:task];
+            self.keyedTasks[key] = tasks;
+        }
+    }
+    [task resume];
+}
+
+- (void)cancelUploadsWithKey:(NSString *)key {
+    NSArray<NSURLSessionTask *> *tasks;
+    @synchronized (self.completions) {
+        tasks = self.keyedTasks[key];
+        [self.keyedTasks removeObjectForKey:key];
+    }
+    for (NSURLSessionTask *task in tasks) {
+        [task cancel];
+    }
+}
+
+#pragma mark NSURLSessionDataDelegate
+
+- (void)URLSession:(NSURLSession *)session dataTask:(NSURLSessionDataTask *)dataTask didReceiveData:(NSData *)data {
+    @synchronized (self.completions) {
+        NSMutableData *received = self.responseData[@(dataTask.taskIdentifier)];
+        if (received) {
+            [received appendData:data];
+        } else {
+            self.responseData[@(dataTask.taskIdentifier)] = [data mutableCopy];
+        }
+    }
+}
+
+- (void)URLSession:(NSURLSession *)session task:(NSURLSessionTask *)task didCompleteWithError:(NSError *)error {
+    if (task.taskDescription) {
+        [NSFileManager.defaultManager removeItemAtPath:task.taskDescription error:nil];
+    }
+    
+    OSBackgroundUploadCompletion completion;
+    NSData *data;
+    @synchronized (self.completions) {
+        completion = self.completions[@(task.taskIdentifier)];
+        data = self.responseData[@(task.taskIdentifier)];
+        [self.completions removeObjectForKey:@(task.taskIdentifier)];
+        [self.responseData removeObjectForKey:@(task.taskIdentifier)];
+        for (NSString *key in self.keyedTasks.allKeys) {
+            [self.keyedTasks[key] removeObject:task];
+            if (self.keyedTasks[key].count == 0) {
+                [self.keyedTasks removeObjectForKey:key];
+            }
+        }
+    }
+    if (!completion) {
+        // Made by a previous launch, there is no one left to tell
+        ONE_S_LOG(ONE_S_LL_VERBOSE, @"Background upload from a previous launch finished with status code %li", (long)((NSHTTPURLResponse *)task.response).statusCode);
+        return;
+    }
+    completion(data, task.response, error);
+}
+
+@end
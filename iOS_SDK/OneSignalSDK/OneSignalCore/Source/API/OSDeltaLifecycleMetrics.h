@@ -0,0 +1,82 @@
+/**
+ * Modified MIT License
+ *
+ * Copyright 2024 OneSignal
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * 2. All copies of substantial portions of the Software may only be used in connection
+ * with services provided by OneSignal.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#import <Foundation/Foundation.h>
+
+#ifndef OSDeltaLifecycleMetrics_h
+#define OSDeltaLifecycleMetrics_h
+
+// Stages of a delta, as keys of the histograms in OSDeltaLifecycleMetrics' snapshot
+// From being enqueued in the operation repo until the repo flushed it to its executor
+#define OS_DELTA_STAGE_QUEUED @"queued"
+// From the flush until the request built from it was handed to OneSignalClient, including combining and waiting on earlier requests
+#define OS_DELTA_STAGE_EXECUTOR @"executor"
+// From being handed to OneSignalClient until the server acknowledged it, including reattempts
+#define OS_DELTA_STAGE_NETWORK @"network"
+#define OS_DELTA_STAGE_TOTAL @"total"
+
+/**
+ When a delta was enqueued and flushed, carried from the delta to the requests built from it.
+ Traces are only held in memory, requests read from the cache do not have them.
+ */
+@interface OSDeltaTrace : NSObject
+
+@property (strong, nonatomic, readonly, nonnull) NSString *name;
+@property (strong, nonatomic, readonly, nonnull) NSDate *enqueuedAt;
+// Nil if the delta was never flushed by the operation repo
+@property (strong, nonatomic, readonly, nullable) NSDate *flushedAt;
+
+- (instancetype _Nonnull)initWithName:(NSString * _Nonnull)name enqueuedAt:(NSDate * _Nonnull)enqueuedAt flushedAt:(NSDate * _Nullable)flushedAt;
+
+@end
+
+/**
+ How long changes take to reach the server, by delta name such as OS_UPDATE_PROPERTIES_DELTA and by stage.
+ OneSignalClient records the traces of a request once it succeeds, so this measures end-to-end freshness
+ and shows which stage, such as the operation repo's poll interval, dominates it.
+ Latencies are kept as fixed bucket histograms like OSRequestMetrics.
+ */
+@interface OSDeltaLifecycleMetrics : NSObject
+
++ (OSDeltaLifecycleMetrics * _Nonnull)sharedMetrics;
+
+// Upper bounds in milliseconds of the histogram buckets, the last bucket counts everything above the last bound
++ (NSArray<NSNumber *> * _Nonnull)bucketBounds;
+
+- (void)recordTraces:(NSArray<OSDeltaTrace *> * _Nonnull)traces sentAt:(NSDate * _Nonnull)sentAt acknowledgedAt:(NSDate * _Nonnull)acknowledgedAt;
+
+/**
+ Everything recorded so far, by delta name:
+ { "OS_UPDATE_PROPERTIES_DELTA": { "count": 3, "histograms": { "queued": [0, 1, 2, ...], "executor": [...], ... } } }
+ Each histogram has one count per bucket of `bucketBounds`, plus one for the overflow bucket.
+ */
+- (NSDictionary<NSString *, NSDictionary *> * _Nonnull)snapshot;
+- (void)reset;
+
+@end
+
+#endif /* OSDeltaLifecycleMetrics_h */
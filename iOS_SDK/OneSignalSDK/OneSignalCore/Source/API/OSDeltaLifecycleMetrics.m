@@ -0,0 +1,158 @@
+/**
+ * Modified MIT License
+ *
+ * Copyright 2024 OneSignal
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * 2. All copies of substantial portions of the Software may only be used in connection
+ * with services provided by OneSignal.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#import "OSDeltaLifecycleMetrics.h"
+
+@implementation OSDeltaTrace
+
+- (instancetype)initWithName:(NSString *)name enqueuedAt:(NSDate *)enqueuedAt flushedAt:(NSDate *)flushedAt {
+    if (self = [super init]) {
+        _name = name;
+        _enqueuedAt = enqueuedAt;
+        _flushedAt = flushedAt;
+    }
+    return self;
+}
+
+@end
+
+@interface OSDeltaNameMetrics : NSObject
+@property (nonatomic) NSUInteger count;
+// Bucket counts by stage
+@property (strong, nonatomic) NSMutableDictionary<NSString *, NSMutableArray<NSNumber *> *> *histograms;
+@end
+
+@implementation OSDeltaNameMetrics
+
+- (instancetype)init {
+    if (self = [super init]) {
+        _histograms = [NSMutableDictionary new];
+    }
+    return self;
+}
+
+- (void)addIntervalFrom:(NSDate *)start to:(NSDate *)end toStage:(NSString *)stage {
+    if (!start || !end) {
+        return;
+    }
+    NSArray<NSNumber *> *bounds = [OSDeltaLifecycleMetrics bucketBounds];
+    NSMutableArray<NSNumber *> *histogram = self.histograms[stage];
+    if (!histogram) {
+        histogram = [NSMutableArray arrayWithCapacity:bounds.count + 1];
+        for (NSUInteger i = 0; i <= bounds.count; i++) {
+            [histogram addObject:@0];
+        }
+        self.histograms[stage] = histogram;
+    }
+    double milliseconds = MAX(0, [end timeIntervalSinceDate:start] * 1000);
+    NSUInteger bucket = 0;
+    while (bucket < bounds.count && milliseconds > bounds[bucket].doubleValue) {
+        bucket++;
+    }
+    histogram[bucket] = @(histogram[bucket].unsignedIntegerValue + 1);
+}
+
+- (NSDictionary *)export {
+    NSMutableDictionary *histograms = [NSMutableDictionary new];
+    for (NSString *stage in self.histograms) {
+        histograms[stage] = [self.histograms[stage] copy];
+    }
+    return @{
+        @"count": @(self.count),
+        @"histograms": histograms
+    };
+}
+
+@end
+
+@interface OSDeltaLifecycleMetrics ()
+// Access is synchronized on the dictionary itself
+@property (strong, nonatomic) NSMutableDictionary<NSString *, OSDeltaNameMetrics *> *metricsByName;
+@end
+
+@implementation OSDeltaLifecycleMetrics
+
++ (OSDeltaLifecycleMetrics *)sharedMetrics {
+    static OSDeltaLifecycleMetrics *sharedMetrics = nil;
+    static dispatch_once_t once;
+    dispatch_once(&once, ^{
+        sharedMetrics = [OSDeltaLifecycleMetrics new];
+    });
+    return sharedMetrics;
+}
+
+// Wider than OSRequestMetrics' bounds, as deltas wait out the poll interval and any time offline
++ (NSArray<NSNumber *> *)bucketBounds {
+    static NSArray<NSNumber *> *bounds;
+    static dispatch_once_t once;
+    dispatch_once(&once, ^{
+        bounds = @[@50, @100, @250, @500, @1000, @2500, @5000, @10000, @30000, @60000, @300000];
+    });
+    return bounds;
+}
+
+- (instancetype)init {
+    if (self = [super init]) {
+        _metricsByName = [NSMutableDictionary new];
+    }
+    return self;
+}
+
+- (void)recordTraces:(NSArray<OSDeltaTrace *> *)traces sentAt:(NSDate *)sentAt acknowledgedAt:(NSDate *)acknowledgedAt {
+    @synchronized (self.metricsByName) {
+        for (OSDeltaTrace *trace in traces) {
+            OSDeltaNameMetrics *metrics = self.metricsByName[trace.name];
+            if (!metrics) {
+                metrics = [OSDeltaNameMetrics new];
+                self.metricsByName[trace.name] = metrics;
+            }
+            metrics.count++;
+            [metrics addIntervalFrom:trace.enqueuedAt to:trace.flushedAt toStage:OS_DELTA_STAGE_QUEUED];
+            [metrics addIntervalFrom:trace.flushedAt to:sentAt toStage:OS_DELTA_STAGE_EXECUTOR];
+            [metrics addIntervalFrom:sentAt to:acknowledgedAt toStage:OS_DELTA_STAGE_NETWORK];
+            [metrics addIntervalFrom:trace.enqueuedAt to:acknowledgedAt toStage:OS_DELTA_STAGE_TOTAL];
+        }
+    }
+}
+
+- (NSDictionary<NSString *, NSDictionary *> *)snapshot {
+    NSMutableDictionary<NSString *, NSDictionary *> *snapshot = [NSMutableDictionary new];
+    @synchronized (self.metricsByName) {
+        for (NSString *name in self.metricsByName) {
+            snapshot[name] = [self.metricsByName[name] export];
+        }
+    }
+    return snapshot;
+}
+
+- (void)reset {
+    @synchronized (self.metricsByName) {
+        [self.metricsByName removeAllObjects];
+    }
+}
+
+@end
@@ -40,7 +40,19 @@ typedef NS_ENUM(NSInteger, OSResponseStatusType) {
 @interface OSNetworkingUtils : NSObject
 
 + (NSNumber*)getNetType;
+// False while the network path is expensive or in Low Data Mode, OS_REACHABILITY_CHANGED_NOTIFICATION is posted when it changes
++ (BOOL)allowsPrefetch;
+// Whether the default route is available, OS_REACHABILITY_CHANGED_NOTIFICATION is posted when it changes
++ (BOOL)isReachable;
 + (OSResponseStatusType)getResponseStatusType:(NSInteger)statusCode;
+// The data in gzip format, for a Content-Encoding: gzip body, or nil if it could not be compressed, such as before iOS 13
++ (NSData*)gzipData:(NSData*)data;
+/*
+ What every in-process SDK session starts from, such as OneSignalClient's and the extension's attachment downloads.
+ Each session is created once and kept for the life of the process, so later requests reuse its HTTP/2 connections
+ and resume its TLS sessions, including across notifications handled by the same extension process.
+ */
++ (NSURLSessionConfiguration *)defaultSessionConfiguration;
 
 @end
 
@@ -27,17 +27,38 @@
 
 #import "OSNetworkingUtils.h"
 #import "OneSignalReachability.h"
+#import "OSTuningConfig.h"
 
 @implementation OSNetworkingUtils
 
 + (NSNumber *)getNetType {
-    OneSignalReachability* reachability = [OneSignalReachability reachabilityForInternetConnection];
+    OneSignalReachability* reachability = [OneSignalReachability sharedInternetReachability];
     NetworkStatus status = [reachability currentReachabilityStatus];
     if (status == ReachableViaWiFi)
         return @0;
     return @1;
 }
 
++ (BOOL)allowsPrefetch {
+    return [[OneSignalReachability sharedInternetReachability] allowsPrefetch];
+}
+
++ (BOOL)isReachable {
+    return [[OneSignalReachability sharedInternetReachability] currentReachabilityStatus] != NotReachable;
+}
+
++ (NSURLSessionConfiguration *)defaultSessionConfiguration {
+    NSURLSessionConfiguration *configuration = [NSURLSessionConfiguration defaultSessionConfiguration];
+    // The longest a request may go without receiving data
+    configuration.timeoutIntervalForRequest = OSTuningConfig.sharedConfig.requestTimeout;
+    // The longest a request may take in total, including time spent waiting for connectivity
+    configuration.timeoutIntervalForResource = OSTuningConfig.sharedConfig.resourceTimeout;
+    // HTTP/2 multiplexes on a single connection; these only apply if the server falls back to HTTP/1.1
+    configuration.HTTPMaximumConnectionsPerHost = OSTuningConfig.sharedConfig.httpMaxConnectionsPerHost;
+    configuration.HTTPShouldUsePipelining = YES;
+    return configuration;
+}
+
 + (OSResponseStatusType)getResponseStatusType:(NSInteger)statusCode {
     if (statusCode == 400 || statusCode == 402) {
         return OSResponseStatusInvalid;
@@ -52,4 +73,49 @@
     }
 }
 
+// CRC-32 as used by the gzip trailer, computed here so compressing needs nothing beyond Foundation
+static uint32_t OSCRC32(const uint8_t *bytes, NSUInteger length) {
+    static uint32_t table[256];
+    static dispatch_once_t once;
+    dispatch_once(&once, ^{
+        for (uint32_t i = 0; i < 256; i++) {
+            uint32_t crc = i;
+            for (int bit = 0; bit < 8; bit++)
+                crc = (crc & 1) ? 0xEDB88320 ^ (crc >> 1) : crc >> 1;
+            table[i] = crc;
+        }
+    });
+    uint32_t crc = 0xFFFFFFFF;
+    for (NSUInteger i = 0; i < length; i++)
+        crc = table[(crc ^ bytes[i]) & 0xFF] ^ (crc >> 8);
+    return crc ^ 0xFFFFFFFF;
+}
+
++ (NSData *)gzipData:(NSData *)data {
+    if (data.length == 0 || data.length > UINT32_MAX)
+        return nil;
+    if (@available(iOS 13.0, *)) {
+        // Foundation's zlib algorithm produces a raw DEFLATE stream, which the gzip header and trailer wrap
+        NSData *deflated = [data compressedDataUsingAlgorithm:NSDataCompressionAlgorithmZlib error:nil];
+        if (!deflated)
+            return nil;
+
+        // Magic bytes, DEFLATE, no flags, no modification time, no extra flags, unknown OS
+        const uint8_t header[10] = {0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff};
+        uint32_t crc = OSCRC32(data.bytes, data.length);
+        uint32_t size = (uint32_t)data.length;
+        const uint8_t trailer[8] = {
+            crc & 0xFF, (crc >> 8) & 0xFF, (crc >> 16) & 0xFF, (crc >> 24) & 0xFF,
+            size & 0xFF, (size >> 8) & 0xFF, (size >> 16) & 0xFF, (size >> 24) & 0xFF
+        };
+        NSMutableData *compressed = [NSMutableData dataWithCapacity:sizeof(header) + deflated.length + sizeof(trailer)];
+        [compressed appendBytes:header length:sizeof(header)];
+        [compressed appendData:deflated];
+        [compressed appendBytes:trailer length:sizeof(trailer)];
+        return compressed;
+    }
+    // Bodies are sent uncompressed before iOS 13
+    return nil;
+}
+
 @end
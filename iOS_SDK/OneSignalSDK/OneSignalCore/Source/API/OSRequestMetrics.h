@@ -0,0 +1,80 @@
+/**
+ * Modified MIT License
+ *
+ * Copyright 2024 OneSignal
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * 2. All copies of substantial portions of the Software may only be used in connection
+ * with services provided by OneSignal.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#import <Foundation/Foundation.h>
+
+#ifndef OSRequestMetrics_h
+#define OSRequestMetrics_h
+
+// Phases of a request, as keys of the timings passed to recordTimings:forRequestType:
+#define OS_REQUEST_PHASE_TOTAL @"total"
+#define OS_REQUEST_PHASE_DNS @"dns"
+#define OS_REQUEST_PHASE_CONNECT @"connect"
+#define OS_REQUEST_PHASE_TLS @"tls"
+#define OS_REQUEST_PHASE_TTFB @"ttfb"
+#define OS_REQUEST_PHASE_TRANSFER @"transfer"
+
+@class OSRequestMetrics;
+
+@protocol OSRequestMetricsDelegate <NSObject>
+/**
+ Called once per completed task, off the main thread, with the duration of each phase in milliseconds.
+ Phases that did not happen, such as DNS and connect on a reused connection, are left out.
+ */
+- (void)requestMetrics:(OSRequestMetrics * _Nonnull)metrics didRecordTimings:(NSDictionary<NSString *, NSNumber *> * _Nonnull)timings forRequestType:(NSString * _Nonnull)requestType;
+@end
+
+/**
+ Latency, error and retry counts of OneSignalClient's requests, by request class such as OSRequestCreateUser.
+ Latencies are kept as fixed bucket histograms so memory stays bounded however many requests are made.
+ Meant to be exported with `snapshot` or forwarded by a delegate to a RUM pipeline, and to tune timeouts.
+ */
+@interface OSRequestMetrics : NSObject <NSURLSessionTaskDelegate>
+
++ (OSRequestMetrics * _Nonnull)sharedMetrics;
+
+@property (weak, nonatomic, nullable) id<OSRequestMetricsDelegate> delegate;
+
+// Upper bounds in milliseconds of the histogram buckets, the last bucket counts everything above the last bound
++ (NSArray<NSNumber *> * _Nonnull)bucketBounds;
+
+- (void)recordTimings:(NSDictionary<NSString *, NSNumber *> * _Nonnull)timings forRequestType:(NSString * _Nonnull)requestType;
+// A status code of 0 is counted as a network error
+- (void)recordCompletionForRequestType:(NSString * _Nonnull)requestType statusCode:(NSInteger)statusCode;
+- (void)recordRetryForRequestType:(NSString * _Nonnull)requestType;
+
+/**
+ Everything recorded so far, by request type:
+ { "OSRequestCreateUser": { "count": 3, "retries": 1, "errors": { "500": 1 }, "histograms": { "total": [0, 1, 2, ...], ... } } }
+ Each histogram has one count per bucket of `bucketBounds`, plus one for the overflow bucket.
+ */
+- (NSDictionary<NSString *, NSDictionary *> * _Nonnull)snapshot;
+- (void)reset;
+
+@end
+
+#endif /* OSRequestMetrics_h */
@@ -0,0 +1,203 @@
+/**
+ * Modified MIT License
+ *
+ * Copyright 2024 OneSignal
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * 2. All copies of substantial portions of the Software may only be used in connection
+ * with services provided by OneSignal.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#import "OSRequestMetrics.h"
+
+static NSUInteger const OSRequestMetricsBucketCount = 11;
+
+static NSArray<NSString *> *OSRequestMetricsPhases(void) {
+    return @[OS_REQUEST_PHASE_TOTAL, OS_REQUEST_PHASE_DNS, OS_REQUEST_PHASE_CONNECT, OS_REQUEST_PHASE_TLS, OS_REQUEST_PHASE_TTFB, OS_REQUEST_PHASE_TRANSFER];
+}
+
+static NSNumber *OSMillisecondsBetween(NSDate *start, NSDate *end) {
+    if (!start || !end) {
+        return nil;
+    }
+    return @(MAX(0, [end timeIntervalSinceDate:start] * 1000));
+}
+
+@interface OSRequestTypeMetrics : NSObject
+@property (nonatomic) NSUInteger count;
+@property (nonatomic) NSUInteger retries;
+@property (strong, nonatomic) NSMutableDictionary<NSString *, NSNumber *> *errors;
+// Bucket counts by phase
+@property (strong, nonatomic) NSMutableDictionary<NSString *, NSMutableArray<NSNumber *> *> *histograms;
+@end
+
+@implementation OSRequestTypeMetrics
+
+- (instancetype)init {
+    if (self = [super init]) {
+        _errors = [NSMutableDictionary new];
+        _histograms = [NSMutableDictionary new];
+    }
+    return self;
+}
+
+- (void)addMilliseconds:(double)milliseconds toPhase:(NSString *)phase {
+    NSMutableArray<NSNumber *> *histogram = self.histograms[phase];
+    if (!histogram) {
+        histogram = [NSMutableArray arrayWithCapacity:OSRequestMetricsBucketCount];
+        for (NSUInteger i = 0; i < OSRequestMetricsBucketCount; i++) {
+            [histogram addObject:@0];
+        }
+        self.histograms[phase] = histogram;
+    }
+    NSArray<NSNumber *> *bounds = [OSRequestMetrics bucketBounds];
+    NSUInteger bucket = 0;
+    while (bucket < bounds.count && milliseconds > bounds[bucket].doubleValue) {
+        bucket++;
+    }
+    histogram[bucket] = @(histogram[bucket].unsignedIntegerValue + 1);
+}
+
+- (NSDictionary *)export {
+    NSMutableDictionary *histograms = [NSMutableDictionary new];
+    for (NSString *phase in self.histograms) {
+        histograms[phase] = [self.histograms[phase] copy];
+    }
+    return @{
+        @"count": @(self.count),
+        @"retries": @(self.retries),
+        @"errors": [self.errors copy],
+        @"histograms": histograms
+    };
+}
+
+@end
+
+@interface OSRequestMetrics ()
+// Access is synchronized on the dictionary itself
+@property (strong, nonatomic) NSMutableDictionary<NSString *, OSRequestTypeMetrics *> *metricsByType;
+@end
+
+@implementation OSRequestMetrics
+
++ (OSRequestMetrics *)sharedMetrics {
+    static OSRequestMetrics *sharedMetrics = nil;
+    static dispatch_once_t once;
+    dispatch_once(&once, ^{
+        sharedMetrics = [OSRequestMetrics new];
+    });
+    return sharedMetrics;
+}
+
++ (NSArray<NSNumber *> *)bucketBounds {
+    static NSArray<NSNumber *> *bounds;
+    static dispatch_once_t once;
+    dispatch_once(&once, ^{
+        bounds = @[@10, @25, @50, @100, @250, @500, @1000, @2500, @5000, @10000];
+    });
+    return bounds;
+}
+
+- (instancetype)init {
+    if (self = [super init]) {
+        _metricsByType = [NSMutableDictionary new];
+    }
+    return self;
+}
+
+// Must be called while synchronized on `metricsByType`
+- (OSRequestTypeMetrics *)metricsForType:(NSString *)requestType {
+    OSRequestTypeMetrics *metrics = self.metricsByType[requestType];
+    if (!metrics) {
+        metrics = [OSRequestTypeMetrics new];
+        self.metricsByType[requestType] = metrics;
+    }
+    return metrics;
+}
+
+- (void)recordTimings:(NSDictionary<NSString *, NSNumber *> *)timings forRequestType:(NSString *)requestType {
+    @synchronized (self.metricsByType) {
+        OSRequestTypeMetrics *metrics = [self metricsForType:requestType];
+        for (NSString *phase in OSRequestMetricsPhases()) {
+            NSNumber *milliseconds = timings[phase];
+            if (milliseconds) {
+                [metrics addMilliseconds:milliseconds.doubleValue toPhase:phase];
+            }
+        }
+    }
+    [self.delegate requestMetrics:self didRecordTimings:timings forRequestType:requestType];
+}
+
+- (void)recordCompletionForRequestType:(NSString *)requestType statusCode:(NSInteger)statusCode {
+    @synchronized (self.metricsByType) {
+        OSRequestTypeMetrics *metrics = [self metricsForType:requestType];
+        metrics.count++;
+        if (statusCode < 200 || statusCode >= 300) {
+            NSString *key = [NSString stringWithFormat:@"%ld", (long)statusCode];
+            metrics.errors[key] = @(metrics.errors[key].unsignedIntegerValue + 1);
+        }
+    }
+}
+
+- (void)recordRetryForRequestType:(NSString *)requestType {
+    @synchronized (self.metricsByType) {
+        [self metricsForType:requestType].retries++;
+    }
+}
+
+- (NSDictionary<NSString *, NSDictionary *> *)snapshot {
+    NSMutableDictionary<NSString *, NSDictionary *> *snapshot = [NSMutableDictionary new];
+    @synchronized (self.metricsByType) {
+        for (NSString *requestType in self.metricsByType) {
+            snapshot[requestType] = [self.metricsByType[requestType] export];
+        }
+    }
+    return snapshot;
+}
+
+- (void)reset {
+    @synchronized (self.metricsByType) {
+        [self.metricsByType removeAllObjects];
+    }
+}
+
+#pragma mark NSURLSessionTaskDelegate
+
+// OneSignalClient sets each task's description to its request's class
+- (void)URLSession:(NSURLSession *)session task:(NSURLSessionTask *)task didFinishCollectingMetrics:(NSURLSessionTaskMetrics *)metrics {
+    NSString *requestType = task.taskDescription;
+    if (!requestType) {
+        return;
+    }
+    NSMutableDictionary<NSString *, NSNumber *> *timings = [NSMutableDictionary new];
+    timings[OS_REQUEST_PHASE_TOTAL] = @(metrics.taskInterval.duration * 1000);
+    // The last transaction is the one that produced the response, earlier ones were redirected or failed
+    NSURLSessionTaskTransactionMetrics *transaction = metrics.transactionMetrics.lastObject;
+    if (transaction && transaction.resourceFetchType == NSURLSessionTaskMetricsResourceFetchTypeNetworkLoad) {
+        timings[OS_REQUEST_PHASE_DNS] = OSMillisecondsBetween(transaction.domainLookupStartDate, transaction.domainLookupEndDate);
+        timings[OS_REQUEST_PHASE_CONNECT] = OSMillisecondsBetween(transaction.connectStartDate, transaction.connectEndDate);
+        timings[OS_REQUEST_PHASE_TLS] = OSMillisecondsBetween(transaction.secureConnectionStartDate, transaction.secureConnectionEndDate);
+        timings[OS_REQUEST_PHASE_TTFB] = OSMillisecondsBetween(transaction.requestStartDate, transaction.responseStartDate);
+        timings[OS_REQUEST_PHASE_TRANSFER] = OSMillisecondsBetween(transaction.responseStartDate, transaction.responseEndDate);
+    }
+    [self recordTimings:timings forRequestType:requestType];
+}
+
+@end
@@ -35,6 +35,7 @@ NS_ASSUME_NONNULL_BEGIN
 
 @interface OSRequestGetIosParams : OneSignalRequest
 + (instancetype)withUserId:(NSString *)userId appId:(NSString *)appId;
++ (instancetype)withUserId:(NSString *)userId appId:(NSString *)appId etag:(NSString *)etag;
 @end
 
 @interface OSRequestPostNotification : OneSignalRequest
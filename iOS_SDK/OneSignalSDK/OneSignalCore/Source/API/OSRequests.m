@@ -48,6 +48,10 @@
  */
 @implementation OSRequestGetIosParams
 + (instancetype)withUserId:(NSString *)userId appId:(NSString *)appId {
+    return [self withUserId:userId appId:appId etag:nil];
+}
+
++ (instancetype)withUserId:(NSString *)userId appId:(NSString *)appId etag:(NSString *)etag {
     let request = [OSRequestGetIosParams new];
     
     if (userId) {
@@ -57,6 +61,11 @@
     request.method = GET;
     request.path = [NSString stringWithFormat:@"apps/%@/ios_params.js", appId];
     request.disableLocalCaching = true;
+    request.priority = OSRequestPriorityHigh;
+    // Lets the backend answer 304 Not Modified when the cached params are still current
+    if (etag) {
+        request.additionalHeaders = @{@"If-None-Match": etag};
+    }
     
     return request;
 }
@@ -84,6 +93,8 @@
     request.parameters = @{@"player_id" : userId ?: [NSNull null], @"app_id" : appId ?: [NSNull null], @"opened" : @(opened), @"device_type": deviceType};
     request.method = PUT;
     request.path = [NSString stringWithFormat:@"notifications/%@", messageId];
+    // Analytics only, waits behind requests the user is waiting on
+    request.priority = OSRequestPriorityLow;
     
     return request;
 }
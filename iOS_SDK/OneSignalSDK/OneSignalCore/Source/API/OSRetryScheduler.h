@@ -0,0 +1,56 @@
+/**
+ * Modified MIT License
+ *
+ * Copyright 2024 OneSignal
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * 2. All copies of substantial portions of the Software may only be used in connection
+ * with services provided by OneSignal.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ Runs reattempts of failed requests on a dedicated queue instead of the main run loop.
+ Delays use exponential backoff with full jitter, so clients do not retry in lockstep after an outage,
+ and honor a server's Retry-After header. Reattempts that come due while the network is unreachable
+ are parked and released, spread out, once connectivity returns.
+ */
+@interface OSRetryScheduler : NSObject
+
++ (OSRetryScheduler *)sharedScheduler;
+
+/**
+ A random delay in [0, min(max retry delay, retry delay * 3^reattemptCount)], but no shorter than `retryAfter` if provided.
+ */
++ (NSTimeInterval)delayForReattemptCount:(int)reattemptCount retryAfter:(NSNumber * _Nullable)retryAfter;
+
+/**
+ Parses a Retry-After header, in delta-seconds or HTTP-date form, into seconds from now.
+ */
++ (NSNumber * _Nullable)retryAfterFromHeaders:(NSDictionary * _Nullable)headers;
+
+- (void)scheduleReattempt:(dispatch_block_t)reattempt afterDelay:(NSTimeInterval)delay;
+
+@end
+
+NS_ASSUME_NONNULL_END
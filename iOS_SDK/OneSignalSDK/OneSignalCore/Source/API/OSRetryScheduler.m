@@ -0,0 +1,140 @@
+/**
+ * Modified MIT License
+ *
+ * Copyright 2024 OneSignal
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * 2. All copies of substantial portions of the Software may only be used in connection
+ * with services provided by OneSignal.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#import "OSRetryScheduler.h"
+#import "OneSignalReachability.h"
+#import "OneSignalCommonDefines.h"
+#import "OneSignalLog.h"
+#import "OSTuningConfig.h"
+#import "OSDispatchQueues.h"
+
+@interface OSRetryScheduler ()
+@property (strong, nonatomic) dispatch_queue_t queue;
+@property (strong, nonatomic) OneSignalReachability *reachability;
+// Reattempts that came due while offline. Access is synchronized by the `queue`.
+@property (strong, nonatomic) NSMutableArray<dispatch_block_t> *parkedReattempts;
+@end
+
+@implementation OSRetryScheduler
+
++ (OSRetryScheduler *)sharedScheduler {
+    static OSRetryScheduler *sharedScheduler = nil;
+    static dispatch_once_t once;
+    dispatch_once(&once, ^{
+        sharedScheduler = [OSRetryScheduler new];
+    });
+    return sharedScheduler;
+}
+
+- (instancetype)init {
+    if (self = [super init]) {
+        _queue = dispatch_queue_create_with_target("com.onesignal.client.retry", DISPATCH_QUEUE_SERIAL, OSDispatchQueues.utility);
+        _parkedReattempts = [NSMutableArray new];
+        _reachability = [OneSignalReachability sharedInternetReachability];
+        [[NSNotificationCenter defaultCenter] addObserver:self
+                                                 selector:@selector(reachabilityChanged)
+                                                     name:OS_REACHABILITY_CHANGED_NOTIFICATION
+                                                   object:_reachability];
+    }
+    return self;
+}
+
+- (void)dealloc {
+    [[NSNotificationCenter defaultCenter] removeObserver:self];
+}
+
++ (NSTimeInterval)delayForReattemptCount:(int)reattemptCount retryAfter:(NSNumber *)retryAfter {
+    OSTuningConfig *tuning = OSTuningConfig.sharedConfig;
+    double window = MIN(tuning.requestMaxRetryDelay, tuning.requestRetryDelay * pow(3, reattemptCount));
+    double delay = window * ((double)arc4random() / UINT32_MAX);
+    if (retryAfter) {
+        delay = MAX(delay, retryAfter.doubleValue);
+    }
+    return delay;
+}
+
++ (NSNumber *)retryAfterFromHeaders:(NSDictionary *)headers {
+    id value = nil;
+    for (NSString *key in headers) {
+        if ([key caseInsensitiveCompare:@"Retry-After"] == NSOrderedSame) {
+            value = headers[key];
+            break;
+        }
+    }
+    if (![value isKindOfClass:[NSString class]]) {
+        return nil;
+    }
+    NSString *retryAfter = [value stringByTrimmingCharactersInSet:[NSCharacterSet whitespaceCharacterSet]];
+    
+    NSScanner *scanner = [NSScanner scannerWithString:retryAfter];
+    NSInteger seconds;
+    if ([scanner scanInteger:&seconds] && scanner.isAtEnd) {
+        return seconds >= 0 ? @(seconds) : nil;
+    }
+    
+    NSDateFormatter *formatter = [NSDateFormatter new];
+    formatter.locale = [NSLocale localeWithLocaleIdentifier:@"en_US_POSIX"];
+    formatter.timeZone = [NSTimeZone timeZoneWithAbbreviation:@"GMT"];
+    formatter.dateFormat = @"EEE, dd MMM yyyy HH:mm:ss zzz";
+    NSDate *date = [formatter dateFromString:retryAfter];
+    if (!date) {
+        return nil;
+    }
+    return @(MAX(0, [date timeIntervalSinceNow]));
+}
+
+- (BOOL)isReachable {
+    return [self.reachability currentReachabilityStatus] != NotReachable;
+}
+
+- (void)scheduleReattempt:(dispatch_block_t)reattempt afterDelay:(NSTimeInterval)delay {
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(delay * NSEC_PER_SEC)), self.queue, ^{
+        if ([self isReachable]) {
+            reattempt();
+        } else {
+            [OneSignalLog onesignalLog:ONE_S_LL_DEBUG message:@"OSRetryScheduler parking reattempt until the network is reachable"];
+            [self.parkedReattempts addObject:reattempt];
+        }
+    });
+}
+
+- (void)reachabilityChanged {
+    dispatch_async(self.queue, ^{
+        if (self.parkedReattempts.count == 0 || ![self isReachable]) {
+            return;
+        }
+        ONE_S_LOG(ONE_S_LL_DEBUG, @"OSRetryScheduler releasing %lu parked reattempts", (unsigned long)self.parkedReattempts.count);
+        // Spread the released reattempts out instead of reconnecting all at once
+        for (dispatch_block_t reattempt in self.parkedReattempts) {
+            double delay = REATTEMPT_RESUME_SPREAD * ((double)arc4random() / UINT32_MAX);
+            [self scheduleReattempt:reattempt afterDelay:delay];
+        }
+        [self.parkedReattempts removeAllObjects];
+    });
+}
+
+@end
@@ -34,6 +34,9 @@
 
 @protocol IOneSignalClient <NSObject>
 - (void)executeRequest:(OneSignalRequest *)request onSuccess:(OSResultSuccessBlock)successBlock onFailure:(OSClientFailureBlock)failureBlock;
+@optional
+// Cancels deferrable requests made with this `deferralKey`, their failure block is called with NSURLErrorCancelled
+- (void)cancelDeferredRequestsWithKey:(NSString *)key;
 @end
 
 @interface OneSignalClient : NSObject <IOneSignalClient>
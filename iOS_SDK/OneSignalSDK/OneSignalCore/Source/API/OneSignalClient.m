@@ -27,14 +27,53 @@
 
 #import "OneSignalClient.h"
 #import "OSReattemptRequest.h"
+#import "OSRetryScheduler.h"
+#import "OSBackgroundUploadSession.h"
+#import "OneSignalReachability.h"
 #import "OneSignalCommonDefines.h"
 #import "OneSignalLog.h"
 #import "OneSignalCoreHelper.h"
 #import "OSPrivacyConsentController.h"
+#import "OSNetworkingUtils.h"
+#import "OSRemoteParamController.h"
+#import "OSTrace.h"
+#import "OSRequestMetrics.h"
+#import "OSDeltaLifecycleMetrics.h"
+#import "OSDispatchQueues.h"
+#import "OSFlightRecorder.h"
+#import "OSPerformanceCounters.h"
+#import "OSTuningConfig.h"
+#import "OSNetworkingUtils.h"
 
 @interface OneSignalClient ()
-@property (strong, nonatomic) NSURLSession *sharedSession;
-@property (strong, nonatomic) NSURLSession *noCacheSession;
+/*
+ All requests share one session, and so one connection pool. Over HTTP/2 the requests made right after launch,
+ such as create user, IAM fetch and subscription updates, are multiplexed on the connection that
+ OSRequestGetIosParams already warmed up, instead of each paying for a new TCP and TLS handshake.
+ The session's delegate records each task's timings into OSRequestMetrics.
+ */
+@property (strong, nonatomic) NSURLSession *session;
+/*
+ Requests made while the network is unreachable are parked instead of failing with status code 0 and
+ using up their reattempts. They are released in priority order once connectivity returns.
+ Access to `parkedRequests` is synchronized by the `offlineQueue`.
+ */
+@property (strong, nonatomic) dispatch_queue_t offlineQueue;
+@property (strong, nonatomic) dispatch_queue_t encodingQueue;
+@property (strong, nonatomic) NSMutableArray<OSReattemptRequest *> *parkedRequests;
+@property (strong, nonatomic) OneSignalReachability *reachability;
+/*
+ Callers waiting on an identical GET that is already in flight, by the request's `idempotencyKey`.
+ The key is only present while its request is in flight. Access is synchronized on the dictionary itself.
+ */
+@property (strong, nonatomic) NSMutableDictionary<NSString *, NSMutableArray<OSReattemptRequest *> *> *inFlightRequests;
+/*
+ Low priority requests, such as outcomes and impressions, are held back while any high priority request,
+ such as create user or identify user, is in flight so they do not compete for bandwidth on slow connections.
+ Access to both is synchronized on `deferredRequests`.
+ */
+@property (nonatomic) NSInteger highPriorityTasksInFlight;
+@property (strong, nonatomic) NSMutableArray<OSReattemptRequest *> *deferredRequests;
 @end
 
 @implementation OneSignalClient
@@ -50,21 +89,105 @@
 
 -(instancetype)init {
     if (self = [super init]) {
-        _sharedSession = [NSURLSession sessionWithConfiguration:[self configurationWithCachingPolicy:NSURLRequestUseProtocolCachePolicy]];
-        _noCacheSession = [NSURLSession sessionWithConfiguration:[self configurationWithCachingPolicy:NSURLRequestReloadIgnoringLocalCacheData]];
+        _session = [NSURLSession sessionWithConfiguration:[self sessionConfiguration] delegate:[OSRequestMetrics sharedMetrics] delegateQueue:nil];
+        _offlineQueue = dispatch_queue_create_with_target("com.onesignal.client.offline", DISPATCH_QUEUE_SERIAL, OSDispatchQueues.utility);
+        _encodingQueue = dispatch_queue_create_with_target("com.onesignal.client.encoding", DISPATCH_QUEUE_SERIAL, OSDispatchQueues.utility);
+        _parkedRequests = [NSMutableArray new];
+        _inFlightRequests = [NSMutableDictionary new];
+        _deferredRequests = [NSMutableArray new];
+        _reachability = [OneSignalReachability sharedInternetReachability];
+        [[NSNotificationCenter defaultCenter] addObserver:self
+                                                 selector:@selector(reachabilityChanged)
+                                                     name:OS_REACHABILITY_CHANGED_NOTIFICATION
+                                                   object:_reachability];
     }
     
     return self;
 }
 
-- (NSURLSessionConfiguration *)configurationWithCachingPolicy:(NSURLRequestCachePolicy)policy {
-    NSURLSessionConfiguration *configuration = [NSURLSessionConfiguration defaultSessionConfiguration];
-    configuration.timeoutIntervalForRequest = REQUEST_TIMEOUT_REQUEST; // TODO: Are these anything?
-    configuration.timeoutIntervalForResource = REQUEST_TIMEOUT_RESOURCE; // TODO: Are these anything?
+- (void)dealloc {
+    [[NSNotificationCenter defaultCenter] removeObserver:self];
+}
+
+- (BOOL)isReachable {
+    return [self.reachability currentReachabilityStatus] != NotReachable;
+}
+
+/*
+ While the path is in Low Data Mode, low priority uploads such as outcomes and impressions are handed to the
+ background session like deferrable requests. The system sends them when it sees fit, and they are not lost if
+ the app is terminated first, where parking them in memory could hold them until then.
+ */
+- (BOOL)sendsAsBackgroundUpload:(OneSignalRequest *)request {
+    if (request.method != POST && request.method != PUT && request.method != PATCH) {
+        return false;
+    }
+    return request.deferrable || (request.priority < OSRequestPriorityNormal && self.reachability.isConstrained);
+}
+
+- (void)parkRequest:(OneSignalRequest *)request onSuccess:(OSResultSuccessBlock)successBlock onFailure:(OSClientFailureBlock)failureBlock {
+    dispatch_async(self.offlineQueue, ^{
+        ONE_S_LOG(ONE_S_LL_DEBUG, @"Network unreachable, parking request (%@)", NSStringFromClass([request class]));
+        [self.parkedRequests addObject:[OSReattemptRequest withRequest:request successBlock:successBlock failureBlock:failureBlock]];
+        
+        // Connectivity may have returned before this request was parked
+        if ([self isReachable]) {
+            [self releaseParkedRequests];
+            return;
+        }
+        if (self.parkedRequests.count <= OS_OFFLINE_REQUEST_QUEUE_LIMIT) {
+            return;
+        }
+        // Over the limit, drop the oldest of the lowest priority requests
+        OSReattemptRequest *dropped = self.parkedRequests.firstObject;
+        for (OSReattemptRequest *parked in self.parkedRequests) {
+            if (parked.request.priority < dropped.request.priority) {
+                dropped = parked;
+            }
+        }
+        [self.parkedRequests removeObjectIdenticalTo:dropped];
+        
+        NSString *message = [NSString stringWithFormat:@"Dropped request (%@) parked while the network was unreachable", NSStringFromClass([dropped.request class])];
+        [OneSignalLog onesignalLog:ONE_S_LL_WARN message:message];
+        if (dropped.failureBlock) {
+            dropped.failureBlock([[OneSignalClientError alloc] initWithCode:0 message:message responseHeaders:nil response:nil underlyingError:nil]);
+        }
+    });
+}
+
+- (void)reachabilityChanged {
+    dispatch_async(self.offlineQueue, ^{
+        if ([self isReachable]) {
+            [self releaseParkedRequests];
+        }
+    });
+}
+
+// Must be called on the `offlineQueue`
+- (void)releaseParkedRequests {
+    if (self.parkedRequests.count == 0) {
+        return;
+    }
+    // Highest priority first, then in the order they were made
+    NSArray<OSReattemptRequest *> *released = [self.parkedRequests sortedArrayWithOptions:NSSortStable usingComparator:^NSComparisonResult(OSReattemptRequest *first, OSReattemptRequest *second) {
+        if (first.request.priority == second.request.priority) {
+            return NSOrderedSame;
+        }
+        return first.request.priority > second.request.priority ? NSOrderedAscending : NSOrderedDescending;
+    }];
+    [self.parkedRequests removeAllObjects];
     
-    //prevent caching of requests, this mainly impacts OSRequestGetIosParams,
-    //since the OSRequestGetTags endpoint has a caching header policy
-    configuration.requestCachePolicy = policy;
+    ONE_S_LOG(ONE_S_LL_DEBUG, @"Network reachable, releasing %lu parked requests", (unsigned long)released.count);
+    for (OSReattemptRequest *parked in released) {
+        [self performRequest:parked.request onSuccess:parked.successBlock onFailure:parked.failureBlock];
+    }
+}
+
+- (NSURLSessionConfiguration *)sessionConfiguration {
+    NSURLSessionConfiguration *configuration = [OSNetworkingUtils defaultSessionConfiguration];
+    // Wait for a route instead of failing immediately with status code 0 and burning a reattempt
+    configuration.waitsForConnectivity = YES;
+    configuration.requestCachePolicy = NSURLRequestUseProtocolCachePolicy;
     
     return configuration;
 }
@@ -74,6 +197,72 @@
 }
 
 - (void)executeRequest:(OneSignalRequest *)request onSuccess:(OSResultSuccessBlock)successBlock onFailure:(OSClientFailureBlock)failureBlock {
+    NSArray<OSDeltaTrace *> *deltaTraces = request.deltaTraces;
+    if (deltaTraces.count > 0) {
+        NSDate *sentAt = [NSDate date];
+        OSResultSuccessBlock tracedSuccessBlock = successBlock;
+        successBlock = ^(NSDictionary *result) {
+            [[OSDeltaLifecycleMetrics sharedMetrics] recordTraces:deltaTraces sentAt:sentAt acknowledgedAt:[NSDate date]];
+            if (tracedSuccessBlock) {
+                tracedSuccessBlock(result);
+            }
+        };
+    }
+    
+    NSString *key = request.method == GET ? request.idempotencyKey : nil;
+    if (!key) {
+        [self performRequest:request onSuccess:successBlock onFailure:failureBlock];
+        return;
+    }
+    
+    @synchronized (self.inFlightRequests) {
+        NSMutableArray<OSReattemptRequest *> *waiting = self.inFlightRequests[key];
+        if (waiting) {
+            [OneSignalLog onesignalLog:ONE_S_LL_VERBOSE messageBlock:^NSString *{
+                return [NSString stringWithFormat:@"Request (%@) joined an identical request already in flight", NSStringFromClass([request class])];
+            }];
+            [waiting addObject:[OSReattemptRequest withRequest:request successBlock:successBlock failureBlock:failureBlock]];
+            return;
+        }
+        self.inFlightRequests[key] = [NSMutableArray new];
+    }
+    
+    // The result is fanned out once the request and any of its reattempts are done
+    [self performRequest:request onSuccess:^(NSDictionary *result) {
+        for (OSReattemptRequest *waiter in [self finishInFlightRequestWithKey:key]) {
+            waiter.request.responseHeaders = request.responseHeaders;
+            waiter.request.responseStatusCode = request.responseStatusCode;
+            if (waiter.successBlock) {
+                waiter.successBlock(result);
+            }
+        }
+        if (successBlock) {
+            successBlock(result);
+        }
+    } onFailure:^(OneSignalClientError *error) {
+        for (OSReattemptRequest *waiter in [self finishInFlightRequestWithKey:key]) {
+            waiter.request.responseHeaders = request.responseHeaders;
+            waiter.request.responseStatusCode = request.responseStatusCode;
+            if (waiter.failureBlock) {
+                waiter.failureBlock(error);
+            }
+        }
+        if (failureBlock) {
+            failureBlock(error);
+        }
+    }];
+}
+
+- (NSArray<OSReattemptRequest *> *)finishInFlightRequestWithKey:(NSString *)key {
+    @synchronized (self.inFlightRequests) {
+        NSArray<OSReattemptRequest *> *waiting = self.inFlightRequests[key];
+        [self.inFlightRequests removeObjectForKey:key];
+        return waiting;
+    }
+}
+
+// Parked requests and reattempts come back through here, so they keep their place as the in-flight request for their key
+- (void)performRequest:(OneSignalRequest *)request onSuccess:(OSResultSuccessBlock)successBlock onFailure:(OSClientFailureBlock)failureBlock {
     // If privacy consent is required but not yet given, any non-GET request should be blocked.
     if (request.method != GET && [OSPrivacyConsentController shouldLogMissingPrivacyConsentErrorWithMethodName:nil]) {
         [OneSignalLog onesignalLog:ONE_S_LL_ERROR message:@"Attempted to perform an HTTP request (%@) before the user provided privacy consent."];
@@ -103,15 +292,140 @@
         has a property indicating if local caching should be
         explicitly disabled for that request. The default is false.
     */
-    NSURLSession *session = request.disableLocalCaching ? self.noCacheSession : self.sharedSession;
+    if (![self isReachable]) {
+        [self parkRequest:request onSuccess:successBlock onFailure:failureBlock];
+        return;
+    }
+    
+    if ([self deferLowPriorityRequest:request onSuccess:successBlock onFailure:failureBlock]) {
+        return;
+    }
+    
+    // Encoding a body, such as a user with many tags, and staging background uploads is kept off the main thread.
+    // Every request is encoded and sent from the one serial queue, so a GET cannot start ahead of an earlier POST.
+    dispatch_async(self.encodingQueue, ^{
+        [self startRequest:request onSuccess:successBlock onFailure:failureBlock];
+    });
+}
+
+- (void)startRequest:(OneSignalRequest *)request onSuccess:(OSResultSuccessBlock)successBlock onFailure:(OSClientFailureBlock)failureBlock {
+    NSMutableURLRequest *urlRequest = request.urlRequest;
     
-    NSURLSessionDataTask *task = [session dataTaskWithRequest:request.urlRequest completionHandler:^(NSData * _Nullable data, NSURLResponse * _Nullable response, NSError * _Nullable error) {
+    //prevent caching of requests, this mainly impacts OSRequestGetIosParams,
+    //since the OSRequestGetTags endpoint has a caching header policy
+    if (request.disableLocalCaching) {
+        urlRequest.cachePolicy = NSURLRequestReloadIgnoringLocalCacheData;
+    }
+    
+    [self compressBodyOfRequest:urlRequest];
+    
+    if ([self sendsAsBackgroundUpload:request]) {
+        NSDate *earliestBeginDate = request.deferralDelay > 0 ? [NSDate dateWithTimeIntervalSinceNow:request.deferralDelay] : nil;
+        // Background uploads can complete in a later launch, so they are marked with an event rather than an interval
+        [OSTrace event:[NSString stringWithFormat:@"Upload %@", NSStringFromClass([request class])]];
+        [[OSBackgroundUploadSession sharedSession] uploadRequest:urlRequest earliestBeginDate:earliestBeginDate key:request.deferralKey completion:^(NSData * _Nullable data, NSURLResponse * _Nullable response, NSError * _Nullable error) {
+            [self handleJSONNSURLResponse:response data:data error:error isAsync:true withRequest:request onSuccess:successBlock onFailure:failureBlock];
+        }];
+        return;
+    }
+    
+    BOOL highPriority = request.priority > OSRequestPriorityNormal;
+    if (highPriority) {
+        @synchronized (self.deferredRequests) {
+            self.highPriorityTasksInFlight++;
+        }
+    }
+    
+    uint64_t signpostId = [OSTrace beginInterval:OSTraceIntervalRequest name:NSStringFromClass([request class])];
+    __block NSUInteger taskId = 0;
+    NSURLSessionDataTask *task = [self.session dataTaskWithRequest:urlRequest completionHandler:^(NSData * _Nullable data, NSURLResponse * _Nullable response, NSError * _Nullable error) {
+        [OSTrace endInterval:OSTraceIntervalRequest signpostId:signpostId];
+        [OSFlightRecorder record:OSFlightRecorderEventRequestFinished arg0:[(NSHTTPURLResponse *)response statusCode] arg1:taskId];
+        if (highPriority) {
+            [self highPriorityTaskFinished];
+        }
+        [[OSRequestMetrics sharedMetrics] recordCompletionForRequestType:NSStringFromClass([request class]) statusCode:[(NSHTTPURLResponse *)response statusCode]];
         [self handleJSONNSURLResponse:response data:data error:error isAsync:true withRequest:request onSuccess:successBlock onFailure:failureBlock];
     }];
+    task.priority = [self taskPriorityForRequest:request];
+    task.taskDescription = NSStringFromClass([request class]);
+    taskId = task.taskIdentifier;
+    [OSFlightRecorder record:OSFlightRecorderEventRequestStarted class:[request class] arg1:taskId];
     
     [task resume];
 }
 
+- (float)taskPriorityForRequest:(OneSignalRequest *)request {
+    switch (request.priority) {
+        case OSRequestPriorityHigh:
+            return NSURLSessionTaskPriorityHigh;
+        case OSRequestPriorityLow:
+            return NSURLSessionTaskPriorityLow;
+        default:
+            return NSURLSessionTaskPriorityDefault;
+    }
+}
+
+- (BOOL)deferLowPriorityRequest:(OneSignalRequest *)request onSuccess:(OSResultSuccessBlock)successBlock onFailure:(OSClientFailureBlock)failureBlock {
+    if (request.priority >= OSRequestPriorityNormal) {
+        return false;
+    }
+    @synchronized (self.deferredRequests) {
+        if (self.highPriorityTasksInFlight == 0) {
+            return false;
+        }
+        [self.deferredRequests addObject:[OSReattemptRequest withRequest:request successBlock:successBlock failureBlock:failureBlock]];
+    }
+    [OneSignalLog onesignalLog:ONE_S_LL_VERBOSE messageBlock:^NSString *{
+        return [NSString stringWithFormat:@"Deferring low priority request (%@) until high priority requests finish", NSStringFromClass([request class])];
+    }];
+    return true;
+}
+
+- (void)highPriorityTaskFinished {
+    NSArray<OSReattemptRequest *> *released;
+    @synchronized (self.deferredRequests) {
+        self.highPriorityTasksInFlight--;
+        if (self.highPriorityTasksInFlight > 0 || self.deferredRequests.count == 0) {
+            return;
+        }
+        released = [self.deferredRequests copy];
+        [self.deferredRequests removeAllObjects];
+    }
+    for (OSReattemptRequest *deferred in released) {
+        [self performRequest:deferred.request onSuccess:deferred.successBlock onFailure:deferred.failureBlock];
+    }
+}
+
+- (void)cancelDeferredRequestsWithKey:(NSString *)key {
+    NSError *cancelledError = [NSError errorWithDomain:NSURLErrorDomain code:NSURLErrorCancelled userInfo:nil];
+    NSArray<OSReattemptRequest *> *(^cancel)(NSMutableArray<OSReattemptRequest *> *) = ^(NSMutableArray<OSReattemptRequest *> *requests) {
+        NSArray<OSReattemptRequest *> *matching = [requests filteredArrayUsingPredicate:[NSPredicate predicateWithBlock:^BOOL(OSReattemptRequest *waiting, NSDictionary *bindings) {
+            return [waiting.request.deferralKey isEqualToString:key];
+        }]];
+        [requests removeObjectsInArray:matching];
+        return matching;
+    };
+    void (^notify)(NSArray<OSReattemptRequest *> *) = ^(NSArray<OSReattemptRequest *> *cancelled) {
+        for (OSReattemptRequest *waiting in cancelled) {
+            if (waiting.failureBlock) {
+                waiting.failureBlock([[OneSignalClientError alloc] initWithCode:0 message:@"Request cancelled" responseHeaders:nil response:nil underlyingError:cancelledError]);
+            }
+        }
+    };
+    
+    // Requests still waiting on the client never reached the background session
+    NSArray<OSReattemptRequest *> *deferred;
+    @synchronized (self.deferredRequests) {
+        deferred = cancel(self.deferredRequests);
+    }
+    notify(deferred);
+    dispatch_async(self.offlineQueue, ^{
+        notify(cancel(self.parkedRequests));
+    });
+    [[OSBackgroundUploadSession sharedSession] cancelUploadsWithKey:key];
+}
+
 - (void)handleMissingAppIdError:(OSClientFailureBlock)failureBlock withRequest:(OneSignalRequest *)request {
     NSString *errorDescription = [NSString stringWithFormat:@"HTTP Request (%@) must contain app_id parameter", NSStringFromClass([request class])];
     
@@ -126,11 +440,30 @@
         return false;
     }
     
-    [self prettyPrintDebugStatementWithRequest:request];
+    if ([OneSignalLog isLogLevelEnabled:ONE_S_LL_VERBOSE]) {
+        [self prettyPrintDebugStatementWithRequest:request];
+    }
     
     return true;
 }
 
+/*
+ Large JSON bodies, such as create user with many tags and aliases or outcomes, are sent gzip compressed
+ once remote params say the API accepts it. The body is left as is when compressing does not make it smaller.
+ */
+- (void)compressBodyOfRequest:(NSMutableURLRequest *)urlRequest {
+    if (urlRequest.HTTPBody.length < OS_GZIP_REQUEST_BODY_MIN_BYTES ||
+        ![OSRemoteParamController.sharedController isRequestBodyCompressionEnabled])
+        return;
+    
+    NSData *compressed = [OSNetworkingUtils gzipData:urlRequest.HTTPBody];
+    if (!compressed || compressed.length >= urlRequest.HTTPBody.length)
+        return;
+    
+    urlRequest.HTTPBody = compressed;
+    [urlRequest setValue:@"gzip" forHTTPHeaderField:@"Content-Encoding"];
+}
+
 // reattempts a failed HTTP request
 // only occurs if the request encountered a 500+ server error (or timeout) code.
 // only asynchronous HTTP requests will get reattempted with a delay
@@ -143,22 +476,27 @@
     //very important to increment this variable otherwise the request will continue to reattempt infinitely until it stops getting a 500+ error code.
     //we want requests to only retry one time after a delay.
     reattempt.request.reattemptCount++;
+    [[OSRequestMetrics sharedMetrics] recordRetryForRequestType:NSStringFromClass([reattempt.request class])];
+    [OSPerformanceCounters increment:OSPerformanceCounterRequestRetries];
+    [OSFlightRecorder record:OSFlightRecorderEventRequestRetried class:[reattempt.request class] arg1:reattempt.request.reattemptCount];
     
-    [self executeRequest:reattempt.request onSuccess:reattempt.successBlock onFailure:reattempt.failureBlock];
+    [self performRequest:reattempt.request onSuccess:reattempt.successBlock onFailure:reattempt.failureBlock];
 }
 
-- (BOOL)willReattemptRequest:(int)statusCode withRequest:(OneSignalRequest *)request success:(OSResultSuccessBlock)successBlock failure:(OSClientFailureBlock)failureBlock asyncRequest:(BOOL)async {
+- (BOOL)willReattemptRequest:(int)statusCode withRequest:(OneSignalRequest *)request responseHeaders:(NSDictionary *)headers success:(OSResultSuccessBlock)successBlock failure:(OSClientFailureBlock)failureBlock asyncRequest:(BOOL)async {
     // in the event that there is no network connection, NSURLSession will return status code 0
-    if ((statusCode >= 500 || statusCode == 0) && request.reattemptCount < MAX_ATTEMPT_COUNT - 1) {
+    if ((statusCode >= 500 || statusCode == 0) && request.reattemptCount < OSTuningConfig.sharedConfig.requestMaxAttempts - 1) {
         OSReattemptRequest *reattempt = [OSReattemptRequest withRequest:request successBlock:successBlock failureBlock:failureBlock];
         
         if (async) {
-            //retry again in an increasing interval calculated with reattemptDelay
-            double reattemptDelay = [self calculateReattemptDelay:request.reattemptCount];
-            [OneSignalLog onesignalLog:ONE_S_LL_DEBUG message:[NSString stringWithFormat:@"Re-scheduling request (%@) to be re-attempted in %.3f seconds due to failed HTTP request with status code %i", NSStringFromClass([request class]), reattemptDelay, (int)statusCode]];
-            [OneSignalCoreHelper dispatch_async_on_main_queue:^{
-                [self performSelector:@selector(reattemptRequest:) withObject:reattempt afterDelay:reattemptDelay];
+            //retry again in a jittered, increasing interval, or when the server asks us to
+            double reattemptDelay = [OSRetryScheduler delayForReattemptCount:request.reattemptCount retryAfter:[OSRetryScheduler retryAfterFromHeaders:headers]];
+            [OneSignalLog onesignalLog:ONE_S_LL_DEBUG messageBlock:^NSString *{
+                return [NSString stringWithFormat:@"Re-scheduling request (%@) to be re-attempted in %.3f seconds due to failed HTTP request with status code %i", NSStringFromClass([request class]), reattemptDelay, (int)statusCode];
             }];
+            [[OSRetryScheduler sharedScheduler] scheduleReattempt:^{
+                [self reattemptRequest:reattempt];
+            } afterDelay:reattemptDelay];
         } else {
             //retry again immediately
             [self reattemptRequest: reattempt];
@@ -170,11 +508,6 @@
     return false;
 }
 
-// A request will retry with intervals of 5, 15 , 45, 135 seconds...
-- (double)calculateReattemptDelay:(int)reattemptCount {
-    return REATTEMPT_DELAY * pow(3, reattemptCount);
-}
-
 - (void)prettyPrintDebugStatementWithRequest:(OneSignalRequest *)request {
     if (![NSJSONSerialization isValidJSONObject:request.parameters])
         return;
@@ -190,25 +523,41 @@
     
     NSString *jsonString = [[NSString alloc] initWithData:data encoding:NSUTF8StringEncoding];
 
-    [OneSignalLog onesignalLog:ONE_S_LL_VERBOSE message:[NSString stringWithFormat:@"HTTP Request (%@) with URL: %@, with parameters: %@ and headers: %@", NSStringFromClass([request class]), request.urlRequest.URL.absoluteString, jsonString, request.additionalHeaders]];
+    ONE_S_LOG(ONE_S_LL_VERBOSE, @"HTTP Request (%@) with URL: %@, with parameters: %@ and headers: %@", NSStringFromClass([request class]), request.urlRequest.URL.absoluteString, jsonString, request.additionalHeaders);
 }
 
 - (void)handleJSONNSURLResponse:(NSURLResponse*)response data:(NSData*)data error:(NSError*)error isAsync:(BOOL)async withRequest:(OneSignalRequest *)request onSuccess:(OSResultSuccessBlock)successBlock onFailure:(OSClientFailureBlock)failureBlock {
+    // Decode large payloads, such as the IAM list or a fetched user, off the session's serial delegate queue
+    // so they do not hold up the completion of other requests
+    if (async && data.length > OS_LARGE_RESPONSE_BYTES) {
+        dispatch_async(OSDispatchQueues.utility, ^{
+            [self decodeJSONNSURLResponse:response data:data error:error isAsync:async withRequest:request onSuccess:successBlock onFailure:failureBlock];
+        });
+        return;
+    }
+    [self decodeJSONNSURLResponse:response data:data error:error isAsync:async withRequest:request onSuccess:successBlock onFailure:failureBlock];
+}
+
+- (void)decodeJSONNSURLResponse:(NSURLResponse*)response data:(NSData*)data error:(NSError*)error isAsync:(BOOL)async withRequest:(OneSignalRequest *)request onSuccess:(OSResultSuccessBlock)successBlock onFailure:(OSClientFailureBlock)failureBlock {
     
     NSHTTPURLResponse* HTTPResponse = (NSHTTPURLResponse*)response;
     NSInteger statusCode = [HTTPResponse statusCode];
     NSDictionary *headers = [HTTPResponse allHeaderFields]; // can be null
     NSError* jsonError = nil;
-    NSMutableDictionary* innerJson;
+    NSDictionary* innerJson;
     
+    // The status code and headers are not injected into the payload, so it is parsed into immutable containers.
+    // They reach callers through OneSignalClientError on failure.
     if (data != nil && [data length] > 0) {
-        innerJson = [NSJSONSerialization JSONObjectWithData:data options:NSJSONReadingMutableContainers error:&jsonError];
-        innerJson[@"httpStatusCode"] = [NSNumber numberWithLong:statusCode];
-        innerJson[@"headers"] = headers;
+        innerJson = [NSJSONSerialization JSONObjectWithData:data options:0 error:&jsonError];
         
-        [OneSignalLog onesignalLog:ONE_S_LL_VERBOSE message:[NSString stringWithFormat:@"network request (%@) with URL %@ and headers: %@", NSStringFromClass([request class]), request.urlRequest.URL.absoluteString, request.additionalHeaders]];
+        [OneSignalLog onesignalLog:ONE_S_LL_VERBOSE messageBlock:^NSString *{
+            return [NSString stringWithFormat:@"network request (%@) with URL %@ and headers: %@", NSStringFromClass([request class]), request.urlRequest.URL.absoluteString, request.additionalHeaders];
+        }];
 
-        [OneSignalLog onesignalLog:ONE_S_LL_VERBOSE message:[NSString stringWithFormat:@"network response (%@) with URL %@: %@", NSStringFromClass([request class]), request.urlRequest.URL.absoluteString, innerJson]];
+        [OneSignalLog onesignalLog:ONE_S_LL_VERBOSE messageBlock:^NSString *{
+            return [NSString stringWithFormat:@"network response (%@) with URL %@: %@", NSStringFromClass([request class]), request.urlRequest.URL.absoluteString, innerJson];
+        }];
         if (jsonError) {
             if (failureBlock != nil)
                 failureBlock([[OneSignalClientError alloc] initWithCode:statusCode message:@"Error parsing JSON" responseHeaders:headers response:nil underlyingError:jsonError]);
@@ -216,9 +565,14 @@
         }
     }
     
-    if ([self willReattemptRequest:(int)statusCode withRequest:request success:successBlock failure:failureBlock asyncRequest:async])
+    // A cancelled request also has no status code, but must not be reattempted
+    BOOL cancelled = [error.domain isEqualToString:NSURLErrorDomain] && error.code == NSURLErrorCancelled;
+    if (!cancelled && [self willReattemptRequest:(int)statusCode withRequest:request responseHeaders:headers success:successBlock failure:failureBlock asyncRequest:async])
         return;
     
+    request.responseHeaders = headers;
+    request.responseStatusCode = statusCode;
+    
     if (error == nil && (statusCode == 200 || statusCode == 201 || statusCode == 202)) {
         if (successBlock != nil) {
             if (innerJson != nil)
@@ -47,9 +47,37 @@ typedef enum : NSInteger {
  */
 + (instancetype)reachabilityForInternetConnection;
 
+/*!
+ * A shared instance for the default route, with its notifier already started.
+ * From iOS 12 it follows an NWPathMonitor, which also reports whether the path is expensive or constrained.
+ */
++ (instancetype)sharedInternetReachability;
+
+/*!
+ * The current path is cellular or a personal hotspot. Only known once the path monitor is started, NO before that.
+ */
+@property (nonatomic, readonly) BOOL isExpensive;
+
+/*!
+ * The user turned on Low Data Mode for the current path, from iOS 13. Only known once the path monitor is started, NO before that.
+ */
+@property (nonatomic, readonly) BOOL isConstrained;
+
+/*!
+ * Whether discretionary traffic, such as prefetching content ahead of display, should go out on the current path.
+ */
+- (BOOL)allowsPrefetch;
+
 /*!
  * WWAN may be available, but not active until a connection has been established. WiFi may require a connection for VPN on Demand.
  */
 - (BOOL)connectionRequired;
 
+/*!
+ * Starts posting OS_REACHABILITY_CHANGED_NOTIFICATION, with this instance as the object, whenever reachability changes,
+ * and from iOS 12 whenever the path becomes or stops being expensive or constrained.
+ */
+- (BOOL)startNotifier;
+- (void)stopNotifier;
+
 @end
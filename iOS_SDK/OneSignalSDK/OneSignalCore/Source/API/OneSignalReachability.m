@@ -31,8 +31,20 @@
 #import <sys/socket.h>
 // TODO: Before GA: There is a better native way to work with this, using different imports
 #import <CoreFoundation/CoreFoundation.h>
+#import <Network/Network.h>
 
 #import "OneSignalReachability.h"
+#import "OneSignalCommonDefines.h"
+#import "OSDispatchQueues.h"
+
+
+#pragma mark - Supporting functions
+
+static void ReachabilityCallback(SCNetworkReachabilityRef target, SCNetworkReachabilityFlags flags, void* info)
+{
+    OneSignalReachability* noteObject = (__bridge OneSignalReachability *)info;
+    [[NSNotificationCenter defaultCenter] postNotificationName:OS_REACHABILITY_CHANGED_NOTIFICATION object:noteObject];
+}
 
 
 #pragma mark - Reachability implementation
@@ -41,6 +53,13 @@
 {
     BOOL _alwaysReturnLocalWiFiStatus; //default is NO
     SCNetworkReachabilityRef _reachabilityRef;
+    // From iOS 12 the notifier follows a path monitor instead of the reachability callback
+    id _pathMonitor;
+    // The last path the monitor reported, synchronized on self
+    BOOL _hasPath;
+    NetworkStatus _pathStatus;
+    BOOL _isExpensive;
+    BOOL _isConstrained;
 }
 
 + (instancetype)reachabilityWithAddress:(const struct sockaddr_in *)hostAddress
@@ -75,8 +94,99 @@
     return [self reachabilityWithAddress:&zeroAddress];
 }
 
+#pragma mark - Start and stop notifier
+
+- (BOOL)startNotifier
+{
+    if (@available(iOS 12.0, *)) {
+        [self startPathMonitor];
+        return YES;
+    }
+    SCNetworkReachabilityContext context = {0, (__bridge void *)(self), NULL, NULL, NULL};
+    
+    if (!SCNetworkReachabilitySetCallback(_reachabilityRef, ReachabilityCallback, &context))
+    {
+        return NO;
+    }
+    
+    dispatch_queue_t queue = dispatch_queue_create_with_target("com.onesignal.reachability", DISPATCH_QUEUE_SERIAL, OSDispatchQueues.utility);
+    if (!SCNetworkReachabilitySetDispatchQueue(_reachabilityRef, queue))
+    {
+        SCNetworkReachabilitySetCallback(_reachabilityRef, NULL, NULL);
+        return NO;
+    }
+    
+    return YES;
+}
+
+- (void)startPathMonitor API_AVAILABLE(ios(12.0))
+{
+    if (_pathMonitor)
+        return;
+    nw_path_monitor_t monitor = nw_path_monitor_create();
+    dispatch_queue_t queue = dispatch_queue_create_with_target("com.onesignal.reachability", DISPATCH_QUEUE_SERIAL, OSDispatchQueues.utility);
+    nw_path_monitor_set_queue(monitor, queue);
+    __weak OneSignalReachability *weakSelf = self;
+    nw_path_monitor_set_update_handler(monitor, ^(nw_path_t path) {
+        [weakSelf pathDidUpdate:path];
+    });
+    _pathMonitor = monitor;
+    nw_path_monitor_start(monitor);
+}
+
+- (void)pathDidUpdate:(nw_path_t)path API_AVAILABLE(ios(12.0))
+{
+    nw_path_status_t pathStatus = nw_path_get_status(path);
+    NetworkStatus status = NotReachable;
+    // Satisfiable paths need a connection to come up first, such as VPN on demand, like the reachability on-demand flags
+    if (pathStatus == nw_path_status_satisfied || pathStatus == nw_path_status_satisfiable)
+        status = nw_path_uses_interface_type(path, nw_interface_type_cellular) ? ReachableViaWWAN : ReachableViaWiFi;
+    BOOL isExpensive = nw_path_is_expensive(path);
+    BOOL isConstrained = NO;
+    if (@available(iOS 13.0, *)) {
+        isConstrained = nw_path_is_constrained(path);
+    }
+
+    @synchronized (self) {
+        if (_hasPath && _pathStatus == status && _isExpensive == isExpensive && _isConstrained == isConstrained)
+            return;
+        _hasPath = YES;
+        _pathStatus = status;
+        _isExpensive = isExpensive;
+        _isConstrained = isConstrained;
+    }
+    [[NSNotificationCenter defaultCenter] postNotificationName:OS_REACHABILITY_CHANGED_NOTIFICATION object:self];
+}
+
+- (void)stopNotifier
+{
+    if (@available(iOS 12.0, *)) {
+        if (_pathMonitor) {
+            nw_path_monitor_cancel(_pathMonitor);
+            _pathMonitor = nil;
+        }
+    }
+    if (_reachabilityRef != NULL)
+    {
+        SCNetworkReachabilitySetDispatchQueue(_reachabilityRef, NULL);
+        SCNetworkReachabilitySetCallback(_reachabilityRef, NULL, NULL);
+    }
+}
+
++ (instancetype)sharedInternetReachability
+{
+    static OneSignalReachability *sharedReachability = nil;
+    static dispatch_once_t once;
+    dispatch_once(&once, ^{
+        sharedReachability = [self reachabilityForInternetConnection];
+        [sharedReachability startNotifier];
+    });
+    return sharedReachability;
+}
+
 - (void)dealloc
 {
+    [self stopNotifier];
     if (_reachabilityRef != NULL)
     {
         CFRelease(_reachabilityRef);
@@ -150,8 +260,33 @@
 }
 
 
+- (BOOL)isExpensive
+{
+    @synchronized (self) {
+        return _isExpensive;
+    }
+}
+
+- (BOOL)isConstrained
+{
+    @synchronized (self) {
+        return _isConstrained;
+    }
+}
+
+- (BOOL)allowsPrefetch
+{
+    @synchronized (self) {
+        return !_isExpensive && !_isConstrained;
+    }
+}
+
 - (NetworkStatus)currentReachabilityStatus
 {
+    @synchronized (self) {
+        if (_hasPath)
+            return _pathStatus;
+    }
     NSAssert(_reachabilityRef != NULL, @"currentNetworkStatus called with NULL SCNetworkReachabilityRef");
     NetworkStatus returnValue = NotReachable;
     SCNetworkReachabilityFlags flags;
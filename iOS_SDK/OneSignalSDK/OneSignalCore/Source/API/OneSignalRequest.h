@@ -38,6 +38,15 @@
 typedef void (^OSResultSuccessBlock)(NSDictionary* result);
 typedef void (^OSFailureBlock)(NSError* error);
 
+@class OSDeltaTrace;
+
+/*Order in which requests held back while offline are released*/
+typedef NS_ENUM(NSInteger, OSRequestPriority) {
+    OSRequestPriorityLow = -1,
+    OSRequestPriorityNormal = 0,
+    OSRequestPriorityHigh = 1
+};
+
 @interface OneSignalRequest : NSObject
 
 @property (nonatomic) BOOL disableLocalCaching;
@@ -48,6 +57,21 @@ typedef void (^OSFailureBlock)(NSError* error);
 @property (nonatomic) int reattemptCount;
 @property (nonatomic) BOOL dataRequest; //false for JSON based requests
 @property (nonatomic) NSDate *timestamp;
+@property (nonatomic) OSRequestPriority priority;
+// Sent as a background upload that may finish after the app is suspended, for requests whose result is not needed right away
+@property (nonatomic) BOOL deferrable;
+// Seconds the system waits before starting a deferrable request, 0 to start it right away
+@property (nonatomic) NSTimeInterval deferralDelay;
+// Deferrable requests with a key can be cancelled by it with OneSignalClient's cancelDeferredRequestsWithKey:
+@property (strong, nonatomic, nullable) NSString *deferralKey;
+// GET requests with the same key share one network task while it is in flight, nil to never share
+@property (strong, nonatomic, nullable) NSString *idempotencyKey;
+// Headers of the last response to this request, set before its success or failure block is called
+@property (strong, nonatomic, nullable) NSDictionary *responseHeaders;
+// Status code of the last response to this request, set along with `responseHeaders`, 0 until a response is received
+@property (nonatomic) NSInteger responseStatusCode;
+// The deltas this request was built from, recorded into OSDeltaLifecycleMetrics once the request succeeds
+@property (strong, nonatomic, nullable) NSArray<OSDeltaTrace *> *deltaTraces;
 -(BOOL)missingAppId; //for requests that don't require an appId parameter, the subclass should override this method and return false
 -(NSMutableURLRequest * _Nonnull )urlRequest;
 
@@ -34,7 +34,13 @@
 #define HTTP_HEADER_KEY_OS_WRAPPER @"SDK-Wrapper"
 #define HTTP_HEADER_PREFIX_OS_VERSION @"onesignal/ios/"
 
-@implementation OneSignalRequest
+@implementation OneSignalRequest {
+    /*
+     Built on the first read of `urlRequest` and reused by the client for execution, logging and reattempts.
+     Dropped when the path, method, headers or parameters are set. Access is synchronized on self.
+     */
+    NSMutableURLRequest *_cachedURLRequest;
+}
 
 - (id)init {
     if (self = [super init]) {
@@ -51,12 +57,62 @@
         self.dataRequest = false;
         
         self.timestamp = [NSDate date];
+        
+        self.priority = OSRequestPriorityNormal;
+        
+        self.deferrable = false;
+        
+        self.deferralDelay = 0;
     }
     
     return self;
 }
 
+- (void)setPath:(NSString *)path {
+    @synchronized (self) {
+        _path = path;
+        _cachedURLRequest = nil;
+    }
+}
+
+- (void)setMethod:(HTTPMethod)method {
+    @synchronized (self) {
+        _method = method;
+        _cachedURLRequest = nil;
+    }
+}
+
+- (void)setParameters:(NSDictionary *)parameters {
+    @synchronized (self) {
+        _parameters = parameters;
+        _cachedURLRequest = nil;
+    }
+}
+
+- (void)setAdditionalHeaders:(NSDictionary<NSString *,NSString *> *)additionalHeaders {
+    @synchronized (self) {
+        _additionalHeaders = additionalHeaders;
+        _cachedURLRequest = nil;
+    }
+}
+
+- (void)setDataRequest:(BOOL)dataRequest {
+    @synchronized (self) {
+        _dataRequest = dataRequest;
+        _cachedURLRequest = nil;
+    }
+}
+
+// Callers get their own copy, so setting a cache policy on it does not change the cached request
 -(NSMutableURLRequest *)urlRequest {
+    @synchronized (self) {
+        if (!_cachedURLRequest)
+            _cachedURLRequest = [self buildURLRequest];
+        return [_cachedURLRequest mutableCopy];
+    }
+}
+
+-(NSMutableURLRequest *)buildURLRequest {
     //build URL
     NSString *urlString = [OS_API_SERVER_URL stringByAppendingString:self.path];
     
@@ -27,5 +27,6 @@
 
 #import <Foundation/Foundation.h>
 @interface NSDateFormatter (OneSignal)
+// Shared by all callers, do not change its properties
 + (instancetype)iso8601DateFormatter;
 @end
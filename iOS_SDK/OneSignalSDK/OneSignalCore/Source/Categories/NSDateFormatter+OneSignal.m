@@ -29,12 +29,20 @@
 
 @implementation NSDateFormatter (OneSignal)
 
+/*
+ Formatters are among the most expensive Foundation objects to create, so every caller shares one.
+ NSDateFormatter is thread safe for formatting and parsing as long as it is not changed, callers must not set its properties.
+ */
 + (instancetype)iso8601DateFormatter {
-    NSDateFormatter *dateFormatter = [NSDateFormatter new];
-    [dateFormatter setCalendar:[NSCalendar calendarWithIdentifier:NSCalendarIdentifierISO8601]];
-    [dateFormatter setTimeZone:[NSTimeZone timeZoneForSecondsFromGMT:0]];
-    [dateFormatter setLocale:[[NSLocale alloc] initWithLocaleIdentifier:@"en_US_POSIX"]];
-    [dateFormatter setDateFormat:@"yyyy-MM-dd'T'HH:mm:ss.SSSXXXXX"];
+    static NSDateFormatter *dateFormatter;
+    static dispatch_once_t once;
+    dispatch_once(&once, ^{
+        dateFormatter = [NSDateFormatter new];
+        [dateFormatter setCalendar:[NSCalendar calendarWithIdentifier:NSCalendarIdentifierISO8601]];
+        [dateFormatter setTimeZone:[NSTimeZone timeZoneForSecondsFromGMT:0]];
+        [dateFormatter setLocale:[[NSLocale alloc] initWithLocaleIdentifier:@"en_US_POSIX"]];
+        [dateFormatter setDateFormat:@"yyyy-MM-dd'T'HH:mm:ss.SSSXXXXX"];
+    });
     return dateFormatter;
 }
 
@@ -35,6 +35,8 @@
 + (BOOL)isIOSVersionGreaterThanOrEqual:(NSString *)version;
 + (BOOL)isIOSVersionLessThan:(NSString *)version;
 + (NSString*)getDeviceVariant;
+// The device variant and release mode are read once per process, this reads them on a background queue ahead of first use
++ (void)warmEnvironmentInBackground;
 
 @end
 
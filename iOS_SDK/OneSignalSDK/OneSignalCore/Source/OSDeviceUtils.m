@@ -29,6 +29,8 @@
 #import <UIKit/UIKit.h>
 #import "OSMacros.h"
 #import "OSDeviceUtils.h"
+#import "OneSignalMobileProvision.h"
+#import "OSDispatchQueues.h"
 
 @implementation OSDeviceUtils
 
@@ -45,17 +47,31 @@
 }
 
 + (NSString*)getSystemInfoMachine {
-    // e.g. @"x86_64" or @"iPhone9,3"
-    struct utsname systemInfo;
-    uname(&systemInfo);
-    return [NSString stringWithCString:systemInfo.machine
-                                         encoding:NSUTF8StringEncoding];
+    static NSString *systemInfoMachine;
+    static dispatch_once_t once;
+    dispatch_once(&once, ^{
+        // e.g. @"x86_64" or @"iPhone9,3"
+        struct utsname systemInfo;
+        uname(&systemInfo);
+        systemInfoMachine = [NSString stringWithCString:systemInfo.machine
+                                               encoding:NSUTF8StringEncoding];
+    });
+    return systemInfoMachine;
 }
 
 // This will get real device model if it is a real iOS device (Example iPhone8,2)
 // If an iOS Simulator it will return "Simulator iPhone" or "Simulator iPad"
 // If a macOS Catalyst app, return "Mac"
 + (NSString*)getDeviceVariant {
+    static NSString *deviceVariant;
+    static dispatch_once_t once;
+    dispatch_once(&once, ^{
+        deviceVariant = [self readDeviceVariant];
+    });
+    return deviceVariant;
+}
+
++ (NSString*)readDeviceVariant {
     let systemInfoMachine = [self getSystemInfoMachine];
 
     // x86_64 could mean an iOS Simulator or Catalyst app on macOS
@@ -72,4 +88,11 @@
     return systemInfoMachine;
 }
 
++ (void)warmEnvironmentInBackground {
+    dispatch_async(OSDispatchQueues.utility, ^{
+        [self getDeviceVariant];
+        [OneSignalMobileProvision releaseMode];
+    });
+}
+
 @end
@@ -0,0 +1,51 @@
+/**
+ * Modified MIT License
+ *
+ * Copyright 2024 OneSignal
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * 2. All copies of substantial portions of the Software may only be used in connection
+ * with services provided by OneSignal.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#import <Foundation/Foundation.h>
+
+#ifndef OSDispatchQueues_h
+#define OSDispatchQueues_h
+
+/**
+ The root queues every SDK queue targets, one per quality of service, so the SDK's work is classified
+ deliberately instead of running at the default QoS of the global queues and competing with the app's UI.
+ - `userInitiated` for work the user is waiting on, such as login and the notification permission flow.
+ - `utility` for flushing deltas, sending requests and persisting state.
+ - `background` for telemetry, log listeners and compacting or pruning caches.
+ The roots are concurrent, as SDK queues call `sync` on each other, such as the operation repo asking an executor
+ for pending work, which would deadlock on a shared serial root. Create serial queues that target them with
+ `dispatch_queue_create_with_target` or `DispatchQueue(label:target:)`, and use them directly for one-off work.
+ */
+@interface OSDispatchQueues : NSObject
+
+@property (class, readonly, nonnull) dispatch_queue_t userInitiated;
+@property (class, readonly, nonnull) dispatch_queue_t utility;
+@property (class, readonly, nonnull) dispatch_queue_t background;
+
+@end
+
+#endif /* OSDispatchQueues_h */
@@ -0,0 +1,74 @@
+/**
+ * Modified MIT License
+ *
+ * Copyright 2024 OneSignal
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * 2. All copies of substantial portions of the Software may only be used in connection
+ * with services provided by OneSignal.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#import <Foundation/Foundation.h>
+
+#ifndef OSFlightRecorder_h
+#define OSFlightRecorder_h
+
+typedef NS_ENUM(uint32_t, OSFlightRecorderEvent) {
+    // arg0: request class, arg1: task id
+    OSFlightRecorderEventRequestStarted = 1,
+    // arg0: status code, arg1: task id
+    OSFlightRecorderEventRequestFinished,
+    // arg0: request class, arg1: reattempt count
+    OSFlightRecorderEventRequestRetried,
+    // arg0: delta queue depth
+    OSFlightRecorderEventDeltaEnqueued,
+    // arg0: delta queue depth, arg1: 1 if in background
+    OSFlightRecorderEventDeltaQueueFlushed,
+    // arg0: 1 if idle, 0 if busy
+    OSFlightRecorderEventOperationRepoIdleChanged,
+    // arg0: 1 if the new user has an external id, 0 for an anonymous user
+    OSFlightRecorderEventUserSwitched
+};
+
+/**
+ Always-on capture of the most recent SDK events, for diagnosing field issues without verbose logging.
+ Each event is a fixed-size binary entry written into a ring buffer of OS_FLIGHT_RECORDER_CAPACITY entries,
+ so recording costs a lock and a few stores, never an allocation or string formatting.
+ */
+@interface OSFlightRecorder : NSObject
+
++ (void)record:(OSFlightRecorderEvent)event arg0:(int64_t)arg0 arg1:(int64_t)arg1 NS_SWIFT_NAME(record(_:arg0:arg1:));
+// Records a class by address, it is resolved to its name only when the events are read
++ (void)record:(OSFlightRecorderEvent)event class:(Class _Nonnull)cls arg1:(int64_t)arg1 NS_SWIFT_NAME(record(_:class:arg1:));
+
+/**
+ The recorded entries, oldest first, in the binary layout written by the recorder:
+ a "OSFR" magic, a uint32 version and a uint32 entry count, then per entry a double timestamp
+ (seconds since the reference date), a uint32 event, 4 bytes of padding and two int64 arguments, in host byte order.
+ Meant to be attached to crash reports or support tickets.
+ */
++ (NSData * _Nonnull)dump;
+// The recorded entries decoded into dictionaries with "timestamp", "event", "arg0" and "arg1"
++ (NSArray<NSDictionary<NSString *, id> *> * _Nonnull)events;
++ (void)clear;
+
+@end
+
+#endif /* OSFlightRecorder_h */
@@ -0,0 +1,130 @@
+/**
+ * Modified MIT License
+ *
+ * Copyright 2024 OneSignal
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * 2. All copies of substantial portions of the Software may only be used in connection
+ * with services provided by OneSignal.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#import <Foundation/Foundation.h>
+#import <pthread.h>
+#import "OSFlightRecorder.h"
+#import "OneSignalCommonDefines.h"
+
+#define OS_FLIGHT_RECORDER_MAGIC "OSFR"
+#define OS_FLIGHT_RECORDER_VERSION 1
+
+typedef struct {
+    double timestamp;
+    uint32_t event;
+    uint32_t padding;
+    int64_t arg0;
+    int64_t arg1;
+} OSFlightRecorderEntry;
+
+static OSFlightRecorderEntry _entries[OS_FLIGHT_RECORDER_CAPACITY];
+// Total entries ever recorded, the next entry is written at `_recorded % OS_FLIGHT_RECORDER_CAPACITY`
+static uint64_t _recorded = 0;
+static pthread_mutex_t _lock = PTHREAD_MUTEX_INITIALIZER;
+
+@implementation OSFlightRecorder
+
++ (void)record:(OSFlightRecorderEvent)event arg0:(int64_t)arg0 arg1:(int64_t)arg1 {
+    double timestamp = CFAbsoluteTimeGetCurrent();
+    pthread_mutex_lock(&_lock);
+    OSFlightRecorderEntry *entry = &_entries[_recorded % OS_FLIGHT_RECORDER_CAPACITY];
+    entry->timestamp = timestamp;
+    entry->event = event;
+    entry->arg0 = arg0;
+    entry->arg1 = arg1;
+    _recorded++;
+    pthread_mutex_unlock(&_lock);
+}
+
++ (void)record:(OSFlightRecorderEvent)event class:(Class)cls arg1:(int64_t)arg1 {
+    [self record:event arg0:(int64_t)(uintptr_t)cls arg1:arg1];
+}
+
++ (NSData *)dump {
+    pthread_mutex_lock(&_lock);
+    uint32_t count = (uint32_t)MIN(_recorded, (uint64_t)OS_FLIGHT_RECORDER_CAPACITY);
+    uint32_t version = OS_FLIGHT_RECORDER_VERSION;
+    NSMutableData *data = [NSMutableData dataWithCapacity:12 + count * sizeof(OSFlightRecorderEntry)];
+    [data appendBytes:OS_FLIGHT_RECORDER_MAGIC length:4];
+    [data appendBytes:&version length:sizeof(version)];
+    [data appendBytes:&count length:sizeof(count)];
+    for (uint64_t i = _recorded - count; i < _recorded; i++) {
+        [data appendBytes:&_entries[i % OS_FLIGHT_RECORDER_CAPACITY] length:sizeof(OSFlightRecorderEntry)];
+    }
+    pthread_mutex_unlock(&_lock);
+    return data;
+}
+
++ (NSArray<NSDictionary<NSString *, id> *> *)events {
+    NSData *dump = [self dump];
+    uint32_t count;
+    [dump getBytes:&count range:NSMakeRange(8, sizeof(count))];
+    NSMutableArray *events = [NSMutableArray arrayWithCapacity:count];
+    for (uint32_t i = 0; i < count; i++) {
+        OSFlightRecorderEntry entry;
+        [dump getBytes:&entry range:NSMakeRange(12 + i * sizeof(OSFlightRecorderEntry), sizeof(entry))];
+        id arg0 = @(entry.arg0);
+        if (entry.event == OSFlightRecorderEventRequestStarted || entry.event == OSFlightRecorderEventRequestRetried) {
+            arg0 = NSStringFromClass((__bridge Class)(void *)(uintptr_t)entry.arg0) ?: arg0;
+        }
+        [events addObject:@{
+            @"timestamp": [NSDate dateWithTimeIntervalSinceReferenceDate:entry.timestamp],
+            @"event": [self nameOfEvent:entry.event],
+            @"arg0": arg0,
+            @"arg1": @(entry.arg1)
+        }];
+    }
+    return events;
+}
+
++ (NSString *)nameOfEvent:(OSFlightRecorderEvent)event {
+    switch (event) {
+        case OSFlightRecorderEventRequestStarted:
+            return @"RequestStarted";
+        case OSFlightRecorderEventRequestFinished:
+            return @"RequestFinished";
+        case OSFlightRecorderEventRequestRetried:
+            return @"RequestRetried";
+        case OSFlightRecorderEventDeltaEnqueued:
+            return @"DeltaEnqueued";
+        case OSFlightRecorderEventDeltaQueueFlushed:
+            return @"DeltaQueueFlushed";
+        case OSFlightRecorderEventOperationRepoIdleChanged:
+            return @"OperationRepoIdleChanged";
+        case OSFlightRecorderEventUserSwitched:
+            return @"UserSwitched";
+    }
+    return [NSString stringWithFormat:@"%u", event];
+}
+
++ (void)clear {
+    pthread_mutex_lock(&_lock);
+    _recorded = 0;
+    pthread_mutex_unlock(&_lock);
+}
+
+@end
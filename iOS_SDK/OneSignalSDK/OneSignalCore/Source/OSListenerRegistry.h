@@ -0,0 +1,46 @@
+/**
+ * Modified MIT License
+ *
+ * Copyright 2024 OneSignal
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * 2. All copies of substantial portions of the Software may only be used in connection
+ * with services provided by OneSignal.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#import <Foundation/Foundation.h>
+
+#ifndef OSListenerRegistry_h
+#define OSListenerRegistry_h
+
+/**
+ Holds strong references to listeners that may be added, removed and fired from any thread.
+ Every add or remove publishes a new immutable snapshot, so firing iterates `listeners` without taking a lock,
+ and a listener added or removed while firing only affects later snapshots.
+ */
+@interface OSListenerRegistry<__covariant ListenerType> : NSObject
+@property (readonly, nonnull) NSArray<ListenerType> *listeners;
+@property (readonly) NSUInteger count;
+- (void)addListener:(ListenerType _Nonnull)listener;
+- (void)removeListener:(ListenerType _Nonnull)listener;
+- (void)removeAllListeners;
+@end
+
+#endif /* OSListenerRegistry_h */
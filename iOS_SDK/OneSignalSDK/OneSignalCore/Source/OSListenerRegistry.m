@@ -0,0 +1,72 @@
+/**
+ * Modified MIT License
+ *
+ * Copyright 2024 OneSignal
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * 2. All copies of substantial portions of the Software may only be used in connection
+ * with services provided by OneSignal.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#import <Foundation/Foundation.h>
+#import "OSListenerRegistry.h"
+
+@interface OSListenerRegistry ()
+// Only replaced, never mutated. Readers load it atomically, writers publish a new array under the lock.
+@property (atomic, copy, nonnull) NSArray *snapshot;
+@end
+
+@implementation OSListenerRegistry
+
+- (instancetype)init {
+    if (self = [super init])
+        _snapshot = @[];
+    return self;
+}
+
+- (NSArray *)listeners {
+    return self.snapshot;
+}
+
+- (NSUInteger)count {
+    return self.snapshot.count;
+}
+
+- (void)addListener:(id)listener {
+    @synchronized (self) {
+        self.snapshot = [self.snapshot arrayByAddingObject:listener];
+    }
+}
+
+- (void)removeListener:(id)listener {
+    @synchronized (self) {
+        NSMutableArray *listeners = [self.snapshot mutableCopy];
+        [listeners removeObject:listener];
+        self.snapshot = listeners;
+    }
+}
+
+- (void)removeAllListeners {
+    @synchronized (self) {
+        self.snapshot = @[];
+    }
+}
+
+@end
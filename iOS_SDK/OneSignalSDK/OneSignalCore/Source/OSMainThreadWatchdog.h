@@ -0,0 +1,60 @@
+/**
+ * Modified MIT License
+ *
+ * Copyright 2024 OneSignal
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * 2. All copies of substantial portions of the Software may only be used in connection
+ * with services provided by OneSignal.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#import <Foundation/Foundation.h>
+
+#ifndef OSMainThreadWatchdog_h
+#define OSMainThreadWatchdog_h
+
+/**
+ Reports SDK blocks that keep the main thread busy, so the SDK stays out of the app's hang reports.
+ While DEBUG logging is enabled, blocks the SDK sends to main through OneSignalCoreHelper are timed and each one
+ running longer than OS_MAIN_THREAD_WATCHDOG_THRESHOLD_MS is counted against its call site, the method that dispatched it.
+ Only UI work should reach main, a call site showing up in the snapshot is work to move to an OSDispatchQueues queue.
+ */
+@interface OSMainThreadWatchdog : NSObject
+
++ (BOOL)isEnabled;
+
+/**
+ Runs the block, timing it when enabled. The call site is the return address of the dispatching call,
+ such as `__builtin_return_address(0)`, and is only symbolicated when the block is over the threshold.
+ */
++ (void)runBlock:(dispatch_block_t _Nonnull)block fromAddress:(const void * _Nullable)address;
++ (void)runBlock:(dispatch_block_t _Nonnull)block callSite:(NSString * _Nonnull)callSite;
+
+/**
+ The blocks over the threshold so far, by call site:
+ { "threshold_ms": 16, "slow_blocks": 2, "max_ms": 40, "sites": { "-[OSMessagingController sendMessageImpression:]": { "count": 2, "max_ms": 40, "total_ms": 61 } } }
+ */
++ (NSDictionary<NSString *, id> * _Nonnull)snapshot;
++ (void)reset;
+
+@end
+
+#endif /* OSMainThreadWatchdog_h */
@@ -0,0 +1,145 @@
+/**
+ * Modified MIT License
+ *
+ * Copyright 2024 OneSignal
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * 2. All copies of substantial portions of the Software may only be used in connection
+ * with services provided by OneSignal.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#import <dlfcn.h>
+#import "OSMainThreadWatchdog.h"
+#import "OneSignalLog.h"
+#import "OneSignalCommonDefines.h"
+
+@interface OSMainThreadSiteStatistics : NSObject
+@property (nonatomic) NSUInteger count;
+@property (nonatomic) double maxMilliseconds;
+@property (nonatomic) double totalMilliseconds;
+@end
+
+@implementation OSMainThreadSiteStatistics
+@end
+
+static NSMutableDictionary<NSString *, OSMainThreadSiteStatistics *> *siteStatistics;
+static NSUInteger slowBlocks;
+static double maxMilliseconds;
+
+@implementation OSMainThreadWatchdog
+
++ (void)initialize {
+    if (self == [OSMainThreadWatchdog class]) {
+        siteStatistics = [NSMutableDictionary new];
+    }
+}
+
++ (BOOL)isEnabled {
+    return [OneSignalLog isLogLevelEnabled:ONE_S_LL_DEBUG];
+}
+
++ (void)runBlock:(dispatch_block_t)block fromAddress:(const void *)address {
+    if (![self isEnabled]) {
+        block();
+        return;
+    }
+    CFAbsoluteTime start = CFAbsoluteTimeGetCurrent();
+    block();
+    double milliseconds = (CFAbsoluteTimeGetCurrent() - start) * 1000;
+    if (milliseconds > OS_MAIN_THREAD_WATCHDOG_THRESHOLD_MS) {
+        [self recordBlockOf:milliseconds atCallSite:[self callSiteForAddress:address]];
+    }
+}
+
++ (void)runBlock:(dispatch_block_t)block callSite:(NSString *)callSite {
+    if (![self isEnabled]) {
+        block();
+        return;
+    }
+    CFAbsoluteTime start = CFAbsoluteTimeGetCurrent();
+    block();
+    double milliseconds = (CFAbsoluteTimeGetCurrent() - start) * 1000;
+    if (milliseconds > OS_MAIN_THREAD_WATCHDOG_THRESHOLD_MS) {
+        [self recordBlockOf:milliseconds atCallSite:callSite];
+    }
+}
+
++ (NSString *)callSiteForAddress:(const void *)address {
+    Dl_info info;
+    if (!address || !dladdr(address, &info)) {
+        return @"unknown";
+    }
+    if (info.dli_sname) {
+        return [NSString stringWithUTF8String:info.dli_sname];
+    }
+    // Stripped builds have no symbols, the image offset can be symbolicated with the dSYM
+    NSString *image = info.dli_fname ? [[NSString stringWithUTF8String:info.dli_fname] lastPathComponent] : @"unknown";
+    return [NSString stringWithFormat:@"%@+0x%lx", image, (unsigned long)((uintptr_t)address - (uintptr_t)info.dli_fbase)];
+}
+
++ (void)recordBlockOf:(double)milliseconds atCallSite:(NSString *)callSite {
+    @synchronized (siteStatistics) {
+        slowBlocks++;
+        maxMilliseconds = MAX(maxMilliseconds, milliseconds);
+        OSMainThreadSiteStatistics *statistics = siteStatistics[callSite];
+        if (!statistics) {
+            if (siteStatistics.count >= OS_MAIN_THREAD_WATCHDOG_SITE_LIMIT) {
+                return;
+            }
+            statistics = [OSMainThreadSiteStatistics new];
+            siteStatistics[callSite] = statistics;
+        }
+        statistics.count++;
+        statistics.maxMilliseconds = MAX(statistics.maxMilliseconds, milliseconds);
+        statistics.totalMilliseconds += milliseconds;
+    }
+    [OneSignalLog onesignalLog:ONE_S_LL_DEBUG message:[NSString stringWithFormat:@"OSMainThreadWatchdog: %@ ran on the main thread for %.1fms", callSite, milliseconds]];
+}
+
++ (NSDictionary<NSString *, id> *)snapshot {
+    @synchronized (siteStatistics) {
+        NSMutableDictionary<NSString *, NSDictionary *> *sites = [NSMutableDictionary new];
+        for (NSString *callSite in siteStatistics) {
+            OSMainThreadSiteStatistics *statistics = siteStatistics[callSite];
+            sites[callSite] = @{
+                @"count": @(statistics.count),
+                @"max_ms": @(statistics.maxMilliseconds),
+                @"total_ms": @(statistics.totalMilliseconds)
+            };
+        }
+        return @{
+            @"threshold_ms": @(OS_MAIN_THREAD_WATCHDOG_THRESHOLD_MS),
+            @"slow_blocks": @(slowBlocks),
+            @"max_ms": @(maxMilliseconds),
+            @"sites": sites
+        };
+    }
+}
+
++ (void)reset {
+    @synchronized (siteStatistics) {
+        [siteStatistics removeAllObjects];
+        slowBlocks = 0;
+        maxMilliseconds = 0;
+    }
+}
+
+@end
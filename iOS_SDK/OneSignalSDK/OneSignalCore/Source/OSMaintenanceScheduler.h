@@ -0,0 +1,67 @@
+/**
+ * Modified MIT License
+ *
+ * Copyright 2024 OneSignal
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * 2. All copies of substantial portions of the Software may only be used in connection
+ * with services provided by OneSignal.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#import <Foundation/Foundation.h>
+
+#ifndef OSMaintenanceScheduler_h
+#define OSMaintenanceScheduler_h
+
+/**
+ Housekeeping jobs from across the SDK, such as pruning caches and stale records, run together at most once per
+ OS_MAINTENANCE_INTERVAL instead of inline on hot paths. Modules register their jobs when they start.
+ The app runs them from a BGProcessingTask while the device is idle and charging, or when the app is backgrounded
+ if it does not permit OS_MAINTENANCE_TASK_IDENTIFIER, so foreground sessions do no housekeeping.
+ */
+// A job calls completion once its work is done, which may be after the block returns
+typedef void (^OSMaintenanceJobBlock)(dispatch_block_t _Nonnull completion);
+
+@interface OSMaintenanceScheduler : NSObject
+
++ (OSMaintenanceScheduler * _Nonnull)sharedScheduler;
+
+/**
+ Jobs run one at a time off the main thread, in the order registered. A name registered again replaces its job.
+ The next job starts when the job calls its completion, or after OS_MAINTENANCE_JOB_TIMEOUT.
+ */
+- (void)registerJob:(NSString * _Nonnull)name block:(OSMaintenanceJobBlock _Nonnull)block;
+
+// When the jobs are next due, nil if they are due now
+- (NSDate * _Nullable)nextRunDate;
+- (BOOL)isDue;
+
+/**
+ Runs the jobs on a background queue, asking shouldContinue before each one so a run can stop when its time expires.
+ The completion runs on that queue, finished is true when every job ran, which is when the run counts as complete.
+ A run with no jobs registered does not count, so jobs registered later are still due.
+ A run requested while another is in progress completes right away, unfinished.
+ */
+- (void)runJobsWithShouldContinue:(BOOL (^ _Nonnull)(void))shouldContinue completion:(void (^ _Nullable)(BOOL finished))completion;
+
+@end
+
+#endif /* OSMaintenanceScheduler_h */
@@ -0,0 +1,151 @@
+/**
+ * Modified MIT License
+ *
+ * Copyright 2024 OneSignal
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * 2. All copies of substantial portions of the Software may only be used in connection
+ * with services provided by OneSignal.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#import "OSMaintenanceScheduler.h"
+#import "OSDispatchQueues.h"
+#import "OneSignalLog.h"
+#import "OneSignalUserDefaults.h"
+#import "OneSignalCommonDefines.h"
+
+@interface OSMaintenanceJob : NSObject
+@property (strong, nonatomic) NSString *name;
+@property (copy, nonatomic) OSMaintenanceJobBlock block;
+@end
+
+@implementation OSMaintenanceJob
+@end
+
+@interface OSMaintenanceScheduler ()
+// Synchronized on self
+@property (strong, nonatomic) NSMutableArray<OSMaintenanceJob *> *jobs;
+@property (nonatomic) BOOL running;
+@property (strong, nonatomic) dispatch_queue_t queue;
+@end
+
+@implementation OSMaintenanceScheduler
+
++ (OSMaintenanceScheduler *)sharedScheduler {
+    static OSMaintenanceScheduler *sharedScheduler = nil;
+    static dispatch_once_t once;
+    dispatch_once(&once, ^{
+        sharedScheduler = [OSMaintenanceScheduler new];
+    });
+    return sharedScheduler;
+}
+
+- (instancetype)init {
+    if (self = [super init]) {
+        _jobs = [NSMutableArray new];
+        _queue = dispatch_queue_create_with_target("com.onesignal.maintenance", DISPATCH_QUEUE_SERIAL, OSDispatchQueues.background);
+    }
+    return self;
+}
+
+- (void)registerJob:(NSString *)name block:(OSMaintenanceJobBlock)block {
+    OSMaintenanceJob *job = [OSMaintenanceJob new];
+    job.name = name;
+    job.block = block;
+    @synchronized (self) {
+        for (NSUInteger i = 0; i < self.jobs.count; i++) {
+            if ([self.jobs[i].name isEqualToString:name]) {
+                self.jobs[i] = job;
+                return;
+            }
+        }
+        [self.jobs addObject:job];
+    }
+}
+
+- (NSDate *)nextRunDate {
+    double lastRun = [OneSignalUserDefaults.initStandard getSavedDoubleForKey:OSUD_MAINTENANCE_LAST_RUN defaultValue:0];
+    if (lastRun <= 0)
+        return nil;
+    NSDate *nextRun = [NSDate dateWithTimeIntervalSince1970:lastRun + OS_MAINTENANCE_INTERVAL];
+    return [nextRun timeIntervalSinceNow] > 0 ? nextRun : nil;
+}
+
+- (BOOL)isDue {
+    return [self nextRunDate] == nil;
+}
+
+- (void)runJobsWithShouldContinue:(BOOL (^)(void))shouldContinue completion:(void (^)(BOOL finished))completion {
+    NSArray<OSMaintenanceJob *> *jobs;
+    @synchronized (self) {
+        if (self.running) {
+            if (completion)
+                dispatch_async(self.queue, ^{ completion(NO); });
+            return;
+        }
+        self.running = YES;
+        jobs = [self.jobs copy];
+    }
+    dispatch_async(self.queue, ^{
+        [self runJobs:jobs fromIndex:0 shouldContinue:shouldContinue completion:completion];
+    });
+}
+
+// Called on the queue, each job starts once the one before it completes or times out
+- (void)runJobs:(NSArray<OSMaintenanceJob *> *)jobs fromIndex:(NSUInteger)index shouldContinue:(BOOL (^)(void))shouldContinue completion:(void (^)(BOOL finished))completion {
+    if (index == jobs.count || !shouldContinue()) {
+        [self finishRunWithJobs:jobs finished:index == jobs.count completion:completion];
+        return;
+    }
+    OSMaintenanceJob *job = jobs[index];
+    CFAbsoluteTime start = CFAbsoluteTimeGetCurrent();
+    // Only read and written on the queue
+    __block BOOL completed = NO;
+    void (^jobCompleted)(BOOL) = ^(BOOL timedOut) {
+        dispatch_async(self.queue, ^{
+            if (completed)
+                return;
+            completed = YES;
+            [OneSignalLog onesignalLog:timedOut ? ONE_S_LL_WARN : ONE_S_LL_VERBOSE messageBlock:^NSString *{
+                return [NSString stringWithFormat:@"OSMaintenanceScheduler %@ %@ in %.1f ms", timedOut ? @"timed out" : @"ran", job.name, (CFAbsoluteTimeGetCurrent() - start) * 1000];
+            }];
+            [self runJobs:jobs fromIndex:index + 1 shouldContinue:shouldContinue completion:completion];
+        });
+    };
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(OS_MAINTENANCE_JOB_TIMEOUT * NSEC_PER_SEC)), self.queue, ^{
+        jobCompleted(YES);
+    });
+    job.block(^{
+        jobCompleted(NO);
+    });
+}
+
+- (void)finishRunWithJobs:(NSArray<OSMaintenanceJob *> *)jobs finished:(BOOL)finished completion:(void (^)(BOOL finished))completion {
+    if (finished && jobs.count > 0)
+        [OneSignalUserDefaults.initStandard saveDoubleForKey:OSUD_MAINTENANCE_LAST_RUN withValue:[[NSDate date] timeIntervalSince1970]];
+    @synchronized (self) {
+        self.running = NO;
+    }
+    if (completion)
+        completion(finished);
+}
+
+@end
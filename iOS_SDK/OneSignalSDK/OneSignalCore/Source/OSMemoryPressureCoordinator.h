@@ -0,0 +1,62 @@
+/**
+ * Modified MIT License
+ *
+ * Copyright 2024 OneSignal
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * 2. All copies of substantial portions of the Software may only be used in connection
+ * with services provided by OneSignal.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#import <Foundation/Foundation.h>
+
+#ifndef OSMemoryPressureCoordinator_h
+#define OSMemoryPressureCoordinator_h
+
+NS_ASSUME_NONNULL_BEGIN
+
+// Implemented by anything holding memory it can rebuild on demand
+@protocol OSMemoryPressureResponder <NSObject>
+// Called on the main thread. Drop whatever can be loaded, decoded or created again when next needed.
+- (void)purgeForMemoryPressure;
+@end
+
+/**
+ The one place the SDK reacts to memory pressure, from UIApplicationDidReceiveMemoryWarningNotification in the app
+ and the dispatch memory pressure source in extensions, which get no memory warnings.
+ OneSignalCore's own caches are purged first, then each registered responder.
+ */
+@interface OSMemoryPressureCoordinator : NSObject
+
+// Starts listening for memory pressure, safe to call more than once
++ (void)start;
+
+// Responders are held strongly, they are expected to live as long as the process
++ (void)addResponder:(NSObject<OSMemoryPressureResponder> *)responder;
++ (void)removeResponder:(NSObject<OSMemoryPressureResponder> *)responder;
+
+// Purges as if the system reported memory pressure, must be called on the main thread
++ (void)purge;
+
+@end
+
+NS_ASSUME_NONNULL_END
+
+#endif /* OSMemoryPressureCoordinator_h */
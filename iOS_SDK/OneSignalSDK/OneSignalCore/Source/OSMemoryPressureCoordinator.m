@@ -0,0 +1,78 @@
+/**
+ * Modified MIT License
+ *
+ * Copyright 2024 OneSignal
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * 2. All copies of substantial portions of the Software may only be used in connection
+ * with services provided by OneSignal.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#import <UIKit/UIKit.h>
+#import "OSMemoryPressureCoordinator.h"
+#import "OSListenerRegistry.h"
+#import "OneSignalUserDefaults.h"
+#import "OneSignalLog.h"
+
+@implementation OSMemoryPressureCoordinator
+
+static OSListenerRegistry<NSObject<OSMemoryPressureResponder> *> *_responders;
+static dispatch_source_t _memoryPressureSource;
+
++ (void)initialize {
+    if (self == [OSMemoryPressureCoordinator class])
+        _responders = [OSListenerRegistry new];
+}
+
++ (void)start {
+    static dispatch_once_t once;
+    dispatch_once(&once, ^{
+        [[NSNotificationCenter defaultCenter] addObserver:self selector:@selector(purge) name:UIApplicationDidReceiveMemoryWarningNotification object:nil];
+
+        // Extensions only learn about memory pressure through this source
+        if ([NSBundle.mainBundle.bundleURL.pathExtension isEqualToString:@"appex"]) {
+            _memoryPressureSource = dispatch_source_create(DISPATCH_SOURCE_TYPE_MEMORYPRESSURE, 0, DISPATCH_MEMORYPRESSURE_WARN | DISPATCH_MEMORYPRESSURE_CRITICAL, dispatch_get_main_queue());
+            dispatch_source_set_event_handler(_memoryPressureSource, ^{
+                [OSMemoryPressureCoordinator purge];
+            });
+            dispatch_resume(_memoryPressureSource);
+        }
+    });
+}
+
++ (void)addResponder:(NSObject<OSMemoryPressureResponder> *)responder {
+    [self start];
+    [_responders addListener:responder];
+}
+
++ (void)removeResponder:(NSObject<OSMemoryPressureResponder> *)responder {
+    [_responders removeListener:responder];
+}
+
++ (void)purge {
+    [OneSignalLog onesignalLog:ONE_S_LL_DEBUG message:@"OSMemoryPressureCoordinator purging caches for memory pressure"];
+    [OneSignalUserDefaults purgeDecodedValues];
+    [OneSignalLog purgePendingLogEvents];
+    for (NSObject<OSMemoryPressureResponder> *responder in _responders.listeners) {
+        [responder purgeForMemoryPressure];
+    }
+}
+
+@end
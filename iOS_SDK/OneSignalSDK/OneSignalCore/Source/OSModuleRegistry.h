@@ -0,0 +1,64 @@
+/**
+ * Modified MIT License
+ *
+ * Copyright 2024 OneSignal
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * 2. All copies of substantial portions of the Software may only be used in connection
+ * with services provided by OneSignal.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#import <Foundation/Foundation.h>
+
+#ifndef OSModuleRegistry_h
+#define OSModuleRegistry_h
+
+NS_ASSUME_NONNULL_BEGIN
+
+// The optional modules the main SDK calls into without linking against them
+typedef NS_ENUM(NSUInteger, OSModule) {
+    OSModuleInAppMessages,
+    OSModuleLocation,
+    OSModuleLiveActivities
+};
+
+/**
+ Resolves each optional module's entry class once per process.
+ Objective-C modules register themselves from +load. Modules that cannot, such as Swift ones,
+ are looked up by class name on first use. Lookups after that are an array read.
+ */
+@interface OSModuleRegistry : NSObject
+
+// Must be called before the module is first looked up, such as from +load
++ (void)registerModule:(OSModule)module moduleClass:(Class)moduleClass;
+
+// Nil if the module is not part of the app or was disabled
++ (Class _Nullable)classForModule:(OSModule)module;
+
+// For modules the app opted out of at initialization, they resolve to nil without being looked up
++ (void)disableModule:(OSModule)module;
++ (BOOL)isModuleDisabled:(OSModule)module;
++ (void)clearStatics; // Used by Unit Tests, enables the disabled modules again
+
+@end
+
+NS_ASSUME_NONNULL_END
+
+#endif /* OSModuleRegistry_h */
@@ -0,0 +1,87 @@
+/**
+ * Modified MIT License
+ *
+ * Copyright 2024 OneSignal
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * 2. All copies of substantial portions of the Software may only be used in connection
+ * with services provided by OneSignal.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#import <Foundation/Foundation.h>
+#import "OSModuleRegistry.h"
+#import "OneSignalCommonDefines.h"
+
+#define OS_MODULE_COUNT (OSModuleLiveActivities + 1)
+
+static Class _moduleClasses[OS_MODULE_COUNT];
+static dispatch_once_t _moduleResolved[OS_MODULE_COUNT];
+static BOOL _moduleDisabled[OS_MODULE_COUNT];
+
+static NSString *OSModuleClassName(OSModule module) {
+    switch (module) {
+        case OSModuleInAppMessages:
+            return ONE_SIGNAL_IN_APP_MESSAGES_CLASS_NAME;
+        case OSModuleLocation:
+            return ONE_SIGNAL_LOCATION_CLASS_NAME;
+        case OSModuleLiveActivities:
+            return ONE_SIGNAL_LIVE_ACTIVITIES_CLASS_NAME;
+    }
+}
+
+@implementation OSModuleRegistry
+
++ (void)registerModule:(OSModule)module moduleClass:(Class)moduleClass {
+    if (module >= OS_MODULE_COUNT) {
+        return;
+    }
+    _moduleClasses[module] = moduleClass;
+}
+
++ (Class)classForModule:(OSModule)module {
+    if (module >= OS_MODULE_COUNT || _moduleDisabled[module]) {
+        return nil;
+    }
+    dispatch_once(&_moduleResolved[module], ^{
+        if (!_moduleClasses[module]) {
+            _moduleClasses[module] = NSClassFromString(OSModuleClassName(module));
+        }
+    });
+    return _moduleClasses[module];
+}
+
++ (void)disableModule:(OSModule)module {
+    if (module >= OS_MODULE_COUNT) {
+        return;
+    }
+    _moduleDisabled[module] = YES;
+}
+
++ (BOOL)isModuleDisabled:(OSModule)module {
+    return module < OS_MODULE_COUNT && _moduleDisabled[module];
+}
+
++ (void)clearStatics {
+    for (NSUInteger module = 0; module < OS_MODULE_COUNT; module++) {
+        _moduleDisabled[module] = NO;
+    }
+}
+
+@end
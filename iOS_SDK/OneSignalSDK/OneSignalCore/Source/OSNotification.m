@@ -31,20 +31,69 @@
 #import "OSNotification.h"
 #import "OneSignalLog.h"
 
+// Parsed notifications kept for reuse by later stages handling the same payload
+#define PARSED_NOTIFICATIONS_CACHE_LIMIT 16
+
+@interface OSNotification ()
+// Action buttons and additional data are only parsed when first read
+@property (strong, nonatomic, nullable) NSArray<NSDictionary*> *unparsedActionButtons;
+@property (nonatomic) BOOL didParseActionButtons;
+@property (nonatomic) BOOL didParseAdditionalData;
+@end
+
 @implementation OSNotification
- 
+
+@synthesize actionButtons = _actionButtons;
+@synthesize additionalData = _additionalData;
+
++ (NSCache<NSString *, OSNotification *> *)parsedNotifications {
+    static NSCache *parsedNotifications;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        parsedNotifications = [NSCache new];
+        parsedNotifications.countLimit = PARSED_NOTIFICATIONS_CACHE_LIMIT;
+    });
+    return parsedNotifications;
+}
+
+/*
+ Notifications are immutable once parsed, so the same payload handed to several stages
+    of the NSE or of foreground handling is only parsed once per process.
+ Payloads are matched by notification id and then compared in full, since opened
+    payloads can carry extra keys such as actionSelected.
+ */
 + (instancetype)parseWithApns:(nonnull NSDictionary*)message {
     if (!message)
         return nil;
     
+    NSString *notificationId = [self notificationIdInPayload:message];
+    if (notificationId) {
+        OSNotification *parsed = [self.parsedNotifications objectForKey:notificationId];
+        if (parsed && (parsed.rawPayload == message || [parsed.rawPayload isEqualToDictionary:message]))
+            return parsed;
+    }
+    
     OSNotification *osNotification = [OSNotification new];
     
     [osNotification initWithRawMessage:message];
+    
+    if (notificationId)
+        [self.parsedNotifications setObject:osNotification forKey:notificationId];
     return osNotification;
 }
 
++ (NSString *)notificationIdInPayload:(NSDictionary *)message {
+    NSDictionary *oneSignalFields = [message[@"os_data"] isKindOfClass:[NSDictionary class]] ? message[@"os_data"] : message[@"custom"];
+    if (![oneSignalFields isKindOfClass:[NSDictionary class]])
+        return nil;
+    
+    NSString *notificationId = oneSignalFields[@"i"];
+    return [notificationId isKindOfClass:[NSString class]] ? notificationId : nil;
+}
+
 - (void)initWithRawMessage:(NSDictionary*)message {
-    _rawPayload = [NSDictionary dictionaryWithDictionary:message];
+    // Copying is free for the immutable dictionaries iOS hands over
+    _rawPayload = [message copy];
     
     if ([_rawPayload[@"os_data"] isKindOfClass:[NSDictionary class]])
         [self parseOSDataPayload];
@@ -62,11 +111,17 @@
     else {
         [self parseApnsFields];
         _attachments = _rawPayload[@"att"];
-        [self parseActionButtons:_rawPayload[@"buttons"]];
+        _unparsedActionButtons = _rawPayload[@"buttons"] ?: @[];
     }
     
-    [self parseCommonOneSignalFields:_rawPayload[@"custom"]];
-    _additionalData = _rawPayload[@"custom"][@"a"];
+    if ([_rawPayload[@"custom"] isKindOfClass:[NSDictionary class]])
+        [self parseCommonOneSignalFields:_rawPayload[@"custom"]];
+}
+
+- (void)parseOriginalAdditionalData {
+    NSDictionary *custom = _rawPayload[@"custom"];
+    NSDictionary *additionalData = [custom isKindOfClass:[NSDictionary class]] ? custom[@"a"] : nil;
+    _additionalData = [additionalData isKindOfClass:[NSDictionary class]] ? additionalData : nil;
     
     //fixes an issue where actionSelected was a top level property in _rawPayload
     //and 'actionSelected' was not being set in additionalData
@@ -93,16 +148,15 @@
         // it appears that in iOS 9, the 'buttons' os_data field is an object not array
         // this if statement checks for this condition and parses appropriately
         if ([os_data[@"buttons"] isKindOfClass:[NSArray class]]) {
-            [self parseActionButtons:os_data[@"buttons"]];
+            _unparsedActionButtons = os_data[@"buttons"] ?: @[];
         } else if (os_data[@"buttons"] && [os_data[@"buttons"] isKindOfClass: [NSDictionary class]] && [os_data[@"buttons"][@"o"] isKindOfClass: [NSArray class]]) {
-            [self parseActionButtons:os_data[@"buttons"][@"o"]];
+            _unparsedActionButtons = os_data[@"buttons"][@"o"] ?: @[];
         } else if ([_rawPayload[@"actionbuttons"] isKindOfClass:[NSArray class]]) {
-            [self parseActionButtons:_rawPayload[@"actionbuttons"]];
+            _unparsedActionButtons = _rawPayload[@"actionbuttons"] ?: @[];
         }
     }
     
     [self parseCommonOneSignalFields:_rawPayload[@"os_data"]];
-    [self parseOSDataAdditionalData];
 }
 
 - (void)parseOSDataAdditionalData {
@@ -118,7 +172,9 @@
     _launchURL = payload[@"u"];
     _templateId = payload[@"ti"];
     _templateName = payload[@"tn"];
-    _badgeIncrement = [payload[@"badge_inc"] integerValue];
+    id badgeIncrement = payload[@"badge_inc"];
+    if ([badgeIncrement isKindOfClass:[NSNumber class]] || [badgeIncrement isKindOfClass:[NSString class]])
+        _badgeIncrement = [badgeIncrement integerValue];
     _collapseId = payload[@"collapse_id"];
 }
 
@@ -148,7 +204,33 @@
     _badge = [payload[@"b"] intValue];
     _sound = payload[@"s"];
     _attachments = payload[@"at"];
-    [self parseActionButtons:payload[@"o"]];
+    _unparsedActionButtons = payload[@"o"] ?: @[];
+}
+
+- (NSArray *)actionButtons {
+    @synchronized (self) {
+        if (!_didParseActionButtons) {
+            _didParseActionButtons = true;
+            // Payloads that never had a buttons field keep a nil actionButtons
+            if ([_unparsedActionButtons isKindOfClass:[NSArray class]])
+                [self parseActionButtons:_unparsedActionButtons];
+            _unparsedActionButtons = nil;
+        }
+        return _actionButtons;
+    }
+}
+
+- (NSDictionary *)additionalData {
+    @synchronized (self) {
+        if (!_didParseAdditionalData) {
+            _didParseAdditionalData = true;
+            if ([_rawPayload[@"os_data"] isKindOfClass:[NSDictionary class]])
+                [self parseOSDataAdditionalData];
+            else
+                [self parseOriginalAdditionalData];
+        }
+        return _additionalData;
+    }
 }
 
 // Parse and convert minified keys for action buttons
@@ -158,7 +240,8 @@
         
         // check to ensure the button object has the correct
         // format before adding it to the array
-        if (!button[@"n"] ||
+        if (![button isKindOfClass:[NSDictionary class]] ||
+            !button[@"n"] ||
             (!button[@"i"] && !button[@"n"])) {
             continue;
         }
@@ -168,7 +251,7 @@
         actionDict[@"id"] = button[@"i"] ?: button[@"n"];
         
         // Parse Action Icon into system or template icon
-        if (button[@"icon_type"] && button[@"path"]) {
+        if ([button[@"icon_type"] isKindOfClass:[NSString class]] && button[@"path"]) {
             if ([button[@"icon_type"] isEqualToString:@"system"]) {
                 actionDict[@"systemIcon"] = button[@"path"];
             } else if ([button[@"icon_type"] isEqualToString:@"custom"]) {
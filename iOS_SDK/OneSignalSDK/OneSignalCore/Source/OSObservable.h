@@ -35,6 +35,10 @@
 
 @interface OSObservable<__covariant ObserverType, __covariant ObjectType> : NSObject
 - (instancetype _Nonnull)initWithChangeSelector:(SEL)selector;
+// Observers are only called with the latest state, once per `interval`, or once per main queue turn when it is 0
+- (instancetype _Nonnull)initWithChangeSelector:(SEL)selector coalescingInterval:(NSTimeInterval)interval;
+// Combines a pending state with a newer one instead of replacing it, such as to keep the first previous state. Returning nil drops both.
+- (instancetype _Nonnull)initWithChangeSelector:(SEL)selector coalescingInterval:(NSTimeInterval)interval merge:(ObjectType _Nullable (^ _Nullable)(ObjectType _Nonnull pending, ObjectType _Nonnull state))merge;
 - (void)addObserver:(ObserverType)observer;
 - (void)removeObserver:(ObserverType)observer;
 - (BOOL)notifyChange:(ObjectType)state;
@@ -44,6 +48,8 @@
 
 @interface OSBoolObservable<__covariant ObserverType> : NSObject
 - (instancetype _Nonnull)initWithChangeSelector:(SEL)selector;
+// Observers are only called with the latest state, once per `interval`, or once per main queue turn when it is 0
+- (instancetype _Nonnull)initWithChangeSelector:(SEL)selector coalescingInterval:(NSTimeInterval)interval;
 - (void)addObserver:(ObserverType)observer;
 - (void)removeObserver:(ObserverType)observer;
 - (BOOL)notifyChange:(BOOL)state;
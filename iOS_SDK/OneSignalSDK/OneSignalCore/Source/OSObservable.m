@@ -29,9 +29,27 @@
 #import "OSObservable.h"
 #import "OneSignalCoreHelper.h"
 
+/*
+ In coalescing mode a notify only records the state and schedules one delivery,
+ after `coalescingInterval`, or on the next turn of the main queue when it is 0.
+ Observers then see only the latest state, so registration flapping between several states runs them once.
+ */
+static void scheduleCoalescedDelivery(NSTimeInterval coalescingInterval, dispatch_block_t deliver) {
+    if (coalescingInterval > 0)
+        dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(coalescingInterval * NSEC_PER_SEC)), dispatch_get_main_queue(), deliver);
+    else
+        [OneSignalCoreHelper dispatch_async_on_main_queue:deliver];
+}
+
 @implementation OSObservable {
 NSHashTable* observers;
 SEL changeSelector;
+BOOL coalesces;
+NSTimeInterval coalescingInterval;
+// The latest state waiting on a coalesced delivery. Access is synchronized on `observers`.
+id pendingState;
+BOOL deliveryScheduled;
+id (^mergeBlock)(id pending, id state);
 }
 
 - (instancetype _Nonnull)initWithChangeSelector:(SEL)selector {
@@ -42,6 +60,21 @@ SEL changeSelector;
     return self;
 }
 
+- (instancetype _Nonnull)initWithChangeSelector:(SEL)selector coalescingInterval:(NSTimeInterval)interval {
+    if (self = [self initWithChangeSelector:selector]) {
+        coalesces = true;
+        coalescingInterval = interval;
+    }
+    return self;
+}
+
+- (instancetype _Nonnull)initWithChangeSelector:(SEL)selector coalescingInterval:(NSTimeInterval)interval merge:(id (^)(id pending, id state))merge {
+    if (self = [self initWithChangeSelector:selector coalescingInterval:interval]) {
+        mergeBlock = [merge copy];
+    }
+    return self;
+}
+
 - (instancetype)init {
     if (self = [super init])
         observers = [NSHashTable new];
@@ -60,39 +93,68 @@ SEL changeSelector;
     }
 }
 
-#pragma clang diagnostic push
-#pragma clang diagnostic ignored "-Warc-performSelector-leaks"
-
 - (BOOL)notifyChange:(id)state {
-    BOOL fired = false;
+    NSArray *obs;
     
     @synchronized(observers) {
-        NSArray *obs = [observers copy];
-        for (id observer in obs) {
-            fired = true;
-            if (changeSelector) {
-                // Any Observable setup to fire a custom selector with changeSelector
-                //  is external to our SDK. Run on the main thread in case the
-                //  app developer needs to update UI elements.
-                
-                [self callObserver:observer withSelector:changeSelector withState:state];
-                
-            } else {
-                [observer onChanged:state];
+        // Weak observers that went away may still be counted by the table itself
+        obs = [observers allObjects];
+        if (obs.count == 0)
+            return false;
+        
+        if (coalesces) {
+            pendingState = (pendingState && mergeBlock) ? mergeBlock(pendingState, state) : state;
+            if (!deliveryScheduled) {
+                deliveryScheduled = true;
+                scheduleCoalescedDelivery(coalescingInterval, ^{
+                    [self deliverPendingState];
+                });
             }
+            return true;
         }
     }
     
-    return fired;
+    if (changeSelector) {
+        // Any Observable setup to fire a custom selector with changeSelector
+        //  is external to our SDK. Run on the main thread in case the
+        //  app developer needs to update UI elements.
+        [OneSignalCoreHelper dispatch_async_on_main_queue:^{
+            [self callObservers:obs withState:state];
+        }];
+    } else {
+        [self callObservers:obs withState:state];
+    }
+    
+    return true;
 }
 
-- (void)callObserver:(id)observer withSelector:(SEL)selector withState:(id)state {
-    [OneSignalCoreHelper dispatch_async_on_main_queue:^{
-        [observer performSelector:self->changeSelector withObject:state];
-    }];
+- (void)deliverPendingState {
+    NSArray *obs;
+    id state;
+    @synchronized(observers) {
+        deliveryScheduled = false;
+        state = pendingState;
+        pendingState = nil;
+        obs = [observers allObjects];
+    }
+    // The merged changes cancelled each other out
+    if (!state)
+        return;
+    [self callObservers:obs withState:state];
 }
 
-#pragma clang diagnostic pop
+- (void)callObservers:(NSArray *)obs withState:(id)state {
+    SEL selector = changeSelector;
+    for (id observer in obs) {
+        if (selector) {
+            // Calls the method directly, performSelector is another dynamic send on top of it
+            void (*onChange)(id, SEL, id) = (void (*)(id, SEL, id))[observer methodForSelector:selector];
+            onChange(observer, selector, state);
+        } else {
+            [observer onChanged:state];
+        }
+    }
+}
 
 @end
 
@@ -100,6 +162,11 @@ SEL changeSelector;
 @implementation OSBoolObservable {
 NSHashTable* observers;
 SEL changeSelector;
+BOOL coalesces;
+NSTimeInterval coalescingInterval;
+// The latest state waiting on a coalesced delivery. Access is synchronized on `observers`.
+BOOL pendingState;
+BOOL deliveryScheduled;
 }
 
 - (instancetype _Nonnull)initWithChangeSelector:(SEL)selector {
@@ -110,6 +177,14 @@ SEL changeSelector;
     return self;
 }
 
+- (instancetype _Nonnull)initWithChangeSelector:(SEL)selector coalescingInterval:(NSTimeInterval)interval {
+    if (self = [self initWithChangeSelector:selector]) {
+        coalesces = true;
+        coalescingInterval = interval;
+    }
+    return self;
+}
+
 - (instancetype)init {
     if (self = [super init])
         observers = [NSHashTable new];
@@ -128,43 +203,58 @@ SEL changeSelector;
     }
 }
 
-#pragma clang diagnostic push
-#pragma clang diagnostic ignored "-Warc-performSelector-leaks"
-
 - (BOOL)notifyChange:(BOOL)state {
-    BOOL fired = false;
+    // Only a custom selector is ever called on BOOL observers
+    if (!changeSelector)
+        return false;
     
+    NSArray *obs;
     @synchronized(observers) {
-        NSArray *obs = [observers copy];
-        for (id observer in obs) {
-            fired = true;
-            if (changeSelector) {
-                // Any Observable setup to fire a custom selector with changeSelector
-                //  is external to our SDK. Run on the main thread in case the
-                //  app developer needs to update UI elements.
-                
-                [self callObserver:observer withSelector:changeSelector withState:state];
+        // Weak observers that went away may still be counted by the table itself
+        obs = [observers allObjects];
+        if (obs.count == 0)
+            return false;
+        
+        if (coalesces) {
+            pendingState = state;
+            if (!deliveryScheduled) {
+                deliveryScheduled = true;
+                scheduleCoalescedDelivery(coalescingInterval, ^{
+                    [self deliverPendingState];
+                });
             }
+            return true;
         }
     }
     
-    return fired;
-}
-
-- (void)callObserver:(id)observer withSelector:(SEL)selector withState:(BOOL)state {
+    // Any Observable setup to fire a custom selector with changeSelector
+    //  is external to our SDK. Run on the main thread in case the
+    //  app developer needs to update UI elements.
     [OneSignalCoreHelper dispatch_async_on_main_queue:^{
-        // The following declaration is to resolve: Sending 'const BOOL *' (aka 'const bool *') to parameter of type 'void * _Nonnull' discards qualifiers
-        BOOL boolValue = state;
-
-        NSMethodSignature* signature = [[observer class] instanceMethodSignatureForSelector:self->changeSelector];
-        NSInvocation* invocation = [NSInvocation invocationWithMethodSignature:signature];
-        [invocation setTarget: observer];
-        [invocation setSelector:self->changeSelector];
-        [invocation setArgument: &boolValue atIndex: 2];
-        [invocation invoke];
+        [self callObservers:obs withState:state];
     }];
+    
+    return true;
+}
+
+- (void)deliverPendingState {
+    NSArray *obs;
+    BOOL state;
+    @synchronized(observers) {
+        deliveryScheduled = false;
+        state = pendingState;
+        obs = [observers allObjects];
+    }
+    [self callObservers:obs withState:state];
 }
 
-#pragma clang diagnostic pop
+- (void)callObservers:(NSArray *)obs withState:(BOOL)state {
+    SEL selector = changeSelector;
+    for (id observer in obs) {
+        // A typed call replaces building an NSInvocation and method signature for every observer on every change
+        void (*onChange)(id, SEL, BOOL) = (void (*)(id, SEL, BOOL))[observer methodForSelector:selector];
+        onChange(observer, selector, state);
+    }
+}
 
 @end
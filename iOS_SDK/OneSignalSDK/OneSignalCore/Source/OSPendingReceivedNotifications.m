@@ -0,0 +1,121 @@
+/**
+ * Modified MIT License
+ *
+ * Copyright 2024 OneSignal
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * 2. All copies of substantial portions of the Software may only be used in connection
+ * with services provided by OneSignal.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#import <Foundation/Foundation.h>
+#import "OSPendingReceivedNotifications.h"
+#import "OneSignalCommonDefines.h"
+#import "OneSignalUserDefaults.h"
+#import "OSMacros.h"
+
+@implementation OSPendingReceivedNotifications
+
+// nil if the app group is not set up, the entries then go to the shared NSUserDefaults
++ (NSURL *)directory {
+    static NSURL *directory;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        NSURL *container = [[NSFileManager defaultManager] containerURLForSecurityApplicationGroupIdentifier:[OneSignalUserDefaults appGroupName]];
+        if (container) {
+            directory = [container URLByAppendingPathComponent:ONESIGNAL_PENDING_RECEIVED_NOTIFICATIONS_DIRECTORY isDirectory:YES];
+            [[NSFileManager defaultManager] createDirectoryAtURL:directory withIntermediateDirectories:YES attributes:nil error:nil];
+        }
+    });
+    return directory;
+}
+
+// Names start with the zero padded receive time in microseconds and a sequence number, so sorting them sorts the entries oldest first
++ (NSArray<NSURL *> *)entryFilesIn:(NSURL *)directory {
+    NSArray<NSURL *> *contents = [[NSFileManager defaultManager] contentsOfDirectoryAtURL:directory includingPropertiesForKeys:nil options:NSDirectoryEnumerationSkipsHiddenFiles error:nil];
+    let files = [NSMutableArray<NSURL *> new];
+    for (NSURL *file in contents) {
+        if ([file.pathExtension isEqualToString:@"json"])
+            [files addObject:file];
+    }
+    return [files sortedArrayUsingComparator:^NSComparisonResult(NSURL *first, NSURL *second) {
+        return [first.lastPathComponent compare:second.lastPathComponent];
+    }];
+}
+
++ (void)addNotificationId:(NSString *)notificationId {
+    NSTimeInterval now = [NSDate date].timeIntervalSince1970;
+    NSDictionary *entry = @{@"id": notificationId, @"timestamp": @(now)};
+    NSURL *directory = [self directory];
+    if (!directory) {
+        [self addLegacyEntry:entry];
+        return;
+    }
+
+    static uint32_t sequence;
+    NSString *name;
+    @synchronized (self) {
+        NSArray<NSURL *> *files = [self entryFilesIn:directory];
+        for (NSUInteger i = 0; i + OS_PENDING_RECEIVED_NOTIFICATIONS_LIMIT <= files.count; i++)
+            [[NSFileManager defaultManager] removeItemAtURL:files[i] error:nil];
+        name = [NSString stringWithFormat:@"%016lld-%010u-%@.json", (long long)(now * 1000000), sequence++, [NSUUID UUID].UUIDString];
+    }
+    let data = [NSJSONSerialization dataWithJSONObject:entry options:0 error:nil];
+    // Written to a temporary file and renamed into place, so the app never reads a partial entry
+    [data writeToURL:[directory URLByAppendingPathComponent:name] atomically:YES];
+}
+
++ (NSArray<NSDictionary *> *)takeAll {
+    // Entries an earlier version of the NSE saved to the shared NSUserDefaults come first
+    let entries = [NSMutableArray<NSDictionary *> new];
+    let sharedUserDefaults = OneSignalUserDefaults.initShared;
+    NSArray<NSDictionary *> *legacy = [sharedUserDefaults getSavedObjectForKey:OSUD_PENDING_RECEIVED_NOTIFICATIONS defaultValue:nil];
+    if (legacy.count > 0) {
+        [entries addObjectsFromArray:legacy];
+        [sharedUserDefaults saveObjectForKey:OSUD_PENDING_RECEIVED_NOTIFICATIONS withValue:nil];
+    }
+
+    NSURL *directory = [self directory];
+    if (!directory)
+        return entries;
+    @synchronized (self) {
+        for (NSURL *file in [self entryFilesIn:directory]) {
+            NSData *data = [NSData dataWithContentsOfURL:file];
+            [[NSFileManager defaultManager] removeItemAtURL:file error:nil];
+            NSDictionary *entry = data ? [NSJSONSerialization JSONObjectWithData:data options:0 error:nil] : nil;
+            if ([entry isKindOfClass:[NSDictionary class]] && [entry[@"id"] isKindOfClass:[NSString class]])
+                [entries addObject:entry];
+        }
+    }
+    return entries;
+}
+
++ (void)addLegacyEntry:(NSDictionary *)entry {
+    let sharedUserDefaults = OneSignalUserDefaults.initShared;
+    @synchronized (self) {
+        NSMutableArray<NSDictionary *> *pending = [[sharedUserDefaults getSavedObjectForKey:OSUD_PENDING_RECEIVED_NOTIFICATIONS defaultValue:[NSArray new]] mutableCopy];
+        [pending addObject:entry];
+        if (pending.count > OS_PENDING_RECEIVED_NOTIFICATIONS_LIMIT)
+            [pending removeObjectsInRange:NSMakeRange(0, pending.count - OS_PENDING_RECEIVED_NOTIFICATIONS_LIMIT)];
+        [sharedUserDefaults saveObjectForKey:OSUD_PENDING_RECEIVED_NOTIFICATIONS withValue:pending];
+    }
+}
+
+@end
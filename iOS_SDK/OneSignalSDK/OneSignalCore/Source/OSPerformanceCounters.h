@@ -0,0 +1,68 @@
+/**
+ * Modified MIT License
+ *
+ * Copyright 2024 OneSignal
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * 2. All copies of substantial portions of the Software may only be used in connection
+ * with services provided by OneSignal.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#import <Foundation/Foundation.h>
+
+#ifndef OSPerformanceCounters_h
+#define OSPerformanceCounters_h
+
+typedef NS_ENUM(NSUInteger, OSPerformanceCounter) {
+    OSPerformanceCounterDeltasEnqueued,
+    OSPerformanceCounterDeltasCoalesced,
+    OSPerformanceCounterModelStoreSaves,
+    OSPerformanceCounterUserDefaultsWrites,
+    OSPerformanceCounterUserDefaultsBytesWritten,
+    OSPerformanceCounterIAMEvaluations,
+    OSPerformanceCounterIAMEvaluationMicroseconds,
+    OSPerformanceCounterRequestRetries
+};
+
+typedef NS_ENUM(NSUInteger, OSPerformanceGauge) {
+    OSPerformanceGaugeDeltaQueueDepth
+};
+
+/**
+ Process-wide counters and gauges from across the SDK, exposed through `OneSignal.Debug.metrics`.
+ Each value is a relaxed atomic, so updating one is a single instruction and a snapshot never takes a lock,
+ which keeps them cheap enough to leave on and sample periodically in production.
+ */
+@interface OSPerformanceCounters : NSObject
+
++ (void)increment:(OSPerformanceCounter)counter NS_SWIFT_NAME(increment(_:));
++ (void)add:(int64_t)amount toCounter:(OSPerformanceCounter)counter NS_SWIFT_NAME(add(_:to:));
++ (void)setGauge:(OSPerformanceGauge)gauge value:(int64_t)value NS_SWIFT_NAME(setGauge(_:value:));
+
+/**
+ The current values by name, such as "deltas_enqueued", plus averages derived from them such as "iam_evaluation_average_ms".
+ Values are read one at a time, so a snapshot taken while they change may mix old and new values.
+ */
++ (NSDictionary<NSString *, NSNumber *> * _Nonnull)snapshot;
++ (void)reset;
+
+@end
+
+#endif /* OSPerformanceCounters_h */
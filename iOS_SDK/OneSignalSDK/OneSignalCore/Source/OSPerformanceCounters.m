@@ -0,0 +1,104 @@
+/**
+ * Modified MIT License
+ *
+ * Copyright 2024 OneSignal
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * 2. All copies of substantial portions of the Software may only be used in connection
+ * with services provided by OneSignal.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#import <Foundation/Foundation.h>
+#import <stdatomic.h>
+#import "OSPerformanceCounters.h"
+
+#define OS_PERFORMANCE_COUNTER_COUNT (OSPerformanceCounterRequestRetries + 1)
+#define OS_PERFORMANCE_GAUGE_COUNT (OSPerformanceGaugeDeltaQueueDepth + 1)
+
+static _Atomic int64_t _counters[OS_PERFORMANCE_COUNTER_COUNT];
+static _Atomic int64_t _gauges[OS_PERFORMANCE_GAUGE_COUNT];
+
+static NSString *OSPerformanceCounterName(OSPerformanceCounter counter) {
+    switch (counter) {
+        case OSPerformanceCounterDeltasEnqueued:
+            return @"deltas_enqueued";
+        case OSPerformanceCounterDeltasCoalesced:
+            return @"deltas_coalesced";
+        case OSPerformanceCounterModelStoreSaves:
+            return @"model_store_saves";
+        case OSPerformanceCounterUserDefaultsWrites:
+            return @"user_defaults_writes";
+        case OSPerformanceCounterUserDefaultsBytesWritten:
+            return @"user_defaults_bytes_written";
+        case OSPerformanceCounterIAMEvaluations:
+            return @"iam_evaluations";
+        case OSPerformanceCounterIAMEvaluationMicroseconds:
+            return @"iam_evaluation_us";
+        case OSPerformanceCounterRequestRetries:
+            return @"request_retries";
+    }
+}
+
+static NSString *OSPerformanceGaugeName(OSPerformanceGauge gauge) {
+    switch (gauge) {
+        case OSPerformanceGaugeDeltaQueueDepth:
+            return @"delta_queue_depth";
+    }
+}
+
+@implementation OSPerformanceCounters
+
++ (void)increment:(OSPerformanceCounter)counter {
+    [self add:1 toCounter:counter];
+}
+
++ (void)add:(int64_t)amount toCounter:(OSPerformanceCounter)counter {
+    atomic_fetch_add_explicit(&_counters[counter], amount, memory_order_relaxed);
+}
+
++ (void)setGauge:(OSPerformanceGauge)gauge value:(int64_t)value {
+    atomic_store_explicit(&_gauges[gauge], value, memory_order_relaxed);
+}
+
++ (NSDictionary<NSString *, NSNumber *> *)snapshot {
+    NSMutableDictionary<NSString *, NSNumber *> *snapshot = [NSMutableDictionary new];
+    int64_t values[OS_PERFORMANCE_COUNTER_COUNT];
+    for (NSUInteger i = 0; i < OS_PERFORMANCE_COUNTER_COUNT; i++) {
+        values[i] = atomic_load_explicit(&_counters[i], memory_order_relaxed);
+        snapshot[OSPerformanceCounterName(i)] = @(values[i]);
+    }
+    for (NSUInteger i = 0; i < OS_PERFORMANCE_GAUGE_COUNT; i++) {
+        snapshot[OSPerformanceGaugeName(i)] = @(atomic_load_explicit(&_gauges[i], memory_order_relaxed));
+    }
+    int64_t evaluations = values[OSPerformanceCounterIAMEvaluations];
+    snapshot[@"iam_evaluation_average_ms"] = @(evaluations > 0 ? values[OSPerformanceCounterIAMEvaluationMicroseconds] / 1000.0 / evaluations : 0);
+    return snapshot;
+}
+
++ (void)reset {
+    for (NSUInteger i = 0; i < OS_PERFORMANCE_COUNTER_COUNT; i++) {
+        atomic_store_explicit(&_counters[i], 0, memory_order_relaxed);
+    }
+    for (NSUInteger i = 0; i < OS_PERFORMANCE_GAUGE_COUNT; i++) {
+        atomic_store_explicit(&_gauges[i], 0, memory_order_relaxed);
+    }
+}
+
+@end
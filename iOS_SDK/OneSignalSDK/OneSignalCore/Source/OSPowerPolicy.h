@@ -0,0 +1,59 @@
+/**
+ * Modified MIT License
+ *
+ * Copyright 2024 OneSignal
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * 2. All copies of substantial portions of the Software may only be used in connection
+ * with services provided by OneSignal.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#import <Foundation/Foundation.h>
+
+#ifndef OSPowerPolicy_h
+#define OSPowerPolicy_h
+
+/**
+ Scales back discretionary SDK work while the device is in Low Power Mode or at a serious or critical thermal state:
+ flushes are debounced longer, telemetry waits longer before it is sent, prefetching stops and location updates need
+ a larger move. Values are read when work is scheduled, so everything reverts on its own once the device recovers.
+ OS_POWER_POLICY_CHANGED_NOTIFICATION is posted when the policy changes, for work that has to be restarted.
+ */
+@interface OSPowerPolicy : NSObject
+
++ (OSPowerPolicy * _Nonnull)sharedPolicy;
+
+@property (nonatomic, readonly) BOOL isConstrained;
+// Prefetching content ahead of display, such as in-app message HTML and web views
+@property (nonatomic, readonly) BOOL allowsPrefetch;
+
+// Debounce and batch windows, in any unit
+- (double)scaledDelay:(double)delay;
+// How long telemetry such as receipts waits before it is sent, in seconds
+- (NSTimeInterval)telemetryDeferral:(NSTimeInterval)delay;
+// Distance thresholds, in any unit
+- (double)scaledDistance:(double)distance;
+
+// Called with the process info state when it changes, exposed for tests
+- (void)updateWithLowPowerMode:(BOOL)lowPowerMode thermalState:(NSProcessInfoThermalState)thermalState;
+
+@end
+
+#endif /* OSPowerPolicy_h */
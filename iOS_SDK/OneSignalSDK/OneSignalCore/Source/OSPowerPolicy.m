@@ -0,0 +1,107 @@
+/**
+ * Modified MIT License
+ *
+ * Copyright 2024 OneSignal
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * 2. All copies of substantial portions of the Software may only be used in connection
+ * with services provided by OneSignal.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#import "OSPowerPolicy.h"
+#import "OneSignalLog.h"
+#import "OneSignalCommonDefines.h"
+
+@interface OSPowerPolicy ()
+// Synchronized on self
+@property (nonatomic) BOOL constrained;
+@end
+
+@implementation OSPowerPolicy
+
++ (OSPowerPolicy *)sharedPolicy {
+    static OSPowerPolicy *sharedPolicy = nil;
+    static dispatch_once_t once;
+    dispatch_once(&once, ^{
+        sharedPolicy = [OSPowerPolicy new];
+    });
+    return sharedPolicy;
+}
+
+- (instancetype)init {
+    if (self = [super init]) {
+        NSProcessInfo *processInfo = NSProcessInfo.processInfo;
+        _constrained = [OSPowerPolicy isConstrainedWithLowPowerMode:[self isLowPowerModeEnabled:processInfo] thermalState:processInfo.thermalState];
+        [[NSNotificationCenter defaultCenter] addObserver:self selector:@selector(processInfoStateDidChange) name:NSProcessInfoPowerStateDidChangeNotification object:nil];
+        [[NSNotificationCenter defaultCenter] addObserver:self selector:@selector(processInfoStateDidChange) name:NSProcessInfoThermalStateDidChangeNotification object:nil];
+    }
+    return self;
+}
+
+- (BOOL)isLowPowerModeEnabled:(NSProcessInfo *)processInfo {
+    // Low Power Mode is not available on Mac Catalyst before macOS 12
+    if ([processInfo respondsToSelector:@selector(isLowPowerModeEnabled)])
+        return processInfo.isLowPowerModeEnabled;
+    return NO;
+}
+
++ (BOOL)isConstrainedWithLowPowerMode:(BOOL)lowPowerMode thermalState:(NSProcessInfoThermalState)thermalState {
+    return lowPowerMode || thermalState >= NSProcessInfoThermalStateSerious;
+}
+
+- (void)processInfoStateDidChange {
+    NSProcessInfo *processInfo = NSProcessInfo.processInfo;
+    [self updateWithLowPowerMode:[self isLowPowerModeEnabled:processInfo] thermalState:processInfo.thermalState];
+}
+
+- (void)updateWithLowPowerMode:(BOOL)lowPowerMode thermalState:(NSProcessInfoThermalState)thermalState {
+    BOOL constrained = [OSPowerPolicy isConstrainedWithLowPowerMode:lowPowerMode thermalState:thermalState];
+    @synchronized (self) {
+        if (_constrained == constrained)
+            return;
+        _constrained = constrained;
+    }
+    [OneSignalLog onesignalLog:ONE_S_LL_DEBUG message:[NSString stringWithFormat:@"OSPowerPolicy constrained: %d (low power mode: %d, thermal state: %ld)", constrained, lowPowerMode, (long)thermalState]];
+    [[NSNotificationCenter defaultCenter] postNotificationName:OS_POWER_POLICY_CHANGED_NOTIFICATION object:self];
+}
+
+- (BOOL)isConstrained {
+    @synchronized (self) {
+        return _constrained;
+    }
+}
+
+- (BOOL)allowsPrefetch {
+    return !self.isConstrained;
+}
+
+- (double)scaledDelay:(double)delay {
+    return self.isConstrained ? delay * OS_POWER_POLICY_DELAY_MULTIPLIER : delay;
+}
+
+- (NSTimeInterval)telemetryDeferral:(NSTimeInterval)delay {
+    return self.isConstrained ? MAX(delay * OS_POWER_POLICY_DELAY_MULTIPLIER, OS_POWER_POLICY_MIN_TELEMETRY_DEFERRAL) : delay;
+}
+
+- (double)scaledDistance:(double)distance {
+    return self.isConstrained ? distance * OS_POWER_POLICY_DISTANCE_MULTIPLIER : distance;
+}
+
+@end
@@ -32,4 +32,6 @@ THE SOFTWARE.
 + (BOOL)getPrivacyConsent;
 + (BOOL)shouldLogMissingPrivacyConsentErrorWithMethodName:(NSString *)methodName;
 + (void)setRequiresPrivacyConsent:(BOOL)required;
+// Re-reads the consent state from storage, called when it changes outside of this class
++ (void)reloadPrivacyConsentState;
 @end
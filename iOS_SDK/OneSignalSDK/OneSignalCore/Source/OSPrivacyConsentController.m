@@ -27,14 +27,58 @@ THE SOFTWARE.
 
 
 #import <Foundation/Foundation.h>
+#import <stdatomic.h>
 #import "OSPrivacyConsentController.h"
+#import "OneSignalConfigManager.h"
 #import "OneSignalUserDefaults.h"
 #import "OneSignalCommonDefines.h"
 #import "OneSignalLog.h"
 #import "OSRemoteParamController.h"
 
+// Bits of the consent state published to readers, zero until it is first loaded
+#define OS_CONSENT_STATE_LOADED (1 << 0)
+#define OS_CONSENT_STATE_REQUIRES_CONSENT (1 << 1)
+#define OS_CONSENT_STATE_CONSENT_GIVEN (1 << 2)
+
 @implementation OSPrivacyConsentController
 
+static atomic_uint _consentState;
+
+/*
+ The consent state only changes through this class and remote params, so it is loaded from storage once
+ and re-published on each change. Readers then pay a single atomic load instead of two user defaults reads.
+ */
++ (unsigned int)consentState {
+    unsigned int state = atomic_load_explicit(&_consentState, memory_order_relaxed);
+    if (state & OS_CONSENT_STATE_LOADED)
+        return state;
+    return [self loadConsentState];
+}
+
++ (unsigned int)loadConsentState {
+    BOOL shouldRequireUserConsent = [OneSignalUserDefaults.initShared getSavedBoolForKey:OSUD_REQUIRES_USER_PRIVACY_CONSENT defaultValue:NO];
+    // if the plist key does not exist default to true
+    // the plist value specifies whether GDPR privacy consent is required for this app
+    // if required and consent has not been previously granted, return false
+    BOOL requiresConsent = [[[NSBundle mainBundle] objectForInfoDictionaryKey:ONESIGNAL_REQUIRE_PRIVACY_CONSENT] boolValue] ?: false;
+    BOOL consentGranted = [OneSignalUserDefaults.initStandard getSavedBoolForKey:GDPR_CONSENT_GRANTED defaultValue:false];
+    // The default is the inverse of privacy consent required
+    BOOL privacyConsent = [OneSignalUserDefaults.initStandard getSavedBoolForKey:GDPR_CONSENT_GRANTED defaultValue:!shouldRequireUserConsent];
+
+    unsigned int state = OS_CONSENT_STATE_LOADED;
+    if ((requiresConsent || shouldRequireUserConsent) && !consentGranted)
+        state |= OS_CONSENT_STATE_REQUIRES_CONSENT;
+    if (privacyConsent)
+        state |= OS_CONSENT_STATE_CONSENT_GIVEN;
+    atomic_store_explicit(&_consentState, state, memory_order_relaxed);
+    return state;
+}
+
++ (void)reloadPrivacyConsentState {
+    [self loadConsentState];
+    [OneSignalConfigManager updateReadiness];
+}
+
 + (void)setRequiresPrivacyConsent:(BOOL)required {
     OSRemoteParamController *remoteParamController = [OSRemoteParamController sharedController];
 
@@ -47,28 +91,20 @@ THE SOFTWARE.
         return;
     }
     [OneSignalUserDefaults.initShared saveBoolForKey:OSUD_REQUIRES_USER_PRIVACY_CONSENT withValue:required];
+    [self reloadPrivacyConsentState];
 }
 
 + (BOOL)requiresUserPrivacyConsent {
-    BOOL shouldRequireUserConsent = [OneSignalUserDefaults.initShared getSavedBoolForKey:OSUD_REQUIRES_USER_PRIVACY_CONSENT defaultValue:NO];
-    // if the plist key does not exist default to true
-    // the plist value specifies whether GDPR privacy consent is required for this app
-    // if required and consent has not been previously granted, return false
-    BOOL requiresConsent = [[[NSBundle mainBundle] objectForInfoDictionaryKey:ONESIGNAL_REQUIRE_PRIVACY_CONSENT] boolValue] ?: false;
-    if (requiresConsent || shouldRequireUserConsent)
-        return ![OneSignalUserDefaults.initStandard getSavedBoolForKey:GDPR_CONSENT_GRANTED defaultValue:false];
-    
-    return false;
+    return ([self consentState] & OS_CONSENT_STATE_REQUIRES_CONSENT) != 0;
 }
 
 + (void)consentGranted:(BOOL)granted {
     [OneSignalUserDefaults.initStandard saveBoolForKey:GDPR_CONSENT_GRANTED withValue:granted];
+    [self reloadPrivacyConsentState];
 }
 
 + (BOOL)getPrivacyConsent {
-    // The default is the inverse of privacy consent required
-    BOOL defaultValue = ![OneSignalUserDefaults.initShared getSavedBoolForKey:OSUD_REQUIRES_USER_PRIVACY_CONSENT defaultValue:NO];
-    return [OneSignalUserDefaults.initStandard getSavedBoolForKey:GDPR_CONSENT_GRANTED defaultValue:defaultValue];
+    return ([self consentState] & OS_CONSENT_STATE_CONSENT_GIVEN) != 0;
 }
 
 + (BOOL)shouldLogMissingPrivacyConsentErrorWithMethodName:(NSString *)methodName {
@@ -0,0 +1,51 @@
+/**
+ * Modified MIT License
+ *
+ * Copyright 2024 OneSignal
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * 2. All copies of substantial portions of the Software may only be used in connection
+ * with services provided by OneSignal.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#import <Foundation/Foundation.h>
+
+#ifndef OSProcessedNotifications_h
+#define OSProcessedNotifications_h
+
+// Kinds of processing that should happen at most once per notification
+#define OS_PROCESSED_NOTIFICATION_RECEIVED @"received"
+#define OS_PROCESSED_NOTIFICATION_OPENED @"opened"
+
+/**
+ Remembers which notification ids were already processed, shared between the app and the NSE through the app group.
+ Ids are kept for a bounded window, so a redelivered or replayed notification is recognized as a duplicate.
+ Each id is a marker file in the app group container, falling back to the shared NSUserDefaults without one.
+ */
+@interface OSProcessedNotifications : NSObject
+/**
+ Returns true the first time it is called for a notification id and kind, recording it as processed.
+ Returns false if it was already processed, by this process or the other one.
+ */
++ (BOOL)claimNotificationId:(NSString * _Nonnull)notificationId kind:(NSString * _Nonnull)kind;
++ (BOOL)wasProcessed:(NSString * _Nonnull)notificationId kind:(NSString * _Nonnull)kind;
+@end
+
+#endif /* OSProcessedNotifications_h */
@@ -0,0 +1,203 @@
+/**
+ * Modified MIT License
+ *
+ * Copyright 2024 OneSignal
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * 2. All copies of substantial portions of the Software may only be used in connection
+ * with services provided by OneSignal.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#import <Foundation/Foundation.h>
+#import <sys/file.h>
+#import <sys/stat.h>
+#import "OSProcessedNotifications.h"
+#import "OneSignalCoreHelper.h"
+#import "OneSignalCommonDefines.h"
+#import "OneSignalUserDefaults.h"
+#import "OSMacros.h"
+#import "OSSharedStateVersion.h"
+
+@implementation OSProcessedNotifications
+
+// The stored dictionary as of `cachedVersion`, synchronized on the class
+static NSDictionary *cachedProcessed;
+static NSUInteger cachedVersion;
+
+/*
+ Stored as kind -> notification id -> processed timestamp, so probing an id is a dictionary lookup.
+ The other process may have written to it, so it is read from the app group again whenever
+ OSSharedStateVersion reports a change.
+ */
++ (NSDictionary<NSString *, NSNumber *> *)processedIdsForKind:(NSString *)kind {
+    NSUInteger version = [OSSharedStateVersion currentVersion];
+    if (!cachedProcessed || version != cachedVersion) {
+        cachedProcessed = [OneSignalUserDefaults.initShared getSavedDictionaryForKey:OSUD_PROCESSED_NOTIFICATION_IDS defaultValue:@{}];
+        cachedVersion = version;
+    }
+    NSDictionary *ids = cachedProcessed[kind];
+    return [ids isKindOfClass:[NSDictionary class]] ? ids : @{};
+}
+
++ (BOOL)isProcessedAt:(NSNumber *)timestamp {
+    return timestamp && [NSDate date].timeIntervalSince1970 - timestamp.doubleValue < OS_PROCESSED_NOTIFICATION_IDS_WINDOW;
+}
+
++ (BOOL)wasProcessed:(NSString *)notificationId kind:(NSString *)kind {
+    @synchronized (self) {
+        if ([self isProcessedAt:[self processedIdsForKind:kind][notificationId]])
+            return true;
+    }
+    NSString *marker = [self markerPathForNotificationId:notificationId kind:kind];
+    return marker && [self isMarkerProcessed:marker];
+}
+
++ (BOOL)claimNotificationId:(NSString *)notificationId kind:(NSString *)kind {
+    NSString *marker = [self markerPathForNotificationId:notificationId kind:kind];
+    if (!marker)
+        return [self claimInUserDefaults:notificationId kind:kind];
+    // Ids claimed by earlier versions are only in the user defaults
+    @synchronized (self) {
+        if ([self isProcessedAt:[self processedIdsForKind:kind][notificationId]])
+            return false;
+    }
+    return [self claimMarker:marker];
+}
+
+#pragma mark Marker files
+
+// nil if the app group is not set up, the ids are then kept in the shared NSUserDefaults
++ (NSURL *)markersDirectory {
+    static NSURL *directory;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        NSURL *container = [[NSFileManager defaultManager] containerURLForSecurityApplicationGroupIdentifier:[OneSignalUserDefaults appGroupName]];
+        if (container)
+            directory = [container URLByAppendingPathComponent:ONESIGNAL_PROCESSED_NOTIFICATIONS_DIRECTORY isDirectory:YES];
+    });
+    return directory;
+}
+
++ (NSString *)markerPathForNotificationId:(NSString *)notificationId kind:(NSString *)kind {
+    NSURL *directory = [self markersDirectory];
+    if (!directory)
+        return nil;
+    NSURL *kindDirectory = [directory URLByAppendingPathComponent:kind isDirectory:YES];
+    [[NSFileManager defaultManager] createDirectoryAtURL:kindDirectory withIntermediateDirectories:YES attributes:nil error:nil];
+    // Hashed so any id makes a valid file name
+    return [kindDirectory URLByAppendingPathComponent:[OneSignalCoreHelper hashUsingSha1:notificationId]].path;
+}
+
++ (BOOL)isMarkerProcessed:(NSString *)marker {
+    struct stat info;
+    if (stat(marker.fileSystemRepresentation, &info) != 0)
+        return false;
+    return [self isProcessedAt:@(info.st_mtimespec.tv_sec)];
+}
+
+/*
+ Creating the marker with O_EXCL succeeds in exactly one process, so the app and the NSE can never both claim an id.
+ A marker left from outside the window is renewed under a lock on the directory, and checked again once the lock is held.
+ */
++ (BOOL)claimMarker:(NSString *)marker {
+    int fd = open(marker.fileSystemRepresentation, O_WRONLY | O_CREAT | O_EXCL, 0644);
+    if (fd >= 0) {
+        close(fd);
+        [self pruneMarkersNextTo:marker];
+        return true;
+    }
+    if (errno != EEXIST || [self isMarkerProcessed:marker])
+        return false;
+
+    NSString *lockPath = [[self markersDirectory] URLByAppendingPathComponent:@".lock"].path;
+    int lock = open(lockPath.fileSystemRepresentation, O_RDWR | O_CREAT, 0644);
+    if (lock < 0)
+        return false;
+    flock(lock, LOCK_EX);
+    BOOL claimed = ![self isMarkerProcessed:marker] && utimes(marker.fileSystemRepresentation, NULL) == 0;
+    flock(lock, LOCK_UN);
+    close(lock);
+    return claimed;
+}
+
+// Once there are more markers than the limit, the expired ones are dropped, then the oldest ones if there are still too many
++ (void)pruneMarkersNextTo:(NSString *)marker {
+    NSURL *kindDirectory = [NSURL fileURLWithPath:marker.stringByDeletingLastPathComponent isDirectory:YES];
+    NSArray<NSURL *> *markers = [[NSFileManager defaultManager] contentsOfDirectoryAtURL:kindDirectory includingPropertiesForKeys:@[NSURLContentModificationDateKey] options:NSDirectoryEnumerationSkipsHiddenFiles error:nil];
+    if (markers.count <= OS_PROCESSED_NOTIFICATION_IDS_LIMIT)
+        return;
+    NSMutableArray<NSURL *> *kept = [NSMutableArray new];
+    for (NSURL *url in markers) {
+        if ([self isMarkerProcessed:url.path])
+            [kept addObject:url];
+        else
+            [[NSFileManager defaultManager] removeItemAtURL:url error:nil];
+    }
+    if (kept.count <= OS_PROCESSED_NOTIFICATION_IDS_LIMIT)
+        return;
+    [kept sortUsingComparator:^NSComparisonResult(NSURL *first, NSURL *second) {
+        NSDate *firstDate, *secondDate;
+        [first getResourceValue:&firstDate forKey:NSURLContentModificationDateKey error:nil];
+        [second getResourceValue:&secondDate forKey:NSURLContentModificationDateKey error:nil];
+        return [firstDate compare:secondDate];
+    }];
+    for (NSUInteger i = 0; i < kept.count - OS_PROCESSED_NOTIFICATION_IDS_LIMIT; i++) {
+        if (![kept[i].path isEqualToString:marker])
+            [[NSFileManager defaultManager] removeItemAtURL:kept[i] error:nil];
+    }
+}
+
+#pragma mark User defaults
+
++ (BOOL)claimInUserDefaults:(NSString *)notificationId kind:(NSString *)kind {
+    @synchronized (self) {
+        // Claims always read the stored ids, a stale cache could hand the same id to both processes
+        NSUInteger version = [OSSharedStateVersion currentVersion];
+        let sharedUserDefaults = OneSignalUserDefaults.initShared;
+        NSMutableDictionary *processed = [[sharedUserDefaults getSavedDictionaryForKey:OSUD_PROCESSED_NOTIFICATION_IDS defaultValue:@{}] mutableCopy];
+        NSMutableDictionary<NSString *, NSNumber *> *ids = [NSMutableDictionary new];
+        if ([processed[kind] isKindOfClass:[NSDictionary class]]) {
+            [ids addEntriesFromDictionary:processed[kind]];
+        }
+        if ([self isProcessedAt:ids[notificationId]]) {
+            return false;
+        }
+
+        // Expired ids are dropped as new ones are recorded, then the oldest ones if there are still too many
+        NSTimeInterval now = [NSDate date].timeIntervalSince1970;
+        for (NSString *processedId in ids.allKeys) {
+            if (![self isProcessedAt:ids[processedId]]) {
+                [ids removeObjectForKey:processedId];
+            }
+        }
+        if (ids.count >= OS_PROCESSED_NOTIFICATION_IDS_LIMIT) {
+            NSArray *oldestFirst = [ids keysSortedByValueUsingSelector:@selector(compare:)];
+            [ids removeObjectsForKeys:[oldestFirst subarrayWithRange:NSMakeRange(0, ids.count - OS_PROCESSED_NOTIFICATION_IDS_LIMIT + 1)]];
+        }
+        ids[notificationId] = @(now);
+        processed[kind] = ids;
+        [sharedUserDefaults saveDictionaryForKey:OSUD_PROCESSED_NOTIFICATION_IDS withValue:processed];
+        cachedProcessed = [processed copy];
+        cachedVersion = version;
+        return true;
+    }
+}
+
+@end
@@ -0,0 +1,58 @@
+/**
+ * Modified MIT License
+ *
+ * Copyright 2024 OneSignal
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * 2. All copies of substantial portions of the Software may only be used in connection
+ * with services provided by OneSignal.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#import <Foundation/Foundation.h>
+#import "OSStorageEngine.h"
+
+#ifndef OSSQLiteStorageEngine_h
+#define OSSQLiteStorageEngine_h
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ Stores each key as its own row in a SQLite database, so a write only touches that key.
+ Keys not in the database yet are moved into it from `fallback` on their first read, `fallback` being where they
+ were stored before the engine was enabled.
+ */
+@interface OSSQLiteStorageEngine : NSObject <OSStorageEngine>
+
+/**
+ Nil if the database can not be opened, callers should keep using NSUserDefaults.
+ Pass `sharedContainer` for a database in an app group container, it then never holds a file lock between writes.
+ */
+- (instancetype _Nullable)initWithPath:(NSString *)path fallback:(NSUserDefaults * _Nullable)fallback sharedContainer:(BOOL)sharedContainer;
+
+// Moves every row back into the user defaults and deletes the database, for when the engine is turned off again
++ (BOOL)exportDatabaseAtPath:(NSString *)path toUserDefaults:(NSUserDefaults *)userDefaults;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+@end
+
+NS_ASSUME_NONNULL_END
+
+#endif /* OSSQLiteStorageEngine_h */
@@ -0,0 +1,296 @@
+/**
+ * Modified MIT License
+ *
+ * Copyright 2024 OneSignal
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * 2. All copies of substantial portions of the Software may only be used in connection
+ * with services provided by OneSignal.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#import <sqlite3.h>
+#import "OSSQLiteStorageEngine.h"
+#import "OneSignalLog.h"
+
+// How a row's value column is encoded
+typedef NS_ENUM(int, OSStorageValueKind) {
+    // NSData stored as is, such as NSKeyedArchiver blobs
+    OSStorageValueKindData = 0,
+    // Any other property list object, as a binary plist
+    OSStorageValueKindPropertyList = 1
+};
+
+// How long a write waits for the other process to finish its write before failing
+#define OS_SQLITE_BUSY_TIMEOUT_MS 2000
+
+@implementation OSSQLiteStorageEngine {
+    sqlite3 *database;
+    sqlite3_stmt *selectStatement;
+    sqlite3_stmt *upsertStatement;
+    sqlite3_stmt *insertIfMissingStatement;
+    sqlite3_stmt *deleteStatement;
+    NSUserDefaults *fallback;
+}
+
+- (instancetype _Nullable)initWithPath:(NSString *)path fallback:(NSUserDefaults * _Nullable)fallbackUserDefaults sharedContainer:(BOOL)sharedContainer {
+    self = [super init];
+    if (!self)
+        return nil;
+
+    fallback = fallbackUserDefaults;
+    [[NSFileManager defaultManager] createDirectoryAtPath:[path stringByDeletingLastPathComponent] withIntermediateDirectories:YES attributes:nil error:nil];
+
+    int flags = SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE | SQLITE_OPEN_FULLMUTEX;
+    if (sqlite3_open_v2(path.UTF8String, &database, flags, NULL) != SQLITE_OK) {
+        [self logError:@"open"];
+        return nil;
+    }
+    sqlite3_busy_timeout(database, OS_SQLITE_BUSY_TIMEOUT_MS);
+
+    /*
+     iOS terminates a suspended app holding a file lock in an app group container with 0xdead10cc.
+     A WAL connection keeps a shared lock on the -shm file as long as it is open, so the shared database
+     uses a rollback journal instead, which only holds locks for the length of a statement or transaction.
+     The busy timeout still lets the app and its extension take turns writing.
+     */
+    NSString *journalMode = sharedContainer ? @"PRAGMA journal_mode=DELETE;" : @"PRAGMA journal_mode=WAL;";
+    if (![self execute:journalMode] ||
+        ![self execute:@"PRAGMA synchronous=NORMAL;"] ||
+        ![self execute:@"CREATE TABLE IF NOT EXISTS kv (key TEXT PRIMARY KEY NOT NULL, kind INTEGER NOT NULL, value BLOB NOT NULL) WITHOUT ROWID;"] ||
+        ![self prepare:@"SELECT kind, value FROM kv WHERE key = ?;" statement:&selectStatement] ||
+        ![self prepare:@"INSERT OR REPLACE INTO kv (key, kind, value) VALUES (?, ?, ?);" statement:&upsertStatement] ||
+        ![self prepare:@"INSERT OR IGNORE INTO kv (key, kind, value) VALUES (?, ?, ?);" statement:&insertIfMissingStatement] ||
+        ![self prepare:@"DELETE FROM kv WHERE key = ?;" statement:&deleteStatement])
+        return nil;
+
+    return self;
+}
+
+- (void)dealloc {
+    sqlite3_finalize(selectStatement);
+    sqlite3_finalize(upsertStatement);
+    sqlite3_finalize(insertIfMissingStatement);
+    sqlite3_finalize(deleteStatement);
+    sqlite3_close(database);
+}
+
++ (BOOL)exportDatabaseAtPath:(NSString *)path toUserDefaults:(NSUserDefaults *)userDefaults {
+    OSSQLiteStorageEngine *engine = [[OSSQLiteStorageEngine alloc] initWithPath:path fallback:nil sharedContainer:true];
+    if (!engine)
+        return false;
+    BOOL exported = [engine exportRowsToUserDefaults:userDefaults];
+    // Closes the database before its files are removed
+    engine = nil;
+    if (!exported)
+        return false;
+
+    // Only removed once every row is in the user defaults
+    for (NSString *suffix in @[@"", @"-wal", @"-shm", @"-journal"]) {
+        [[NSFileManager defaultManager] removeItemAtPath:[path stringByAppendingString:suffix] error:nil];
+    }
+    return true;
+}
+
+- (BOOL)exportRowsToUserDefaults:(NSUserDefaults *)userDefaults {
+    sqlite3_stmt *statement;
+    if (![self prepare:@"SELECT key, kind, value FROM kv;" statement:&statement])
+        return false;
+    int result;
+    @synchronized (self) {
+        while ((result = sqlite3_step(statement)) == SQLITE_ROW) {
+            const char *key = (const char *)sqlite3_column_text(statement, 0);
+            id value = [self decodeColumnsOfStatement:statement startingAt:1];
+            if (key && value)
+                [userDefaults setObject:value forKey:[NSString stringWithUTF8String:key]];
+        }
+        sqlite3_finalize(statement);
+    }
+    if (result != SQLITE_DONE) {
+        [self logError:@"export"];
+        return false;
+    }
+    return [userDefaults synchronize];
+}
+
+- (void)logError:(NSString *)operation {
+    [OneSignalLog onesignalLog:ONE_S_LL_ERROR message:[NSString stringWithFormat:@"OSSQLiteStorageEngine %@ failed: %s", operation, database ? sqlite3_errmsg(database) : "no database"]];
+}
+
+- (BOOL)execute:(NSString *)sql {
+    if (sqlite3_exec(database, sql.UTF8String, NULL, NULL, NULL) == SQLITE_OK)
+        return true;
+    [self logError:sql];
+    return false;
+}
+
+- (BOOL)prepare:(NSString *)sql statement:(sqlite3_stmt **)statement {
+    if (sqlite3_prepare_v2(database, sql.UTF8String, -1, statement, NULL) == SQLITE_OK)
+        return true;
+    [self logError:sql];
+    return false;
+}
+
+#pragma mark OSStorageEngine
+
+- (id _Nullable)objectForKey:(NSString *)key {
+    id value = nil;
+    BOOL found = false;
+    @synchronized (self) {
+        found = [self readKey:key value:&value];
+    }
+    if (found)
+        return value;
+
+    // Stored before the engine was enabled. It is moved into the database, unless the other process already wrote the key.
+    id legacyValue = [fallback objectForKey:key];
+    if (!legacyValue)
+        return nil;
+    @synchronized (self) {
+        if (![self bindValue:legacyValue forKey:key toStatement:insertIfMissingStatement])
+            return legacyValue;
+        [self readKey:key value:&value];
+    }
+    [fallback removeObjectForKey:key];
+    return value;
+}
+
+- (void)setObject:(id)value forKey:(NSString *)key {
+    @synchronized (self) {
+        [self writeValue:value forKey:key];
+    }
+}
+
+- (void)removeObjectForKey:(NSString *)key {
+    BOOL deleted;
+    @synchronized (self) {
+        deleted = [self deleteKey:key];
+    }
+    // Only once the row is gone, the fallback is the copy of a key that failed to move into the database
+    if (deleted)
+        [fallback removeObjectForKey:key];
+}
+
+- (BOOL)applyChanges:(NSDictionary<NSString *, id> *)changes {
+    NSMutableArray<NSString *> *removedKeys = [NSMutableArray new];
+    @synchronized (self) {
+        // One transaction, and so one commit, for the whole batch
+        if (![self execute:@"BEGIN IMMEDIATE;"])
+            return false;
+        for (NSString *key in changes) {
+            id value = changes[key];
+            BOOL applied;
+            if (value == [NSNull null]) {
+                applied = [self deleteKey:key];
+                [removedKeys addObject:key];
+            } else {
+                applied = [self writeValue:value forKey:key];
+            }
+            // Committing the rest would report the whole batch as written
+            if (!applied) {
+                [self execute:@"ROLLBACK;"];
+                return false;
+            }
+        }
+        if (![self execute:@"COMMIT;"]) {
+            // Such as the other process holding its lock past the busy timeout, none of the batch was written
+            [self execute:@"ROLLBACK;"];
+            return false;
+        }
+    }
+    for (NSString *key in removedKeys) {
+        [fallback removeObjectForKey:key];
+    }
+    return true;
+}
+
+// Every write is committed when it is made, there is nothing left to flush
+- (BOOL)synchronize {
+    return true;
+}
+
+#pragma mark Statements
+
+// Caller must hold the lock on self
+- (BOOL)readKey:(NSString *)key value:(id *)value {
+    BOOL found = false;
+    sqlite3_bind_text(selectStatement, 1, key.UTF8String, -1, SQLITE_TRANSIENT);
+    if (sqlite3_step(selectStatement) == SQLITE_ROW) {
+        found = true;
+        *value = [self decodeColumnsOfStatement:selectStatement startingAt:0];
+    }
+    sqlite3_reset(selectStatement);
+    sqlite3_clear_bindings(selectStatement);
+    return found;
+}
+
+// The kind column followed by the value column
+- (id _Nullable)decodeColumnsOfStatement:(sqlite3_stmt *)statement startingAt:(int)column {
+    int kind = sqlite3_column_int(statement, column);
+    NSData *data = [NSData dataWithBytes:sqlite3_column_blob(statement, column + 1) length:sqlite3_column_bytes(statement, column + 1)];
+    if (kind == OSStorageValueKindData)
+        return data;
+    return [NSPropertyListSerialization propertyListWithData:data options:NSPropertyListImmutable format:nil error:nil];
+}
+
+// Caller must hold the lock on self
+- (BOOL)writeValue:(id)value forKey:(NSString *)key {
+    return [self bindValue:value forKey:key toStatement:upsertStatement];
+}
+
+// Runs an insert statement for the key and value. Caller must hold the lock on self.
+- (BOOL)bindValue:(id)value forKey:(NSString *)key toStatement:(sqlite3_stmt *)statement {
+    OSStorageValueKind kind = OSStorageValueKindData;
+    NSData *data = value;
+    if (![value isKindOfClass:[NSData class]]) {
+        kind = OSStorageValueKindPropertyList;
+        data = [NSPropertyListSerialization dataWithPropertyList:value format:NSPropertyListBinaryFormat_v1_0 options:0 error:nil];
+        if (!data) {
+            [OneSignalLog onesignalLog:ONE_S_LL_ERROR message:[NSString stringWithFormat:@"OSSQLiteStorageEngine can not store non property list value for key: %@", key]];
+            return false;
+        }
+    }
+
+    sqlite3_bind_text(statement, 1, key.UTF8String, -1, SQLITE_TRANSIENT);
+    sqlite3_bind_int(statement, 2, kind);
+    // An empty blob must still be bound as a blob, a NULL pointer would bind NULL
+    if (data.length == 0)
+        sqlite3_bind_zeroblob(statement, 3, 0);
+    else
+        sqlite3_bind_blob(statement, 3, data.bytes, (int)data.length, SQLITE_TRANSIENT);
+    BOOL written = sqlite3_step(statement) == SQLITE_DONE;
+    if (!written)
+        [self logError:@"write"];
+    sqlite3_reset(statement);
+    sqlite3_clear_bindings(statement);
+    return written;
+}
+
+// Caller must hold the lock on self
+- (BOOL)deleteKey:(NSString *)key {
+    sqlite3_bind_text(deleteStatement, 1, key.UTF8String, -1, SQLITE_TRANSIENT);
+    BOOL deleted = sqlite3_step(deleteStatement) == SQLITE_DONE;
+    if (!deleted)
+        [self logError:@"delete"];
+    sqlite3_reset(deleteStatement);
+    sqlite3_clear_bindings(deleteStatement);
+    return deleted;
+}
+
+@end
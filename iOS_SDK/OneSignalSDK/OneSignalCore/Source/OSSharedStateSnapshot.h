@@ -0,0 +1,66 @@
+/**
+ * Modified MIT License
+ *
+ * Copyright 2024 OneSignal
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * 2. All copies of substantial portions of the Software may only be used in connection
+ * with services provided by OneSignal.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#import <Foundation/Foundation.h>
+
+#ifndef OSSharedStateSnapshot_h
+#define OSSharedStateSnapshot_h
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ A small, versioned, read-only copy of the app group values extensions and App Clips read when they start,
+ such as the app id and subscription id. It is written whenever one of those values is saved to the shared suite
+ and memory-mapped by readers, so they can skip loading the shared NSUserDefaults plist.
+ OneSignalUserDefaults keeps it up to date and reads from it, callers should not need to use it directly.
+ */
+@interface OSSharedStateSnapshot : NSObject
+
+// Whether the key is one of the values kept in the snapshot
++ (BOOL)isSnapshotKey:(NSString *)key;
+
+// Records a value saved to the shared suite, or a removal if nil, and schedules the snapshot file write
++ (void)setValue:(id _Nullable)value forKey:(NSString *)key;
+
+/**
+ Returns YES if the snapshot has a value for the key, through `value`.
+ Returns NO if it does not, or there is no snapshot yet, and the value should be read from the shared suite.
+ The snapshot is read again after another process announces a change through OSSharedStateVersion.
+ */
++ (BOOL)getValue:(id _Nullable * _Nonnull)value forKey:(NSString *)key;
+
+// Writes values set since the last write now, before other processes are told the shared suite changed
++ (void)flush;
+
+// Deletes the snapshot, for clearing state in unit tests along with the shared suite
++ (void)discardSnapshot;
+
+@end
+
+NS_ASSUME_NONNULL_END
+
+#endif /* OSSharedStateSnapshot_h */
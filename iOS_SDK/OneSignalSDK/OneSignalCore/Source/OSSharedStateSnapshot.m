@@ -0,0 +1,318 @@
+/**
+ * Modified MIT License
+ *
+ * Copyright 2024 OneSignal
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * 2. All copies of substantial portions of the Software may only be used in connection
+ * with services provided by OneSignal.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#import <sys/stat.h>
+#import "OSSharedStateSnapshot.h"
+#import "OneSignalCommonDefines.h"
+#import "OneSignalUserDefaults.h"
+#import "OSSharedStateVersion.h"
+#import "OSDispatchQueues.h"
+
+// "OSSS", followed by the format version and the entry count
+#define OS_SNAPSHOT_MAGIC 0x5353534F
+#define OS_SNAPSHOT_FORMAT_VERSION 1
+
+// Each entry is the value type, the key length and key, then the value length and value
+typedef NS_ENUM(uint8_t, OSSnapshotValueType) {
+    OSSnapshotValueTypeString = 1,
+    OSSnapshotValueTypeBool = 2,
+    OSSnapshotValueTypeInteger = 3,
+    OSSnapshotValueTypeDouble = 4
+};
+
+@implementation OSSharedStateSnapshot
+
+// The file's values with `pendingValues` on top, nil if there is no snapshot. Synchronized on the class.
+static NSMutableDictionary<NSString *, id> *values;
+// Values set by this process that are not in the file yet, NSNull for a removal
+static NSMutableDictionary<NSString *, id> *pendingValues;
+// Identifies the file `values` was read from, a write by another process replaces the file
+static ino_t loadedInode;
+static struct timespec loadedModified;
+// The OSSharedStateVersion the file was last checked at
+static NSUInteger loadedVersion;
+static BOOL writeScheduled = false;
+
++ (NSSet<NSString *> *)snapshotKeys {
+    static NSSet *keys;
+    static dispatch_once_t once;
+    dispatch_once(&once, ^{
+        keys = [NSSet setWithArray:@[OSUD_APP_ID, OSUD_PUSH_SUBSCRIPTION_ID, OSUD_RECEIVE_RECEIPTS_ENABLED, OSUD_REQUIRES_USER_PRIVACY_CONSENT]];
+    });
+    return keys;
+}
+
++ (BOOL)isSnapshotKey:(NSString *)key {
+    return [[self snapshotKeys] containsObject:key];
+}
+
+// Nil when there is no app group container, the snapshot is not used then
++ (NSString *)path {
+    static NSString *path;
+    static dispatch_once_t once;
+    dispatch_once(&once, ^{
+        NSURL *container = [[NSFileManager defaultManager] containerURLForSecurityApplicationGroupIdentifier:[OneSignalUserDefaults appGroupName]];
+        path = [[container URLByAppendingPathComponent:@"OneSignal" isDirectory:YES] URLByAppendingPathComponent:@"shared_state.snapshot"].path;
+    });
+    return path;
+}
+
++ (dispatch_queue_t)writeQueue {
+    static dispatch_queue_t queue;
+    static dispatch_once_t once;
+    dispatch_once(&once, ^{
+        queue = dispatch_queue_create_with_target("com.onesignal.sharedstatesnapshot", DISPATCH_QUEUE_SERIAL, OSDispatchQueues.utility);
+    });
+    return queue;
+}
+
+#pragma mark Reading
+
++ (BOOL)getValue:(id _Nullable * _Nonnull)value forKey:(NSString *)key {
+    if (![self isSnapshotKey:key] || ![self path])
+        return false;
+    // Checked before loading, so a change made while loading is seen on the next read
+    NSUInteger version = [OSSharedStateVersion currentVersion];
+    @synchronized (self) {
+        // The stat alone can miss a replacement, such as one that reuses the inode within the timestamp's precision
+        if (version != loadedVersion) {
+            loadedVersion = version;
+            loadedInode = 0;
+        }
+        [self reloadIfChanged];
+        if (!values)
+            return false;
+        *value = values[key];
+        return true;
+    }
+}
+
+// Caller must hold the lock on the class
++ (void)reloadIfChanged {
+    struct stat info;
+    if (stat([self path].fileSystemRepresentation, &info) != 0) {
+        // Values set by this process are kept until they are written, they were seeded from the shared suite
+        if (pendingValues.count == 0)
+            values = nil;
+        return;
+    }
+    if (values && info.st_ino == loadedInode &&
+        info.st_mtimespec.tv_sec == loadedModified.tv_sec && info.st_mtimespec.tv_nsec == loadedModified.tv_nsec)
+        return;
+
+    // Mapped rather than read, the file is only a few hundred bytes but is read on every extension start
+    NSData *data = [NSData dataWithContentsOfFile:[self path] options:NSDataReadingMappedAlways error:nil];
+    NSMutableDictionary *loaded = [[self valuesFromData:data] mutableCopy];
+    loadedInode = info.st_ino;
+    loadedModified = info.st_mtimespec;
+    if (!loaded) {
+        if (pendingValues.count == 0)
+            values = nil;
+        return;
+    }
+    // Another process's write does not undo the ones this process has not written yet
+    for (NSString *key in pendingValues) {
+        id pending = pendingValues[key];
+        loaded[key] = pending == [NSNull null] ? nil : pending;
+    }
+    values = loaded;
+}
+
++ (NSDictionary<NSString *, id> *)valuesFromData:(NSData *)data {
+    const uint8_t *bytes = data.bytes;
+    NSUInteger length = data.length;
+    uint32_t header[3];
+    if (length < sizeof(header))
+        return nil;
+    memcpy(header, bytes, sizeof(header));
+    if (header[0] != OS_SNAPSHOT_MAGIC || header[1] != OS_SNAPSHOT_FORMAT_VERSION)
+        return nil;
+
+    NSMutableDictionary *decoded = [NSMutableDictionary new];
+    NSUInteger offset = sizeof(header);
+    for (uint32_t i = 0; i < header[2]; i++) {
+        uint8_t type;
+        uint16_t keyLength;
+        uint32_t valueLength;
+        if (offset + sizeof(type) + sizeof(keyLength) > length)
+            return nil;
+        memcpy(&type, bytes + offset, sizeof(type));
+        memcpy(&keyLength, bytes + offset + sizeof(type), sizeof(keyLength));
+        offset += sizeof(type) + sizeof(keyLength);
+        if (offset + keyLength + sizeof(valueLength) > length)
+            return nil;
+        NSString *key = [[NSString alloc] initWithBytes:bytes + offset length:keyLength encoding:NSUTF8StringEncoding];
+        memcpy(&valueLength, bytes + offset + keyLength, sizeof(valueLength));
+        offset += keyLength + sizeof(valueLength);
+        if (!key || offset + valueLength > length)
+            return nil;
+
+        id value = [self valueOfType:type bytes:bytes + offset length:valueLength];
+        if (!value)
+            return nil;
+        decoded[key] = value;
+        offset += valueLength;
+    }
+    return decoded;
+}
+
++ (id)valueOfType:(OSSnapshotValueType)type bytes:(const uint8_t *)bytes length:(uint32_t)length {
+    switch (type) {
+        case OSSnapshotValueTypeString:
+            return [[NSString alloc] initWithBytes:bytes length:length encoding:NSUTF8StringEncoding];
+        case OSSnapshotValueTypeBool:
+            return length == 1 ? @(bytes[0] != 0) : nil;
+        case OSSnapshotValueTypeInteger: {
+            int64_t integer;
+            if (length != sizeof(integer))
+                return nil;
+            memcpy(&integer, bytes, sizeof(integer));
+            return @(integer);
+        }
+        case OSSnapshotValueTypeDouble: {
+            double number;
+            if (length != sizeof(number))
+                return nil;
+            memcpy(&number, bytes, sizeof(number));
+            return @(number);
+        }
+    }
+    return nil;
+}
+
+#pragma mark Writing
+
++ (void)setValue:(id _Nullable)value forKey:(NSString *)key {
+    if (![self isSnapshotKey:key] || ![self path])
+        return;
+    @synchronized (self) {
+        [self reloadIfChanged];
+        // The first snapshot starts from the shared suite, so keys missing from it really are unset
+        if (!values) {
+            // Seeded before being assigned, while `values` is nil these reads go to the shared suite
+            NSMutableDictionary *seeded = [NSMutableDictionary new];
+            for (NSString *snapshotKey in [self snapshotKeys]) {
+                seeded[snapshotKey] = [OneSignalUserDefaults.initShared getSavedObjectForKey:snapshotKey defaultValue:nil];
+            }
+            values = seeded;
+        }
+        values[key] = value;
+        if (!pendingValues)
+            pendingValues = [NSMutableDictionary new];
+        pendingValues[key] = value ?: [NSNull null];
+        if (writeScheduled)
+            return;
+        writeScheduled = true;
+    }
+    dispatch_async([self writeQueue], ^{
+        [OSSharedStateSnapshot writeSnapshot];
+    });
+}
+
++ (void)flush {
+    if ([self path])
+        [self writeSnapshot];
+}
+
++ (void)writeSnapshot {
+    @synchronized (self) {
+        // Already written by a flush
+        if (!writeScheduled)
+            return;
+        writeScheduled = false;
+        // Picks up values another process wrote since the file was read, only the keys set here replace them
+        [self reloadIfChanged];
+        [pendingValues removeAllObjects];
+        // Discarded since the write was scheduled
+        if (!values)
+            return;
+        NSData *data = [self dataForValues:values];
+        [[NSFileManager defaultManager] createDirectoryAtPath:[[self path] stringByDeletingLastPathComponent] withIntermediateDirectories:YES attributes:nil error:nil];
+        // Atomic, so a reader that has the old file mapped keeps a complete copy
+        [data writeToFile:[self path] atomically:YES];
+
+        struct stat info;
+        if (stat([self path].fileSystemRepresentation, &info) == 0) {
+            loadedInode = info.st_ino;
+            loadedModified = info.st_mtimespec;
+        }
+    }
+}
+
++ (void)discardSnapshot {
+    @synchronized (self) {
+        values = nil;
+        [pendingValues removeAllObjects];
+        if ([self path])
+            [[NSFileManager defaultManager] removeItemAtPath:[self path] error:nil];
+    }
+}
+
++ (NSData *)dataForValues:(NSDictionary<NSString *, id> *)snapshotValues {
+    NSMutableData *entries = [NSMutableData new];
+    uint32_t count = 0;
+    for (NSString *key in snapshotValues) {
+        id value = snapshotValues[key];
+        OSSnapshotValueType type;
+        NSData *valueData;
+        if ([value isKindOfClass:[NSString class]]) {
+            type = OSSnapshotValueTypeString;
+            valueData = [value dataUsingEncoding:NSUTF8StringEncoding];
+        } else if ([value isKindOfClass:[NSNumber class]] && CFGetTypeID((__bridge CFTypeRef)value) == CFBooleanGetTypeID()) {
+            type = OSSnapshotValueTypeBool;
+            uint8_t flag = [value boolValue];
+            valueData = [NSData dataWithBytes:&flag length:sizeof(flag)];
+        } else if ([value isKindOfClass:[NSNumber class]] && !CFNumberIsFloatType((__bridge CFNumberRef)value)) {
+            type = OSSnapshotValueTypeInteger;
+            int64_t integer = [value longLongValue];
+            valueData = [NSData dataWithBytes:&integer length:sizeof(integer)];
+        } else if ([value isKindOfClass:[NSNumber class]]) {
+            type = OSSnapshotValueTypeDouble;
+            double number = [value doubleValue];
+            valueData = [NSData dataWithBytes:&number length:sizeof(number)];
+        } else {
+            continue;
+        }
+
+        NSData *keyData = [key dataUsingEncoding:NSUTF8StringEncoding];
+        uint16_t keyLength = (uint16_t)keyData.length;
+        uint32_t valueLength = (uint32_t)valueData.length;
+        [entries appendBytes:&type length:sizeof(type)];
+        [entries appendBytes:&keyLength length:sizeof(keyLength)];
+        [entries appendData:keyData];
+        [entries appendBytes:&valueLength length:sizeof(valueLength)];
+        [entries appendData:valueData];
+        count++;
+    }
+
+    uint32_t header[3] = {OS_SNAPSHOT_MAGIC, OS_SNAPSHOT_FORMAT_VERSION, count};
+    NSMutableData *data = [NSMutableData dataWithBytes:header length:sizeof(header)];
+    [data appendData:entries];
+    return data;
+}
+
+@end
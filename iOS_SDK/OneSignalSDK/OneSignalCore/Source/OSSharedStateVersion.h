@@ -0,0 +1,56 @@
+/**
+ * Modified MIT License
+ *
+ * Copyright 2024 OneSignal
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * 2. All copies of substantial portions of the Software may only be used in connection
+ * with services provided by OneSignal.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#import <Foundation/Foundation.h>
+
+#ifndef OSSharedStateVersion_h
+#define OSSharedStateVersion_h
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ Tells the app when an extension, such as the notification service extension, has changed OneSignal's app group state.
+ Extensions post a Darwin notification after their writes reach the app group, and the app reads it as a version number.
+ Code that keeps values from the app group in memory can compare versions and only read them again after a change.
+ */
+@interface OSSharedStateVersion : NSObject
+
+/**
+ Changes after every write to the app group by an extension, checking it does not touch the app group.
+ Read it before loading a value, so a change made while loading is seen on the next check.
+ In an extension it changes on every call, since the app does not announce its own writes.
+ */
++ (NSUInteger)currentVersion;
+
+// Called by OneSignalUserDefaults after writes to the app group are persisted, only posts from an extension
++ (void)postChange;
+
+@end
+
+NS_ASSUME_NONNULL_END
+
+#endif /* OSSharedStateVersion_h */
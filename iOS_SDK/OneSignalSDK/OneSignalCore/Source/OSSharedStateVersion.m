@@ -0,0 +1,83 @@
+/**
+ * Modified MIT License
+ *
+ * Copyright 2024 OneSignal
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * 2. All copies of substantial portions of the Software may only be used in connection
+ * with services provided by OneSignal.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#import <notify.h>
+#import "OSSharedStateVersion.h"
+#import "OneSignalUserDefaults.h"
+
+@implementation OSSharedStateVersion
+
+static int notifyToken = NOTIFY_TOKEN_INVALID;
+static NSUInteger version = 0;
+
+// One name per app group, so apps sharing a device don't wake each other
++ (const char *)notificationName {
+    static NSString *name;
+    static dispatch_once_t once;
+    dispatch_once(&once, ^{
+        name = [NSString stringWithFormat:@"%@.onesignal.shared_state_changed", [OneSignalUserDefaults appGroupName]];
+    });
+    return name.UTF8String;
+}
+
++ (BOOL)isExtension {
+    static BOOL isExtension;
+    static dispatch_once_t once;
+    dispatch_once(&once, ^{
+        isExtension = [NSBundle.mainBundle.bundleURL.pathExtension isEqualToString:@"appex"];
+    });
+    return isExtension;
+}
+
++ (NSUInteger)currentVersion {
+    @synchronized (self) {
+        // The app does not announce its writes, so in an extension every check counts as a change
+        if ([self isExtension])
+            return ++version;
+
+        if (notifyToken == NOTIFY_TOKEN_INVALID &&
+            notify_register_check([self notificationName], &notifyToken) != NOTIFY_STATUS_OK) {
+            notifyToken = NOTIFY_TOKEN_INVALID;
+        }
+
+        // notify_check reads shared memory, it does not message notifyd
+        int changed = 1;
+        if (notifyToken != NOTIFY_TOKEN_INVALID)
+            notify_check(notifyToken, &changed);
+        // Without a token every check counts as a change, so callers read the app group as they would without this
+        if (changed)
+            version++;
+        return version;
+    }
+}
+
++ (void)postChange {
+    if ([self isExtension])
+        notify_post([self notificationName]);
+}
+
+@end
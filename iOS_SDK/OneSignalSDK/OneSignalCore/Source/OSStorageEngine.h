@@ -0,0 +1,57 @@
+/**
+ * Modified MIT License
+ *
+ * Copyright 2024 OneSignal
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * 2. All copies of substantial portions of the Software may only be used in connection
+ * with services provided by OneSignal.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#import <Foundation/Foundation.h>
+
+#ifndef OSStorageEngine_h
+#define OSStorageEngine_h
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ Where OneSignalUserDefaults persists its values. Values are property list objects, the same as NSUserDefaults takes.
+ NSUserDefaults is the default engine, `OSSQLiteStorageEngine` is the opt-in alternative.
+ */
+@protocol OSStorageEngine <NSObject>
+
+- (id _Nullable)objectForKey:(NSString *)key;
+- (void)setObject:(id)value forKey:(NSString *)key;
+- (void)removeObjectForKey:(NSString *)key;
+- (BOOL)synchronize;
+
+@optional
+// Applies a batch of writes at once, NSNull values are removals. Engines without it, or returning false, get one call per key.
+- (BOOL)applyChanges:(NSDictionary<NSString *, id> *)changes;
+
+@end
+
+@interface NSUserDefaults (OSStorageEngine) <OSStorageEngine>
+@end
+
+NS_ASSUME_NONNULL_END
+
+#endif /* OSStorageEngine_h */
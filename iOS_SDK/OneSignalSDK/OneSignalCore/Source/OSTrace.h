@@ -0,0 +1,54 @@
+/**
+ * Modified MIT License
+ *
+ * Copyright 2024 OneSignal
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * 2. All copies of substantial portions of the Software may only be used in connection
+ * with services provided by OneSignal.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#import <Foundation/Foundation.h>
+
+#ifndef OSTrace_h
+#define OSTrace_h
+
+/*
+ Signpost intervals shown in Instruments under the com.onesignal.sdk subsystem, Performance category.
+ Each kind maps to a fixed signpost name, the name passed in is attached as the interval's message.
+ */
+typedef NS_ENUM(NSUInteger, OSTraceInterval) {
+    OSTraceIntervalInitStage,
+    OSTraceIntervalCacheLoad,
+    OSTraceIntervalRequest,
+    OSTraceIntervalIAMEvaluation
+};
+
+@interface OSTrace : NSObject
+
+// Returns the id to pass to endInterval:signpostId:, 0 when tracing is unavailable or disabled
++ (uint64_t)beginInterval:(OSTraceInterval)interval name:(NSString * _Nonnull)name NS_SWIFT_NAME(begin(_:name:));
++ (void)endInterval:(OSTraceInterval)interval signpostId:(uint64_t)signpostId NS_SWIFT_NAME(end(_:signpostId:));
++ (void)measureInterval:(OSTraceInterval)interval name:(NSString * _Nonnull)name block:(void (NS_NOESCAPE ^ _Nonnull)(void))block NS_SWIFT_NAME(measure(_:name:block:));
++ (void)event:(NSString * _Nonnull)name;
+
+@end
+
+#endif /* OSTrace_h */
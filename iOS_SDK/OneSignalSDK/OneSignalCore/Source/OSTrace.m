@@ -0,0 +1,115 @@
+/**
+ * Modified MIT License
+ *
+ * Copyright 2024 OneSignal
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * 2. All copies of substantial portions of the Software may only be used in connection
+ * with services provided by OneSignal.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#import <Foundation/Foundation.h>
+#import <os/signpost.h>
+#import "OSTrace.h"
+
+#define OS_TRACE_SUBSYSTEM "com.onesignal.sdk"
+#define OS_TRACE_CATEGORY "Performance"
+
+@implementation OSTrace
+
++ (os_log_t)log API_AVAILABLE(ios(12.0)) {
+    static os_log_t log;
+    static dispatch_once_t once;
+    dispatch_once(&once, ^{
+        log = os_log_create(OS_TRACE_SUBSYSTEM, OS_TRACE_CATEGORY);
+    });
+    return log;
+}
+
+/*
+ os_signpost requires the signpost name to be a string literal, so each interval kind has its own call.
+ Signposts are near free when Instruments is not recording, os_signpost_enabled skips building the message entirely.
+ */
++ (uint64_t)beginInterval:(OSTraceInterval)interval name:(NSString *)name {
+    if (@available(iOS 12.0, *)) {
+        os_log_t log = [self log];
+        if (!os_signpost_enabled(log)) {
+            return 0;
+        }
+        os_signpost_id_t signpostId = os_signpost_id_generate(log);
+        const char *message = name.UTF8String;
+        switch (interval) {
+            case OSTraceIntervalInitStage:
+                os_signpost_interval_begin(log, signpostId, "InitStage", "%{public}s", message);
+                break;
+            case OSTraceIntervalCacheLoad:
+                os_signpost_interval_begin(log, signpostId, "CacheLoad", "%{public}s", message);
+                break;
+            case OSTraceIntervalRequest:
+                os_signpost_interval_begin(log, signpostId, "Request", "%{public}s", message);
+                break;
+            case OSTraceIntervalIAMEvaluation:
+                os_signpost_interval_begin(log, signpostId, "IAMEvaluation", "%{public}s", message);
+                break;
+        }
+        return signpostId;
+    }
+    return 0;
+}
+
++ (void)endInterval:(OSTraceInterval)interval signpostId:(uint64_t)signpostId {
+    if (signpostId == 0) {
+        return;
+    }
+    if (@available(iOS 12.0, *)) {
+        os_log_t log = [self log];
+        switch (interval) {
+            case OSTraceIntervalInitStage:
+                os_signpost_interval_end(log, signpostId, "InitStage");
+                break;
+            case OSTraceIntervalCacheLoad:
+                os_signpost_interval_end(log, signpostId, "CacheLoad");
+                break;
+            case OSTraceIntervalRequest:
+                os_signpost_interval_end(log, signpostId, "Request");
+                break;
+            case OSTraceIntervalIAMEvaluation:
+                os_signpost_interval_end(log, signpostId, "IAMEvaluation");
+                break;
+        }
+    }
+}
+
++ (void)measureInterval:(OSTraceInterval)interval name:(NSString *)name block:(void (NS_NOESCAPE ^)(void))block {
+    uint64_t signpostId = [self beginInterval:interval name:name];
+    block();
+    [self endInterval:interval signpostId:signpostId];
+}
+
++ (void)event:(NSString *)name {
+    if (@available(iOS 12.0, *)) {
+        os_log_t log = [self log];
+        if (os_signpost_enabled(log)) {
+            os_signpost_event_emit(log, OS_SIGNPOST_ID_EXCLUSIVE, "Event", "%{public}s", name.UTF8String);
+        }
+    }
+}
+
+@end
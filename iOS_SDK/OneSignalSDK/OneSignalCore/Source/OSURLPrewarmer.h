@@ -0,0 +1,52 @@
+/**
+ * Modified MIT License
+ *
+ * Copyright 2024 OneSignal
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * 2. All copies of substantial portions of the Software may only be used in connection
+ * with services provided by OneSignal.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#import <Foundation/Foundation.h>
+
+#ifndef OSURLPrewarmer_h
+#define OSURLPrewarmer_h
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ Resolves the host of a URL the user is likely to open next, such as a notification's launch URL, so opening it
+ does not wait on DNS. The system resolver's cache is shared with Safari and WebKit, so this helps whether the
+ URL opens in Safari or in an in-app web view.
+ */
+@interface OSURLPrewarmer : NSObject
+
+// Does nothing for URLs that are not http(s) or whose host was prewarmed in the last OS_URL_PREWARM_HOST_TTL seconds
++ (void)prewarmURLString:(NSString * _Nullable)urlString;
+
++ (void)clearStatics; // Used by Unit Tests
+
+@end
+
+NS_ASSUME_NONNULL_END
+
+#endif /* OSURLPrewarmer_h */
@@ -0,0 +1,87 @@
+/**
+ * Modified MIT License
+ *
+ * Copyright 2024 OneSignal
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * 2. All copies of substantial portions of the Software may only be used in connection
+ * with services provided by OneSignal.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#import <netdb.h>
+#import "OSURLPrewarmer.h"
+#import "OneSignalCommonDefines.h"
+#import "OneSignalLog.h"
+#import "OSMacros.h"
+#import "OSDispatchQueues.h"
+
+@implementation OSURLPrewarmer
+
+// Host to the time it was last prewarmed. Synchronized on the class.
+static NSMutableDictionary<NSString *, NSDate *> *_prewarmedHosts;
+
++ (void)clearStatics {
+    @synchronized (self) {
+        _prewarmedHosts = nil;
+    }
+}
+
+// The host to resolve for the URL, or nil if it is not http(s) or was prewarmed recently
++ (NSString *)claimHostOfURLString:(NSString *)urlString {
+    if (urlString.length == 0)
+        return nil;
+    let url = [NSURL URLWithString:[urlString stringByTrimmingCharactersInSet:NSCharacterSet.whitespaceAndNewlineCharacterSet]];
+    let scheme = url.scheme.lowercaseString;
+    NSString *host = url.host.lowercaseString;
+    if (!host.length || !([scheme isEqualToString:@"http"] || [scheme isEqualToString:@"https"]))
+        return nil;
+
+    @synchronized (self) {
+        if (!_prewarmedHosts)
+            _prewarmedHosts = [NSMutableDictionary new];
+        NSDate *lastPrewarmed = _prewarmedHosts[host];
+        if (lastPrewarmed && -[lastPrewarmed timeIntervalSinceNow] < OS_URL_PREWARM_HOST_TTL)
+            return nil;
+        if (_prewarmedHosts.count >= OS_URL_PREWARM_HOSTS_LIMIT)
+            [_prewarmedHosts removeAllObjects];
+        _prewarmedHosts[host] = [NSDate date];
+    }
+    return host;
+}
+
++ (void)prewarmURLString:(NSString *)urlString {
+    NSString *host = [self claimHostOfURLString:urlString];
+    if (!host)
+        return;
+
+    dispatch_async(OSDispatchQueues.utility, ^{
+        struct addrinfo hints = {0};
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+        struct addrinfo *result = NULL;
+        int error = getaddrinfo(host.UTF8String, NULL, &hints, &result);
+        if (result)
+            freeaddrinfo(result);
+        ONE_S_LOG(ONE_S_LL_VERBOSE, @"OSURLPrewarmer resolved %@ with result: %d", host, error);
+    });
+}
+
+@end
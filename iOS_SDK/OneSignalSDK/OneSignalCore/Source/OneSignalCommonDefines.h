@@ -73,10 +73,15 @@
 
 // Notification
 #define OSUD_LAST_MESSAGE_OPENED                                            @"GT_LAST_MESSAGE_OPENED_"                                          // * OSUD_MOST_RECENT_NOTIFICATION_OPENED
+#define OSUD_PENDING_NOTIFICATION_OPENS                                     @"OSUD_PENDING_NOTIFICATION_OPENS"                                  // Opened notification ids not yet submitted
 #define OSUD_TEMP_CACHED_NOTIFICATION_MEDIA                                 @"OSUD_TEMP_CACHED_NOTIFICATION_MEDIA"                              // OSUD_TEMP_CACHED_NOTIFICATION_MEDIA
+#define OSUD_NSE_LAST_STAGE_TIMINGS                                         @"OSUD_NSE_LAST_STAGE_TIMINGS"                                      // Shared, stage timings of the last NSE run
+#define OSUD_MAINTENANCE_LAST_RUN                                           @"OSUD_MAINTENANCE_LAST_RUN"                                        // When OSMaintenanceScheduler last ran every job
 // Remote Params
 #define OSUD_LOCATION_ENABLED                                               @"OSUD_LOCATION_ENABLED"
 #define OSUD_REQUIRES_USER_PRIVACY_CONSENT                                  @"OSUD_REQUIRES_USER_PRIVACY_CONSENT"
+#define OSUD_CACHED_IOS_PARAMS                                              @"OSUD_CACHED_IOS_PARAMS"                                           // Last ios_params with its app id and ETag
+#define OSUD_SDK_TUNING                                                     @"OSUD_SDK_TUNING"                                                  // Last sdk_tuning from the ios_params, so the next launch starts with it
 // Remote Params - Receive Receipts
 #define OSUD_RECEIVE_RECEIPTS_ENABLED                                       @"OS_ENABLE_RECEIVE_RECEIPTS"                                       // * OSUD_RECEIVE_RECEIPTS_ENABLED
 // Outcomes
@@ -94,14 +99,23 @@
 #define OSUD_CACHED_INDIRECT_NOTIFICATION_IDS                               @"CACHED_INDIRECT_NOTIFICATION_IDS"                                 // * OSUD_CACHED_INDIRECT_NOTIFICATION_IDS
 #define OSUD_CACHED_RECEIVED_NOTIFICATION_IDS                               @"CACHED_RECEIVED_NOTIFICATION_IDS"                                 // * OSUD_CACHED_RECEIVED_NOTIFICATION_IDS
 #define OSUD_CACHED_RECEIVED_IAM_IDS                                        @"OSUD_CACHED_RECEIVED_IAM_IDS"
+#define OSUD_CACHED_RECEIVED_NOTIFICATION_BUFFER                            @"OSUD_CACHED_RECEIVED_NOTIFICATION_BUFFER"
+#define OSUD_CACHED_RECEIVED_IAM_BUFFER                                     @"OSUD_CACHED_RECEIVED_IAM_BUFFER"
 #define OSUD_CACHED_UNATTRIBUTED_UNIQUE_OUTCOME_EVENTS_SENT                 @"CACHED_UNATTRIBUTED_UNIQUE_OUTCOME_EVENTS_SENT"                   // * OSUD_CACHED_UNATTRIBUTED_UNIQUE_OUTCOME_EVENTS_SENT
 #define OSUD_CACHED_ATTRIBUTED_UNIQUE_OUTCOME_EVENT_NOTIFICATION_IDS_SENT   @"CACHED_ATTRIBUTED_UNIQUE_OUTCOME_EVENT_NOTIFICATION_IDS_SENT"     // * OSUD_CACHED_ATTRIBUTED_UNIQUE_OUTCOME_EVENT_NOTIFICATION_IDS_SENT
+#define OSUD_PENDING_OUTCOME_EVENTS                                         @"OSUD_PENDING_OUTCOME_EVENTS"
+#define OSUD_FAILED_OUTCOME_EVENTS                                          @"OSUD_FAILED_OUTCOME_EVENTS"
+#define OSUD_PENDING_RECEIVED_NOTIFICATIONS                                 @"OSUD_PENDING_RECEIVED_NOTIFICATIONS"                              // Shared, where earlier versions and NSEs without an app group container keep OSPendingReceivedNotifications
+#define OSUD_PROCESSED_NOTIFICATION_IDS                                     @"OSUD_PROCESSED_NOTIFICATION_IDS"                                  // Shared, notification ids already processed, by kind
 // Migration
 #define OSUD_CACHED_SDK_VERSION                                             @"OSUD_CACHED_SDK_VERSION"
+#define OSUD_STORAGE_SCHEMA_VERSION                                         @"OSUD_STORAGE_SCHEMA_VERSION"                                      // Shared, schema version of the cached data
 // Time Tracking
 #define OSUD_APP_LAST_CLOSED_TIME                                           @"GT_LAST_CLOSED_TIME"                                              // * OSUD_APP_LAST_CLOSED_TIME
 #define OSUD_UNSENT_ACTIVE_TIME                                             @"GT_UNSENT_ACTIVE_TIME"                                            // * OSUD_UNSENT_ACTIVE_TIME
 #define OSUD_UNSENT_ACTIVE_TIME_ATTRIBUTED                                  @"GT_UNSENT_ACTIVE_TIME_ATTRIBUTED"                                 // * OSUD_UNSENT_ACTIVE_TIME_ATTRIBUTED
+#define OSUD_PENDING_SESSION_TIME                                           @"OSUD_PENDING_SESSION_TIME"                                        // * OSUD_PENDING_SESSION_TIME
+#define OSUD_SQLITE_STORAGE_ENABLED                                         @"OSUD_SQLITE_STORAGE_ENABLED"                                      // * OSUD_SQLITE_STORAGE_ENABLED
 
 // Deprecated Selectors
 #define DEPRECATED_SELECTORS @[ @"application:didReceiveLocalNotification:", \
@@ -133,6 +147,20 @@
 #define IOS_OUTCOMES_V2_SERVICE_ENABLE @"v2_enabled"
 #define IOS_LOCATION_SHARED @"location_shared"
 #define IOS_REQUIRES_USER_PRIVACY_CONSENT @"requires_user_privacy_consent"
+#define IOS_GZIP_REQUEST_BODIES_ENABLE @"gzip_request_bodies_enable"
+#define IOS_SDK_TUNING @"sdk_tuning"
+
+// SDK tuning keys, read from the sdk_tuning dictionary of the iOS params and of the OneSignal_sdk_tuning Info.plist entry
+#define OS_TUNING_OP_REPO_FLUSH_DELAY_MS @"op_repo_flush_delay_ms"
+#define OS_TUNING_OP_REPO_FLUSH_THRESHOLD @"op_repo_flush_threshold"
+#define OS_TUNING_OUTCOME_BATCH_SIZE @"outcome_batch_size"
+#define OS_TUNING_REQUEST_MAX_ATTEMPTS @"request_max_attempts"
+#define OS_TUNING_REQUEST_RETRY_DELAY @"request_retry_delay"
+#define OS_TUNING_REQUEST_MAX_RETRY_DELAY @"request_max_retry_delay"
+#define OS_TUNING_REQUEST_TIMEOUT @"request_timeout"
+#define OS_TUNING_RESOURCE_TIMEOUT @"resource_timeout"
+#define OS_TUNING_HTTP_MAX_CONNECTIONS_PER_HOST @"http_max_connections_per_host"
+#define OS_TUNING_EXECUTOR_MAX_IN_FLIGHT_REQUESTS @"executor_max_in_flight_requests"
 
 // SMS Parameter Names
 #define SMS_NUMBER_KEY @"sms_number"
@@ -143,6 +171,7 @@
 #define ONESIGNAL_SUPRESS_LAUNCH_URLS @"OneSignal_suppress_launch_urls"
 #define ONESIGNAL_IN_APP_HIDE_DROP_SHADOW @"OneSignal_in_app_message_hide_drop_shadow"
 #define ONESIGNAL_IN_APP_HIDE_GRAY_OVERLAY @"OneSignal_in_app_message_hide_gray_overlay"
+#define ONESIGNAL_SDK_TUNING @"OneSignal_sdk_tuning"
 
 // GDPR Privacy Consent
 #define GDPR_CONSENT_GRANTED @"GDPR_CONSENT_GRANTED"
@@ -151,17 +180,36 @@
 // Badge handling
 #define ONESIGNAL_DISABLE_BADGE_CLEARING @"OneSignal_disable_badge_clearing"
 #define ONESIGNAL_APP_GROUP_NAME_KEY @"OneSignal_app_groups_key"
+// Optional Info.plist key, set to YES to store SDK state in SQLite databases instead of NSUserDefaults plists
+#define ONESIGNAL_SQLITE_STORAGE_KEY @"OneSignal_sqlite_storage"
+// Info.plist key, set to YES when the app forwards its UIApplicationDelegate and UNUserNotificationCenterDelegate calls itself
+#define ONESIGNAL_DISABLE_SWIZZLING_KEY @"OneSignal_disable_swizzling"
+// Info.plist key, set to YES to install swizzling from the first OneSignal init instead of +load
+#define ONESIGNAL_DEFER_SWIZZLING_KEY @"OneSignal_defer_swizzling"
+// Optional Info.plist key, JPEG and PNG attachments larger than this many pixels on their long edge are downsampled in the NSE
+#define ONESIGNAL_NOTIFICATION_MEDIA_MAX_PIXEL_SIZE_KEY @"OneSignal_notification_media_max_pixel_size"
 #define ONESIGNAL_BADGE_KEY @"onesignalBadgeCount"
+// File in the app group container holding the badge count, shared by the app and its extensions under a file lock
+#define ONESIGNAL_BADGE_COUNTER_FILE @"Library/OneSignalBadgeCount"
+// Directory in the app group container with a file per notification the NSE received, see OSPendingReceivedNotifications
+#define ONESIGNAL_PENDING_RECEIVED_NOTIFICATIONS_DIRECTORY @"Library/OneSignalPendingReceived"
+// Directory in the app group container with a marker file per processed notification id, see OSProcessedNotifications
+#define ONESIGNAL_PROCESSED_NOTIFICATIONS_DIRECTORY @"Library/OneSignalProcessed"
 
 // Firebase
 #define ONESIGNAL_FB_ENABLE_FIREBASE @"OS_ENABLE_FIREBASE_ANALYTICS"
 #define ONESIGNAL_FB_LAST_TIME_RECEIVED @"OS_LAST_RECIEVED_TIME"
 #define ONESIGNAL_FB_LAST_GAF_CAMPAIGN_RECEIVED @"OS_LAST_RECIEVED_GAF_CAMPAIGN"
 #define ONESIGNAL_FB_LAST_NOTIFICATION_ID_RECEIVED @"OS_LAST_RECIEVED_NOTIFICATION_ID"
+// The notification id, campaign and time of the last received notification, saved together in one write
+#define ONESIGNAL_FB_LAST_RECEIVED @"OS_LAST_RECIEVED_NOTIFICATION"
 
 // APNS params
 #define ONESIGNAL_IAM_PREVIEW @"os_in_app_message_preview_id"
 #define ONESIGNAL_POST_PREVIEW_IAM @"ONESIGNAL_POST_PREVIEW_IAM"
+// Sent in the additional data of a silent push to have the SDK fetch the latest in-app messages
+#define ONESIGNAL_IAM_REFRESH @"os_in_app_message_refresh"
+#define ONESIGNAL_POST_REFRESH_IAM @"ONESIGNAL_POST_REFRESH_IAM"
 
 #define ONESIGNAL_SUPPORTED_ATTACHMENT_TYPES @[@"aiff", @"wav", @"mp3", @"mp4", @"jpg", @"jpeg", @"png", @"gif", @"mpeg", @"mpg", @"avi", @"m4a", @"m4v"]
 
@@ -196,6 +244,8 @@ typedef enum {ATTRIBUTED, NOT_ATTRIBUTED} FocusAttributionState;
 #define IDENTITY_EXECUTOR_BACKGROUND_TASK       @"IDENTITY_EXECUTOR_BACKGROUND_TASK_"
 #define PROPERTIES_EXECUTOR_BACKGROUND_TASK     @"PROPERTIES_EXECUTOR_BACKGROUND_TASK_"
 #define SUBSCRIPTION_EXECUTOR_BACKGROUND_TASK   @"SUBSCRIPTION_EXECUTOR_BACKGROUND_TASK_"
+// Requests are not started in the background with less time than this left
+#define OS_BACKGROUND_TASK_MIN_TIME_REMAINING_SECONDS 5
 
 // OneSignal constants
 #define OS_PUSH @"push"
@@ -233,6 +283,8 @@ typedef enum {GET, POST, HEAD, PUT, DELETE, OPTIONS, CONNECT, TRACE, PATCH} HTTP
 // The SDK saves a list of category ID's allowing multiple notifications
 // to have their own unique buttons/etc.
 #define SHARED_CATEGORY_LIST @"com.onesignal.shared_registered_categories"
+// Maps a hash of a notification's action buttons to the category ID already registered for them
+#define SHARED_CATEGORY_LAYOUTS @"com.onesignal.shared_category_layouts"
 
 // Device types
 #define DEVICE_TYPE_PUSH 0
@@ -240,6 +292,9 @@ typedef enum {GET, POST, HEAD, PUT, DELETE, OPTIONS, CONNECT, TRACE, PATCH} HTTP
 #define DEVICE_TYPE_SMS 14
 
 #define MAX_NSE_LIFETIME_SECOUNDS 30
+// Part of the NSE lifetime kept back for handing the content to iOS, optional stages only run within the rest
+#define NSE_BUDGET_RESERVE_SECONDS 3
+#define NSE_MIN_ATTACHMENT_DOWNLOAD_SECONDS 1
 
 #ifndef OS_TEST
     // OneSignal API Client Defines
@@ -247,6 +302,10 @@ typedef enum {GET, POST, HEAD, PUT, DELETE, OPTIONS, CONNECT, TRACE, PATCH} HTTP
     #define REQUEST_TIMEOUT_REQUEST 120.0 //for most HTTP requests
     #define REQUEST_TIMEOUT_RESOURCE 120.0 //for loading a resource like an image
     #define MAX_ATTEMPT_COUNT 5
+    // The longest backoff window for a reattempt, before jitter, in seconds
+    #define REATTEMPT_MAX_DELAY 300.0
+    // Parked reattempts are spread over this many seconds when connectivity returns
+    #define REATTEMPT_RESUME_SPREAD 5.0
 
     // the max number of UNNotificationCategory ID's the SDK will register
     #define MAX_CATEGORIES_SIZE 128
@@ -260,18 +319,51 @@ typedef enum {GET, POST, HEAD, PUT, DELETE, OPTIONS, CONNECT, TRACE, PATCH} HTTP
     // Flush interval for operation repo in milliseconds
     #define POLL_INTERVAL_MS 5000
 
+    // How long OneSignalUserDefaults coalesces writes before flushing them to disk, in milliseconds
+    #define OS_USER_DEFAULTS_FLUSH_DELAY_MS 1000
+
+    // Outcome events are buffered and sent together once this many are waiting, or after this many seconds
+    #define OS_OUTCOME_BUFFER_FLUSH_SIZE 20
+    #define OS_OUTCOME_BUFFER_FLUSH_INTERVAL 10.0
+
+    // Foregrounds within this many seconds of the last notification settings query reuse its result
+    #define OS_PERMISSION_REFRESH_MIN_INTERVAL 1.0
+
+    // Notification opens are submitted together once no other open arrived for this many seconds
+    #define OS_NOTIFICATION_OPENS_FLUSH_DELAY 1.0
+
     /**
      The number of seconds to delay after an operation completes that creates or changes IDs.
      This is a "cold down" period to avoid a caveat with OneSignal's backend replication, where you may
      incorrectlyget a 404 when attempting a GET or PATCH REST API call on something just after it is created.
      */
     #define OP_REPO_POST_CREATE_DELAY_SECONDS 3
+
+    // Devices migrating a legacy player start its request at a random point within this many seconds, spreading an upgrade wave
+    #define OS_LEGACY_MIGRATION_MAX_JITTER_SECONDS 30.0
+
+    // A user's requests held for a new JWT are sent again after this many seconds if the app never provides one
+    #define OS_JWT_REFRESH_TIMEOUT_SECONDS 60
+
+    // How long live activity token requests are held so a burst of changes is sent once per activity
+    #define OS_LIVE_ACTIVITIES_BATCH_WINDOW 2.0
+
+    // Session time is sent as one delta once focus has not changed for this many seconds
+    #define OS_SESSION_TIME_FLUSH_DELAY 5.0
+
+    // Housekeeping jobs run at most once per this many seconds, see OSMaintenanceScheduler
+    #define OS_MAINTENANCE_INTERVAL (24 * 60 * 60)
+
+    // A maintenance job that has not called its completion after this many seconds no longer holds up the next one
+    #define OS_MAINTENANCE_JOB_TIMEOUT 60.0
 #else
     // Test defines for API Client
     #define REATTEMPT_DELAY 0.004
     #define REQUEST_TIMEOUT_REQUEST 0.02 //for most HTTP requests
     #define REQUEST_TIMEOUT_RESOURCE 0.02 //for loading a resource like an image
     #define MAX_ATTEMPT_COUNT 3
+    #define REATTEMPT_MAX_DELAY 0.05
+    #define REATTEMPT_RESUME_SPREAD 0.004
 
     // the max number of UNNotificationCategory ID's the SDK will register
     #define MAX_CATEGORIES_SIZE 5
@@ -286,10 +378,119 @@ typedef enum {GET, POST, HEAD, PUT, DELETE, OPTIONS, CONNECT, TRACE, PATCH} HTTP
     // Reduce flush interval for operation repo in tests
     #define POLL_INTERVAL_MS 100
 
+    // Reduce the write-behind window of OneSignalUserDefaults in tests
+    #define OS_USER_DEFAULTS_FLUSH_DELAY_MS 10
+
+    // Send buffered outcome events sooner in tests
+    #define OS_OUTCOME_BUFFER_FLUSH_SIZE 5
+    #define OS_OUTCOME_BUFFER_FLUSH_INTERVAL 0.05
+
+    // Query notification settings on every foreground in tests
+    #define OS_PERMISSION_REFRESH_MIN_INTERVAL 0
+
+    // Submit notification opens right away in tests
+    #define OS_NOTIFICATION_OPENS_FLUSH_DELAY 0
+
     // Reduce delay in tests
     #define OP_REPO_POST_CREATE_DELAY_SECONDS 0
+
+    // Migrate legacy players right away in tests
+    #define OS_LEGACY_MIGRATION_MAX_JITTER_SECONDS 0.0
+
+    // Give up waiting for a new JWT quickly in tests
+    #define OS_JWT_REFRESH_TIMEOUT_SECONDS 1
+
+    // Send live activity requests right away in tests
+    #define OS_LIVE_ACTIVITIES_BATCH_WINDOW 0.0
+
+    // Send session time right away in tests
+    #define OS_SESSION_TIME_FLUSH_DELAY 0
+
+    // Maintenance is always due in tests
+    #define OS_MAINTENANCE_INTERVAL 0
+
+    // Move past a stuck maintenance job quickly in tests
+    #define OS_MAINTENANCE_JOB_TIMEOUT 0.5
 #endif
 
+// The most requests each operation executor has in flight at once, the rest wait for one to complete
+#define OS_EXECUTOR_MAX_IN_FLIGHT_REQUESTS 4
+// Tags past this many encoded bytes are sent in follow-up update properties requests, so a large sync makes partial progress
+#define OS_UPDATE_PROPERTIES_MAX_TAGS_BYTES (16 * 1024)
+
+// High-water marks for queues that grow while offline, the oldest items are dropped past them
+#define OS_OPERATION_REPO_DELTA_QUEUE_LIMIT 1000
+#define OS_EXECUTOR_REQUEST_QUEUE_LIMIT 500
+#define OS_LIVE_ACTIVITIES_REQUEST_CACHE_LIMIT 100
+
+// Backoff for live activity requests that still fail after the client's reattempts, doubling up to the max
+#define OS_LIVE_ACTIVITIES_RETRY_BASE_DELAY 30.0
+#define OS_LIVE_ACTIVITIES_RETRY_MAX_DELAY 3600.0
+
+// The BGProcessingTask identifier apps list under BGTaskSchedulerPermittedIdentifiers to run SDK housekeeping while idle and charging
+#define OS_MAINTENANCE_TASK_IDENTIFIER @"com.onesignal.maintenance"
+
+// While OSPowerPolicy is constrained, flush debounce and batch windows are this many times longer, location has to move
+// this many times further, and telemetry sent right away is instead held at least OS_POWER_POLICY_MIN_TELEMETRY_DEFERRAL seconds
+#define OS_POWER_POLICY_DELAY_MULTIPLIER 4
+#define OS_POWER_POLICY_DISTANCE_MULTIPLIER 5
+#define OS_POWER_POLICY_MIN_TELEMETRY_DEFERRAL 60
+
+// SDK blocks running on the main thread longer than this many milliseconds are reported by OSMainThreadWatchdog
+#define OS_MAIN_THREAD_WATCHDOG_THRESHOLD_MS 16
+// The most distinct call sites OSMainThreadWatchdog keeps, later ones are only counted in the totals
+#define OS_MAIN_THREAD_WATCHDOG_SITE_LIMIT 100
+
+// Log events waiting to be delivered to log listeners, the oldest are dropped past this
+#define OS_LOG_LISTENER_BUFFER_LIMIT 1000
+
+// Entries kept by OSFlightRecorder, 32 bytes each
+#define OS_FLIGHT_RECORDER_CAPACITY 1024
+
+// A location fix only becomes a properties delta once the device has moved this far from the last one sent
+// and this many seconds have passed since it, so jitter and bursts of fixes don't each produce an update
+#define OS_LOCATION_MIN_DISTANCE_METERS 100.0
+#define OS_LOCATION_MIN_SEND_INTERVAL 60.0
+
+// The most requests OneSignalClient holds back while the network is unreachable
+#define OS_OFFLINE_REQUEST_QUEUE_LIMIT 50
+
+// JSON bodies at least this many bytes are sent gzip compressed, once remote params allow it
+#define OS_GZIP_REQUEST_BODY_MIN_BYTES 1024
+
+// Responses larger than this many bytes are decoded on a background queue rather than the session's delegate queue
+#define OS_LARGE_RESPONSE_BYTES 64 * 1024
+
+// Deferrable requests are sent as background uploads, which the system may keep retrying for up to an hour
+#define OS_BACKGROUND_UPLOAD_SESSION_ID @"com.onesignal.background-upload"
+#define OS_BACKGROUND_UPLOAD_DIRECTORY @"OneSignalUploads"
+#define OS_BACKGROUND_UPLOAD_TIMEOUT 60 * 60
+// Deferral key of the delayed session end outcome, cancelled if the app returns to the foreground before it begins
+#define OS_SESSION_END_DEFERRAL_KEY @"session_end"
+
+// Outcome events that failed to send are kept for a later retry, up to this many and for up to this many seconds
+#define OS_FAILED_OUTCOME_EVENTS_LIMIT 100
+#define OS_FAILED_OUTCOME_EVENTS_TTL WEEK_IN_SECONDS
+
+// Attributed unique outcomes are deduped for this many seconds, keeping at most this many, and expired entries are pruned at most once per interval
+#define OS_UNIQUE_OUTCOMES_WINDOW WEEK_IN_SECONDS
+#define OS_UNIQUE_OUTCOMES_LIMIT 1000
+#define OS_UNIQUE_OUTCOMES_PRUNE_INTERVAL (24 * 60 * 60)
+
+// Hosts of URLs likely to be opened next are resolved ahead at most once per this many seconds, remembering up to this many hosts
+#define OS_URL_PREWARM_HOST_TTL 60
+#define OS_URL_PREWARM_HOSTS_LIMIT 32
+
+// Notifications the NSE received while the app was not running, kept until the session manager picks them up
+#define OS_PENDING_RECEIVED_NOTIFICATIONS_LIMIT 50
+
+// Processed notification ids are remembered per kind for this many seconds, keeping at most this many of each
+#define OS_PROCESSED_NOTIFICATION_IDS_WINDOW (3 * 24 * 60 * 60)
+#define OS_PROCESSED_NOTIFICATION_IDS_LIMIT 100
+
+// Connections OneSignalClient may open to the API host if HTTP/2 is unavailable and requests fall back to HTTP/1.1
+#define OS_HTTP_MAX_CONNECTIONS_PER_HOST 4
+
 // A max timeout for a request, which might include multiple reattempts
 #define MAX_TIMEOUT ((REQUEST_TIMEOUT_REQUEST * MAX_ATTEMPT_COUNT) + (REATTEMPT_DELAY * MAX_ATTEMPT_COUNT)) * NSEC_PER_SEC
 
@@ -299,6 +500,14 @@ typedef enum {GET, POST, HEAD, PUT, DELETE, OPTIONS, CONNECT, TRACE, PATCH} HTTP
 #define OS_ROUGHLY_EQUAL(left, right) (fabs(left - right) < 0.03)
 
 #define MAX_NOTIFICATION_MEDIA_SIZE_BYTES 50000000
+// Shared deadline for all attachment downloads, leaves part of MAX_NSE_LIFETIME_SECOUNDS for the rest of the NSE work
+#define MAX_NOTIFICATION_MEDIA_DOWNLOAD_SECONDS 25
+// Downloaded attachments are kept by URL in the app group so repeated creative is reused, oldest used evicted first
+#define NOTIFICATION_MEDIA_CACHE_DIRECTORY @"OneSignalNotificationMedia"
+#define MAX_NOTIFICATION_MEDIA_CACHE_SIZE_BYTES 100000000
+// Cached media not used for this long is removed by maintenance, creative is rarely reused after a campaign ends.
+// Media downloaded longer ago than this is downloaded again, even if it is still used.
+#define MAX_NOTIFICATION_MEDIA_CACHE_AGE_SECONDS (7 * 24 * 60 * 60)
 
 #pragma mark User Model
 
@@ -306,6 +515,8 @@ typedef enum {GET, POST, HEAD, PUT, DELETE, OPTIONS, CONNECT, TRACE, PATCH} HTTP
 #define OS_EXTERNAL_ID                                                      @"external_id"
 
 #define OS_ON_USER_WILL_CHANGE                                              @"OS_ON_USER_WILL_CHANGE"
+// Posted when a user fetch hydrates tags that differ from the locally cached tags
+#define OS_ON_USER_TAGS_DID_CHANGE                                          @"OS_ON_USER_TAGS_DID_CHANGE"
 
 // OSID and EID snapshots during hydration
 #define OS_SNAPSHOT_ONESIGNAL_ID                                            @"OS_SNAPSHOT_ONESIGNAL_ID"
@@ -319,6 +530,8 @@ typedef enum {GET, POST, HEAD, PUT, DELETE, OPTIONS, CONNECT, TRACE, PATCH} HTTP
 #define OS_PUSH_SUBSCRIPTION_MODEL_KEY                                      @"OS_PUSH_SUBSCRIPTION_MODEL_KEY"
 #define OS_PUSH_SUBSCRIPTION_MODEL_STORE_KEY                                @"OS_PUSH_SUBSCRIPTION_MODEL_STORE_KEY"
 #define OS_SUBSCRIPTION_MODEL_STORE_KEY                                     @"OS_SUBSCRIPTION_MODEL_STORE_KEY"
+// The property of a change grouped by OSModel.batchUpdate, its value is a dictionary of the changed properties
+#define OS_MODEL_BATCH_UPDATE_PROPERTY                                      @"OS_MODEL_BATCH_UPDATE"
 
 // Deltas
 #define OS_ADD_ALIAS_DELTA                                                  @"OS_ADD_ALIAS_DELTA"
@@ -332,9 +545,21 @@ typedef enum {GET, POST, HEAD, PUT, DELETE, OPTIONS, CONNECT, TRACE, PATCH} HTTP
 
 // Operation Repo
 #define OS_OPERATION_REPO_DELTA_QUEUE_KEY                                   @"OS_OPERATION_REPO_DELTA_QUEUE_KEY"
+#define OS_OPERATION_REPO_DELTA_LOG_FILE_NAME                               @"OSOperationRepoDeltaLog.bin"
+#define OS_OPERATION_REPO_DID_BECOME_IDLE                                   @"OS_OPERATION_REPO_DID_BECOME_IDLE"
+#define OS_OPERATION_REPO_DID_BECOME_BUSY                                   @"OS_OPERATION_REPO_DID_BECOME_BUSY"
+
+// Posted by OneSignalReachability when reachability of the default route changes
+#define OS_REACHABILITY_CHANGED_NOTIFICATION                                @"OS_REACHABILITY_CHANGED_NOTIFICATION"
+// Posted by OSPowerPolicy when the device enters or leaves Low Power Mode or a serious thermal state
+#define OS_POWER_POLICY_CHANGED_NOTIFICATION                                @"OS_POWER_POLICY_CHANGED_NOTIFICATION"
+// The number of queued deltas that triggers a flush without waiting for the debounce window
+#define OP_REPO_FLUSH_DELTA_THRESHOLD                                       50
 
 // User Executor
 #define OS_USER_EXECUTOR_USER_REQUEST_QUEUE_KEY                             @"OS_USER_EXECUTOR_USER_REQUEST_QUEUE_KEY"
+#define OS_USER_EXECUTOR_APPENDED_REQUESTS_KEY                              @"OS_USER_EXECUTOR_APPENDED_REQUESTS_KEY"
+#define OS_USER_EXECUTOR_COMPLETED_REQUESTS_KEY                             @"OS_USER_EXECUTOR_COMPLETED_REQUESTS_KEY"
 #define OS_USER_EXECUTOR_TRANSFER_SUBSCRIPTION_REQUEST_QUEUE_KEY            @"OS_USER_EXECUTOR_TRANSFER_SUBSCRIPTION_REQUEST_QUEUE_KEY"
 
 // Identity Executor
@@ -351,9 +576,13 @@ typedef enum {GET, POST, HEAD, PUT, DELETE, OPTIONS, CONNECT, TRACE, PATCH} HTTP
 #define OS_SUBSCRIPTION_EXECUTOR_ADD_REQUEST_QUEUE_KEY                      @"OS_SUBSCRIPTION_EXECUTOR_ADD_REQUEST_QUEUE_KEY"
 #define OS_SUBSCRIPTION_EXECUTOR_REMOVE_REQUEST_QUEUE_KEY                   @"OS_SUBSCRIPTION_EXECUTOR_REMOVE_REQUEST_QUEUE_KEY"
 #define OS_SUBSCRIPTION_EXECUTOR_UPDATE_REQUEST_QUEUE_KEY                   @"OS_SUBSCRIPTION_EXECUTOR_UPDATE_REQUEST_QUEUE_KEY"
+// Fingerprints of the last subscription update payload the server acknowledged, by subscription ID
+#define OS_SUBSCRIPTION_EXECUTOR_ACKNOWLEDGED_UPDATES_KEY                   @"OS_SUBSCRIPTION_EXECUTOR_ACKNOWLEDGED_UPDATES_KEY"
 
 // Live Activies Executor
 #define OS_LIVE_ACTIVITIES_EXECUTOR_UPDATE_TOKENS_KEY                       @"OS_LIVE_ACTIVITIES_EXECUTOR_UPDATE_TOKENS_KEY"
 #define OS_LIVE_ACTIVITIES_EXECUTOR_START_TOKENS_KEY                        @"OS_LIVE_ACTIVITIES_EXECUTOR_START_TOKENS_KEY"
+#define OS_LIVE_ACTIVITIES_EXECUTOR_UPDATE_TOKEN_ENTRIES_KEY                @"OS_LIVE_ACTIVITIES_EXECUTOR_UPDATE_TOKEN_ENTRIES_KEY"
+#define OS_LIVE_ACTIVITIES_EXECUTOR_START_TOKEN_ENTRIES_KEY                 @"OS_LIVE_ACTIVITIES_EXECUTOR_START_TOKEN_ENTRIES_KEY"
 
 #endif /* OneSignalCommonDefines_h */
@@ -32,5 +32,7 @@
 + (void)setAppId:(NSString *)appId;
 + (NSString *_Nullable)getAppId;
 + (BOOL)shouldAwaitAppIdAndLogMissingPrivacyConsentForMethod:(NSString *)methodName;
+// Re-publishes whether the app ID is set and privacy consent is not missing, called when either changes
++ (void)updateReadiness;
 
 @end
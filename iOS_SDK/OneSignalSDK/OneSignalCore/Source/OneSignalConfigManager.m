@@ -25,6 +25,7 @@
  THE SOFTWARE.
  */
 
+#import <stdatomic.h>
 #import "OneSignalConfigManager.h"
 #import "OSPrivacyConsentController.h"
 #import "OneSignalLog.h"
@@ -32,14 +33,26 @@
 @implementation OneSignalConfigManager
 
 static NSString *_appId;
+// Set while the app ID is set and privacy consent is not missing, so the hot path gate is one atomic load
+static atomic_bool _isReady;
+
 + (void)setAppId:(NSString *)appId {
     _appId = appId;
+    [self updateReadiness];
+}
+
++ (void)updateReadiness {
+    BOOL isReady = _appId != nil && ![OSPrivacyConsentController requiresUserPrivacyConsent];
+    atomic_store_explicit(&_isReady, isReady, memory_order_relaxed);
 }
 + (NSString *_Nullable)getAppId {
     return _appId;
 }
 
 + (BOOL)shouldAwaitAppIdAndLogMissingPrivacyConsentForMethod:(NSString *)methodName {
+    if (atomic_load_explicit(&_isReady, memory_order_relaxed))
+        return false;
+
     BOOL shouldAwait = false;
     if (!_appId) {
         if (methodName) {
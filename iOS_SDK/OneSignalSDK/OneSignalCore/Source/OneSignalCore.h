@@ -47,11 +47,31 @@
 #import <OneSignalCore/OSDeviceUtils.h>
 #import <OneSignalCore/OSNetworkingUtils.h>
 #import <OneSignalCore/OSObservable.h>
+#import <OneSignalCore/OSListenerRegistry.h>
+#import <OneSignalCore/OSProcessedNotifications.h>
+#import <OneSignalCore/OSPendingReceivedNotifications.h>
+#import <OneSignalCore/OSTrace.h>
+#import <OneSignalCore/OSRequestMetrics.h>
+#import <OneSignalCore/OSDeltaLifecycleMetrics.h>
+#import <OneSignalCore/OSFlightRecorder.h>
+#import <OneSignalCore/OSPerformanceCounters.h>
+#import <OneSignalCore/OSDispatchQueues.h>
+#import <OneSignalCore/OSMainThreadWatchdog.h>
+#import <OneSignalCore/OSMaintenanceScheduler.h>
+#import <OneSignalCore/OSPowerPolicy.h>
+#import <OneSignalCore/OSModuleRegistry.h>
+#import <OneSignalCore/OSStorageEngine.h>
+#import <OneSignalCore/OSSQLiteStorageEngine.h>
+#import <OneSignalCore/OSSharedStateVersion.h>
+#import <OneSignalCore/OSSharedStateSnapshot.h>
+#import <OneSignalCore/OSMemoryPressureCoordinator.h>
+#import <OneSignalCore/OSURLPrewarmer.h>
 #import <OneSignalCore/OSDialogInstanceManager.h>
 #import <OneSignalCore/SwizzlingForwarder.h>
 #import <OneSignalCore/OneSignalSelectorHelpers.h>
 #import <OneSignalCore/OneSignalConfigManager.h>
 #import <OneSignalCore/OSRemoteParamController.h>
+#import <OneSignalCore/OSTuningConfig.h>
 #import <OneSignalCore/OneSignalMobileProvision.h>
 #import <OneSignalCore/OneSignalWrapper.h>
 #import <OneSignalCore/OSInAppMessages.h>
@@ -36,13 +36,50 @@ typedef NS_ENUM(NSUInteger, ONE_S_LOG_LEVEL) {
     ONE_S_LL_VERBOSE
 };
 
+@interface OneSignalLogEvent : NSObject
+@property (readonly) ONE_S_LOG_LEVEL level;
+@property (readonly, nonnull) NSString *entry;
+@end
+
+@protocol OSLogListener <NSObject>
+// Called on a background queue, in the order the SDK logged them
+- (void)onLogEvent:(OneSignalLogEvent * _Nonnull)event;
+@end
+
 @protocol OSDebug <NSObject>
 + (void)setLogLevel:(ONE_S_LOG_LEVEL)logLevel;
 + (void)setAlertLevel:(ONE_S_LOG_LEVEL)logLevel NS_REFINED_FOR_SWIFT;
+// Listeners receive the messages that pass the log level
++ (void)addLogListener:(NSObject<OSLogListener> * _Nonnull)listener;
++ (void)removeLogListener:(NSObject<OSLogListener> * _Nonnull)listener;
+/**
+ Counters and gauges from across the SDK in this process, see OSPerformanceCounters, the time changes take
+ to reach the server by stage under "delta_lifecycle", see OSDeltaLifecycleMetrics, what each storage key was written
+ under "user_defaults_keys", see OneSignalUserDefaults' writeStatistics, SDK blocks that held the main thread
+ under "main_thread", see OSMainThreadWatchdog, plus the stage timings of the last Notification Service Extension run
+ under "nse_last_run" when the app group is set up.
+ */
+@property (class, readonly, nonnull) NSDictionary<NSString *, id> *metrics;
 @end
 
 @interface OneSignalLog : NSObject<OSDebug>
 + (Class<OSDebug>)Debug;
 + (void)onesignalLog:(ONE_S_LOG_LEVEL)logLevel message:(NSString* _Nonnull)message;
+// Only builds the message if it will be logged, for messages that are expensive to format
++ (void)onesignalLog:(ONE_S_LOG_LEVEL)logLevel messageBlock:(NSString* _Nonnull (^ _Nonnull)(void))messageBlock;
++ (BOOL)isLogLevelEnabled:(ONE_S_LOG_LEVEL)logLevel;
 + (ONE_S_LOG_LEVEL)getLogLevel;
+// Drops events waiting for the log listeners, listeners are told how many were dropped
++ (void)purgePendingLogEvents;
 @end
+
+/*
+ Checks the level before the arguments are evaluated or the message is formatted, so
+ verbose messages on hot paths cost only a comparison when they are filtered out.
+ */
+#define ONE_S_LOG(logLevel, format, ...) \
+    do { \
+        if ([OneSignalLog isLogLevelEnabled:(logLevel)]) { \
+            [OneSignalLog onesignalLog:(logLevel) message:[NSString stringWithFormat:(format), ##__VA_ARGS__]]; \
+        } \
+    } while (0)
@@ -26,14 +26,78 @@
  */
 
 #import <Foundation/Foundation.h>
+#import <os/log.h>
 #import "OneSignalLog.h"
 #import "OSDialogInstanceManager.h"
+#import "OSListenerRegistry.h"
+#import "OneSignalCommonDefines.h"
+#import "OSPerformanceCounters.h"
+#import "OneSignalUserDefaults.h"
+#import "OSDeltaLifecycleMetrics.h"
+#import "OSDispatchQueues.h"
+#import "OSMainThreadWatchdog.h"
+
+@implementation OneSignalLogEvent
+
+- (instancetype)initWithLevel:(ONE_S_LOG_LEVEL)level entry:(NSString *)entry {
+    if (self = [super init]) {
+        _level = level;
+        _entry = entry;
+    }
+    return self;
+}
+
+@end
 
 @implementation OneSignalLog
 
 static ONE_S_LOG_LEVEL _nsLogLevel = ONE_S_LL_WARN;
 static ONE_S_LOG_LEVEL _alertLogLevel = ONE_S_LL_NONE;
 
+/*
+ Log listeners are called on their own serial queue, so a slow listener never holds up the thread that logged.
+ Events wait in a bounded buffer until the queue drains it; past OS_LOG_LISTENER_BUFFER_LIMIT the oldest are dropped.
+ Access to the buffer and `_listenerDrainScheduled` is synchronized on `_pendingLogEvents`.
+ */
+static OSListenerRegistry<NSObject<OSLogListener> *> *_logListeners;
+static NSMutableArray<OneSignalLogEvent *> *_pendingLogEvents;
+static NSUInteger _droppedLogEvents = 0;
+static BOOL _listenerDrainScheduled = false;
+static dispatch_queue_t _listenerQueue;
+
+static os_log_t OSLogHandle(void) {
+    static os_log_t handle;
+    static dispatch_once_t once;
+    dispatch_once(&once, ^{
+        handle = os_log_create("com.onesignal.sdk", "OneSignal");
+    });
+    return handle;
+}
+
+static os_log_type_t OSLogType(ONE_S_LOG_LEVEL logLevel) {
+    switch (logLevel) {
+        case ONE_S_LL_FATAL:
+            return OS_LOG_TYPE_FAULT;
+        case ONE_S_LL_ERROR:
+            return OS_LOG_TYPE_ERROR;
+        case ONE_S_LL_INFO:
+            return OS_LOG_TYPE_INFO;
+        case ONE_S_LL_DEBUG:
+        case ONE_S_LL_VERBOSE:
+            return OS_LOG_TYPE_DEBUG;
+        default:
+            return OS_LOG_TYPE_DEFAULT;
+    }
+}
+
++ (void)initialize {
+    if (self == [OneSignalLog class]) {
+        _logListeners = [OSListenerRegistry new];
+        _pendingLogEvents = [NSMutableArray new];
+        _listenerQueue = dispatch_queue_create_with_target("com.onesignal.log.listeners", DISPATCH_QUEUE_SERIAL, OSDispatchQueues.background);
+    }
+}
+
 + (Class<OSDebug>)Debug {
     return self;
 }
@@ -46,15 +110,96 @@ static ONE_S_LOG_LEVEL _alertLogLevel = ONE_S_LL_NONE;
     _alertLogLevel = logLevel;
 }
 
++ (void)addLogListener:(NSObject<OSLogListener> *)listener {
+    [_logListeners addListener:listener];
+}
+
++ (void)removeLogListener:(NSObject<OSLogListener> *)listener {
+    [_logListeners removeListener:listener];
+}
+
++ (NSDictionary<NSString *, id> *)metrics {
+    NSMutableDictionary<NSString *, id> *metrics = [[OSPerformanceCounters snapshot] mutableCopy];
+    metrics[@"delta_lifecycle"] = [[OSDeltaLifecycleMetrics sharedMetrics] snapshot];
+    metrics[@"user_defaults_keys"] = [OneSignalUserDefaults writeStatistics];
+    metrics[@"main_thread"] = [OSMainThreadWatchdog snapshot];
+    // The NSE runs in its own process, so its timings come from the app group rather than the counters
+    OneSignalUserDefaults *sharedUserDefaults = OneSignalUserDefaults.initShared;
+    metrics[@"nse_last_run"] = [sharedUserDefaults getSavedDictionaryForKey:OSUD_NSE_LAST_STAGE_TIMINGS defaultValue:nil];
+    return metrics;
+}
+
++ (void)enqueueLogEvent:(OneSignalLogEvent *)event {
+    @synchronized (_pendingLogEvents) {
+        if (_pendingLogEvents.count >= OS_LOG_LISTENER_BUFFER_LIMIT) {
+            [_pendingLogEvents removeObjectAtIndex:0];
+            _droppedLogEvents++;
+        }
+        [_pendingLogEvents addObject:event];
+        if (_listenerDrainScheduled) {
+            return;
+        }
+        _listenerDrainScheduled = true;
+    }
+    dispatch_async(_listenerQueue, ^{
+        [self drainLogEvents];
+    });
+}
+
++ (void)purgePendingLogEvents {
+    @synchronized (_pendingLogEvents) {
+        _droppedLogEvents += _pendingLogEvents.count;
+        [_pendingLogEvents removeAllObjects];
+    }
+}
+
+// Must be called on the `_listenerQueue`
++ (void)drainLogEvents {
+    NSArray<OneSignalLogEvent *> *events;
+    NSUInteger dropped;
+    @synchronized (_pendingLogEvents) {
+        events = [_pendingLogEvents copy];
+        dropped = _droppedLogEvents;
+        [_pendingLogEvents removeAllObjects];
+        _droppedLogEvents = 0;
+        _listenerDrainScheduled = false;
+    }
+    NSArray<NSObject<OSLogListener> *> *listeners = _logListeners.listeners;
+    if (dropped > 0) {
+        OneSignalLogEvent *droppedEvent = [[OneSignalLogEvent alloc] initWithLevel:ONE_S_LL_WARN entry:[NSString stringWithFormat:@"WARNING: Dropped %lu log events while log listeners were behind", (unsigned long)dropped]];
+        for (NSObject<OSLogListener> *listener in listeners) {
+            [listener onLogEvent:droppedEvent];
+        }
+    }
+    for (OneSignalLogEvent *event in events) {
+        for (NSObject<OSLogListener> *listener in listeners) {
+            [listener onLogEvent:event];
+        }
+    }
+}
+
 + (void)onesignalLog:(ONE_S_LOG_LEVEL)logLevel message:(NSString* _Nonnull)message {
     onesignal_Log(logLevel, message);
 }
 
++ (void)onesignalLog:(ONE_S_LOG_LEVEL)logLevel messageBlock:(NSString* _Nonnull (^ _Nonnull)(void))messageBlock {
+    if ([self isLogLevelEnabled:logLevel]) {
+        onesignal_Log(logLevel, messageBlock());
+    }
+}
+
++ (BOOL)isLogLevelEnabled:(ONE_S_LOG_LEVEL)logLevel {
+    return logLevel <= _nsLogLevel || logLevel <= _alertLogLevel;
+}
+
 + (ONE_S_LOG_LEVEL)getLogLevel {
     return _nsLogLevel;
 }
 
 void onesignal_Log(ONE_S_LOG_LEVEL logLevel, NSString* message) {
+    if (![OneSignalLog isLogLevelEnabled:logLevel]) {
+        return;
+    }
     NSString* levelString;
     switch (logLevel) {
         case ONE_S_LL_FATAL:
@@ -80,8 +225,13 @@ void onesignal_Log(ONE_S_LOG_LEVEL logLevel, NSString* message) {
             break;
     }
 
-    if (logLevel <= _nsLogLevel)
-        NSLog(@"%@", [levelString stringByAppendingString:message]);
+    if (logLevel <= _nsLogLevel) {
+        // A static format string lets os_log defer the formatting, and skip it for debug messages nobody is streaming
+        os_log_with_type(OSLogHandle(), OSLogType(logLevel), "%{public}@%{public}@", levelString, message);
+        if (_logListeners.count > 0) {
+            [OneSignalLog enqueueLogEvent:[[OneSignalLogEvent alloc] initWithLevel:logLevel entry:[levelString stringByAppendingString:message]]];
+        }
+    }
     
     if (logLevel <= _alertLogLevel) {
         [[OSDialogInstanceManager sharedInstance] presentDialogWithTitle:levelString withMessage:message withActions:nil cancelTitle:NSLocalizedString(@"Close", @"Close button") withActionCompletion:nil];
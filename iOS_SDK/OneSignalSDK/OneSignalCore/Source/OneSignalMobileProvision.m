@@ -35,46 +35,54 @@
  
  */
 
+// The profile cannot change while the app runs, so it is read and parsed once, including when there is none
 + (NSDictionary*) getProvision {
     static NSDictionary* provision = nil;
-    if (!provision) {
-        // iphoneos & iphonesimulator provisioning file is embedded.mobileprovision
-        NSString *provisioningPath = [[NSBundle mainBundle] pathForResource:@"embedded" ofType:@"mobileprovision"];
-        
-        // If embedded.mobileprovision not found, try Mac Catalyst bundle struct and unique filename
-        if (!provisioningPath) {
-            NSString *bundleURL = [[NSBundle mainBundle] bundleURL].absoluteString;
-            provisioningPath = [[[bundleURL componentsSeparatedByString:@"file://"] objectAtIndex:1] stringByAppendingString:@"Contents/embedded.provisionprofile"];
-        }
-        
-        // NSISOLatin1 keeps the binary wrapper from being parsed as unicode and dropped as invalid
-        NSString *binaryString = [NSString stringWithContentsOfFile:provisioningPath encoding:NSISOLatin1StringEncoding error:NULL];
-        if (!binaryString)
-            return nil;
-        
-        NSScanner *scanner = [NSScanner scannerWithString:binaryString];
-        BOOL ok = [scanner scanUpToString:@"<plist" intoString:nil];
-        if (!ok) {
-            [self logInvalidProvisionError:@"unable to find beginning of plist"];
-            return UIApplicationReleaseUnknown;
-        }
-        NSString *plistString;
-        ok = [scanner scanUpToString:@"</plist>" intoString:&plistString];
-        if (!ok) {
-            [self logInvalidProvisionError:@"unable to find end of plist"];
-            return UIApplicationReleaseUnknown;
-        }
-        plistString = [NSString stringWithFormat:@"%@</plist>",plistString];
-        // juggle latin1 back to utf-8!
-        NSData *plistdata_latin1 = [plistString dataUsingEncoding:NSISOLatin1StringEncoding];
-        //        plistString = [NSString stringWithUTF8String:[plistdata_latin1 bytes]];
-        //        NSData *plistdata2_latin1 = [plistString dataUsingEncoding:NSISOLatin1StringEncoding];
-        NSError *error = nil;
-        provision = [NSPropertyListSerialization propertyListWithData:plistdata_latin1 options:NSPropertyListImmutable format:NULL error:&error];
-        if (error) {
-            [self logInvalidProvisionError:[NSString stringWithFormat:@"error parsing extracted plist - %@",error]];
-            return nil;
-        }
+    static dispatch_once_t once;
+    dispatch_once(&once, ^{
+        provision = [self readProvision];
+    });
+    return provision;
+}
+
++ (NSDictionary*) readProvision {
+    NSDictionary* provision = nil;
+    // iphoneos & iphonesimulator provisioning file is embedded.mobileprovision
+    NSString *provisioningPath = [[NSBundle mainBundle] pathForResource:@"embedded" ofType:@"mobileprovision"];
+    
+    // If embedded.mobileprovision not found, try Mac Catalyst bundle struct and unique filename
+    if (!provisioningPath) {
+        NSString *bundleURL = [[NSBundle mainBundle] bundleURL].absoluteString;
+        provisioningPath = [[[bundleURL componentsSeparatedByString:@"file://"] objectAtIndex:1] stringByAppendingString:@"Contents/embedded.provisionprofile"];
+    }
+    
+    // NSISOLatin1 keeps the binary wrapper from being parsed as unicode and dropped as invalid
+    NSString *binaryString = [NSString stringWithContentsOfFile:provisioningPath encoding:NSISOLatin1StringEncoding error:NULL];
+    if (!binaryString)
+        return nil;
+    
+    NSScanner *scanner = [NSScanner scannerWithString:binaryString];
+    BOOL ok = [scanner scanUpToString:@"<plist" intoString:nil];
+    if (!ok) {
+        [self logInvalidProvisionError:@"unable to find beginning of plist"];
+        return nil;
+    }
+    NSString *plistString;
+    ok = [scanner scanUpToString:@"</plist>" intoString:&plistString];
+    if (!ok) {
+        [self logInvalidProvisionError:@"unable to find end of plist"];
+        return nil;
+    }
+    plistString = [NSString stringWithFormat:@"%@</plist>",plistString];
+    // juggle latin1 back to utf-8!
+    NSData *plistdata_latin1 = [plistString dataUsingEncoding:NSISOLatin1StringEncoding];
+    //        plistString = [NSString stringWithUTF8String:[plistdata_latin1 bytes]];
+    //        NSData *plistdata2_latin1 = [plistString dataUsingEncoding:NSISOLatin1StringEncoding];
+    NSError *error = nil;
+    provision = [NSPropertyListSerialization propertyListWithData:plistdata_latin1 options:NSPropertyListImmutable format:NULL error:&error];
+    if (error) {
+        [self logInvalidProvisionError:[NSString stringWithFormat:@"error parsing extracted plist - %@",error]];
+        return nil;
     }
     return provision;
 }
@@ -84,10 +92,19 @@
 }
 
 + (OSUIApplicationReleaseMode) releaseMode {
+    static OSUIApplicationReleaseMode releaseMode;
+    static dispatch_once_t once;
+    dispatch_once(&once, ^{
+        releaseMode = [self readReleaseMode];
+    });
+    return releaseMode;
+}
+
++ (OSUIApplicationReleaseMode) readReleaseMode {
     NSDictionary *entitlements = nil;
     NSDictionary *provision = [self getProvision];
     if (provision) {
-        [OneSignalLog onesignalLog:ONE_S_LL_DEBUG message:[NSString stringWithFormat:@"provision: %@", provision]];
+        ONE_S_LOG(ONE_S_LL_DEBUG, @"provision: %@", provision);
         entitlements = [provision objectForKey:@"Entitlements"];
     }
     else
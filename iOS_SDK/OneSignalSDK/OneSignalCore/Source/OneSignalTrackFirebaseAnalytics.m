@@ -39,8 +39,18 @@ static BOOL trackingEnabled = false;
     trackingEnabled = false;
 }
 
+// Looked up once, most apps do not link Firebase and should not pay for the lookup on every notification
++ (Class)firAnalyticsClass {
+    static Class firAnalyticsClass;
+    static dispatch_once_t once;
+    dispatch_once(&once, ^{
+        firAnalyticsClass = NSClassFromString(@"FIRAnalytics");
+    });
+    return firAnalyticsClass;
+}
+
 + (BOOL)libraryExists {
-    return NSClassFromString(@"FIRAnalytics") != nil;
+    return [self firAnalyticsClass] != nil;
 }
 
 // Called from both main target and extension
@@ -52,8 +62,14 @@ static BOOL trackingEnabled = false;
 
 
 + (void)updateFromDownloadParams:(NSDictionary*)params {
-    trackingEnabled = [params[@"fba"] boolValue];
+    BOOL enabled = [params[@"fba"] boolValue];
     OneSignalUserDefaults *sharedUserDefaults = OneSignalUserDefaults.initShared;
+    // Params are downloaded every launch, only write when the setting changes
+    if (enabled == [sharedUserDefaults getSavedBoolForKey:ONESIGNAL_FB_ENABLE_FIREBASE defaultValue:false]) {
+        trackingEnabled = enabled;
+        return;
+    }
+    trackingEnabled = enabled;
     if (trackingEnabled)
         [sharedUserDefaults saveBoolForKey:ONESIGNAL_FB_ENABLE_FIREBASE withValue:YES];
     else
@@ -65,7 +81,7 @@ static BOOL trackingEnabled = false;
 }
 
 + (void)logEventWithName:(NSString*)name parameters:(NSDictionary*)params {
-    id firAnalyticsClass = NSClassFromString(@"FIRAnalytics");
+    id firAnalyticsClass = [self firAnalyticsClass];
     if (!firAnalyticsClass)
         return;
     
@@ -88,7 +104,8 @@ static BOOL trackingEnabled = false;
 }
 
 + (void)trackOpenEvent:(OSNotificationClickEvent*)event {
-    if (!trackingEnabled)
+    // The parameters are only built when there is a Firebase to log them to
+    if (!trackingEnabled || ![self libraryExists])
         return;
     
     lastOpenedTime = [[NSDate date] timeIntervalSince1970];
@@ -103,19 +120,25 @@ static BOOL trackingEnabled = false;
 }
 
 + (void)trackReceivedEvent:(OSNotification*)notification {
-    NSString *campaign = [self getCampaignNameFromNotification:notification];
-    OneSignalUserDefaults *sharedUserDefaults = OneSignalUserDefaults.initShared;
-    [sharedUserDefaults saveStringForKey:ONESIGNAL_FB_LAST_NOTIFICATION_ID_RECEIVED withValue:notification.notificationId];
-    [sharedUserDefaults saveStringForKey:ONESIGNAL_FB_LAST_GAF_CAMPAIGN_RECEIVED withValue:campaign];
-    [sharedUserDefaults saveDoubleForKey:ONESIGNAL_FB_LAST_TIME_RECEIVED withValue:[[NSDate date] timeIntervalSince1970]];
+    // The extension does not call init, read the setting the app saved
+    if (!trackingEnabled)
+        [self init];
+    if (!trackingEnabled)
+        return;
+    
+    [OneSignalUserDefaults.initShared saveObjectForKey:ONESIGNAL_FB_LAST_RECEIVED withValue:@{
+        @"notification_id": notification.notificationId ?: @"",
+        @"campaign": [self getCampaignNameFromNotification:notification],
+        @"time": @([[NSDate date] timeIntervalSince1970])
+    }];
 }
 
 + (void)trackInfluenceOpenEvent {
-    if (!trackingEnabled)
+    if (!trackingEnabled || ![self libraryExists])
         return;
     
-    OneSignalUserDefaults *sharedUserDefaults = OneSignalUserDefaults.initShared;
-    NSTimeInterval lastTimeReceived = [sharedUserDefaults getSavedDoubleForKey:ONESIGNAL_FB_LAST_TIME_RECEIVED defaultValue:0];
+    NSDictionary *lastReceived = [OneSignalUserDefaults.initShared getSavedObjectForKey:ONESIGNAL_FB_LAST_RECEIVED defaultValue:nil];
+    NSTimeInterval lastTimeReceived = [lastReceived[@"time"] doubleValue];
     
     if (lastTimeReceived == 0)
         return;
@@ -131,15 +154,15 @@ static BOOL trackingEnabled = false;
     if (now - lastOpenedTime < 30)
         return;
     
-    NSString *notificationId = [sharedUserDefaults getSavedStringForKey:ONESIGNAL_FB_LAST_NOTIFICATION_ID_RECEIVED defaultValue:nil];
-    NSString *campaign = [sharedUserDefaults getSavedStringForKey:ONESIGNAL_FB_LAST_GAF_CAMPAIGN_RECEIVED defaultValue:nil];
+    NSString *notificationId = lastReceived[@"notification_id"];
+    NSString *campaign = lastReceived[@"campaign"];
     
     NSMutableDictionary *params = [NSMutableDictionary dictionaryWithDictionary:@{
         @"source": @"OneSignal",
         @"medium": @"notification"
     }];
     
-    if (notificationId) {
+    if (notificationId.length > 0) {
         params[@"notification_id"] = notificationId;
     }
     if (campaign) {
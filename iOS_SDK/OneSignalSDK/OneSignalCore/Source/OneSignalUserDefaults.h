@@ -27,15 +27,48 @@
 
 #import <Foundation/Foundation.h>
 
+/**
+ Values are persisted in NSUserDefaults by default. When the `OneSignal_sqlite_storage` key in the app's Info.plist is YES,
+ they are persisted in a SQLite database per suite instead, see `OSSQLiteStorageEngine`.
+ The notification service extension follows the app's setting. Removing the key moves the values back to NSUserDefaults.
+ */
 @interface OneSignalUserDefaults : NSObject
 
 @property (strong, nonatomic, nullable) NSUserDefaults *userDefaults;
 
+// These return cached, process-wide instances that are safe to hold on to and share across threads
 + (OneSignalUserDefaults * _Nonnull)initStandard;
 + (OneSignalUserDefaults * _Nonnull)initShared;
 
 + (NSString * _Nonnull)appGroupName;
 
+/**
+ Writes are staged in an in-memory journal and flushed to NSUserDefaults in coalesced batches on a background queue.
+ Reads consult the journal first, so callers always see their own writes.
+ Call this to force all pending writes to disk, such as when the app enters the background or before the NSE exits.
+ */
++ (void)flushPendingWrites;
+
+// Defaults to YES. When NO, every write is applied and synchronized immediately.
++ (BOOL)writeBehindEnabled;
++ (void)setWriteBehindEnabled:(BOOL)enabled;
+
+// Drops any staged writes without persisting them, for clearing state in unit tests
++ (void)discardPendingWrites;
+
+/**
+ What each key was written in this process, across all suites:
+ { "OS_OPERATION_REPO_DELTA_QUEUE_KEY": { "writes": 40, "bytes": 81920, "time_us": 5200, "flushes": 6 } }
+ `bytes` is the size of the encoded values and `time_us` the time spent encoding and staging them, or writing them when
+ write-behind is disabled. `flushes` counts the writes that reached storage, fewer than `writes` when the journal coalesced them.
+ Exposed under "user_defaults_keys" in `OneSignal.Debug.metrics`.
+ */
++ (NSDictionary<NSString *, NSDictionary<NSString *, NSNumber *> *> * _Nonnull)writeStatistics;
++ (void)resetWriteStatistics;
+
+// Drops the objects kept by `getCachedCodeableDataForKey:` and `prefetchCodeableDataForKeys:`, they are decoded again when next read
++ (void)purgeDecodedValues;
+
 - (BOOL)keyExists:(NSString * _Nonnull)key;
 
 - (void)removeValueForKey:(NSString * _Nonnull)key;
@@ -72,4 +105,18 @@
 - (id _Nullable)getSavedCodeableDataForKey:(NSString * _Nonnull)key defaultValue:(id _Nullable)value;
 - (void)saveCodeableDataForKey:(NSString * _Nonnull)key withValue:(id _Nullable)value;
 
+/**
+ Like `getSavedCodeableDataForKey:defaultValue:`, but returns the object decoded on a previous call for as long as
+ the stored data is unchanged, including by another process such as the notification service extension.
+ The returned object is shared between callers, so it must not be mutated.
+ */
+- (id _Nullable)getCachedCodeableDataForKey:(NSString * _Nonnull)key defaultValue:(id _Nullable)value;
+
+/**
+ Unarchives the codeable data for these keys concurrently and blocks until all of them are decoded.
+ The next `getSavedCodeableDataForKey:defaultValue:` for each key returns its decoded object instead of unarchiving again,
+ as long as the stored data has not changed in the meantime. Each prefetched object is handed out once.
+ */
+- (void)prefetchCodeableDataForKeys:(NSArray<NSString *> * _Nonnull)keys;
+
 @end
@@ -28,139 +28,607 @@
 #import <Foundation/Foundation.h>
 #import "OneSignalUserDefaults.h"
 #import "OneSignalCommonDefines.h"
+#import "OSPerformanceCounters.h"
+#import "OSStorageEngine.h"
+#import "OSSQLiteStorageEngine.h"
+#import "OSSharedStateVersion.h"
+#import "OSSharedStateSnapshot.h"
+#import "OSDispatchQueues.h"
+
+@implementation NSUserDefaults (OSStorageEngine)
+@end
+
+@interface OneSignalUserDefaults ()
+
+// The key identifying which suite this instance reads and writes, used to share the write-behind journal across instances
+@property (strong, nonatomic, nonnull) NSString *suiteKey;
+
+// Where values are persisted, `userDefaults` itself unless SQLite storage is enabled
+@property (strong, nonatomic, nonnull) id<OSStorageEngine> storage;
+
+// Set on the app group suite, which keeps the values extensions read at startup in OSSharedStateSnapshot
+@property (nonatomic) BOOL usesSnapshot;
+
+// Objects decoded by `getCachedCodeableDataForKey:`, keyed by key, with the archived data they came from. Synchronized on itself.
+@property (strong, nonatomic, nonnull) NSMutableDictionary<NSString *, NSArray *> *decodedValues;
+
+// Objects decoded by `prefetchCodeableDataForKeys:` and not yet read, in the same form as `decodedValues`. Synchronized on itself.
+@property (strong, nonatomic, nonnull) NSMutableDictionary<NSString *, NSArray *> *prefetchedValues;
+
+@end
+
+#define OS_STANDARD_SUITE_KEY @"OS_STANDARD_SUITE_KEY"
+
+// What was written to one key in this process, see `writeStatistics`
+@interface OSUserDefaultsKeyStatistics : NSObject
+@property (nonatomic) int64_t writes;
+@property (nonatomic) int64_t bytes;
+@property (nonatomic) int64_t microseconds;
+@property (nonatomic) int64_t flushes;
+@end
+
+@implementation OSUserDefaultsKeyStatistics
+@end
+
+// The payload size of a property list value, without the plist encoding overhead, for the bytes written counter
+static int64_t OSApproximateByteSize(id value) {
+    if ([value isKindOfClass:[NSData class]])
+        return ((NSData *)value).length;
+    if ([value isKindOfClass:[NSString class]])
+        return [(NSString *)value lengthOfBytesUsingEncoding:NSUTF8StringEncoding];
+    if ([value isKindOfClass:[NSArray class]]) {
+        int64_t size = 0;
+        for (id element in (NSArray *)value)
+            size += OSApproximateByteSize(element);
+        return size;
+    }
+    if ([value isKindOfClass:[NSDictionary class]]) {
+        __block int64_t size = 0;
+        [(NSDictionary *)value enumerateKeysAndObjectsUsingBlock:^(id key, id element, BOOL *stop) {
+            size += OSApproximateByteSize(key) + OSApproximateByteSize(element);
+        }];
+        return size;
+    }
+    return value ? sizeof(double) : 0;
+}
+
+/**
+ The write-behind journal. Maps a suite key to a dictionary of the keys written and not yet flushed.
+ A pending removal is represented by NSNull. Access is synchronized on `journalLock`.
+ */
+static NSMutableDictionary<NSString *, NSMutableDictionary<NSString *, id> *> *pendingWrites;
+// The storage each suite in the journal should be flushed to
+static NSMutableDictionary<NSString *, id<OSStorageEngine>> *pendingSuites;
+static NSObject *journalLock;
+// Cached handles to the app group suite, keyed by app group name
+static NSMutableDictionary<NSString *, OneSignalUserDefaults *> *sharedInstances;
+static dispatch_queue_t flushQueue;
+static BOOL flushScheduled = false;
+static BOOL writeBehindEnabled = true;
+// Keyed by key across all suites, synchronized on itself
+static NSMutableDictionary<NSString *, OSUserDefaultsKeyStatistics *> *keyStatistics;
 
 @implementation OneSignalUserDefaults : NSObject
 
-// TODO: Revisit if we should use a singletone, not init so much
++ (void)initialize {
+    if (self != [OneSignalUserDefaults class])
+        return;
+
+    pendingWrites = [NSMutableDictionary new];
+    pendingSuites = [NSMutableDictionary new];
+    journalLock = [NSObject new];
+    sharedInstances = [NSMutableDictionary new];
+    keyStatistics = [NSMutableDictionary new];
+    flushQueue = dispatch_queue_create_with_target("com.onesignal.userdefaults.flush", DISPATCH_QUEUE_SERIAL, OSDispatchQueues.utility);
+}
+
+/**
+ Returns the process-wide handle for the standard suite. The same instance is returned on every call,
+ so callers on hot paths can call this freely or hold on to the handle.
+ */
 + (OneSignalUserDefaults * _Nonnull)initStandard {
-    OneSignalUserDefaults *instance = [OneSignalUserDefaults new];
-    instance.userDefaults = [instance getStandardUserDefault];
-    return instance;
+    static OneSignalUserDefaults *standardInstance;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        standardInstance = [OneSignalUserDefaults new];
+        standardInstance.userDefaults = [standardInstance getStandardUserDefault];
+        standardInstance.storage = [OneSignalUserDefaults storageFor:standardInstance.userDefaults inDirectory:[[NSFileManager defaultManager] URLsForDirectory:NSApplicationSupportDirectory inDomains:NSUserDomainMask].firstObject named:@"OneSignal.sqlite" sharedContainer:false];
+        standardInstance.suiteKey = OS_STANDARD_SUITE_KEY;
+        standardInstance.decodedValues = [NSMutableDictionary new];
+        standardInstance.prefetchedValues = [NSMutableDictionary new];
+    });
+    return standardInstance;
 }
 
-// TODO: Revisit if we should use a singletone, not init so much
+/**
+ Returns the process-wide handle for the app group suite, avoiding a new `initWithSuiteName:` per call.
+ Handles are cached by app group name in case the name resolves differently, such as in tests.
+ */
 + (OneSignalUserDefaults * _Nonnull)initShared {
-    OneSignalUserDefaults *instance = [OneSignalUserDefaults new];
-    instance.userDefaults = [instance getSharedUserDefault];
-    return instance;
+    NSString *appGroupName = [OneSignalUserDefaults appGroupName];
+    @synchronized (sharedInstances) {
+        OneSignalUserDefaults *instance = sharedInstances[appGroupName];
+        if (!instance) {
+            instance = [OneSignalUserDefaults new];
+            instance.userDefaults = [[NSUserDefaults alloc] initWithSuiteName:appGroupName];
+            // In the app group container so the app and the notification service extension share the database
+            instance.storage = [OneSignalUserDefaults storageFor:instance.userDefaults inDirectory:[[NSFileManager defaultManager] containerURLForSecurityApplicationGroupIdentifier:appGroupName] named:@"OneSignalShared.sqlite" sharedContainer:true];
+            instance.suiteKey = appGroupName;
+            instance.usesSnapshot = true;
+            instance.decodedValues = [NSMutableDictionary new];
+            instance.prefetchedValues = [NSMutableDictionary new];
+            sharedInstances[appGroupName] = instance;
+        }
+        return instance;
+    }
 }
 
 - (NSUserDefaults* _Nonnull)getStandardUserDefault {
     return NSUserDefaults.standardUserDefaults;
 }
 
-- (NSUserDefaults* _Nonnull)getSharedUserDefault {
-    return [[NSUserDefaults alloc] initWithSuiteName:[self appGroupKey]];
+#pragma mark Storage engine
+
+/**
+ The app and its notification service extension must store state in the same place, but each has its own Info.plist.
+ Only the app's Info.plist is read. The app records the setting in the app group's user defaults, where the extension reads it.
+ Read once per process, so a change takes effect on the next launch of each.
+ */
++ (BOOL)sqliteStorageEnabled {
+    static BOOL enabled;
+    static dispatch_once_t once;
+    dispatch_once(&once, ^{
+        NSUserDefaults *appGroupUserDefaults = [[NSUserDefaults alloc] initWithSuiteName:[self appGroupName]];
+        if ([NSBundle.mainBundle.bundleURL.pathExtension isEqualToString:@"appex"]) {
+            enabled = [appGroupUserDefaults boolForKey:OSUD_SQLITE_STORAGE_ENABLED];
+            return;
+        }
+        enabled = [[[NSBundle mainBundle] objectForInfoDictionaryKey:ONESIGNAL_SQLITE_STORAGE_KEY] boolValue];
+        if ([appGroupUserDefaults boolForKey:OSUD_SQLITE_STORAGE_ENABLED] != enabled)
+            [appGroupUserDefaults setBool:enabled forKey:OSUD_SQLITE_STORAGE_ENABLED];
+    });
+    return enabled;
+}
+
+/**
+ Returns a SQLite engine for the database in the directory when SQLite storage is enabled, otherwise the user defaults themselves.
+ Also falls back to the user defaults if the directory is unavailable, such as an app group that is not set up.
+ Turning SQLite storage off, by removing the Info.plist key, moves the database's values back into the user defaults.
+ */
++ (id<OSStorageEngine> _Nonnull)storageFor:(NSUserDefaults * _Nonnull)userDefaults inDirectory:(NSURL * _Nullable)directory named:(NSString * _Nonnull)name sharedContainer:(BOOL)sharedContainer {
+    if (!directory)
+        return userDefaults;
+    NSString *path = [[directory URLByAppendingPathComponent:@"OneSignal"] URLByAppendingPathComponent:name].path;
+    if (![self sqliteStorageEnabled]) {
+        if ([[NSFileManager defaultManager] fileExistsAtPath:path])
+            [OSSQLiteStorageEngine exportDatabaseAtPath:path toUserDefaults:userDefaults];
+        return userDefaults;
+    }
+    return [[OSSQLiteStorageEngine alloc] initWithPath:path fallback:userDefaults sharedContainer:sharedContainer] ?: userDefaults;
+}
+
+#pragma mark Write-behind journal
+
++ (BOOL)writeBehindEnabled {
+    @synchronized (journalLock) {
+        return writeBehindEnabled;
+    }
+}
+
++ (void)setWriteBehindEnabled:(BOOL)enabled {
+    @synchronized (journalLock) {
+        writeBehindEnabled = enabled;
+    }
+    if (!enabled)
+        [self flushPendingWrites];
+}
+
++ (void)flushPendingWrites {
+    NSMutableArray<id<OSStorageEngine>> *suitesToSynchronize = [NSMutableArray new];
+    BOOL wroteSharedSuite = false;
+    @synchronized (journalLock) {
+        // Apply the journal while holding the lock so readers never observe a key missing from both places
+        for (NSString *suiteKey in pendingWrites) {
+            id<OSStorageEngine> storage = pendingSuites[suiteKey];
+            NSDictionary *writes = pendingWrites[suiteKey];
+            if (!storage || writes.count == 0)
+                continue;
+            [self recordFlushOfKeys:writes.allKeys];
+            if (![storage respondsToSelector:@selector(applyChanges:)] || ![storage applyChanges:writes]) {
+                for (NSString *key in writes) {
+                    id value = writes[key];
+                    if (value == [NSNull null])
+                        [storage removeObjectForKey:key];
+                    else
+                        [storage setObject:value forKey:key];
+                }
+            }
+            [suitesToSynchronize addObject:storage];
+            wroteSharedSuite = wroteSharedSuite || ![suiteKey isEqualToString:OS_STANDARD_SUITE_KEY];
+        }
+        [pendingWrites removeAllObjects];
+        [pendingSuites removeAllObjects];
+        flushScheduled = false;
+    }
+    // One synchronize per suite for the whole batch
+    for (id<OSStorageEngine> storage in suitesToSynchronize) {
+        [storage synchronize];
+    }
+    if (wroteSharedSuite) {
+        [OSSharedStateSnapshot flush];
+        [OSSharedStateVersion postChange];
+    }
+}
+
++ (OSUserDefaultsKeyStatistics *)statisticsForKey:(NSString *)key {
+    // Caller must hold keyStatistics
+    OSUserDefaultsKeyStatistics *statistics = keyStatistics[key];
+    if (!statistics) {
+        statistics = [OSUserDefaultsKeyStatistics new];
+        keyStatistics[key] = statistics;
+    }
+    return statistics;
+}
+
++ (void)recordWriteForKey:(NSString *)key bytes:(int64_t)bytes since:(CFAbsoluteTime)start {
+    int64_t microseconds = (int64_t)((CFAbsoluteTimeGetCurrent() - start) * 1000000);
+    @synchronized (keyStatistics) {
+        OSUserDefaultsKeyStatistics *statistics = [self statisticsForKey:key];
+        statistics.writes++;
+        statistics.bytes += bytes;
+        statistics.microseconds += microseconds;
+    }
 }
 
-- (NSString * _Nonnull)appGroupKey {
-    return [OneSignalUserDefaults appGroupName];
++ (void)recordFlushOfKeys:(NSArray<NSString *> *)keys {
+    @synchronized (keyStatistics) {
+        for (NSString *key in keys) {
+            [self statisticsForKey:key].flushes++;
+        }
+    }
 }
 
++ (NSDictionary<NSString *, NSDictionary<NSString *, NSNumber *> *> *)writeStatistics {
+    NSMutableDictionary<NSString *, NSDictionary<NSString *, NSNumber *> *> *snapshot = [NSMutableDictionary new];
+    @synchronized (keyStatistics) {
+        for (NSString *key in keyStatistics) {
+            OSUserDefaultsKeyStatistics *statistics = keyStatistics[key];
+            snapshot[key] = @{
+                @"writes": @(statistics.writes),
+                @"bytes": @(statistics.bytes),
+                @"time_us": @(statistics.microseconds),
+                @"flushes": @(statistics.flushes)
+            };
+        }
+    }
+    return snapshot;
+}
+
++ (void)resetWriteStatistics {
+    @synchronized (keyStatistics) {
+        [keyStatistics removeAllObjects];
+    }
+}
+
++ (void)discardPendingWrites {
+    @synchronized (journalLock) {
+        [pendingWrites removeAllObjects];
+        [pendingSuites removeAllObjects];
+    }
+}
+
++ (void)purgeDecodedValues {
+    NSMutableArray<OneSignalUserDefaults *> *instances = [NSMutableArray arrayWithObject:[OneSignalUserDefaults initStandard]];
+    @synchronized (sharedInstances) {
+        [instances addObjectsFromArray:sharedInstances.allValues];
+    }
+    for (OneSignalUserDefaults *instance in instances) {
+        @synchronized (instance.decodedValues) {
+            [instance.decodedValues removeAllObjects];
+        }
+        @synchronized (instance.prefetchedValues) {
+            [instance.prefetchedValues removeAllObjects];
+        }
+    }
+}
+
++ (void)scheduleFlush {
+    // Caller must hold journalLock
+    if (flushScheduled)
+        return;
+    flushScheduled = true;
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, OS_USER_DEFAULTS_FLUSH_DELAY_MS * NSEC_PER_MSEC), flushQueue, ^{
+        [OneSignalUserDefaults flushPendingWrites];
+    });
+}
+
+/**
+ Stages a value for the key, or a removal if the value is nil.
+ The value must already be in the form NSUserDefaults stores, and immutable.
+ */
+- (void)stageValue:(id _Nullable)value forKey:(NSString * _Nonnull)key {
+    [self stageValue:value forKey:key since:CFAbsoluteTimeGetCurrent()];
+}
+
+// `start` is when the write began, before encoding the value, for the time spent on the key in `writeStatistics`
+- (void)stageValue:(id _Nullable)value forKey:(NSString * _Nonnull)key since:(CFAbsoluteTime)start {
+    if (self.usesSnapshot)
+        [OSSharedStateSnapshot setValue:value forKey:key];
+    [self dropDecodedValueForKey:key];
+    int64_t bytes = OSApproximateByteSize(value);
+    [OSPerformanceCounters increment:OSPerformanceCounterUserDefaultsWrites];
+    [OSPerformanceCounters add:bytes toCounter:OSPerformanceCounterUserDefaultsBytesWritten];
+    BOOL staged = false;
+    @synchronized (journalLock) {
+        if (writeBehindEnabled) {
+            NSMutableDictionary *writes = pendingWrites[self.suiteKey];
+            if (!writes) {
+                writes = [NSMutableDictionary new];
+                pendingWrites[self.suiteKey] = writes;
+                pendingSuites[self.suiteKey] = self.storage;
+            }
+            writes[key] = value ?: [NSNull null];
+            [OneSignalUserDefaults scheduleFlush];
+            staged = true;
+        }
+    }
+    if (staged) {
+        [OneSignalUserDefaults recordWriteForKey:key bytes:bytes since:start];
+        return;
+    }
+
+    if (value)
+        [self.storage setObject:value forKey:key];
+    else
+        [self.storage removeObjectForKey:key];
+    [self.storage synchronize];
+    [OneSignalUserDefaults recordFlushOfKeys:@[key]];
+    [OneSignalUserDefaults recordWriteForKey:key bytes:bytes since:start];
+    if (![self.suiteKey isEqualToString:OS_STANDARD_SUITE_KEY]) {
+        [OSSharedStateSnapshot flush];
+        [OSSharedStateVersion postChange];
+    }
+}
+
+// A write replaces the data the decoded objects came from, so they would never be handed out again
+- (void)dropDecodedValueForKey:(NSString * _Nonnull)key {
+    @synchronized (self.decodedValues) {
+        [self.decodedValues removeObjectForKey:key];
+    }
+    @synchronized (self.prefetchedValues) {
+        [self.prefetchedValues removeObjectForKey:key];
+    }
+}
+
+/**
+ Returns YES if the key has a write in the journal that has not been flushed yet.
+ The staged value is returned through `value`, which is nil for a pending removal.
+ */
+- (BOOL)hasPendingValueForKey:(NSString * _Nonnull)key value:(id _Nullable * _Nonnull)value {
+    @synchronized (journalLock) {
+        id pending = pendingWrites[self.suiteKey][key];
+        if (!pending)
+            return false;
+        *value = pending == [NSNull null] ? nil : pending;
+        return true;
+    }
+}
+
+// The persisted value, from the shared state snapshot for the keys it has
+- (id _Nullable)storedObjectForKey:(NSString * _Nonnull)key {
+    id value;
+    if (self.usesSnapshot && [OSSharedStateSnapshot getValue:&value forKey:key])
+        return value;
+    return [self.storage objectForKey:key];
+}
+
+- (id _Nullable)immutableCopyOf:(id _Nullable)value {
+    if ([value conformsToProtocol:@protocol(NSCopying)])
+        return [value copy];
+    return value;
+}
+
+#pragma mark Getters and setters
+
 - (BOOL)keyExists:(NSString * _Nonnull)key {
-    return [self.userDefaults objectForKey:key] != nil;
+    id pending;
+    if ([self hasPendingValueForKey:key value:&pending])
+        return pending != nil;
+    return [self storedObjectForKey:key] != nil;
 }
 
 - (void)removeValueForKey:(NSString * _Nonnull)key {
-    [self.userDefaults removeObjectForKey:key];
-    [self.userDefaults synchronize];
+    [self stageValue:nil forKey:key];
 }
 
 - (BOOL)getSavedBoolForKey:(NSString * _Nonnull)key defaultValue:(BOOL)value {
-    if ([self keyExists:key])
-        return (BOOL) [self.userDefaults boolForKey:key];
+    id pending;
+    if ([self hasPendingValueForKey:key value:&pending])
+        return pending ? [pending boolValue] : value;
+
+    id stored = [self storedObjectForKey:key];
+    if (stored)
+        return [stored respondsToSelector:@selector(boolValue)] ? [stored boolValue] : false;
     
     return value;
 }
 
 - (void)saveBoolForKey:(NSString * _Nonnull)key withValue:(BOOL)value {
-    [self.userDefaults setBool:value forKey:key];
-    [self.userDefaults synchronize];
+    [self stageValue:@(value) forKey:key];
 }
 
 - (NSString * _Nullable)getSavedStringForKey:(NSString * _Nonnull)key defaultValue:(NSString * _Nullable)value {
-    if ([self keyExists:key])
-        return [self.userDefaults stringForKey:key];
+    id pending;
+    if ([self hasPendingValueForKey:key value:&pending])
+        return pending ? pending : value;
+
+    id stored = [self storedObjectForKey:key];
+    if (stored)
+        return [stored isKindOfClass:[NSNumber class]] ? [stored stringValue] : ([stored isKindOfClass:[NSString class]] ? stored : nil);
     
     return value;
 }
 
 - (void)saveStringForKey:(NSString * _Nonnull)key withValue:(NSString * _Nullable)value {
-    [self.userDefaults setObject:value forKey:key];
-    [self.userDefaults synchronize];
+    [self stageValue:[value copy] forKey:key];
 }
 
 // NOTE: NSInteger because NSUserDefaults returns NSInteger when using integerForKey method
 - (NSInteger)getSavedIntegerForKey:(NSString * _Nonnull)key defaultValue:(NSInteger)value {
-    if ([self keyExists:key])
-        return [self.userDefaults integerForKey:key];
+    id pending;
+    if ([self hasPendingValueForKey:key value:&pending])
+        return pending ? [pending integerValue] : value;
+
+    id stored = [self storedObjectForKey:key];
+    if (stored)
+        return [stored respondsToSelector:@selector(integerValue)] ? [stored integerValue] : 0;
         
     return value;
 }
 
 - (void)saveIntegerForKey:(NSString * _Nonnull)key withValue:(NSInteger)value {
-    [self.userDefaults setInteger:value forKey:key];
-    [self.userDefaults synchronize];
+    [self stageValue:@(value) forKey:key];
 }
 
 - (double)getSavedDoubleForKey:(NSString * _Nonnull)key defaultValue:(double)value {
-    if ([self keyExists:key])
-        return [self.userDefaults doubleForKey:key];
+    id pending;
+    if ([self hasPendingValueForKey:key value:&pending])
+        return pending ? [pending doubleValue] : value;
+
+    id stored = [self storedObjectForKey:key];
+    if (stored)
+        return [stored respondsToSelector:@selector(doubleValue)] ? [stored doubleValue] : 0;
     
     return value;
 }
 
 - (void)saveDoubleForKey:(NSString * _Nonnull)key withValue:(double)value {
-    [self.userDefaults setDouble:value forKey:key];
-    [self.userDefaults synchronize];
+    [self stageValue:@(value) forKey:key];
 }
 
 - (NSSet * _Nullable)getSavedSetForKey:(NSString * _Nonnull)key defaultValue:(NSSet * _Nullable)value {
-    if ([self keyExists:key])
-        return [NSSet setWithArray:[self.userDefaults arrayForKey:key]];
+    id pending;
+    if ([self hasPendingValueForKey:key value:&pending])
+        return pending ? [NSSet setWithArray:pending] : value;
+
+    id stored = [self storedObjectForKey:key];
+    if (stored)
+        return [NSSet setWithArray:[stored isKindOfClass:[NSArray class]] ? stored : @[]];
     
     return value;
 }
 
 - (void)saveSetForKey:(NSString * _Nonnull)key withValue:(NSSet * _Nullable)value {
-    [self.userDefaults setObject:[value allObjects] forKey:key];
-    [self.userDefaults synchronize];
+    [self stageValue:[value allObjects] forKey:key];
 }
 
 - (NSDictionary * _Nullable)getSavedDictionaryForKey:(NSString * _Nonnull)key defaultValue:(NSDictionary * _Nullable)value {
-    if ([self keyExists:key])
-        return [self.userDefaults dictionaryForKey:key];
+    id pending;
+    if ([self hasPendingValueForKey:key value:&pending])
+        return pending ? pending : value;
+
+    id stored = [self storedObjectForKey:key];
+    if (stored)
+        return [stored isKindOfClass:[NSDictionary class]] ? stored : nil;
 
     return value;
 }
 
 - (void)saveDictionaryForKey:(NSString * _Nonnull)key withValue:(NSSet * _Nullable)value {
-    [self.userDefaults setObject:value forKey:key];
-    [self.userDefaults synchronize];
+    [self stageValue:[self immutableCopyOf:value] forKey:key];
 }
 
 - (id _Nullable)getSavedObjectForKey:(NSString *)key defaultValue:(id _Nullable)value {
-    if ([self keyExists:key])
-        return [self.userDefaults objectForKey:key];
+    id pending;
+    if ([self hasPendingValueForKey:key value:&pending])
+        return pending ? pending : value;
+
+    id stored = [self storedObjectForKey:key];
+    if (stored)
+        return stored;
     
     return value;
 }
 
 - (void)saveObjectForKey:(NSString * _Nonnull)key withValue:(id _Nullable)object {
-    [self.userDefaults setObject:object forKey:key];
-    [self.userDefaults synchronize];
+    [self stageValue:[self immutableCopyOf:object] forKey:key];
 }
 
 - (id _Nullable)getSavedCodeableDataForKey:(NSString * _Nonnull)key defaultValue:(id _Nullable)value {
-    if ([self keyExists:key])
-        return [NSKeyedUnarchiver unarchiveObjectWithData:[self.userDefaults objectForKey:key]];
+    id pending;
+    if ([self hasPendingValueForKey:key value:&pending])
+        return pending ? [self unarchiveData:pending forKey:key] : value;
+
+    id stored = [self storedObjectForKey:key];
+    if (stored)
+        return [self unarchiveData:stored forKey:key];
     
     return value;
 }
 
+- (id _Nullable)unarchiveData:(NSData *)data forKey:(NSString *)key {
+    NSArray *prefetched;
+    @synchronized (self.prefetchedValues) {
+        prefetched = self.prefetchedValues[key];
+        [self.prefetchedValues removeObjectForKey:key];
+    }
+    if (prefetched && (prefetched[0] == data || [prefetched[0] isEqualToData:data]))
+        return prefetched[1];
+    return [NSKeyedUnarchiver unarchiveObjectWithData:data];
+}
+
+- (void)prefetchCodeableDataForKeys:(NSArray<NSString *> * _Nonnull)keys {
+    // Read on the calling thread so the journal and NSUserDefaults are consulted the same way as a regular read
+    NSMutableArray<NSString *> *foundKeys = [NSMutableArray new];
+    NSMutableArray<NSData *> *datas = [NSMutableArray new];
+    for (NSString *key in keys) {
+        NSData *data = [self getSavedObjectForKey:key defaultValue:nil];
+        if ([data isKindOfClass:[NSData class]]) {
+            [foundKeys addObject:key];
+            [datas addObject:data];
+        }
+    }
+    dispatch_apply(datas.count, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^(size_t index) {
+        id object = [NSKeyedUnarchiver unarchiveObjectWithData:datas[index]];
+        if (!object)
+            return;
+        @synchronized (self.prefetchedValues) {
+            self.prefetchedValues[foundKeys[index]] = @[datas[index], object];
+        }
+    });
+}
+
 - (void)saveCodeableDataForKey:(NSString * _Nonnull)key withValue:(id _Nullable)value {
-    [self.userDefaults setObject:[NSKeyedArchiver archivedDataWithRootObject:value] forKey:key];
-    [self.userDefaults synchronize];
+    CFAbsoluteTime start = CFAbsoluteTimeGetCurrent();
+    // Archive now so the journal holds a snapshot, even if the caller mutates the object afterwards
+    [self stageValue:[NSKeyedArchiver archivedDataWithRootObject:value] forKey:key since:start];
+}
+
+- (id _Nullable)getCachedCodeableDataForKey:(NSString * _Nonnull)key defaultValue:(id _Nullable)value {
+    NSData *data = [self getSavedObjectForKey:key defaultValue:nil];
+    if (!data)
+        return value;
+
+    @synchronized (self.decodedValues) {
+        NSArray *decoded = self.decodedValues[key];
+        if (decoded && decoded[0] == data)
+            return decoded[1];
+        // Comparing the archived bytes is much cheaper than unarchiving them again
+        if (decoded && [decoded[0] isEqualToData:data]) {
+            // Keep the data just read, storage returns the same instance until the value changes, such as once the
+            // journal is flushed, so the following reads are a pointer comparison instead of comparing every byte
+            self.decodedValues[key] = @[data, decoded[1]];
+            return decoded[1];
+        }
+    }
+
+    id object = [NSKeyedUnarchiver unarchiveObjectWithData:data];
+    if (!object)
+        return value;
+    @synchronized (self.decodedValues) {
+        self.decodedValues[key] = @[data, object];
+    }
+    return object;
 }
 
 //gets the NSBundle of the primary application - NOT the app extension
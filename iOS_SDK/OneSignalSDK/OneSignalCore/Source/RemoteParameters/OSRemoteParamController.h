@@ -35,8 +35,16 @@ THE SOFTWARE.
 @property (strong, nonatomic, readonly, nonnull) NSDictionary *remoteParams;
 
 - (void)saveRemoteParams:(NSDictionary *_Nonnull)params;
+
+// The last downloaded params are kept across launches so they can be applied before the request returns
+- (NSDictionary *_Nullable)cachedRemoteParamsForAppId:(NSString *_Nonnull)appId;
+- (NSString *_Nullable)cachedRemoteParamsETagForAppId:(NSString *_Nonnull)appId;
+- (BOOL)cacheRemoteParams:(NSDictionary *_Nonnull)params etag:(NSString *_Nullable)etag forAppId:(NSString *_Nonnull)appId;
+- (void)clearCachedRemoteParams;
 - (BOOL)hasLocationKey;
 - (BOOL)hasPrivacyConsentKey;
+// Whether the API accepts gzip compressed request bodies, false until remote params are downloaded
+- (BOOL)isRequestBodyCompressionEnabled;
 
 - (BOOL)isLocationShared;
 - (void)saveLocationShared:(BOOL)shared;
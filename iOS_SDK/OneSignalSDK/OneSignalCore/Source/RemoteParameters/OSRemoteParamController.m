@@ -44,6 +44,58 @@ static OSRemoteParamController *_sharedController;
     _remoteParams = params;
 }
 
+/*
+ The params are stored as JSON since they can contain NSNull values, which user defaults cannot hold.
+ They are only valid for the app id they were downloaded for.
+ */
+- (NSDictionary *)cachedRemoteParamsEntryForAppId:(NSString *)appId {
+    NSDictionary *cache = [OneSignalUserDefaults.initStandard getSavedDictionaryForKey:OSUD_CACHED_IOS_PARAMS defaultValue:nil];
+    if (![cache[@"app_id"] isEqualToString:appId]) {
+        return nil;
+    }
+    return cache;
+}
+
+- (NSDictionary *)cachedRemoteParamsForAppId:(NSString *)appId {
+    NSData *data = [self cachedRemoteParamsEntryForAppId:appId][@"params"];
+    if (![data isKindOfClass:[NSData class]]) {
+        return nil;
+    }
+    NSDictionary *params = [NSJSONSerialization JSONObjectWithData:data options:0 error:nil];
+    return [params isKindOfClass:[NSDictionary class]] ? params : nil;
+}
+
+- (NSString *)cachedRemoteParamsETagForAppId:(NSString *)appId {
+    // An ETag is only useful if the params it refers to can still be read back for a 304
+    if (![self cachedRemoteParamsForAppId:appId]) {
+        return nil;
+    }
+    return [self cachedRemoteParamsEntryForAppId:appId][@"etag"];
+}
+
+/*
+ Returns true if the params differ from the ones previously cached for this app id.
+ */
+- (BOOL)cacheRemoteParams:(NSDictionary *)params etag:(NSString *)etag forAppId:(NSString *)appId {
+    BOOL changed = ![params isEqualToDictionary:[self cachedRemoteParamsForAppId:appId]];
+    NSData *data = [NSJSONSerialization isValidJSONObject:params] ? [NSJSONSerialization dataWithJSONObject:params options:0 error:nil] : nil;
+    if (!data) {
+        [self clearCachedRemoteParams];
+        return changed;
+    }
+    NSMutableDictionary *cache = [NSMutableDictionary dictionaryWithDictionary:@{
+        @"app_id": appId,
+        @"params": data
+    }];
+    cache[@"etag"] = etag;
+    [OneSignalUserDefaults.initStandard saveDictionaryForKey:OSUD_CACHED_IOS_PARAMS withValue:cache];
+    return changed;
+}
+
+- (void)clearCachedRemoteParams {
+    [OneSignalUserDefaults.initStandard removeValueForKey:OSUD_CACHED_IOS_PARAMS];
+}
+
 - (BOOL)hasLocationKey {
     return _remoteParams && _remoteParams[IOS_LOCATION_SHARED];
 }
@@ -52,6 +104,10 @@ static OSRemoteParamController *_sharedController;
     return _remoteParams && _remoteParams[IOS_REQUIRES_USER_PRIVACY_CONSENT];
 }
 
+- (BOOL)isRequestBodyCompressionEnabled {
+    return _remoteParams && [_remoteParams[IOS_GZIP_REQUEST_BODIES_ENABLE] boolValue];
+}
+
 - (BOOL)isLocationShared {
     return [OneSignalUserDefaults.initShared getSavedBoolForKey:OSUD_LOCATION_ENABLED defaultValue:NO];
 }
@@ -66,6 +122,7 @@ static OSRemoteParamController *_sharedController;
 
 - (void)savePrivacyConsentRequired:(BOOL)required {
     [OneSignalUserDefaults.initShared saveBoolForKey:OSUD_REQUIRES_USER_PRIVACY_CONSENT withValue:required];
+    [OSPrivacyConsentController reloadPrivacyConsentState];
 }
 
 @end
@@ -0,0 +1,76 @@
+/**
+Modified MIT License
+
+Copyright 2024 OneSignal
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+1. The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+2. All copies of substantial portions of the Software may only be used in connection
+with services provided by OneSignal.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#import <Foundation/Foundation.h>
+
+#ifndef OSTuningConfig_h
+#define OSTuningConfig_h
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ Throughput and battery knobs for the request and delta pipelines.
+ Values come from the OneSignal_sdk_tuning Info.plist dictionary, then the sdk_tuning dictionary of the iOS params,
+ then the compile-time defaults. Out of range values are clamped so a bad config cannot stall a pipeline.
+ The last remote tuning is persisted, since some values such as timeouts are only read when the URL session is created.
+ */
+@interface OSTuningConfig : NSObject
+
++ (OSTuningConfig *)sharedConfig;
+
+// Operation repo, defaults to POLL_INTERVAL_MS and OP_REPO_FLUSH_DELTA_THRESHOLD
+@property (nonatomic, readonly) NSInteger operationRepoFlushDelayMilliseconds;
+@property (nonatomic, readonly) NSInteger operationRepoFlushThreshold;
+
+// Requests each user executor sends at a time, defaults to OS_EXECUTOR_MAX_IN_FLIGHT_REQUESTS
+@property (nonatomic, readonly) NSInteger executorMaxInFlightRequests;
+
+// Outcome events buffered before a flush, defaults to OS_OUTCOME_BUFFER_FLUSH_SIZE
+@property (nonatomic, readonly) NSInteger outcomeBatchSize;
+
+// Request retry policy, defaults to MAX_ATTEMPT_COUNT, REATTEMPT_DELAY and REATTEMPT_MAX_DELAY
+@property (nonatomic, readonly) NSInteger requestMaxAttempts;
+@property (nonatomic, readonly) NSTimeInterval requestRetryDelay;
+@property (nonatomic, readonly) NSTimeInterval requestMaxRetryDelay;
+
+// URL session, defaults to REQUEST_TIMEOUT_REQUEST, REQUEST_TIMEOUT_RESOURCE and OS_HTTP_MAX_CONNECTIONS_PER_HOST
+@property (nonatomic, readonly) NSTimeInterval requestTimeout;
+@property (nonatomic, readonly) NSTimeInterval resourceTimeout;
+@property (nonatomic, readonly) NSInteger httpMaxConnectionsPerHost;
+
+// For knobs owned by other modules, such as in-app message prefetching, which keep their defaults in their own defines
+- (NSInteger)integerForKey:(NSString *)key defaultValue:(NSInteger)defaultValue minimum:(NSInteger)minimum maximum:(NSInteger)maximum;
+- (double)doubleForKey:(NSString *)key defaultValue:(double)defaultValue minimum:(double)minimum maximum:(double)maximum;
+
+// The sdk_tuning dictionary of the iOS params, nil or a non dictionary clears the remote tuning
+- (void)applyRemoteTuning:(id _Nullable)tuning;
+
+@end
+
+NS_ASSUME_NONNULL_END
+
+#endif /* OSTuningConfig_h */
@@ -0,0 +1,152 @@
+/**
+Modified MIT License
+
+Copyright 2024 OneSignal
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+1. The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+2. All copies of substantial portions of the Software may only be used in connection
+with services provided by OneSignal.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#import <Foundation/Foundation.h>
+#import "OSTuningConfig.h"
+#import "OneSignalCommonDefines.h"
+#import "OneSignalUserDefaults.h"
+#import "OneSignalLog.h"
+
+@interface OSTuningConfig ()
+@property (strong, nonatomic) NSDictionary *appTuning;
+@property (strong, nonatomic) NSDictionary *remoteTuning;
+@end
+
+@implementation OSTuningConfig
+
++ (OSTuningConfig *)sharedConfig {
+    static OSTuningConfig *sharedConfig;
+    static dispatch_once_t once;
+    dispatch_once(&once, ^{
+        sharedConfig = [OSTuningConfig new];
+    });
+    return sharedConfig;
+}
+
+- (instancetype)init {
+    if (self = [super init]) {
+        id appTuning = [[NSBundle mainBundle] objectForInfoDictionaryKey:ONESIGNAL_SDK_TUNING];
+        _appTuning = [appTuning isKindOfClass:[NSDictionary class]] ? appTuning : @{};
+        _remoteTuning = [OneSignalUserDefaults.initStandard getSavedDictionaryForKey:OSUD_SDK_TUNING defaultValue:@{}];
+    }
+    return self;
+}
+
+- (void)applyRemoteTuning:(id)tuning {
+    NSMutableDictionary *remoteTuning = [NSMutableDictionary new];
+    if ([tuning isKindOfClass:[NSDictionary class]]) {
+        // Only numbers are kept, so the saved dictionary never holds NSNull or nested values
+        [(NSDictionary *)tuning enumerateKeysAndObjectsUsingBlock:^(id key, id value, BOOL *stop) {
+            if ([key isKindOfClass:[NSString class]] && [value isKindOfClass:[NSNumber class]]) {
+                remoteTuning[key] = value;
+            }
+        }];
+    }
+    
+    NSDictionary *snapshot = [remoteTuning copy];
+    @synchronized (self) {
+        if ([snapshot isEqualToDictionary:_remoteTuning]) {
+            return;
+        }
+        _remoteTuning = snapshot;
+    }
+    [OneSignalUserDefaults.initStandard saveDictionaryForKey:OSUD_SDK_TUNING withValue:snapshot];
+    [OneSignalLog onesignalLog:ONE_S_LL_VERBOSE message:[NSString stringWithFormat:@"Applied SDK tuning: %@", snapshot]];
+}
+
+- (NSNumber *)numberForKey:(NSString *)key {
+    NSDictionary *appTuning;
+    NSDictionary *remoteTuning;
+    @synchronized (self) {
+        appTuning = _appTuning;
+        remoteTuning = _remoteTuning;
+    }
+    // The app's own Info.plist value wins, it knows its constraints better than a segment wide remote value
+    id value = appTuning[key];
+    if (![value isKindOfClass:[NSNumber class]]) {
+        value = remoteTuning[key];
+    }
+    return [value isKindOfClass:[NSNumber class]] ? value : nil;
+}
+
+- (NSInteger)integerForKey:(NSString *)key defaultValue:(NSInteger)defaultValue minimum:(NSInteger)minimum maximum:(NSInteger)maximum {
+    NSNumber *value = [self numberForKey:key];
+    if (!value) {
+        return defaultValue;
+    }
+    return MIN(MAX(value.integerValue, minimum), maximum);
+}
+
+- (double)doubleForKey:(NSString *)key defaultValue:(double)defaultValue minimum:(double)minimum maximum:(double)maximum {
+    NSNumber *value = [self numberForKey:key];
+    if (!value || isnan(value.doubleValue)) {
+        return defaultValue;
+    }
+    return MIN(MAX(value.doubleValue, minimum), maximum);
+}
+
+- (NSInteger)operationRepoFlushDelayMilliseconds {
+    return [self integerForKey:OS_TUNING_OP_REPO_FLUSH_DELAY_MS defaultValue:POLL_INTERVAL_MS minimum:0 maximum:60000];
+}
+
+- (NSInteger)operationRepoFlushThreshold {
+    return [self integerForKey:OS_TUNING_OP_REPO_FLUSH_THRESHOLD defaultValue:OP_REPO_FLUSH_DELTA_THRESHOLD minimum:1 maximum:1000];
+}
+
+- (NSInteger)executorMaxInFlightRequests {
+    return [self integerForKey:OS_TUNING_EXECUTOR_MAX_IN_FLIGHT_REQUESTS defaultValue:OS_EXECUTOR_MAX_IN_FLIGHT_REQUESTS minimum:1 maximum:16];
+}
+
+- (NSInteger)outcomeBatchSize {
+    return [self integerForKey:OS_TUNING_OUTCOME_BATCH_SIZE defaultValue:OS_OUTCOME_BUFFER_FLUSH_SIZE minimum:1 maximum:100];
+}
+
+- (NSInteger)requestMaxAttempts {
+    return [self integerForKey:OS_TUNING_REQUEST_MAX_ATTEMPTS defaultValue:MAX_ATTEMPT_COUNT minimum:1 maximum:10];
+}
+
+- (NSTimeInterval)requestRetryDelay {
+    return [self doubleForKey:OS_TUNING_REQUEST_RETRY_DELAY defaultValue:REATTEMPT_DELAY minimum:0 maximum:REATTEMPT_MAX_DELAY];
+}
+
+- (NSTimeInterval)requestMaxRetryDelay {
+    return [self doubleForKey:OS_TUNING_REQUEST_MAX_RETRY_DELAY defaultValue:REATTEMPT_MAX_DELAY minimum:0 maximum:3600];
+}
+
+- (NSTimeInterval)requestTimeout {
+    return [self doubleForKey:OS_TUNING_REQUEST_TIMEOUT defaultValue:REQUEST_TIMEOUT_REQUEST minimum:5 maximum:300];
+}
+
+- (NSTimeInterval)resourceTimeout {
+    return [self doubleForKey:OS_TUNING_RESOURCE_TIMEOUT defaultValue:REQUEST_TIMEOUT_RESOURCE minimum:5 maximum:600];
+}
+
+- (NSInteger)httpMaxConnectionsPerHost {
+    return [self integerForKey:OS_TUNING_HTTP_MAX_CONNECTIONS_PER_HOST defaultValue:OS_HTTP_MAX_CONNECTIONS_PER_HOST minimum:1 maximum:8];
+}
+
+@end
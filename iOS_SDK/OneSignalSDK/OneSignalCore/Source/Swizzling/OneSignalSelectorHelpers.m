@@ -29,6 +29,7 @@
 #import <objc/runtime.h>
 
 #import "OneSignalSelectorHelpers.h"
+#import "SwizzlingForwarder.h"
 
 BOOL injectSelector(Class targetClass, SEL targetSelector, Class myClass, SEL mySelector) {
     Method newMeth = class_getInstanceMethod(myClass, mySelector);
@@ -59,5 +60,8 @@ BOOL injectSelector(Class targetClass, SEL targetSelector, Class myClass, SEL my
     else
         class_addMethod(targetClass, targetSelector, newImp, methodTypeEncoding);
     
+    // When there was an original implementation mySelector now holds it, which is what forwarded calls run
+    [SwizzlingForwarder cacheImplementationOfSelector:mySelector onClass:targetClass];
+    
     return existing;
 }
@@ -23,6 +23,13 @@ NS_ASSUME_NONNULL_BEGIN
              withYourSelector:(SEL)yourSelector
          withOriginalSelector:(SEL)originalSelector;
 
+/**
+ Resolves the implementation forwarded calls to the selector on the class will use.
+ Call after swizzling the class, the forwarder otherwise resolves it on the first call.
+ Implementations are cached per class and selector, so later forwards are a direct call.
+ */
++(void)cacheImplementationOfSelector:(SEL)selector onClass:(Class)cls;
+
 /**
  Optionally call before invokeWithArgs to know it will execute anything.
  */
@@ -1,8 +1,75 @@
+#import <objc/runtime.h>
 #import "SwizzlingForwarder.h"
 
+// The most arguments a forwarded selector can take and still be called directly
+#define MAX_DIRECT_ARGUMENTS 3
+
+typedef void (*OSForwardedImp0)(id, SEL);
+typedef void (*OSForwardedImp1)(id, SEL, id);
+typedef void (*OSForwardedImp2)(id, SEL, id, id);
+typedef void (*OSForwardedImp3)(id, SEL, id, id, id);
+
+// The resolved implementation of a selector on a class
+@interface OSForwardedImplementation : NSObject {
+    @public
+    // NULL when the selector has to go through NSInvocation
+    IMP imp;
+    NSUInteger argumentCount;
+}
+@end
+
+@implementation OSForwardedImplementation
+@end
+
 @implementation SwizzlingForwarder {
     id targetObject;
     SEL targetSelector;
+    OSForwardedImplementation *implementation;
+}
+
+/*
+ Only void selectors whose arguments are all objects or blocks can be called through a plain function pointer.
+ Anything else keeps going through NSInvocation.
+ */
++ (OSForwardedImplementation *)resolveSelector:(SEL)selector onClass:(Class)cls {
+    OSForwardedImplementation *resolved = [OSForwardedImplementation new];
+    Method method = class_getInstanceMethod(cls, selector);
+    if (!method)
+        return resolved;
+
+    NSMethodSignature *signature = [NSMethodSignature signatureWithObjCTypes:method_getTypeEncoding(method)];
+    NSUInteger argumentCount = signature.numberOfArguments - 2;
+    if (signature.methodReturnType[0] != 'v' || argumentCount > MAX_DIRECT_ARGUMENTS)
+        return resolved;
+    for (NSUInteger i = 0; i < argumentCount; i++) {
+        if ([signature getArgumentTypeAtIndex:i + 2][0] != '@')
+            return resolved;
+    }
+
+    resolved->imp = method_getImplementation(method);
+    resolved->argumentCount = argumentCount;
+    return resolved;
+}
+
+// A swizzle made after the implementation was resolved, including by another SDK, moves the class on to a different one
++ (BOOL)isImplementation:(OSForwardedImplementation *)resolved currentForSelector:(SEL)selector onClass:(Class)cls {
+    return !resolved->imp || resolved->imp == class_getMethodImplementation(cls, selector);
+}
+
+// Cached on the class itself, keyed by the selector
++ (OSForwardedImplementation *)implementationForSelector:(SEL)selector onClass:(Class)cls {
+    @synchronized (self) {
+        OSForwardedImplementation *resolved = objc_getAssociatedObject(cls, selector);
+        if (!resolved || ![self isImplementation:resolved currentForSelector:selector onClass:cls]) {
+            resolved = [self resolveSelector:selector onClass:cls];
+            objc_setAssociatedObject(cls, selector, resolved, OBJC_ASSOCIATION_RETAIN_NONATOMIC);
+        }
+        return resolved;
+    }
+}
+
++ (void)cacheImplementationOfSelector:(SEL)selector onClass:(Class)cls {
+    [self implementationForSelector:selector onClass:cls];
 }
 
 -(instancetype)initWithTarget:(id)object
@@ -26,6 +93,9 @@
         }
     }
 
+    if (targetObject)
+        implementation = [SwizzlingForwarder implementationForSelector:targetSelector onClass:object_getClass(targetObject)];
+
     return self;
 }
 
@@ -52,6 +122,27 @@
     if (!targetObject)
         return;
 
+    Class targetClass = object_getClass(targetObject);
+    if (![SwizzlingForwarder isImplementation:implementation currentForSelector:targetSelector onClass:targetClass])
+        implementation = [SwizzlingForwarder implementationForSelector:targetSelector onClass:targetClass];
+
+    if (implementation->imp && args.count == implementation->argumentCount) {
+        switch (implementation->argumentCount) {
+            case 0:
+                ((OSForwardedImp0)implementation->imp)(targetObject, targetSelector);
+                return;
+            case 1:
+                ((OSForwardedImp1)implementation->imp)(targetObject, targetSelector, args[0]);
+                return;
+            case 2:
+                ((OSForwardedImp2)implementation->imp)(targetObject, targetSelector, args[0], args[1]);
+                return;
+            case 3:
+                ((OSForwardedImp3)implementation->imp)(targetObject, targetSelector, args[0], args[1], args[2]);
+                return;
+        }
+    }
+
     [SwizzlingForwarder
         callSelector:targetSelector
         onObject:targetObject
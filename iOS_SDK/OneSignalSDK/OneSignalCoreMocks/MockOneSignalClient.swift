@@ -46,6 +46,25 @@ public class MockOneSignalClient: NSObject, IOneSignalClient {
 
     public var allRequestsHandled = true
 
+    // MARK: Simulated network conditions, for load testing
+
+    /// Server latencies in milliseconds, one is picked at random per request. Takes precedence over `executeInstantaneously` when not empty.
+    public var latencies: [Int] = []
+    /// The probability, from 0 to 1, that a request fails with `simulatedErrorStatusCode`
+    public var errorRate: Double = 0
+    public var simulatedErrorStatusCode = 500
+    /// Fails every request with status code 0, as a request made without connectivity does
+    public var isOffline = false
+    /// Latencies and errors are picked with a seeded generator, so a load test replays the same way each run
+    public var randomSeed: UInt64 = 0 {
+        didSet {
+            lock.withLock {
+                randomGenerator = MockRandomNumberGenerator(seed: randomSeed)
+            }
+        }
+    }
+    var randomGenerator = MockRandomNumberGenerator(seed: 0)
+
     /** May add to or change this default remote params response*/
     public func getRemoteParamsResponse() -> [String: Any] {
         return remoteParamsResponse ?? [
@@ -88,12 +107,22 @@ public class MockOneSignalClient: NSObject, IOneSignalClient {
         remoteParamsResponse = nil
         shouldUseProvisionalAuthorization = false
         remoteParamsOutcomes = [:]
+        latencies = []
+        errorRate = 0
+        simulatedErrorStatusCode = 500
+        isOffline = false
+        randomSeed = 0
     }
 
     public func execute(_ request: OneSignalRequest, onSuccess successBlock: @escaping OSResultSuccessBlock, onFailure failureBlock: @escaping OSClientFailureBlock) {
         print("🧪 MockOneSignalClient execute called")
 
-        if executeInstantaneously {
+        if !latencies.isEmpty {
+            let latency = lock.withLock { latencies.randomElement(using: &randomGenerator) ?? 0 }
+            executionQueue.asyncAfter(deadline: .now() + .milliseconds(latency)) {
+                self.finishExecutingRequest(request, onSuccess: successBlock, onFailure: failureBlock)
+            }
+        } else if executeInstantaneously {
             finishExecutingRequest(request, onSuccess: successBlock, onFailure: failureBlock)
         } else {
             executionQueue.asyncAfter(deadline: .now() + .milliseconds(50)) {
@@ -129,6 +158,11 @@ public class MockOneSignalClient: NSObject, IOneSignalClient {
 
         self.didCompleteRequest(request)
 
+        if let error = simulatedFailure() {
+            failureBlock(error)
+            return
+        }
+
         let stringifiedRequest = stringify(request)
         // Switch between types of requests with mock responses
         if request.isKind(of: OSRequestGetIosParams.self) {
@@ -148,6 +182,17 @@ public class MockOneSignalClient: NSObject, IOneSignalClient {
         }
     }
 
+    func simulatedFailure() -> OneSignalClientError? {
+        if isOffline {
+            return OneSignalClientError(code: 0, message: "Simulated offline request", responseHeaders: nil, response: nil, underlyingError: nil)
+        }
+        let failed = lock.withLock { errorRate > 0 && Double.random(in: 0..<1, using: &randomGenerator) < errorRate }
+        guard failed else {
+            return nil
+        }
+        return OneSignalClientError(code: simulatedErrorStatusCode, message: "Simulated server error", responseHeaders: nil, response: nil, underlyingError: nil)
+    }
+
     func didCompleteRequest(_ request: OneSignalRequest) {
         networkRequestCount += 1
 
@@ -171,6 +216,23 @@ public class MockOneSignalClient: NSObject, IOneSignalClient {
     }
 }
 
+/// SplitMix64, small and fast, for reproducible simulated network conditions
+struct MockRandomNumberGenerator: RandomNumberGenerator {
+    private var state: UInt64
+
+    init(seed: UInt64) {
+        state = seed
+    }
+
+    mutating func next() -> UInt64 {
+        state &+= 0x9E3779B97F4A7C15
+        var z = state
+        z = (z ^ (z >> 30)) &* 0xBF58476D1CE4E5B9
+        z = (z ^ (z >> 27)) &* 0x94D049BB133111EB
+        return z ^ (z >> 31)
+    }
+}
+
 // MARK: - Asserts
 
 extension MockOneSignalClient {
@@ -0,0 +1,115 @@
+/*
+ Modified MIT License
+
+ Copyright 2024 OneSignal
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ 1. The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ 2. All copies of substantial portions of the Software may only be used in connection
+ with services provided by OneSignal.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ */
+
+import OneSignalOSCore
+
+/**
+ A clock that only moves when the test advances it. Delayed work scheduled through its queues runs in deadline order
+ as virtual time passes, so scenarios spanning hours of debounce windows and retries run in milliseconds.
+ */
+public class MockVirtualClock {
+    private struct ScheduledWork {
+        let deadline: UInt64
+        let sequence: Int
+        let target: DispatchQueue
+        let work: () -> Void
+    }
+
+    private let lock = NSRecursiveLock()
+    private var scheduled: [ScheduledWork] = []
+    private var sequence = 0
+
+    /// Nanoseconds of virtual time elapsed since the clock was created.
+    public private(set) var nowNanoseconds: UInt64 = 0
+
+    public init() {}
+
+    /**
+     Returns a queue that runs immediate work on `target` as usual and holds delayed work until the clock reaches its deadline.
+     Delayed work also runs on `target`, so it stays serialized with the rest of the owner's work.
+     */
+    public func queue(target: DispatchQueue) -> OSDispatchQueue {
+        return MockVirtualTimeDispatchQueue(clock: self, target: target)
+    }
+
+    /**
+     Moves the clock forward, running all work that comes due in order, including work scheduled by that work.
+     Must not be called from a target queue.
+     */
+    public func advance(by interval: TimeInterval) {
+        let end = lock.withLock { nowNanoseconds + UInt64(max(interval, 0) * Double(NSEC_PER_SEC)) }
+        while let next = popWork(dueBy: end) {
+            next.target.sync(execute: next.work)
+        }
+        lock.withLock { nowNanoseconds = end }
+    }
+
+    /// The number of delayed work items that have not come due yet.
+    public var pendingCount: Int {
+        return lock.withLock { scheduled.count }
+    }
+
+    fileprivate func schedule(after delayNanoseconds: UInt64, target: DispatchQueue, work: @escaping () -> Void) {
+        lock.withLock {
+            sequence += 1
+            scheduled.append(ScheduledWork(deadline: nowNanoseconds + delayNanoseconds, sequence: sequence, target: target, work: work))
+        }
+    }
+
+    private func popWork(dueBy end: UInt64) -> ScheduledWork? {
+        return lock.withLock {
+            guard let index = scheduled.indices.min(by: { (scheduled[$0].deadline, scheduled[$0].sequence) < (scheduled[$1].deadline, scheduled[$1].sequence) }),
+                  scheduled[index].deadline <= end else {
+                return nil
+            }
+            let work = scheduled.remove(at: index)
+            nowNanoseconds = max(nowNanoseconds, work.deadline)
+            return work
+        }
+    }
+}
+
+private class MockVirtualTimeDispatchQueue: OSDispatchQueue {
+    private let clock: MockVirtualClock
+    private let target: DispatchQueue
+
+    init(clock: MockVirtualClock, target: DispatchQueue) {
+        self.clock = clock
+        self.target = target
+    }
+
+    func async(execute work: @escaping @convention(block) () -> Void) {
+        target.async(execute: work)
+    }
+
+    func asyncAfterTime(deadline: DispatchTime, execute work: @escaping @Sendable @convention(block) () -> Void) {
+        // Callers compute deadlines from the wall clock, only the delay they asked for is kept
+        let now = DispatchTime.now().uptimeNanoseconds
+        let delay = deadline.uptimeNanoseconds > now ? deadline.uptimeNanoseconds - now : 0
+        clock.schedule(after: delay, target: target, work: work)
+    }
+}
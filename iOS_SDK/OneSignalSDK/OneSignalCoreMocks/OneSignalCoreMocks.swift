@@ -28,6 +28,9 @@ import XCTest
 public class OneSignalCoreMocks: NSObject {
     @objc
     public static func clearUserDefaults() {
+        OneSignalUserDefaults.discardPendingWrites()
+        OSSharedStateSnapshot.discardSnapshot()
+
         if let userDefaults = OneSignalUserDefaults.initStandard().userDefaults {
             let dictionary = userDefaults.dictionaryRepresentation()
             for key in dictionary.keys {
@@ -41,6 +44,7 @@ public class OneSignalCoreMocks: NSObject {
                 sharedUserDefaults.removeObject(forKey: key)
             }
         }
+        OSPrivacyConsentController.reloadPrivacyConsentState()
     }
 
     /** Wait specified number of seconds for any async methods to run */
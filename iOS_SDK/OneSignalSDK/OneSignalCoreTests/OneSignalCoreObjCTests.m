@@ -26,12 +26,98 @@
  */
 
 #import <XCTest/XCTest.h>
+#import <objc/runtime.h>
+#import <notify.h>
+#import <sys/stat.h>
 #import <OneSignalCore/OneSignalCore.h>
+#import "OneSignalReachability.h"
 
 @interface OneSignalCoreObjCTests : XCTestCase
 
 @end
 
+@interface OneSignalClient (Tests)
+@property (strong, nonatomic) OneSignalReachability *reachability;
+- (void)decodeJSONNSURLResponse:(NSURLResponse*)response data:(NSData*)data error:(NSError*)error isAsync:(BOOL)async withRequest:(OneSignalRequest *)request onSuccess:(OSResultSuccessBlock)successBlock onFailure:(OSClientFailureBlock)failureBlock;
+- (BOOL)isReachable;
+- (BOOL)sendsAsBackgroundUpload:(OneSignalRequest *)request;
+- (NSURLSessionConfiguration *)sessionConfiguration;
+@end
+
+// A reachable path in Low Data Mode
+@interface ConstrainedReachability : OneSignalReachability
+@end
+
+@implementation ConstrainedReachability
+
+- (NetworkStatus)currentReachabilityStatus {
+    return ReachableViaWiFi;
+}
+
+- (BOOL)isConstrained {
+    return YES;
+}
+
+@end
+
+@interface OSSharedStateSnapshot (Tests)
++ (NSData *)dataForValues:(NSDictionary<NSString *, id> *)values;
++ (NSDictionary<NSString *, id> *)valuesFromData:(NSData *)data;
++ (NSString *)path;
+@end
+
+@interface OSURLPrewarmer (Tests)
++ (NSString *)claimHostOfURLString:(NSString *)urlString;
+@end
+
+// Stands in for an app delegate with its own implementation of a swizzled selector
+@interface SwizzlingForwarderTestTarget : NSObject
+@property (nonatomic) NSUInteger calls;
+- (void)forwarderTest:(id)first second:(id)second third:(id)third;
+@end
+
+@implementation SwizzlingForwarderTestTarget
+- (void)forwarderTest:(id)first second:(id)second third:(id)third {
+    self.calls++;
+}
+@end
+
+// Stands in for a module that registers itself from +load
+@interface ModuleRegistryTestModule : NSObject
+@end
+
+@implementation ModuleRegistryTestModule
+@end
+
+// Swizzled by the test itself, after the forwarder resolved its implementation
+@interface SwizzlingForwarderLateSwizzleTarget : NSObject
+@property (nonatomic) NSUInteger calls;
+- (void)lateSwizzleTest:(id)first;
+@end
+
+@implementation SwizzlingForwarderLateSwizzleTarget
+- (void)lateSwizzleTest:(id)first {
+    self.calls++;
+}
+@end
+
+// Counts the purges it is asked to do
+@interface MemoryPressureTestResponder : NSObject <OSMemoryPressureResponder>
+@property (nonatomic) NSUInteger purges;
+@end
+
+@implementation MemoryPressureTestResponder
+- (void)purgeForMemoryPressure {
+    self.purges++;
+}
+@end
+
+#define SWIZZLING_FORWARDER_ITERATIONS 10000
+
+// Worst case notification payloads must parse far inside the NSE's time, which is about 30 seconds
+#define OS_FUZZ_NOTIFICATION_ITERATIONS 100
+#define OS_FUZZ_NOTIFICATION_PARSE_BUDGET_SECONDS 0.25
+
 @implementation OneSignalCoreObjCTests
 
 - (void)setUp {
@@ -52,4 +138,487 @@
     XCTAssertEqualObjects(@"test", stringResult);
 }
 
+- (void)testOSNetworkingUtils_gzipData_producesSmallerGzipStream {
+    NSMutableString *json = [NSMutableString stringWithString:@"{\"tags\":{"];
+    for (int i = 0; i < 200; i++)
+        [json appendFormat:@"\"tag_%d\":\"value\",", i];
+    [json appendString:@"\"last\":\"value\"}}"];
+    NSData *body = [json dataUsingEncoding:NSUTF8StringEncoding];
+
+    NSData *compressed = [OSNetworkingUtils gzipData:body];
+    XCTAssertNotNil(compressed);
+    XCTAssertLessThan(compressed.length, body.length);
+    // Every gzip stream starts with the magic bytes 1f 8b
+    const uint8_t *bytes = compressed.bytes;
+    XCTAssertEqual(bytes[0], 0x1f);
+    XCTAssertEqual(bytes[1], 0x8b);
+    // The trailer ends with the uncompressed size, and the stream between header and trailer inflates back to the body
+    uint32_t size = bytes[compressed.length - 4] | bytes[compressed.length - 3] << 8 | bytes[compressed.length - 2] << 16 | (uint32_t)bytes[compressed.length - 1] << 24;
+    XCTAssertEqual(size, body.length);
+    NSData *deflated = [compressed subdataWithRange:NSMakeRange(10, compressed.length - 18)];
+    XCTAssertEqualObjects([deflated decompressedDataUsingAlgorithm:NSDataCompressionAlgorithmZlib error:nil], body);
+
+    XCTAssertNil([OSNetworkingUtils gzipData:[NSData data]]);
+}
+
+- (void)testOSNetworkingUtils_defaultSessionConfiguration_isWhatTheClientStartsFrom {
+    OSTuningConfig *tuning = OSTuningConfig.sharedConfig;
+    NSURLSessionConfiguration *shared = [OSNetworkingUtils defaultSessionConfiguration];
+    XCTAssertEqual(shared.timeoutIntervalForRequest, tuning.requestTimeout);
+    XCTAssertEqual(shared.timeoutIntervalForResource, tuning.resourceTimeout);
+    XCTAssertEqual(shared.HTTPMaximumConnectionsPerHost, tuning.httpMaxConnectionsPerHost);
+    XCTAssertTrue(shared.HTTPShouldUsePipelining);
+
+    NSURLSessionConfiguration *client = [[OneSignalClient new] sessionConfiguration];
+    XCTAssertEqual(client.timeoutIntervalForRequest, shared.timeoutIntervalForRequest);
+    XCTAssertEqual(client.timeoutIntervalForResource, shared.timeoutIntervalForResource);
+    XCTAssertEqual(client.HTTPMaximumConnectionsPerHost, shared.HTTPMaximumConnectionsPerHost);
+    XCTAssertTrue(client.HTTPShouldUsePipelining);
+    // The client's own settings are added on top
+    XCTAssertTrue(client.waitsForConnectivity);
+}
+
+- (void)testOneSignalRequest_urlRequestIsReusedUntilParametersChange {
+    OneSignalRequest *request = [OneSignalRequest new];
+    request.path = @"apps/test/outcomes";
+    request.method = POST;
+    request.parameters = @{@"app_id" : @"test", @"id" : @"first"};
+    
+    NSMutableURLRequest *first = request.urlRequest;
+    first.cachePolicy = NSURLRequestReloadIgnoringLocalCacheData;
+    NSMutableURLRequest *second = request.urlRequest;
+    
+    // Each read is a copy of the same encoded request, changes to one copy stay out of the next
+    XCTAssertEqualObjects(first.HTTPBody, second.HTTPBody);
+    XCTAssertNotEqual(second.cachePolicy, NSURLRequestReloadIgnoringLocalCacheData);
+    
+    request.parameters = @{@"app_id" : @"test", @"id" : @"second"};
+    NSDictionary *body = [NSJSONSerialization JSONObjectWithData:request.urlRequest.HTTPBody options:0 error:nil];
+    XCTAssertEqualObjects(body[@"id"], @"second");
+}
+
+- (void)testIso8601DateFormatter_isSharedAndRoundTrips {
+    NSDateFormatter *formatter = [NSDateFormatter iso8601DateFormatter];
+    XCTAssertEqual(formatter, [NSDateFormatter iso8601DateFormatter]);
+    
+    NSDate *date = [formatter dateFromString:@"2024-05-01T12:30:45.250+00:00"];
+    XCTAssertNotNil(date);
+    XCTAssertEqualObjects([formatter stringFromDate:date], @"2024-05-01T12:30:45.250Z");
+}
+
+- (void)testSwizzlingForwarder_forwardsToTheOriginalImplementation {
+    SwizzlingForwarderTestTarget *target = [SwizzlingForwarderTestTarget new];
+    SwizzlingForwarder *forwarder = [[SwizzlingForwarder alloc] initWithTarget:target withYourSelector:@selector(forwarderTest:second:third:) withOriginalSelector:@selector(forwarderTest:second:third:)];
+    XCTAssertTrue(forwarder.hasReceiver);
+    
+    [forwarder invokeWithArgs:@[@1, @2, @3]];
+    [forwarder invokeWithArgs:@[@1, @2, @3]];
+    XCTAssertEqual(target.calls, 2);
+}
+
+- (void)testSwizzlingForwarder_callsASwizzleMadeAfterItResolved {
+    SwizzlingForwarderLateSwizzleTarget *target = [SwizzlingForwarderLateSwizzleTarget new];
+    SwizzlingForwarder *forwarder = [[SwizzlingForwarder alloc] initWithTarget:target withYourSelector:@selector(lateSwizzleTest:) withOriginalSelector:@selector(lateSwizzleTest:)];
+    [forwarder invokeWithArgs:@[@1]];
+    XCTAssertEqual(target.calls, 1);
+    
+    // Such as another SDK swizzling the app delegate after OneSignal did
+    __block NSUInteger swizzledCalls = 0;
+    Method method = class_getInstanceMethod([SwizzlingForwarderLateSwizzleTarget class], @selector(lateSwizzleTest:));
+    method_setImplementation(method, imp_implementationWithBlock(^(id object, id first) {
+        swizzledCalls++;
+    }));
+    
+    [forwarder invokeWithArgs:@[@1]];
+    [[[SwizzlingForwarder alloc] initWithTarget:target withYourSelector:@selector(lateSwizzleTest:) withOriginalSelector:@selector(lateSwizzleTest:)] invokeWithArgs:@[@1]];
+    XCTAssertEqual(swizzledCalls, 2);
+    XCTAssertEqual(target.calls, 1);
+}
+
+// Baseline for testSwizzlingForwarder_forwarding_performance, calling the same selector without swizzling
+- (void)testSwizzlingForwarder_directCallBaseline_performance {
+    SwizzlingForwarderTestTarget *target = [SwizzlingForwarderTestTarget new];
+    [self measureBlock:^{
+        for (int i = 0; i < SWIZZLING_FORWARDER_ITERATIONS; i++) {
+            [target forwarderTest:@1 second:@2 third:@3];
+        }
+    }];
+}
+
+// A forwarder is created and invoked once per intercepted callback, same as the swizzled delegate methods
+- (void)testSwizzlingForwarder_forwarding_performance {
+    SwizzlingForwarderTestTarget *target = [SwizzlingForwarderTestTarget new];
+    [self measureBlock:^{
+        for (int i = 0; i < SWIZZLING_FORWARDER_ITERATIONS; i++) {
+            SwizzlingForwarder *forwarder = [[SwizzlingForwarder alloc] initWithTarget:target withYourSelector:@selector(forwarderTest:second:third:) withOriginalSelector:@selector(forwarderTest:second:third:)];
+            [forwarder invokeWithArgs:@[@1, @2, @3]];
+        }
+    }];
+}
+
+- (void)testSharedStateSnapshot_encodingRoundTripsAndRejectsTruncatedData {
+    NSDictionary *values = @{
+        OSUD_APP_ID : @"app id",
+        OSUD_RECEIVE_RECEIPTS_ENABLED : @YES,
+        @"integer" : @42,
+        @"double" : @1.5
+    };
+    NSData *data = [OSSharedStateSnapshot dataForValues:values];
+    XCTAssertEqualObjects([OSSharedStateSnapshot valuesFromData:data], values);
+    
+    XCTAssertNil([OSSharedStateSnapshot valuesFromData:[data subdataWithRange:NSMakeRange(0, data.length - 1)]]);
+    XCTAssertNil([OSSharedStateSnapshot valuesFromData:[NSData data]]);
+}
+
+- (void)testMemoryPressureCoordinator_purgesDecodedValuesAndRegisteredResponders {
+    OneSignalUserDefaults *defaults = [OneSignalUserDefaults initStandard];
+    NSString *key = @"memory_pressure_test_key";
+    [defaults saveCodeableDataForKey:key withValue:@[@"value"]];
+    id cached = [defaults getCachedCodeableDataForKey:key defaultValue:nil];
+    XCTAssertTrue([defaults getCachedCodeableDataForKey:key defaultValue:nil] == cached);
+    
+    MemoryPressureTestResponder *responder = [MemoryPressureTestResponder new];
+    [OSMemoryPressureCoordinator addResponder:responder];
+    [OSMemoryPressureCoordinator purge];
+    XCTAssertEqual(responder.purges, 1);
+    
+    // Decoded again, from the same stored data
+    id decoded = [defaults getCachedCodeableDataForKey:key defaultValue:nil];
+    XCTAssertFalse(decoded == cached);
+    XCTAssertEqualObjects(decoded, cached);
+    
+    [OSMemoryPressureCoordinator removeResponder:responder];
+    [OSMemoryPressureCoordinator purge];
+    XCTAssertEqual(responder.purges, 1);
+    [defaults removeValueForKey:key];
+}
+
+// Stands in for another process writing the snapshot file
+- (void)writeSnapshotFileWithValues:(NSDictionary *)values {
+    NSString *path = [OSSharedStateSnapshot path];
+    [[NSFileManager defaultManager] createDirectoryAtPath:[path stringByDeletingLastPathComponent] withIntermediateDirectories:YES attributes:nil error:nil];
+    [[OSSharedStateSnapshot dataForValues:values] writeToFile:path atomically:YES];
+}
+
+- (void)testSharedStateSnapshot_writeKeepsValuesAnotherProcessWrote {
+    XCTSkipIf(![OSSharedStateSnapshot path], @"The test host has no app group container");
+    [OSSharedStateSnapshot discardSnapshot];
+    [OSSharedStateSnapshot setValue:@"app id" forKey:OSUD_APP_ID];
+    [OSSharedStateSnapshot flush];
+    
+    // Another process saves the subscription id while this one has a write pending
+    [OSSharedStateSnapshot setValue:@YES forKey:OSUD_RECEIVE_RECEIPTS_ENABLED];
+    [self writeSnapshotFileWithValues:@{OSUD_APP_ID : @"app id", OSUD_PUSH_SUBSCRIPTION_ID : @"subscription id"}];
+    [OSSharedStateSnapshot flush];
+    
+    NSDictionary *written = [OSSharedStateSnapshot valuesFromData:[NSData dataWithContentsOfFile:[OSSharedStateSnapshot path]]];
+    XCTAssertEqualObjects(written[OSUD_PUSH_SUBSCRIPTION_ID], @"subscription id");
+    XCTAssertEqualObjects(written[OSUD_RECEIVE_RECEIPTS_ENABLED], @YES);
+    XCTAssertEqualObjects(written[OSUD_APP_ID], @"app id");
+    [OSSharedStateSnapshot discardSnapshot];
+}
+
+- (void)testSharedStateSnapshot_isReadAgainAfterAChangeNotification {
+    XCTSkipIf(![OSSharedStateSnapshot path], @"The test host has no app group container");
+    [OSSharedStateSnapshot discardSnapshot];
+    [OSSharedStateSnapshot setValue:@"first" forKey:OSUD_PUSH_SUBSCRIPTION_ID];
+    [OSSharedStateSnapshot flush];
+    id value;
+    XCTAssertTrue([OSSharedStateSnapshot getValue:&value forKey:OSUD_PUSH_SUBSCRIPTION_ID]);
+    XCTAssertEqualObjects(value, @"first");
+    
+    // Rewritten in place with the old timestamp, so checking the file alone does not see the change
+    NSString *path = [OSSharedStateSnapshot path];
+    struct stat info;
+    XCTAssertEqual(stat(path.fileSystemRepresentation, &info), 0);
+    NSFileHandle *file = [NSFileHandle fileHandleForWritingAtPath:path];
+    [file truncateFileAtOffset:0];
+    [file writeData:[OSSharedStateSnapshot dataForValues:@{OSUD_PUSH_SUBSCRIPTION_ID : @"second"}]];
+    [file closeFile];
+    struct timespec times[2] = {info.st_atimespec, info.st_mtimespec};
+    utimensat(AT_FDCWD, path.fileSystemRepresentation, times, 0);
+    
+    NSUInteger version = [OSSharedStateVersion currentVersion];
+    NSString *name = [NSString stringWithFormat:@"%@.onesignal.shared_state_changed", [OneSignalUserDefaults appGroupName]];
+    notify_post(name.UTF8String);
+    NSDate *deadline = [NSDate dateWithTimeIntervalSinceNow:2];
+    while ([OSSharedStateVersion currentVersion] == version && [deadline timeIntervalSinceNow] > 0)
+        [NSRunLoop.currentRunLoop runUntilDate:[NSDate dateWithTimeIntervalSinceNow:0.01]];
+    
+    XCTAssertTrue([OSSharedStateSnapshot getValue:&value forKey:OSUD_PUSH_SUBSCRIPTION_ID]);
+    XCTAssertEqualObjects(value, @"second");
+    [OSSharedStateSnapshot discardSnapshot];
+}
+
+// The test host is an app, so the version only moves when an extension posts
+- (void)testSharedStateVersion_onlyChangesAfterAnExtensionPosts {
+    // The first check registers for the notification and counts as a change
+    [OSSharedStateVersion currentVersion];
+    NSUInteger version = [OSSharedStateVersion currentVersion];
+    XCTAssertEqual([OSSharedStateVersion currentVersion], version);
+    
+    // The app's own writes are not announced
+    [OSSharedStateVersion postChange];
+    XCTAssertEqual([OSSharedStateVersion currentVersion], version);
+    
+    // Stands in for the notification service extension, notifyd delivers the post asynchronously
+    NSString *name = [NSString stringWithFormat:@"%@.onesignal.shared_state_changed", [OneSignalUserDefaults appGroupName]];
+    notify_post(name.UTF8String);
+    NSDate *deadline = [NSDate dateWithTimeIntervalSinceNow:2];
+    while ([OSSharedStateVersion currentVersion] == version && [deadline timeIntervalSinceNow] > 0)
+        [NSRunLoop.currentRunLoop runUntilDate:[NSDate dateWithTimeIntervalSinceNow:0.01]];
+    NSUInteger changedVersion = [OSSharedStateVersion currentVersion];
+    XCTAssertGreaterThan(changedVersion, version);
+    XCTAssertEqual([OSSharedStateVersion currentVersion], changedVersion);
+}
+
+// The class is internal to OneSignalCore, so it is reached through the runtime
+- (void)testBackgroundUploadSession_usesTheAppGroupContainerAndABoundedTimeout {
+    Class sessionClass = NSClassFromString(@"OSBackgroundUploadSession");
+    XCTAssertNotNil(sessionClass);
+    id uploadSession = [sessionClass valueForKey:@"sharedSession"];
+    NSURLSessionConfiguration *configuration = [uploadSession valueForKeyPath:@"session.configuration"];
+    
+    XCTAssertEqualObjects(configuration.sharedContainerIdentifier, [OneSignalUserDefaults appGroupName]);
+    XCTAssertEqual(configuration.timeoutIntervalForResource, OS_BACKGROUND_UPLOAD_TIMEOUT);
+    XCTAssertLessThanOrEqual(configuration.timeoutIntervalForResource, 60 * 60);
+}
+
+// Decoding a response the size of a large in-app message list
+- (void)testOneSignalClient_decodingALargeResponse_performance {
+    NSMutableArray *messages = [NSMutableArray new];
+    for (int i = 0; i < 500; i++) {
+        [messages addObject:@{
+            @"id" : [NSString stringWithFormat:@"message_%i", i],
+            @"variants" : @{@"ios" : @{@"default" : @"variant", @"en" : @"variant_en"}},
+            @"triggers" : @[@[@{@"id" : @"trigger", @"kind" : @"custom", @"property" : @"level", @"operator" : @"greater", @"value" : @(i)}]],
+            @"redisplay" : @{@"limit" : @10, @"delay" : @60}
+        }];
+    }
+    NSData *data = [NSJSONSerialization dataWithJSONObject:@{@"in_app_messages" : messages} options:0 error:nil];
+    NSHTTPURLResponse *response = [[NSHTTPURLResponse alloc] initWithURL:[NSURL URLWithString:@"https://api.onesignal.com"] statusCode:200 HTTPVersion:@"HTTP/2" headerFields:nil];
+    OneSignalRequest *request = [OneSignalRequest new];
+    
+    [self measureBlock:^{
+        __block NSDictionary *decoded;
+        [[OneSignalClient sharedClient] decodeJSONNSURLResponse:response data:data error:nil isAsync:false withRequest:request onSuccess:^(NSDictionary *result) {
+            decoded = result;
+        } onFailure:nil];
+        XCTAssertEqual([decoded[@"in_app_messages"] count], 500);
+    }];
+}
+
+// Seeded, so a failing payload reproduces
+static uint64_t fuzzRandom(uint64_t *state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return *state;
+}
+
+static id pathologicalPayloadValue(uint64_t *state) {
+    switch (fuzzRandom(state) % 7) {
+        case 0: {
+            NSDictionary *nested = @{@"leaf" : @"value"};
+            for (int i = 0; i < 500; i++)
+                nested = @{@"nested" : nested};
+            return nested;
+        }
+        case 1:
+            return [@"" stringByPaddingToLength:1024 * 1024 withString:@"éx" startingAtIndex:0];
+        case 2: {
+            NSMutableArray *buttons = [NSMutableArray new];
+            for (int i = 0; i < 10000; i++)
+                [buttons addObject:@{@"i" : [NSString stringWithFormat:@"button_%i", i], @"n" : @"Button", @"icon_type" : @"system", @"path" : @"star"}];
+            return buttons;
+        }
+        case 3:
+            return @[@"not a button", @1, [NSNull null], @{@"n" : @"Button", @"icon_type" : @42, @"path" : @"star"}];
+        case 4:
+            return [NSNull null];
+        case 5:
+            return @"not a dictionary";
+        default:
+            return @{};
+    }
+}
+
+- (void)testOSNotification_fuzzingPayloads_parsesWithinBudget {
+    uint64_t state = 0x5eed;
+    NSArray<NSString *> *customKeys = @[@"a", @"u", @"ti", @"tn", @"badge_inc", @"collapse_id"];
+    NSArray<NSString *> *topLevelKeys = @[@"custom", @"buttons", @"att", @"actionSelected"];
+    for (int i = 0; i < OS_FUZZ_NOTIFICATION_ITERATIONS; i++) {
+        @autoreleasepool {
+            NSMutableDictionary *custom = [@{@"i" : [NSString stringWithFormat:@"notification_%i", i], @"a" : @{@"key" : @"value"}} mutableCopy];
+            NSMutableDictionary *payload = [@{
+                @"aps" : @{@"alert" : @{@"title" : @"Title", @"body" : @"Body"}, @"mutable-content" : @1},
+                @"custom" : custom
+            } mutableCopy];
+            custom[customKeys[fuzzRandom(&state) % customKeys.count]] = pathologicalPayloadValue(&state);
+            payload[topLevelKeys[fuzzRandom(&state) % topLevelKeys.count]] = pathologicalPayloadValue(&state);
+
+            NSTimeInterval start = NSProcessInfo.processInfo.systemUptime;
+            OSNotification *notification = [OSNotification parseWithApns:payload];
+            [notification additionalData];
+            [notification actionButtons];
+            NSTimeInterval elapsed = NSProcessInfo.processInfo.systemUptime - start;
+            XCTAssertNotNil(notification);
+            XCTAssertLessThanOrEqual(elapsed, OS_FUZZ_NOTIFICATION_PARSE_BUDGET_SECONDS, @"Payload %i took %.3fs to parse", i, elapsed);
+        }
+    }
+}
+
+- (void)testPendingReceivedNotifications_takeAllReturnsEachAddedNotificationOnce {
+    [OSPendingReceivedNotifications takeAll];
+    [OSPendingReceivedNotifications addNotificationId:@"notification_1"];
+    [OSPendingReceivedNotifications addNotificationId:@"notification_2"];
+
+    NSArray<NSDictionary *> *pending = [OSPendingReceivedNotifications takeAll];
+    XCTAssertEqualObjects([pending valueForKey:@"id"], (@[@"notification_1", @"notification_2"]));
+    XCTAssertNotNil(pending.firstObject[@"timestamp"]);
+    XCTAssertEqual([OSPendingReceivedNotifications takeAll].count, 0);
+}
+
+- (void)testPendingReceivedNotifications_keepsTheNewestWithinTheLimit {
+    [OSPendingReceivedNotifications takeAll];
+    for (int i = 0; i < OS_PENDING_RECEIVED_NOTIFICATIONS_LIMIT + 5; i++)
+        [OSPendingReceivedNotifications addNotificationId:[NSString stringWithFormat:@"notification_%i", i]];
+
+    NSArray<NSDictionary *> *pending = [OSPendingReceivedNotifications takeAll];
+    XCTAssertEqual(pending.count, OS_PENDING_RECEIVED_NOTIFICATIONS_LIMIT);
+    XCTAssertEqualObjects(pending.lastObject[@"id"], ([NSString stringWithFormat:@"notification_%i", OS_PENDING_RECEIVED_NOTIFICATIONS_LIMIT + 4]));
+}
+
+- (void)testOSNotification_buttonsAndAdditionalDataParsedOnFirstRead {
+    NSDictionary *payload = @{
+        @"aps" : @{@"alert" : @"Body", @"mutable-content" : @1},
+        @"os_data" : @{@"i" : [NSUUID UUID].UUIDString, @"buttons" : @[@{@"i" : @"open", @"n" : @"Open"}, @{@"n" : @"Later"}]},
+        @"key" : @"value"
+    };
+    OSNotification *notification = [OSNotification parseWithApns:payload];
+
+    XCTAssertEqualObjects(notification.actionButtons, (@[@{@"id" : @"open", @"text" : @"Open"}, @{@"id" : @"Later", @"text" : @"Later"}]));
+    XCTAssertEqualObjects(notification.additionalData[@"key"], @"value");
+    XCTAssertNil(notification.additionalData[@"os_data"]);
+    // Equal payloads reuse the parsed instance, a changed payload with the same id does not
+    XCTAssertEqual([OSNotification parseWithApns:[payload copy]], notification);
+    NSMutableDictionary *changed = [payload mutableCopy];
+    changed[@"key"] = @"other";
+    XCTAssertEqualObjects([OSNotification parseWithApns:changed].additionalData[@"key"], @"other");
+}
+
+- (void)testRemoteParamsCache_isKeptPerAppIdWithItsETag {
+    OSRemoteParamController *controller = [OSRemoteParamController sharedController];
+    [controller clearCachedRemoteParams];
+    NSDictionary *params = @{@"fba" : @YES, @"provisional_auth" : [NSNull null]};
+
+    XCTAssertTrue([controller cacheRemoteParams:params etag:@"\"v1\"" forAppId:@"app_1"]);
+    XCTAssertEqualObjects([controller cachedRemoteParamsForAppId:@"app_1"], params);
+    XCTAssertEqualObjects([controller cachedRemoteParamsETagForAppId:@"app_1"], @"\"v1\"");
+    XCTAssertNil([controller cachedRemoteParamsForAppId:@"app_2"]);
+    XCTAssertNil([controller cachedRemoteParamsETagForAppId:@"app_2"]);
+
+    // The same params again are not a change, new ones are
+    XCTAssertFalse([controller cacheRemoteParams:[params copy] etag:@"\"v1\"" forAppId:@"app_1"]);
+    XCTAssertTrue([controller cacheRemoteParams:@{@"fba" : @NO} etag:@"\"v2\"" forAppId:@"app_1"]);
+
+    OSRequestGetIosParams *request = [OSRequestGetIosParams withUserId:@"user" appId:@"app_1" etag:[controller cachedRemoteParamsETagForAppId:@"app_1"]];
+    XCTAssertEqualObjects(request.additionalHeaders[@"If-None-Match"], @"\"v2\"");
+    XCTAssertNil([OSRequestGetIosParams withUserId:@"user" appId:@"app_1"].additionalHeaders[@"If-None-Match"]);
+    [controller clearCachedRemoteParams];
+}
+
+- (void)testTrace_measureRunsTheBlockOnceAndIntervalsPairUp {
+    __block int runs = 0;
+    [OSTrace measureInterval:OSTraceIntervalCacheLoad name:@"cache" block:^{
+        runs++;
+    }];
+    XCTAssertEqual(runs, 1);
+
+    // Ending an interval that was never begun, as when tracing is off, does nothing
+    XCTAssertNoThrow([OSTrace endInterval:OSTraceIntervalRequest signpostId:0]);
+    for (NSUInteger interval = OSTraceIntervalInitStage; interval <= OSTraceIntervalIAMEvaluation; interval++) {
+        uint64_t signpostId = [OSTrace beginInterval:interval name:@"interval"];
+        XCTAssertNoThrow([OSTrace endInterval:interval signpostId:signpostId]);
+    }
+    XCTAssertNoThrow([OSTrace event:@"event"]);
+}
+
+- (void)testPrefetchCodeableData_nextReadGetsThePrefetchedObjectOnce {
+    OneSignalUserDefaults *userDefaults = [OneSignalUserDefaults initStandard];
+    NSString *key = @"OS_TEST_PREFETCHED_CODEABLE_DATA";
+    [userDefaults saveCodeableDataForKey:key withValue:@[@"first", @"second"]];
+    [OneSignalUserDefaults purgeDecodedValues];
+
+    [userDefaults prefetchCodeableDataForKeys:@[key, @"OS_TEST_MISSING_KEY"]];
+    NSDictionary<NSString *, NSArray *> *prefetched = [[userDefaults valueForKey:@"prefetchedValues"] copy];
+    XCTAssertEqual(prefetched.count, 1);
+    id read = [userDefaults getSavedCodeableDataForKey:key defaultValue:nil];
+    XCTAssertEqual(read, prefetched[key][1]);
+    XCTAssertEqual([[userDefaults valueForKey:@"prefetchedValues"] count], 0);
+
+    // A prefetched object is not handed out for data written after the prefetch
+    [userDefaults prefetchCodeableDataForKeys:@[key]];
+    [userDefaults saveCodeableDataForKey:key withValue:@[@"third"]];
+    XCTAssertEqualObjects([userDefaults getSavedCodeableDataForKey:key defaultValue:nil], @[@"third"]);
+    [userDefaults removeValueForKey:key];
+}
+
+- (void)testModuleRegistry_registeredClassIsReturnedWithoutALookup {
+    // The location module is not linked into this test target, so only the registration can resolve it
+    [OSModuleRegistry registerModule:OSModuleLocation moduleClass:[ModuleRegistryTestModule class]];
+    
+    XCTAssertEqual([OSModuleRegistry classForModule:OSModuleLocation], [ModuleRegistryTestModule class]);
+    XCTAssertEqual([OSModuleRegistry classForModule:OSModuleLocation], [ModuleRegistryTestModule class]);
+}
+
+- (void)testDeviceProbes_areReadOncePerProcess {
+    NSString *deviceVariant = [OSDeviceUtils getDeviceVariant];
+    XCTAssertNotNil(deviceVariant);
+    // The same string object each time, it is not probed again
+    XCTAssertTrue([OSDeviceUtils getDeviceVariant] == deviceVariant);
+    XCTAssertEqual([OneSignalMobileProvision releaseMode], [OneSignalMobileProvision releaseMode]);
+}
+
+- (void)testURLPrewarmer_resolvesEachWebHostOncePerInterval {
+    [OSURLPrewarmer clearStatics];
+
+    XCTAssertEqualObjects([OSURLPrewarmer claimHostOfURLString:@" https://Example.com/sale?id=1 "], @"example.com");
+    // The same host is not resolved again within OS_URL_PREWARM_HOST_TTL, whatever the path
+    XCTAssertNil([OSURLPrewarmer claimHostOfURLString:@"http://example.com/other"]);
+    XCTAssertEqualObjects([OSURLPrewarmer claimHostOfURLString:@"https://onesignal.com"], @"onesignal.com");
+
+    // Deep links and malformed URLs have no web host to resolve
+    XCTAssertNil([OSURLPrewarmer claimHostOfURLString:@"myapp://product/1"]);
+    XCTAssertNil([OSURLPrewarmer claimHostOfURLString:@"not a url"]);
+    XCTAssertNil([OSURLPrewarmer claimHostOfURLString:@""]);
+    XCTAssertNil([OSURLPrewarmer claimHostOfURLString:nil]);
+
+    [OSURLPrewarmer clearStatics];
+    XCTAssertEqualObjects([OSURLPrewarmer claimHostOfURLString:@"https://example.com"], @"example.com");
+    [OSURLPrewarmer clearStatics];
+}
+
+- (void)testOneSignalClient_inLowDataModeSendsLowPriorityUploadsInTheBackgroundInsteadOfParking {
+    OneSignalClient *client = [OneSignalClient new];
+    client.reachability = [ConstrainedReachability reachabilityForInternetConnection];
+    OneSignalRequest *outcome = [OneSignalRequest new];
+    outcome.method = POST;
+    outcome.priority = OSRequestPriorityLow;
+    OneSignalRequest *fetch = [OneSignalRequest new];
+    fetch.method = GET;
+    fetch.priority = OSRequestPriorityLow;
+    OneSignalRequest *update = [OneSignalRequest new];
+    update.method = PATCH;
+
+    // Nothing is held in memory until Low Data Mode is turned off
+    XCTAssertTrue([client isReachable]);
+    XCTAssertTrue([client sendsAsBackgroundUpload:outcome]);
+    XCTAssertFalse([client sendsAsBackgroundUpload:fetch]);
+    XCTAssertFalse([client sendsAsBackgroundUpload:update]);
+
+    client.reachability = [OneSignalReachability reachabilityForInternetConnection];
+    XCTAssertFalse([client sendsAsBackgroundUpload:outcome]);
+}
+
 @end
@@ -28,6 +28,22 @@
 import XCTest
 import OneSignalCore
 
+private class MockRangeObserver: NSObject {
+    var received: [NSRange] = []
+
+    @objc func onRangeDidChange(_ range: NSValue) {
+        received.append(range.rangeValue)
+    }
+}
+
+private class MockBoolObserver: NSObject {
+    var received: [Bool] = []
+
+    @objc func onBoolDidChange(_ value: Bool) {
+        received.append(value)
+    }
+}
+
 final class OneSignalCoreTests: XCTestCase {
 
     override func setUpWithError() throws {
@@ -73,4 +89,573 @@ final class OneSignalCoreTests: XCTestCase {
         XCTAssertEqual(templateId, "templateId123")
         XCTAssertEqual(templateName, "Template name")
     }
+
+    func testUserDefaultsWriteBehind_readsOwnWritesAndPersistsOnFlush() throws {
+        let userDefaults = OneSignalUserDefaults.initStandard()
+        let key = "testUserDefaultsWriteBehind"
+        userDefaults.removeValue(forKey: key)
+        OneSignalUserDefaults.flushPendingWrites()
+
+        userDefaults.saveString(forKey: key, withValue: "value")
+
+        // Reads see the staged write before it is flushed
+        XCTAssertEqual(userDefaults.getSavedString(forKey: key, defaultValue: nil), "value")
+        XCTAssertEqual(OneSignalUserDefaults.initStandard().getSavedString(forKey: key, defaultValue: nil), "value")
+
+        OneSignalUserDefaults.flushPendingWrites()
+        XCTAssertEqual(userDefaults.userDefaults?.string(forKey: key), "value")
+
+        // Staged removals hide the persisted value
+        userDefaults.removeValue(forKey: key)
+        XCTAssertFalse(userDefaults.keyExists(key))
+        OneSignalUserDefaults.flushPendingWrites()
+        XCTAssertNil(userDefaults.userDefaults?.object(forKey: key))
+    }
+
+    func testUserDefaultsWriteStatistics_countsWritesBytesAndCoalescedFlushesPerKey() throws {
+        let userDefaults = OneSignalUserDefaults.initStandard()
+        let key = "testUserDefaultsWriteStatistics"
+        OneSignalUserDefaults.flushPendingWrites()
+        OneSignalUserDefaults.resetWriteStatistics()
+
+        /* When */
+        userDefaults.saveString(forKey: key, withValue: "1234")
+        userDefaults.saveString(forKey: key, withValue: "12345678")
+        OneSignalUserDefaults.flushPendingWrites()
+
+        /* Then */
+        let statistics = try XCTUnwrap(OneSignalUserDefaults.writeStatistics()[key])
+        XCTAssertEqual(statistics["writes"], 2)
+        XCTAssertEqual(statistics["bytes"], 12)
+        // Both writes were coalesced by the journal into one
+        XCTAssertEqual(statistics["flushes"], 1)
+        XCTAssertNotNil(OneSignalLog.metrics["user_defaults_keys"])
+
+        userDefaults.removeValue(forKey: key)
+        OneSignalUserDefaults.flushPendingWrites()
+        OneSignalUserDefaults.resetWriteStatistics()
+        XCTAssertTrue(OneSignalUserDefaults.writeStatistics().isEmpty)
+    }
+
+    func testUserDefaults_returnsCachedInstances() throws {
+        XCTAssertTrue(OneSignalUserDefaults.initStandard() === OneSignalUserDefaults.initStandard())
+        XCTAssertTrue(OneSignalUserDefaults.initShared() === OneSignalUserDefaults.initShared())
+        XCTAssertFalse(OneSignalUserDefaults.initStandard() === OneSignalUserDefaults.initShared())
+    }
+
+    func testUserDefaults_reusesDecodedCodeableDataUntilItChanges() throws {
+        let userDefaults = OneSignalUserDefaults.initStandard()
+        let key = "testUserDefaultsCachedCodeableData"
+        userDefaults.saveCodeableData(forKey: key, withValue: ["a", "b"])
+
+        let first = userDefaults.getCachedCodeableData(forKey: key, defaultValue: nil) as? NSArray
+        let second = userDefaults.getCachedCodeableData(forKey: key, defaultValue: nil) as? NSArray
+        XCTAssertEqual(first, ["a", "b"])
+        XCTAssertTrue(first === second)
+
+        // A write, also one made by another process, is picked up on the next read
+        userDefaults.userDefaults?.set(NSKeyedArchiver.archivedData(withRootObject: ["c"]), forKey: key)
+        OneSignalUserDefaults.discardPendingWrites()
+        XCTAssertEqual(userDefaults.getCachedCodeableData(forKey: key, defaultValue: nil) as? NSArray, ["c"])
+
+        userDefaults.removeValue(forKey: key)
+        OneSignalUserDefaults.flushPendingWrites()
+    }
+
+    func testUserDefaults_keepsDecodedCodeableDataAcrossFlushesAndDropsItOnWrite() throws {
+        let userDefaults = OneSignalUserDefaults.initStandard()
+        let key = "testUserDefaultsCachedCodeableDataFlush"
+        userDefaults.saveCodeableData(forKey: key, withValue: ["a"])
+        let staged = userDefaults.getCachedCodeableData(forKey: key, defaultValue: nil) as? NSArray
+
+        // The same bytes now come from storage rather than the journal
+        OneSignalUserDefaults.flushPendingWrites()
+        let flushed = userDefaults.getCachedCodeableData(forKey: key, defaultValue: nil) as? NSArray
+        XCTAssertTrue(staged === flushed)
+        XCTAssertTrue(flushed === userDefaults.getCachedCodeableData(forKey: key, defaultValue: nil) as? NSArray)
+
+        userDefaults.saveCodeableData(forKey: key, withValue: ["a"])
+        let rewritten = userDefaults.getCachedCodeableData(forKey: key, defaultValue: nil) as? NSArray
+        XCTAssertEqual(rewritten, ["a"])
+        XCTAssertFalse(flushed === rewritten)
+
+        userDefaults.removeValue(forKey: key)
+        OneSignalUserDefaults.flushPendingWrites()
+    }
+
+    func testConfigManager_awaitsUntilAppIdIsSetAndConsentIsGiven() throws {
+        OneSignalConfigManager.setAppId(nil)
+        XCTAssertTrue(OneSignalConfigManager.shouldAwaitAppIdAndLogMissingPrivacyConsent(forMethod: nil))
+
+        OneSignalConfigManager.setAppId("test-app-id")
+        XCTAssertFalse(OneSignalConfigManager.shouldAwaitAppIdAndLogMissingPrivacyConsent(forMethod: nil))
+
+        OSPrivacyConsentController.setRequiresPrivacyConsent(true)
+        XCTAssertTrue(OSPrivacyConsentController.requiresUserPrivacyConsent())
+        XCTAssertTrue(OneSignalConfigManager.shouldAwaitAppIdAndLogMissingPrivacyConsent(forMethod: nil))
+
+        OSPrivacyConsentController.consentGranted(true)
+        XCTAssertTrue(OSPrivacyConsentController.getPrivacyConsent())
+        XCTAssertFalse(OneSignalConfigManager.shouldAwaitAppIdAndLogMissingPrivacyConsent(forMethod: nil))
+
+        OneSignalUserDefaults.initShared().removeValue(forKey: OSUD_REQUIRES_USER_PRIVACY_CONSENT)
+        OneSignalUserDefaults.initStandard().removeValue(forKey: GDPR_CONSENT_GRANTED)
+        OneSignalUserDefaults.flushPendingWrites()
+        OSPrivacyConsentController.reloadPrivacyConsentState()
+    }
+
+    func testSQLiteStorageEngine_storesRowsAndFallsBackToUserDefaults() throws {
+        let path = (NSTemporaryDirectory() as NSString).appendingPathComponent("\(UUID().uuidString)/OneSignal.sqlite")
+        let fallback = try XCTUnwrap(UserDefaults(suiteName: "testSQLiteStorageEngine"))
+        fallback.set("legacy", forKey: "migrated")
+        defer {
+            fallback.removePersistentDomain(forName: "testSQLiteStorageEngine")
+            try? FileManager.default.removeItem(atPath: (path as NSString).deletingLastPathComponent)
+        }
+        let storage = try XCTUnwrap(OSSQLiteStorageEngine(path: path, fallback: fallback, sharedContainer: true))
+
+        // Keys written before the engine was enabled are still read, and moved into the database
+        XCTAssertEqual(storage.object(forKey: "migrated") as? String, "legacy")
+        XCTAssertNil(fallback.object(forKey: "migrated"))
+        XCTAssertEqual(storage.object(forKey: "migrated") as? String, "legacy")
+
+        let archived = NSKeyedArchiver.archivedData(withRootObject: ["a"])
+        storage.setObject(archived, forKey: "data")
+        storage.setObject(["nested": [1, 2]], forKey: "plist")
+        XCTAssertEqual(storage.object(forKey: "data") as? Data, archived)
+        XCTAssertEqual(storage.object(forKey: "plist") as? NSDictionary, ["nested": [1, 2]])
+
+        XCTAssertEqual((storage as OSStorageEngine).applyChanges?(["migrated": NSNull(), "plist": "replaced"]), true)
+        XCTAssertNil(storage.object(forKey: "migrated"))
+        XCTAssertEqual(storage.object(forKey: "plist") as? String, "replaced")
+
+        // A second connection, as the other process would open, sees the committed rows
+        let other = try XCTUnwrap(OSSQLiteStorageEngine(path: path, fallback: nil, sharedContainer: true))
+        XCTAssertEqual(other.object(forKey: "data") as? Data, archived)
+    }
+
+    func testSQLiteStorageEngine_batchWithAFailedWriteIsRolledBack() throws {
+        let path = (NSTemporaryDirectory() as NSString).appendingPathComponent("\(UUID().uuidString)/OneSignal.sqlite")
+        let fallback = try XCTUnwrap(UserDefaults(suiteName: "testSQLiteStorageEngineRollback"))
+        defer {
+            fallback.removePersistentDomain(forName: "testSQLiteStorageEngineRollback")
+            try? FileManager.default.removeItem(atPath: (path as NSString).deletingLastPathComponent)
+        }
+        let storage = try XCTUnwrap(OSSQLiteStorageEngine(path: path, fallback: fallback, sharedContainer: true))
+        storage.setObject("kept", forKey: "removed")
+        storage.setObject("before", forKey: "replaced")
+
+        // Not a property list, so it can not be written
+        XCTAssertEqual((storage as OSStorageEngine).applyChanges?(["removed": NSNull(), "replaced": "after", "unwritable": NSObject()]), false)
+
+        // None of the batch was committed, the journal writes it key by key instead
+        XCTAssertEqual(storage.object(forKey: "removed") as? String, "kept")
+        XCTAssertEqual(storage.object(forKey: "replaced") as? String, "before")
+        XCTAssertNil(storage.object(forKey: "unwritable"))
+    }
+
+    func testSQLiteStorageEngine_turningItOffMovesTheRowsBackToUserDefaults() throws {
+        let path = (NSTemporaryDirectory() as NSString).appendingPathComponent("\(UUID().uuidString)/OneSignal.sqlite")
+        let userDefaults = try XCTUnwrap(UserDefaults(suiteName: "testSQLiteStorageEngineExport"))
+        defer {
+            userDefaults.removePersistentDomain(forName: "testSQLiteStorageEngineExport")
+            try? FileManager.default.removeItem(atPath: (path as NSString).deletingLastPathComponent)
+        }
+        var storage = OSSQLiteStorageEngine(path: path, fallback: userDefaults, sharedContainer: false)
+        storage?.setObject(["nested": [1, 2]], forKey: "plist")
+        storage = nil
+
+        XCTAssertTrue(OSSQLiteStorageEngine.exportDatabase(atPath: path, to: userDefaults))
+        XCTAssertEqual(userDefaults.object(forKey: "plist") as? NSDictionary, ["nested": [1, 2]])
+        XCTAssertFalse(FileManager.default.fileExists(atPath: path))
+    }
+
+    func testListenerRegistry_firingIteratesASnapshot() throws {
+        let registry = OSListenerRegistry<NSString>()
+        registry.addListener("a")
+        registry.addListener("b")
+
+        let snapshot = registry.listeners
+        registry.removeListener("a")
+        registry.addListener("c")
+
+        // Listeners changed while firing only show up in the next snapshot
+        XCTAssertEqual(snapshot, ["a", "b"])
+        XCTAssertEqual(registry.listeners, ["b", "c"])
+        XCTAssertEqual(registry.count, 2)
+
+        registry.removeAllListeners()
+        XCTAssertEqual(registry.count, 0)
+    }
+
+    func testProcessedNotifications_claimsEachIdOncePerKind() throws {
+        OneSignalUserDefaults.initShared().removeValue(forKey: OSUD_PROCESSED_NOTIFICATION_IDS)
+        // Marker files outlive the test run, so each run claims new ids
+        let notificationId = UUID().uuidString
+
+        XCTAssertTrue(OSProcessedNotifications.claimNotificationId(notificationId, kind: OS_PROCESSED_NOTIFICATION_RECEIVED))
+        XCTAssertFalse(OSProcessedNotifications.claimNotificationId(notificationId, kind: OS_PROCESSED_NOTIFICATION_RECEIVED))
+        XCTAssertTrue(OSProcessedNotifications.wasProcessed(notificationId, kind: OS_PROCESSED_NOTIFICATION_RECEIVED))
+
+        // Being received does not make the notification's open a duplicate
+        XCTAssertFalse(OSProcessedNotifications.wasProcessed(notificationId, kind: OS_PROCESSED_NOTIFICATION_OPENED))
+        XCTAssertTrue(OSProcessedNotifications.claimNotificationId(notificationId, kind: OS_PROCESSED_NOTIFICATION_OPENED))
+
+        OneSignalUserDefaults.initShared().removeValue(forKey: OSUD_PROCESSED_NOTIFICATION_IDS)
+    }
+
+    func testProcessedNotifications_concurrentClaimsOfAnIdSucceedOnce() throws {
+        let notificationId = UUID().uuidString
+        let lock = NSLock()
+        var claims = 0
+        DispatchQueue.concurrentPerform(iterations: 20) { _ in
+            if OSProcessedNotifications.claimNotificationId(notificationId, kind: OS_PROCESSED_NOTIFICATION_RECEIVED) {
+                lock.lock()
+                claims += 1
+                lock.unlock()
+            }
+        }
+        XCTAssertEqual(claims, 1)
+    }
+
+    func testRequestMetrics_bucketsTimingsAndCountsErrorsAndRetries() throws {
+        let metrics = OSRequestMetrics()
+
+        metrics.recordTimings([OS_REQUEST_PHASE_TOTAL: 5, OS_REQUEST_PHASE_TTFB: 30], forRequestType: "OSRequestCreateUser")
+        metrics.recordTimings([OS_REQUEST_PHASE_TOTAL: 20000], forRequestType: "OSRequestCreateUser")
+        metrics.recordCompletion(forRequestType: "OSRequestCreateUser", statusCode: 500)
+        metrics.recordRetry(forRequestType: "OSRequestCreateUser")
+        metrics.recordCompletion(forRequestType: "OSRequestCreateUser", statusCode: 201)
+
+        let createUser = try XCTUnwrap(metrics.snapshot()["OSRequestCreateUser"])
+        XCTAssertEqual(createUser["count"] as? Int, 2)
+        XCTAssertEqual(createUser["retries"] as? Int, 1)
+        XCTAssertEqual(createUser["errors"] as? [String: Int], ["500": 1])
+
+        let histograms = try XCTUnwrap(createUser["histograms"] as? [String: [Int]])
+        let bucketCount = OSRequestMetrics.bucketBounds().count + 1
+        var total = Array(repeating: 0, count: bucketCount)
+        total[0] = 1
+        total[bucketCount - 1] = 1
+        XCTAssertEqual(histograms[OS_REQUEST_PHASE_TOTAL], total)
+        XCTAssertEqual(histograms[OS_REQUEST_PHASE_TTFB]?[2], 1)
+        XCTAssertNil(histograms[OS_REQUEST_PHASE_DNS])
+
+        metrics.reset()
+        XCTAssertTrue(metrics.snapshot().isEmpty)
+    }
+
+    func testDeltaLifecycleMetrics_bucketsEachStageByDeltaName() throws {
+        let metrics = OSDeltaLifecycleMetrics()
+        let enqueuedAt = Date()
+
+        /* When */
+        let trace = OSDeltaTrace(name: "OS_UPDATE_PROPERTIES_DELTA", enqueuedAt: enqueuedAt, flushedAt: enqueuedAt.addingTimeInterval(5))
+        metrics.recordTraces([trace], sentAt: enqueuedAt.addingTimeInterval(5.2), acknowledgedAt: enqueuedAt.addingTimeInterval(5.5))
+        // Never flushed by the operation repo, so only the stages after it was sent are known
+        let unflushed = OSDeltaTrace(name: "OS_UPDATE_PROPERTIES_DELTA", enqueuedAt: enqueuedAt, flushedAt: nil)
+        metrics.recordTraces([unflushed], sentAt: enqueuedAt, acknowledgedAt: enqueuedAt.addingTimeInterval(0.01))
+
+        /* Then */
+        let properties = try XCTUnwrap(metrics.snapshot()["OS_UPDATE_PROPERTIES_DELTA"])
+        XCTAssertEqual(properties["count"] as? Int, 2)
+        let histograms = try XCTUnwrap(properties["histograms"] as? [String: [Int]])
+        XCTAssertEqual(histograms[OS_DELTA_STAGE_QUEUED]?.reduce(0, +), 1)
+        XCTAssertEqual(histograms[OS_DELTA_STAGE_QUEUED]?[6], 1)
+        XCTAssertEqual(histograms[OS_DELTA_STAGE_EXECUTOR]?[2], 1)
+        XCTAssertEqual(histograms[OS_DELTA_STAGE_NETWORK]?[0], 1)
+        XCTAssertEqual(histograms[OS_DELTA_STAGE_NETWORK]?[3], 1)
+        XCTAssertEqual(histograms[OS_DELTA_STAGE_TOTAL]?.count, OSDeltaLifecycleMetrics.bucketBounds().count + 1)
+        XCTAssertEqual(histograms[OS_DELTA_STAGE_TOTAL]?[7], 1)
+
+        metrics.reset()
+        XCTAssertTrue(metrics.snapshot().isEmpty)
+    }
+
+    func testDispatchQueues_rootsHaveTheirQoSAndAllowNestedSync() throws {
+        XCTAssertEqual(OSDispatchQueues.userInitiated.qos.qosClass, .userInitiated)
+        XCTAssertEqual(OSDispatchQueues.utility.qos.qosClass, .utility)
+        XCTAssertEqual(OSDispatchQueues.background.qos.qosClass, .background)
+
+        // Queues sharing a root call sync on each other, such as the operation repo on its executors
+        let outer = DispatchQueue(label: "testDispatchQueues.outer", target: OSDispatchQueues.utility)
+        let inner = DispatchQueue(label: "testDispatchQueues.inner", target: OSDispatchQueues.utility)
+        let finished = expectation(description: "nested sync finished")
+        outer.async {
+            inner.sync {}
+            finished.fulfill()
+        }
+        wait(for: [finished], timeout: 1)
+    }
+
+    func testMainThreadWatchdog_reportsSlowBlocksByCallSiteOnlyInDebug() throws {
+        OSMainThreadWatchdog.reset()
+        OSMainThreadWatchdog.runBlock({ Thread.sleep(forTimeInterval: 0.05) }, callSite: "not timed")
+        XCTAssertEqual(OSMainThreadWatchdog.snapshot()["slow_blocks"] as? Int, 0)
+
+        OneSignalLog.setLogLevel(.LL_DEBUG)
+        OSMainThreadWatchdog.runBlock({ Thread.sleep(forTimeInterval: 0.05) }, callSite: "slow")
+        OSMainThreadWatchdog.runBlock({ Thread.sleep(forTimeInterval: 0.05) }, callSite: "slow")
+        OSMainThreadWatchdog.runBlock({}, callSite: "fast")
+        OneSignalLog.setLogLevel(.LL_WARN)
+
+        let snapshot = OSMainThreadWatchdog.snapshot()
+        let sites = snapshot["sites"] as! [String: [String: Any]]
+        XCTAssertEqual(snapshot["slow_blocks"] as? Int, 2)
+        XCTAssertEqual(Array(sites.keys), ["slow"])
+        XCTAssertEqual(sites["slow"]?["count"] as? Int, 2)
+        XCTAssertGreaterThanOrEqual(sites["slow"]?["max_ms"] as! Double, 50)
+        XCTAssertNotNil(OneSignalLog.metrics["main_thread"])
+        OSMainThreadWatchdog.reset()
+    }
+
+    func testLogListener_receivesMessagesThatPassTheLogLevelInOrder() throws {
+        class Listener: NSObject, OSLogListener {
+            var entries: [String] = []
+            let expectation: XCTestExpectation
+
+            init(expectation: XCTestExpectation) {
+                self.expectation = expectation
+            }
+
+            func onLogEvent(_ event: OneSignalLogEvent) {
+                entries.append(event.entry)
+                if entries.count == 2 {
+                    expectation.fulfill()
+                }
+            }
+        }
+
+        let listener = Listener(expectation: expectation(description: "log events delivered"))
+        OneSignalLog.setLogLevel(.LL_DEBUG)
+        OneSignalLog.addLogListener(listener)
+
+        OneSignalLog.onesignalLog(.LL_DEBUG, message: "first")
+        OneSignalLog.onesignalLog(.LL_VERBOSE, message: "filtered out")
+        OneSignalLog.onesignalLog(.LL_WARN, message: "second")
+
+        waitForExpectations(timeout: 1)
+        XCTAssertEqual(listener.entries, ["DEBUG: first", "WARNING: second"])
+
+        OneSignalLog.removeLogListener(listener)
+        OneSignalLog.setLogLevel(.LL_WARN)
+    }
+
+    func testFlightRecorder_keepsTheMostRecentEntriesOldestFirst() throws {
+        OSFlightRecorder.clear()
+        for depth in 0..<Int64(OS_FLIGHT_RECORDER_CAPACITY + 2) {
+            OSFlightRecorder.record(.deltaEnqueued, arg0: depth, arg1: 0)
+        }
+        OSFlightRecorder.record(.requestStarted, class: OneSignalClientError.self, arg1: 7)
+
+        let events = OSFlightRecorder.events()
+        XCTAssertEqual(events.count, Int(OS_FLIGHT_RECORDER_CAPACITY))
+        XCTAssertEqual(events.first?["arg0"] as? Int64, 3)
+        XCTAssertEqual(events.last?["event"] as? String, "RequestStarted")
+        XCTAssertEqual(events.last?["arg0"] as? String, "OneSignalClientError")
+        XCTAssertEqual(events.last?["arg1"] as? Int64, 7)
+
+        let dump = OSFlightRecorder.dump()
+        XCTAssertEqual(String(data: dump.prefix(4), encoding: .ascii), "OSFR")
+        XCTAssertEqual(dump.count, 12 + Int(OS_FLIGHT_RECORDER_CAPACITY) * 32)
+
+        OSFlightRecorder.clear()
+        XCTAssertTrue(OSFlightRecorder.events().isEmpty)
+    }
+
+    func testFirebaseAnalytics_receivedNotificationIsOnlySavedWhileEnabled() throws {
+        let sharedUserDefaults = OneSignalUserDefaults.initShared()
+        sharedUserDefaults.removeValue(forKey: ONESIGNAL_FB_LAST_RECEIVED)
+        let notification: OSNotification = try XCTUnwrap(OSNotification.parse(withApns: [
+            "aps": ["alert": "Message Body"],
+            "os_data": ["i": "notif id"]
+        ]))
+
+        OneSignalTrackFirebaseAnalytics.updateFromDownloadParams(["fba": false])
+        OneSignalTrackFirebaseAnalytics.trackReceivedEvent(notification)
+        XCTAssertNil(sharedUserDefaults.getSavedObject(forKey: ONESIGNAL_FB_LAST_RECEIVED, defaultValue: nil))
+
+        OneSignalTrackFirebaseAnalytics.updateFromDownloadParams(["fba": true])
+        OneSignalTrackFirebaseAnalytics.trackReceivedEvent(notification)
+        let lastReceived = try XCTUnwrap(sharedUserDefaults.getSavedObject(forKey: ONESIGNAL_FB_LAST_RECEIVED, defaultValue: nil) as? [String: Any])
+        XCTAssertEqual(lastReceived["notification_id"] as? String, "notif id")
+        XCTAssertNotNil(lastReceived["time"])
+
+        OneSignalTrackFirebaseAnalytics.updateFromDownloadParams(["fba": false])
+        XCTAssertFalse(sharedUserDefaults.getSavedBool(forKey: ONESIGNAL_FB_ENABLE_FIREBASE, defaultValue: false))
+        sharedUserDefaults.removeValue(forKey: ONESIGNAL_FB_LAST_RECEIVED)
+    }
+
+    func testPerformanceCounters_snapshotIncludesCountersGaugesAndAverages() throws {
+        OSPerformanceCounters.reset()
+        OSPerformanceCounters.increment(.deltasEnqueued)
+        OSPerformanceCounters.increment(.deltasEnqueued)
+        OSPerformanceCounters.increment(.iamEvaluations)
+        OSPerformanceCounters.increment(.iamEvaluations)
+        OSPerformanceCounters.add(3000, to: .iamEvaluationMicroseconds)
+        OSPerformanceCounters.setGauge(.deltaQueueDepth, value: 5)
+
+        let snapshot = OSPerformanceCounters.snapshot()
+        XCTAssertEqual(snapshot["deltas_enqueued"], 2)
+        XCTAssertEqual(snapshot["deltas_coalesced"], 0)
+        XCTAssertEqual(snapshot["delta_queue_depth"], 5)
+        XCTAssertEqual(snapshot["iam_evaluation_average_ms"]?.doubleValue, 1.5)
+        XCTAssertEqual(OneSignalLog.metrics["deltas_enqueued"] as? Int, 2)
+
+        OSPerformanceCounters.reset()
+        XCTAssertEqual(OSPerformanceCounters.snapshot()["deltas_enqueued"], 0)
+    }
+
+    func testTuningConfig_clampsRemoteValuesAndFallsBackToDefaults() throws {
+        let tuning = OSTuningConfig.sharedConfig()
+        tuning.applyRemoteTuning([OS_TUNING_OUTCOME_BATCH_SIZE: 0, OS_TUNING_REQUEST_MAX_ATTEMPTS: 2, OS_TUNING_REQUEST_TIMEOUT: "30"])
+
+        XCTAssertEqual(tuning.outcomeBatchSize, 1)
+        XCTAssertEqual(tuning.requestMaxAttempts, 2)
+        XCTAssertEqual(tuning.requestTimeout, REQUEST_TIMEOUT_REQUEST)
+        XCTAssertEqual(tuning.integer(forKey: "unknown_knob", defaultValue: 7, minimum: 0, maximum: 10), 7)
+
+        tuning.applyRemoteTuning(NSNull())
+        XCTAssertEqual(tuning.outcomeBatchSize, Int(OS_OUTCOME_BUFFER_FLUSH_SIZE))
+        XCTAssertEqual(tuning.requestMaxAttempts, Int(MAX_ATTEMPT_COUNT))
+    }
+
+    func testBoolObservable_coalescesFlappingIntoTheSettledValue() throws {
+        let observer = MockBoolObserver()
+        let observable = OSBoolObservable<MockBoolObserver>(change: #selector(MockBoolObserver.onBoolDidChange(_:)), coalescingInterval: 0)
+        observable.addObserver(observer)
+
+        observable.notifyChange(true)
+        observable.notifyChange(false)
+        observable.notifyChange(true)
+        XCTAssertEqual(observer.received, [])
+
+        let delivered = expectation(description: "coalesced change delivered")
+        DispatchQueue.main.async { delivered.fulfill() }
+        wait(for: [delivered], timeout: 1)
+        XCTAssertEqual(observer.received, [true])
+    }
+
+    func testObservable_mergesCoalescedStatesAndDropsNetNoOps() throws {
+        let observer = MockRangeObserver()
+        // A range stands in for a previous/current pair, location is the first previous and length the last current
+        let observable = OSObservable<MockRangeObserver, NSValue>(change: #selector(MockRangeObserver.onRangeDidChange(_:)), coalescingInterval: 0) { pending, state in
+            let merged = NSRange(location: pending.rangeValue.location, length: state.rangeValue.length)
+            return merged.location == merged.length ? nil : NSValue(range: merged)
+        }
+        observable.addObserver(observer)
+
+        observable.notifyChange(NSValue(range: NSRange(location: 1, length: 2)))
+        observable.notifyChange(NSValue(range: NSRange(location: 2, length: 3)))
+        let delivered = expectation(description: "coalesced change delivered")
+        DispatchQueue.main.async { delivered.fulfill() }
+        wait(for: [delivered], timeout: 1)
+        XCTAssertEqual(observer.received, [NSRange(location: 1, length: 3)])
+
+        observable.notifyChange(NSValue(range: NSRange(location: 1, length: 2)))
+        observable.notifyChange(NSValue(range: NSRange(location: 2, length: 1)))
+        let dropped = expectation(description: "net no-op dropped")
+        DispatchQueue.main.async { dropped.fulfill() }
+        wait(for: [dropped], timeout: 1)
+        XCTAssertEqual(observer.received.count, 1)
+    }
+
+    func testMaintenanceScheduler_runsJobsInOrderUntilAskedToStop() throws {
+        let scheduler = OSMaintenanceScheduler()
+        var ran = [String]()
+        scheduler.registerJob("first") { completion in
+            ran.append("first")
+            completion()
+        }
+        scheduler.registerJob("second") { completion in
+            ran.append("second")
+            completion()
+        }
+        scheduler.registerJob("first") { completion in
+            ran.append("first replaced")
+            completion()
+        }
+
+        let finishedRun = expectation(description: "every job ran")
+        scheduler.runJobs(shouldContinue: { true }) { finished in
+            XCTAssertTrue(finished)
+            finishedRun.fulfill()
+        }
+        wait(for: [finishedRun], timeout: 1)
+        XCTAssertEqual(ran, ["first replaced", "second"])
+
+        ran.removeAll()
+        var asked = 0
+        let stoppedRun = expectation(description: "run stopped")
+        scheduler.runJobs(shouldContinue: {
+            asked += 1
+            return asked == 1
+        }) { finished in
+            XCTAssertFalse(finished)
+            stoppedRun.fulfill()
+        }
+        wait(for: [stoppedRun], timeout: 1)
+        XCTAssertEqual(ran, ["first replaced"])
+    }
+
+    func testMaintenanceScheduler_waitsForAsynchronousJobsAndTimesOutStuckOnes() throws {
+        let scheduler = OSMaintenanceScheduler()
+        var ran = [String]()
+        scheduler.registerJob("async") { completion in
+            DispatchQueue.global().asyncAfter(deadline: .now() + 0.1) {
+                ran.append("async")
+                completion()
+            }
+        }
+        scheduler.registerJob("stuck") { _ in
+            ran.append("stuck")
+        }
+        scheduler.registerJob("last") { completion in
+            ran.append("last")
+            completion()
+        }
+
+        let finishedRun = expectation(description: "every job ran")
+        scheduler.runJobs(shouldContinue: { true }) { finished in
+            XCTAssertTrue(finished)
+            finishedRun.fulfill()
+        }
+        wait(for: [finishedRun], timeout: OS_MAINTENANCE_JOB_TIMEOUT + 1)
+        XCTAssertEqual(ran, ["async", "stuck", "last"])
+    }
+
+    func testMaintenanceScheduler_withoutJobsDoesNotRecordARun() throws {
+        OneSignalUserDefaults.initStandard().removeValue(forKey: OSUD_MAINTENANCE_LAST_RUN)
+        let scheduler = OSMaintenanceScheduler()
+
+        let emptyRun = expectation(description: "run without jobs")
+        scheduler.runJobs(shouldContinue: { true }) { _ in
+            emptyRun.fulfill()
+        }
+        wait(for: [emptyRun], timeout: 1)
+
+        XCTAssertEqual(OneSignalUserDefaults.initStandard().getSavedDouble(forKey: OSUD_MAINTENANCE_LAST_RUN, defaultValue: 0), 0)
+    }
+
+    func testPowerPolicy_scalesBackWorkUnderLowPowerOrSeriousThermalStateAndReverts() throws {
+        let policy = OSPowerPolicy()
+        policy.update(withLowPowerMode: false, thermalState: .fair)
+        XCTAssertFalse(policy.isConstrained)
+        XCTAssertEqual(policy.scaledDelay(5), 5)
+        XCTAssertEqual(policy.telemetryDeferral(0), 0)
+
+        expectation(forNotification: NSNotification.Name(OS_POWER_POLICY_CHANGED_NOTIFICATION), object: policy)
+        policy.update(withLowPowerMode: false, thermalState: .serious)
+        waitForExpectations(timeout: 1)
+        XCTAssertFalse(policy.allowsPrefetch)
+        XCTAssertEqual(policy.scaledDelay(5), 5 * Double(OS_POWER_POLICY_DELAY_MULTIPLIER))
+        XCTAssertEqual(policy.scaledDistance(100), 100 * Double(OS_POWER_POLICY_DISTANCE_MULTIPLIER))
+        XCTAssertEqual(policy.telemetryDeferral(0), TimeInterval(OS_POWER_POLICY_MIN_TELEMETRY_DEFERRAL))
+
+        policy.update(withLowPowerMode: true, thermalState: .nominal)
+        XCTAssertTrue(policy.isConstrained)
+        policy.update(withLowPowerMode: false, thermalState: .nominal)
+        XCTAssertTrue(policy.allowsPrefetch)
+        XCTAssertEqual(policy.scaledDelay(5), 5)
+    }
 }
@@ -31,7 +31,12 @@
 @interface OneSignalAttachmentHandler : NSObject
 
 + (void)addAttachments:(OSNotification*)notification toNotificationContent:(UNMutableNotificationContent*)content;
++ (void)addAttachments:(OSNotification*)notification toNotificationContent:(UNMutableNotificationContent*)content withinSeconds:(NSTimeInterval)seconds;
+// Cancels every attachment download still in flight, for when the NSE runs out of time
++ (void)cancelAttachmentDownloads;
 + (void)addActionButtons:(OSNotification*)notification toNotificationContent:(UNMutableNotificationContent*)content;
 + (UNNotificationAction *)createActionForButton:(NSDictionary *)button;
+// Maintenance job, trims the shared notification media cache
++ (void)removeExpiredCachedMedia;
 @end
 
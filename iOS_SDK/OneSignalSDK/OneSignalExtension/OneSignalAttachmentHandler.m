@@ -26,125 +26,161 @@
  */
 
 #import <Foundation/Foundation.h>
+#import <ImageIO/ImageIO.h>
 #import "OneSignalAttachmentHandler.h"
 #import "OneSignalNotificationCategoryController.h"
+#import "OneSignalAttachmentMediaCache.h"
+
+// A single in-flight attachment download waiting on DirectDownloadDelegate
+@interface DirectDownload : NSObject
+@property (strong, nonatomic) NSURL *url;
+@property (strong, nonatomic) NSURLSessionTask *task;
+@property (strong, nonatomic) NSString *localPath;
+@property (strong, nonatomic) dispatch_semaphore_t semaphore;
+// Written from the session's delegate queue and read by the waiting thread
+@property (strong, atomic) NSError *error;
+@property (strong, atomic) NSString *mimeType;
+@end
+
+@implementation DirectDownload
+@end
+
+/*
+ Delegate of the one session shared by all attachment downloads
+ Moves each finished temp file into place and wakes the thread waiting on it
+*/
+@interface DirectDownloadDelegate : NSObject <NSURLSessionDownloadDelegate>
+- (void)addDownload:(DirectDownload *)download forTask:(NSURLSessionTask *)task;
+- (void)cancelDownloadsForURLs:(NSSet<NSURL *> *)urls;
+@end
 
-@interface DirectDownloadDelegate : NSObject <NSURLSessionDataDelegate> {
-    NSError* error;
-    NSURLResponse* response;
-    BOOL done;
-    NSFileHandle* outputHandle;
+@implementation DirectDownloadDelegate {
+    NSMutableDictionary<NSNumber *, DirectDownload *> *downloads;
 }
 
-@property (readonly, getter=isDone) BOOL done;
-@property (readonly) NSError* error;
-@property (readonly) NSURLResponse* response;
+- (instancetype)init {
+    if (self = [super init]) {
+        downloads = [NSMutableDictionary new];
+    }
+    return self;
+}
 
-@end
+- (void)addDownload:(DirectDownload *)download forTask:(NSURLSessionTask *)task {
+    download.task = task;
+    @synchronized (downloads) {
+        downloads[@(task.taskIdentifier)] = download;
+    }
+}
 
-@implementation DirectDownloadDelegate
-@synthesize error, response, done;
-
--(void)URLSession:(NSURLSession *)session dataTask:(NSURLSessionDataTask *)dataTask didReceiveData:(NSData *)data {
-    NSError * __autoreleasing fileHandleError;
-    NSError * __autoreleasing *fileHandleErrorPointer = &fileHandleError;
-    if (@available(iOS 13.0, *)) {
-        // We need to use NSInvocation for reflection because performSelector cannot take pointer parameters
-        SEL writeDataSelector = NSSelectorFromString(@"writeData:error:");
-        NSInvocation *invocation = [NSInvocation invocationWithMethodSignature:[NSFileHandle instanceMethodSignatureForSelector:writeDataSelector]];
-        [invocation setTarget:outputHandle];
-        [invocation setSelector:writeDataSelector];
-        /*
-         From Apple's Documentation on NSInvocation:
-         Indices 0 and 1 indicate the hidden arguments self and _cmd, respectively;
-         you should set these values directly with the target and selector properties.
-         Use indices 2 and greater for the arguments normally passed in a message.
-        */
-        [invocation setArgument:&data atIndex:2];
-        [invocation setArgument:&fileHandleErrorPointer atIndex:3];
-        [invocation invoke];
-    } else {
-        @try {
-            [outputHandle writeData:data];
-        } @catch (NSException *e) {
-            NSDictionary *userInfo = @{
-                NSLocalizedDescriptionKey : @"Failed to write attachment data to filehandle",
-            };
-            fileHandleError = [NSError errorWithDomain:@"com.onesignal.download" code:0 userInfo:userInfo];
-        }
+// Cancels the in-flight downloads of the given URLs, or all of them when urls is nil
+- (void)cancelDownloadsForURLs:(NSSet<NSURL *> *)urls {
+    NSArray<DirectDownload *> *inFlight;
+    @synchronized (downloads) {
+        inFlight = downloads.allValues;
     }
-    
-    if (fileHandleError != nil) {
-        [OneSignalLog onesignalLog:ONE_S_LL_ERROR message:[NSString stringWithFormat:@"OneSignal Error encountered while downloading attachment: %@", fileHandleError]];
+    for (DirectDownload *download in inFlight) {
+        if (!urls || [urls containsObject:download.url])
+            [download.task cancel];
     }
 }
 
-- (void)URLSession:(NSURLSession *)session dataTask:(NSURLSessionDataTask *)dataTask didReceiveResponse:(NSURLResponse *)aResponse completionHandler:(void (^)(NSURLSessionResponseDisposition))completionHandler {
-    response = aResponse;
-    long long expectedLength = response.expectedContentLength;
-    if (expectedLength > MAX_NOTIFICATION_MEDIA_SIZE_BYTES) { //Enforcing 50 mb limit on media before downloading
-        completionHandler(NSURLSessionResponseCancel);
-        return;
+- (DirectDownload *)downloadForTask:(NSURLSessionTask *)task {
+    @synchronized (downloads) {
+        return downloads[@(task.taskIdentifier)];
     }
-    completionHandler(NSURLSessionResponseAllow);
 }
 
--(void)URLSession:(NSURLSession *)session didBecomeInvalidWithError:(NSError *)anError {
-    error = anError;
-    done = YES;
-    
-    [outputHandle closeFile];
+- (void)URLSession:(NSURLSession *)session downloadTask:(NSURLSessionDownloadTask *)downloadTask didWriteData:(int64_t)bytesWritten totalBytesWritten:(int64_t)totalBytesWritten totalBytesExpectedToWrite:(int64_t)totalBytesExpectedToWrite {
+    if (totalBytesExpectedToWrite > MAX_NOTIFICATION_MEDIA_SIZE_BYTES || totalBytesWritten > MAX_NOTIFICATION_MEDIA_SIZE_BYTES) { //Enforcing 50 mb limit on media
+        [downloadTask cancel];
+    }
 }
 
--(void)URLSession:(NSURLSession *)session task:(NSURLSessionTask *)task didCompleteWithError:(NSError *)anError {
-    done = YES;
-    error = anError;
-    [outputHandle closeFile];
+- (void)URLSession:(NSURLSession *)session downloadTask:(NSURLSessionDownloadTask *)downloadTask didFinishDownloadingToURL:(NSURL *)location {
+    DirectDownload *download = [self downloadForTask:downloadTask];
+    if (!download)
+        return;
+    // The temp file is deleted when this returns, move it into place in one step
+    NSError *moveError;
+    [[NSFileManager defaultManager] removeItemAtPath:download.localPath error:nil];
+    if (![[NSFileManager defaultManager] moveItemAtURL:location toURL:[NSURL fileURLWithPath:download.localPath] error:&moveError]) {
+        download.error = moveError;
+        return;
+    }
+    download.mimeType = downloadTask.response.MIMEType;
 }
 
-- (id)initWithFilePath:(NSString*)path {
-    if (self = [super init]) {
-        if ([[NSFileManager defaultManager] fileExistsAtPath:path])
-            [[NSFileManager defaultManager] removeItemAtPath:path error:nil];
-        
-        [[NSFileManager defaultManager] createFileAtPath:path contents:nil attributes:nil];
-        outputHandle = [NSFileHandle fileHandleForWritingAtPath:path];
+- (void)URLSession:(NSURLSession *)session task:(NSURLSessionTask *)task didCompleteWithError:(NSError *)error {
+    DirectDownload *download;
+    @synchronized (downloads) {
+        download = downloads[@(task.taskIdentifier)];
+        [downloads removeObjectForKey:@(task.taskIdentifier)];
     }
-    return self;
+    if (error)
+        download.error = error;
+    if (download.semaphore)
+        dispatch_semaphore_signal(download.semaphore);
 }
+
 @end
 
 @interface NSURLSession (DirectDownload)
 + (NSString *)downloadItemAtURL:(NSURL *)url toFile:(NSString *)localPath error:(NSError **)error;
++ (void)cancelDirectDownloadsForURLs:(NSSet<NSURL *> *)urls;
 @end
 
 @implementation NSURLSession (DirectDownload)
 
+static NSURLSession *_directDownloadSession;
+static DirectDownloadDelegate *_directDownloadDelegate;
+
+// Kept for the life of the extension process, later notifications in a burst reuse its connections to the media hosts
++ (NSURLSession *)directDownloadSession {
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        let configuration = [OSNetworkingUtils defaultSessionConfiguration];
+        // Downloads are bounded by the shared deadline, waiting for connectivity would only hold the NSE
+        configuration.waitsForConnectivity = NO;
+        configuration.timeoutIntervalForResource = MAX_NOTIFICATION_MEDIA_DOWNLOAD_SECONDS;
+        // OneSignalAttachmentMediaCache keeps the media, a URL cache would only copy it again within the NSE memory limit
+        configuration.URLCache = nil;
+        _directDownloadDelegate = [DirectDownloadDelegate new];
+        _directDownloadSession = [NSURLSession sessionWithConfiguration:configuration delegate:_directDownloadDelegate delegateQueue:nil];
+    });
+    return _directDownloadSession;
+}
+
 + (NSString *)downloadItemAtURL:(NSURL *)url toFile:(NSString *)localPath error:(NSError **)error {
-    NSMutableURLRequest *request = [[NSMutableURLRequest alloc] initWithURL:url];
-    
-    DirectDownloadDelegate *delegate = [[DirectDownloadDelegate alloc] initWithFilePath:localPath];
-    
-    NSURLSession *session = [NSURLSession sessionWithConfiguration:[NSURLSessionConfiguration defaultSessionConfiguration] delegate:delegate delegateQueue:nil];
-    
-    NSURLSessionDataTask *task = [session dataTaskWithRequest:request];
+    let session = [self directDownloadSession];
+    let download = [DirectDownload new];
+    download.url = url;
+    download.localPath = localPath;
+    download.semaphore = dispatch_semaphore_create(0);
     
+    NSURLSessionDownloadTask *task = [session downloadTaskWithRequest:[NSURLRequest requestWithURL:url]];
+    [_directDownloadDelegate addDownload:download forTask:task];
     [task resume];
     
-    [session finishTasksAndInvalidate];
-    
-    while (![delegate isDone]) {
-        [[NSRunLoop currentRunLoop] runUntilDate:[NSDate dateWithTimeIntervalSinceNow:1.0]];
+    let deadline = dispatch_time(DISPATCH_TIME_NOW, (int64_t)(MAX_NOTIFICATION_MEDIA_DOWNLOAD_SECONDS * NSEC_PER_SEC));
+    if (dispatch_semaphore_wait(download.semaphore, deadline) != 0) {
+        [task cancel];
+        download.error = [NSError errorWithDomain:@"com.onesignal.download" code:NSURLErrorTimedOut userInfo:@{NSLocalizedDescriptionKey : @"Timed out downloading attachment"}];
     }
     
-    NSError *downloadError = [delegate error];
+    NSError *downloadError = download.error;
     if (downloadError != nil) {
         if (error)
             *error = downloadError;
         return nil;
     }
     
-    return delegate.response.MIMEType;
+    return download.mimeType;
+}
+
++ (void)cancelDirectDownloadsForURLs:(NSSet<NSURL *> *)urls {
+    if (!_directDownloadDelegate)
+        return;
+    [_directDownloadDelegate cancelDownloadsForURLs:urls];
 }
 
 @end
@@ -156,6 +192,14 @@
     if (!notification.actionButtons || notification.actionButtons.count == 0)
         return;
     
+    // The same buttons were registered for an earlier notification, skip the round trips to UNUserNotificationCenter
+    let categoryController = OneSignalNotificationCategoryController.sharedInstance;
+    let registeredCategoryId = [categoryController registeredCategoryIdForActionButtons:notification.actionButtons];
+    if (registeredCategoryId) {
+        content.categoryIdentifier = registeredCategoryId;
+        return;
+    }
+    
     let actionArray = [NSMutableArray new];
     for(NSDictionary* button in notification.actionButtons) {
         let action = [self createActionForButton:button];
@@ -198,15 +242,24 @@
     //   some iOS background thread time to flush to disk.
     allCategories = OneSignalNotificationCategoryController.sharedInstance.existingCategories;
     
+    [categoryController saveCategoryId:newCategoryIdentifier forActionButtons:notification.actionButtons];
+    
     content.categoryIdentifier = newCategoryIdentifier;
 }
 
 + (void)addAttachments:(OSNotification*)notification
  toNotificationContent:(UNMutableNotificationContent*)content {
+    [self addAttachments:notification toNotificationContent:content withinSeconds:MAX_NOTIFICATION_MEDIA_DOWNLOAD_SECONDS];
+}
+
++ (void)addAttachments:(OSNotification*)notification
+ toNotificationContent:(UNMutableNotificationContent*)content
+         withinSeconds:(NSTimeInterval)seconds {
     if (!notification.attachments)
         return;
     
     let unAttachments = [NSMutableArray new];
+    let downloadedNames = [self downloadRemoteAttachments:notification.attachments withinSeconds:MIN(seconds, MAX_NOTIFICATION_MEDIA_DOWNLOAD_SECONDS)];
     
     for(NSString* key in notification.attachments) {
         let URI = [OneSignalCoreHelper trimURLSpacing:[notification.attachments valueForKey:key]];
@@ -215,8 +268,7 @@
         
         // Remote media attachment */
         if (nsURL && [self isWWWScheme:nsURL]) {
-            // Synchroneously download file and chache it
-            let name = [self downloadMediaAndSaveInBundle:URI];
+            let name = downloadedNames[key];
             
             if (!name)
                 continue;
@@ -261,6 +313,48 @@
     content.attachments = unAttachments;
 }
 
+/*
+ Starts every remote attachment download at once and waits for them under one shared deadline
+ Returns the saved resource names by attachment key, downloads that miss the deadline are left out
+*/
++ (NSDictionary<NSString *, NSString *> *)downloadRemoteAttachments:(NSDictionary *)attachments withinSeconds:(NSTimeInterval)seconds {
+    let downloadedNames = [NSMutableDictionary<NSString *, NSString *> new];
+    let downloadURLs = [NSMutableSet<NSURL *> new];
+    let group = dispatch_group_create();
+    
+    for (NSString *key in attachments) {
+        let URI = [OneSignalCoreHelper trimURLSpacing:[attachments valueForKey:key]];
+        let nsURL = [NSURL URLWithString:URI];
+        if (!nsURL || ![self isWWWScheme:nsURL])
+            continue;
+        [downloadURLs addObject:nsURL];
+        
+        dispatch_group_async(group, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^{
+            let name = [self downloadMediaAndSaveInBundle:URI];
+            if (!name)
+                return;
+            @synchronized (downloadedNames) {
+                downloadedNames[key] = name;
+            }
+        });
+    }
+    
+    let deadline = dispatch_time(DISPATCH_TIME_NOW, (int64_t)(seconds * NSEC_PER_SEC));
+    if (dispatch_group_wait(group, deadline) != 0) {
+        [OneSignalLog onesignalLog:ONE_S_LL_WARN message:@"OneSignal attachment downloads did not all finish in time, continuing with the ones that did"];
+        // Late downloads would otherwise keep the connection and memory of the NSE until their own timeout
+        [NSURLSession cancelDirectDownloadsForURLs:downloadURLs];
+    }
+    
+    @synchronized (downloadedNames) {
+        return [downloadedNames copy];
+    }
+}
+
++ (void)cancelAttachmentDownloads {
+    [NSURLSession cancelDirectDownloadsForURLs:nil];
+}
+
 + (UNNotificationAction *)createActionForButton:(NSDictionary *)button {
     NSString *buttonId = button[@"id"];
     NSString *buttonText = button[@"text"];
@@ -306,8 +400,12 @@
     }
 }
 
++ (void)removeExpiredCachedMedia {
+    [OneSignalAttachmentMediaCache removeMediaNotUsedSince:[NSDate dateWithTimeIntervalSinceNow:-MAX_NOTIFICATION_MEDIA_CACHE_AGE_SECONDS]];
+}
+
 /*
- Synchroneously downloads an attachment
+ Synchroneously downloads an attachment, safe to call from several threads at once
  On success returns bundle resource name, otherwise returns nil
 */
 + (NSString *)downloadMediaAndSaveInBundle:(NSString *)urlString {
@@ -320,6 +418,16 @@
     NSArray* paths = NSSearchPathForDirectoriesInDomains(NSCachesDirectory, NSUserDomainMask, YES);
     NSString* filePath = [paths[0] stringByAppendingPathComponent:name];
     
+    // Reuse media an earlier notification already downloaded, the attachment gets its own link to it
+    let cachedPath = [OneSignalAttachmentMediaCache cachedMediaPathForURL:urlString];
+    if (cachedPath) {
+        let cachedName = [name stringByAppendingPathExtension:cachedPath.pathExtension];
+        if ([OneSignalAttachmentMediaCache linkItemAtPath:cachedPath toPath:[paths[0] stringByAppendingPathComponent:cachedName]]) {
+            ONE_S_LOG(ONE_S_LL_VERBOSE, @"Using cached media for URL: %@", urlString);
+            return cachedName;
+        }
+    }
+    
     //guard against situations where for example, available storage is too low
     
     @try {
@@ -346,18 +454,24 @@
             return nil;
         }
 
+        [self downsampleImageIfNeededAtPath:newPath];
+        [OneSignalAttachmentMediaCache cacheMediaAtPath:newPath forURL:urlString];
+
         let standardUserDefaults = OneSignalUserDefaults.initStandard;
 
-        NSArray* cachedFiles = [standardUserDefaults getSavedObjectForKey:OSUD_TEMP_CACHED_NOTIFICATION_MEDIA defaultValue:nil];
-        NSMutableArray* appendedCache;
-        if (cachedFiles) {
-            appendedCache = [[NSMutableArray alloc] initWithArray:cachedFiles];
-            [appendedCache addObject:name];
-        }
-        else
-            appendedCache = [[NSMutableArray alloc] initWithObjects:name, nil];
+        // Downloads run concurrently, keep the read-modify-write of the cached file list atomic
+        @synchronized (self) {
+            NSArray* cachedFiles = [standardUserDefaults getSavedObjectForKey:OSUD_TEMP_CACHED_NOTIFICATION_MEDIA defaultValue:nil];
+            NSMutableArray* appendedCache;
+            if (cachedFiles) {
+                appendedCache = [[NSMutableArray alloc] initWithArray:cachedFiles];
+                [appendedCache addObject:name];
+            }
+            else
+                appendedCache = [[NSMutableArray alloc] initWithObjects:name, nil];
 
-        [standardUserDefaults saveObjectForKey:OSUD_TEMP_CACHED_NOTIFICATION_MEDIA withValue:appendedCache];
+            [standardUserDefaults saveObjectForKey:OSUD_TEMP_CACHED_NOTIFICATION_MEDIA withValue:appendedCache];
+        }
         return name;
     } @catch (NSException *exception) {
         [OneSignalLog onesignalLog:ONE_S_LL_ERROR message:[NSString stringWithFormat:@"OneSignal encountered an exception while downloading file (%@), exception: %@", url, exception.description]];
@@ -366,6 +480,69 @@
     }
 }
 
+/*
+ Optional stage enabled by ONESIGNAL_NOTIFICATION_MEDIA_MAX_PIXEL_SIZE_KEY
+ ImageIO decodes straight to the target size from the file, so the full size bitmap never sits in NSE memory
+*/
++ (void)downsampleImageIfNeededAtPath:(NSString *)path {
+    NSInteger maxPixelSize = [[[NSBundle mainBundle] objectForInfoDictionaryKey:ONESIGNAL_NOTIFICATION_MEDIA_MAX_PIXEL_SIZE_KEY] integerValue];
+    [self downsampleImageAtPath:path toMaxPixelSize:maxPixelSize];
+}
+
++ (void)downsampleImageAtPath:(NSString *)path toMaxPixelSize:(NSInteger)maxPixelSize {
+    if (maxPixelSize <= 0)
+        return;
+    // Animated and non image media are left alone
+    if (![@[@"jpg", @"jpeg", @"png"] containsObject:path.pathExtension.lowercaseString])
+        return;
+    
+    @autoreleasepool {
+        let url = [NSURL fileURLWithPath:path];
+        NSDictionary *sourceOptions = @{(id)kCGImageSourceShouldCache : @NO};
+        CGImageSourceRef source = CGImageSourceCreateWithURL((__bridge CFURLRef)url, (__bridge CFDictionaryRef)sourceOptions);
+        if (!source)
+            return;
+        
+        // Reading the header doesn't decode any pixels
+        NSDictionary *properties = CFBridgingRelease(CGImageSourceCopyPropertiesAtIndex(source, 0, NULL));
+        NSInteger width = [properties[(id)kCGImagePropertyPixelWidth] integerValue];
+        NSInteger height = [properties[(id)kCGImagePropertyPixelHeight] integerValue];
+        CFStringRef type = CGImageSourceGetType(source);
+        if (MAX(width, height) <= maxPixelSize || !type) {
+            CFRelease(source);
+            return;
+        }
+        
+        NSDictionary *thumbnailOptions = @{
+            (id)kCGImageSourceCreateThumbnailFromImageAlways : @YES,
+            (id)kCGImageSourceCreateThumbnailWithTransform : @YES,
+            (id)kCGImageSourceShouldCacheImmediately : @YES,
+            (id)kCGImageSourceThumbnailMaxPixelSize : @(maxPixelSize)
+        };
+        CGImageRef image = CGImageSourceCreateThumbnailAtIndex(source, 0, (__bridge CFDictionaryRef)thumbnailOptions);
+        let downsampledPath = [path stringByAppendingString:@".downsampled"];
+        BOOL written = NO;
+        if (image) {
+            CGImageDestinationRef destination = CGImageDestinationCreateWithURL((__bridge CFURLRef)[NSURL fileURLWithPath:downsampledPath], type, 1, NULL);
+            if (destination) {
+                CGImageDestinationAddImage(destination, image, NULL);
+                written = CGImageDestinationFinalize(destination);
+                CFRelease(destination);
+            }
+            CGImageRelease(image);
+        }
+        CFRelease(source);
+        
+        if (!written) {
+            [[NSFileManager defaultManager] removeItemAtPath:downsampledPath error:nil];
+            return;
+        }
+        [[NSFileManager defaultManager] removeItemAtPath:path error:nil];
+        [[NSFileManager defaultManager] moveItemAtPath:downsampledPath toPath:path error:nil];
+        ONE_S_LOG(ONE_S_LL_VERBOSE, @"Downsampled %ldx%ld attachment to a max of %ld pixels", (long)width, (long)height, (long)maxPixelSize);
+    }
+}
+
 + (BOOL)isWWWScheme:(NSURL*)url {
     NSString* urlScheme = [url.scheme lowercaseString];
     return [urlScheme isEqualToString:@"http"] || [urlScheme isEqualToString:@"https"];
@@ -0,0 +1,45 @@
+/*
+ Modified MIT License
+
+ Copyright 2024 OneSignal
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ 1. The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ 2. All copies of substantial portions of the Software may only be used in connection
+ with services provided by OneSignal.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ */
+
+#import <Foundation/Foundation.h>
+
+/*
+ Size and age bounded cache of downloaded notification media keyed by the media URL
+ Lives in the app group container when one is configured so every NSE launch shares it
+*/
+@interface OneSignalAttachmentMediaCache : NSObject
+
+// Path of the cached media for the URL, or nil if it isn't cached or was downloaded too long ago
++ (NSString * _Nullable)cachedMediaPathForURL:(NSString * _Nonnull)urlString;
+// Adds a downloaded file to the cache, the file itself stays where it is
++ (void)cacheMediaAtPath:(NSString * _Nonnull)path forURL:(NSString * _Nonnull)urlString;
+// Hard links (or clones when linking isn't possible) the item so the attachment can take ownership of its own copy
++ (BOOL)linkItemAtPath:(NSString * _Nonnull)path toPath:(NSString * _Nonnull)destinationPath;
+// Removes media not used since the date, then evicts down to the size limit
++ (void)removeMediaNotUsedSince:(NSDate * _Nonnull)date;
+
+@end
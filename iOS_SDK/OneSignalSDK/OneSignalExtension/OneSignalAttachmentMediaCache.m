@@ -0,0 +1,139 @@
+/*
+ Modified MIT License
+
+ Copyright 2024 OneSignal
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ 1. The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ 2. All copies of substantial portions of the Software may only be used in connection
+ with services provided by OneSignal.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ */
+
+#import "OneSignalAttachmentMediaCache.h"
+#import <OneSignalCore/OneSignalCore.h>
+
+@implementation OneSignalAttachmentMediaCache
+
++ (NSString *)cacheDirectory {
+    static NSString *cacheDirectory;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        NSURL *container = [[NSFileManager defaultManager] containerURLForSecurityApplicationGroupIdentifier:[OneSignalUserDefaults appGroupName]];
+        NSString *caches = container
+            ? [container URLByAppendingPathComponent:@"Library/Caches" isDirectory:YES].path
+            : NSSearchPathForDirectoriesInDomains(NSCachesDirectory, NSUserDomainMask, YES).firstObject;
+        cacheDirectory = [caches stringByAppendingPathComponent:NOTIFICATION_MEDIA_CACHE_DIRECTORY];
+        [[NSFileManager defaultManager] createDirectoryAtPath:cacheDirectory withIntermediateDirectories:YES attributes:nil error:nil];
+    });
+    return cacheDirectory;
+}
+
++ (NSString *)keyForURL:(NSString *)urlString {
+    return [OneSignalCoreHelper hashUsingSha1:urlString];
+}
+
++ (NSString *)cachedMediaPathForURL:(NSString *)urlString {
+    let key = [self keyForURL:urlString];
+    let directory = [self cacheDirectory];
+    for (NSString *name in [[NSFileManager defaultManager] contentsOfDirectoryAtPath:directory error:nil]) {
+        if (![name.stringByDeletingPathExtension isEqualToString:key])
+            continue;
+        let path = [directory stringByAppendingPathComponent:name];
+        // Media at a URL can be replaced, so a copy is only reused for so long after it was downloaded
+        NSDate *creationDate = [[NSFileManager defaultManager] attributesOfItemAtPath:path error:nil].fileCreationDate;
+        if (creationDate && -[creationDate timeIntervalSinceNow] > MAX_NOTIFICATION_MEDIA_CACHE_AGE_SECONDS) {
+            @synchronized (self) {
+                [[NSFileManager defaultManager] removeItemAtPath:path error:nil];
+            }
+            return nil;
+        }
+        // Mark as recently used so eviction drops it last
+        [[NSFileManager defaultManager] setAttributes:@{NSFileModificationDate : [NSDate date]} ofItemAtPath:path error:nil];
+        return path;
+    }
+    return nil;
+}
+
++ (void)cacheMediaAtPath:(NSString *)path forURL:(NSString *)urlString {
+    let name = [[self keyForURL:urlString] stringByAppendingPathExtension:path.pathExtension];
+    let cachedPath = [[self cacheDirectory] stringByAppendingPathComponent:name];
+    @synchronized (self) {
+        if ([[NSFileManager defaultManager] fileExistsAtPath:cachedPath])
+            return;
+        if (![self linkItemAtPath:path toPath:cachedPath])
+            return;
+        [self evictToSizeLimit];
+    }
+}
+
++ (BOOL)linkItemAtPath:(NSString *)path toPath:(NSString *)destinationPath {
+    NSError *error;
+    if ([[NSFileManager defaultManager] linkItemAtPath:path toPath:destinationPath error:&error])
+        return YES;
+    // Linking fails across volumes, copyItem clones on APFS so it stays cheap
+    if ([[NSFileManager defaultManager] copyItemAtPath:path toPath:destinationPath error:&error])
+        return YES;
+    [OneSignalLog onesignalLog:ONE_S_LL_ERROR message:[NSString stringWithFormat:@"OneSignal failed to link cached media: %@", error]];
+    return NO;
+}
+
++ (void)removeMediaNotUsedSince:(NSDate *)date {
+    let directory = [NSURL fileURLWithPath:[self cacheDirectory] isDirectory:YES];
+    @synchronized (self) {
+        NSArray<NSURL *> *fileURLs = [[NSFileManager defaultManager] contentsOfDirectoryAtURL:directory includingPropertiesForKeys:@[NSURLContentModificationDateKey] options:NSDirectoryEnumerationSkipsHiddenFiles error:nil];
+        for (NSURL *fileURL in fileURLs) {
+            NSDate *modificationDate;
+            [fileURL getResourceValue:&modificationDate forKey:NSURLContentModificationDateKey error:nil];
+            if (modificationDate && [modificationDate compare:date] == NSOrderedAscending)
+                [[NSFileManager defaultManager] removeItemAtURL:fileURL error:nil];
+        }
+        [self evictToSizeLimit];
+    }
+}
+
++ (void)evictToSizeLimit {
+    let directory = [NSURL fileURLWithPath:[self cacheDirectory] isDirectory:YES];
+    NSArray<NSURLResourceKey> *keys = @[NSURLFileAllocatedSizeKey, NSURLContentModificationDateKey];
+    NSMutableArray<NSURL *> *fileURLs = [[[NSFileManager defaultManager] contentsOfDirectoryAtURL:directory includingPropertiesForKeys:keys options:NSDirectoryEnumerationSkipsHiddenFiles error:nil] mutableCopy];
+    unsigned long long totalBytes = 0;
+    for (NSURL *fileURL in fileURLs) {
+        NSNumber *fileSize;
+        [fileURL getResourceValue:&fileSize forKey:NSURLFileAllocatedSizeKey error:nil];
+        totalBytes += fileSize.unsignedLongLongValue;
+    }
+    if (totalBytes <= MAX_NOTIFICATION_MEDIA_CACHE_SIZE_BYTES)
+        return;
+    
+    [fileURLs sortUsingComparator:^NSComparisonResult(NSURL *first, NSURL *second) {
+        NSDate *firstDate, *secondDate;
+        [first getResourceValue:&firstDate forKey:NSURLContentModificationDateKey error:nil];
+        [second getResourceValue:&secondDate forKey:NSURLContentModificationDateKey error:nil];
+        return [firstDate ?: [NSDate distantPast] compare:secondDate ?: [NSDate distantPast]];
+    }];
+    for (NSURL *fileURL in fileURLs) {
+        if (totalBytes <= MAX_NOTIFICATION_MEDIA_CACHE_SIZE_BYTES)
+            break;
+        NSNumber *fileSize;
+        [fileURL getResourceValue:&fileSize forKey:NSURLFileAllocatedSizeKey error:nil];
+        if ([[NSFileManager defaultManager] removeItemAtURL:fileURL error:nil])
+            totalBytes -= MIN(totalBytes, fileSize.unsignedLongLongValue);
+    }
+}
+
+@end
@@ -32,5 +32,7 @@
 @interface OneSignalExtensionBadgeHandler : NSObject
 + (void)handleBadgeCountWithNotificationRequest:(UNNotificationRequest *)request withNotification:(OSNotification *)notification withMutableNotificationContent:(UNMutableNotificationContent *)replacementContent;
 + (void)updateCachedBadgeValue:(NSInteger)value;
+// Persists the value on a background queue, a burst of updates is written once with the latest value
++ (void)setNeedsCachedBadgeValue:(NSInteger)value;
 + (NSInteger)currentCachedBadgeValue;
 @end
@@ -25,6 +25,7 @@
  * THE SOFTWARE.
  */
 
+#import <sys/file.h>
 #import "OneSignalExtensionBadgeHandler.h"
 
 @implementation OneSignalExtensionBadgeHandler
@@ -40,27 +41,108 @@
         return;
     }
     
-    int currentValue = (int)OneSignalExtensionBadgeHandler.currentCachedBadgeValue ?: 0;
-    
-    currentValue += (int)notification.badgeIncrement;
-    
-    //cannot have negative badge values
-    if (currentValue < 0)
-        currentValue = 0;
+    // Read and incremented under one lock, so a burst of notifications handled by
+    //  several extension processes counts every increment
+    NSInteger currentValue = [OneSignalExtensionBadgeHandler modifyCachedBadgeValue:^NSInteger(NSInteger value) {
+        //cannot have negative badge values
+        return MAX(value + notification.badgeIncrement, 0);
+    }];
     
     replacementContent.badge = @(currentValue);
-    
-    [OneSignalExtensionBadgeHandler updateCachedBadgeValue:currentValue];
 }
 
 + (NSInteger)currentCachedBadgeValue {
-    return [OneSignalUserDefaults.initShared getSavedIntegerForKey:ONESIGNAL_BADGE_KEY defaultValue:0];
+    return [OneSignalExtensionBadgeHandler modifyCachedBadgeValue:^NSInteger(NSInteger value) {
+        return value;
+    }];
 }
 
 + (void)updateCachedBadgeValue:(NSInteger)value {
-    // Since badge logic can be executed in an extension, we need to use app groups to get
-    //  a shared NSUserDefaults from the app group suite name
-    [OneSignalUserDefaults.initShared saveIntegerForKey:ONESIGNAL_BADGE_KEY withValue:value];
+    [OneSignalExtensionBadgeHandler modifyCachedBadgeValue:^NSInteger(NSInteger currentValue) {
+        return value;
+    }];
+}
+
+// The value waiting on a scheduled write, nil if none. Access is synchronized on the class.
+static NSNumber *_pendingBadgeValue;
+
++ (void)setNeedsCachedBadgeValue:(NSInteger)value {
+    @synchronized (self) {
+        BOOL writeScheduled = _pendingBadgeValue != nil;
+        _pendingBadgeValue = @(value);
+        if (writeScheduled)
+            return;
+    }
+    dispatch_async(dispatch_get_global_queue(QOS_CLASS_UTILITY, 0), ^{
+        [OneSignalExtensionBadgeHandler writePendingCachedBadgeValue];
+    });
+}
+
++ (void)writePendingCachedBadgeValue {
+    NSNumber *pendingValue;
+    @synchronized (self) {
+        pendingValue = _pendingBadgeValue;
+        _pendingBadgeValue = nil;
+    }
+    if (pendingValue)
+        [OneSignalExtensionBadgeHandler writeCachedBadgeValue:^NSInteger(NSInteger currentValue) {
+            return pendingValue.integerValue;
+        }];
+}
+
+// nil if the app group is not set up, the count then falls back to the shared NSUserDefaults
++ (NSString *)badgeCounterPath {
+    static NSString *badgeCounterPath;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        NSURL *container = [[NSFileManager defaultManager] containerURLForSecurityApplicationGroupIdentifier:[OneSignalUserDefaults appGroupName]];
+        if (container) {
+            badgeCounterPath = [container URLByAppendingPathComponent:ONESIGNAL_BADGE_COUNTER_FILE].path;
+            [[NSFileManager defaultManager] createDirectoryAtPath:badgeCounterPath.stringByDeletingLastPathComponent withIntermediateDirectories:YES attributes:nil error:nil];
+        }
+    });
+    return badgeCounterPath;
+}
+
+/*
+ Applies `modify` to the cached badge count and returns the new count.
+ Since badge logic can be executed in an extension, the count is kept in the app group.
+ An exclusive flock across the read and the write makes the update atomic between processes,
+    and a single pwrite of the value avoids synchronizing NSUserDefaults on every badge change.
+ A value still waiting on a scheduled write is written first, so it is never applied after this update.
+ */
++ (NSInteger)modifyCachedBadgeValue:(NSInteger (^)(NSInteger value))modify {
+    [self writePendingCachedBadgeValue];
+    return [self writeCachedBadgeValue:modify];
+}
+
++ (NSInteger)writeCachedBadgeValue:(NSInteger (^)(NSInteger value))modify {
+    let sharedUserDefaults = OneSignalUserDefaults.initShared;
+    NSString *path = [self badgeCounterPath];
+    int fd = path ? open(path.fileSystemRepresentation, O_RDWR | O_CREAT, 0644) : -1;
+    if (fd < 0) {
+        @synchronized (self) {
+            NSInteger value = [sharedUserDefaults getSavedIntegerForKey:ONESIGNAL_BADGE_KEY defaultValue:0];
+            NSInteger newValue = modify(value);
+            if (newValue != value)
+                [sharedUserDefaults saveIntegerForKey:ONESIGNAL_BADGE_KEY withValue:newValue];
+            return newValue;
+        }
+    }
+    
+    flock(fd, LOCK_EX);
+    int64_t value = 0;
+    BOOL hasValue = pread(fd, &value, sizeof(value), 0) == sizeof(value);
+    // The first update after upgrading starts from the count earlier versions saved to NSUserDefaults
+    if (!hasValue)
+        value = [sharedUserDefaults getSavedIntegerForKey:ONESIGNAL_BADGE_KEY defaultValue:0];
+    int64_t newValue = modify((NSInteger)value);
+    if (!hasValue || newValue != value)
+        pwrite(fd, &newValue, sizeof(newValue), 0);
+    flock(fd, LOCK_UN);
+    close(fd);
+    
+    return (NSInteger)newValue;
 }
 
 @end
@@ -37,6 +37,9 @@
                            @"player_id": playerId ?: [NSNull null],
                            @"device_type": @0};
     request.method = PUT;
+    request.priority = OSRequestPriorityLow;
+    // Handed to the system so the NSE does not have to stay alive until it is sent
+    request.deferrable = true;
     request.path = [NSString stringWithFormat:@"notifications/%@/report_received", notificationId];
 
     return request;
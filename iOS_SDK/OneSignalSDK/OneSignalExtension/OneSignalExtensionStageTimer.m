@@ -0,0 +1,93 @@
+/*
+ Modified MIT License
+
+ Copyright 2024 OneSignal
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ 1. The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ 2. All copies of substantial portions of the Software may only be used in connection
+ with services provided by OneSignal.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ */
+
+#import "OneSignalExtensionStageTimer.h"
+#import <OneSignalCore/OneSignalCore.h>
+
+@implementation OneSignalExtensionStageTimer {
+    NSTimeInterval startTime;
+    NSTimeInterval budget;
+    NSMutableDictionary<NSString *, NSNumber *> *stageMilliseconds;
+    NSMutableArray<NSString *> *skippedStages;
+}
+
+- (instancetype)initWithBudget:(NSTimeInterval)aBudget {
+    if (self = [super init]) {
+        // systemUptime is monotonic, wall clock changes can't skew the timings
+        startTime = NSProcessInfo.processInfo.systemUptime;
+        budget = aBudget;
+        stageMilliseconds = [NSMutableDictionary new];
+        skippedStages = [NSMutableArray new];
+    }
+    return self;
+}
+
+- (NSTimeInterval)elapsedTime {
+    return NSProcessInfo.processInfo.systemUptime - startTime;
+}
+
+- (void)measureStage:(NSString *)stage block:(void (^)(void))block {
+    let stageStart = NSProcessInfo.processInfo.systemUptime;
+    block();
+    let milliseconds = (NSProcessInfo.processInfo.systemUptime - stageStart) * 1000;
+    @synchronized (self) {
+        stageMilliseconds[stage] = @(lround(milliseconds));
+    }
+}
+
+- (void)skipStage:(NSString *)stage {
+    [OneSignalLog onesignalLog:ONE_S_LL_WARN message:[NSString stringWithFormat:@"NSE skipping %@ with %.1fs of its budget left", stage, [self remainingTime]]];
+    @synchronized (self) {
+        [skippedStages addObject:stage];
+    }
+}
+
+- (NSTimeInterval)remainingTime {
+    return MAX(0, budget - [self elapsedTime]);
+}
+
+- (BOOL)hasTimeRemaining:(NSTimeInterval)seconds {
+    return [self remainingTime] >= seconds;
+}
+
+- (void)saveForNotificationId:(NSString *)notificationId {
+    NSDictionary *timings;
+    @synchronized (self) {
+        timings = @{
+            @"notification_id" : notificationId ?: @"",
+            @"total_ms" : @(lround([self elapsedTime] * 1000)),
+            @"stages_ms" : [stageMilliseconds copy],
+            @"skipped" : [skippedStages copy]
+        };
+    }
+    ONE_S_LOG(ONE_S_LL_VERBOSE, @"NSE stage timings: %@", timings);
+    [OneSignalUserDefaults.initShared saveDictionaryForKey:OSUD_NSE_LAST_STAGE_TIMINGS withValue:timings];
+    // Saved as the NSE run ends, a staged write would wait on a delayed flush the process may not live to see
+    [OneSignalUserDefaults flushPendingWrites];
+}
+
+@end
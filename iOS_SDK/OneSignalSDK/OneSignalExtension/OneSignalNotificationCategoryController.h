@@ -38,6 +38,10 @@ NS_ASSUME_NONNULL_BEGIN
  
  The SDK automatically prunes notification categories once more
  than MAX_CATEGORIES_SIZE categories have been registered.
+ 
+ Categories are also remembered by their button layout, so notifications
+ with the same buttons reuse a registered category instead of registering
+ a new one with UNUserNotificationCenter.
  */
 
 @interface OneSignalNotificationCategoryController : NSObject
@@ -46,6 +50,11 @@ NS_ASSUME_NONNULL_BEGIN
 
 - (NSString *)registerNotificationCategoryForNotificationId:(NSString *)notificationId;
 
+// The category ID registered for an identical button layout, or nil if one still has to be registered
+- (NSString * _Nullable)registeredCategoryIdForActionButtons:(NSArray *)actionButtons;
+
+- (void)saveCategoryId:(NSString *)categoryId forActionButtons:(NSArray *)actionButtons;
+
 - (NSMutableSet<UNNotificationCategory*>*)existingCategories;
 
 @end
@@ -61,6 +61,8 @@
         [self pruneCategories:mutableExisting];
         
         [mutableExisting removeObjectsInRange:NSMakeRange(0, mutableExisting.count - MAX_CATEGORIES_SIZE)];
+        
+        [self removeLayoutsForCategoryIdsNotIn:mutableExisting];
     }
     
     [OneSignalUserDefaults.initShared saveObjectForKey:SHARED_CATEGORY_LIST withValue:mutableExisting];
@@ -96,6 +98,71 @@
     return categoryId;
 }
 
+/*
+ A button layout is identified by the SHA1 of its JSON with sorted keys, so the same
+ buttons in the same order always hash the same regardless of the notification they came with
+ */
+- (NSString *)layoutHashForActionButtons:(NSArray *)actionButtons {
+    if (![NSJSONSerialization isValidJSONObject:actionButtons])
+        return nil;
+    
+    let data = [NSJSONSerialization dataWithJSONObject:actionButtons options:NSJSONWritingSortedKeys error:nil];
+    if (!data)
+        return nil;
+    
+    return [OneSignalCoreHelper hashUsingSha1:[[NSString alloc] initWithData:data encoding:NSUTF8StringEncoding]];
+}
+
+- (NSDictionary<NSString *, NSString *> *)registeredLayouts {
+    return [OneSignalUserDefaults.initShared getSavedObjectForKey:SHARED_CATEGORY_LAYOUTS defaultValue:[NSDictionary new]];
+}
+
+/*
+ The reused category is moved to the end of the saved category ID's,
+ so it is pruned last while new notifications still depend on it
+ */
+- (NSString *)registeredCategoryIdForActionButtons:(NSArray *)actionButtons {
+    let layoutHash = [self layoutHashForActionButtons:actionButtons];
+    if (!layoutHash)
+        return nil;
+    
+    NSString *categoryId = self.registeredLayouts[layoutHash];
+    if (!categoryId)
+        return nil;
+    
+    NSMutableArray<NSString *> *mutableExisting = [self.existingRegisteredCategoryIds mutableCopy];
+    if (![mutableExisting containsObject:categoryId])
+        return nil;
+    
+    if (![mutableExisting.lastObject isEqualToString:categoryId]) {
+        [mutableExisting removeObject:categoryId];
+        [mutableExisting addObject:categoryId];
+        [OneSignalUserDefaults.initShared saveObjectForKey:SHARED_CATEGORY_LIST withValue:mutableExisting];
+    }
+    
+    return categoryId;
+}
+
+- (void)saveCategoryId:(NSString *)categoryId forActionButtons:(NSArray *)actionButtons {
+    let layoutHash = [self layoutHashForActionButtons:actionButtons];
+    if (!layoutHash)
+        return;
+    
+    NSMutableDictionary<NSString *, NSString *> *layouts = [self.registeredLayouts mutableCopy];
+    layouts[layoutHash] = categoryId;
+    [OneSignalUserDefaults.initShared saveObjectForKey:SHARED_CATEGORY_LAYOUTS withValue:layouts];
+}
+
+- (void)removeLayoutsForCategoryIdsNotIn:(NSArray<NSString *> *)categoryIds {
+    let keptIds = [NSSet setWithArray:categoryIds];
+    NSMutableDictionary<NSString *, NSString *> *layouts = [self.registeredLayouts mutableCopy];
+    for (NSString *layoutHash in layouts.allKeys) {
+        if (![keptIds containsObject:layouts[layoutHash]])
+            [layouts removeObjectForKey:layoutHash];
+    }
+    [OneSignalUserDefaults.initShared saveObjectForKey:SHARED_CATEGORY_LAYOUTS withValue:layouts];
+}
+
 // Get all existing Notifications Categories in a blocking way
 - (NSMutableSet<UNNotificationCategory*>*)existingCategories {
     __block NSMutableSet* allCategories;
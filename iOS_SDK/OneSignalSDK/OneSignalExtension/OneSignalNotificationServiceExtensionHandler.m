@@ -26,11 +26,11 @@
  */
 
 #import <OneSignalCore/OneSignalCore.h>
-#import <OneSignalOutcomes/OneSignalOutcomes.h>
 #import "OneSignalNotificationServiceExtensionHandler.h"
 #import "OneSignalExtensionBadgeHandler.h"
 #import "OneSignalReceiveReceiptsController.h"
 #import "OneSignalAttachmentHandler.h"
+#import "OneSignalExtensionStageTimer.h"
 
 @implementation OneSignalNotificationServiceExtensionHandler
 
@@ -45,6 +45,7 @@
 + (UNMutableNotificationContent*)didReceiveNotificationExtensionRequest:(UNNotificationRequest*)request             withMutableNotificationContent:(UNMutableNotificationContent*)replacementContent
                 withContentHandler:(void (^)(UNNotificationContent * _Nonnull))contentHandler {
     [OneSignalLog onesignalLog:ONE_S_LL_VERBOSE message:@"NSE request received"];
+    let timer = [[OneSignalExtensionStageTimer alloc] initWithBudget:MAX_NSE_LIFETIME_SECOUNDS - NSE_BUDGET_RESERVE_SECONDS];
     
     if (!replacementContent)
         replacementContent = [request.content mutableCopy];
@@ -59,31 +60,44 @@
     OSNotification *notification = [OSNotification parseWithApns:replacementContent.userInfo];
 
     // Handle badge count
-    [OneSignalExtensionBadgeHandler handleBadgeCountWithNotificationRequest:request withNotification:notification withMutableNotificationContent:replacementContent];
+    [timer measureStage:@"badge" block:^{
+        [OneSignalExtensionBadgeHandler handleBadgeCountWithNotificationRequest:request withNotification:notification withMutableNotificationContent:replacementContent];
+    }];
     
     // Track receieved
-    [OneSignalTrackFirebaseAnalytics trackReceivedEvent:notification];
+    [timer measureStage:@"analytics" block:^{
+        [OneSignalTrackFirebaseAnalytics trackReceivedEvent:notification];
+    }];
 
     // Action Buttons
-    [self addActionButtonsToExtentionRequest:request
-                                 withNotification:notification
-              withMutableNotificationContent:replacementContent];
+    [timer measureStage:@"category_registration" block:^{
+        [self addActionButtonsToExtentionRequest:request
+                                     withNotification:notification
+                  withMutableNotificationContent:replacementContent];
+    }];
     
     // Get and check the received notification id
     NSString *receivedNotificationId = notification.notificationId;
     
     // Trigger the notification to be shown with the replacementContent
     if (contentHandler) {
-        dispatch_semaphore_t semaphore = dispatch_semaphore_create(0);
-        [self onNotificationReceived:receivedNotificationId withBlockingTask:semaphore];
-        // Download Media Attachments after kicking off the confirmed delivery task
-        [OneSignalAttachmentHandler addAttachments:notification toNotificationContent:replacementContent];
+        [timer measureStage:@"receipt" block:^{
+            [self onNotificationReceived:receivedNotificationId randomizeDelivery:YES];
+        }];
+        // Download Media Attachments after handing off the confirmed delivery
+        [self addAttachments:notification toNotificationContent:replacementContent withTimer:timer];
+        [timer saveForNotificationId:receivedNotificationId];
+        // The NSE process can be killed as soon as the content handler is called
+        [OneSignalUserDefaults flushPendingWrites];
         contentHandler(replacementContent);
-        dispatch_semaphore_wait(semaphore, dispatch_time(DISPATCH_TIME_NOW, MAX_NSE_LIFETIME_SECOUNDS * NSEC_PER_SEC));
     } else {
-        [self onNotificationReceived:receivedNotificationId withBlockingTask:nil];
+        [timer measureStage:@"receipt" block:^{
+            [self onNotificationReceived:receivedNotificationId randomizeDelivery:NO];
+        }];
         // Download Media Attachments
-        [OneSignalAttachmentHandler addAttachments:notification toNotificationContent:replacementContent];
+        [self addAttachments:notification toNotificationContent:replacementContent withTimer:timer];
+        [timer saveForNotificationId:receivedNotificationId];
+        [OneSignalUserDefaults flushPendingWrites];
     }
 
     return replacementContent;
@@ -109,11 +123,15 @@
     if (!replacementContent)
         replacementContent = [request.content mutableCopy];
     
+    [OneSignalAttachmentHandler cancelAttachmentDownloads];
+    
     let notification = [OSNotification parseWithApns:request.content.userInfo];
     
     [self addActionButtonsToExtentionRequest:request
                                  withNotification:notification
               withMutableNotificationContent:replacementContent];
+
+    [OneSignalUserDefaults flushPendingWrites];
     
     return replacementContent;
 }
@@ -129,32 +147,46 @@
     [OneSignalAttachmentHandler addActionButtons:notification toNotificationContent:replacementContent];
 }
 
-+ (void)onNotificationReceived:(NSString *)receivedNotificationId withBlockingTask:(dispatch_semaphore_t)semaphore {
+// Downloads are optional, they are skipped when too little of the budget is left and otherwise limited to what remains
++ (void)addAttachments:(OSNotification *)notification
+ toNotificationContent:(UNMutableNotificationContent *)replacementContent
+             withTimer:(OneSignalExtensionStageTimer *)timer {
+    if (!notification.attachments)
+        return;
+    if (![timer hasTimeRemaining:NSE_MIN_ATTACHMENT_DOWNLOAD_SECONDS]) {
+        [timer skipStage:@"download"];
+        return;
+    }
+    [timer measureStage:@"download" block:^{
+        [OneSignalAttachmentHandler addAttachments:notification toNotificationContent:replacementContent withinSeconds:[timer remainingTime]];
+    }];
+}
+
++ (void)onNotificationReceived:(NSString *)receivedNotificationId randomizeDelivery:(BOOL)randomizeDelivery {
     if (receivedNotificationId && ![receivedNotificationId isEqualToString:@""]) {
-        // If update was made without app being initialized/launched before -> migrate
-        [OSOutcomes migrate];
-        [OneSignalLog onesignalLog:ONE_S_LL_VERBOSE message:[NSString stringWithFormat:@"NSE request received, sessionManager: %@", [OSSessionManager sharedSessionManager]]];
-        // Save received notification id
-        [[OSSessionManager sharedSessionManager] onNotificationReceived:receivedNotificationId];
+        ONE_S_LOG(ONE_S_LL_VERBOSE, @"NSE request received, notificationId: %@", receivedNotificationId);
+        // Redelivered notifications still get their content, but are only tracked and confirmed once
+        if (![OSProcessedNotifications claimNotificationId:receivedNotificationId kind:OS_PROCESSED_NOTIFICATION_RECEIVED]) {
+            ONE_S_LOG(ONE_S_LL_VERBOSE, @"NSE notificationId: %@ was already received, not tracking it again", receivedNotificationId);
+            return;
+        }
+        // Left for the app's session manager to attribute, instead of loading outcomes and the session trackers into the NSE
+        [OSPendingReceivedNotifications addNotificationId:receivedNotificationId];
         
         // Track confirmed delivery
         let sharedUserDefaults = OneSignalUserDefaults.initShared;
         let playerId = [sharedUserDefaults getSavedStringForKey:OSUD_PUSH_SUBSCRIPTION_ID defaultValue:nil];
         let appId = [sharedUserDefaults getSavedStringForKey:OSUD_APP_ID defaultValue:nil];
-        // Randomize send of confirmed deliveries to lessen traffic for high recipient notifications
-        int randomDelay = semaphore != nil ? arc4random_uniform(MAX_CONF_DELIVERY_DELAY) : 0;
-        [OneSignalLog onesignalLog:ONE_S_LL_VERBOSE message:[NSString stringWithFormat:@"OneSignal onNotificationReceived sendReceiveReceipt with delay: %i", randomDelay]];
+        // Randomize send of confirmed deliveries to lessen traffic for high recipient notifications.
+        // The system holds the upload for the delay, so the NSE can finish as soon as the content is ready.
+        int randomDelay = randomizeDelivery ? arc4random_uniform(MAX_CONF_DELIVERY_DELAY) : 0;
+        ONE_S_LOG(ONE_S_LL_VERBOSE, @"OneSignal onNotificationReceived sendReceiveReceipt with delay: %i", randomDelay);
         OneSignalReceiveReceiptsController *controller = [OneSignalReceiveReceiptsController new];
+        // These blocks only run if the NSE process is still alive when the upload finishes
         [controller sendReceiveReceiptWithPlayerId:playerId notificationId:receivedNotificationId appId:appId delay:randomDelay successBlock:^(NSDictionary *result) {
-            [OneSignalLog onesignalLog:ONE_S_LL_VERBOSE message:[NSString stringWithFormat:@"OneSignal onNotificationReceived sendReceiveReceipt Success for playerId: %@ result: %@", playerId, result]];
-            if (semaphore) {
-                dispatch_semaphore_signal(semaphore);
-            }
+            ONE_S_LOG(ONE_S_LL_VERBOSE, @"OneSignal onNotificationReceived sendReceiveReceipt Success for playerId: %@ result: %@", playerId, result);
         } failureBlock:^(NSError *error) {
             [OneSignalLog onesignalLog:ONE_S_LL_ERROR message:[NSString stringWithFormat:@"OneSignal onNotificationReceived sendReceiveReceipt Failed for playerId: %@ error: %@", playerId, error]];
-            if (semaphore) {
-                dispatch_semaphore_signal(semaphore);
-            }
         }];
    }
 }
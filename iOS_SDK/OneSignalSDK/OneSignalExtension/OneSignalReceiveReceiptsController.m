@@ -64,8 +64,8 @@
                           notificationId:notificationId
                                    appId:appId
                                    delay:0
-                            successBlock:nil
-                            failureBlock:nil];
+                            successBlock:success
+                            failureBlock:failure];
 }
 
 - (void)sendReceiveReceiptWithPlayerId:(nonnull NSString *)playerId
@@ -93,20 +93,19 @@
     }
 
     let request = [OSRequestReceiveReceipts withPlayerId:playerId notificationId:notificationId appId:appId];
+    // The background upload session holds the request for the delay, the process does not need to outlive it
+    request.deferralDelay = [OSPowerPolicy.sharedPolicy telemetryDeferral:delay];
 
-    dispatch_time_t dispatchTime = dispatch_time(DISPATCH_TIME_NOW, delay * NSEC_PER_SEC);
-    dispatch_after(dispatchTime, dispatch_get_main_queue(), ^{
-        [OneSignalLog onesignalLog:ONE_S_LL_VERBOSE message:[NSString stringWithFormat:@"OneSignal sendReceiveReceiptWithPlayerId now sending confirmed delievery after: %i second delay", delay]];
-        [OneSignalCoreImpl.sharedClient executeRequest:request onSuccess:^(NSDictionary *result) {
-            if (success) {
-                success(result);
-            }
-        } onFailure:^(OneSignalClientError *error) {
-            if (failure) {
-                failure(error.underlyingError);
-            }
-        }];
-    });
+    ONE_S_LOG(ONE_S_LL_VERBOSE, @"OneSignal sendReceiveReceiptWithPlayerId scheduling confirmed delievery after: %i second delay", (int)request.deferralDelay);
+    [OneSignalCoreImpl.sharedClient executeRequest:request onSuccess:^(NSDictionary *result) {
+        if (success) {
+            success(result);
+        }
+    } onFailure:^(OneSignalClientError *error) {
+        if (failure) {
+            failure(error.underlyingError);
+        }
+    }];
 }
 
 @end
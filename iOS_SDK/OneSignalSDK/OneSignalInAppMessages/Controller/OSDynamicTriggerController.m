@@ -28,6 +28,7 @@
 #import "OSDynamicTriggerController.h"
 #import "OSInAppMessagingDefines.h"
 #import "OneSignalCommonDefines.h"
+#import <OneSignalCore/OSDispatchQueues.h>
 #import "OSMessagingController.h"
 #import <OneSignalOutcomes/OneSignalOutcomes.h>
 #import "OSSessionManager.h"
@@ -35,14 +36,21 @@
 @interface OSDynamicTriggerController ()
 
 /*
- Maps messageId's to future scheduled time-based triggers
+ Maps triggerId's of future scheduled time-based triggers to their deadline
  For example, a message might conceivably have a session_duration trigger
  and an os_time trigger both scheduled for the future
 
- This dictionary prevents the SDK from scheduling multiple duplicate timers
+ This dictionary prevents the SDK from scheduling multiple duplicate deadlines
  for the same messageId + trigger type
  */
-@property (strong, nonatomic, nonnull) NSMutableSet<NSString *> *scheduledMessages;
+@property (strong, nonatomic, nonnull) NSMutableDictionary<NSString *, NSDate *> *scheduledMessages;
+
+/*
+ A single timer on a background queue is armed for the earliest deadline,
+ instead of one main run loop timer per trigger
+ */
+@property (strong, nonatomic, nonnull) dispatch_queue_t timerQueue;
+@property (strong, nonatomic, nullable) dispatch_source_t timer;
 
 @end
 
@@ -50,7 +58,8 @@
 
 - (instancetype)init {
     if (self = [super init]) {
-        self.scheduledMessages = [NSMutableSet new];
+        self.scheduledMessages = [NSMutableDictionary new];
+        self.timerQueue = dispatch_queue_create_with_target("com.onesignal.iam.dynamicTriggers", DISPATCH_QUEUE_SERIAL, OSDispatchQueues.utility);
         self.timeSinceLastMessage = [NSDate distantPast];
     }
     
@@ -58,16 +67,14 @@
 }
 
 - (BOOL)dynamicTriggerShouldFire:(OSTrigger *)trigger withMessageId:(NSString *)messageId {
-    if (!trigger.value)
+    // All time-based trigger values should be numbers (either timestamps or offsets)
+    if (trigger.valueType != OSTriggerValueTypeNumber)
         return false;
 
     @synchronized (self.scheduledMessages) {
-        // All time-based trigger values should be numbers (either timestamps or offsets)
-        if (![trigger.value isKindOfClass:[NSNumber class]])
-            return false;
 
         // Timer already set for this message trigger
-        if ([self.scheduledMessages containsObject:trigger.triggerId])
+        if (self.scheduledMessages[trigger.triggerId])
             return false;
 
         let requiredTimeValue = [trigger.value doubleValue];
@@ -76,16 +83,16 @@
         var offset = 0.0f;
 
         // Check what type of trigger it is
-        if ([trigger.kind isEqualToString:OS_DYNAMIC_TRIGGER_KIND_SESSION_TIME]) {
+        if (trigger.kindType == OSTriggerKindTypeSessionTime) {
             let currentDuration = fabs([[OSSessionManager.sharedSessionManager sessionLaunchTime] timeIntervalSinceNow]);
             if ([self evaluateTimeInterval:requiredTimeValue withCurrentValue:currentDuration forOperator:trigger.operatorType]) {
-                [OneSignalLog onesignalLog:ONE_S_LL_VERBOSE message:[NSString stringWithFormat:@"session time trigger completed: %@", trigger.triggerId]];
+                ONE_S_LOG(ONE_S_LL_VERBOSE, @"session time trigger completed: %@", trigger.triggerId);
                 [self.delegate dynamicTriggerCompleted:trigger.triggerId];
                 //[self.delegate dynamicTriggerFired:trigger.triggerId];
                 return true;
             }
             offset = requiredTimeValue - currentDuration;
-        } else if ([trigger.kind isEqualToString:OS_DYNAMIC_TRIGGER_KIND_MIN_TIME_SINCE]) {
+        } else if (trigger.kindType == OSTriggerKindTypeMinTimeSince) {
 
             // Make sure no IAM are showng before handling "since_last_message" trigger kind
             if (OSMessagingController.sharedInstance.isInAppMessageShowing)
@@ -94,7 +101,7 @@
             let timestampSinceLastMessage = fabs([self.timeSinceLastMessage timeIntervalSinceNow]);
 
             if ([self evaluateTimeInterval:requiredTimeValue withCurrentValue:timestampSinceLastMessage forOperator:trigger.operatorType]) {
-                [OneSignalLog onesignalLog:ONE_S_LL_VERBOSE message:[NSString stringWithFormat:@"time since last inapp trigger completed: %@", trigger.triggerId]];
+                ONE_S_LOG(ONE_S_LL_VERBOSE, @"time since last inapp trigger completed: %@", trigger.triggerId);
                 return true;
             }
             offset = requiredTimeValue - timestampSinceLastMessage;
@@ -104,18 +111,10 @@
         if (offset <= 0.0f)
             return false;
 
-        // If we reach this point, it means we need to return false and set up a timer for a future time
-        NSTimer *timer = [NSTimer timerWithTimeInterval:offset
-                                            target:self
-                                          selector:@selector(timerFiredForMessage:)
-                                          userInfo:@{@"trigger" : trigger}
-                                           repeats:false];
-        if (timer) {
-            [OneSignalLog onesignalLog:ONE_S_LL_VERBOSE message:[NSString stringWithFormat:@"timer added for triggerId: %@, messageId: %@", trigger.triggerId, messageId]];
-            [[NSRunLoop mainRunLoop] addTimer:timer forMode:NSRunLoopCommonModes];
-        }
-
-        [self.scheduledMessages addObject:trigger.triggerId];
+        // If we reach this point, it means we need to return false and schedule a deadline for a future time
+        ONE_S_LOG(ONE_S_LL_VERBOSE, @"deadline added for triggerId: %@, messageId: %@", trigger.triggerId, messageId);
+        self.scheduledMessages[trigger.triggerId] = [NSDate dateWithTimeIntervalSinceNow:offset];
+        [self armTimer];
     }
     return false;
 }
@@ -144,14 +143,63 @@
     }
 }
 
-- (void)timerFiredForMessage:(NSTimer *)timer {
+// Must be called while synchronized on scheduledMessages
+- (void)armTimer {
+    NSDate *nextDeadline = nil;
+    for (NSDate *deadline in self.scheduledMessages.allValues) {
+        if (!nextDeadline || [deadline compare:nextDeadline] == NSOrderedAscending)
+            nextDeadline = deadline;
+    }
+
+    if (!nextDeadline) {
+        if (self.timer)
+            dispatch_source_cancel(self.timer);
+        self.timer = nil;
+        return;
+    }
+
+    if (!self.timer) {
+        self.timer = dispatch_source_create(DISPATCH_SOURCE_TYPE_TIMER, 0, 0, self.timerQueue);
+        __weak OSDynamicTriggerController *weakSelf = self;
+        dispatch_source_set_event_handler(self.timer, ^{
+            [weakSelf deadlinesReached];
+        });
+        dispatch_resume(self.timer);
+    }
+
+    let delay = MAX([nextDeadline timeIntervalSinceNow], 0);
+    dispatch_source_set_timer(self.timer,
+                              dispatch_time(DISPATCH_TIME_NOW, (int64_t)(delay * NSEC_PER_SEC)),
+                              DISPATCH_TIME_FOREVER,
+                              (uint64_t)(OS_DYNAMIC_TRIGGER_BATCH_WINDOW * NSEC_PER_SEC));
+}
+
+- (void)deadlinesReached {
+    BOOL fired = NO;
     @synchronized (self.scheduledMessages) {
-        let trigger = (OSTrigger *)timer.userInfo[@"trigger"];
+        // Fire every deadline within the batch window together with a single re-evaluation
+        let batchEnd = [NSDate dateWithTimeIntervalSinceNow:OS_DYNAMIC_TRIGGER_BATCH_WINDOW];
+        for (NSString *triggerId in self.scheduledMessages.allKeys) {
+            if ([self.scheduledMessages[triggerId] compare:batchEnd] != NSOrderedDescending) {
+                [self.scheduledMessages removeObjectForKey:triggerId];
+                fired = YES;
+            }
+        }
+        [self armTimer];
+    }
 
-        [self.scheduledMessages removeObject:trigger.triggerId];
+    if (!fired)
+        return;
 
+    // Messages are evaluated and displayed on the main thread
+    dispatch_async(dispatch_get_main_queue(), ^{
         [self.delegate dynamicTriggerFired];
-    }
+    });
+}
+
+- (void)dealloc {
+    if (_timer)
+        dispatch_source_cancel(_timer);
 }
 
 @end
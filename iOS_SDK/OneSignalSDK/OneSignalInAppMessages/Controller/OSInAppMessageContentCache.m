@@ -0,0 +1,165 @@
+/**
+ * Modified MIT License
+ *
+ * Copyright 2024 OneSignal
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * 2. All copies of substantial portions of the Software may only be used in connection
+ * with services provided by OneSignal.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#import "OSInAppMessageContentCache.h"
+#import <OneSignalCore/OneSignalCore.h>
+#import "OSInAppMessagingDefines.h"
+
+#define OS_IAM_CONTENT_CACHE_SEPARATOR @"_"
+
+@interface OSInAppMessageContentCache ()
+
+// All file access happens on this queue
+@property (strong, nonatomic, nonnull) dispatch_queue_t queue;
+@property (strong, nonatomic, nullable) NSURL *directory;
+
+@end
+
+@implementation OSInAppMessageContentCache
+
+static OSInAppMessageContentCache *_sharedCache;
++ (OSInAppMessageContentCache *)sharedCache {
+    if (!_sharedCache)
+        _sharedCache = [OSInAppMessageContentCache new];
+    return _sharedCache;
+}
+
+- (instancetype)init {
+    if (self = [super init]) {
+        _queue = dispatch_queue_create_with_target("com.onesignal.iam.contentCache", DISPATCH_QUEUE_SERIAL, OSDispatchQueues.utility);
+        NSURL *caches = [[NSFileManager defaultManager] URLsForDirectory:NSCachesDirectory inDomains:NSUserDomainMask].firstObject;
+        _directory = [caches URLByAppendingPathComponent:OS_IAM_CONTENT_CACHE_DIRECTORY isDirectory:YES];
+    }
+    return self;
+}
+
+- (NSURL *)fileURLForMessageId:(NSString *)messageId variantId:(NSString *)variantId {
+    NSString *name = [NSString stringWithFormat:@"%@%@%@.json", messageId, OS_IAM_CONTENT_CACHE_SEPARATOR, variantId];
+    return [_directory URLByAppendingPathComponent:name isDirectory:NO];
+}
+
+// The modification date tracks use for eviction, so age is measured from the creation date of the saved file
+- (BOOL)isExpiredFileAtURL:(NSURL *)fileURL {
+    NSDate *creationDate;
+    [fileURL getResourceValue:&creationDate forKey:NSURLCreationDateKey error:nil];
+    return creationDate && -[creationDate timeIntervalSinceNow] > OS_IAM_CONTENT_CACHE_MAX_AGE_SECONDS;
+}
+
+- (void)contentForMessageId:(NSString *)messageId variantId:(NSString *)variantId completion:(void (^)(NSDictionary *content))completion {
+    dispatch_async(_queue, ^{
+        NSURL *fileURL = [self fileURLForMessageId:messageId variantId:variantId];
+        if ([self isExpiredFileAtURL:fileURL]) {
+            [[NSFileManager defaultManager] removeItemAtURL:fileURL error:nil];
+            completion(nil);
+            return;
+        }
+        NSData *data = [NSData dataWithContentsOfURL:fileURL];
+        NSDictionary *content = data ? [NSJSONSerialization JSONObjectWithData:data options:0 error:nil] : nil;
+        if (![content isKindOfClass:[NSDictionary class]]) {
+            completion(nil);
+            return;
+        }
+        // Mark as recently used so size eviction drops it last
+        [[NSFileManager defaultManager] setAttributes:@{NSFileModificationDate : [NSDate date]} ofItemAtPath:fileURL.path error:nil];
+        completion(content);
+    });
+}
+
+- (BOOL)hasContentForMessageId:(NSString *)messageId variantId:(NSString *)variantId {
+    NSURL *fileURL = [self fileURLForMessageId:messageId variantId:variantId];
+    return [[NSFileManager defaultManager] fileExistsAtPath:fileURL.path] && ![self isExpiredFileAtURL:fileURL];
+}
+
+- (void)saveContent:(NSDictionary *)content forMessageId:(NSString *)messageId variantId:(NSString *)variantId {
+    if (![NSJSONSerialization isValidJSONObject:content])
+        return;
+
+    dispatch_async(_queue, ^{
+        NSData *data = [NSJSONSerialization dataWithJSONObject:content options:0 error:nil];
+        if (!data || data.length > OS_IAM_CONTENT_CACHE_MAX_BYTES)
+            return;
+
+        [[NSFileManager defaultManager] createDirectoryAtURL:self.directory withIntermediateDirectories:YES attributes:nil error:nil];
+        NSError *error;
+        if (![data writeToURL:[self fileURLForMessageId:messageId variantId:variantId] options:NSDataWritingAtomic error:&error]) {
+            [OneSignalLog onesignalLog:ONE_S_LL_ERROR message:[NSString stringWithFormat:@"OSInAppMessageContentCache failed to save content for message: %@ error: %@", messageId, error]];
+            return;
+        }
+        [self evictToSizeLimit];
+    });
+}
+
+- (void)removeContentForMessageIdsNotIn:(NSSet<NSString *> *)messageIds {
+    dispatch_async(_queue, ^{
+        for (NSURL *fileURL in [self cachedFileURLsWithKeys:@[]]) {
+            NSString *name = fileURL.lastPathComponent.stringByDeletingPathExtension;
+            NSString *messageId = [name componentsSeparatedByString:OS_IAM_CONTENT_CACHE_SEPARATOR].firstObject;
+            if (![messageIds containsObject:messageId])
+                [[NSFileManager defaultManager] removeItemAtURL:fileURL error:nil];
+        }
+    });
+}
+
+- (NSArray<NSURL *> *)cachedFileURLsWithKeys:(NSArray<NSURLResourceKey> *)keys {
+    return [[NSFileManager defaultManager] contentsOfDirectoryAtURL:_directory includingPropertiesForKeys:keys options:NSDirectoryEnumerationSkipsHiddenFiles error:nil] ?: @[];
+}
+
+// Must be called on the cache queue. Removes expired content, then the least recently used past the size limit.
+- (void)evictToSizeLimit {
+    NSArray<NSURLResourceKey> *keys = @[NSURLFileSizeKey, NSURLContentModificationDateKey, NSURLCreationDateKey];
+    NSMutableArray<NSURL *> *fileURLs = [NSMutableArray new];
+    unsigned long long totalBytes = 0;
+    for (NSURL *fileURL in [self cachedFileURLsWithKeys:keys]) {
+        if ([self isExpiredFileAtURL:fileURL]) {
+            [[NSFileManager defaultManager] removeItemAtURL:fileURL error:nil];
+            continue;
+        }
+        [fileURLs addObject:fileURL];
+        NSNumber *fileSize;
+        [fileURL getResourceValue:&fileSize forKey:NSURLFileSizeKey error:nil];
+        totalBytes += fileSize.unsignedLongLongValue;
+    }
+    if (totalBytes <= OS_IAM_CONTENT_CACHE_MAX_BYTES)
+        return;
+
+    [fileURLs sortUsingComparator:^NSComparisonResult(NSURL *first, NSURL *second) {
+        NSDate *firstDate, *secondDate;
+        [first getResourceValue:&firstDate forKey:NSURLContentModificationDateKey error:nil];
+        [second getResourceValue:&secondDate forKey:NSURLContentModificationDateKey error:nil];
+        return [firstDate ?: [NSDate distantPast] compare:secondDate ?: [NSDate distantPast]];
+    }];
+    for (NSURL *fileURL in fileURLs) {
+        if (totalBytes <= OS_IAM_CONTENT_CACHE_MAX_BYTES)
+            break;
+        NSNumber *fileSize;
+        [fileURL getResourceValue:&fileSize forKey:NSURLFileSizeKey error:nil];
+        if ([[NSFileManager defaultManager] removeItemAtURL:fileURL error:nil])
+            totalBytes -= MIN(totalBytes, fileSize.unsignedLongLongValue);
+    }
+}
+
+@end
@@ -36,6 +36,9 @@ NS_ASSUME_NONNULL_BEGIN
 - (void)loadMessageHTMLContentWithResult:(OSResultSuccessBlock _Nullable)successBlock failure:(OSFailureBlock _Nullable)failureBlock;
 - (void)loadPreviewMessageHTMLContentWithUUID:(NSString * _Nonnull)previewUUID success:(OSResultSuccessBlock _Nullable)successBlock failure:(OSFailureBlock _Nullable)failureBlock;
 
+// Downloads the message content into the content cache if it is not already cached
+- (void)prefetchMessageHTMLContent;
+
 - (NSString * _Nullable)variantId;
 
 @end
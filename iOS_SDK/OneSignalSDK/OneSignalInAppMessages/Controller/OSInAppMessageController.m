@@ -30,6 +30,7 @@
 #import <OneSignalUser/OneSignalUser.h>
 #import "OSInAppMessagingDefines.h"
 #import "OSInAppMessagingRequests.h"
+#import "OSInAppMessageContentCache.h"
 
 
 @implementation OSInAppMessageInternal (OSInAppMessageController)
@@ -44,10 +45,37 @@
         return;
     }
     
+    [OSInAppMessageContentCache.sharedCache contentForMessageId:self.messageId variantId:variantId completion:^(NSDictionary *content) {
+        if (content) {
+            ONE_S_LOG(ONE_S_LL_VERBOSE, @"Loaded cached HTML content for message ID: %@", self.messageId);
+            if (successBlock)
+                successBlock(content);
+            return;
+        }
+        [self requestMessageHTMLContentWithVariantId:variantId success:successBlock failure:failureBlock];
+    }];
+}
+
+- (void)prefetchMessageHTMLContent {
+    let variantId = [self variantId];
+    if (!variantId || [OSInAppMessageContentCache.sharedCache hasContentForMessageId:self.messageId variantId:variantId])
+        return;
+
+    [self requestMessageHTMLContentWithVariantId:variantId success:nil failure:^(NSError *error) {
+        ONE_S_LOG(ONE_S_LL_DEBUG, @"Failed to prefetch HTML content for message ID: %@ error: %@", self.messageId, error);
+    }];
+}
+
+- (void)requestMessageHTMLContentWithVariantId:(NSString *)variantId success:(OSResultSuccessBlock _Nullable)successBlock failure:(OSFailureBlock _Nullable)failureBlock {
     let request = [OSRequestLoadInAppMessageContent withAppId:[OneSignalConfigManager getAppId] withMessageId:self.messageId withVariantId:variantId];
     
-    [OneSignalCoreImpl.sharedClient executeRequest:request onSuccess:successBlock onFailure:^(OneSignalClientError *error) {
-        failureBlock(error.underlyingError);
+    [OneSignalCoreImpl.sharedClient executeRequest:request onSuccess:^(NSDictionary *result) {
+        [OSInAppMessageContentCache.sharedCache saveContent:result forMessageId:self.messageId variantId:variantId];
+        if (successBlock)
+            successBlock(result);
+    } onFailure:^(OneSignalClientError *error) {
+        if (failureBlock)
+            failureBlock(error.underlyingError);
     }];
 }
 
@@ -59,6 +87,22 @@
     }];
 }
 
+/*
+ Resolving walks the variants, so the result is kept with the language code it was resolved for.
+ Prefetching, display, redisplay and telemetry reuse it until the language changes.
+ */
+- (NSString * _Nullable)variantId {
+    // we only want the first two characters, ie. "en-US" we want "en"
+    NSString *userLanguageCode = [OneSignalUserManagerImpl.sharedInstance.language substringToIndex:2];
+    let resolved = self.resolvedVariant;
+    if (resolved && [resolved[0] isEqualToString:userLanguageCode ?: @""])
+        return resolved[1].length > 0 ? resolved[1] : nil;
+
+    NSString *variantId = [self variantIdForLanguageCode:userLanguageCode];
+    self.resolvedVariant = @[userLanguageCode ?: @"", variantId ?: @""];
+    return variantId;
+}
+
 /**
     The platform type should take precedence over a language match.
     So if, for example, a message has an 'ios' variant but it only
@@ -66,21 +110,19 @@
     variant over lower platforms (ie. 'all') even if they have a
     matching language.
 */
-- (NSString * _Nullable)variantId {
-    // we only want the first two characters, ie. "en-US" we want "en"
-    NSString *userLanguageCode = [OneSignalUserManagerImpl.sharedInstance.language substringToIndex:2];
-    
+- (NSString * _Nullable)variantIdForLanguageCode:(NSString * _Nullable)userLanguageCode {
+    let variants = self.variants;
     NSString *variantId;
     
     for (NSString *type in PREFERRED_VARIANT_ORDER) {
-        if (self.variants[type]) {
-            if (self.variants[type][userLanguageCode]) {
-                variantId = self.variants[type][userLanguageCode];
+        if (variants[type]) {
+            if (variants[type][userLanguageCode]) {
+                variantId = variants[type][userLanguageCode];
                 break;
             }
             
-            if (!variantId && self.variants[type][@"default"]) {
-                variantId = self.variants[type][@"default"];
+            if (!variantId && variants[type][@"default"]) {
+                variantId = variants[type][@"default"];
                 break;
             }
         }
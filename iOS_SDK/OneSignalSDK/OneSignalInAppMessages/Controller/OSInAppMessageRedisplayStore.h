@@ -0,0 +1,51 @@
+/*
+ Modified MIT License
+
+ Copyright 2024 OneSignal
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ 1. The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ 2. All copies of substantial portions of the Software may only be used in connection
+ with services provided by OneSignal.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ */
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*
+ Holds the display quantity and last display time of in-app messages that can redisplay, by message id
+ Each record is a small array of numbers instead of an archived message, and like the state store
+ changes are coalesced: setNeedsFlush schedules a single write after a short delay, which also happens when the app backgrounds
+ */
+@interface OSInAppMessageRedisplayStore : NSObject
+
+- (BOOL)containsMessageId:(NSString *)messageId;
+- (NSInteger)displayQuantityForMessageId:(NSString *)messageId;
+- (double)lastDisplayTimeForMessageId:(NSString *)messageId;
+- (void)setDisplayQuantity:(NSInteger)displayQuantity lastDisplayTime:(double)lastDisplayTime forMessageId:(NSString *)messageId;
+// Removes the records last displayed before the given time, returns if any were removed
+- (BOOL)removeRecordsDisplayedBefore:(double)time;
+
+- (void)setNeedsFlush;
+- (void)flush;
+
+@end
+
+NS_ASSUME_NONNULL_END
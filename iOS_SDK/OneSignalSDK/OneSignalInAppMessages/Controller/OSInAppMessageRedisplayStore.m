@@ -0,0 +1,161 @@
+/*
+ Modified MIT License
+
+ Copyright 2024 OneSignal
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ 1. The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ 2. All copies of substantial portions of the Software may only be used in connection
+ with services provided by OneSignal.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ */
+
+#import <UIKit/UIKit.h>
+#import <OneSignalCore/OneSignalCore.h>
+#import "OSInAppMessageRedisplayStore.h"
+#import "OSInAppMessageInternal.h"
+#import "OSInAppMessagingDefines.h"
+
+// Positions in a record array
+#define OS_IAM_REDISPLAY_QUANTITY_INDEX 0
+#define OS_IAM_REDISPLAY_LAST_DISPLAY_TIME_INDEX 1
+
+@interface OSInAppMessageRedisplayStore ()
+
+// Synchronized on itself, message id to @[displayQuantity, lastDisplayTime]
+@property (strong, nonatomic, nonnull) NSMutableDictionary<NSString *, NSArray<NSNumber *> *> *records;
+@property (nonatomic) BOOL flushScheduled;
+// Set when records were read from the legacy archive, so they are saved in the new format on the first flush
+@property (nonatomic) BOOL loadedLegacyRecords;
+
+@end
+
+@implementation OSInAppMessageRedisplayStore
+
+- (instancetype)init {
+    if (self = [super init]) {
+        [self loadRecords];
+        [[NSNotificationCenter defaultCenter] addObserver:self selector:@selector(flush) name:UIApplicationDidEnterBackgroundNotification object:nil];
+        [[NSNotificationCenter defaultCenter] addObserver:self selector:@selector(flush) name:UIApplicationWillTerminateNotification object:nil];
+    }
+    return self;
+}
+
+- (void)dealloc {
+    [[NSNotificationCenter defaultCenter] removeObserver:self];
+}
+
+- (void)loadRecords {
+    let standardUserDefaults = OneSignalUserDefaults.initStandard;
+    NSMutableDictionary *records = [NSMutableDictionary new];
+    NSDictionary *savedRecords = [standardUserDefaults getSavedDictionaryForKey:OS_IAM_REDISPLAY_STATS_KEY defaultValue:nil];
+    for (NSString *messageId in savedRecords) {
+        NSArray *record = savedRecords[messageId];
+        if ([record isKindOfClass:[NSArray class]] && record.count > OS_IAM_REDISPLAY_LAST_DISPLAY_TIME_INDEX)
+            records[messageId] = record;
+    }
+
+    /*
+     The archive of whole messages written by earlier versions is still read, and left in place, for one release.
+     An app rolled back to the previous version keeps its redisplay data, and messages it displays afterwards are picked up here.
+     TODO: Stop reading OS_IAM_REDISPLAY_DICTIONARY, and remove it, in the next release
+     */
+    NSDictionary *legacyMessages = [standardUserDefaults getSavedCodeableDataForKey:OS_IAM_REDISPLAY_DICTIONARY defaultValue:nil];
+    if ([legacyMessages isKindOfClass:[NSDictionary class]]) {
+        for (NSString *messageId in legacyMessages) {
+            OSInAppMessageInternal *message = legacyMessages[messageId];
+            if (![message isKindOfClass:[OSInAppMessageInternal class]])
+                continue;
+            // The most recent display wins, whichever version recorded it
+            if (records[messageId] && [records[messageId][OS_IAM_REDISPLAY_LAST_DISPLAY_TIME_INDEX] doubleValue] >= message.displayStats.lastDisplayTime)
+                continue;
+            records[messageId] = @[@(message.displayStats.displayQuantity), @(message.displayStats.lastDisplayTime)];
+            _loadedLegacyRecords = YES;
+        }
+    }
+    _records = records;
+}
+
+- (BOOL)containsMessageId:(NSString *)messageId {
+    @synchronized (self) {
+        return _records[messageId] != nil;
+    }
+}
+
+- (NSInteger)displayQuantityForMessageId:(NSString *)messageId {
+    @synchronized (self) {
+        return [_records[messageId][OS_IAM_REDISPLAY_QUANTITY_INDEX] integerValue];
+    }
+}
+
+- (double)lastDisplayTimeForMessageId:(NSString *)messageId {
+    @synchronized (self) {
+        return [_records[messageId][OS_IAM_REDISPLAY_LAST_DISPLAY_TIME_INDEX] doubleValue];
+    }
+}
+
+- (void)setDisplayQuantity:(NSInteger)displayQuantity lastDisplayTime:(double)lastDisplayTime forMessageId:(NSString *)messageId {
+    if (!messageId)
+        return;
+    @synchronized (self) {
+        _records[messageId] = @[@(displayQuantity), @(lastDisplayTime)];
+    }
+    [self setNeedsFlush];
+}
+
+- (BOOL)removeRecordsDisplayedBefore:(double)time {
+    NSMutableArray<NSString *> *messageIdsToRemove = [NSMutableArray new];
+    @synchronized (self) {
+        for (NSString *messageId in _records) {
+            if ([_records[messageId][OS_IAM_REDISPLAY_LAST_DISPLAY_TIME_INDEX] doubleValue] < time)
+                [messageIdsToRemove addObject:messageId];
+        }
+        [_records removeObjectsForKeys:messageIdsToRemove];
+    }
+    if (messageIdsToRemove.count == 0)
+        return NO;
+    [self setNeedsFlush];
+    return YES;
+}
+
+- (void)setNeedsFlush {
+    @synchronized (self) {
+        if (_flushScheduled)
+            return;
+        _flushScheduled = YES;
+    }
+    __weak OSInAppMessageRedisplayStore *weakSelf = self;
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(OS_IAM_STATE_FLUSH_DELAY * NSEC_PER_SEC)), OSDispatchQueues.utility, ^{
+        [weakSelf flush];
+    });
+}
+
+- (void)flush {
+    NSDictionary *records;
+    @synchronized (self) {
+        if (!_flushScheduled && !_loadedLegacyRecords)
+            return;
+        _flushScheduled = NO;
+        _loadedLegacyRecords = NO;
+        records = [_records copy];
+    }
+
+    [OneSignalUserDefaults.initStandard saveDictionaryForKey:OS_IAM_REDISPLAY_STATS_KEY withValue:records];
+}
+
+@end
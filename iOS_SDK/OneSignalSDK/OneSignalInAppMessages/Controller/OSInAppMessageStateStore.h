@@ -0,0 +1,58 @@
+/*
+ Modified MIT License
+
+ Copyright 2024 OneSignal
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ 1. The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ 2. All copies of substantial portions of the Software may only be used in connection
+ with services provided by OneSignal.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ */
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+typedef NS_ENUM(NSUInteger, OSInAppMessageStateSet) {
+    OSInAppMessageStateSetSeen,
+    OSInAppMessageStateSetImpressioned,
+    OSInAppMessageStateSetClicked,
+    OSInAppMessageStateSetViewedPages
+};
+
+/*
+ Holds the seen, impressioned, clicked and viewed page ids of in-app messages
+ All sets are persisted together as one versioned dictionary, and writes are coalesced:
+ setNeedsFlush schedules a single write after a short delay, which also happens when the app backgrounds
+ */
+@interface OSInAppMessageStateStore : NSObject
+
+- (BOOL)containsId:(NSString *)identifier inSet:(OSInAppMessageStateSet)set;
+// Returns false if the id was already in the set, so callers on different threads can claim an id once
+- (BOOL)addId:(NSString *)identifier toSet:(OSInAppMessageStateSet)set;
+- (void)removeId:(NSString *)identifier fromSet:(OSInAppMessageStateSet)set;
+- (void)removeAllIdsFromSet:(OSInAppMessageStateSet)set;
+- (NSSet<NSString *> *)idsInSet:(OSInAppMessageStateSet)set;
+
+- (void)setNeedsFlush;
+- (void)flush;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,149 @@
+/*
+ Modified MIT License
+
+ Copyright 2024 OneSignal
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ 1. The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ 2. All copies of substantial portions of the Software may only be used in connection
+ with services provided by OneSignal.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ */
+
+#import <UIKit/UIKit.h>
+#import <OneSignalCore/OneSignalCore.h>
+#import "OSInAppMessageStateStore.h"
+#import "OSInAppMessagingDefines.h"
+
+#define OS_IAM_STATE_VERSION_KEY @"version"
+#define OS_IAM_STATE_SET_KEYS @[@"seen", @"impressioned", @"clicked", @"viewed_pages"]
+#define OS_IAM_STATE_LEGACY_SET_KEYS @[OS_IAM_SEEN_SET_KEY, OS_IAM_IMPRESSIONED_SET_KEY, OS_IAM_CLICKED_SET_KEY, OS_IAM_PAGE_IMPRESSIONED_SET_KEY]
+
+@interface OSInAppMessageStateStore ()
+
+// Synchronized on itself
+@property (strong, nonatomic, nonnull) NSArray<NSMutableSet<NSString *> *> *sets;
+@property (nonatomic) BOOL flushScheduled;
+@property (nonatomic) BOOL migratedFromLegacySets;
+
+@end
+
+@implementation OSInAppMessageStateStore
+
+- (instancetype)init {
+    if (self = [super init]) {
+        [self loadSets];
+        [[NSNotificationCenter defaultCenter] addObserver:self selector:@selector(flush) name:UIApplicationDidEnterBackgroundNotification object:nil];
+        [[NSNotificationCenter defaultCenter] addObserver:self selector:@selector(flush) name:UIApplicationWillTerminateNotification object:nil];
+    }
+    return self;
+}
+
+- (void)dealloc {
+    [[NSNotificationCenter defaultCenter] removeObserver:self];
+}
+
+- (void)loadSets {
+    let standardUserDefaults = OneSignalUserDefaults.initStandard;
+    NSMutableArray *sets = [NSMutableArray new];
+    NSDictionary *state = [standardUserDefaults getSavedDictionaryForKey:OS_IAM_STATE_KEY defaultValue:nil];
+    if (state && [state[OS_IAM_STATE_VERSION_KEY] integerValue] <= OS_IAM_STATE_VERSION) {
+        for (NSString *setKey in OS_IAM_STATE_SET_KEYS) {
+            NSArray *ids = state[setKey];
+            [sets addObject:[ids isKindOfClass:[NSArray class]] ? [NSMutableSet setWithArray:ids] : [NSMutableSet new]];
+        }
+    } else {
+        // Read the separate sets written by earlier versions, they are removed on the first flush
+        for (NSString *legacyKey in OS_IAM_STATE_LEGACY_SET_KEYS)
+            [sets addObject:[[NSMutableSet alloc] initWithSet:[standardUserDefaults getSavedSetForKey:legacyKey defaultValue:nil]]];
+        _migratedFromLegacySets = !state;
+    }
+    _sets = sets;
+}
+
+- (BOOL)containsId:(NSString *)identifier inSet:(OSInAppMessageStateSet)set {
+    @synchronized (self) {
+        return [_sets[set] containsObject:identifier];
+    }
+}
+
+- (BOOL)addId:(NSString *)identifier toSet:(OSInAppMessageStateSet)set {
+    if (!identifier)
+        return NO;
+    @synchronized (self) {
+        if ([_sets[set] containsObject:identifier])
+            return NO;
+        [_sets[set] addObject:identifier];
+        return YES;
+    }
+}
+
+- (void)removeId:(NSString *)identifier fromSet:(OSInAppMessageStateSet)set {
+    if (!identifier)
+        return;
+    @synchronized (self) {
+        [_sets[set] removeObject:identifier];
+    }
+}
+
+- (void)removeAllIdsFromSet:(OSInAppMessageStateSet)set {
+    @synchronized (self) {
+        [_sets[set] removeAllObjects];
+    }
+}
+
+- (NSSet<NSString *> *)idsInSet:(OSInAppMessageStateSet)set {
+    @synchronized (self) {
+        return [_sets[set] copy];
+    }
+}
+
+- (void)setNeedsFlush {
+    @synchronized (self) {
+        if (_flushScheduled)
+            return;
+        _flushScheduled = YES;
+    }
+    __weak OSInAppMessageStateStore *weakSelf = self;
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(OS_IAM_STATE_FLUSH_DELAY * NSEC_PER_SEC)), OSDispatchQueues.utility, ^{
+        [weakSelf flush];
+    });
+}
+
+- (void)flush {
+    NSMutableDictionary *state = [NSMutableDictionary new];
+    BOOL removeLegacySets;
+    @synchronized (self) {
+        if (!_flushScheduled)
+            return;
+        _flushScheduled = NO;
+        state[OS_IAM_STATE_VERSION_KEY] = @(OS_IAM_STATE_VERSION);
+        for (NSUInteger i = 0; i < OS_IAM_STATE_SET_KEYS.count; i++)
+            state[OS_IAM_STATE_SET_KEYS[i]] = [_sets[i] allObjects];
+        removeLegacySets = _migratedFromLegacySets;
+        _migratedFromLegacySets = NO;
+    }
+
+    [OneSignalUserDefaults.initStandard saveDictionaryForKey:OS_IAM_STATE_KEY withValue:state];
+    if (removeLegacySets) {
+        for (NSString *legacyKey in OS_IAM_STATE_LEGACY_SET_KEYS)
+            [OneSignalUserDefaults.initStandard removeValueForKey:legacyKey];
+    }
+}
+
+@end
@@ -0,0 +1,50 @@
+/*
+ Modified MIT License
+
+ Copyright 2024 OneSignal
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ 1. The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ 2. All copies of substantial portions of the Software may only be used in connection
+ with services provided by OneSignal.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ */
+#import <Foundation/Foundation.h>
+#import "OSInAppMessageStateStore.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/*
+ Impressions, page impressions and clicks are recorded here and uploaded together once the batch window closes, or when the app backgrounds.
+ Events are persisted until they are sent, and are only uploaded once the device has a push subscription ID, so they wait for the user and subscription to be created.
+ The ids in the state store dedupe the events, an event that cannot be sent removes its id again so it can be tracked the next time.
+ */
+@interface OSInAppMessageTelemetryBuffer : NSObject
+
+- (instancetype)initWithStateStore:(OSInAppMessageStateStore *)stateStore;
+
+- (void)recordImpressionForMessageId:(NSString *)messageId variantId:(NSString * _Nullable)variantId;
+- (void)recordPageImpressionForMessageId:(NSString *)messageId variantId:(NSString * _Nullable)variantId pageId:(NSString *)pageId;
+- (void)recordClickForMessageId:(NSString *)messageId variantId:(NSString * _Nullable)variantId clickId:(NSString *)clickId firstClick:(BOOL)firstClick;
+
+// Sends all recorded events that are not already being sent
+- (void)upload;
+
+@end
+
+NS_ASSUME_NONNULL_END
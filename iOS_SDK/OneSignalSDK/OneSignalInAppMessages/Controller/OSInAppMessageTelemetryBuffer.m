@@ -0,0 +1,229 @@
+/*
+ Modified MIT License
+
+ Copyright 2024 OneSignal
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ 1. The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ 2. All copies of substantial portions of the Software may only be used in connection
+ with services provided by OneSignal.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ */
+#import <UIKit/UIKit.h>
+#import <OneSignalCore/OneSignalCore.h>
+#import <OneSignalUser/OneSignalUser-Swift.h>
+#import "OSInAppMessageTelemetryBuffer.h"
+#import "OSInAppMessagingDefines.h"
+#import "OSInAppMessagingRequests.h"
+
+#define OS_IAM_TELEMETRY_TYPE_KEY @"type"
+#define OS_IAM_TELEMETRY_MESSAGE_ID_KEY @"message_id"
+#define OS_IAM_TELEMETRY_VARIANT_ID_KEY @"variant_id"
+#define OS_IAM_TELEMETRY_PAGE_ID_KEY @"page_id"
+#define OS_IAM_TELEMETRY_CLICK_ID_KEY @"click_id"
+#define OS_IAM_TELEMETRY_FIRST_CLICK_KEY @"first_click"
+
+typedef NS_ENUM(NSUInteger, OSInAppMessageTelemetryType) {
+    OSInAppMessageTelemetryTypeImpression,
+    OSInAppMessageTelemetryTypePageImpression,
+    OSInAppMessageTelemetryTypeClick
+};
+
+@interface OSInAppMessageTelemetryBuffer ()
+
+@property (strong, nonatomic, nonnull) OSInAppMessageStateStore *stateStore;
+// Synchronized on self
+@property (strong, nonatomic, nonnull) NSMutableArray<NSDictionary *> *events;
+@property (strong, nonatomic, nonnull) NSMutableSet<NSDictionary *> *sendingEvents;
+@property (nonatomic) BOOL uploadScheduled;
+
+@end
+
+@implementation OSInAppMessageTelemetryBuffer
+
+- (instancetype)initWithStateStore:(OSInAppMessageStateStore *)stateStore {
+    if (self = [super init]) {
+        _stateStore = stateStore;
+        NSArray *events = [OneSignalUserDefaults.initStandard getSavedCodeableDataForKey:OS_IAM_TELEMETRY_BUFFER_KEY defaultValue:nil];
+        _events = [events isKindOfClass:[NSArray class]] ? [events mutableCopy] : [NSMutableArray new];
+        _sendingEvents = [NSMutableSet new];
+        [[NSNotificationCenter defaultCenter] addObserver:self selector:@selector(upload) name:UIApplicationDidEnterBackgroundNotification object:nil];
+        if (_events.count > 0)
+            [self setNeedsUpload];
+    }
+    return self;
+}
+
+- (void)dealloc {
+    [[NSNotificationCenter defaultCenter] removeObserver:self];
+}
+
+- (void)recordImpressionForMessageId:(NSString *)messageId variantId:(NSString *)variantId {
+    [self recordEvent:[self eventWithType:OSInAppMessageTelemetryTypeImpression messageId:messageId variantId:variantId]];
+}
+
+- (void)recordPageImpressionForMessageId:(NSString *)messageId variantId:(NSString *)variantId pageId:(NSString *)pageId {
+    NSMutableDictionary *event = [self eventWithType:OSInAppMessageTelemetryTypePageImpression messageId:messageId variantId:variantId];
+    event[OS_IAM_TELEMETRY_PAGE_ID_KEY] = pageId;
+    [self recordEvent:event];
+}
+
+- (void)recordClickForMessageId:(NSString *)messageId variantId:(NSString *)variantId clickId:(NSString *)clickId firstClick:(BOOL)firstClick {
+    NSMutableDictionary *event = [self eventWithType:OSInAppMessageTelemetryTypeClick messageId:messageId variantId:variantId];
+    event[OS_IAM_TELEMETRY_CLICK_ID_KEY] = clickId;
+    event[OS_IAM_TELEMETRY_FIRST_CLICK_KEY] = @(firstClick);
+    [self recordEvent:event];
+}
+
+// A message without a variant has no variant_id, so none is sent for it
+- (NSMutableDictionary *)eventWithType:(OSInAppMessageTelemetryType)type messageId:(NSString *)messageId variantId:(NSString *)variantId {
+    NSMutableDictionary *event = [NSMutableDictionary new];
+    event[OS_IAM_TELEMETRY_TYPE_KEY] = @(type);
+    event[OS_IAM_TELEMETRY_MESSAGE_ID_KEY] = messageId;
+    event[OS_IAM_TELEMETRY_VARIANT_ID_KEY] = variantId;
+    return event;
+}
+
+- (void)recordEvent:(NSDictionary *)event {
+    event = [event copy];
+    @synchronized (self) {
+        [_events addObject:event];
+        if (_events.count > OS_IAM_TELEMETRY_BUFFER_LIMIT)
+            [self dropEvent:_events.firstObject];
+        [self persistEvents];
+    }
+    // The event is persisted, so its dedup id can be persisted as well
+    [self.stateStore setNeedsFlush];
+    [self setNeedsUpload];
+}
+
+- (void)setNeedsUpload {
+    @synchronized (self) {
+        if (_uploadScheduled)
+            return;
+        _uploadScheduled = YES;
+    }
+    __weak OSInAppMessageTelemetryBuffer *weakSelf = self;
+    NSTimeInterval batchWindow = [OSPowerPolicy.sharedPolicy scaledDelay:OS_IAM_TELEMETRY_BATCH_WINDOW];
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(batchWindow * NSEC_PER_SEC)), OSDispatchQueues.background, ^{
+        [weakSelf upload];
+    });
+}
+
+- (void)upload {
+    [self uploadWithAppId:[OneSignalConfigManager getAppId] subscriptionId:OneSignalUserManagerImpl.sharedInstance.pushSubscriptionId];
+}
+
+- (void)uploadWithAppId:(NSString *)appId subscriptionId:(NSString *)subscriptionId {
+    NSArray<NSDictionary *> *events;
+    @synchronized (self) {
+        _uploadScheduled = NO;
+        if (!appId || !subscriptionId) {
+            // Uploaded once the subscription is created, the next recorded event or backgrounding tries again
+            return;
+        }
+        NSMutableArray *unsent = [NSMutableArray new];
+        for (NSDictionary *event in _events) {
+            if (![_sendingEvents containsObject:event])
+                [unsent addObject:event];
+        }
+        [_sendingEvents addObjectsFromArray:unsent];
+        events = unsent;
+    }
+    if (events.count == 0)
+        return;
+    ONE_S_LOG(ONE_S_LL_VERBOSE, @"OSInAppMessageTelemetryBuffer uploading %lu events", (unsigned long)events.count);
+    for (NSDictionary *event in events)
+        [self sendEvent:event appId:appId subscriptionId:subscriptionId];
+}
+
+- (void)sendEvent:(NSDictionary *)event appId:(NSString *)appId subscriptionId:(NSString *)subscriptionId {
+    NSString *messageId = event[OS_IAM_TELEMETRY_MESSAGE_ID_KEY];
+    NSString *variantId = event[OS_IAM_TELEMETRY_VARIANT_ID_KEY];
+    // Events buffered by earlier versions stored a missing variant as an empty string
+    if (variantId.length == 0)
+        variantId = nil;
+    OneSignalRequest *request;
+    switch ([event[OS_IAM_TELEMETRY_TYPE_KEY] unsignedIntegerValue]) {
+        case OSInAppMessageTelemetryTypeImpression:
+            request = [OSRequestInAppMessageViewed withAppId:appId withPlayerId:subscriptionId withMessageId:messageId forVariantId:variantId];
+            break;
+        case OSInAppMessageTelemetryTypePageImpression:
+            request = [OSRequestInAppMessagePageViewed withAppId:appId withPlayerId:subscriptionId withMessageId:messageId withPageId:event[OS_IAM_TELEMETRY_PAGE_ID_KEY] forVariantId:variantId];
+            break;
+        default: {
+            let action = [OSInAppMessageClickResult new];
+            action.clickId = event[OS_IAM_TELEMETRY_CLICK_ID_KEY];
+            action.firstClick = [event[OS_IAM_TELEMETRY_FIRST_CLICK_KEY] boolValue];
+            request = [OSRequestInAppMessageClicked withAppId:appId withPlayerId:subscriptionId withMessageId:messageId forVariantId:variantId withAction:action];
+            break;
+        }
+    }
+
+    [OneSignalCoreImpl.sharedClient executeRequest:request onSuccess:^(NSDictionary *result) {
+        ONE_S_LOG(ONE_S_LL_DEBUG, @"In App Message with id: %@, successful POST %@", messageId, request.path);
+        [self completeEvent:event];
+    } onFailure:^(OneSignalClientError *error) {
+        ONE_S_LOG(ONE_S_LL_ERROR, @"In App Message with id: %@, failed POST %@ with error: %@", messageId, request.path, error.message);
+        if ([OSNetworkingUtils getResponseStatusType:error.code] == OSResponseStatusRetryable) {
+            // Kept for the next upload
+            @synchronized (self) {
+                [self.sendingEvents removeObject:event];
+            }
+            return;
+        }
+        @synchronized (self) {
+            [self dropEvent:event];
+        }
+    }];
+}
+
+- (void)completeEvent:(NSDictionary *)event {
+    @synchronized (self) {
+        [_sendingEvents removeObject:event];
+        [_events removeObject:event];
+        [self persistEvents];
+    }
+}
+
+// Must be synchronized on self. An event that will not be sent no longer dedupes later ones.
+- (void)dropEvent:(NSDictionary *)event {
+    [_sendingEvents removeObject:event];
+    [_events removeObject:event];
+    [self persistEvents];
+    NSString *messageId = event[OS_IAM_TELEMETRY_MESSAGE_ID_KEY];
+    switch ([event[OS_IAM_TELEMETRY_TYPE_KEY] unsignedIntegerValue]) {
+        case OSInAppMessageTelemetryTypeImpression:
+            [_stateStore removeId:messageId fromSet:OSInAppMessageStateSetImpressioned];
+            break;
+        case OSInAppMessageTelemetryTypePageImpression:
+            [_stateStore removeId:[messageId stringByAppendingString:event[OS_IAM_TELEMETRY_PAGE_ID_KEY]] fromSet:OSInAppMessageStateSetViewedPages];
+            break;
+        default:
+            [_stateStore removeId:event[OS_IAM_TELEMETRY_CLICK_ID_KEY] fromSet:OSInAppMessageStateSetClicked];
+            break;
+    }
+    [_stateStore setNeedsFlush];
+}
+
+// Must be synchronized on self
+- (void)persistEvents {
+    [OneSignalUserDefaults.initStandard saveCodeableDataForKey:OS_IAM_TELEMETRY_BUFFER_KEY withValue:[_events copy]];
+}
+
+@end
@@ -34,7 +34,12 @@
 #import "OSInAppMessageController.h"
 #import "OSInAppMessagePrompt.h"
 #import "OSInAppMessagingRequests.h"
+#import "OSInAppMessageStateStore.h"
+#import "OSInAppMessageTelemetryBuffer.h"
+#import "OSInAppMessageRedisplayStore.h"
+#import "OSInAppMessageContentCache.h"
 #import "OneSignalWebViewManager.h"
+#import "OSInAppMessageWebViewPool.h"
 #import "OneSignalTracker.h"
 #import <OneSignalOutcomes/OneSignalOutcomes.h>
 #import "OSSessionManager.h"
@@ -42,7 +47,10 @@
 
 static NSInteger const DEFAULT_RETRY_AFTER_SECONDS = 1;     // Default 1 second retry delay
 static NSInteger const DEFAULT_RETRY_LIMIT = 0;             // If not returned by backend, don't retry
-static NSInteger const IAM_FETCH_DELAY_BUFFER = 0.5;        // Fallback value if ryw_delay is nil: delay by 500 ms to increase the probability of getting a 200 & not having to retry
+static NSTimeInterval const IAM_FETCH_DELAY_BUFFER = 0.5;   // Fallback value if ryw_delay is nil: delay by 500 ms to increase the probability of getting a 200 & not having to retry
+static double const IAM_RYW_DELAY_SCALE_MIN = 0.25;         // Wait at least this fraction of ryw_delay, however quickly writes have been readable
+static double const IAM_RYW_DELAY_SCALE_DECAY = 0.8;        // Applied to the fraction each time a fetch after a write succeeds on its first attempt
+static NSTimeInterval const IAM_FETCH_CONDITION_TIMEOUT = 30; // Fetch with the newest token available if the user update doesn't land in time
 
 @implementation OSInAppMessageWillDisplayEvent
 
@@ -104,32 +112,73 @@ static NSInteger const IAM_FETCH_DELAY_BUFFER = 0.5;        // Fallback value if
 
 @end
 
-@interface OSMessagingController ()
+/*
+ The evaluated messages and their trigger key index, built together and replaced in one assignment.
+ Readers take the whole object once, so an index is never read against a list it was not built from.
+ */
+@interface OSIndexedInAppMessages : NSObject
+@property (strong, nonatomic, readonly, nonnull) NSArray <OSInAppMessageInternal *> *messages;
+// Maps a trigger key to the indexes of the messages referencing it
+@property (strong, nonatomic, readonly, nonnull) NSDictionary<NSString *, NSIndexSet *> *messageIndexesByTriggerKey;
+- (instancetype _Nonnull)initWithMessages:(NSArray<OSInAppMessageInternal *> * _Nonnull)messages triggerController:(OSTriggerController * _Nullable)triggerController;
+- (NSArray<OSInAppMessageInternal *> * _Nonnull)messagesWithTriggerKeys:(NSArray<NSString *> * _Nonnull)triggerKeys;
+@end
+
+@implementation OSIndexedInAppMessages
+
+- (instancetype)initWithMessages:(NSArray<OSInAppMessageInternal *> *)messages triggerController:(OSTriggerController *)triggerController {
+    if (self = [super init]) {
+        _messages = [messages copy];
+        _messageIndexesByTriggerKey = [triggerController triggerKeyIndexForMessages:_messages] ?: @{};
+    }
+    return self;
+}
 
+- (NSArray<OSInAppMessageInternal *> *)messagesWithTriggerKeys:(NSArray<NSString *> *)triggerKeys {
+    NSMutableIndexSet *indexes = [NSMutableIndexSet new];
+    for (NSString *triggerKey in triggerKeys) {
+        NSIndexSet *keyIndexes = _messageIndexesByTriggerKey[triggerKey];
+        if (keyIndexes)
+            [indexes addIndexes:keyIndexes];
+    }
+    return [_messages objectsAtIndexes:indexes];
+}
+
+@end
+
+@interface OSMessagingController () <OSMemoryPressureResponder, OSUserStateObserver>
+
+// Created on the first display and kept, hidden with no root view controller, between displays
 @property (strong, nonatomic, nullable) UIWindow *window;
+// The messages that can still display, the only ones evaluated. Read from and replaced in indexedMessages.
 @property (strong, nonatomic, nonnull) NSArray <OSInAppMessageInternal *> *messages;
+// Read on the evaluation queue as well as the main thread, so it is atomic
+@property (strong, atomic, nonnull) OSIndexedInAppMessages *indexedMessages;
+// Messages from the last fetch that can never display again, see isDormantMessage:
+@property (strong, nonatomic, nonnull) NSArray <OSInAppMessageInternal *> *dormantMessages;
 @property (strong, nonatomic, nonnull) OSTriggerController *triggerController;
 @property (strong, nonatomic, nonnull) NSMutableArray <OSInAppMessageInternal *> *messageDisplayQueue;
 
-// Tracking already seen IAMs, used to prevent showing an IAM more than once after it has been dismissed
-@property (strong, nonatomic, nonnull) NSMutableSet <NSString *> *seenInAppMessages;
-
-// Tracking IAMs with redisplay, used to enable showing an IAM more than once after it has been dismissed
-@property (strong, nonatomic, nonnull) NSMutableDictionary <NSString *, OSInAppMessageInternal *> *redisplayedInAppMessages;
+// Serial queue messages are evaluated on, only the decision to present a message hops to the main thread
+@property (strong, nonatomic, nonnull) dispatch_queue_t evaluationQueue;
 
-// Tracking for click ids wihtin IAMs so that body, button, and image are only tracked on the dashboard once
-// TODO:We should refactor this to be like redisplay logic, save clickId + IAM or by IAM
-@property (strong, nonatomic, nonnull) NSMutableSet <NSString *> *clickedClickIds;
+/*
+ Tracking of seen IAMs, impressions, clicks ids and viewed pages, persisted together with coalesced writes
+   * Seen IAMs are used to prevent showing an IAM more than once after it has been dismissed
+   * Clicks ids so that body, button, and image are only tracked on the dashboard once
+   * Impressions and viewed pages so that an IAM is only tracked once and not several times if it is reshown
+ */
+@property (strong, nonatomic, nonnull) OSInAppMessageStateStore *stateStore;
 
-// Tracking for impessions so that an IAM is only tracked once and not several times if it is reshown
-@property (strong, nonatomic, nonnull) NSMutableSet <NSString *> *impressionedInAppMessages;
+// Impressions, page impressions and clicks are uploaded from here in batches
+@property (strong, nonatomic, nonnull) OSInAppMessageTelemetryBuffer *telemetryBuffer;
 
-// Tracking for impessions so that an IAM is only tracked once and not several times if it is reshown
-@property (strong, nonatomic, nonnull) NSMutableSet <NSString *> *viewedPageIDs;
+// Tracking IAMs with redisplay, used to enable showing an IAM more than once after it has been dismissed
+@property (strong, nonatomic, nonnull) OSInAppMessageRedisplayStore *redisplayStore;
 
-@property (nonatomic) NSMutableArray<NSObject<OSInAppMessageClickListener> *> *clickListeners;
+@property (strong, nonatomic, nonnull) OSListenerRegistry<NSObject<OSInAppMessageClickListener> *> *clickListeners;
 
-@property (nonatomic) NSMutableArray<NSObject<OSInAppMessageLifecycleListener> *> *lifecycleListeners;
+@property (strong, nonatomic, nonnull) OSListenerRegistry<NSObject<OSInAppMessageLifecycleListener> *> *lifecycleListeners;
 
 @property (strong, nullable) OSInAppMessageViewController *viewController;
 
@@ -143,8 +192,37 @@ static NSInteger const IAM_FETCH_DELAY_BUFFER = 0.5;        // Fallback value if
 
 @property (nonatomic) BOOL isAppInactive;
 
+// Presented from the decision saved at the last backgrounding, until the next fetch confirms or withdraws it. Main thread only.
+@property (nonatomic, nullable) OSInAppMessageInternal *appOpenMessage;
+// The user the app open message was presented for
+@property (nonatomic, nullable) NSString *appOpenMessageOnesignalId;
+// Set once the launch's first fetch has taken the saved app open decision. Main thread only.
+@property (nonatomic) BOOL didTakeAppOpenMessage;
+
 @property (nonatomic) BOOL calledLoadTags;
 
+// Set when a refresh push arrives in the background, the messages are fetched once the app enters the foreground. Main thread only.
+@property (nonatomic) BOOL needsRefreshOnForeground;
+
+/*
+ Incremented by every fetch, a delayed fetch or retry only runs if no newer fetch started in the meantime.
+ Synchronized on self, as are the accesses to `rywDelayScale`.
+ */
+@property (nonatomic) NSUInteger fetchGeneration;
+
+/*
+ The fraction of the server's ryw_delay to wait before fetching after a user write, adapted to the replication lag observed.
+ It shrinks while fetches succeed on their first attempt and resets to the full delay when the server answers 425 Too Early.
+ */
+@property (nonatomic) double rywDelayScale;
+
+/*
+ The last parsed list keyed by message ID, each value is @[json, parsed message].
+ Messages whose JSON is unchanged in the next list reuse their parsed instance instead of being parsed again.
+ Replaced as a whole, so parsing on any thread reads a consistent snapshot.
+ */
+@property (strong, atomic, nonnull) NSDictionary<NSString *, NSArray *> *parsedMessagesById;
+
 @end
 
 @implementation OSMessagingController
@@ -173,6 +251,7 @@ static dispatch_once_t once;
 + (void)start {
     OSMessagingController *shared = OSMessagingController.sharedInstance;
     [OneSignalUserManagerImpl.sharedInstance.pushSubscriptionImpl addObserver:shared];
+    [OneSignalUserManagerImpl.sharedInstance addObserver:shared];
 }
 
 static BOOL _isInAppMessagingPaused = false;
@@ -207,27 +286,41 @@ static BOOL _isInAppMessagingPaused = false;
         self.dateGenerator = ^ NSTimeInterval {
             return [[NSDate date] timeIntervalSince1970];
         };
+        self.rywDelayScale = 1;
+        self.parsedMessagesById = @{};
         self.messages = [NSArray<OSInAppMessageInternal *> new];
+        self.dormantMessages = [NSArray<OSInAppMessageInternal *> new];
         [self initializeTriggerController];
         self.messageDisplayQueue = [NSMutableArray new];
-        self.clickListeners = [NSMutableArray new];
-        self.lifecycleListeners = [NSMutableArray new];
+        self.evaluationQueue = dispatch_queue_create_with_target("com.onesignal.iam.evaluation", DISPATCH_QUEUE_SERIAL, OSDispatchQueues.utility);
+        self.clickListeners = [OSListenerRegistry new];
+        self.lifecycleListeners = [OSListenerRegistry new];
         
-        let standardUserDefaults = OneSignalUserDefaults.initStandard;
+        // Messages cached before 3.7.0 were archived under the OSInAppMessage class name.
+        // Migration only runs once per storage schema version, so the old name is registered on every launch.
+        [NSKeyedUnarchiver setClass:[OSInAppMessageInternal class] forClassName:@"OSInAppMessage"];
         
         // Get all cached IAM data from NSUserDefaults for shown, impressions, and clicks
-        self.seenInAppMessages = [[NSMutableSet alloc] initWithSet:[standardUserDefaults getSavedSetForKey:OS_IAM_SEEN_SET_KEY defaultValue:nil]];
-        self.redisplayedInAppMessages = [[NSMutableDictionary alloc] initWithDictionary:[standardUserDefaults getSavedCodeableDataForKey:OS_IAM_REDISPLAY_DICTIONARY defaultValue:[NSMutableDictionary new]]];
-        [OneSignalLog onesignalLog:ONE_S_LL_VERBOSE message:[NSString stringWithFormat:@"init redisplayedInAppMessages with: %@", [_redisplayedInAppMessages description]]];
-        self.clickedClickIds = [[NSMutableSet alloc] initWithSet:[standardUserDefaults getSavedSetForKey:OS_IAM_CLICKED_SET_KEY defaultValue:nil]];
-        self.impressionedInAppMessages = [[NSMutableSet alloc] initWithSet:[standardUserDefaults getSavedSetForKey:OS_IAM_IMPRESSIONED_SET_KEY defaultValue:nil]];
-        self.viewedPageIDs = [[NSMutableSet alloc] initWithSet:[standardUserDefaults getSavedSetForKey:OS_IAM_PAGE_IMPRESSIONED_SET_KEY defaultValue:nil]];
+        self.stateStore = [OSInAppMessageStateStore new];
+        self.telemetryBuffer = [[OSInAppMessageTelemetryBuffer alloc] initWithStateStore:self.stateStore];
+        self.redisplayStore = [OSInAppMessageRedisplayStore new];
         self.currentPromptAction = nil;
         self.isAppInactive = NO;
         // BOOL that controls if in-app messaging is paused or not (false by default)
         _isInAppMessagingPaused = false;
         
         [[NSNotificationCenter defaultCenter] addObserver:self selector:@selector(handleIAMPreview:) name:ONESIGNAL_POST_PREVIEW_IAM object:nil];
+        [[NSNotificationCenter defaultCenter] addObserver:self selector:@selector(handleIAMRefresh:) name:ONESIGNAL_POST_REFRESH_IAM object:nil];
+        [[NSNotificationCenter defaultCenter] addObserver:self selector:@selector(applicationWillEnterForeground:) name:UIApplicationWillEnterForegroundNotification object:nil];
+        [[NSNotificationCenter defaultCenter] addObserver:self selector:@selector(applicationDidEnterBackground:) name:UIApplicationDidEnterBackgroundNotification object:nil];
+        [[NSNotificationCenter defaultCenter] addObserver:self selector:@selector(prefetchConditionsDidChange:) name:OS_POWER_POLICY_CHANGED_NOTIFICATION object:nil];
+        [[NSNotificationCenter defaultCenter] addObserver:self selector:@selector(prefetchConditionsDidChange:) name:OS_REACHABILITY_CHANGED_NOTIFICATION object:nil];
+        [OSMemoryPressureCoordinator addResponder:self];
+        __weak OSMessagingController *weakSelf = self;
+        [OSMaintenanceScheduler.sharedScheduler registerJob:@"prune_redisplay_records" block:^(dispatch_block_t completion) {
+            [weakSelf deleteOldRedisplayedInAppMessages];
+            completion();
+        }];
     }
     
     return self;
@@ -236,13 +329,22 @@ static BOOL _isInAppMessagingPaused = false;
 - (void)initializeTriggerController {
     self.triggerController = [OSTriggerController new];
     self.triggerController.delegate = self;
+    // Index the messages with the new trigger controller
+    self.messages = self.messages;
     NSString *timeSinceLastMessage = [OneSignalUserDefaults.initShared getSavedStringForKey:OS_IAM_TIME_SINCE_LAST_MESSAGE_KEY defaultValue:nil];
     [self.triggerController timeSinceLastMessage:[[NSDateFormatter iso8601DateFormatter]
                                                   dateFromString:timeSinceLastMessage]];
 }
 
 - (void)getInAppMessagesFromServer:(NSString *)subscriptionId {
-    dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+    // Queued on the main thread ahead of the fetch result, which re-validates it
+    [OneSignalCoreHelper dispatch_async_on_main_queue:^{
+        // Without both IDs there is no fetch, the next one is still the launch's first
+        NSString *onesignalId = OneSignalUserManagerImpl.sharedInstance.onesignalId;
+        if (subscriptionId && onesignalId)
+            [self presentAppOpenMessageForOnesignalId:onesignalId];
+    }];
+    dispatch_async(OSDispatchQueues.utility, ^{
         [OneSignalLog onesignalLog:ONE_S_LL_VERBOSE message:@"getInAppMessagesFromServer"];
 
         if (!subscriptionId) {
@@ -258,24 +360,27 @@ static BOOL _isInAppMessagingPaused = false;
         }
 
         OSIamFetchReadyCondition *condition = [OSIamFetchReadyCondition sharedInstanceWithId:onesignalId];
-        OSReadYourWriteData *rywData = [consistencyManager getRywTokenFromAwaitableCondition:condition forId:onesignalId];
-        
-        // We need to delay the first request by however long the backend is telling us (`ryw_delay`)
-        // This will help avoid unnecessary retries & can be easily adjusted from the backend
-        NSTimeInterval rywDelayInSeconds;
-        if (rywData.rywDelay) {
-            rywDelayInSeconds = [rywData.rywDelay doubleValue] / 1000.0;
-        } else {
-            rywDelayInSeconds = IAM_FETCH_DELAY_BUFFER;
+        NSUInteger generation;
+        @synchronized (self) {
+            generation = ++self.fetchGeneration;
         }
-        dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(rywDelayInSeconds * NSEC_PER_SEC)), dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
-            
-            // Initial request
-            [self attemptFetchWithRetries:subscriptionId
-                                 rywData:rywData
-                                 attempts:@0 // Starting with 0 attempts
-                               retryLimit:nil]; // Retry limit to be set dynamically on first failure
-        });
+        [consistencyManager getRywTokenFromAwaitableCondition:condition forId:onesignalId timeout:IAM_FETCH_CONDITION_TIMEOUT completion:^(OSReadYourWriteData *rywData) {
+            if (![self isCurrentFetch:generation])
+                return;
+            NSTimeInterval rywDelayInSeconds = [self fetchDelayForRywData:rywData];
+            dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(rywDelayInSeconds * NSEC_PER_SEC)), OSDispatchQueues.utility, ^{
+                if (![self isCurrentFetch:generation]) {
+                    [OneSignalLog onesignalLog:ONE_S_LL_VERBOSE message:@"getInAppMessagesFromServer superseded by a newer fetch"];
+                    return;
+                }
+                // Initial request
+                [self attemptFetchWithRetries:subscriptionId
+                                     rywData:rywData
+                                     attempts:@0 // Starting with 0 attempts
+                                   retryLimit:nil // Retry limit to be set dynamically on first failure
+                                   generation:generation];
+            });
+        }];
     });
 }
 
@@ -283,7 +388,8 @@ static BOOL _isInAppMessagingPaused = false;
 - (void)attemptFetchWithRetries:(NSString *)subscriptionId
                        rywData:(OSReadYourWriteData *)rywData
                        attempts:(NSNumber *)attempts
-                     retryLimit:(NSNumber *)retryLimit {
+                     retryLimit:(NSNumber *)retryLimit
+                     generation:(NSUInteger)generation {
     NSNumber *sessionDuration = @([OSSessionManager.sharedSessionManager getTimeFocusedElapsed]);
     NSString *rywToken = rywData.rywToken;
     NSNumber *rywDelay = rywData.rywDelay;
@@ -292,35 +398,31 @@ static BOOL _isInAppMessagingPaused = false;
     OSRequestGetInAppMessages *request = [OSRequestGetInAppMessages withSubscriptionId:subscriptionId
                                                                     withSessionDuration:sessionDuration
                                                                     withRetryCount:attempts
-                                                                    withRywToken:rywToken];
+                                                                    withRywToken:rywToken
+                                                                    withETag:[self cachedInAppMessagesETagForSubscriptionId:subscriptionId]];
 
     __block NSNumber *blockRetryLimit = retryLimit;
 
     [OneSignalCoreImpl.sharedClient executeRequest:request
                                           onSuccess:^(NSDictionary *result) {
-        dispatch_async(dispatch_get_main_queue(), ^{
-            [OneSignalLog onesignalLog:ONE_S_LL_VERBOSE message:@"getInAppMessagesFromServer success"];
-            if (result[@"in_app_messages"]) {
-                NSMutableArray *messages = [NSMutableArray new];
-                
-                for (NSDictionary *messageJson in result[@"in_app_messages"]) {
-                    OSInAppMessageInternal *message = [OSInAppMessageInternal instanceWithJson:messageJson];
-                    if (message) {
-                        [messages addObject:message];
-                    }
-                }
-                
-                [self updateInAppMessagesFromServer:messages];
-                return;
-            }
-        });
+        if (rywToken && [attempts integerValue] == 0)
+            [self adaptRywDelayScaleAfterTooEarly:NO];
+        [OneSignalLog onesignalLog:ONE_S_LL_VERBOSE message:@"getInAppMessagesFromServer success"];
+        [self handleInAppMessagesResult:result request:request subscriptionId:subscriptionId];
     }
     onFailure:^(OneSignalClientError *error) {
         NSDictionary* responseHeaders = error.responseHeaders;
         
-        [OneSignalLog onesignalLog:ONE_S_LL_VERBOSE message:[NSString stringWithFormat:@"getInAppMessagesFromServer failure: %@", error.underlyingError.localizedDescription]];
+        if (error.code == 304) {
+            [self useCachedInAppMessagesForSubscriptionId:subscriptionId];
+            return;
+        }
+        
+        ONE_S_LOG(ONE_S_LL_VERBOSE, @"getInAppMessagesFromServer failure: %@", error.underlyingError.localizedDescription);
         
         if (error.code == 425 || error.code == 429) { // 425 Too Early or 429 Too Many Requests
+            if (error.code == 425)
+                [self adaptRywDelayScaleAfterTooEarly:YES];
             NSInteger retryAfter = [responseHeaders[@"Retry-After"] integerValue] ?: DEFAULT_RETRY_AFTER_SECONDS;
             
             // Dynamically set the retry limit from the header, if not already set
@@ -334,7 +436,8 @@ static BOOL _isInAppMessagingPaused = false;
                          subscriptionId:subscriptionId
                                 rywData:rywData
                                attempts:@(nextAttempt)
-                             retryLimit:blockRetryLimit];
+                             retryLimit:blockRetryLimit
+                             generation:generation];
             } else {
                 // Final attempt without rywToken
                 [self fetchInAppMessagesWithoutToken:subscriptionId];
@@ -349,115 +452,362 @@ static BOOL _isInAppMessagingPaused = false;
          subscriptionId:(NSString *)subscriptionId
                rywData:(OSReadYourWriteData *)rywData
                attempts:(NSNumber *)attempts
-             retryLimit:(NSNumber *)retryLimit {
+             retryLimit:(NSNumber *)retryLimit
+             generation:(NSUInteger)generation {
 
-    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(retryAfter * NSEC_PER_SEC)), dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
-        
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(retryAfter * NSEC_PER_SEC)), OSDispatchQueues.utility, ^{
+        if (![self isCurrentFetch:generation]) {
+            [OneSignalLog onesignalLog:ONE_S_LL_VERBOSE message:@"getInAppMessagesFromServer retry superseded by a newer fetch"];
+            return;
+        }
         [self attemptFetchWithRetries:subscriptionId
                              rywData:rywData
                              attempts:attempts
-                           retryLimit:retryLimit];
+                           retryLimit:retryLimit
+                           generation:generation];
     });
 }
 
+- (BOOL)isCurrentFetch:(NSUInteger)generation {
+    @synchronized (self) {
+        return generation == self.fetchGeneration;
+    }
+}
+
+/*
+ Without a ryw_token there is no recent user write the fetch must observe, so it is sent right away.
+ Otherwise it waits for the server's ryw_delay, scaled by the replication lag observed so far.
+ */
+- (NSTimeInterval)fetchDelayForRywData:(OSReadYourWriteData *)rywData {
+    if (!rywData.rywToken)
+        return 0;
+    if (!rywData.rywDelay)
+        return IAM_FETCH_DELAY_BUFFER;
+    @synchronized (self) {
+        return [rywData.rywDelay doubleValue] / 1000.0 * self.rywDelayScale;
+    }
+}
+
+- (void)adaptRywDelayScaleAfterTooEarly:(BOOL)tooEarly {
+    @synchronized (self) {
+        self.rywDelayScale = tooEarly ? 1 : MAX(IAM_RYW_DELAY_SCALE_MIN, self.rywDelayScale * IAM_RYW_DELAY_SCALE_DECAY);
+    }
+}
+
 - (void)fetchInAppMessagesWithoutToken:(NSString *)subscriptionId {
     NSNumber *sessionDuration = @([OSSessionManager.sharedSessionManager getTimeFocusedElapsed]);
     
     OSRequestGetInAppMessages *request = [OSRequestGetInAppMessages withSubscriptionId:subscriptionId
                                                                       withSessionDuration:sessionDuration
                                                                       withRetryCount:nil
-                                                                      withRywToken:nil]; // No retries for the final attempt
+                                                                      withRywToken:nil // No retries for the final attempt
+                                                                      withETag:[self cachedInAppMessagesETagForSubscriptionId:subscriptionId]];
 
     [OneSignalCoreImpl.sharedClient executeRequest:request
                                           onSuccess:^(NSDictionary *result) {
-        dispatch_async(dispatch_get_main_queue(), ^{
-            [OneSignalLog onesignalLog:ONE_S_LL_VERBOSE message:@"Final attempt without token success"];
-            if (result[@"in_app_messages"]) {
-                NSMutableArray *messages = [NSMutableArray new];
-
-                for (NSDictionary *messageJson in result[@"in_app_messages"]) {
-                    OSInAppMessageInternal *message = [OSInAppMessageInternal instanceWithJson:messageJson];
-                    if (message) {
-                        [messages addObject:message];
-                    }
-                }
+        [OneSignalLog onesignalLog:ONE_S_LL_VERBOSE message:@"Final attempt without token success"];
+        [self handleInAppMessagesResult:result request:request subscriptionId:subscriptionId];
+    } onFailure:^(OneSignalClientError *error) {
+        if (error.code == 304) {
+            [self useCachedInAppMessagesForSubscriptionId:subscriptionId];
+            return;
+        }
+        ONE_S_LOG(ONE_S_LL_VERBOSE, @"getInAppMessagesFromServer failure: %@", error.underlyingError.localizedDescription);
+    }];
+}
 
-                [self updateInAppMessagesFromServer:messages];
-                return;
+// Caching and parsing happen on the client's callback queue, only updating the displayed state needs main
+- (void)handleInAppMessagesResult:(NSDictionary *)result request:(OneSignalRequest *)request subscriptionId:(NSString *)subscriptionId {
+    NSArray *messagesJson = result[@"in_app_messages"];
+    if (!messagesJson) {
+        return;
+    }
+    NSArray<OSInAppMessageInternal *> *messages = [self inAppMessagesFromJson:messagesJson firstPageHandler:^(NSArray<OSInAppMessageInternal *> *firstPage) {
+        [self evaluateFirstPageOfMessages:firstPage];
+    }];
+    [self cacheInAppMessagesJson:messagesJson etag:[self etagFromHeaders:request.responseHeaders] subscriptionId:subscriptionId];
+    [OneSignalCoreHelper dispatch_async_on_main_queue:^{
+        [self updateInAppMessagesFromServer:messages];
+    }];
+}
+
+- (NSArray<OSInAppMessageInternal *> *)inAppMessagesFromJson:(NSArray *)messagesJson {
+    return [self inAppMessagesFromJson:messagesJson firstPageHandler:nil];
+}
+
+/*
+ Messages are materialized a page at a time, each page in its own autorelease pool so the temporaries of parsing
+ don't pile up over a large list. When the list has more than one page, the handler gets the first page as soon as
+ it is parsed, on the calling thread.
+ */
+- (NSArray<OSInAppMessageInternal *> *)inAppMessagesFromJson:(NSArray *)messagesJson firstPageHandler:(void (^)(NSArray<OSInAppMessageInternal *> *firstPage))firstPageHandler {
+    let previouslyParsed = self.parsedMessagesById;
+    NSMutableDictionary<NSString *, NSArray *> *parsedMessagesById = [NSMutableDictionary new];
+    NSMutableArray *messages = [NSMutableArray new];
+    NSUInteger reusedCount = 0;
+    let count = messagesJson.count;
+    for (NSUInteger pageStart = 0; pageStart < count; pageStart += OS_IAM_PARSE_PAGE_SIZE) {
+        let pageEnd = MIN(pageStart + OS_IAM_PARSE_PAGE_SIZE, count);
+        @autoreleasepool {
+            for (NSUInteger i = pageStart; i < pageEnd; i++) {
+                NSDictionary *messageJson = messagesJson[i];
+                NSArray *parsed = [messageJson isKindOfClass:[NSDictionary class]] ? previouslyParsed[messageJson[@"id"]] : nil;
+                OSInAppMessageInternal *message;
+                if (parsed && [parsed[0] isEqual:messageJson]) {
+                    message = parsed[1];
+                    reusedCount++;
+                } else {
+                    message = [OSInAppMessageInternal instanceWithJson:messageJson];
+                    // Resolved off the main thread while parsing, display reads the stored variant
+                    [message variantId];
+                }
+                if (message) {
+                    [messages addObject:message];
+                    parsedMessagesById[message.messageId] = @[messageJson, message];
+                }
             }
-        });
-    } onFailure:^(OneSignalClientError *error) {
-        [OneSignalLog onesignalLog:ONE_S_LL_VERBOSE message:[NSString stringWithFormat:@"getInAppMessagesFromServer failure: %@", error.underlyingError.localizedDescription]];
+        }
+        if (firstPageHandler && pageStart == 0 && pageEnd < count)
+            firstPageHandler([messages copy]);
+    }
+    self.parsedMessagesById = parsedMessagesById;
+    ONE_S_LOG(ONE_S_LL_VERBOSE, @"inAppMessagesFromJson parsed %lu messages, reused %lu unchanged", (unsigned long)(messages.count - reusedCount), (unsigned long)reusedCount);
+    return messages;
+}
+
+- (NSString *)etagFromHeaders:(NSDictionary *)headers {
+    // Header field names are case-insensitive
+    for (NSString *name in headers) {
+        if ([name caseInsensitiveCompare:@"ETag"] == NSOrderedSame) {
+            return headers[name];
+        }
+    }
+    return nil;
+}
+
+/*
+ The last IAM list is persisted with its ETag so a 304 Not Modified can reuse it.
+ It is only valid for the subscription it was fetched for.
+ The ETag and subscription stay in user defaults, the list is written to its own file.
+ */
+- (void)cacheInAppMessagesJson:(NSArray *)messagesJson etag:(NSString *)etag subscriptionId:(NSString *)subscriptionId {
+    let standardUserDefaults = OneSignalUserDefaults.initStandard;
+    NSData *data = etag ? [NSJSONSerialization dataWithJSONObject:messagesJson options:0 error:nil] : nil;
+    if (!data || ![data writeToURL:[self inAppMessagesCacheFileURL] options:NSDataWritingAtomic error:nil]) {
+        [standardUserDefaults removeValueForKey:OS_IAM_MESSAGES_CACHE_KEY];
+        return;
+    }
+    [standardUserDefaults saveDictionaryForKey:OS_IAM_MESSAGES_CACHE_KEY withValue:@{
+        @"subscription_id": subscriptionId,
+        @"etag": etag
     }];
 }
 
+- (NSURL *)inAppMessagesCacheFileURL {
+    NSURL *caches = [[NSFileManager defaultManager] URLsForDirectory:NSCachesDirectory inDomains:NSUserDomainMask].firstObject;
+    return [caches URLByAppendingPathComponent:OS_IAM_MESSAGES_CACHE_FILE isDirectory:NO];
+}
+
+- (NSDictionary *)cachedInAppMessagesForSubscriptionId:(NSString *)subscriptionId {
+    NSDictionary *cache = [OneSignalUserDefaults.initStandard getSavedDictionaryForKey:OS_IAM_MESSAGES_CACHE_KEY defaultValue:nil];
+    if (![cache[@"subscription_id"] isEqualToString:subscriptionId]) {
+        return nil;
+    }
+    // Caches can be purged by the system, an ETag without its list would leave nothing to fall back on for a 304
+    if (![[NSFileManager defaultManager] fileExistsAtPath:[self inAppMessagesCacheFileURL].path]) {
+        return nil;
+    }
+    return cache;
+}
+
+- (NSString *)cachedInAppMessagesETagForSubscriptionId:(NSString *)subscriptionId {
+    return [self cachedInAppMessagesForSubscriptionId:subscriptionId][@"etag"];
+}
+
+- (void)useCachedInAppMessagesForSubscriptionId:(NSString *)subscriptionId {
+    // Mapped so the list is paged in from disk as it is parsed rather than copied into memory
+    NSData *data = [self cachedInAppMessagesForSubscriptionId:subscriptionId] ? [NSData dataWithContentsOfURL:[self inAppMessagesCacheFileURL] options:NSDataReadingMappedIfSafe error:nil] : nil;
+    NSArray *messagesJson = data ? [NSJSONSerialization JSONObjectWithData:data options:0 error:nil] : nil;
+    if (![messagesJson isKindOfClass:[NSArray class]]) {
+        // Without the cached list the ETag is useless, drop it so the next fetch downloads the full list
+        [OneSignalUserDefaults.initStandard removeValueForKey:OS_IAM_MESSAGES_CACHE_KEY];
+        return;
+    }
+    [OneSignalLog onesignalLog:ONE_S_LL_VERBOSE message:@"getInAppMessagesFromServer not modified, using cached in app messages"];
+    NSArray<OSInAppMessageInternal *> *messages = [self inAppMessagesFromJson:messagesJson];
+    [OneSignalCoreHelper dispatch_async_on_main_queue:^{
+        [self updateInAppMessagesFromServer:messages];
+    }];
+}
+
+- (NSArray<OSInAppMessageInternal *> *)messages {
+    return self.indexedMessages.messages;
+}
+
+- (void)setMessages:(NSArray<OSInAppMessageInternal *> *)messages {
+    self.indexedMessages = [[OSIndexedInAppMessages alloc] initWithMessages:messages triggerController:self.triggerController];
+}
+
+/*
+ Drops the dormant messages and the parsed list.
+ Only the in-memory list is trimmed, the next fetch from the server brings back any that are still live.
+ */
+- (void)purgeForMemoryPressure {
+    // The next display creates the window again
+    if (self.window.hidden)
+        self.window = nil;
+    // The next list is parsed in full instead
+    self.parsedMessagesById = @{};
+    [self pruneDormantMessages];
+    if (self.dormantMessages.count == 0)
+        return;
+    ONE_S_LOG(ONE_S_LL_DEBUG, @"OSMessagingController dropped %lu non-displayable messages for memory pressure", (unsigned long)self.dormantMessages.count);
+    self.dormantMessages = @[];
+}
+
+/*
+ A message is dormant when it can never display again: it is finished, it was seen without redisplay,
+ or it was seen as many times as its redisplay limit allows.
+ Nothing on the device can revive one, triggers do not reset the seen set and end times do not move, only the server
+ can by changing the message. So dormant messages are left out of evaluation, and each fetch prunes its list afresh.
+ */
+- (BOOL)isDormantMessage:(OSInAppMessageInternal *)message {
+    if (message.isPreview || message == self.currentInAppMessage)
+        return NO;
+    if ([message isFinished])
+        return YES;
+    if (![self.stateStore containsId:message.messageId inSet:OSInAppMessageStateSetSeen])
+        return NO;
+    if (!message.displayStats.isRedisplayEnabled)
+        return YES;
+    return [self.redisplayStore containsMessageId:message.messageId] &&
+           [self.redisplayStore displayQuantityForMessageId:message.messageId] >= message.displayStats.displayLimit;
+}
+
+// Moves the messages that became dormant, such as one just dismissed, out of the evaluated messages
+- (void)pruneDormantMessages {
+    NSArray<OSInAppMessageInternal *> *queued;
+    @synchronized (self.messageDisplayQueue) {
+        queued = [self.messageDisplayQueue copy];
+    }
+    let active = [NSMutableArray<OSInAppMessageInternal *> new];
+    let dormant = [NSMutableArray<OSInAppMessageInternal *> new];
+    for (OSInAppMessageInternal *message in self.messages) {
+        if ([self isDormantMessage:message] && ![queued containsObject:message])
+            [dormant addObject:message];
+        else
+            [active addObject:message];
+    }
+    if (dormant.count == 0)
+        return;
+    ONE_S_LOG(ONE_S_LL_VERBOSE, @"OSMessagingController moved %lu messages that can no longer display to the dormant set", (unsigned long)dormant.count);
+    self.messages = active;
+    self.dormantMessages = [self.dormantMessages arrayByAddingObjectsFromArray:dormant];
+}
+
+- (NSArray<OSInAppMessageInternal *> *)messagesWithTriggerKeys:(NSArray<NSString *> *)triggerKeys {
+    return [self.indexedMessages messagesWithTriggerKeys:triggerKeys];
+}
+
 - (void)updateInAppMessagesFromServer:(NSArray<OSInAppMessageInternal *> *)newMessages {
     [OneSignalLog onesignalLog:ONE_S_LL_VERBOSE message:@"updateInAppMessagesFromServer"];
+    NSArray<OSInAppMessageInternal *> *queued;
+    @synchronized (self.messageDisplayQueue) {
+        queued = [self.messageDisplayQueue copy];
+    }
+    // Reused instances start over like freshly parsed ones, apart from the message on screen and the queued ones,
+    // such as those presented from the first page while the list was still being parsed
+    for (OSInAppMessageInternal *message in newMessages) {
+        if (message == self.currentInAppMessage || [queued indexOfObjectIdenticalTo:message] != NSNotFound)
+            continue;
+        message.isDisplayedInSession = NO;
+        message.isTriggerChanged = NO;
+        message.actionTaken = NO;
+    }
     self.messages = newMessages;
+    [self revalidateAppOpenMessageWithMessages:newMessages];
+    self.dormantMessages = @[];
+    [self pruneDormantMessages];
     self.calledLoadTags = NO;
-    [self resetRedisplayMessagesBySession];
+    if (newMessages.count > 0) {
+        // Warm up web views once the main run loop is idle so the first display doesn't wait on WebKit
+        [[NSRunLoop mainRunLoop] performInModes:@[NSDefaultRunLoopMode] block:^{
+            [OSInAppMessageWebViewPool.sharedPool prewarm];
+        }];
+    }
     [self evaluateMessages];
-    [self deleteOldRedisplayedInAppMessages];
+    [self evictContentCacheForMessages:newMessages];
+    [self prefetchContentForMessages:self.messages];
 }
 
-- (void)resetRedisplayMessagesBySession {
-    [OneSignalLog onesignalLog:ONE_S_LL_VERBOSE message:[NSString stringWithFormat:@"resetRedisplayMessagesBySession with redisplayedInAppMessages: %@", [_redisplayedInAppMessages description]]];
+/*
+ Download content ahead of display for messages that can still be shown
+ Dormant messages and previews are skipped, and nothing is prefetched while OSPowerPolicy is constrained
+ or the network path is expensive or constrained
+ */
+- (BOOL)allowsPrefetch {
+    return OSPowerPolicy.sharedPolicy.allowsPrefetch && [OSNetworkingUtils allowsPrefetch];
+}
 
-    for (NSString *messageId in _redisplayedInAppMessages) {
-        [_redisplayedInAppMessages objectForKey:messageId].isDisplayedInSession = false;
+- (void)prefetchContentForMessages:(NSArray<OSInAppMessageInternal *> *)messages {
+    if (![self allowsPrefetch])
+        return;
+    NSInteger prefetchLimit = [OSTuningConfig.sharedConfig integerForKey:OS_TUNING_IAM_PREFETCH_LIMIT defaultValue:OS_IAM_CONTENT_PREFETCH_LIMIT minimum:0 maximum:OS_IAM_CONTENT_PREFETCH_MAX_LIMIT];
+    NSInteger prefetchCount = 0;
+    for (OSInAppMessageInternal *message in messages) {
+        if (prefetchCount >= prefetchLimit)
+            break;
+        if (message.isPreview || [self isDormantMessage:message])
+            continue;
+        [message prefetchMessageHTMLContent];
+        prefetchCount++;
     }
 }
 
+- (void)evictContentCacheForMessages:(NSArray<OSInAppMessageInternal *> *)messages {
+    NSMutableSet<NSString *> *messageIds = [NSMutableSet new];
+    for (OSInAppMessageInternal *message in messages)
+        [messageIds addObject:message.messageId];
+    [OSInAppMessageContentCache.sharedCache removeContentForMessageIdsNotIn:messageIds];
+}
+
 - (void)deleteInactiveMessage:(OSInAppMessageInternal *)message {
     let deleteMessage = [NSString stringWithFormat:@"Deleting inactive in-app message from cache: %@", message.messageId];
     [OneSignalLog onesignalLog:ONE_S_LL_ERROR message:deleteMessage];
     NSMutableArray *newMessagesArray = [NSMutableArray arrayWithArray:self.messages];
     [newMessagesArray removeObject: message];
     self.messages = newMessagesArray;
+    [self evictContentCacheForMessages:newMessagesArray];
 }
 
 /*
  Part of redisplay logic
  Remove IAMs that the last display time was six month ago
+ Runs as a maintenance job, off the main thread
  */
 - (void)deleteOldRedisplayedInAppMessages {
-    NSMutableSet <NSString *> *messagesIdToRemove = [NSMutableSet new];
-
     let maxCacheTime = self.dateGenerator() - OS_IAM_MAX_CACHE_TIME;
-    for (NSString *messageId in _redisplayedInAppMessages) {
-        if ([_redisplayedInAppMessages objectForKey:messageId].displayStats.lastDisplayTime < maxCacheTime) {
-            [messagesIdToRemove addObject:messageId];
-        }
-    }
-
-    if ([messagesIdToRemove count] > 0) {
-        NSMutableDictionary <NSString *, OSInAppMessageInternal *> * newRedisplayDictionary = [_redisplayedInAppMessages mutableCopy];
-        for (NSString * messageId in messagesIdToRemove) {
-            [newRedisplayDictionary removeObjectForKey:messageId];
-        }
-
-        [OneSignalUserDefaults.initStandard saveCodeableDataForKey:OS_IAM_REDISPLAY_DICTIONARY withValue:newRedisplayDictionary];
-    }
+    [self.redisplayStore removeRecordsDisplayedBefore:maxCacheTime];
 }
 
 - (void)addInAppMessageClickListener:(NSObject<OSInAppMessageClickListener> *_Nullable)listener {
-    [_clickListeners addObject:listener];
+    [_clickListeners addListener:listener];
 }
 
 - (void)removeInAppMessageClickListener:(NSObject<OSInAppMessageClickListener> *_Nullable)listener {
-    [_clickListeners removeObject:listener];
+    [_clickListeners removeListener:listener];
 }
 
 - (void)addInAppMessageLifecycleListener:(NSObject<OSInAppMessageLifecycleListener> *_Nullable)listener {
-    [_lifecycleListeners addObject:listener];
+    [_lifecycleListeners addListener:listener];
 }
 
 - (void)removeInAppMessageLifecycleListener:(NSObject<OSInAppMessageLifecycleListener> *_Nullable)listener {
-    [_lifecycleListeners removeObject:listener];
+    [_lifecycleListeners removeListener:listener];
 }
 
 - (void)onWillDisplayInAppMessage:(OSInAppMessageInternal *)message {
-    for (NSObject<OSInAppMessageLifecycleListener> *listener in _lifecycleListeners) {
+    for (NSObject<OSInAppMessageLifecycleListener> *listener in _lifecycleListeners.listeners) {
         if ([listener respondsToSelector:@selector(onWillDisplayInAppMessage:)]) {
             OSInAppMessageWillDisplayEvent *event = [[OSInAppMessageWillDisplayEvent alloc] initWithInAppMessage:message];
             [listener onWillDisplayInAppMessage:event];
@@ -466,7 +816,7 @@ static BOOL _isInAppMessagingPaused = false;
 }
 
 - (void)onDidDisplayInAppMessage:(OSInAppMessageInternal *)message {
-    for (NSObject<OSInAppMessageLifecycleListener> *listener in _lifecycleListeners) {
+    for (NSObject<OSInAppMessageLifecycleListener> *listener in _lifecycleListeners.listeners) {
         if ([listener respondsToSelector:@selector(onDidDisplayInAppMessage:)]) {
             OSInAppMessageDidDisplayEvent *event = [[OSInAppMessageDidDisplayEvent alloc] initWithInAppMessage:message];
             [listener onDidDisplayInAppMessage:event];
@@ -475,7 +825,7 @@ static BOOL _isInAppMessagingPaused = false;
 }
 
 - (void)onWillDismissInAppMessage:(OSInAppMessageInternal *)message {
-    for (NSObject<OSInAppMessageLifecycleListener> *listener in _lifecycleListeners) {
+    for (NSObject<OSInAppMessageLifecycleListener> *listener in _lifecycleListeners.listeners) {
         if ([listener respondsToSelector:@selector(onWillDismissInAppMessage:)]) {
             OSInAppMessageWillDismissEvent *event = [[OSInAppMessageWillDismissEvent alloc] initWithInAppMessage:message];
             [listener onWillDismissInAppMessage:event];
@@ -484,7 +834,7 @@ static BOOL _isInAppMessagingPaused = false;
 }
 
 - (void)onDidDismissInAppMessage:(OSInAppMessageInternal *)message {
-    for (NSObject<OSInAppMessageLifecycleListener> *listener in _lifecycleListeners) {
+    for (NSObject<OSInAppMessageLifecycleListener> *listener in _lifecycleListeners.listeners) {
         if ([listener respondsToSelector:@selector(onDidDismissInAppMessage:)]) {
             OSInAppMessageDidDismissEvent *event = [[OSInAppMessageDidDismissEvent alloc] initWithInAppMessage:message];
             [listener onDidDismissInAppMessage:event];
@@ -498,6 +848,165 @@ static BOOL _isInAppMessagingPaused = false;
     [self presentInAppPreviewMessage:message];
 }
 
+/*
+ A silent push asked for the latest in-app messages, so new campaigns show without waiting for the next session.
+ Messages can only display in the foreground, a push received in the background defers the fetch until then.
+ */
+- (void)handleIAMRefresh:(NSNotification *)nsNotification {
+    dispatch_async(dispatch_get_main_queue(), ^{
+        if (UIApplication.sharedApplication.applicationState == UIApplicationStateBackground) {
+            self.needsRefreshOnForeground = YES;
+            return;
+        }
+        [self getInAppMessagesFromServer:OneSignalUserManagerImpl.sharedInstance.pushSubscriptionId];
+    });
+}
+
+// Catch up on the prefetching skipped while the policy or the network path was constrained
+- (void)prefetchConditionsDidChange:(NSNotification *)nsNotification {
+    if (![self allowsPrefetch])
+        return;
+    [OneSignalCoreHelper dispatch_async_on_main_queue:^{
+        if (self.messages.count == 0)
+            return;
+        [OSInAppMessageWebViewPool.sharedPool prewarm];
+        [self prefetchContentForMessages:self.messages];
+    }];
+}
+
+- (void)applicationWillEnterForeground:(NSNotification *)nsNotification {
+    if (!self.needsRefreshOnForeground)
+        return;
+    self.needsRefreshOnForeground = NO;
+    [self getInAppMessagesFromServer:OneSignalUserManagerImpl.sharedInstance.pushSubscriptionId];
+}
+
+#pragma mark App open message
+
+/*
+ Messages without triggers display as soon as a session starts, but only once the fetch and an evaluation complete.
+ When the app backgrounds, the first such message that would show is saved with its server JSON and its content
+ is prefetched, so the next launch presents it right away. The decision belongs to the onesignal_id it was made for
+ and only the launch's first fetch takes it. That fetch then re-validates it and withdraws it if the server no longer
+ sends it as a message without triggers. Changing the user discards a saved decision and withdraws a presented one.
+ Messages with session time triggers are left to the regular evaluation, their timers start with the session.
+ */
+- (OSInAppMessageInternal *)appOpenMessageCandidateInMessages:(NSArray<OSInAppMessageInternal *> *)messages {
+    for (OSInAppMessageInternal *message in messages) {
+        if (message.isPreview || message.triggers.count > 0 || [self isDormantMessage:message])
+            continue;
+        if ([self shouldShowInAppMessage:message matchesTriggers:YES])
+            return message;
+    }
+    return nil;
+}
+
+- (void)applicationDidEnterBackground:(NSNotification *)nsNotification {
+    let messages = self.messages;
+    let parsedMessagesById = self.parsedMessagesById;
+    NSString *onesignalId = OneSignalUserManagerImpl.sharedInstance.onesignalId;
+    dispatch_async(self.evaluationQueue, ^{
+        let message = onesignalId ? [self appOpenMessageCandidateInMessages:messages] : nil;
+        NSDictionary *messageJson = message ? parsedMessagesById[message.messageId][0] : nil;
+        [self saveAppOpenMessageJson:messageJson onesignalId:onesignalId];
+        if (messageJson && [self allowsPrefetch])
+            [message prefetchMessageHTMLContent];
+    });
+}
+
+// The server JSON is saved as data, it can hold nulls user defaults can't store
+- (void)saveAppOpenMessageJson:(NSDictionary *)messageJson onesignalId:(NSString *)onesignalId {
+    let standardUserDefaults = OneSignalUserDefaults.initStandard;
+    NSData *data = messageJson ? [NSJSONSerialization dataWithJSONObject:messageJson options:0 error:nil] : nil;
+    if (!data) {
+        [standardUserDefaults removeValueForKey:OS_IAM_APP_OPEN_MESSAGE_KEY];
+        return;
+    }
+    [standardUserDefaults saveObjectForKey:OS_IAM_APP_OPEN_MESSAGE_KEY withValue:@{
+        @"onesignal_id": onesignalId,
+        @"message": data
+    }];
+}
+
+/*
+ Presents the saved message if this is the launch's first fetch and the user is the one it was decided for.
+ The decision is only used once. On a cold start it becomes the evaluated list until the fetch replaces it,
+ registered as parsed from its JSON so the fetch keeps the same instance when the server sends it unchanged.
+ */
+- (void)presentAppOpenMessageForOnesignalId:(NSString *)onesignalId {
+    if (self.didTakeAppOpenMessage)
+        return;
+    self.didTakeAppOpenMessage = YES;
+    let standardUserDefaults = OneSignalUserDefaults.initStandard;
+    NSDictionary *saved = [standardUserDefaults getSavedObjectForKey:OS_IAM_APP_OPEN_MESSAGE_KEY defaultValue:nil];
+    if (!saved)
+        return;
+    [standardUserDefaults removeValueForKey:OS_IAM_APP_OPEN_MESSAGE_KEY];
+    if (_isInAppMessagingPaused || ![saved isKindOfClass:[NSDictionary class]] || ![saved[@"onesignal_id"] isEqual:onesignalId])
+        return;
+    NSData *data = saved[@"message"];
+    NSDictionary *messageJson = [data isKindOfClass:[NSData class]] ? [NSJSONSerialization JSONObjectWithData:data options:0 error:nil] : nil;
+    if (![messageJson isKindOfClass:[NSDictionary class]])
+        return;
+
+    OSInAppMessageInternal *message;
+    NSArray *parsed = self.parsedMessagesById[messageJson[@"id"]];
+    if (parsed && [parsed[0] isEqual:messageJson]) {
+        message = parsed[1];
+    } else if (self.messages.count == 0) {
+        message = [self inAppMessagesFromJson:@[messageJson]].firstObject;
+        self.messages = message ? @[message] : @[];
+    }
+    if (![message isEqual:[self appOpenMessageCandidateInMessages:message ? @[message] : @[]]])
+        return;
+    ONE_S_LOG(ONE_S_LL_VERBOSE, @"Presenting in-app message %@ decided on when the app backgrounded", message.messageId);
+    self.appOpenMessage = message;
+    self.appOpenMessageOnesignalId = onesignalId;
+    [self presentInAppMessage:message];
+}
+
+// Withdraws the app open message if the fetched messages no longer include it without triggers
+- (void)revalidateAppOpenMessageWithMessages:(NSArray<OSInAppMessageInternal *> *)newMessages {
+    let message = self.appOpenMessage;
+    if (!message)
+        return;
+    self.appOpenMessage = nil;
+    self.appOpenMessageOnesignalId = nil;
+    for (OSInAppMessageInternal *newMessage in newMessages) {
+        if ([newMessage.messageId isEqualToString:message.messageId] && newMessage.triggers.count == 0 && ![newMessage isFinished])
+            return;
+    }
+    ONE_S_LOG(ONE_S_LL_VERBOSE, @"Withdrawing in-app message %@, the fetched messages no longer agree with it", message.messageId);
+    [self withdrawAppOpenMessage:message];
+}
+
+// Discards the saved decision and withdraws the presented message unless they were made for this user
+- (void)resetAppOpenMessageForOnesignalId:(NSString *)onesignalId {
+    let standardUserDefaults = OneSignalUserDefaults.initStandard;
+    NSDictionary *saved = [standardUserDefaults getSavedObjectForKey:OS_IAM_APP_OPEN_MESSAGE_KEY defaultValue:nil];
+    if ([saved isKindOfClass:[NSDictionary class]] && ![saved[@"onesignal_id"] isEqual:onesignalId])
+        [standardUserDefaults removeValueForKey:OS_IAM_APP_OPEN_MESSAGE_KEY];
+
+    let message = self.appOpenMessage;
+    if (!message || [self.appOpenMessageOnesignalId isEqualToString:onesignalId])
+        return;
+    ONE_S_LOG(ONE_S_LL_VERBOSE, @"Withdrawing in-app message %@, it was decided on for another user", message.messageId);
+    self.appOpenMessage = nil;
+    self.appOpenMessageOnesignalId = nil;
+    [self withdrawAppOpenMessage:message];
+}
+
+// Dropped from the display queue, or dismissed if it is already showing
+- (void)withdrawAppOpenMessage:(OSInAppMessageInternal *)message {
+    @synchronized (self.messageDisplayQueue) {
+        if (self.isInAppMessageShowing && self.messageDisplayQueue.firstObject == message) {
+            [self.viewController dismissCurrentInAppMessage];
+            return;
+        }
+        [self.messageDisplayQueue removeObjectIdenticalTo:message];
+    }
+}
+
 - (void)presentInAppMessage:(OSInAppMessageInternal *)message {
     if (!message.variantId) {
         let errorMessage = [NSString stringWithFormat:@"Attempted to display a message with a nil variantId. Current preferred language is %@, supported message variants are %@", OneSignalUserManagerImpl.sharedInstance.language, message.variants];
@@ -512,6 +1021,7 @@ static BOOL _isInAppMessagingPaused = false;
         
         // Return early if an IAM is already showing
         if (self.isInAppMessageShowing) {
+            [self prepareNextMessageInDisplayQueue];
             return;
         }
         // Return early if the app is not active
@@ -564,18 +1074,40 @@ static BOOL _isInAppMessagingPaused = false;
 
 - (void)showMessage:(OSInAppMessageInternal *)message {
     self.viewController = [[OSInAppMessageViewController alloc] initWithMessage:message delegate:self];
+    // Liquid templates render with the cached tags right away, the view patches them in if the refresh changes them
     if (message.hasLiquid && !self.calledLoadTags) {
-        self.viewController.waitForTags = YES;
         [self loadTags];
     }
     dispatch_async(dispatch_get_main_queue(), ^{
         [[self.viewController view] setNeedsLayout];
     });
+    [self prepareNextMessageInDisplayQueue];
+}
+
+/*
+ Get the message queued behind the one showing ready while it is visible
+ Its content is fetched into the content cache and a spare web view is warmed in the pool,
+ so back to back messages only wait on the dismiss animation
+ */
+- (void)prepareNextMessageInDisplayQueue {
+    OSInAppMessageInternal *nextMessage;
+    @synchronized (self.messageDisplayQueue) {
+        if (self.messageDisplayQueue.count < 2) {
+            return;
+        }
+        nextMessage = self.messageDisplayQueue[1];
+    }
+    if (!nextMessage.isPreview) {
+        [nextMessage prefetchMessageHTMLContent];
+    }
+    [[NSRunLoop mainRunLoop] performInModes:@[NSDefaultRunLoopMode] block:^{
+        [OSInAppMessageWebViewPool.sharedPool prewarm];
+    }];
 }
 
 - (void)sendMessageImpression:(OSInAppMessageInternal *)message {
     if ([self shouldSendImpression:message]) {
-        dispatch_async(dispatch_get_main_queue(), ^{
+        dispatch_async(OSDispatchQueues.utility, ^{
             [self messageViewImpressionRequest:message];
         });
     }
@@ -583,14 +1115,11 @@ static BOOL _isInAppMessagingPaused = false;
 
 - (void)loadTags {
     self.calledLoadTags = YES;
-    // TODO: should we always pull new tags?
-    // For now we aren't pulling new tags and we are just using what is already on the user
-    // I am leaving the logic for waiting for tags to be pulled in case this changes
-    self.viewController.waitForTags = NO;
+    [OneSignalUserManagerImpl.sharedInstance refreshTagsInternal];
 }
 - (void)messageViewPageImpressionRequest:(OSInAppMessageInternal *)message withPageId:(NSString *)pageId {
     if (message.isPreview) {
-        [OneSignalLog onesignalLog:ONE_S_LL_VERBOSE message:[NSString stringWithFormat:@"Not sending page impression for preview message. ID: %@",pageId]];
+        ONE_S_LOG(ONE_S_LL_VERBOSE, @"Not sending page impression for preview message. ID: %@",pageId);
         return;
     }
     
@@ -601,39 +1130,17 @@ static BOOL _isInAppMessagingPaused = false;
     
     NSString *messagePrefixedPageId = [message.messageId stringByAppendingString:pageId];
     
-    if ([self.viewedPageIDs containsObject:messagePrefixedPageId]) {
-        [OneSignalLog onesignalLog:ONE_S_LL_VERBOSE message:[NSString stringWithFormat:@"Page Impression already sent. id: %@",pageId]];
+    if (![self.stateStore addId:messagePrefixedPageId toSet:OSInAppMessageStateSetViewedPages]) {
+        ONE_S_LOG(ONE_S_LL_VERBOSE, @"Page Impression already sent. id: %@",pageId);
         return;
     }
-
-    [self.viewedPageIDs addObject:messagePrefixedPageId];
     
-    [OneSignalLog onesignalLog:ONE_S_LL_VERBOSE message:[NSString stringWithFormat:@"Page Impression Request page id: %@",pageId]];
-    // Create the request and attach a payload to it
-    let metricsRequest = [OSRequestInAppMessagePageViewed withAppId:OneSignalConfigManager.getAppId
-                                                       withPlayerId:OneSignalUserManagerImpl.sharedInstance.pushSubscriptionId
-                                                      withMessageId:message.messageId
-                                                         withPageId:pageId
-                                                       forVariantId:message.variantId];
-
-    [OneSignalCoreImpl.sharedClient executeRequest:metricsRequest
-                                       onSuccess:^(NSDictionary *result) {
-        NSString *successMessage = [NSString stringWithFormat:@"In App Message with message id: %@ and page id: %@, successful POST page impression update with result: %@", message.messageId, pageId, result];
-                                           [OneSignalLog onesignalLog:ONE_S_LL_DEBUG message:successMessage];
-                                            // If the post was successful, save the updated viewedPageIds set
-                                            [OneSignalUserDefaults.initStandard saveSetForKey:OS_IAM_PAGE_IMPRESSIONED_SET_KEY withValue:self.viewedPageIDs];
-                                       }
-                                       onFailure:^(OneSignalClientError *error) {
-        NSString *errorMessage = [NSString stringWithFormat:@"In App Message with message id: %@ and page id: %@, failed POST page impression update with error: %@", message.messageId, pageId, error.message];
-                                            [OneSignalLog onesignalLog:ONE_S_LL_ERROR message:errorMessage];
-                                            if (message) {
-                                                [self.viewedPageIDs removeObject:messagePrefixedPageId];
-                                            }
-                                       }];
+    ONE_S_LOG(ONE_S_LL_VERBOSE, @"Page Impression Request page id: %@",pageId);
+    [self.telemetryBuffer recordPageImpressionForMessageId:message.messageId variantId:message.variantId pageId:pageId];
 }
 
 - (BOOL)shouldSendImpression:(OSInAppMessageInternal *)message {
-    return !(message.isPreview || [self.impressionedInAppMessages containsObject:message.messageId]);
+    return !(message.isPreview || [self.stateStore containsId:message.messageId inSet:OSInAppMessageStateSetImpressioned]);
 }
 
 /*
@@ -643,54 +1150,110 @@ static BOOL _isInAppMessagingPaused = false;
 - (void)messageViewImpressionRequest:(OSInAppMessageInternal *)message {
     // Make sure no tracking is performed for previewed IAMs
     // If the messageId exists in cached impressionedInAppMessages return early so the impression is not tracked again
-    if (![self shouldSendImpression:message])
+    if (message.isPreview)
         return;
     
-    // Add messageId to impressionedInAppMessages
-    [self.impressionedInAppMessages addObject:message.messageId];
-    
-    // Create the request and attach a payload to it
-    let metricsRequest = [OSRequestInAppMessageViewed withAppId:OneSignalConfigManager.getAppId
-                                                   withPlayerId:OneSignalUserManagerImpl.sharedInstance.pushSubscriptionId
-                                                  withMessageId:message.messageId
-                                                   forVariantId:message.variantId];
+    // Add messageId to impressionedInAppMessages, claimed atomically as impressions are sent off the main thread
+    if (![self.stateStore addId:message.messageId toSet:OSInAppMessageStateSetImpressioned])
+        return;
     
-    [OneSignalCoreImpl.sharedClient executeRequest:metricsRequest
-                                       onSuccess:^(NSDictionary *result) {
-                                           NSString *successMessage = [NSString stringWithFormat:@"In App Message with id: %@, successful POST impression update with result: %@", message.messageId, result];
-                                           [OneSignalLog onesignalLog:ONE_S_LL_DEBUG message:successMessage];
-                                           
-                                           // If the post was successful, save the updated impressionedInAppMessages set
-                                           [OneSignalUserDefaults.initStandard saveSetForKey:OS_IAM_IMPRESSIONED_SET_KEY withValue:self.impressionedInAppMessages];
-                                       }
-                                       onFailure:^(OneSignalClientError *error) {
-                                           NSString *errorMessage = [NSString stringWithFormat:@"In App Message with id: %@, failed POST impression update with error: %@", message.messageId, error.message];
-                                           [OneSignalLog onesignalLog:ONE_S_LL_ERROR message:errorMessage];
-                                           
-                                           // If the post failed, remove the messageId from the impressionedInAppMessages set
-                                           [self.impressionedInAppMessages removeObject:message.messageId];
-                                       }];
+    [self.telemetryBuffer recordImpressionForMessageId:message.messageId variantId:message.variantId];
 }
 
 /*
  Checks to see if any messages should be shown now
  */
 - (void)evaluateMessages {
+    [self evaluateMessages:self.messages];
+}
+
+- (void)evaluateMessages:(NSArray<OSInAppMessageInternal *> *)messages {
     if (_isInAppMessagingPaused) {
         [OneSignalLog onesignalLog:ONE_S_LL_VERBOSE message:@"Not evaluating in app messages while paused"];
         return;
     }
-    [OneSignalLog onesignalLog:ONE_S_LL_VERBOSE message:@"Evaluating in app messages"];
-    for (OSInAppMessageInternal *message in self.messages) {
-        if ([self.triggerController messageMatchesTriggers:message]) {
-            // Make changes to IAM if redisplay available
-            [self setDataForRedisplay:message];
-            // Should we show the in app message
-            if ([self shouldShowInAppMessage:message]) {
+    dispatch_async(self.evaluationQueue, ^{
+        ONE_S_LOG(ONE_S_LL_VERBOSE, @"Evaluating %lu in app messages", (unsigned long)messages.count);
+        NSMutableArray<OSInAppMessageInternal *> *messagesToPresent = [NSMutableArray new];
+        // Each entry is the message, its redisplay stats and whether it redisplays, applied on the main thread
+        NSMutableArray<NSArray *> *redisplayUpdates = [NSMutableArray new];
+        uint64_t signpostId = [OSTrace beginInterval:OSTraceIntervalIAMEvaluation name:[NSString stringWithFormat:@"%lu messages", (unsigned long)messages.count]];
+        NSTimeInterval evaluationStart = NSProcessInfo.processInfo.systemUptime;
+        BOOL *matches = [self triggerMatchesForMessages:messages];
+        for (NSUInteger i = 0; i < messages.count; i++) {
+            let message = messages[i];
+            if (!matches[i])
+                continue;
+            BOOL redisplay;
+            let redisplayStats = [self redisplayStatsForMessage:message redisplay:&redisplay];
+            if (redisplayStats)
+                [redisplayUpdates addObject:@[message, redisplayStats, @(redisplay)]];
+            // A message that redisplays is only left out of the seen set once the update is applied
+            BOOL shouldShow = redisplay
+                ? ![message isFinished] && OneSignalUserManagerImpl.sharedInstance.pushSubscriptionId != nil
+                : [self shouldShowInAppMessage:message matchesTriggers:YES];
+            if (shouldShow)
+                [messagesToPresent addObject:message];
+        }
+        free(matches);
+        [OSTrace endInterval:OSTraceIntervalIAMEvaluation signpostId:signpostId];
+        [OSPerformanceCounters increment:OSPerformanceCounterIAMEvaluations];
+        [OSPerformanceCounters add:(int64_t)((NSProcessInfo.processInfo.systemUptime - evaluationStart) * USEC_PER_SEC) toCounter:OSPerformanceCounterIAMEvaluationMicroseconds];
+        if (messagesToPresent.count == 0 && redisplayUpdates.count == 0)
+            return;
+
+        dispatch_async(dispatch_get_main_queue(), ^{
+            for (NSArray *update in redisplayUpdates)
+                [self applyRedisplayStats:update[1] toMessage:update[0] redisplay:[update[2] boolValue]];
+            for (OSInAppMessageInternal *message in messagesToPresent)
                 [self presentInAppMessage:message];
-            }
+        });
+    });
+}
+
+/*
+ Presents the first page's messages that can show now, while the rest of a large list is still being parsed.
+ The full list is evaluated once it is in, the display queue keeps a message from being presented twice.
+ Seen messages are left to that evaluation, their redisplay data is prepared against the whole list.
+ */
+- (void)evaluateFirstPageOfMessages:(NSArray<OSInAppMessageInternal *> *)messages {
+    if (_isInAppMessagingPaused)
+        return;
+    dispatch_async(self.evaluationQueue, ^{
+        NSMutableArray<OSInAppMessageInternal *> *messagesToPresent = [NSMutableArray new];
+        for (OSInAppMessageInternal *message in messages) {
+            if (message.isPreview || [self isDormantMessage:message])
+                continue;
+            if ([self shouldShowInAppMessage:message])
+                [messagesToPresent addObject:message];
         }
+        if (messagesToPresent.count == 0)
+            return;
+        ONE_S_LOG(ONE_S_LL_VERBOSE, @"Presenting %lu in app messages from the first page of the list", (unsigned long)messagesToPresent.count);
+        dispatch_async(dispatch_get_main_queue(), ^{
+            for (OSInAppMessageInternal *message in messagesToPresent)
+                [self presentInAppMessage:message];
+        });
+    });
+}
+
+/*
+ Matching triggers only reads the messages and the trigger snapshot, so large catalogs are matched in parallel.
+ Redisplay data is worked out afterwards on the evaluation queue, and applied with presentation on the main thread.
+ The caller frees the returned array.
+ */
+- (BOOL *)triggerMatchesForMessages:(NSArray<OSInAppMessageInternal *> *)messages {
+    let count = messages.count;
+    BOOL *matches = calloc(MAX(count, 1), sizeof(BOOL));
+    if (count < OS_IAM_PARALLEL_EVALUATION_MIN_MESSAGES) {
+        for (NSUInteger i = 0; i < count; i++)
+            matches[i] = [self.triggerController messageMatchesTriggers:messages[i]];
+        return matches;
     }
+    dispatch_apply(count, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^(size_t i) {
+        matches[i] = [self.triggerController messageMatchesTriggers:messages[i]];
+    });
+    return matches;
 }
 
 /*
@@ -704,41 +1267,61 @@ static BOOL _isInAppMessagingPaused = false;
 
  For redisplay, the message need to be removed from the arrays that track the display/impression
  For click counting, every message has it click id array
+
+ Messages are evaluated off the main thread, so this works on a copy of the display stats and changes nothing.
+ Returns nil when the message has no redisplay data, `redisplay` is set when it can display again.
 */
-- (void)setDataForRedisplay:(OSInAppMessageInternal *)message {
+- (OSInAppMessageDisplayStats *)redisplayStatsForMessage:(OSInAppMessageInternal *)message redisplay:(BOOL *)redisplay {
+    *redisplay = NO;
     if (!message.displayStats.isRedisplayEnabled) {
-        return;
+        return nil;
     }
 
-    BOOL messageDismissed = [_seenInAppMessages containsObject:message.messageId];
-    let redisplayMessageSavedData = [_redisplayedInAppMessages objectForKey:message.messageId];
+    BOOL messageDismissed = [self.stateStore containsId:message.messageId inSet:OSInAppMessageStateSetSeen];
+    BOOL hasRedisplayData = [self.redisplayStore containsMessageId:message.messageId];
 
-    [OneSignalLog onesignalLog:ONE_S_LL_VERBOSE message:[NSString stringWithFormat:@"Redisplay dismissed: %@ and data: %@", messageDismissed ? @"YES" : @"NO", redisplayMessageSavedData.jsonRepresentationInternal.description]];
+    [OneSignalLog onesignalLog:ONE_S_LL_VERBOSE messageBlock:^NSString *{
+        return [NSString stringWithFormat:@"Redisplay dismissed: %@ and has data: %@", messageDismissed ? @"YES" : @"NO", hasRedisplayData ? @"YES" : @"NO"];
+    }];
 
-    if (messageDismissed && redisplayMessageSavedData) {
-        [OneSignalLog onesignalLog:ONE_S_LL_VERBOSE message:[NSString stringWithFormat:@"Redisplay IAM: %@", message.jsonRepresentationInternal.description]];
-        
-        message.displayStats.displayQuantity = redisplayMessageSavedData.displayStats.displayQuantity;
-        message.displayStats.lastDisplayTime = redisplayMessageSavedData.displayStats.lastDisplayTime;
-
-        // Message that don't have triggers should display only once per session
-        BOOL triggerHasChanged = [self hasMessageTriggerChanged:message];
-
-        [OneSignalLog onesignalLog:ONE_S_LL_VERBOSE message:[NSString stringWithFormat:@"setDataForRedisplay with message: %@ \ntriggerHasChanged: %@ \nno triggers: %@ \ndisplayed in session saved: %@", message, message.isTriggerChanged ? @"YES" : @"NO", [message.triggers count] == 0 ? @"YES" : @"NO", redisplayMessageSavedData.isDisplayedInSession  ? @"YES" : @"NO"]];
-        // Check if conditions are correct for redisplay
-        if (triggerHasChanged &&
-            [message.displayStats isDelayTimeSatisfied:self.dateGenerator()] &&
-            [message.displayStats shouldDisplayAgain]) {
-            [OneSignalLog onesignalLog:ONE_S_LL_VERBOSE message:@"setDataForRedisplay clear arrays"];
-
-            [self.seenInAppMessages removeObject:message.messageId];
-            [self.impressionedInAppMessages removeObject:message.messageId];
-            [self.viewedPageIDs removeAllObjects];
-            [OneSignalUserDefaults.initStandard saveSetForKey:OS_IAM_PAGE_IMPRESSIONED_SET_KEY withValue:self.viewedPageIDs];
-            [message clearClickIds];
-            return;
-        }
+    if (!messageDismissed || !hasRedisplayData) {
+        return nil;
+    }
+    [OneSignalLog onesignalLog:ONE_S_LL_VERBOSE messageBlock:^NSString *{
+        return [NSString stringWithFormat:@"Redisplay IAM: %@", message.jsonRepresentationInternal.description];
+    }];
+
+    OSInAppMessageDisplayStats *displayStats = [message.displayStats copy];
+    displayStats.displayQuantity = [self.redisplayStore displayQuantityForMessageId:message.messageId];
+    displayStats.lastDisplayTime = [self.redisplayStore lastDisplayTimeForMessageId:message.messageId];
+
+    // Message that don't have triggers should display only once per session
+    BOOL triggerHasChanged = [self hasMessageTriggerChanged:message];
+
+    [OneSignalLog onesignalLog:ONE_S_LL_VERBOSE messageBlock:^NSString *{
+        return [NSString stringWithFormat:@"redisplayStatsForMessage with message: %@ \ntriggerHasChanged: %@ \nno triggers: %@ \ndisplayed in session: %@", message, message.isTriggerChanged ? @"YES" : @"NO", [message.triggers count] == 0 ? @"YES" : @"NO", message.isDisplayedInSession  ? @"YES" : @"NO"];
+    }];
+    // Check if conditions are correct for redisplay
+    *redisplay = triggerHasChanged &&
+        [displayStats isDelayTimeSatisfied:self.dateGenerator()] &&
+        [displayStats shouldDisplayAgain];
+    return displayStats;
+}
+
+// Applies what redisplayStatsForMessage:redisplay: worked out, on the main thread
+- (void)applyRedisplayStats:(OSInAppMessageDisplayStats *)displayStats toMessage:(OSInAppMessageInternal *)message redisplay:(BOOL)redisplay {
+    message.displayStats.displayQuantity = displayStats.displayQuantity;
+    message.displayStats.lastDisplayTime = displayStats.lastDisplayTime;
+    if (!redisplay) {
+        return;
     }
+    [OneSignalLog onesignalLog:ONE_S_LL_VERBOSE message:@"applyRedisplayStats clear arrays"];
+
+    [self.stateStore removeId:message.messageId fromSet:OSInAppMessageStateSetSeen];
+    [self.stateStore removeId:message.messageId fromSet:OSInAppMessageStateSetImpressioned];
+    [self.stateStore removeAllIdsFromSet:OSInAppMessageStateSetViewedPages];
+    [self.stateStore setNeedsFlush];
+    [message clearClickIds];
 }
 
 - (BOOL)hasMessageTriggerChanged:(OSInAppMessageInternal *)message {
@@ -758,8 +1341,12 @@ static BOOL _isInAppMessagingPaused = false;
  Checks if the IAM matches any triggers or if it exists in cached seenInAppMessages set
  */
 - (BOOL)shouldShowInAppMessage:(OSInAppMessageInternal *)message {
-    return ![self.seenInAppMessages containsObject:message.messageId] &&
-           [self.triggerController messageMatchesTriggers:message] &&
+    return [self shouldShowInAppMessage:message matchesTriggers:[self.triggerController messageMatchesTriggers:message]];
+}
+
+- (BOOL)shouldShowInAppMessage:(OSInAppMessageInternal *)message matchesTriggers:(BOOL)matchesTriggers {
+    return ![self.stateStore containsId:message.messageId inSet:OSInAppMessageStateSetSeen] &&
+           matchesTriggers &&
            ![message isFinished] &&
            OneSignalUserManagerImpl.sharedInstance.pushSubscriptionId != nil;
     return true;
@@ -787,9 +1374,9 @@ static BOOL _isInAppMessagingPaused = false;
  *   - At least one Trigger has changed
  */
 - (void)evaluateRedisplayedInAppMessages:(NSArray<NSString *> *)newTriggersKeys {
-    for (OSInAppMessageInternal *message in _messages) {
-        if ([_redisplayedInAppMessages objectForKey:message.messageId] &&
-            [self.triggerController hasSharedTriggers:message newTriggersKeys:newTriggersKeys]) {
+    // Messages from the trigger key index already share at least one of the keys
+    for (OSInAppMessageInternal *message in [self messagesWithTriggerKeys:newTriggersKeys]) {
+        if ([self.redisplayStore containsMessageId:message.messageId]) {
               message.isTriggerChanged = true;
         }
     }
@@ -840,12 +1427,15 @@ static BOOL _isInAppMessagingPaused = false;
                 [self onDidDismissInAppMessage:message];
             }
             OSInAppMessageInternal *showingIAM = self.messageDisplayQueue.firstObject;
-            [self.seenInAppMessages addObject:showingIAM.messageId];
-            [OneSignalUserDefaults.initStandard saveSetForKey:OS_IAM_SEEN_SET_KEY withValue:self.seenInAppMessages];
-            [OneSignalLog onesignalLog:ONE_S_LL_VERBOSE message:[NSString stringWithFormat:@"Dismissing IAM save seenInAppMessages: %@", _seenInAppMessages]];
+            [self.stateStore addId:showingIAM.messageId toSet:OSInAppMessageStateSetSeen];
+            [self.stateStore setNeedsFlush];
+            [OneSignalLog onesignalLog:ONE_S_LL_VERBOSE messageBlock:^NSString *{
+                return [NSString stringWithFormat:@"Dismissing IAM save seenInAppMessages: %@", [self.stateStore idsInSet:OSInAppMessageStateSetSeen]];
+            }];
             // Remove dismissed IAM from messageDisplayQueue
             [self.messageDisplayQueue removeObjectAtIndex:0];
             [self persistInAppMessageForRedisplay:showingIAM];
+            [self pruneDormantMessages];
         }
         // Reset the IAM viewController to prepare for next IAM if one exists
         self.viewController = nil;
@@ -867,9 +1457,10 @@ static BOOL _isInAppMessagingPaused = false;
          Hide the top level IAM window
          After the IAM window is hidden, iOS will automatically promote the main window
          This also re-shows the keyboard automatically if it had focus in a text input
+         The window itself is kept for the next display, only the message's view controller is released
         */
         self.window.hidden = true;
-        self.window = nil;
+        self.window.rootViewController = nil;
     }
 }
 
@@ -901,7 +1492,7 @@ static BOOL _isInAppMessagingPaused = false;
 - (void)persistInAppMessageForRedisplay:(OSInAppMessageInternal *)message {
     // If the IAM doesn't have the re display prop or is a preview IAM there is no need to save it
     if (![message.displayStats isRedisplayEnabled] || message.isPreview) {
-        [OneSignalLog onesignalLog:ONE_S_LL_VERBOSE message:[NSString stringWithFormat:@"not persisting %@",message.displayStats]];
+        ONE_S_LOG(ONE_S_LL_VERBOSE, @"not persisting %@",message.displayStats);
         return;
     }
 
@@ -911,19 +1502,9 @@ static BOOL _isInAppMessagingPaused = false;
     message.isTriggerChanged = false;
     message.isDisplayedInSession = true;
 
-    [OneSignalLog onesignalLog:ONE_S_LL_VERBOSE message:[NSString stringWithFormat:@"redisplayedInAppMessages: %@", [_redisplayedInAppMessages description]]];
-
     // Update the data to enable future re displays
-    // Avoid calling the userdefault data again
-    [_redisplayedInAppMessages setObject:message forKey:message.messageId];
-
-    [OneSignalUserDefaults.initStandard saveCodeableDataForKey:OS_IAM_REDISPLAY_DICTIONARY withValue:_redisplayedInAppMessages];
-    [OneSignalLog onesignalLog:ONE_S_LL_VERBOSE message:[NSString stringWithFormat:@"persistInAppMessageForRedisplay: %@ \nredisplayedInAppMessages: %@", [message description], _redisplayedInAppMessages]];
-
-    let standardUserDefaults = OneSignalUserDefaults.initStandard;
-    let redisplayedInAppMessages = [[NSMutableDictionary alloc] initWithDictionary:[standardUserDefaults getSavedCodeableDataForKey:OS_IAM_REDISPLAY_DICTIONARY defaultValue:[NSMutableDictionary new]]];
-
-    [OneSignalLog onesignalLog:ONE_S_LL_VERBOSE message:[NSString stringWithFormat:@"persistInAppMessageForRedisplay saved redisplayedInAppMessages: %@", [redisplayedInAppMessages description]]];
+    [self.redisplayStore setDisplayQuantity:message.displayStats.displayQuantity lastDisplayTime:displayTimeSeconds forMessageId:message.messageId];
+    ONE_S_LOG(ONE_S_LL_VERBOSE, @"persistInAppMessageForRedisplay: %@", [message description]);
 }
 
 - (void)handlePromptActions:(NSArray<NSObject<OSInAppMessagePrompt> *> *)promptActions withMessage:(OSInAppMessageInternal *)inAppMessage {
@@ -937,10 +1518,10 @@ static BOOL _isInAppMessagingPaused = false;
     }
 
     if (_currentPromptAction) {
-        [OneSignalLog onesignalLog:ONE_S_LL_VERBOSE message:[NSString stringWithFormat:@"IAM prompt to handle: %@", [_currentPromptAction description]]];
+        ONE_S_LOG(ONE_S_LL_VERBOSE, @"IAM prompt to handle: %@", [_currentPromptAction description]);
         _currentPromptAction.hasPrompted = YES;
         [_currentPromptAction handlePrompt:^(PromptActionResult result) {
-            [OneSignalLog onesignalLog:ONE_S_LL_VERBOSE message:[NSString stringWithFormat:@"IAM prompt to handle finished accepted: %u", result]];
+            ONE_S_LOG(ONE_S_LL_VERBOSE, @"IAM prompt to handle finished accepted: %u", result);
             if (inAppMessage.isPreview && result == LOCATION_PERMISSIONS_MISSING_INFO_PLIST) {
                 [self showAlertDialogMessage:inAppMessage promptActions:promptActions];
             } else {
@@ -984,7 +1565,7 @@ static BOOL _isInAppMessagingPaused = false;
         [[OSSessionManager sharedSessionManager] onDirectInfluenceFromIAMClick:message.messageId];
     }
     
-    for (NSObject<OSInAppMessageClickListener> *listener in _clickListeners) {
+    for (NSObject<OSInAppMessageClickListener> *listener in _clickListeners.listeners) {
         if ([listener respondsToSelector:@selector(onClickInAppMessage:)]) {
             OSInAppMessageClickEvent *event = [[OSInAppMessageClickEvent alloc] initWithInAppMessage:message clickResult:action];
             [listener onClickInAppMessage:event];
@@ -1004,8 +1585,8 @@ static BOOL _isInAppMessagingPaused = false;
 }
 
 - (void)messageViewDidDisplayPage:(OSInAppMessageInternal *)message withPageId:(NSString *)pageId {
-    dispatch_async(dispatch_get_main_queue(), ^{
-           [self messageViewPageImpressionRequest:message withPageId:pageId];
+    dispatch_async(OSDispatchQueues.utility, ^{
+        [self messageViewPageImpressionRequest:message withPageId:pageId];
     });
 }
 
@@ -1025,10 +1606,10 @@ static BOOL _isInAppMessagingPaused = false;
  */
 - (void)processPreviewInAppMessage:(OSInAppMessageInternal *)message withAction:(OSInAppMessageClickResult *)action {
      if (action.tags)
-        [OneSignalLog onesignalLog:ONE_S_LL_VERBOSE message:[NSString stringWithFormat:@"Tags detected inside of the action click payload, ignoring because action came from IAM preview\nTags: %@", action.tags.jsonRepresentation]];
+        ONE_S_LOG(ONE_S_LL_VERBOSE, @"Tags detected inside of the action click payload, ignoring because action came from IAM preview\nTags: %@", action.tags.jsonRepresentation);
 
     if (action.outcomes.count > 0) {
-        [OneSignalLog onesignalLog:ONE_S_LL_VERBOSE message:[NSString stringWithFormat:@"Outcomes detected inside of the action click payload, ignoring because action came from IAM preview: %@", [action.outcomes description]]];
+        ONE_S_LOG(ONE_S_LL_VERBOSE, @"Outcomes detected inside of the action click payload, ignoring because action came from IAM preview: %@", [action.outcomes description]);
     }
 }
 
@@ -1039,7 +1620,7 @@ static BOOL _isInAppMessagingPaused = false;
 */
 - (BOOL)isClickAvailable:(OSInAppMessageInternal *)message withClickId:(NSString *)clickId {
     // If IAM has redisplay the clickId may be available
-    return ([message.displayStats isRedisplayEnabled] && [message isClickAvailable:clickId]) || ![_clickedClickIds containsObject:clickId];
+    return ([message.displayStats isRedisplayEnabled] && [message isClickAvailable:clickId]) || ![self.stateStore containsId:clickId inSet:OSInAppMessageStateSetClicked];
 }
 
 - (void)sendClickRESTCall:(OSInAppMessageInternal *)message withAction:(OSInAppMessageClickResult *)action {
@@ -1054,31 +1635,11 @@ static BOOL _isInAppMessagingPaused = false;
         return;
     }
     // Add clickId to clickedClickIds
-    [self.clickedClickIds addObject:clickId];
+    [self.stateStore addId:clickId toSet:OSInAppMessageStateSetClicked];
     // Track clickId per IAM
     [message addClickId:clickId];
     
-    let metricsRequest = [OSRequestInAppMessageClicked withAppId:OneSignalConfigManager.getAppId
-                                                    withPlayerId:OneSignalUserManagerImpl.sharedInstance.pushSubscriptionId
-                                                   withMessageId:message.messageId
-                                                    forVariantId:message.variantId
-                                                      withAction:action];
-
-   [OneSignalCoreImpl.sharedClient executeRequest:metricsRequest
-                                      onSuccess:^(NSDictionary *result) {
-                                          NSString *successMessage = [NSString stringWithFormat:@"In App Message with id: %@, successful POST click update for click id: %@, with result: %@", message.messageId, action.clickId,  result];
-                                          [OneSignalLog onesignalLog:ONE_S_LL_DEBUG message:successMessage];
-
-                                          // Save the updated clickedClickIds since click was tracked successfully
-                                          [OneSignalUserDefaults.initStandard saveSetForKey:OS_IAM_CLICKED_SET_KEY withValue:self.clickedClickIds];
-                                      }
-                                      onFailure:^(OneSignalClientError *error) {
-                                          NSString *errorMessage = [NSString stringWithFormat:@"In App Message with id: %@, failed POST click update for click id: %@, with error: %@", message.messageId, action.clickId, error.message];
-                                          [OneSignalLog onesignalLog:ONE_S_LL_ERROR message:errorMessage];
-
-                                          // Remove clickId from local clickedClickIds since click was not tracked
-                                          [self.clickedClickIds removeObject:action.clickId];
-                                      }];
+    [self.telemetryBuffer recordClickForMessageId:message.messageId variantId:message.variantId clickId:clickId firstClick:action.firstClick];
 }
 
 - (void)sendTagCallWithAction:(OSInAppMessageClickResult *)action {
@@ -1123,13 +1684,13 @@ static BOOL _isInAppMessagingPaused = false;
     if (!self.window) {
         self.window = [[UIWindow alloc] init];
         self.window.windowLevel = UIWindowLevelAlert;
-        self.window.frame = [[UIScreen mainScreen] bounds];
+        self.window.backgroundColor = [UIColor clearColor];
+        self.window.opaque = true;
+        self.window.clipsToBounds = true;
     }
-    
+    // Banners shrink the window to fit, a reused window starts from the full screen again
+    self.window.frame = [[UIScreen mainScreen] bounds];
     self.window.rootViewController = _viewController;
-    self.window.backgroundColor = [UIColor clearColor];
-    self.window.opaque = true;
-    self.window.clipsToBounds = true;
 
     [self addKeySceneToWindow:self.window];
 
@@ -1144,19 +1705,21 @@ static BOOL _isInAppMessagingPaused = false;
         // window.windowScene = UIApplication.sharedApplication.keyWindow.windowScene;
         UIWindow *keyWindow = UIApplication.sharedApplication.keyWindow;
         id windowScene = [keyWindow performSelector:@selector(windowScene)];
+        // A reused window usually still belongs to the key scene, moving it between scenes is not free
+        if ([window performSelector:@selector(windowScene)] == windowScene)
+            return;
         [window performSelector:@selector(setWindowScene:) withObject:windowScene];
     }
 }
 
 - (void)dynamicTriggerCompleted:(NSString *)triggerId {
-    [OneSignalLog onesignalLog:ONE_S_LL_VERBOSE message:[NSString stringWithFormat:@"messageDynamicTriggerCompleted called with triggerId: %@", triggerId]];
+    ONE_S_LOG(ONE_S_LL_VERBOSE, @"messageDynamicTriggerCompleted called with triggerId: %@", triggerId);
     [self makeRedisplayMessagesAvailableWithTriggers:@[triggerId]];
 }
 
 - (void)makeRedisplayMessagesAvailableWithTriggers:(NSArray<NSString *> *)triggerIds {
-    for (OSInAppMessageInternal *message in self.messages) {
-        if ([self.redisplayedInAppMessages objectForKey:message.messageId]
-            && [_triggerController hasSharedTriggers:message newTriggersKeys:triggerIds]) {
+    for (OSInAppMessageInternal *message in [self messagesWithTriggerKeys:triggerIds]) {
+        if ([self.redisplayStore containsMessageId:message.messageId]) {
             message.isTriggerChanged = YES;
         }
     }
@@ -1170,6 +1733,12 @@ static BOOL _isInAppMessagingPaused = false;
     [self evaluateMessages];
 }
 
+- (void)triggerConditionChangedForKeys:(NSArray<NSString *> *)keys {
+    // Only messages with a condition on one of the changed keys can change their result
+    ONE_S_LOG(ONE_S_LL_VERBOSE, @"Trigger condition changed for keys: %@", keys);
+    [self evaluateMessages:[self messagesWithTriggerKeys:keys]];
+}
+
 #pragma mark OSMessagingControllerDelegate Methods
 - (void)onApplicationDidBecomeActive {
     // To avoid excesive message evaluation
@@ -1200,6 +1769,16 @@ static BOOL _isInAppMessagingPaused = false;
     [self getInAppMessagesFromServer:state.current.id];
 }
 
+#pragma mark OSUserStateObserver Methods
+
+// The app open decision only holds for the onesignal_id it was made for
+- (void)onUserStateDidChangeWithState:(OSUserChangedState * _Nonnull)state {
+    NSString *onesignalId = state.current.onesignalId;
+    [OneSignalCoreHelper dispatch_async_on_main_queue:^{
+        [self resetAppOpenMessageForOnesignalId:onesignalId];
+    }];
+}
+
 - (void)dealloc {
     [[NSNotificationCenter defaultCenter] removeObserver:self];
 }
@@ -1234,6 +1813,7 @@ static BOOL _isInAppMessagingPaused = false;
 - (void)webViewContentFinishedLoading:(OSInAppMessageInternal *)message {}
 #pragma mark OSTriggerControllerDelegate Methods
 - (void)triggerConditionChanged {}
+- (void)triggerConditionChangedForKeys:(NSArray<NSString *> *)keys {}
 - (void)dynamicTriggerCompleted:(NSString *)triggerId {}
 
 @end
@@ -39,6 +39,8 @@ NS_ASSUME_NONNULL_BEGIN
  It is also called when the app changes trigger values
  */
 - (void)triggerConditionChanged;
+// Called when the app changes trigger values, only messages referencing these keys need re-evaluating
+- (void)triggerConditionChangedForKeys:(NSArray<NSString *> *)keys;
 - (void)dynamicTriggerCompleted:(NSString *)triggerId;
 @end
 
@@ -49,6 +51,7 @@ NS_ASSUME_NONNULL_BEGIN
 - (BOOL)messageMatchesTriggers:(OSInAppMessageInternal *)message;
 - (BOOL)hasSharedTriggers:(OSInAppMessageInternal *)message newTriggersKeys:(NSArray<NSString *> *)newTriggersKeys;
 - (BOOL)messageHasOnlyDynamicTriggers:(OSInAppMessageInternal *)message;
+- (NSDictionary<NSString *, NSIndexSet *> *)triggerKeyIndexForMessages:(NSArray<OSInAppMessageInternal *> *)messages;
 - (void)addTriggers:(NSDictionary<NSString *, id> *)triggers;
 - (void)removeTriggersForKeys:(NSArray<NSString *> *)keys;
 - (NSDictionary<NSString *, id> *)getTriggers;
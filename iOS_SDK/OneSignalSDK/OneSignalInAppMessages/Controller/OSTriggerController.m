@@ -29,7 +29,10 @@
 #import "OSInAppMessagingDefines.h"
 
 @interface OSTriggerController ()
-@property (strong, nonatomic, nonnull) NSMutableDictionary<NSString *, id> *triggers;
+// Immutable snapshot replaced on every change, so evaluation can read it without locking
+@property (strong, atomic, nonnull) NSDictionary<NSString *, id> *triggers;
+// Serializes writers building the next snapshot
+@property (strong, nonatomic, nonnull) NSObject *triggersWriteLock;
 @property (strong, nonatomic, nonnull) OSDynamicTriggerController *dynamicTriggerController;
 @end
 
@@ -37,7 +40,8 @@
 
 - (instancetype _Nonnull)init {
     if (self = [super init]) {
-        self.triggers = [NSMutableDictionary<NSString *, id> new];
+        self.triggers = [NSDictionary<NSString *, id> new];
+        self.triggersWriteLock = [NSObject new];
         self.dynamicTriggerController = [OSDynamicTriggerController new];
         self.dynamicTriggerController.delegate = self;
     }
@@ -47,32 +51,29 @@
 
 #pragma mark Public Methods
 - (void)addTriggers:(NSDictionary<NSString *, id> *)triggers {
-    @synchronized (self.triggers) {
-        [self.triggers addEntriesFromDictionary:triggers];
-        
-        [self.delegate triggerConditionChanged];
+    @synchronized (self.triggersWriteLock) {
+        NSMutableDictionary *newTriggers = [self.triggers mutableCopy];
+        [newTriggers addEntriesFromDictionary:triggers];
+        self.triggers = [newTriggers copy];
     }
+    [self.delegate triggerConditionChangedForKeys:triggers.allKeys];
 }
 
 - (void)removeTriggersForKeys:(NSArray<NSString *> *)keys {
-    @synchronized (self.triggers) {
-        for (NSString *key in keys)
-            [self.triggers removeObjectForKey:key];
-        
-        [self.delegate triggerConditionChanged];
+    @synchronized (self.triggersWriteLock) {
+        NSMutableDictionary *newTriggers = [self.triggers mutableCopy];
+        [newTriggers removeObjectsForKeys:keys];
+        self.triggers = [newTriggers copy];
     }
+    [self.delegate triggerConditionChangedForKeys:keys];
 }
 
 - (NSDictionary<NSString *, id> *)getTriggers {
-    @synchronized (self.triggers) {
-        return self.triggers;
-    }
+    return self.triggers;
 }
 
 - (id)getTriggerValueForKey:(NSString *)key {
-    @synchronized (self.triggers) {
-        return self.triggers[key];
-    }
+    return self.triggers[key];
 }
 
 /*
@@ -81,19 +82,7 @@
  * If trigger key is part of message triggers, then return true, otherwise false
  */
 - (BOOL)hasSharedTriggers:(OSInAppMessageInternal *)message newTriggersKeys:(NSArray<NSString *> *)newTriggersKeys {
-    for (NSString *triggerKey in newTriggersKeys) {
-        for (NSArray <OSTrigger *> *andConditions in message.triggers) {
-            for (OSTrigger *trigger in andConditions) {
-                // Dynamic triggers depends on triggerId
-                // Common triggers changed by user depends on property
-                if ([triggerKey isEqual:trigger.property] || [triggerKey isEqualToString:trigger.triggerId]) {
-                    // At least one trigger has changed
-                    return YES;
-                }
-            }
-        }
-    }
-    return NO;
+    return [[self triggerKeysForMessage:message] intersectsSet:[NSSet setWithArray:newTriggersKeys]];
 }
 
 /*
@@ -107,7 +96,7 @@
 
     for (NSArray <OSTrigger *> *andConditions in message.triggers) {
         for (OSTrigger *trigger in andConditions) {
-            if ([trigger.kind isEqualToString:OS_DYNAMIC_TRIGGER_KIND_CUSTOM])
+            if (trigger.kindType == OSTriggerKindTypeCustom)
                 // At least one trigger is not dynamic
                 return false;
          }
@@ -116,8 +105,50 @@
     return true;
 }
 
+/*
+ Inverted index from trigger key to the indexes of the messages referencing it
+ Keys come from triggerKeysForMessage: like hasSharedTriggers, so the index and the per message check always agree
+ */
+- (NSDictionary<NSString *, NSIndexSet *> *)triggerKeyIndexForMessages:(NSArray<OSInAppMessageInternal *> *)messages {
+    NSMutableDictionary<NSString *, NSMutableIndexSet *> *index = [NSMutableDictionary new];
+    for (NSUInteger i = 0; i < messages.count; i++) {
+        for (NSString *triggerKey in [self triggerKeysForMessage:messages[i]]) {
+            if (!index[triggerKey])
+                index[triggerKey] = [NSMutableIndexSet new];
+            [index[triggerKey] addIndex:i];
+        }
+    }
+    return index;
+}
+
+/*
+ Dynamic triggers change by triggerId, common triggers changed by the user by property, so both identify a trigger
+ */
+- (NSSet<NSString *> *)triggerKeysForMessage:(OSInAppMessageInternal *)message {
+    NSMutableSet<NSString *> *triggerKeys = [NSMutableSet new];
+    for (NSArray <OSTrigger *> *andConditions in message.triggers) {
+        for (OSTrigger *trigger in andConditions) {
+            if (trigger.property.length > 0)
+                [triggerKeys addObject:trigger.property];
+            if (trigger.triggerId.length > 0)
+                [triggerKeys addObject:trigger.triggerId];
+        }
+    }
+    return triggerKeys;
+}
+
 #pragma mark Private Methods
 
++ (NSNumberFormatter *)decimalFormatter {
+    static NSNumberFormatter *formatter;
+    static dispatch_once_t once;
+    dispatch_once(&once, ^{
+        formatter = [NSNumberFormatter new];
+        formatter.numberStyle = NSNumberFormatterDecimalStyle;
+    });
+    return formatter;
+}
+
 - (void)timeSinceLastMessage:(NSDate *)date {
     if (date == nil) {
         date = [NSDate distantPast];
@@ -141,6 +172,9 @@
 - (BOOL)messageMatchesTriggers:(OSInAppMessageInternal *)message {
     if (message.triggers.count == 0)
         return true;
+
+    // Evaluate every condition against the same snapshot
+    let triggers = self.triggers;
     for (NSArray <OSTrigger *> *conditions in message.triggers) {
 
         // Dynamic triggers should be handled after looping through all other triggers
@@ -150,9 +184,9 @@
         for (int i = 0; i < conditions.count; i++) {
             let trigger = conditions[i];
             
-            if (OS_IS_DYNAMIC_TRIGGER_KIND(trigger.kind))
+            if (trigger.isDynamic)
                 [dynamicTriggers addObject:trigger];
-            else if (![self evaluateTrigger:trigger forMessage:message]) {
+            else if (![self evaluateTrigger:trigger withTriggers:triggers]) {
                 foundFalseTrigger = true;
                 break;
             }
@@ -183,14 +217,15 @@
     return false;
 }
 
-- (BOOL)evaluateTrigger:(OSTrigger *)trigger forMessage:(OSInAppMessageInternal *)message {
-    if (!self.triggers[trigger.property] && [trigger.kind isEqualToString:OS_DYNAMIC_TRIGGER_KIND_CUSTOM]) {
+- (BOOL)evaluateTrigger:(OSTrigger *)trigger withTriggers:(NSDictionary<NSString *, id> *)triggers {
+    id realValue = triggers[trigger.property];
+    if (!realValue && trigger.kindType == OSTriggerKindTypeCustom) {
         // The value doesn't exist
         
         // The condition for this trigger is true since the value doesn't exist
         // Either loop to the next condition, or return true if we are the last condition
         return trigger.operatorType == OSTriggerOperatorTypeNotExists ||
-        (trigger.value && trigger.operatorType == OSTriggerOperatorTypeNotEqualTo);
+        (trigger.valueType != OSTriggerValueTypeNone && trigger.operatorType == OSTriggerOperatorTypeNotEqualTo);
 
     } else if (trigger.operatorType == OSTriggerOperatorTypeExists) {
         return true;
@@ -199,14 +234,12 @@
     }
     
     // If we reach this point, the trigger has been set locally
-    id realValue = self.triggers[trigger.property];
-    
     if (trigger.operatorType == OSTriggerOperatorTypeContains) {
         return [self array:realValue containsValue:trigger.value];
-    } else if ([trigger.value isKindOfClass:[NSNumber class]] && [realValue isKindOfClass:[NSNumber class]] &&
+    } else if (trigger.valueType == OSTriggerValueTypeNumber && [realValue isKindOfClass:[NSNumber class]] &&
                 [self trigger:trigger.value matchesNumericValue:realValue operatorType:trigger.operatorType]) {
         return true;
-    } else if ([trigger.value isKindOfClass:[NSString class]] && [realValue isKindOfClass:[NSString class]] &&
+    } else if (trigger.valueType == OSTriggerValueTypeString && [realValue isKindOfClass:[NSString class]] &&
                 [self trigger:trigger.value matchesStringValue:realValue operatorType:trigger.operatorType]) {
         return true;
     } else if ([self triggerMatchesFlex:trigger matchesStringValue:realValue]) {
@@ -233,16 +266,14 @@
 }
 
 - (BOOL)triggerMatchesFlex:(OSTrigger *)trigger matchesStringValue:(id)realValue {
-    if (![trigger value])
+    if (trigger.valueType == OSTriggerValueTypeNone)
         return false;
     
     if ([trigger operatorType] == OSTriggerOperatorTypeEqualTo || [trigger operatorType] == OSTriggerOperatorTypeNotEqualTo)
-        return [self trigger:[trigger.value description] matchesStringValue:[realValue description] operatorType:trigger.operatorType];
+        return [self trigger:trigger.flexValue matchesStringValue:[realValue description] operatorType:trigger.operatorType];
     
-    if ([trigger.value isKindOfClass:[NSNumber class]] && [realValue isKindOfClass:[NSString class]]) {
-        NSNumberFormatter *formatter = [[NSNumberFormatter alloc] init];
-        formatter.numberStyle = NSNumberFormatterDecimalStyle;
-        NSNumber *realValueFormatted = [formatter numberFromString:realValue];
+    if (trigger.valueType == OSTriggerValueTypeNumber && [realValue isKindOfClass:[NSString class]]) {
+        NSNumber *realValueFormatted = [[OSTriggerController decimalFormatter] numberFromString:realValue];
         return [self trigger:trigger.value matchesNumericValue:realValueFormatted operatorType:trigger.operatorType];
     }
     
@@ -60,6 +60,9 @@ typedef NS_ENUM(NSUInteger, OSInAppMessageBridgeEventType) {
 @property (nonatomic) OSInAppMessageBridgeEventResize *resize;
 @property (nonatomic, nullable) OSInAppMessageBridgeEventPageChange *pageChange;
 @property (strong, nonatomic, nullable) OSInAppMessageClickResult *userAction;
+
+// Decodes a WKScriptMessage body, either a JSON string or an object posted from JS
++ (instancetype _Nullable)instanceWithScriptMessageBody:(id)body;
 @end
 
 NS_ASSUME_NONNULL_END
@@ -41,6 +41,16 @@
     return [OSInAppMessageBridgeEvent instanceWithJson:json];
 }
 
++ (instancetype _Nullable)instanceWithScriptMessageBody:(id)body {
+    // Events posted as JS objects arrive already bridged to a dictionary and need no JSON parsing
+    if ([body isKindOfClass:[NSDictionary class]])
+        return [OSInAppMessageBridgeEvent instanceWithJson:body];
+    if ([body isKindOfClass:[NSString class]])
+        return [OSInAppMessageBridgeEvent instanceWithData:[body dataUsingEncoding:NSUTF8StringEncoding]];
+    [OneSignalLog onesignalLog:ONE_S_LL_WARN message:[NSString stringWithFormat:@"Unable to decode JS-bridge event of class: %@", [body class]]];
+    return nil;
+}
+
 + (instancetype _Nullable)instanceWithJson:(NSDictionary *)json {
     let instance = [OSInAppMessageBridgeEvent new];
     
@@ -92,6 +102,14 @@
 @end
 
 
+// The page height in pageMetaData.rect.height, nil unless every level has the expected type
+static NSNumber *OSBridgeEventPageHeight(NSDictionary *json) {
+    NSDictionary *pageMetaData = json[@"pageMetaData"];
+    NSDictionary *rect = [pageMetaData isKindOfClass:[NSDictionary class]] ? pageMetaData[@"rect"] : nil;
+    NSNumber *height = [rect isKindOfClass:[NSDictionary class]] ? rect[@"height"] : nil;
+    return [height isKindOfClass:[NSNumber class]] ? height : nil;
+}
+
 @implementation OSInAppMessageBridgeEventRenderingComplete
 + (instancetype _Nullable)instanceWithData:(NSData *)data {
     return nil;
@@ -100,15 +118,15 @@
 + (instancetype)instanceWithJson:(NSDictionary *)json {
     let instance = [OSInAppMessageBridgeEventRenderingComplete new];
     
-    if (json[@"displayLocation"])
-        instance.displayLocation = OS_IN_APP_DISPLAY_POSITION_FROM_STRING(json[@"displayLocation"]);
+    let displayLocation = [json[@"displayLocation"] isKindOfClass:[NSString class]] ? OS_IN_APP_DISPLAY_POSITION_FROM_STRING(json[@"displayLocation"]) : NSNotFound;
+    if (displayLocation != NSNotFound)
+        instance.displayLocation = (OSInAppMessageDisplayPosition)displayLocation;
     else
         instance.displayLocation = OSInAppMessageDisplayPositionFullScreen;
     
-    if (json[@"pageMetaData"][@"rect"][@"height"])
-        instance.height = json[@"pageMetaData"][@"rect"][@"height"];
+    instance.height = OSBridgeEventPageHeight(json);
     
-    if (json[@"dragToDismissDisabled"]) {
+    if ([json[@"dragToDismissDisabled"] isKindOfClass:[NSNumber class]]) {
         instance.dragToDismissDisabled = [json[@"dragToDismissDisabled"] boolValue];
     }
     
@@ -132,10 +150,7 @@
 
 + (instancetype)instanceWithJson:(NSDictionary *)json {
     let instance = [OSInAppMessageBridgeEventResize new];
-    
-    if (json[@"pageMetaData"][@"rect"][@"height"])
-        instance.height = json[@"pageMetaData"][@"rect"][@"height"];
-    
+    instance.height = OSBridgeEventPageHeight(json);
     return instance;
 }
 
@@ -75,7 +75,7 @@
     else
         action.closingMessage = true; // Default behavior
     
-    [OneSignalLog onesignalLog:ONE_S_LL_VERBOSE message:[NSString stringWithFormat:@"OSInAppMessageClickResult %@", json]];
+    ONE_S_LOG(ONE_S_LL_VERBOSE, @"OSInAppMessageClickResult %@", json);
 
     NSMutableArray *outcomes = [NSMutableArray new];
     //TODO: when backend is ready check that key matches
@@ -83,12 +83,13 @@
         NSArray *outcomesString = json[@"outcomes"];
         
         for (NSDictionary *outcomeJson in outcomesString) {
-            [outcomes addObject:[OSInAppMessageOutcome instanceWithJson:outcomeJson]];
+            if ([outcomeJson isKindOfClass:[NSDictionary class]])
+                [outcomes addObject:[OSInAppMessageOutcome instanceWithJson:outcomeJson]];
         }
     }
     action.outcomes = outcomes;
     //TODO: when backend is ready check if key match
-    if (json[@"tags"]) {
+    if ([json[@"tags"] isKindOfClass:[NSDictionary class]]) {
         action.tags= [OSInAppMessageTag instanceWithJson:json[@"tags"]];
     } else {
         action.tags = nil;
@@ -100,6 +101,8 @@
         NSArray<NSString *> *promptActionsStrings = json[@"prompts"];
         
         for (NSString *prompt in promptActionsStrings) {
+            if (![prompt isKindOfClass:[NSString class]])
+                continue;
             // TODO: We should refactor this string handling to enums
             if ([prompt isEqualToString:@"push"]) {
                 [promptActions addObject:[[OSInAppMessagePushPrompt alloc] init]];
@@ -27,7 +27,7 @@
 
 #import <OneSignalCore/OneSignalCore.h>
 
-@interface OSInAppMessageDisplayStats : NSObject <NSCoding, OSJSONDecodable, OSJSONEncodable>
+@interface OSInAppMessageDisplayStats : NSObject <NSCoding, NSCopying, OSJSONDecodable, OSJSONEncodable>
 
 //Last IAM display time in seconds
 @property (nonatomic, readwrite) double lastDisplayTime;
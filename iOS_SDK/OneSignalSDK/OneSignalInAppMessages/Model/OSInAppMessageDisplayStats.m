@@ -111,7 +111,7 @@
 
 - (BOOL)shouldDisplayAgain {
     BOOL result = _displayQuantity < _displayLimit;
-    [OneSignalLog onesignalLog:ONE_S_LL_VERBOSE message:[NSString stringWithFormat:@"In app message shouldDisplayAgain: %hhu", result]];
+    ONE_S_LOG(ONE_S_LL_VERBOSE, @"In app message shouldDisplayAgain: %hhu", result);
     return result;
 }
 
@@ -127,6 +127,16 @@
     return [NSString stringWithFormat:@"OSInAppMessageDisplayStats:  redisplayEnabled: %@ \nlastDisplayTime: %f  \ndisplayDelay: %f \ndisplayQuantity: %ld \ndisplayLimit: %ld", self.redisplayEnabled ? @"YES" : @"NO", self.lastDisplayTime, self.displayDelay, (long)self.displayQuantity, (long)self.displayLimit];
 }
 
+- (id)copyWithZone:(NSZone *)zone {
+    OSInAppMessageDisplayStats *copy = [[OSInAppMessageDisplayStats allocWithZone:zone] init];
+    copy.displayLimit = _displayLimit;
+    copy.displayQuantity = _displayQuantity;
+    copy.displayDelay = _displayDelay;
+    copy.lastDisplayTime = _lastDisplayTime;
+    copy.redisplayEnabled = _redisplayEnabled;
+    return copy;
+}
+
 - (void)encodeWithCoder:(NSCoder *)encoder {
     [encoder encodeInteger:_displayLimit forKey:@"displayLimit"];
     [encoder encodeInteger:_displayQuantity forKey:@"displayQuantity"];
@@ -48,6 +48,8 @@ NS_ASSUME_NONNULL_BEGIN
 @property (nonatomic) NSNumber *height;
 @property (nonatomic, nullable) NSDate *endTime;
 @property (nonatomic) BOOL hasLiquid;
+// The language code and variant id variantId last resolved, as empty strings when nil. Cleared when the variants change.
+@property (atomic, copy, nullable) NSArray<NSString *> *resolvedVariant;
 
 - (BOOL)isBanner;
 - (BOOL)takeActionAsUnique;
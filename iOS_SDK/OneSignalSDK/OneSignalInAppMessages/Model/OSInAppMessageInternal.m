@@ -84,6 +84,12 @@
     return _clickedClickIds;
 }
 
+// The variant resolved for the previous variants no longer applies
+- (void)setVariants:(NSDictionary<NSString *, NSDictionary<NSString *, NSString *> *> *)variants {
+    _variants = variants ?: @{};
+    self.resolvedVariant = nil;
+}
+
 + (instancetype)instanceWithData:(NSData *)data {
     NSError *error;
     NSDictionary *json = [NSJSONSerialization JSONObjectWithData:data options:0 error:&error];
@@ -115,7 +121,8 @@
     else
         message.displayStats = [[OSInAppMessageDisplayStats alloc] init];
     
-    if (json[@"end_time"] && [json[@"end_time"] isKindOfClass:[NSString class]]) {
+    // Dates are short, anything longer is not worth handing to the formatter
+    if ([json[@"end_time"] isKindOfClass:[NSString class]] && [json[@"end_time"] length] <= OS_IAM_MAX_END_TIME_LENGTH) {
         NSString *stringEndTime = json[@"end_time"];
         NSDateFormatter *dateFormatter = [NSDateFormatter iso8601DateFormatter];
         NSDate *endTime = [dateFormatter dateFromString:stringEndTime];
@@ -132,17 +139,25 @@
 
     if (json[@"triggers"] && [json[@"triggers"] isKindOfClass:[NSArray class]]) {
         let triggers = [NSMutableArray new];
+        NSUInteger triggerCount = 0;
         
         for (NSArray *list in (NSArray *)json[@"triggers"]) {
+            if (![list isKindOfClass:[NSArray class]] || (triggerCount += list.count) > OS_IAM_MAX_TRIGGERS_PER_MESSAGE) {
+                [OneSignalLog onesignalLog:ONE_S_LL_WARN message:[NSString stringWithFormat:@"Triggers of in-app message %@ are invalid or exceed %d", message.messageId, OS_IAM_MAX_TRIGGERS_PER_MESSAGE]];
+                return nil;
+            }
             let subTriggers = [NSMutableArray new];
             
             for (NSDictionary *triggerJson in list) {
-                let trigger = [OSTrigger instanceWithJson:triggerJson];
+                let trigger = [triggerJson isKindOfClass:[NSDictionary class]] ? [OSTrigger instanceWithJson:triggerJson] : nil;
                 
                 if (trigger)
                     [subTriggers addObject:trigger];
                 else {
-                    [OneSignalLog onesignalLog:ONE_S_LL_WARN message:[NSString stringWithFormat:@"Trigger JSON is invalid: %@", triggerJson]];
+                    // Formatted only if logged, a malformed trigger can be arbitrarily large
+                    [OneSignalLog onesignalLog:ONE_S_LL_WARN messageBlock:^NSString *{
+                        return [NSString stringWithFormat:@"Trigger JSON is invalid: %@", triggerJson];
+                    }];
                     return nil;
                 }
             }
@@ -225,7 +240,7 @@
 
 - (void)encodeWithCoder:(NSCoder *)encoder {
     [encoder encodeObject:self.messageId forKey:@"messageId"];
-    [encoder encodeObject:_variants forKey:@"variants"];
+    [encoder encodeObject:self.variants forKey:@"variants"];
     [encoder encodeObject:_triggers forKey:@"triggers"];
     [encoder encodeObject:_displayStats forKey:@"displayStats"];
     //TODO: This will need to be changed when we add core data or database to iOS, see android implementation for reference
@@ -237,7 +252,7 @@
 - (id)initWithCoder:(NSCoder *)decoder {
     if (self = [super init]) {
         self.messageId = [decoder decodeObjectForKey:@"messageId"];
-        _variants = [decoder decodeObjectForKey:@"variants"];
+        self.variants = [decoder decodeObjectForKey:@"variants"];
         _triggers = [decoder decodeObjectForKey:@"triggers"];
         _displayStats = [decoder decodeObjectForKey:@"displayStats"];
         //TODO: This will need to be changed when we add core data or database to iOS, see android implementation for reference
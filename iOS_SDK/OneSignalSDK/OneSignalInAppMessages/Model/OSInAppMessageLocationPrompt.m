@@ -29,6 +29,7 @@
 #import "OSInAppMessageLocationPrompt.h"
 #import <OneSignalLocation/OneSignalLocationManager.h>
 #import <OneSignalCore/OneSignalLog.h>
+#import <OneSignalCore/OSModuleRegistry.h>
 
 //@interface OneSignalLocation ()
 //
@@ -52,7 +53,7 @@
      This code calls [OneSignalLocation promptLocationFallbackToSettings:true completionHandler:completionHandler];
      */
     BOOL fallback = YES;
-    let oneSignalLocationManager = NSClassFromString(ONE_SIGNAL_LOCATION_CLASS_NAME);
+    let oneSignalLocationManager = [OSModuleRegistry classForModule:OSModuleLocation];
     if (oneSignalLocationManager != nil && [oneSignalLocationManager respondsToSelector:@selector(promptLocationFallbackToSettings:completionHandler:)]) {
         NSMethodSignature* signature = [oneSignalLocationManager methodSignatureForSelector:@selector(promptLocationFallbackToSettings:completionHandler:)];
         NSInvocation* invocation = [NSInvocation invocationWithMethodSignature: signature];
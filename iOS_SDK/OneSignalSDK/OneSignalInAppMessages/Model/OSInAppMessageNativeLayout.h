@@ -0,0 +1,70 @@
+/**
+* Modified MIT License
+*
+* Copyright 2024 OneSignal
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* 1. The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* 2. All copies of substantial portions of the Software may only be used in connection
+* with services provided by OneSignal.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+
+
+#import <Foundation/Foundation.h>
+#import <UIKit/UIKit.h>
+#import "OSInAppMessagingDefines.h"
+#import "OSInAppMessageClickResult.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+@interface OSInAppMessageNativeLayoutButton : NSObject
+@property (strong, nonatomic, nonnull) NSString *text;
+@property (strong, nonatomic, nonnull) UIColor *textColor;
+@property (strong, nonatomic, nonnull) UIColor *backgroundColor;
+@property (strong, nonatomic, nonnull) OSInAppMessageClickResult *action;
+@end
+
+/**
+ The compact layout simple messages are sent with, under OS_IAM_NATIVE_LAYOUT_KEY in their content next to the HTML.
+ Only an image, a title, a body and up to OS_IAM_NATIVE_LAYOUT_MAX_BUTTONS buttons are supported, rendered with UIKit
+ by OSInAppMessageNativeView instead of a web view. Anything else, such as unknown keys or actions replacing the content,
+ makes instanceWithJson: return nil so the message is rendered from its HTML instead.
+ */
+@interface OSInAppMessageNativeLayout : NSObject
+
+@property (nonatomic) OSInAppMessageDisplayPosition displayLocation;
+@property (nonatomic) BOOL dragToDismissDisabled;
+@property (strong, nonatomic, nonnull) UIColor *backgroundColor;
+@property (strong, nonatomic, nonnull) UIColor *textColor;
+@property (strong, nonatomic, nullable) NSURL *imageUrl;
+// Width over height, the image view keeps it as the width changes
+@property (nonatomic) CGFloat imageAspectRatio;
+// Clicking the image, as a full screen image message has no buttons
+@property (strong, nonatomic, nullable) OSInAppMessageClickResult *imageAction;
+@property (strong, nonatomic, nullable) NSString *title;
+@property (strong, nonatomic, nullable) NSString *body;
+@property (strong, nonatomic, nonnull) NSArray<OSInAppMessageNativeLayoutButton *> *buttons;
+// The single page of the message, sent as a page impression once it displays
+@property (strong, nonatomic, nullable) NSString *pageId;
+
++ (instancetype _Nullable)instanceWithJson:(NSDictionary *)json;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,145 @@
+/**
+* Modified MIT License
+*
+* Copyright 2024 OneSignal
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* 1. The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* 2. All copies of substantial portions of the Software may only be used in connection
+* with services provided by OneSignal.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+* THE SOFTWARE.
+*/
+
+
+#import "OSInAppMessageNativeLayout.h"
+
+#define OS_NATIVE_LAYOUT_KEYS @[@"display_location", @"drag_to_dismiss_disabled", @"background_color", @"text_color", @"image", @"title", @"body", @"buttons", @"page_id"]
+#define OS_NATIVE_LAYOUT_IMAGE_KEYS @[@"url", @"aspect_ratio", @"action"]
+#define OS_NATIVE_LAYOUT_BUTTON_KEYS @[@"text", @"text_color", @"background_color", @"action"]
+
+// "#RRGGBB" or "#RRGGBBAA"
+static UIColor *OSColorFromHexString(id string, UIColor *defaultColor) {
+    if (!string)
+        return defaultColor;
+    if (![string isKindOfClass:[NSString class]] || ![string hasPrefix:@"#"])
+        return nil;
+    NSString *hex = [string substringFromIndex:1];
+    unsigned int value = 0;
+    if ((hex.length != 6 && hex.length != 8) || ![[NSScanner scannerWithString:hex] scanHexInt:&value])
+        return nil;
+    if (hex.length == 6)
+        value = (value << 8) | 0xFF;
+    return [UIColor colorWithRed:((value >> 24) & 0xFF) / 255.0
+                           green:((value >> 16) & 0xFF) / 255.0
+                            blue:((value >> 8) & 0xFF) / 255.0
+                           alpha:(value & 0xFF) / 255.0];
+}
+
+static BOOL OSHasOnlyKeys(NSDictionary *json, NSArray<NSString *> *keys) {
+    for (id key in json) {
+        if (![keys containsObject:key])
+            return NO;
+    }
+    return YES;
+}
+
+// Actions replacing the content need the web view to load the new page into
+static OSInAppMessageClickResult *OSNativeActionFromJson(id json, NSString *clickType) {
+    if (![json isKindOfClass:[NSDictionary class]])
+        return nil;
+    OSInAppMessageClickResult *action = [OSInAppMessageClickResult instanceWithJson:json];
+    if (action.urlTarget == OSInAppMessageActionUrlTypeReplaceContent)
+        return nil;
+    if (!action.clickType)
+        action.clickType = clickType;
+    return action;
+}
+
+@implementation OSInAppMessageNativeLayoutButton
+@end
+
+@implementation OSInAppMessageNativeLayout
+
++ (instancetype _Nullable)instanceWithJson:(NSDictionary *)json {
+    if (![json isKindOfClass:[NSDictionary class]] || !OSHasOnlyKeys(json, OS_NATIVE_LAYOUT_KEYS))
+        return nil;
+
+    OSInAppMessageNativeLayout *layout = [OSInAppMessageNativeLayout new];
+
+    let displayLocation = json[@"display_location"];
+    if (![displayLocation isKindOfClass:[NSString class]] || ![OS_IN_APP_DISPLAY_POSITION_STRING containsObject:displayLocation])
+        return nil;
+    layout.displayLocation = OS_IN_APP_DISPLAY_POSITION_FROM_STRING(displayLocation);
+    layout.dragToDismissDisabled = [json[@"drag_to_dismiss_disabled"] isKindOfClass:[NSNumber class]] && [json[@"drag_to_dismiss_disabled"] boolValue];
+
+    layout.backgroundColor = OSColorFromHexString(json[@"background_color"], UIColor.whiteColor);
+    layout.textColor = OSColorFromHexString(json[@"text_color"], UIColor.blackColor);
+    if (!layout.backgroundColor || !layout.textColor)
+        return nil;
+
+    if (json[@"image"]) {
+        NSDictionary *image = json[@"image"];
+        if (![image isKindOfClass:[NSDictionary class]] || !OSHasOnlyKeys(image, OS_NATIVE_LAYOUT_IMAGE_KEYS))
+            return nil;
+        layout.imageUrl = [image[@"url"] isKindOfClass:[NSString class]] ? [NSURL URLWithString:image[@"url"]] : nil;
+        layout.imageAspectRatio = [image[@"aspect_ratio"] isKindOfClass:[NSNumber class]] ? [image[@"aspect_ratio"] doubleValue] : 0;
+        if (!layout.imageUrl || layout.imageAspectRatio <= 0)
+            return nil;
+        if (image[@"action"]) {
+            layout.imageAction = OSNativeActionFromJson(image[@"action"], @"image");
+            if (!layout.imageAction)
+                return nil;
+        }
+    }
+
+    for (NSString *key in @[@"title", @"body", @"page_id"]) {
+        if (json[key] && ![json[key] isKindOfClass:[NSString class]])
+            return nil;
+    }
+    layout.title = json[@"title"];
+    layout.body = json[@"body"];
+    layout.pageId = json[@"page_id"];
+
+    let buttonsJson = json[@"buttons"] ?: @[];
+    if (![buttonsJson isKindOfClass:[NSArray class]] || [buttonsJson count] > OS_IAM_NATIVE_LAYOUT_MAX_BUTTONS)
+        return nil;
+    NSMutableArray<OSInAppMessageNativeLayoutButton *> *buttons = [NSMutableArray new];
+    for (NSDictionary *buttonJson in buttonsJson) {
+        if (![buttonJson isKindOfClass:[NSDictionary class]] || !OSHasOnlyKeys(buttonJson, OS_NATIVE_LAYOUT_BUTTON_KEYS) || ![buttonJson[@"text"] isKindOfClass:[NSString class]])
+            return nil;
+        OSInAppMessageNativeLayoutButton *button = [OSInAppMessageNativeLayoutButton new];
+        button.text = buttonJson[@"text"];
+        button.textColor = OSColorFromHexString(buttonJson[@"text_color"], UIColor.whiteColor);
+        button.backgroundColor = OSColorFromHexString(buttonJson[@"background_color"], UIColor.systemBlueColor);
+        button.action = OSNativeActionFromJson(buttonJson[@"action"], @"button");
+        if (!button.textColor || !button.backgroundColor || !button.action)
+            return nil;
+        [buttons addObject:button];
+    }
+    layout.buttons = buttons;
+
+    // A message with nothing to show or no way to act on it is not a simple message
+    if (!layout.imageUrl && !layout.title && !layout.body)
+        return nil;
+    if (buttons.count == 0 && !layout.imageAction)
+        return nil;
+
+    return layout;
+}
+
+@end
@@ -39,6 +39,12 @@ NS_ASSUME_NONNULL_BEGIN
 @property (nonatomic) OSTriggerOperatorType operatorType;
 @property (strong, nonatomic, nullable) id value;
 
+// Derived from kind and value when they are set, so evaluation doesn't redo the type checks
+@property (nonatomic, readonly) OSTriggerKindType kindType;
+@property (nonatomic, readonly) BOOL isDynamic;
+@property (nonatomic, readonly) OSTriggerValueType valueType;
+@property (strong, nonatomic, readonly, nullable) NSString *flexValue;
+
 @end
 
 NS_ASSUME_NONNULL_END
@@ -29,6 +29,33 @@
 
 @implementation OSTrigger
 
+- (void)setKind:(NSString *)kind {
+    _kind = kind;
+    if ([kind isEqualToString:OS_DYNAMIC_TRIGGER_KIND_CUSTOM])
+        _kindType = OSTriggerKindTypeCustom;
+    else if ([kind isEqualToString:OS_DYNAMIC_TRIGGER_KIND_SESSION_TIME])
+        _kindType = OSTriggerKindTypeSessionTime;
+    else if ([kind isEqualToString:OS_DYNAMIC_TRIGGER_KIND_MIN_TIME_SINCE])
+        _kindType = OSTriggerKindTypeMinTimeSince;
+    else
+        _kindType = OSTriggerKindTypeUnknown;
+    _isDynamic = _kindType == OSTriggerKindTypeSessionTime || _kindType == OSTriggerKindTypeMinTimeSince;
+}
+
+- (void)setValue:(id)value {
+    _value = value;
+    if (!value)
+        _valueType = OSTriggerValueTypeNone;
+    else if ([value isKindOfClass:[NSNumber class]])
+        _valueType = OSTriggerValueTypeNumber;
+    else if ([value isKindOfClass:[NSString class]])
+        _valueType = OSTriggerValueTypeString;
+    else
+        _valueType = OSTriggerValueTypeOther;
+    // Used for equality comparisons across value types
+    _flexValue = [value description];
+}
+
 + (instancetype)instanceWithData:(NSData *)data {
     NSError *error;
     let json = (NSDictionary *)[NSJSONSerialization JSONObjectWithData:data options:NSJSONReadingAllowFragments error:&error];
@@ -111,10 +138,10 @@
 - (id)initWithCoder:(NSCoder *)decoder {
     if (self = [super init]) {
         _triggerId = [decoder decodeObjectForKey:@"triggerId"];
-        _kind = [decoder decodeObjectForKey:@"kind"];
+        self.kind = [decoder decodeObjectForKey:@"kind"];
         _property = [decoder decodeObjectForKey:@"property"];
         _operatorType = (OSTriggerOperatorType)[decoder decodeIntForKey:@"operatorType"];
-        _value = [decoder decodeObjectForKey:@"value"];
+        self.value = [decoder decodeObjectForKey:@"value"];
     }
     return self;
 }
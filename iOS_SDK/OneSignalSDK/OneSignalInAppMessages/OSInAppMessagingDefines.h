@@ -64,6 +64,13 @@ typedef NS_ENUM(NSUInteger, OSTriggerOperatorType) {
 // The higher this value is, the farther away from the edges of the screen the in-app messages will be
 #define MESSAGE_MARGIN 8.0f
 
+// Number of idle web views kept ready for displaying in-app messages
+#define OS_IAM_WEBVIEW_POOL_SIZE 2
+
+// Key of the compact layout simple messages are sent with alongside their HTML, see OSInAppMessageNativeLayout
+#define OS_IAM_NATIVE_LAYOUT_KEY @"native_layout"
+#define OS_IAM_NATIVE_LAYOUT_MAX_BUTTONS 2
+
 // Defines the slowest and fastest allowable dismissal speed for in-app messages
 #define MIN_DISMISSAL_ANIMATION_DURATION 0.1f
 #define MAX_DISMISSAL_ANIMATION_DURATION 0.3f
@@ -73,8 +80,39 @@ typedef NS_ENUM(NSUInteger, OSTriggerOperatorType) {
 #define OS_IAM_CLICKED_SET_KEY @"OS_IAM_CLICKED_SET"
 #define OS_IAM_IMPRESSIONED_SET_KEY @"OS_IAM_IMPRESSIONED_SET"
 #define OS_IAM_PAGE_IMPRESSIONED_SET_KEY @"OS_IAM_PAGE_IMPRESSIONED_SET"
+// Whole messages archived for redisplay by earlier versions, still read for one release alongside OS_IAM_REDISPLAY_STATS_KEY
 #define OS_IAM_REDISPLAY_DICTIONARY @"OS_IAM_REDISPLAY_DICTIONARY"
+#define OS_IAM_REDISPLAY_STATS_KEY @"OS_IAM_REDISPLAY_STATS"
 #define OS_IAM_TIME_SINCE_LAST_MESSAGE_KEY @"OS_IAM_TIME_SINCE_LAST_MESSAGE"
+#define OS_IAM_MESSAGES_CACHE_KEY @"OS_IAM_MESSAGES_CACHE"
+// The cached message list itself lives in this file in Caches so it can be memory-mapped instead of loaded with the user defaults
+#define OS_IAM_MESSAGES_CACHE_FILE @"OneSignalInAppMessages.json"
+// Message without triggers chosen when the app backgrounded, presented on the next open before the fetch completes
+#define OS_IAM_APP_OPEN_MESSAGE_KEY @"OS_IAM_APP_OPEN_MESSAGE"
+#define OS_IAM_STATE_KEY @"OS_IAM_STATE"
+#define OS_IAM_STATE_VERSION 1
+// Seconds to coalesce IAM state changes before writing them
+#define OS_IAM_STATE_FLUSH_DELAY 2.0
+
+// Impressions, page impressions and clicks waiting to be sent
+#define OS_IAM_TELEMETRY_BUFFER_KEY @"OS_IAM_TELEMETRY_BUFFER"
+// Seconds to collect IAM telemetry before uploading it together
+#define OS_IAM_TELEMETRY_BATCH_WINDOW 5.0
+// Oldest events are dropped past this many, e.g. while offline for a long time
+#define OS_IAM_TELEMETRY_BUFFER_LIMIT 200
+
+// On disk cache of in-app message HTML content, evicted oldest first past the size limit
+#define OS_IAM_CONTENT_CACHE_DIRECTORY @"OneSignalInAppMessages"
+#define OS_IAM_CONTENT_CACHE_MAX_BYTES (5 * 1024 * 1024)
+// Content saved longer ago than this is fetched again, in case the message was edited since
+#define OS_IAM_CONTENT_CACHE_MAX_AGE_SECONDS (24 * 60 * 60)
+// Maximum number of messages to prefetch content for after fetching messages, tunable up to the max limit
+#define OS_IAM_CONTENT_PREFETCH_LIMIT 5
+#define OS_IAM_CONTENT_PREFETCH_MAX_LIMIT 20
+#define OS_TUNING_IAM_PREFETCH_LIMIT @"iam_prefetch_limit"
+
+// Fetched messages are parsed in pages of this many, the first page is evaluated before the rest of the list is parsed
+#define OS_IAM_PARSE_PAGE_SIZE 20
 
 // Dynamic trigger kind types
 #define OS_DYNAMIC_TRIGGER_KIND_CUSTOM @"custom"
@@ -83,6 +121,29 @@ typedef NS_ENUM(NSUInteger, OSTriggerOperatorType) {
 #define OS_DYNAMIC_TRIGGER_KIND_STRINGS @[OS_DYNAMIC_TRIGGER_KIND_SESSION_TIME, OS_DYNAMIC_TRIGGER_KIND_MIN_TIME_SINCE]
 // Verify that a string is a valid dynamic trigger
 #define OS_IS_DYNAMIC_TRIGGER_KIND(kind) [OS_DYNAMIC_TRIGGER_KIND_STRINGS containsObject:kind]
+// Deadlines of time-based triggers landing within this window fire together
+#define OS_DYNAMIC_TRIGGER_BATCH_WINDOW 0.1
+
+// Catalogs at least this large have their triggers matched in parallel when evaluated
+#define OS_IAM_PARALLEL_EVALUATION_MIN_MESSAGES 64
+
+// Messages with more triggers than this are rejected when parsed, they would slow down every evaluation
+#define OS_IAM_MAX_TRIGGERS_PER_MESSAGE 1000
+#define OS_IAM_MAX_END_TIME_LENGTH 64
+
+// Trigger kind and value types resolved once when an OSTrigger is parsed
+typedef NS_ENUM(NSUInteger, OSTriggerKindType) {
+    OSTriggerKindTypeUnknown,
+    OSTriggerKindTypeCustom,
+    OSTriggerKindTypeSessionTime,
+    OSTriggerKindTypeMinTimeSince
+};
+typedef NS_ENUM(NSUInteger, OSTriggerValueType) {
+    OSTriggerValueTypeNone,
+    OSTriggerValueTypeNumber,
+    OSTriggerValueTypeString,
+    OSTriggerValueTypeOther
+};
 
 // Trigger property types
 #define OS_TRIGGER_PROPERTY_SESSION_TIME @"playtime"
@@ -101,6 +162,7 @@ typedef NS_ENUM(NSUInteger, OSTriggerOperatorType) {
 // JavaScript method names
 #define OS_JS_GET_PAGE_META_DATA_METHOD @"getPageMetaData()"
 #define OS_SET_SAFE_AREA_INSETS_METHOD @"setSafeAreaInsets(%@)"
+#define OS_SET_PLAYER_TAGS_METHOD @"setPlayerTags(%@)"
 
 #define PREFERRED_VARIANT_ORDER @[@"ios", @"app", @"all"]
 
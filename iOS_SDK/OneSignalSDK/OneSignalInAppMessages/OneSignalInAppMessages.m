@@ -28,9 +28,14 @@
 #import "OneSignalInAppMessages.h"
 #import "OSMessagingController.h"
 #import "OSInAppMessageMigrationController.h"
+#import <OneSignalCore/OSModuleRegistry.h>
 
 @implementation OneSignalInAppMessages
 
++ (void)load {
+    [OSModuleRegistry registerModule:OSModuleInAppMessages moduleClass:self];
+}
+
 + (Class<OSInAppMessages>)InAppMessages {
     return self;
 }
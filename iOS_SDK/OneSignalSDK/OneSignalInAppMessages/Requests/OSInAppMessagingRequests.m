@@ -32,6 +32,7 @@
                             withSessionDuration:(NSNumber * _Nonnull)sessionDuration
                             withRetryCount:(NSNumber *)retryCount
                             withRywToken:(NSString *)rywToken
+                            withETag:(NSString *)etag
 {
     let request = [OSRequestGetInAppMessages new];
     request.method = GET;
@@ -46,11 +47,15 @@
     if ([retryCount intValue] > 0) {
         headers[@"OneSignal-Retry-Count"] = [retryCount stringValue];
     }
+    // Lets the backend answer 304 Not Modified when the cached list is still current
+    headers[@"If-None-Match"] = etag;
 
     request.additionalHeaders = headers;
 
     NSString *appId = [OneSignalConfigManager getAppId];
     request.path = [NSString stringWithFormat:@"apps/%@/subscriptions/%@/iams", appId, subscriptionId];
+    // Overlapping fetches for the same subscription and read-your-write token can share one response
+    request.idempotencyKey = [NSString stringWithFormat:@"%@|%@", request.path, rywToken ?: @""];
     return request;
 }
 @end
@@ -70,6 +75,7 @@
 
     request.parameters = params;
     request.method = POST;
+    request.priority = OSRequestPriorityLow;
     request.path = [NSString stringWithFormat:@"in_app_messages/%@/impression", messageId];
 
     return request;
@@ -93,6 +99,7 @@
 
     request.parameters = params;
     request.method = POST;
+    request.priority = OSRequestPriorityLow;
     request.path = [NSString stringWithFormat:@"in_app_messages/%@/pageImpression", messageId];
 
     return request;
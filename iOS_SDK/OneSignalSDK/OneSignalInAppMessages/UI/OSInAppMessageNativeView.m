@@ -0,0 +1,164 @@
+/**
+ * Modified MIT License
+ *
+ * Copyright 2024 OneSignal
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * 2. All copies of substantial portions of the Software may only be used in connection
+ * with services provided by OneSignal.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#import "OSInAppMessageNativeView.h"
+#import <OneSignalCore/OneSignalCore.h>
+
+#define OS_NATIVE_VIEW_MARGIN 16.0f
+#define OS_NATIVE_VIEW_SPACING 12.0f
+#define OS_NATIVE_VIEW_BUTTON_HEIGHT 44.0f
+
+@interface OSInAppMessageNativeView ()
+
+@property (strong, nonatomic, nonnull) OSInAppMessageNativeLayout *layout;
+
+@end
+
+@implementation OSInAppMessageNativeView
+
+- (instancetype _Nonnull)initWithLayout:(OSInAppMessageNativeLayout *)layout {
+    if (self = [super init]) {
+        self.layout = layout;
+        self.translatesAutoresizingMaskIntoConstraints = false;
+        self.backgroundColor = layout.backgroundColor;
+        self.layer.cornerRadius = 10.0f;
+        self.layer.masksToBounds = true;
+    }
+    return self;
+}
+
+- (void)loadWithCompletion:(void (^)(BOOL loaded))completion {
+    if (!self.layout.imageUrl) {
+        [self buildViewsWithImage:nil];
+        completion(true);
+        return;
+    }
+    let task = [NSURLSession.sharedSession dataTaskWithURL:self.layout.imageUrl completionHandler:^(NSData *data, NSURLResponse *response, NSError *error) {
+        // Still off the main thread, decoded here so the first frame does not decode it
+        UIImage *image = data ? [self decodedImageWithData:data] : nil;
+        [OneSignalCoreHelper dispatch_async_on_main_queue:^{
+            if (!image) {
+                ONE_S_LOG(ONE_S_LL_VERBOSE, @"Native in-app message image failed to load: %@", error.localizedDescription);
+                completion(false);
+                return;
+            }
+            [self buildViewsWithImage:image];
+            completion(true);
+        }];
+    }];
+    [task resume];
+}
+
+- (UIImage *)decodedImageWithData:(NSData *)data {
+    UIImage *image = [UIImage imageWithData:data];
+    if (!image)
+        return nil;
+    if (@available(iOS 15, *))
+        return [image imageByPreparingForDisplay] ?: image;
+    let format = [UIGraphicsImageRendererFormat preferredFormat];
+    format.scale = image.scale;
+    let renderer = [[UIGraphicsImageRenderer alloc] initWithSize:image.size format:format];
+    return [renderer imageWithActions:^(UIGraphicsImageRendererContext *context) {
+        [image drawAtPoint:CGPointZero];
+    }];
+}
+
+- (void)buildViewsWithImage:(UIImage * _Nullable)image {
+    let stack = [UIStackView new];
+    stack.axis = UILayoutConstraintAxisVertical;
+    stack.translatesAutoresizingMaskIntoConstraints = false;
+    [self addSubview:stack];
+    [stack.leadingAnchor constraintEqualToAnchor:self.leadingAnchor].active = true;
+    [stack.trailingAnchor constraintEqualToAnchor:self.trailingAnchor].active = true;
+    [stack.topAnchor constraintEqualToAnchor:self.topAnchor].active = true;
+    [stack.bottomAnchor constraintEqualToAnchor:self.bottomAnchor].active = true;
+
+    if (image) {
+        let imageView = [[UIImageView alloc] initWithImage:image];
+        imageView.contentMode = UIViewContentModeScaleAspectFill;
+        imageView.clipsToBounds = true;
+        [imageView.heightAnchor constraintEqualToAnchor:imageView.widthAnchor multiplier:1.0 / self.layout.imageAspectRatio].active = true;
+        if (self.layout.imageAction) {
+            imageView.userInteractionEnabled = true;
+            [imageView addGestureRecognizer:[[UITapGestureRecognizer alloc] initWithTarget:self action:@selector(imageTapped)]];
+        }
+        [stack addArrangedSubview:imageView];
+    }
+
+    let content = [UIStackView new];
+    content.axis = UILayoutConstraintAxisVertical;
+    content.spacing = OS_NATIVE_VIEW_SPACING;
+    content.layoutMargins = UIEdgeInsetsMake(OS_NATIVE_VIEW_MARGIN, OS_NATIVE_VIEW_MARGIN, OS_NATIVE_VIEW_MARGIN, OS_NATIVE_VIEW_MARGIN);
+    content.layoutMarginsRelativeArrangement = true;
+    if (self.layout.title)
+        [content addArrangedSubview:[self labelWithText:self.layout.title font:[UIFont boldSystemFontOfSize:20.0f]]];
+    if (self.layout.body)
+        [content addArrangedSubview:[self labelWithText:self.layout.body font:[UIFont systemFontOfSize:17.0f]]];
+    for (NSUInteger i = 0; i < self.layout.buttons.count; i++) {
+        let button = self.layout.buttons[i];
+        let buttonView = [UIButton buttonWithType:UIButtonTypeSystem];
+        buttonView.tag = i;
+        buttonView.backgroundColor = button.backgroundColor;
+        buttonView.layer.cornerRadius = 8.0f;
+        buttonView.titleLabel.font = [UIFont boldSystemFontOfSize:17.0f];
+        [buttonView setTitle:button.text forState:UIControlStateNormal];
+        [buttonView setTitleColor:button.textColor forState:UIControlStateNormal];
+        [buttonView.heightAnchor constraintEqualToConstant:OS_NATIVE_VIEW_BUTTON_HEIGHT].active = true;
+        [buttonView addTarget:self action:@selector(buttonTapped:) forControlEvents:UIControlEventTouchUpInside];
+        [content addArrangedSubview:buttonView];
+    }
+    if (content.arrangedSubviews.count > 0)
+        [stack addArrangedSubview:content];
+}
+
+- (UILabel *)labelWithText:(NSString *)text font:(UIFont *)font {
+    let label = [UILabel new];
+    label.text = text;
+    label.font = font;
+    label.textColor = self.layout.textColor;
+    label.textAlignment = NSTextAlignmentCenter;
+    label.numberOfLines = 0;
+    return label;
+}
+
+- (NSNumber *)heightForWidth:(CGFloat)width {
+    CGSize size = [self systemLayoutSizeFittingSize:CGSizeMake(width, UILayoutFittingCompressedSize.height)
+                      withHorizontalFittingPriority:UILayoutPriorityRequired
+                            verticalFittingPriority:UILayoutPriorityFittingSizeLevel];
+    return @(ceil(size.height));
+}
+
+- (void)buttonTapped:(UIButton *)sender {
+    [self.delegate nativeViewDidSelectAction:self.layout.buttons[sender.tag].action];
+}
+
+- (void)imageTapped {
+    [self.delegate nativeViewDidSelectAction:self.layout.imageAction];
+}
+
+@end
@@ -27,6 +27,7 @@
 
 #import <UIKit/UIKit.h>
 #import "OSInAppMessageInternal.h"
+#import "OSInAppMessageNativeView.h"
 #import <WebKit/WebKit.h>
 
 NS_ASSUME_NONNULL_BEGIN
@@ -44,10 +45,14 @@ NS_ASSUME_NONNULL_BEGIN
 
 - (instancetype _Nonnull)initWithMessage:(OSInAppMessageInternal *)inAppMessage withScriptMessageHandler:(id<WKScriptMessageHandler>)messageHandler;
 - (void)resetWebViewToMaxBoundsAndResizeHeight:(void (^) (NSNumber *newHeight)) completion;
+// Same as resetWebViewToMaxBoundsAndResizeHeight: for a height that is already known, without measuring it in JS
+- (void)resetWebViewToMaxBounds;
 - (void)updateSafeAreaInsets;
 - (void)setupWebViewConstraints;
 - (void)loadReplacementURL:(NSURL *)url;
 - (void)loadedHtmlContent:(NSString *)html withBaseURL:(NSURL *)url;
+// Renders the message with UIKit instead of a web view, completes with its height or nil if it failed to load
+- (void)loadNativeLayout:(OSInAppMessageNativeLayout *)layout delegate:(id<OSInAppMessageNativeViewDelegate>)delegate completion:(void (^)(NSNumber * _Nullable height))completion;
 - (void)removeScriptMessageHandler;
 - (void)setIsFullscreen:(BOOL)isFullscreen;
 @end
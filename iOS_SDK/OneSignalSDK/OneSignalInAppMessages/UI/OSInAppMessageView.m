@@ -28,14 +28,24 @@
 #import "OSInAppMessageView.h"
 #import <WebKit/WebKit.h>
 #import "OSInAppMessageClickResult.h"
+#import "OSInAppMessageWebViewPool.h"
 #import <OneSignalUser/OneSignalUser.h>
 
 @interface OSInAppMessageView () <UIScrollViewDelegate, WKUIDelegate, WKNavigationDelegate>
 
 @property (strong, nonatomic, nonnull) OSInAppMessageInternal *message;
-@property (strong, nonatomic, nonnull) WKWebView *webView;
+// Created on the first HTML load, messages rendered natively never have one
+@property (strong, nonatomic, nullable) WKWebView *webView;
+@property (weak, nonatomic, nullable) id<WKScriptMessageHandler> scriptMessageHandler;
+@property (strong, nonatomic, nullable) OSInAppMessageNativeView *nativeView;
+// Pin the native view to the message view's edges, created once as resizing only changes the message view's size
+@property (strong, nonatomic, nullable) NSArray<NSLayoutConstraint *> *nativeViewConstraints;
 @property (nonatomic) BOOL loaded;
 @property (nonatomic) BOOL isFullscreen;
+// Tags JSON the current HTML was rendered with, used to skip refreshes that change nothing
+@property (strong, nonatomic, nullable) NSString *renderedTagsString;
+// The tags snapshot version renderedTagsString was made from, unchanged tags are not serialized again
+@property (nonatomic) NSInteger renderedTagsVersion;
 @end
 
 
@@ -45,17 +55,20 @@
     if (self = [super init]) {
         self.message = inAppMessage;
         self.translatesAutoresizingMaskIntoConstraints = false;
-        [self setupWebviewWithMessageHandler:messageHandler];
+        self.scriptMessageHandler = messageHandler;
+        if (inAppMessage.hasLiquid) {
+            [[NSNotificationCenter defaultCenter] addObserver:self selector:@selector(tagsDidChange) name:OS_ON_USER_TAGS_DID_CHANGE object:nil];
+        }
     }
     
     return self;
 }
 
-- (NSString *)getTagsString {
+- (NSString *)tagsStringFromSnapshot:(OSTagsSnapshot *)snapshot {
     NSError *error;
-    NSDictionary<NSString *, NSString*> *tags = [OneSignalUserManagerImpl.sharedInstance getTagsInternal];
+    NSDictionary<NSString *, NSString*> *tags = (NSDictionary<NSString *, NSString*> *)snapshot.tags;
     if (tags == nil || tags.count <= 0 ) {
-        [OneSignalLog onesignalLog:ONE_S_LL_VERBOSE message:@"[getTagsString] no tags found for the player"];
+        [OneSignalLog onesignalLog:ONE_S_LL_VERBOSE message:@"[tagsStringFromSnapshot] no tags found for the player"];
         return nil;
     }
     NSData *jsonData = [NSJSONSerialization dataWithJSONObject:tags
@@ -71,31 +84,81 @@
     return jsonString;
 }
 
-- (NSString *)addTagsToHTML:(NSString *)html {
-    NSString *tags = [self getTagsString];
-    if (!tags) {
-        return html;
-    }
-    //Script to set the tags for liquid tag substitution
-    NSString *newHtml = [NSString stringWithFormat:@"%@ \n\n\
-                         <script> \
-                            setPlayerTags(%@);\
-                         </script>",html, tags];
-    return newHtml;
+/*
+ Tags and safe area insets are passed to the HTML through user scripts run once the document is parsed,
+ so the HTML itself is loaded exactly as it was fetched or cached instead of being copied to append scripts.
+ The web view pool removes the user scripts when the web view is recycled.
+ */
+- (void)addUserScriptWithSource:(NSString *)source {
+    let script = [[WKUserScript alloc] initWithSource:source injectionTime:WKUserScriptInjectionTimeAtDocumentEnd forMainFrameOnly:YES];
+    [self.webView.configuration.userContentController addUserScript:script];
 }
 
 - (void)loadedHtmlContent:(NSString *)html withBaseURL:(NSURL *)url {
     // UI Update must be done on the main thread
-    NSString *taggedHTML = [self addTagsToHTML:html];
-    [OneSignalLog onesignalLog:ONE_S_LL_VERBOSE message:[NSString stringWithFormat:@"loadedHtmlContent with Tags: \n%@", taggedHTML]];
-    [self.webView loadHTMLString:taggedHTML baseURL:url];
-    
+    [self setupWebviewIfNeeded];
+    [self.webView.configuration.userContentController removeAllUserScripts];
+    OSTagsSnapshot *snapshot = [OneSignalUserManagerImpl.sharedInstance getTagsSnapshotInternal];
+    NSString *tags = [self tagsStringFromSnapshot:snapshot];
+    self.renderedTagsString = tags;
+    self.renderedTagsVersion = snapshot.version;
+    if (tags) {
+        //Script to set the tags for liquid tag substitution
+        [self addUserScriptWithSource:[NSString stringWithFormat:OS_SET_PLAYER_TAGS_METHOD, tags]];
+    }
+    if (self.isFullscreen) {
+        NSString *safeAreaInsetsObjectString = [self safeAreaInsetsObjectString];
+        if (safeAreaInsetsObjectString) {
+            [self addUserScriptWithSource:[NSString stringWithFormat:OS_SET_SAFE_AREA_INSETS_METHOD, safeAreaInsetsObjectString]];
+        }
+    }
+    ONE_S_LOG(ONE_S_LL_VERBOSE, @"loadedHtmlContent with Tags: %@", tags);
+    [self.webView loadHTMLString:html baseURL:url];
+}
+
+- (void)tagsDidChange {
+    dispatch_async(dispatch_get_main_queue(), ^{
+        OSTagsSnapshot *snapshot = [OneSignalUserManagerImpl.sharedInstance getTagsSnapshotInternal];
+        if (!self.loaded || !snapshot || snapshot.version == self.renderedTagsVersion) {
+            return;
+        }
+        self.renderedTagsVersion = snapshot.version;
+        NSString *tags = [self tagsStringFromSnapshot:snapshot];
+        if (!tags || [tags isEqualToString:self.renderedTagsString]) {
+            return;
+        }
+        self.renderedTagsString = tags;
+        // Re-run the liquid substitution in place rather than reloading the page
+        NSString *setTagsString = [NSString stringWithFormat:OS_SET_PLAYER_TAGS_METHOD, tags];
+        [self.webView evaluateJavaScript:setTagsString completionHandler:^(id result, NSError * _Nullable error) {
+            if (error) {
+                [OneSignalLog onesignalLog:ONE_S_LL_ERROR message:[NSString stringWithFormat:@"Javascript Method: %@ Evaluated with Error: %@", OS_SET_PLAYER_TAGS_METHOD, error]];
+            }
+        }];
+    });
+}
+
+- (void)loadNativeLayout:(OSInAppMessageNativeLayout *)layout delegate:(id<OSInAppMessageNativeViewDelegate>)delegate completion:(void (^)(NSNumber * _Nullable height))completion {
+    self.nativeView = [[OSInAppMessageNativeView alloc] initWithLayout:layout];
+    self.nativeView.delegate = delegate;
+    [self.nativeView loadWithCompletion:^(BOOL loaded) {
+        if (!loaded) {
+            self.nativeView = nil;
+            completion(nil);
+            return;
+        }
+        [self addSubview:self.nativeView];
+        completion([self.nativeView heightForWidth:[self maxContentWidth]]);
+    }];
+}
+
+- (void)setupWebviewIfNeeded {
+    if (self.webView)
+        return;
+    [self setupWebviewWithMessageHandler:self.scriptMessageHandler];
 }
 
 - (void)setupWebviewWithMessageHandler:(id<WKScriptMessageHandler>)handler {
-    let configuration = [WKWebViewConfiguration new];
-    [configuration.userContentController addScriptMessageHandler:handler name:@"iosListener"];
-    
     CGFloat marginSpacing = [OneSignalCoreHelper sizeToScale:MESSAGE_MARGIN];
     
     // WebView should use mainBounds as frame since we need to make sure it spans full possible screen size
@@ -104,7 +167,8 @@
     mainBounds.size.width -= (2.0 * marginSpacing);
     
     // Setup WebView, delegates, and disable scrolling inside of the WebView
-    self.webView = [[WKWebView alloc] initWithFrame:mainBounds configuration:configuration];
+    self.webView = [OSInAppMessageWebViewPool.sharedPool dequeueWebViewWithFrame:mainBounds];
+    [self.webView.configuration.userContentController addScriptMessageHandler:handler name:@"iosListener"];
     self.webView.backgroundColor = [UIColor clearColor];
     self.webView.opaque = NO;
     // https://webkit.org/blog/13936/enabling-the-inspection-of-web-content-in-apps/
@@ -132,11 +196,17 @@
 
 - (void)setWebviewFrame {
     CGRect mainBounds = UIScreen.mainScreen.bounds;
+    mainBounds.size.width = [self maxContentWidth];
+    [self.webView setFrame:mainBounds];
+}
+
+- (CGFloat)maxContentWidth {
+    CGFloat width = UIScreen.mainScreen.bounds.size.width;
     if (!self.isFullscreen) {
         CGFloat marginSpacing = [OneSignalCoreHelper sizeToScale:MESSAGE_MARGIN];
-        mainBounds.size.width -= (2.0 * marginSpacing);
+        width -= (2.0 * marginSpacing);
     }
-    [self.webView setFrame:mainBounds];
+    return width;
 }
 
 /*
@@ -144,7 +214,19 @@
  WebView will have margins accounted for on width, but height just needs to be phone height or larger
  The issue is that text wrapping can cause incorrect height issues so width is the real concern here
  */
+- (void)resetWebViewToMaxBounds {
+    [self.webView removeConstraints:[self.webView constraints]];
+    [self setWebviewFrame];
+    [self setupWebViewConstraints];
+}
+
 - (void)resetWebViewToMaxBoundsAndResizeHeight:(void (^) (NSNumber *newHeight)) completion {
+    if (self.nativeView) {
+        // Measured by Auto Layout, there is no page to ask
+        [self setupNativeViewConstraints];
+        completion([self.nativeView heightForWidth:[self maxContentWidth]]);
+        return;
+    }
     [self.webView removeConstraints:[self.webView constraints]];
     
    
@@ -169,15 +251,21 @@
     }];
 }
 
-- (void)updateSafeAreaInsets {
+- (NSString *)safeAreaInsetsObjectString {
     if (@available(iOS 11, *)) {
-        UIWindow *keyWindow = UIApplication.sharedApplication.keyWindow;
-        CGFloat top = keyWindow.safeAreaInsets.top;
-        CGFloat bottom = keyWindow.safeAreaInsets.bottom;
-        CGFloat right = keyWindow.safeAreaInsets.right;
-        CGFloat left = keyWindow.safeAreaInsets.left;
-        NSString *safeAreaInsetsObjectString = [NSString stringWithFormat:OS_JS_SAFE_AREA_INSETS_OBJ,top, bottom, right, left];
-        
+        UIWindow *window = self.window ?: UIApplication.sharedApplication.keyWindow;
+        if (!window) {
+            return nil;
+        }
+        UIEdgeInsets insets = window.safeAreaInsets;
+        return [NSString stringWithFormat:OS_JS_SAFE_AREA_INSETS_OBJ, insets.top, insets.bottom, insets.right, insets.left];
+    }
+    return nil;
+}
+
+- (void)updateSafeAreaInsets {
+    NSString *safeAreaInsetsObjectString = [self safeAreaInsetsObjectString];
+    if (safeAreaInsetsObjectString) {
         NSString *setInsetsString = [NSString stringWithFormat:OS_SET_SAFE_AREA_INSETS_METHOD, safeAreaInsetsObjectString];
         [self.webView evaluateJavaScript:setInsetsString completionHandler:^(NSDictionary *result, NSError * _Nullable error) {
             if (error) {
@@ -196,6 +284,10 @@
 }
 
 - (void)setupWebViewConstraints {
+    if (self.nativeView) {
+        [self setupNativeViewConstraints];
+        return;
+    }
     [OneSignalLog onesignalLog:ONE_S_LL_VERBOSE message:@"Setting up In-App Message WebView Constraints"];
     
     [self.webView removeConstraints:[self.webView constraints]];
@@ -220,6 +312,20 @@
     [self layoutIfNeeded];
 }
 
+- (void)setupNativeViewConstraints {
+    if (!self.nativeViewConstraints) {
+        self.nativeViewConstraints = @[
+            [self.nativeView.leadingAnchor constraintEqualToAnchor:self.leadingAnchor],
+            [self.nativeView.trailingAnchor constraintEqualToAnchor:self.trailingAnchor],
+            [self.nativeView.topAnchor constraintEqualToAnchor:self.topAnchor],
+            [self.nativeView.bottomAnchor constraintEqualToAnchor:self.bottomAnchor]
+        ];
+        [NSLayoutConstraint activateConstraints:self.nativeViewConstraints];
+    }
+    
+    [self layoutIfNeeded];
+}
+
 /*
  Make sure to call this method when the message view gets dismissed
  Otherwise a memory leak will occur and the entire view controller will be leaked
@@ -228,7 +334,15 @@
     [self.webView.configuration.userContentController removeScriptMessageHandlerForName:@"iosListener"];
 }
 
+- (void)dealloc {
+    [[NSNotificationCenter defaultCenter] removeObserver:self];
+    // Return the web view so the next message can skip creating one
+    if (_webView)
+        [OSInAppMessageWebViewPool.sharedPool recycleWebView:_webView];
+}
+
 - (void)loadReplacementURL:(NSURL *)url {
+    [self setupWebviewIfNeeded];
     [self.webView loadRequest:[NSURLRequest requestWithURL:url]];
 }
 
@@ -238,6 +352,10 @@
     if (self.loaded)
         return;
     self.loaded = true;
+    // Tags may have been refreshed while the page was loading
+    if (self.message.hasLiquid) {
+        [self tagsDidChange];
+    }
 }
 
 - (UIView *)viewForZoomingInScrollView:(UIScrollView *)scrollView {
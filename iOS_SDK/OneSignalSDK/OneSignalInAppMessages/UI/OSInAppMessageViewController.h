@@ -48,11 +48,10 @@ NS_ASSUME_NONNULL_BEGIN
 @end
 
 
-@interface OSInAppMessageViewController : UIViewController <OSInAppMessageViewDelegate, WKScriptMessageHandler>
+@interface OSInAppMessageViewController : UIViewController <OSInAppMessageViewDelegate, OSInAppMessageNativeViewDelegate, WKScriptMessageHandler>
 
 @property (weak, nonatomic, nullable) id<OSInAppMessageViewControllerDelegate> delegate;
 @property (strong, nonatomic, nonnull) OSInAppMessageInternal *message;
-@property (nonatomic) BOOL waitForTags;
 
 - (instancetype _Nonnull)initWithMessage:(OSInAppMessageInternal *)inAppMessage delegate:(id<OSInAppMessageViewControllerDelegate>)delegate;
 - (void)dismissCurrentInAppMessage;
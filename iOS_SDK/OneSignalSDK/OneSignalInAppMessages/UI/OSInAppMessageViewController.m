@@ -85,12 +85,25 @@
 // BOOL to track if the message content has loaded before tags have finished loading for liquid templating
 @property (nonatomic, nullable) NSString *pendingHTMLContent;
 
+// Set when the content has a layout simple enough to render without a web view, the HTML is kept to fall back to
+@property (strong, nonatomic, nullable) OSInAppMessageNativeLayout *pendingNativeLayout;
+
 @property (nonatomic) BOOL useHeightMargin;
 
 @property (nonatomic) BOOL useWidthMargin;
 
 @property (nonatomic) BOOL isFullscreen;
 
+// Resize and rendering complete events can arrive in bursts, they are applied at most once per frame from this link
+@property (strong, nonatomic, nullable) CADisplayLink *bridgeEventFrameLink;
+
+@property (nonatomic) BOOL needsSafeAreaInsetsUpdate;
+
+@property (nonatomic) BOOL needsRenderingCompleteDisplay;
+
+// Content heights measured in JS keyed by layoutKeyForSize:, so rotating back to a size does not measure it again
+@property (strong, nonatomic, nonnull) NSMutableDictionary<NSString *, NSNumber *> *measuredHeights;
+
 @end
 
 @implementation OSInAppMessageViewController
@@ -103,6 +116,7 @@ OSInAppMessageInternal *_dismissingMessage = nil;
         self.delegate = delegate;
         self.useHeightMargin = YES;
         self.useWidthMargin = YES;
+        self.measuredHeights = [NSMutableDictionary new];
         _dismissingMessage = nil;
     }
     
@@ -139,6 +153,8 @@ OSInAppMessageInternal *_dismissingMessage = nil;
     [super viewWillDisappear:animated];
     
     [self.dismissalTimer invalidate];
+    [self.bridgeEventFrameLink invalidate];
+    self.bridgeEventFrameLink = nil;
     
     [self.messageView removeScriptMessageHandler];
 }
@@ -257,11 +273,12 @@ OSInAppMessageInternal *_dismissingMessage = nil;
 
             let baseUrl = [NSURL URLWithString:OS_IAM_WEBVIEW_BASE_URL];
             [self parseContentData:data];
-            if (self.waitForTags) {
-                return;
-            }
             [self updateDropShadow];
             [self.delegate messageWillDisplay:self.message];
+            if (self.pendingNativeLayout) {
+                [self loadNativeLayout];
+                return;
+            }
             [self.messageView loadedHtmlContent:self.pendingHTMLContent withBaseURL:baseUrl];
             self.pendingHTMLContent = nil;
             
@@ -271,6 +288,12 @@ OSInAppMessageInternal *_dismissingMessage = nil;
 
 - (void)parseContentData:(NSDictionary *)data {
     self.pendingHTMLContent = data[@"html"];
+    // Liquid is substituted by the page's JS, so those messages always render from their HTML
+    if (data[OS_IAM_NATIVE_LAYOUT_KEY] && !self.message.hasLiquid) {
+        self.pendingNativeLayout = [OSInAppMessageNativeLayout instanceWithJson:data[OS_IAM_NATIVE_LAYOUT_KEY]];
+        if (!self.pendingNativeLayout)
+            [OneSignalLog onesignalLog:ONE_S_LL_VERBOSE message:@"In-app message native layout is not supported, rendering its HTML"];
+    }
     self.maxDisplayTime = [data[@"display_duration"] doubleValue];
     NSDictionary *styles = data[@"styles"];
     if (styles) {
@@ -284,41 +307,39 @@ OSInAppMessageInternal *_dismissingMessage = nil;
         }
     }
     self.isFullscreen = !self.useHeightMargin;
-    if (self.isFullscreen) {
-        self.pendingHTMLContent = [self setContentInsetsInHTML:self.pendingHTMLContent];
-    }
     [self.messageView setIsFullscreen:self.isFullscreen];
 }
 
-- (NSString *)setContentInsetsInHTML:(NSString *)html {
-    NSMutableString *newHTML = [[NSMutableString alloc] initWithString:html];
-    if (@available(iOS 11, *)) {
-        UIWindow *keyWindow = UIApplication.sharedApplication.keyWindow;
-        if (!keyWindow) {
-            return newHTML;
-        }
-        CGFloat top = keyWindow.safeAreaInsets.top;
-        CGFloat bottom = keyWindow.safeAreaInsets.bottom;
-        CGFloat right = keyWindow.safeAreaInsets.right;
-        CGFloat left = keyWindow.safeAreaInsets.left;
-        NSString *safeAreaInsetsObjectString = [NSString stringWithFormat:OS_JS_SAFE_AREA_INSETS_OBJ,top, bottom, right, left];
-        NSString *insetsString = [NSString stringWithFormat:@"\n\n\
-                             <script> \
-                                setSafeAreaInsets(%@);\
-                             </script>",safeAreaInsetsObjectString];
-        [newHTML appendString: insetsString];
-    }
-    return newHTML;
-}
-
-- (void)setWaitForTags:(BOOL)waitForTags {
-    _waitForTags = waitForTags;
-    if (!waitForTags && self.pendingHTMLContent) {
-        dispatch_async(dispatch_get_main_queue(), ^{
+/*
+ Renders the message with UIKit, which needs no web content process and displays in the first frame after the image decodes.
+ This stands in for the page's rendering complete event, falling back to the HTML if the native view fails to load.
+ */
+- (void)loadNativeLayout {
+    let layout = self.pendingNativeLayout;
+    self.pendingNativeLayout = nil;
+    [self.messageView loadNativeLayout:layout delegate:self completion:^(NSNumber *height) {
+        if (!height) {
+            if (!self.pendingHTMLContent) {
+                [self encounteredErrorLoadingMessageContent:nil];
+                [self.delegate messageViewControllerWasDismissed:self.message displayed:NO];
+                return;
+            }
             [self.messageView loadedHtmlContent:self.pendingHTMLContent withBaseURL:[NSURL URLWithString:OS_IAM_WEBVIEW_BASE_URL]];
             self.pendingHTMLContent = nil;
-        });
-    }
+            return;
+        }
+        self.pendingHTMLContent = nil;
+        self.didPageRenderingComplete = true;
+        self.message.dragToDismissDisabled = layout.dragToDismissDisabled;
+        self.message.position = layout.displayLocation;
+        self.message.height = height;
+        [self.measuredHeights removeAllObjects];
+        [self cacheMeasuredHeight:height forSize:self.view.bounds.size];
+        [self.delegate webViewContentFinishedLoading:self.message];
+        [self displayMessage];
+        if (layout.pageId)
+            [self.delegate messageViewDidDisplayPage:self.message withPageId:layout.pageId];
+    }];
 }
 
 - (void)loadMessageContent {
@@ -732,8 +753,10 @@ OSInAppMessageInternal *_dismissingMessage = nil;
  This delegate function gets called when in-app html is load or action button is tapped
  */
 - (void)jsEventOccurredWithBody:(NSData *)body {
-    let event = [OSInAppMessageBridgeEvent instanceWithData:body];
-    
+    [self jsEventOccurred:[OSInAppMessageBridgeEvent instanceWithData:body]];
+}
+
+- (void)jsEventOccurred:(OSInAppMessageBridgeEvent *)event {
     NSString *eventMessage = [NSString stringWithFormat:@"Action Occurred with Event: %@", event];
     [OneSignalLog onesignalLog:ONE_S_LL_VERBOSE message:eventMessage];
     NSString *eventTypeMessage = [NSString stringWithFormat:@"Action Occurred with Event Type: %lu", (unsigned long)event.type];
@@ -747,13 +770,13 @@ OSInAppMessageInternal *_dismissingMessage = nil;
                 self.message.dragToDismissDisabled = event.renderingComplete.dragToDismissDisabled;
                 self.message.position = event.renderingComplete.displayLocation;
                 self.message.height = event.renderingComplete.height;
+                [self.measuredHeights removeAllObjects];
+                [self cacheMeasuredHeight:self.message.height forSize:self.view.bounds.size];
 
                 // The page is fully loaded and should now be displayed
                 // This is only fired once the javascript on the page sends the "rendering_complete" type event
-                dispatch_async(dispatch_get_main_queue(), ^{
-                    [self.delegate webViewContentFinishedLoading:self.message];
-                    [OneSignalCoreHelper performSelector:@selector(displayMessage) onMainThreadOnObject:self withObject:nil afterDelay:0.0f];
-                });
+                self.needsRenderingCompleteDisplay = true;
+                [self setNeedsBridgeEventFrame];
                 break;
             }
             case OSInAppMessageBridgeEventTypePageResize: {
@@ -761,7 +784,8 @@ OSInAppMessageInternal *_dismissingMessage = nil;
                 // Currently used for fullscreen IAMs to account for safe area changes
                 // self.message.height = event.resize.height;
                 if (self.isFullscreen) {
-                    [self.messageView updateSafeAreaInsets];
+                    self.needsSafeAreaInsetsUpdate = true;
+                    [self setNeedsBridgeEventFrame];
                 }
                 break;
             }
@@ -775,6 +799,8 @@ OSInAppMessageInternal *_dismissingMessage = nil;
                 break;
             }
             case OSInAppMessageBridgeEventTypePageChange: {
+                // A new page has its own height
+                [self.measuredHeights removeAllObjects];
                 [self.delegate messageViewDidDisplayPage:self.message withPageId: event.pageChange.page.pageId];
                 break;
             }
@@ -784,6 +810,38 @@ OSInAppMessageInternal *_dismissingMessage = nil;
     }
 }
 
+- (NSString *)layoutKeyForSize:(CGSize)size {
+    let traits = self.traitCollection;
+    return [NSString stringWithFormat:@"%.0fx%.0f-%ld-%ld", size.width, size.height, (long)traits.horizontalSizeClass, (long)traits.verticalSizeClass];
+}
+
+- (void)cacheMeasuredHeight:(NSNumber *)height forSize:(CGSize)size {
+    if (height)
+        self.measuredHeights[[self layoutKeyForSize:size]] = height;
+}
+
+- (void)setNeedsBridgeEventFrame {
+    if (self.bridgeEventFrameLink)
+        return;
+    self.bridgeEventFrameLink = [CADisplayLink displayLinkWithTarget:self selector:@selector(bridgeEventFrameLinkFired:)];
+    [self.bridgeEventFrameLink addToRunLoop:NSRunLoop.mainRunLoop forMode:NSRunLoopCommonModes];
+}
+
+- (void)bridgeEventFrameLinkFired:(CADisplayLink *)link {
+    [link invalidate];
+    self.bridgeEventFrameLink = nil;
+
+    if (self.needsSafeAreaInsetsUpdate) {
+        self.needsSafeAreaInsetsUpdate = false;
+        [self.messageView updateSafeAreaInsets];
+    }
+    if (self.needsRenderingCompleteDisplay) {
+        self.needsRenderingCompleteDisplay = false;
+        [self.delegate webViewContentFinishedLoading:self.message];
+        [self displayMessage];
+    }
+}
+
 /*
  Unity overrides orientation behavior and enables all orientations in supportedInterfaceOrientations, regardless of
  the values set in the info.plist. It then uses its own internal logic for restricting the Application's views to
@@ -872,12 +930,23 @@ OSInAppMessageInternal *_dismissingMessage = nil;
          */
         [OneSignalLog onesignalLog:ONE_S_LL_VERBOSE message:@"Orientation Change Complete: Getting new height from JS getPageMetaData()"];
         
+        NSNumber *cachedHeight = self.measuredHeights[[self layoutKeyForSize:size]];
+        if (cachedHeight) {
+            [OneSignalLog onesignalLog:ONE_S_LL_VERBOSE message:@"Orientation Change Complete with Cached Height: Adding constraints again and showing IAM"];
+            self.message.height = cachedHeight;
+            [self.messageView resetWebViewToMaxBounds];
+            [self addConstraintsForMessage];
+            [self animateAppearance:NO];
+            return;
+        }
+
         // Evaluate the JS getPageMetaData() to obtain the new height for the webView and use it within the completion callback to set the new height
         [self.messageView resetWebViewToMaxBoundsAndResizeHeight:^(NSNumber *newHeight) {
             [OneSignalLog onesignalLog:ONE_S_LL_VERBOSE message:@"Orientation Change Complete with New Height: Adding constraints again and showing IAM"];
             
             // Assign new height to message
             self.message.height = newHeight;
+            [self cacheMeasuredHeight:newHeight forSize:size];
             
             // Add all of the constraints using the new message height obtained from JS code
             [self addConstraintsForMessage];
@@ -888,6 +957,15 @@ OSInAppMessageInternal *_dismissingMessage = nil;
     }];
 }
 
+#pragma mark OSInAppMessageNativeViewDelegate Methods
+- (void)nativeViewDidSelectAction:(OSInAppMessageClickResult *)action {
+    ONE_S_LOG(ONE_S_LL_VERBOSE, @"Native in-app message action: %@", action);
+    if (action.clickType)
+        [self.delegate messageViewDidSelectAction:self.message withAction:action];
+    if (action.closingMessage)
+        [self dismissCurrentInAppMessage];
+}
+
 #pragma mark OSInAppMessageViewDelegate Methods
 - (void)messageViewFailedToLoadMessageContent {
     [self.delegate messageViewControllerWasDismissed:self.message displayed:NO];
@@ -898,8 +976,8 @@ OSInAppMessageInternal *_dismissingMessage = nil;
 }
 
 - (void)userContentController:(WKUserContentController *)userContentController didReceiveScriptMessage:(WKScriptMessage *)message {
-    [OneSignalLog onesignalLog:ONE_S_LL_VERBOSE message:[NSString stringWithFormat:@"Received in-app script message: %@", message.body]];
-    [self jsEventOccurredWithBody:[message.body dataUsingEncoding:NSUTF8StringEncoding]];
+    ONE_S_LOG(ONE_S_LL_VERBOSE, @"Received in-app script message: %@", message.body);
+    [self jsEventOccurred:[OSInAppMessageBridgeEvent instanceWithScriptMessageBody:message.body]];
 }
 
 @end
@@ -0,0 +1,117 @@
+/**
+ * Modified MIT License
+ *
+ * Copyright 2024 OneSignal
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * 2. All copies of substantial portions of the Software may only be used in connection
+ * with services provided by OneSignal.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#import "OSInAppMessageWebViewPool.h"
+#import <OneSignalCore/OneSignalCore.h>
+#import "OSInAppMessagingDefines.h"
+
+@interface OSInAppMessageWebViewPool () <OSMemoryPressureResponder>
+
+// Only before iOS 15
+@property (strong, nonatomic, nullable) WKProcessPool *processPool;
+@property (strong, nonatomic, nonnull) NSMutableArray<WKWebView *> *idleWebViews;
+
+@end
+
+@implementation OSInAppMessageWebViewPool
+
++ (OSInAppMessageWebViewPool *)sharedPool {
+    static OSInAppMessageWebViewPool *sharedPool = nil;
+    static dispatch_once_t once;
+    dispatch_once(&once, ^{
+        sharedPool = [OSInAppMessageWebViewPool new];
+    });
+    return sharedPool;
+}
+
+- (instancetype)init {
+    if (self = [super init]) {
+        // From iOS 15 every web view shares one process pool, setting one has no effect
+        if (@available(iOS 15.0, *)) {} else {
+            _processPool = [WKProcessPool new];
+        }
+        _idleWebViews = [NSMutableArray new];
+        [OSMemoryPressureCoordinator addResponder:self];
+    }
+    return self;
+}
+
+- (WKWebView *)createWebViewWithFrame:(CGRect)frame {
+    let configuration = [WKWebViewConfiguration new];
+    if (_processPool)
+        configuration.processPool = _processPool;
+    return [[WKWebView alloc] initWithFrame:frame configuration:configuration];
+}
+
+- (void)prewarm {
+    // Web views are still created on demand at display
+    if (!OSPowerPolicy.sharedPolicy.allowsPrefetch)
+        return;
+    while (_idleWebViews.count < OS_IAM_WEBVIEW_POOL_SIZE) {
+        let webView = [self createWebViewWithFrame:CGRectZero];
+        // Loading an empty document launches the web content process now instead of on display
+        [webView loadHTMLString:@"" baseURL:nil];
+        [_idleWebViews addObject:webView];
+    }
+    ONE_S_LOG(ONE_S_LL_VERBOSE, @"OSInAppMessageWebViewPool prewarmed %lu web views", (unsigned long)_idleWebViews.count);
+}
+
+- (WKWebView *)dequeueWebViewWithFrame:(CGRect)frame {
+    WKWebView *webView = _idleWebViews.lastObject;
+    if (!webView)
+        return [self createWebViewWithFrame:frame];
+
+    [_idleWebViews removeLastObject];
+    webView.frame = frame;
+    return webView;
+}
+
+- (void)recycleWebView:(WKWebView *)webView {
+    [webView stopLoading];
+    [webView.configuration.userContentController removeAllUserScripts];
+    [webView.configuration.userContentController removeScriptMessageHandlerForName:@"iosListener"];
+    webView.UIDelegate = nil;
+    webView.navigationDelegate = nil;
+    webView.scrollView.delegate = nil;
+    [webView removeFromSuperview];
+
+    if (_idleWebViews.count >= OS_IAM_WEBVIEW_POOL_SIZE)
+        return;
+
+    [webView loadHTMLString:@"" baseURL:nil];
+    [_idleWebViews addObject:webView];
+}
+
+- (void)purgeForMemoryPressure {
+    [self drain];
+}
+
+- (void)drain {
+    [_idleWebViews removeAllObjects];
+}
+
+@end
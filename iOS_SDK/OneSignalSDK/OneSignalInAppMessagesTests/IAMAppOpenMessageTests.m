@@ -0,0 +1,143 @@
+/**
+ * Modified MIT License
+ *
+ * Copyright 2024 OneSignal
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * 2. All copies of substantial portions of the Software may only be used in connection
+ * with services provided by OneSignal.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#import <XCTest/XCTest.h>
+#import "OSMessagingController.h"
+#import "OSInAppMessageInternal.h"
+#import "OSInAppMessagingDefines.h"
+#import <OneSignalCore/OneSignalCore.h>
+
+@interface OSMessagingController (AppOpenMessageTests)
+@property (strong, nonatomic, nonnull) NSMutableArray <OSInAppMessageInternal *> *messageDisplayQueue;
+@property (nonatomic, nullable) OSInAppMessageInternal *appOpenMessage;
+@property (nonatomic, nullable) NSString *appOpenMessageOnesignalId;
+- (NSArray<OSInAppMessageInternal *> *)inAppMessagesFromJson:(NSArray *)messagesJson;
+- (void)revalidateAppOpenMessageWithMessages:(NSArray<OSInAppMessageInternal *> *)newMessages;
+- (void)saveAppOpenMessageJson:(NSDictionary *)messageJson onesignalId:(NSString *)onesignalId;
+- (void)presentAppOpenMessageForOnesignalId:(NSString *)onesignalId;
+- (void)resetAppOpenMessageForOnesignalId:(NSString *)onesignalId;
+@end
+
+@interface IAMAppOpenMessageTests : XCTestCase
+
+@end
+
+@implementation IAMAppOpenMessageTests
+
+- (void)tearDown {
+    [OneSignalUserDefaults.initStandard removeValueForKey:OS_IAM_APP_OPEN_MESSAGE_KEY];
+}
+
+- (BOOL)hasSavedDecision {
+    return [OneSignalUserDefaults.initStandard keyExists:OS_IAM_APP_OPEN_MESSAGE_KEY];
+}
+
+- (NSDictionary *)messageJsonWithId:(NSString *)messageId triggers:(NSArray *)triggers {
+    return @{
+        @"id" : messageId,
+        @"variants" : @{@"all" : @{@"default" : [NSUUID UUID].UUIDString}},
+        @"triggers" : triggers,
+        @"end_time" : @"2099-01-01T00:00:00.000Z"
+    };
+}
+
+- (void)testRevalidation_keepsMessageTheFetchStillSendsWithoutTriggers {
+    OSMessagingController *controller = [OSMessagingController new];
+    NSDictionary *messageJson = [self messageJsonWithId:@"app_open" triggers:@[]];
+    OSInAppMessageInternal *message = [controller inAppMessagesFromJson:@[messageJson]].firstObject;
+    controller.appOpenMessage = message;
+    [controller.messageDisplayQueue addObject:message];
+
+    NSMutableDictionary *updatedJson = [messageJson mutableCopy];
+    updatedJson[@"end_time"] = @"2098-01-01T00:00:00.000Z";
+    [controller revalidateAppOpenMessageWithMessages:[controller inAppMessagesFromJson:@[updatedJson]]];
+
+    XCTAssertEqualObjects(controller.messageDisplayQueue, @[message]);
+    XCTAssertNil(controller.appOpenMessage);
+}
+
+- (void)testRevalidation_withdrawsQueuedMessageTheFetchNoLongerSends {
+    OSMessagingController *controller = [OSMessagingController new];
+    OSInAppMessageInternal *message = [controller inAppMessagesFromJson:@[[self messageJsonWithId:@"app_open" triggers:@[]]]].firstObject;
+    controller.appOpenMessage = message;
+    [controller.messageDisplayQueue addObject:message];
+
+    NSArray *triggers = @[@[@{@"id" : [NSUUID UUID].UUIDString, @"kind" : OS_DYNAMIC_TRIGGER_KIND_CUSTOM, @"property" : @"level", @"operator" : @"greater", @"value" : @1}]];
+    [controller revalidateAppOpenMessageWithMessages:[controller inAppMessagesFromJson:@[[self messageJsonWithId:@"app_open" triggers:triggers]]]];
+
+    XCTAssertEqual(controller.messageDisplayQueue.count, 0);
+    XCTAssertNil(controller.appOpenMessage);
+}
+
+- (void)testDecision_isOnlyTakenByTheLaunchsFirstFetch {
+    OSMessagingController *controller = [OSMessagingController new];
+    NSDictionary *messageJson = [self messageJsonWithId:@"app_open" triggers:@[]];
+    [controller saveAppOpenMessageJson:messageJson onesignalId:@"onesignal_id_a"];
+
+    // The first fetch takes the decision, another user's is not presented
+    [controller presentAppOpenMessageForOnesignalId:@"onesignal_id_b"];
+    XCTAssertFalse([self hasSavedDecision]);
+    XCTAssertNil(controller.appOpenMessage);
+    XCTAssertEqual(controller.messageDisplayQueue.count, 0);
+
+    // Later fetches of the same launch leave it for the next launch
+    [controller saveAppOpenMessageJson:messageJson onesignalId:@"onesignal_id_a"];
+    [controller presentAppOpenMessageForOnesignalId:@"onesignal_id_a"];
+    XCTAssertTrue([self hasSavedDecision]);
+    XCTAssertNil(controller.appOpenMessage);
+    XCTAssertEqual(controller.messageDisplayQueue.count, 0);
+}
+
+- (void)testUserChange_discardsDecisionMadeForAnotherUser {
+    OSMessagingController *controller = [OSMessagingController new];
+    [controller saveAppOpenMessageJson:[self messageJsonWithId:@"app_open" triggers:@[]] onesignalId:@"onesignal_id_a"];
+
+    [controller resetAppOpenMessageForOnesignalId:@"onesignal_id_a"];
+    XCTAssertTrue([self hasSavedDecision]);
+
+    [controller resetAppOpenMessageForOnesignalId:@"onesignal_id_b"];
+    XCTAssertFalse([self hasSavedDecision]);
+}
+
+- (void)testUserChange_withdrawsMessagePresentedForAnotherUser {
+    OSMessagingController *controller = [OSMessagingController new];
+    OSInAppMessageInternal *message = [controller inAppMessagesFromJson:@[[self messageJsonWithId:@"app_open" triggers:@[]]]].firstObject;
+    controller.appOpenMessage = message;
+    controller.appOpenMessageOnesignalId = @"onesignal_id_a";
+    [controller.messageDisplayQueue addObject:message];
+
+    [controller resetAppOpenMessageForOnesignalId:@"onesignal_id_a"];
+    XCTAssertEqualObjects(controller.messageDisplayQueue, @[message]);
+    XCTAssertEqual(controller.appOpenMessage, message);
+
+    [controller resetAppOpenMessageForOnesignalId:@"onesignal_id_b"];
+    XCTAssertEqual(controller.messageDisplayQueue.count, 0);
+    XCTAssertNil(controller.appOpenMessage);
+}
+
+@end
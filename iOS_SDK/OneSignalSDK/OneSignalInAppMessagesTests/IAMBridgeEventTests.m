@@ -0,0 +1,112 @@
+/**
+ * Modified MIT License
+ *
+ * Copyright 2024 OneSignal
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * 2. All copies of substantial portions of the Software may only be used in connection
+ * with services provided by OneSignal.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#import <XCTest/XCTest.h>
+#import "OSInAppMessageBridgeEvent.h"
+#import "OSInAppMessageInternal.h"
+#import "OSInAppMessageView.h"
+#import "OSInAppMessageViewController.h"
+
+@interface OSInAppMessageViewController (BridgeEventTests)
+@property (nonatomic, nullable) OSInAppMessageView *messageView;
+@property (nonatomic) BOOL isFullscreen;
+@property (strong, nonatomic, nullable) CADisplayLink *bridgeEventFrameLink;
+- (void)jsEventOccurred:(OSInAppMessageBridgeEvent *)event;
+- (void)bridgeEventFrameLinkFired:(CADisplayLink *)link;
+@end
+
+@interface SafeAreaCountingMessageView : OSInAppMessageView
+@property (nonatomic) NSInteger safeAreaInsetsUpdateCount;
+@end
+
+@implementation SafeAreaCountingMessageView
+
+- (void)updateSafeAreaInsets {
+    self.safeAreaInsetsUpdateCount++;
+}
+
+@end
+
+@interface IAMBridgeEventTests : XCTestCase
+
+@end
+
+@implementation IAMBridgeEventTests
+
+- (NSDictionary *)resizeEventJson {
+    return @{@"type" : @"resize", @"pageMetaData" : @{@"rect" : @{@"height" : @420}}};
+}
+
+- (void)testScriptMessageBody_objectAndJSONStringDecodeTheSame {
+    NSData *jsonData = [NSJSONSerialization dataWithJSONObject:[self resizeEventJson] options:0 error:nil];
+    NSString *jsonString = [[NSString alloc] initWithData:jsonData encoding:NSUTF8StringEncoding];
+
+    OSInAppMessageBridgeEvent *fromObject = [OSInAppMessageBridgeEvent instanceWithScriptMessageBody:[self resizeEventJson]];
+    OSInAppMessageBridgeEvent *fromString = [OSInAppMessageBridgeEvent instanceWithScriptMessageBody:jsonString];
+
+    XCTAssertEqual(fromObject.type, OSInAppMessageBridgeEventTypePageResize);
+    XCTAssertEqual(fromString.type, OSInAppMessageBridgeEventTypePageResize);
+    XCTAssertEqualObjects(fromObject.resize.height, @420);
+    XCTAssertEqualObjects(fromString.resize.height, @420);
+}
+
+- (void)testScriptMessageBody_ofAnotherClassIsIgnored {
+    XCTAssertNil([OSInAppMessageBridgeEvent instanceWithScriptMessageBody:@42]);
+    XCTAssertNil([OSInAppMessageBridgeEvent instanceWithScriptMessageBody:@[[self resizeEventJson]]]);
+}
+
+- (void)testResizeBurst_updatesTheSafeAreaInsetsOncePerFrame {
+    OSInAppMessageInternal *message = [OSInAppMessageInternal instanceWithJson:@{
+        @"id" : @"message",
+        @"variants" : @{@"all" : @{@"default" : @"variant_id"}},
+        @"triggers" : @[]
+    }];
+    OSInAppMessageViewController *viewController = [[OSInAppMessageViewController alloc] initWithMessage:message delegate:nil];
+    SafeAreaCountingMessageView *messageView = [[SafeAreaCountingMessageView alloc] initWithMessage:message withScriptMessageHandler:nil];
+    viewController.messageView = messageView;
+    viewController.isFullscreen = YES;
+    OSInAppMessageBridgeEvent *resize = [OSInAppMessageBridgeEvent instanceWithJson:[self resizeEventJson]];
+
+    for (int i = 0; i < 5; i++)
+        [viewController jsEventOccurred:resize];
+    CADisplayLink *link = viewController.bridgeEventFrameLink;
+    XCTAssertNotNil(link);
+    XCTAssertEqual(messageView.safeAreaInsetsUpdateCount, 0);
+
+    [viewController bridgeEventFrameLinkFired:link];
+    XCTAssertEqual(messageView.safeAreaInsetsUpdateCount, 1);
+    XCTAssertNil(viewController.bridgeEventFrameLink);
+
+    // The next event waits for a new frame
+    [viewController jsEventOccurred:resize];
+    XCTAssertNotNil(viewController.bridgeEventFrameLink);
+    [viewController bridgeEventFrameLinkFired:viewController.bridgeEventFrameLink];
+    XCTAssertEqual(messageView.safeAreaInsetsUpdateCount, 2);
+}
+
+@end
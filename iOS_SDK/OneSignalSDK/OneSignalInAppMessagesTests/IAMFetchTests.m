@@ -0,0 +1,121 @@
+/**
+ * Modified MIT License
+ *
+ * Copyright 2024 OneSignal
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * 2. All copies of substantial portions of the Software may only be used in connection
+ * with services provided by OneSignal.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#import <XCTest/XCTest.h>
+#import "OSMessagingController.h"
+#import "OneSignalOSCore/OneSignalOSCore-Swift.h"
+#import <OneSignalCore/OneSignalCore.h>
+
+@interface OSMessagingController (FetchTests)
+@property (nonatomic) double rywDelayScale;
+@property (nonatomic) BOOL needsRefreshOnForeground;
+- (NSTimeInterval)fetchDelayForRywData:(OSReadYourWriteData *)rywData;
+- (void)adaptRywDelayScaleAfterTooEarly:(BOOL)tooEarly;
+- (void)applicationWillEnterForeground:(NSNotification *)nsNotification;
+@end
+
+// Counts the fetches instead of sending them
+@interface FetchCountingMessagingController : OSMessagingController
+@property (nonatomic) NSInteger fetchCount;
+@end
+
+@implementation FetchCountingMessagingController
+
+- (void)getInAppMessagesFromServer:(NSString *)subscriptionId {
+    self.fetchCount++;
+}
+
+@end
+
+@interface IAMFetchTests : XCTestCase
+
+@end
+
+@implementation IAMFetchTests
+
+- (void)testFetchDelay_withoutRywTokenIsZero {
+    OSMessagingController *controller = [OSMessagingController new];
+    OSReadYourWriteData *rywData = [[OSReadYourWriteData alloc] initWithRywToken:nil rywDelay:@1000];
+
+    XCTAssertEqual([controller fetchDelayForRywData:rywData], 0);
+    XCTAssertEqual([controller fetchDelayForRywData:nil], 0);
+}
+
+- (void)testFetchDelay_withoutRywDelayUsesTheBuffer {
+    OSMessagingController *controller = [OSMessagingController new];
+    OSReadYourWriteData *rywData = [[OSReadYourWriteData alloc] initWithRywToken:@"token" rywDelay:nil];
+
+    XCTAssertEqualWithAccuracy([controller fetchDelayForRywData:rywData], 0.5, 0.0001);
+}
+
+- (void)testFetchDelay_shrinksAfterSuccessesAndResetsAfterTooEarly {
+    OSMessagingController *controller = [OSMessagingController new];
+    OSReadYourWriteData *rywData = [[OSReadYourWriteData alloc] initWithRywToken:@"token" rywDelay:@1000];
+
+    // The full ryw_delay is waited until a fetch succeeds
+    XCTAssertEqualWithAccuracy([controller fetchDelayForRywData:rywData], 1.0, 0.0001);
+
+    [controller adaptRywDelayScaleAfterTooEarly:NO];
+    XCTAssertEqualWithAccuracy([controller fetchDelayForRywData:rywData], 0.8, 0.0001);
+
+    // The delay never drops below a quarter of ryw_delay
+    for (int i = 0; i < 20; i++)
+        [controller adaptRywDelayScaleAfterTooEarly:NO];
+    XCTAssertEqualWithAccuracy([controller fetchDelayForRywData:rywData], 0.25, 0.0001);
+
+    // A 425 Too Early goes back to the full delay
+    [controller adaptRywDelayScaleAfterTooEarly:YES];
+    XCTAssertEqualWithAccuracy(controller.rywDelayScale, 1.0, 0.0001);
+    XCTAssertEqualWithAccuracy([controller fetchDelayForRywData:rywData], 1.0, 0.0001);
+}
+
+- (void)testRefreshPush_fetchesRightAwayInTheForeground {
+    XCTSkipIf(UIApplication.sharedApplication.applicationState == UIApplicationStateBackground, @"The test host is in the background");
+    FetchCountingMessagingController *controller = [FetchCountingMessagingController new];
+
+    [[NSNotificationCenter defaultCenter] postNotificationName:ONESIGNAL_POST_REFRESH_IAM object:nil userInfo:nil];
+    [[NSRunLoop mainRunLoop] runUntilDate:[NSDate dateWithTimeIntervalSinceNow:0.1]];
+
+    XCTAssertEqual(controller.fetchCount, 1);
+    XCTAssertFalse(controller.needsRefreshOnForeground);
+}
+
+- (void)testRefreshPush_deferredInTheBackgroundFetchesOnceOnForeground {
+    FetchCountingMessagingController *controller = [FetchCountingMessagingController new];
+    controller.needsRefreshOnForeground = YES;
+
+    [controller applicationWillEnterForeground:nil];
+    XCTAssertEqual(controller.fetchCount, 1);
+    XCTAssertFalse(controller.needsRefreshOnForeground);
+
+    // Later foregrounds without a refresh push don't fetch again
+    [controller applicationWillEnterForeground:nil];
+    XCTAssertEqual(controller.fetchCount, 1);
+}
+
+@end
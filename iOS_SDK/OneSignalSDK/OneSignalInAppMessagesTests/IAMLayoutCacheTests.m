@@ -0,0 +1,81 @@
+/**
+ * Modified MIT License
+ *
+ * Copyright 2024 OneSignal
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * 2. All copies of substantial portions of the Software may only be used in connection
+ * with services provided by OneSignal.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#import <XCTest/XCTest.h>
+#import "OSInAppMessageBridgeEvent.h"
+#import "OSInAppMessageInternal.h"
+#import "OSInAppMessageViewController.h"
+
+@interface OSInAppMessageViewController (LayoutCacheTests)
+@property (strong, nonatomic, nonnull) NSMutableDictionary<NSString *, NSNumber *> *measuredHeights;
+- (NSString *)layoutKeyForSize:(CGSize)size;
+- (void)cacheMeasuredHeight:(NSNumber *)height forSize:(CGSize)size;
+- (void)jsEventOccurred:(OSInAppMessageBridgeEvent *)event;
+@end
+
+@interface IAMLayoutCacheTests : XCTestCase
+
+@end
+
+@implementation IAMLayoutCacheTests
+
+- (OSInAppMessageViewController *)viewController {
+    OSInAppMessageInternal *message = [OSInAppMessageInternal instanceWithJson:@{
+        @"id" : @"message",
+        @"variants" : @{@"all" : @{@"default" : @"variant_id"}},
+        @"triggers" : @[]
+    }];
+    return [[OSInAppMessageViewController alloc] initWithMessage:message delegate:nil];
+}
+
+- (void)testMeasuredHeights_areKeptPerViewSize {
+    OSInAppMessageViewController *viewController = [self viewController];
+    CGSize portrait = CGSizeMake(390, 844);
+    CGSize landscape = CGSizeMake(844, 390);
+
+    [viewController cacheMeasuredHeight:@600 forSize:portrait];
+    [viewController cacheMeasuredHeight:@320 forSize:landscape];
+    // A measurement that failed is not cached
+    [viewController cacheMeasuredHeight:nil forSize:CGSizeMake(1024, 768)];
+
+    XCTAssertNotEqualObjects([viewController layoutKeyForSize:portrait], [viewController layoutKeyForSize:landscape]);
+    XCTAssertEqualObjects(viewController.measuredHeights[[viewController layoutKeyForSize:portrait]], @600);
+    XCTAssertEqualObjects(viewController.measuredHeights[[viewController layoutKeyForSize:landscape]], @320);
+    XCTAssertEqual(viewController.measuredHeights.count, 2);
+}
+
+- (void)testMeasuredHeights_areClearedWhenThePageChanges {
+    OSInAppMessageViewController *viewController = [self viewController];
+    [viewController cacheMeasuredHeight:@600 forSize:CGSizeMake(390, 844)];
+
+    [viewController jsEventOccurred:[OSInAppMessageBridgeEvent instanceWithJson:@{@"type" : @"page_change", @"pageId" : @"page_2", @"pageIndex" : @1}]];
+
+    XCTAssertEqual(viewController.measuredHeights.count, 0);
+}
+
+@end
@@ -0,0 +1,169 @@
+/**
+ * Modified MIT License
+ *
+ * Copyright 2024 OneSignal
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * 2. All copies of substantial portions of the Software may only be used in connection
+ * with services provided by OneSignal.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#import <XCTest/XCTest.h>
+#import "OSMemoryFootprint.h"
+#import "OSMessagingController.h"
+#import "OSInAppMessageInternal.h"
+#import "OSInAppMessagingDefines.h"
+#import "OSInAppMessageStateStore.h"
+
+/*
+ Memory budgets for the in-app messages OSMessagingController holds after a fetch.
+ The budget is the growth of the process' physical footprint from parsing and holding the messages, measured the way
+ the system measures it for memory limits. A typical message with triggers and variants takes around 2 KB.
+ Raise a budget only together with the change that needs it, so growth is a deliberate decision.
+ */
+#define OS_IAM_MEMORY_BUDGET_100_MESSAGES (2 * 1024 * 1024)
+#define OS_IAM_MEMORY_BUDGET_1000_MESSAGES (8 * 1024 * 1024)
+
+@interface OSMessagingController (MemoryTests)
+@property (strong, nonatomic, nonnull) NSArray <OSInAppMessageInternal *> *messages;
+@property (strong, nonatomic, nonnull) NSArray <OSInAppMessageInternal *> *dormantMessages;
+@property (strong, nonatomic, nonnull) OSInAppMessageStateStore *stateStore;
+- (NSArray<OSInAppMessageInternal *> *)inAppMessagesFromJson:(NSArray *)messagesJson;
+- (NSArray<OSInAppMessageInternal *> *)inAppMessagesFromJson:(NSArray *)messagesJson firstPageHandler:(void (^)(NSArray<OSInAppMessageInternal *> *firstPage))firstPageHandler;
+- (void)pruneDormantMessages;
+@end
+
+@interface IAMMemoryTests : XCTestCase
+
+@end
+
+@implementation IAMMemoryTests
+
+- (NSArray<NSDictionary *> *)messagesJsonWithCount:(NSUInteger)count {
+    NSMutableArray<NSDictionary *> *messagesJson = [NSMutableArray arrayWithCapacity:count];
+    for (NSUInteger i = 0; i < count; i++) {
+        [messagesJson addObject:@{
+            @"id" : [NSString stringWithFormat:@"message_%lu", (unsigned long)i],
+            @"variants" : @{
+                @"ios" : @{@"default" : [NSUUID UUID].UUIDString, @"en" : [NSUUID UUID].UUIDString},
+                @"all" : @{@"default" : [NSUUID UUID].UUIDString}
+            },
+            @"triggers" : @[@[
+                @{@"id" : [NSUUID UUID].UUIDString, @"kind" : OS_DYNAMIC_TRIGGER_KIND_CUSTOM, @"property" : @"level", @"operator" : @"greater", @"value" : @(i)},
+                @{@"id" : [NSUUID UUID].UUIDString, @"kind" : OS_DYNAMIC_TRIGGER_KIND_CUSTOM, @"property" : @"plan", @"operator" : @"equal", @"value" : @"pro"}
+            ]],
+            @"redisplay" : @{@"limit" : @10, @"delay" : @60},
+            @"end_time" : @"2099-01-01T00:00:00.000Z"
+        }];
+    }
+    return messagesJson;
+}
+
+// The footprint growth from the controller parsing and holding the messages
+- (uint64_t)footprintOfHoldingMessages:(NSUInteger)count controller:(OSMessagingController *)controller {
+    NSArray<NSDictionary *> *messagesJson = [self messagesJsonWithCount:count];
+    uint64_t before = OSPhysicalFootprint();
+    @autoreleasepool {
+        controller.messages = [controller inAppMessagesFromJson:messagesJson];
+    }
+    uint64_t after = OSPhysicalFootprint();
+    XCTAssertEqual(controller.messages.count, count);
+    return after > before ? after - before : 0;
+}
+
+- (void)testHolding100Messages_staysWithinBudget {
+    OSMessagingController *controller = [OSMessagingController new];
+    uint64_t growth = [self footprintOfHoldingMessages:100 controller:controller];
+    XCTAssertLessThanOrEqual(growth, OS_IAM_MEMORY_BUDGET_100_MESSAGES, @"Holding 100 messages grew the footprint by %llu bytes", growth);
+}
+
+- (void)testHolding1000Messages_staysWithinBudget {
+    OSMessagingController *controller = [OSMessagingController new];
+    uint64_t growth = [self footprintOfHoldingMessages:1000 controller:controller];
+    XCTAssertLessThanOrEqual(growth, OS_IAM_MEMORY_BUDGET_1000_MESSAGES, @"Holding 1000 messages grew the footprint by %llu bytes", growth);
+}
+
+- (void)testUnchangedMessages_reuseTheirParsedInstances {
+    OSMessagingController *controller = [OSMessagingController new];
+    NSArray<NSDictionary *> *messagesJson = [self messagesJsonWithCount:2];
+    NSArray<OSInAppMessageInternal *> *firstMessages = [controller inAppMessagesFromJson:messagesJson];
+
+    NSMutableDictionary *changedJson = [messagesJson[1] mutableCopy];
+    changedJson[@"end_time"] = @"2098-01-01T00:00:00.000Z";
+    NSArray<OSInAppMessageInternal *> *secondMessages = [controller inAppMessagesFromJson:@[messagesJson[0], changedJson]];
+
+    XCTAssertEqual(secondMessages[0], firstMessages[0]);
+    XCTAssertNotEqual(secondMessages[1], firstMessages[1]);
+}
+
+- (void)testParsingPages_handsOverTheFirstPageBeforeTheRest {
+    OSMessagingController *controller = [OSMessagingController new];
+    NSArray<NSDictionary *> *messagesJson = [self messagesJsonWithCount:OS_IAM_PARSE_PAGE_SIZE * 2 + 1];
+    __block NSArray<OSInAppMessageInternal *> *firstPage;
+    __block NSUInteger handlerCalls = 0;
+    NSArray<OSInAppMessageInternal *> *messages = [controller inAppMessagesFromJson:messagesJson firstPageHandler:^(NSArray<OSInAppMessageInternal *> *page) {
+        firstPage = page;
+        handlerCalls++;
+    }];
+
+    XCTAssertEqual(handlerCalls, 1);
+    XCTAssertEqual(messages.count, messagesJson.count);
+    XCTAssertEqualObjects(firstPage, [messages subarrayWithRange:NSMakeRange(0, OS_IAM_PARSE_PAGE_SIZE)]);
+}
+
+- (void)testParsingSinglePage_doesNotCallTheFirstPageHandler {
+    OSMessagingController *controller = [OSMessagingController new];
+    __block BOOL handlerCalled = NO;
+    [controller inAppMessagesFromJson:[self messagesJsonWithCount:OS_IAM_PARSE_PAGE_SIZE] firstPageHandler:^(NSArray<OSInAppMessageInternal *> *page) {
+        handlerCalled = YES;
+    }];
+    XCTAssertFalse(handlerCalled);
+}
+
+- (void)testPruning_keepsOnlyMessagesThatCanDisplayInTheEvaluatedSet {
+    OSMessagingController *controller = [OSMessagingController new];
+    NSMutableArray<NSDictionary *> *messagesJson = [[self messagesJsonWithCount:2] mutableCopy];
+    NSMutableDictionary *finished = [messagesJson[0] mutableCopy];
+    finished[@"id"] = @"finished";
+    finished[@"end_time"] = @"2000-01-01T00:00:00.000Z";
+    NSMutableDictionary *seen = [messagesJson[0] mutableCopy];
+    seen[@"id"] = @"seen_without_redisplay";
+    [seen removeObjectForKey:@"redisplay"];
+    [messagesJson addObjectsFromArray:@[finished, seen]];
+    [controller.stateStore addId:@"seen_without_redisplay" toSet:OSInAppMessageStateSetSeen];
+
+    controller.messages = [controller inAppMessagesFromJson:messagesJson];
+    [controller pruneDormantMessages];
+
+    XCTAssertEqualObjects([controller.messages valueForKey:@"messageId"], (@[@"message_0", @"message_1"]));
+    XCTAssertEqualObjects([NSSet setWithArray:[controller.dormantMessages valueForKey:@"messageId"]], ([NSSet setWithArray:@[@"finished", @"seen_without_redisplay"]]));
+}
+
+- (void)testHolding1000Messages_memory {
+    if (@available(iOS 13.0, *)) {
+        NSArray<NSDictionary *> *messagesJson = [self messagesJsonWithCount:1000];
+        OSMessagingController *controller = [OSMessagingController new];
+        [self measureWithMetrics:@[[XCTMemoryMetric new]] block:^{
+            controller.messages = [controller inAppMessagesFromJson:messagesJson];
+        }];
+    }
+}
+
+@end
@@ -0,0 +1,136 @@
+/**
+ * Modified MIT License
+ *
+ * Copyright 2024 OneSignal
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * 2. All copies of substantial portions of the Software may only be used in connection
+ * with services provided by OneSignal.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#import <XCTest/XCTest.h>
+#import <WebKit/WebKit.h>
+#import "OSInAppMessageView.h"
+#import "OSInAppMessageInternal.h"
+#import "OSInAppMessageNativeView.h"
+
+#define TEST_SAFE_AREA_INSETS @"{top: 47, bottom: 34, right: 0, left: 0}"
+
+@interface OSInAppMessageView (MessageViewTests)
+@property (strong, nonatomic, nullable) WKWebView *webView;
+@property (strong, nonatomic, nullable) OSInAppMessageNativeView *nativeView;
+@end
+
+// Records the HTML it is asked to load instead of loading it
+@interface HTMLRecordingWebView : WKWebView
+@property (strong, nonatomic, nullable) NSString *loadedHTML;
+@end
+
+@implementation HTMLRecordingWebView
+
+- (WKNavigation *)loadHTMLString:(NSString *)string baseURL:(NSURL *)baseURL {
+    self.loadedHTML = string;
+    return nil;
+}
+
+@end
+
+@interface FixedInsetsMessageView : OSInAppMessageView
+@end
+
+@implementation FixedInsetsMessageView
+
+- (NSString *)safeAreaInsetsObjectString {
+    return TEST_SAFE_AREA_INSETS;
+}
+
+@end
+
+@interface IAMMessageViewTests : XCTestCase
+
+@end
+
+@implementation IAMMessageViewTests
+
+- (FixedInsetsMessageView *)messageViewWithWebView:(HTMLRecordingWebView *)webView {
+    OSInAppMessageInternal *message = [OSInAppMessageInternal instanceWithJson:@{
+        @"id" : @"message",
+        @"variants" : @{@"all" : @{@"default" : @"variant_id"}},
+        @"triggers" : @[]
+    }];
+    FixedInsetsMessageView *messageView = [[FixedInsetsMessageView alloc] initWithMessage:message withScriptMessageHandler:nil];
+    messageView.webView = webView;
+    return messageView;
+}
+
+- (void)testLoadedHtmlContent_passesInsetsThroughAUserScriptAndLoadsTheHTMLUnmodified {
+    HTMLRecordingWebView *webView = [[HTMLRecordingWebView alloc] initWithFrame:CGRectZero configuration:[WKWebViewConfiguration new]];
+    FixedInsetsMessageView *messageView = [self messageViewWithWebView:webView];
+    [messageView setIsFullscreen:YES];
+    NSString *html = @"<html><body>Message</body></html>";
+
+    [messageView loadedHtmlContent:html withBaseURL:nil];
+
+    XCTAssertEqualObjects(webView.loadedHTML, html);
+    NSArray<WKUserScript *> *scripts = webView.configuration.userContentController.userScripts;
+    XCTAssertEqual(scripts.count, 1);
+    XCTAssertEqualObjects(scripts[0].source, @"setSafeAreaInsets(" TEST_SAFE_AREA_INSETS @")");
+    XCTAssertEqual(scripts[0].injectionTime, WKUserScriptInjectionTimeAtDocumentEnd);
+    XCTAssertTrue(scripts[0].isForMainFrameOnly);
+
+    // Loading again replaces the scripts of the previous load
+    [messageView loadedHtmlContent:html withBaseURL:nil];
+    XCTAssertEqual(webView.configuration.userContentController.userScripts.count, 1);
+}
+
+- (void)testLoadedHtmlContent_withoutFullscreenAddsNoInsets {
+    HTMLRecordingWebView *webView = [[HTMLRecordingWebView alloc] initWithFrame:CGRectZero configuration:[WKWebViewConfiguration new]];
+    FixedInsetsMessageView *messageView = [self messageViewWithWebView:webView];
+    [messageView setIsFullscreen:NO];
+
+    [messageView loadedHtmlContent:@"<html></html>" withBaseURL:nil];
+
+    for (WKUserScript *script in webView.configuration.userContentController.userScripts)
+        XCTAssertFalse([script.source hasPrefix:@"setSafeAreaInsets"]);
+}
+
+- (void)testSetupWebViewConstraints_withANativeViewPinsItOnce {
+    FixedInsetsMessageView *messageView = [self messageViewWithWebView:nil];
+    OSInAppMessageNativeLayout *layout = [OSInAppMessageNativeLayout instanceWithJson:@{
+        @"display_location" : @"center_modal",
+        @"title" : @"Sale",
+        @"buttons" : @[@{@"text" : @"Shop", @"action" : @{@"id" : @"shop", @"url" : @"https://onesignal.com", @"url_target" : @"browser"}}]
+    }];
+    messageView.nativeView = [[OSInAppMessageNativeView alloc] initWithLayout:layout];
+    [messageView addSubview:messageView.nativeView];
+
+    // Resizes and rotations set up the constraints again
+    for (int i = 0; i < 3; i++)
+        [messageView setupWebViewConstraints];
+
+    NSUInteger nativeViewConstraintCount = 0;
+    for (NSLayoutConstraint *constraint in messageView.constraints)
+        if (constraint.firstItem == messageView.nativeView && constraint.active)
+            nativeViewConstraintCount++;
+    XCTAssertEqual(nativeViewConstraintCount, 4);
+}
+
+@end
@@ -0,0 +1,83 @@
+/**
+ * Modified MIT License
+ *
+ * Copyright 2024 OneSignal
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * 2. All copies of substantial portions of the Software may only be used in connection
+ * with services provided by OneSignal.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#import <XCTest/XCTest.h>
+#import "OSInAppMessageNativeLayout.h"
+
+@interface IAMNativeLayoutTests : XCTestCase
+
+@end
+
+@implementation IAMNativeLayoutTests
+
+- (NSDictionary *)imageAndButtonLayout {
+    return @{
+        @"display_location" : @"center_modal",
+        @"background_color" : @"#FFFFFF",
+        @"image" : @{@"url" : @"https://media.onesignal.com/image.png", @"aspect_ratio" : @1.5},
+        @"title" : @"Sale",
+        @"buttons" : @[@{@"text" : @"Shop", @"background_color" : @"#1E88E5CC", @"action" : @{@"id" : @"shop", @"url" : @"https://onesignal.com", @"url_target" : @"browser"}}],
+        @"page_id" : @"page_1"
+    };
+}
+
+- (void)testNativeLayout_parsesTheSupportedSubset {
+    OSInAppMessageNativeLayout *layout = [OSInAppMessageNativeLayout instanceWithJson:[self imageAndButtonLayout]];
+
+    XCTAssertNotNil(layout);
+    XCTAssertEqual(layout.displayLocation, OSInAppMessageDisplayPositionCenterModal);
+    XCTAssertEqualObjects(layout.imageUrl.absoluteString, @"https://media.onesignal.com/image.png");
+    XCTAssertEqual(layout.imageAspectRatio, 1.5);
+    XCTAssertEqualObjects(layout.pageId, @"page_1");
+    XCTAssertEqual(layout.buttons.count, 1);
+    XCTAssertEqualObjects(layout.buttons[0].action.clickId, @"shop");
+    XCTAssertEqualObjects(layout.buttons[0].action.clickType, @"button");
+    CGFloat alpha;
+    [layout.buttons[0].backgroundColor getRed:nil green:nil blue:nil alpha:&alpha];
+    XCTAssertEqualWithAccuracy(alpha, 0.8, 0.01);
+}
+
+- (void)testNativeLayout_rejectsAnythingRicherSoTheHTMLIsUsed {
+    NSMutableDictionary *unknownElement = [[self imageAndButtonLayout] mutableCopy];
+    unknownElement[@"video"] = @{@"url" : @"https://media.onesignal.com/video.mp4"};
+    XCTAssertNil([OSInAppMessageNativeLayout instanceWithJson:unknownElement]);
+
+    NSMutableDictionary *replacement = [[self imageAndButtonLayout] mutableCopy];
+    replacement[@"buttons"] = @[@{@"text" : @"Next", @"action" : @{@"id" : @"next", @"url" : @"https://onesignal.com", @"url_target" : @"replacement"}}];
+    XCTAssertNil([OSInAppMessageNativeLayout instanceWithJson:replacement]);
+
+    NSMutableDictionary *badColor = [[self imageAndButtonLayout] mutableCopy];
+    badColor[@"background_color"] = @"white";
+    XCTAssertNil([OSInAppMessageNativeLayout instanceWithJson:badColor]);
+
+    NSMutableDictionary *noAction = [[self imageAndButtonLayout] mutableCopy];
+    [noAction removeObjectForKey:@"buttons"];
+    XCTAssertNil([OSInAppMessageNativeLayout instanceWithJson:noAction]);
+}
+
+@end
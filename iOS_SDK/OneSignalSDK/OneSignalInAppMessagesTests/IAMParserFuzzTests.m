@@ -0,0 +1,216 @@
+/**
+ * Modified MIT License
+ *
+ * Copyright 2024 OneSignal
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * 2. All copies of substantial portions of the Software may only be used in connection
+ * with services provided by OneSignal.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#import <XCTest/XCTest.h>
+#import "OSMemoryFootprint.h"
+#import "OSInAppMessageInternal.h"
+#import "OSInAppMessageBridgeEvent.h"
+#import "OSInAppMessagingDefines.h"
+
+/*
+ Worst case inputs for the parsers of server and JS bridge JSON: deep nesting, huge trigger arrays, giant strings
+ and values of the wrong type, placed at random in otherwise valid messages and events.
+ Runs are seeded so a failure reproduces. Each input must parse, or be rejected, within the time budget,
+ and a whole run must stay within the memory budget.
+ */
+#define OS_FUZZ_SEED 0x5eed
+#define OS_FUZZ_ITERATIONS 200
+#define OS_FUZZ_PARSE_BUDGET_SECONDS 0.25
+#define OS_FUZZ_MEMORY_BUDGET (64 * 1024 * 1024)
+#define OS_FUZZ_NESTING_DEPTH 500
+#define OS_FUZZ_GIANT_STRING_LENGTH (1024 * 1024)
+#define OS_FUZZ_HUGE_ARRAY_COUNT 100000
+
+@interface IAMParserFuzzTests : XCTestCase
+
+@end
+
+@implementation IAMParserFuzzTests {
+    uint64_t state;
+}
+
+- (void)setUp {
+    state = OS_FUZZ_SEED;
+}
+
+// xorshift64, so the inputs are the same on every run
+- (uint64_t)nextRandom {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return state;
+}
+
+- (NSUInteger)randomBelow:(NSUInteger)bound {
+    return (NSUInteger)([self nextRandom] % bound);
+}
+
+- (NSDictionary *)nestedDictionaryWithDepth:(NSUInteger)depth {
+    NSDictionary *nested = @{@"leaf" : @"value"};
+    for (NSUInteger i = 0; i < depth; i++)
+        nested = @{@"nested" : nested};
+    return nested;
+}
+
+- (NSString *)giantString {
+    return [@"" stringByPaddingToLength:OS_FUZZ_GIANT_STRING_LENGTH withString:@"éx" startingAtIndex:0];
+}
+
+- (NSArray *)hugeArrayOf:(id)element {
+    NSMutableArray *array = [NSMutableArray arrayWithCapacity:OS_FUZZ_HUGE_ARRAY_COUNT];
+    for (NSUInteger i = 0; i < OS_FUZZ_HUGE_ARRAY_COUNT; i++)
+        [array addObject:element];
+    return array;
+}
+
+- (NSDictionary *)triggerJson {
+    return @{@"id" : @"trigger", @"kind" : OS_DYNAMIC_TRIGGER_KIND_CUSTOM, @"property" : @"level", @"operator" : @"greater", @"value" : @1};
+}
+
+// A pathological value to put in place of a field, built fresh so large ones don't outlive the iteration
+- (id)pathologicalValue {
+    switch ([self randomBelow:9]) {
+        case 0: return [self nestedDictionaryWithDepth:OS_FUZZ_NESTING_DEPTH];
+        case 1: return [self giantString];
+        case 2: return [self hugeArrayOf:@"element"];
+        case 3: return [self hugeArrayOf:[self triggerJson]];
+        case 4: return @[[self hugeArrayOf:[self triggerJson]]];
+        case 5: return [NSNull null];
+        case 6: return @(-1);
+        case 7: return @[@"not a list", @{@"not" : @"a list"}, @[@"not a trigger"]];
+        default: return @{};
+    }
+}
+
+- (NSMutableDictionary *)validMessageJson {
+    return [@{
+        @"id" : @"message",
+        @"variants" : @{@"ios" : @{@"default" : @"variant"}, @"all" : @{@"en" : @"variant_en"}},
+        @"triggers" : @[@[[self triggerJson]]],
+        @"redisplay" : @{@"limit" : @10, @"delay" : @60},
+        @"end_time" : @"2099-01-01T00:00:00.000Z"
+    } mutableCopy];
+}
+
+- (NSMutableDictionary *)validBridgeEventJson {
+    NSArray *types = OS_BRIDGE_EVENT_TYPES;
+    return [@{
+        @"type" : types[[self randomBelow:types.count]],
+        @"displayLocation" : @"center_modal",
+        @"dragToDismissDisabled" : @NO,
+        @"pageMetaData" : @{@"rect" : @{@"height" : @300}},
+        @"pageId" : @"page",
+        @"pageIndex" : @0,
+        @"body" : [@{
+            @"id" : @"click",
+            @"name" : @"action",
+            @"url" : @"https://onesignal.com",
+            @"url_target" : @"browser",
+            @"close" : @YES,
+            @"outcomes" : @[@{@"name" : @"outcome", @"weight" : @1, @"unique" : @NO}],
+            @"tags" : @{@"adds" : @{@"key" : @"value"}, @"removes" : @[@"key"]},
+            @"prompts" : @[@"push", @"location"]
+        } mutableCopy]
+    } mutableCopy];
+}
+
+// Replaces one to three fields, at the top level or one level down, with pathological values
+- (void)mutateJson:(NSMutableDictionary *)json {
+    NSUInteger mutations = 1 + [self randomBelow:3];
+    for (NSUInteger i = 0; i < mutations; i++) {
+        NSMutableDictionary *target = json;
+        NSArray *mutableChildren = [[json allValues] filteredArrayUsingPredicate:[NSPredicate predicateWithBlock:^BOOL(id value, NSDictionary *bindings) {
+            return [value isKindOfClass:[NSMutableDictionary class]];
+        }]];
+        if (mutableChildren.count > 0 && [self randomBelow:2] == 0)
+            target = mutableChildren[[self randomBelow:mutableChildren.count]];
+        NSArray *keys = [target.allKeys sortedArrayUsingSelector:@selector(compare:)];
+        target[keys[[self randomBelow:keys.count]]] = [self pathologicalValue];
+    }
+}
+
+- (void)assertParsing:(void (^)(void))parse within:(NSTimeInterval)budget input:(NSUInteger)input {
+    NSTimeInterval start = NSProcessInfo.processInfo.systemUptime;
+    parse();
+    NSTimeInterval elapsed = NSProcessInfo.processInfo.systemUptime - start;
+    XCTAssertLessThanOrEqual(elapsed, budget, @"Input %lu (seed %d) took %.3fs to parse", (unsigned long)input, OS_FUZZ_SEED, elapsed);
+}
+
+- (void)testFuzzingMessageJson_parsesWithinBudgets {
+    uint64_t before = OSPhysicalFootprint();
+    for (NSUInteger i = 0; i < OS_FUZZ_ITERATIONS; i++) {
+        @autoreleasepool {
+            NSMutableDictionary *json = [self validMessageJson];
+            [self mutateJson:json];
+            [self assertParsing:^{
+                [OSInAppMessageInternal instanceWithJson:json];
+            } within:OS_FUZZ_PARSE_BUDGET_SECONDS input:i];
+        }
+    }
+    uint64_t after = OSPhysicalFootprint();
+    XCTAssertLessThanOrEqual(after > before ? after - before : 0, OS_FUZZ_MEMORY_BUDGET);
+}
+
+- (void)testFuzzingBridgeEventJson_parsesWithinBudgets {
+    uint64_t before = OSPhysicalFootprint();
+    for (NSUInteger i = 0; i < OS_FUZZ_ITERATIONS; i++) {
+        @autoreleasepool {
+            NSMutableDictionary *json = [self validBridgeEventJson];
+            [self mutateJson:json];
+            [self assertParsing:^{
+                [OSInAppMessageBridgeEvent instanceWithScriptMessageBody:json];
+            } within:OS_FUZZ_PARSE_BUDGET_SECONDS input:i];
+            // The string form is what the web view posts, it takes the JSON decoding path
+            NSData *data = [NSJSONSerialization isValidJSONObject:json] ? [NSJSONSerialization dataWithJSONObject:json options:0 error:nil] : nil;
+            if (data) {
+                NSString *body = [[NSString alloc] initWithData:data encoding:NSUTF8StringEncoding];
+                [self assertParsing:^{
+                    [OSInAppMessageBridgeEvent instanceWithScriptMessageBody:body];
+                } within:OS_FUZZ_PARSE_BUDGET_SECONDS input:i];
+            }
+        }
+    }
+    uint64_t after = OSPhysicalFootprint();
+    XCTAssertLessThanOrEqual(after > before ? after - before : 0, OS_FUZZ_MEMORY_BUDGET);
+}
+
+- (void)testMessageWithTooManyTriggers_isRejected {
+    NSMutableDictionary *json = [self validMessageJson];
+    json[@"triggers"] = @[[self hugeArrayOf:[self triggerJson]]];
+    XCTAssertNil([OSInAppMessageInternal instanceWithJson:json]);
+}
+
+- (void)testMessageWithMalformedTriggerLists_isRejected {
+    NSMutableDictionary *json = [self validMessageJson];
+    json[@"triggers"] = @[@"not a list"];
+    XCTAssertNil([OSInAppMessageInternal instanceWithJson:json]);
+    json[@"triggers"] = @[@[@"not a trigger"]];
+    XCTAssertNil([OSInAppMessageInternal instanceWithJson:json]);
+}
+
+@end
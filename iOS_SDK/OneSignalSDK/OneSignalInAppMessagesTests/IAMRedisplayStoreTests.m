@@ -0,0 +1,99 @@
+/**
+ * Modified MIT License
+ *
+ * Copyright 2024 OneSignal
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * 2. All copies of substantial portions of the Software may only be used in connection
+ * with services provided by OneSignal.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#import <XCTest/XCTest.h>
+#import <OneSignalCore/OneSignalCore.h>
+#import "OSInAppMessageInternal.h"
+#import "OSInAppMessagingDefines.h"
+#import "OSInAppMessageRedisplayStore.h"
+
+@interface IAMRedisplayStoreTests : XCTestCase
+
+@end
+
+@implementation IAMRedisplayStoreTests
+
+- (void)setUp {
+    [OneSignalUserDefaults.initStandard removeValueForKey:OS_IAM_REDISPLAY_STATS_KEY];
+    [OneSignalUserDefaults.initStandard removeValueForKey:OS_IAM_REDISPLAY_DICTIONARY];
+}
+
+- (void)tearDown {
+    [self setUp];
+}
+
+// Archives a message the way earlier versions saved it for redisplay
+- (void)saveLegacyMessageWithId:(NSString *)messageId displayQuantity:(NSInteger)displayQuantity lastDisplayTime:(double)lastDisplayTime {
+    OSInAppMessageInternal *message = [OSInAppMessageInternal instanceWithJson:@{
+        @"id" : messageId,
+        @"variants" : @{@"all" : @{@"default" : @"variant_id"}},
+        @"triggers" : @[],
+        @"redisplay" : @{@"limit" : @10, @"delay" : @60}
+    }];
+    message.displayStats.displayQuantity = displayQuantity;
+    message.displayStats.lastDisplayTime = lastDisplayTime;
+    [OneSignalUserDefaults.initStandard saveCodeableDataForKey:OS_IAM_REDISPLAY_DICTIONARY withValue:@{messageId : message}];
+}
+
+- (void)testLegacyArchive_isReadAndKeptForARollback {
+    [self saveLegacyMessageWithId:@"legacy" displayQuantity:3 lastDisplayTime:100];
+
+    OSInAppMessageRedisplayStore *store = [OSInAppMessageRedisplayStore new];
+    XCTAssertTrue([store containsMessageId:@"legacy"]);
+    XCTAssertEqual([store displayQuantityForMessageId:@"legacy"], 3);
+    XCTAssertEqual([store lastDisplayTimeForMessageId:@"legacy"], 100);
+
+    [store flush];
+    XCTAssertNotNil([OneSignalUserDefaults.initStandard getSavedCodeableDataForKey:OS_IAM_REDISPLAY_DICTIONARY defaultValue:nil]);
+    NSDictionary *records = [OneSignalUserDefaults.initStandard getSavedDictionaryForKey:OS_IAM_REDISPLAY_STATS_KEY defaultValue:nil];
+    XCTAssertEqualObjects(records[@"legacy"], (@[@3, @100]));
+}
+
+- (void)testLegacyArchive_doesNotReplaceANewerRecord {
+    OSInAppMessageRedisplayStore *store = [OSInAppMessageRedisplayStore new];
+    [store setDisplayQuantity:5 lastDisplayTime:200 forMessageId:@"message"];
+    [store flush];
+    [self saveLegacyMessageWithId:@"message" displayQuantity:3 lastDisplayTime:100];
+
+    OSInAppMessageRedisplayStore *reloaded = [OSInAppMessageRedisplayStore new];
+    XCTAssertEqual([reloaded displayQuantityForMessageId:@"message"], 5);
+    XCTAssertEqual([reloaded lastDisplayTimeForMessageId:@"message"], 200);
+}
+
+- (void)testLegacyArchive_recordsADisplayMadeAfterARollback {
+    OSInAppMessageRedisplayStore *store = [OSInAppMessageRedisplayStore new];
+    [store setDisplayQuantity:1 lastDisplayTime:100 forMessageId:@"message"];
+    [store flush];
+    // The previous version displayed the message again
+    [self saveLegacyMessageWithId:@"message" displayQuantity:2 lastDisplayTime:300];
+
+    OSInAppMessageRedisplayStore *reloaded = [OSInAppMessageRedisplayStore new];
+    XCTAssertEqual([reloaded displayQuantityForMessageId:@"message"], 2);
+    XCTAssertEqual([reloaded lastDisplayTimeForMessageId:@"message"], 300);
+}
+
+@end
@@ -0,0 +1,132 @@
+/**
+ * Modified MIT License
+ *
+ * Copyright 2024 OneSignal
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * 2. All copies of substantial portions of the Software may only be used in connection
+ * with services provided by OneSignal.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#import <XCTest/XCTest.h>
+#import <OneSignalCore/OneSignalCore.h>
+#import "OSInAppMessagingDefines.h"
+#import "OSInAppMessageStateStore.h"
+#import "OSInAppMessageTelemetryBuffer.h"
+
+@interface OSInAppMessageTelemetryBuffer (TelemetryBufferTests)
+@property (strong, nonatomic, nonnull) NSMutableArray<NSDictionary *> *events;
+- (void)uploadWithAppId:(NSString *)appId subscriptionId:(NSString *)subscriptionId;
+- (void)completeEvent:(NSDictionary *)event;
+@end
+
+// Records the events it would send instead of sending them
+@interface RecordingTelemetryBuffer : OSInAppMessageTelemetryBuffer
+@property (strong, nonatomic, nonnull) NSMutableArray<NSDictionary *> *sentEvents;
+@end
+
+@implementation RecordingTelemetryBuffer
+
+- (void)sendEvent:(NSDictionary *)event appId:(NSString *)appId subscriptionId:(NSString *)subscriptionId {
+    if (!self.sentEvents)
+        self.sentEvents = [NSMutableArray new];
+    [self.sentEvents addObject:event];
+}
+
+@end
+
+@interface IAMTelemetryBufferTests : XCTestCase
+
+@end
+
+@implementation IAMTelemetryBufferTests
+
+- (void)setUp {
+    [OneSignalUserDefaults.initStandard removeValueForKey:OS_IAM_TELEMETRY_BUFFER_KEY];
+}
+
+- (void)tearDown {
+    [self setUp];
+}
+
+- (void)testRecordedEvent_withoutVariantHasNoVariantId {
+    RecordingTelemetryBuffer *buffer = [[RecordingTelemetryBuffer alloc] initWithStateStore:[OSInAppMessageStateStore new]];
+
+    [buffer recordImpressionForMessageId:@"message" variantId:nil];
+    [buffer recordClickForMessageId:@"message" variantId:@"variant" clickId:@"click" firstClick:YES];
+
+    XCTAssertNil(buffer.events[0][@"variant_id"]);
+    XCTAssertEqualObjects(buffer.events[1][@"variant_id"], @"variant");
+}
+
+- (void)testUpload_sendsEachEventOnceUntilItCompletes {
+    RecordingTelemetryBuffer *buffer = [[RecordingTelemetryBuffer alloc] initWithStateStore:[OSInAppMessageStateStore new]];
+    [buffer recordImpressionForMessageId:@"message" variantId:@"variant"];
+    [buffer recordPageImpressionForMessageId:@"message" variantId:@"variant" pageId:@"page"];
+
+    // Nothing is sent before the push subscription exists
+    [buffer uploadWithAppId:@"app" subscriptionId:nil];
+    XCTAssertEqual(buffer.sentEvents.count, 0);
+
+    [buffer uploadWithAppId:@"app" subscriptionId:@"subscription"];
+    XCTAssertEqual(buffer.sentEvents.count, 2);
+
+    // Events being sent are not sent again by the next upload
+    [buffer uploadWithAppId:@"app" subscriptionId:@"subscription"];
+    XCTAssertEqual(buffer.sentEvents.count, 2);
+
+    [buffer completeEvent:buffer.sentEvents[0]];
+    XCTAssertEqual(buffer.events.count, 1);
+    NSArray *persisted = [OneSignalUserDefaults.initStandard getSavedCodeableDataForKey:OS_IAM_TELEMETRY_BUFFER_KEY defaultValue:nil];
+    XCTAssertEqualObjects(persisted, @[buffer.sentEvents[1]]);
+}
+
+- (void)testRecordedEvents_areCappedDroppingTheOldestDedupId {
+    OSInAppMessageStateStore *stateStore = [OSInAppMessageStateStore new];
+    RecordingTelemetryBuffer *buffer = [[RecordingTelemetryBuffer alloc] initWithStateStore:stateStore];
+
+    for (int i = 0; i <= OS_IAM_TELEMETRY_BUFFER_LIMIT; i++) {
+        NSString *messageId = [NSString stringWithFormat:@"message_%d", i];
+        [stateStore addId:messageId toSet:OSInAppMessageStateSetImpressioned];
+        [buffer recordImpressionForMessageId:messageId variantId:nil];
+    }
+
+    XCTAssertEqual(buffer.events.count, OS_IAM_TELEMETRY_BUFFER_LIMIT);
+    XCTAssertEqualObjects(buffer.events.firstObject[@"message_id"], @"message_1");
+    // The dropped impression can be tracked again the next time the message displays
+    XCTAssertFalse([stateStore containsId:@"message_0" inSet:OSInAppMessageStateSetImpressioned]);
+    XCTAssertTrue([stateStore containsId:@"message_1" inSet:OSInAppMessageStateSetImpressioned]);
+}
+
+- (void)testRecordedEvents_arePersistedUntilSent {
+    RecordingTelemetryBuffer *buffer = [[RecordingTelemetryBuffer alloc] initWithStateStore:[OSInAppMessageStateStore new]];
+    [buffer recordClickForMessageId:@"message" variantId:@"variant" clickId:@"click" firstClick:NO];
+
+    // A new launch loads the events that were not sent
+    RecordingTelemetryBuffer *relaunched = [[RecordingTelemetryBuffer alloc] initWithStateStore:[OSInAppMessageStateStore new]];
+    XCTAssertEqualObjects(relaunched.events, buffer.events);
+
+    [relaunched uploadWithAppId:@"app" subscriptionId:@"subscription"];
+    XCTAssertEqual(relaunched.sentEvents.count, 1);
+    XCTAssertEqualObjects(relaunched.sentEvents[0][@"click_id"], @"click");
+}
+
+@end
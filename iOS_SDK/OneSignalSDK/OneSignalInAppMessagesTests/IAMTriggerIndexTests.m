@@ -0,0 +1,113 @@
+/**
+ * Modified MIT License
+ *
+ * Copyright 2024 OneSignal
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * 2. All copies of substantial portions of the Software may only be used in connection
+ * with services provided by OneSignal.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#import <XCTest/XCTest.h>
+#import "OSTriggerController.h"
+#import "OSInAppMessageInternal.h"
+#import "OSInAppMessagingDefines.h"
+#import "OSMessagingController.h"
+
+@interface OSIndexedInAppMessages : NSObject
+@property (strong, nonatomic, readonly, nonnull) NSArray <OSInAppMessageInternal *> *messages;
+@end
+
+@interface OSMessagingController (TriggerIndexTests)
+@property (strong, nonatomic, nonnull) NSArray <OSInAppMessageInternal *> *messages;
+@property (strong, atomic, nonnull) OSIndexedInAppMessages *indexedMessages;
+- (NSArray<OSInAppMessageInternal *> *)messagesWithTriggerKeys:(NSArray<NSString *> *)triggerKeys;
+@end
+
+@interface IAMTriggerIndexTests : XCTestCase
+
+@end
+
+@implementation IAMTriggerIndexTests
+
+- (OSInAppMessageInternal *)messageWithId:(NSString *)messageId triggers:(NSArray *)triggers {
+    return [OSInAppMessageInternal instanceWithJson:@{
+        @"id" : messageId,
+        @"variants" : @{@"ios" : @{@"default" : @"variant"}},
+        @"triggers" : triggers
+    }];
+}
+
+- (void)testTriggerKeyIndex_agreesWithSharedTriggers {
+    OSTriggerController *triggerController = [OSTriggerController new];
+    NSArray<OSInAppMessageInternal *> *messages = @[
+        [self messageWithId:@"level" triggers:@[@[
+            @{@"id" : @"level_trigger", @"kind" : OS_DYNAMIC_TRIGGER_KIND_CUSTOM, @"property" : @"level", @"operator" : @"greater", @"value" : @1}
+        ]]],
+        [self messageWithId:@"level_or_plan" triggers:@[
+            @[@{@"id" : @"level_trigger", @"kind" : OS_DYNAMIC_TRIGGER_KIND_CUSTOM, @"property" : @"level", @"operator" : @"greater", @"value" : @5}],
+            @[@{@"id" : @"plan_trigger", @"kind" : OS_DYNAMIC_TRIGGER_KIND_CUSTOM, @"property" : @"plan", @"operator" : @"equal", @"value" : @"pro"}]
+        ]],
+        [self messageWithId:@"session" triggers:@[@[
+            @{@"id" : @"session_trigger", @"kind" : OS_DYNAMIC_TRIGGER_KIND_SESSION_TIME, @"operator" : @"greater", @"value" : @30}
+        ]]],
+        [self messageWithId:@"no_triggers" triggers:@[]]
+    ];
+
+    NSDictionary<NSString *, NSIndexSet *> *index = [triggerController triggerKeyIndexForMessages:messages];
+
+    NSMutableIndexSet *levelIndexes = [NSMutableIndexSet indexSetWithIndex:0];
+    [levelIndexes addIndex:1];
+    XCTAssertEqualObjects(index[@"level"], levelIndexes);
+    XCTAssertEqualObjects(index[@"plan"], [NSIndexSet indexSetWithIndex:1]);
+    // Dynamic triggers are indexed by their id
+    XCTAssertEqualObjects(index[@"session_trigger"], [NSIndexSet indexSetWithIndex:2]);
+    XCTAssertNil(index[@"missing"]);
+
+    for (NSString *key in @[@"level", @"plan", @"session_trigger", @"level_trigger", @"missing"]) {
+        for (NSUInteger i = 0; i < messages.count; i++) {
+            XCTAssertEqual([index[key] containsIndex:i], [triggerController hasSharedTriggers:messages[i] newTriggersKeys:@[key]], @"%@ for message %lu", key, (unsigned long)i);
+        }
+    }
+}
+
+- (void)testMessagesWithTriggerKeys_readsTheMessagesAndTheIndexTheyWereBuiltWith {
+    OSMessagingController *controller = [OSMessagingController new];
+    OSInAppMessageInternal *level = [self messageWithId:@"level" triggers:@[@[
+        @{@"id" : @"level_trigger", @"kind" : OS_DYNAMIC_TRIGGER_KIND_CUSTOM, @"property" : @"level", @"operator" : @"greater", @"value" : @1}
+    ]]];
+    OSInAppMessageInternal *plan = [self messageWithId:@"plan" triggers:@[@[
+        @{@"id" : @"plan_trigger", @"kind" : OS_DYNAMIC_TRIGGER_KIND_CUSTOM, @"property" : @"plan", @"operator" : @"equal", @"value" : @"pro"}
+    ]]];
+    controller.messages = @[level, plan];
+    OSIndexedInAppMessages *first = controller.indexedMessages;
+
+    XCTAssertEqualObjects([controller messagesWithTriggerKeys:@[@"plan"]], @[plan]);
+
+    // Replacing the messages swaps in a new list and index, the one already read is unchanged
+    controller.messages = @[plan];
+    XCTAssertNotEqual(controller.indexedMessages, first);
+    XCTAssertEqualObjects(first.messages, (@[level, plan]));
+    XCTAssertEqualObjects([controller messagesWithTriggerKeys:@[@"plan"]], @[plan]);
+    XCTAssertEqualObjects([controller messagesWithTriggerKeys:@[@"level"]], @[]);
+}
+
+@end
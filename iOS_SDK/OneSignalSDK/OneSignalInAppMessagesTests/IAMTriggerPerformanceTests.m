@@ -0,0 +1,133 @@
+/**
+ * Modified MIT License
+ *
+ * Copyright 2024 OneSignal
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * 2. All copies of substantial portions of the Software may only be used in connection
+ * with services provided by OneSignal.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#import <XCTest/XCTest.h>
+#import "OSTriggerController.h"
+#import "OSMessagingController.h"
+#import "OSInAppMessageInternal.h"
+#import "OSInAppMessagingDefines.h"
+
+/**
+ Benchmarks of evaluating every message's triggers, as OSMessagingController does on each trigger change.
+ Each message has two OR'd groups of custom triggers, and half of the messages match.
+ */
+@interface OSMessagingController (TriggerPerformanceTests)
+@property (strong, nonatomic, nonnull) OSTriggerController *triggerController;
+- (BOOL *)triggerMatchesForMessages:(NSArray<OSInAppMessageInternal *> *)messages;
+@end
+
+@interface IAMTriggerPerformanceTests : XCTestCase
+
+@end
+
+@implementation IAMTriggerPerformanceTests {
+    OSTriggerController *triggerController;
+}
+
+- (void)setUp {
+    triggerController = [OSTriggerController new];
+    [triggerController addTriggers:@{@"level" : @5, @"plan" : @"pro"}];
+}
+
+- (void)tearDown {
+    [triggerController removeTriggersForKeys:@[@"level", @"plan"]];
+}
+
+- (NSArray<OSInAppMessageInternal *> *)messagesWithCount:(NSUInteger)count {
+    NSMutableArray<OSInAppMessageInternal *> *messages = [NSMutableArray arrayWithCapacity:count];
+    for (NSUInteger i = 0; i < count; i++) {
+        NSDictionary *json = @{
+            @"id" : [NSString stringWithFormat:@"message_%lu", (unsigned long)i],
+            @"variants" : @{@"ios" : @{@"default" : @"variant"}},
+            @"triggers" : @[
+                @[
+                    @{@"id" : @"level", @"kind" : OS_DYNAMIC_TRIGGER_KIND_CUSTOM, @"property" : @"level", @"operator" : @"greater", @"value" : @(i % 10)},
+                    @{@"id" : @"plan", @"kind" : OS_DYNAMIC_TRIGGER_KIND_CUSTOM, @"property" : @"plan", @"operator" : @"equal", @"value" : @"pro"}
+                ],
+                @[
+                    @{@"id" : @"missing", @"kind" : OS_DYNAMIC_TRIGGER_KIND_CUSTOM, @"property" : @"missing", @"operator" : @"exists"}
+                ]
+            ]
+        };
+        OSInAppMessageInternal *message = [OSInAppMessageInternal instanceWithJson:json];
+        XCTAssertNotNil(message);
+        [messages addObject:message];
+    }
+    return messages;
+}
+
+- (void)measureEvaluatingMessages:(NSUInteger)count {
+    NSArray<OSInAppMessageInternal *> *messages = [self messagesWithCount:count];
+    [self measureBlock:^{
+        NSUInteger matched = 0;
+        for (OSInAppMessageInternal *message in messages) {
+            if ([self->triggerController messageMatchesTriggers:message])
+                matched++;
+        }
+        XCTAssertEqual(matched, count / 2);
+    }];
+}
+
+- (void)testEvaluatingTriggersOf10Messages {
+    [self measureEvaluatingMessages:10];
+}
+
+- (void)testEvaluatingTriggersOf100Messages {
+    [self measureEvaluatingMessages:100];
+}
+
+- (void)testEvaluatingTriggersOf1000Messages {
+    [self measureEvaluatingMessages:1000];
+}
+
+// Matching in parallel, as OSMessagingController does for catalogs of OS_IAM_PARALLEL_EVALUATION_MIN_MESSAGES or more
+- (void)testEvaluatingTriggersOf1000MessagesConcurrently {
+    NSUInteger count = 1000;
+    XCTAssertGreaterThanOrEqual(count, OS_IAM_PARALLEL_EVALUATION_MIN_MESSAGES);
+    NSArray<OSInAppMessageInternal *> *messages = [self messagesWithCount:count];
+    OSMessagingController *messagingController = [OSMessagingController new];
+    messagingController.triggerController = triggerController;
+
+    // The parallel matches are the ones a message by message evaluation gives
+    BOOL *matches = [messagingController triggerMatchesForMessages:messages];
+    for (NSUInteger i = 0; i < count; i++)
+        XCTAssertEqual(matches[i], [triggerController messageMatchesTriggers:messages[i]]);
+    free(matches);
+
+    [self measureBlock:^{
+        BOOL *matches = [messagingController triggerMatchesForMessages:messages];
+        NSUInteger matched = 0;
+        for (NSUInteger i = 0; i < count; i++) {
+            if (matches[i])
+                matched++;
+        }
+        free(matches);
+        XCTAssertEqual(matched, count / 2);
+    }];
+}
+
+@end
@@ -0,0 +1,89 @@
+/**
+ * Modified MIT License
+ *
+ * Copyright 2024 OneSignal
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * 2. All copies of substantial portions of the Software may only be used in connection
+ * with services provided by OneSignal.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#import <XCTest/XCTest.h>
+#import "OSMessagingController.h"
+#import "OSInAppMessageInternal.h"
+#import "OSInAppMessageController.h"
+
+@interface OSMessagingController (VariantTests)
+- (NSArray<OSInAppMessageInternal *> *)inAppMessagesFromJson:(NSArray *)messagesJson;
+@end
+
+@interface IAMVariantTests : XCTestCase
+
+@end
+
+@implementation IAMVariantTests
+
+- (OSInAppMessageInternal *)parsedMessageWithDefaultVariant:(NSString *)variantId {
+    return [[OSMessagingController new] inAppMessagesFromJson:@[@{
+        @"id" : @"message_id",
+        @"variants" : @{@"all" : @{@"default" : variantId}},
+        @"triggers" : @[],
+        @"end_time" : @"2099-01-01T00:00:00.000Z"
+    }]].firstObject;
+}
+
+- (void)testParsing_resolvesTheVariantOnce {
+    OSInAppMessageInternal *message = [self parsedMessageWithDefaultVariant:@"variant_a"];
+    XCTAssertEqualObjects(message.resolvedVariant[1], @"variant_a");
+
+    // Later calls for the same language read the stored result
+    message.resolvedVariant = @[message.resolvedVariant[0], @"stored"];
+    XCTAssertEqualObjects([message variantId], @"stored");
+}
+
+- (void)testLanguageChange_resolvesTheVariantAgain {
+    OSInAppMessageInternal *message = [self parsedMessageWithDefaultVariant:@"variant_a"];
+    NSString *languageCode = message.resolvedVariant[0];
+
+    // Resolved for a language the user no longer has
+    message.resolvedVariant = @[@"zz", @"stored"];
+    XCTAssertEqualObjects([message variantId], @"variant_a");
+    XCTAssertEqualObjects(message.resolvedVariant, (@[languageCode, @"variant_a"]));
+}
+
+- (void)testNewVariants_clearTheResolvedVariant {
+    OSInAppMessageInternal *message = [self parsedMessageWithDefaultVariant:@"variant_a"];
+
+    message.variants = @{@"all" : @{@"default" : @"variant_b"}};
+    XCTAssertNil(message.resolvedVariant);
+    XCTAssertEqualObjects([message variantId], @"variant_b");
+}
+
+- (void)testMissingVariant_isStoredAsResolvedToo {
+    OSInAppMessageInternal *message = [self parsedMessageWithDefaultVariant:@"variant_a"];
+
+    message.variants = @{@"android" : @{@"default" : @"variant_b"}};
+    XCTAssertNil([message variantId]);
+    XCTAssertEqualObjects(message.resolvedVariant[1], @"");
+    XCTAssertNil([message variantId]);
+}
+
+@end
@@ -0,0 +1,120 @@
+/**
+ * Modified MIT License
+ *
+ * Copyright 2024 OneSignal
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * 2. All copies of substantial portions of the Software may only be used in connection
+ * with services provided by OneSignal.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#import <XCTest/XCTest.h>
+#import "OSMessagingController.h"
+#import "OSInAppMessageInternal.h"
+#import "OSInAppMessageViewController.h"
+
+@interface OSMessagingController (WindowTests)
+@property (strong, nonatomic, nullable) UIWindow *window;
+@property (strong, nullable) OSInAppMessageViewController *viewController;
+- (NSArray<OSInAppMessageInternal *> *)inAppMessagesFromJson:(NSArray *)messagesJson;
+- (void)cleanUpInAppWindow;
+- (void)purgeForMemoryPressure;
+@end
+
+// Stands in for the message's web view, the window is what is under test
+@interface PlainMessageViewController : OSInAppMessageViewController
+@end
+
+@implementation PlainMessageViewController
+- (void)loadView {
+    self.view = [UIView new];
+}
+@end
+
+@interface IAMWindowTests : XCTestCase
+@property (strong, nonatomic) OSMessagingController *controller;
+@property (strong, nonatomic) OSInAppMessageInternal *message;
+@end
+
+@implementation IAMWindowTests
+
+- (void)setUp {
+    self.controller = [OSMessagingController new];
+    self.message = [self.controller inAppMessagesFromJson:@[@{
+        @"id" : @"message_id",
+        @"variants" : @{@"all" : @{@"default" : [NSUUID UUID].UUIDString}},
+        @"triggers" : @[],
+        @"end_time" : @"2099-01-01T00:00:00.000Z"
+    }]].firstObject;
+    // Previews send no impression
+    self.message.isPreview = true;
+}
+
+- (void)tearDown {
+    [self.controller cleanUpInAppWindow];
+}
+
+// Shows the message the way the controller does once its content has loaded
+- (UIWindow *)displayMessage {
+    self.controller.viewController = [[PlainMessageViewController alloc] initWithMessage:self.message delegate:self.controller];
+    [self.controller webViewContentFinishedLoading:self.message];
+    return self.controller.window;
+}
+
+- (void)testDismissedMessage_hidesTheWindowAndReleasesItsViewController {
+    UIWindow *window = [self displayMessage];
+    XCTAssertNotNil(window);
+    XCTAssertFalse(window.hidden);
+
+    [self.controller cleanUpInAppWindow];
+
+    XCTAssertEqual(self.controller.window, window);
+    XCTAssertTrue(window.hidden);
+    XCTAssertNil(window.rootViewController);
+}
+
+- (void)testNextDisplay_reusesTheWindowAtFullScreen {
+    UIWindow *window = [self displayMessage];
+    // A banner shrinks the window to fit
+    window.frame = CGRectMake(0, 0, 100, 100);
+    [self.controller cleanUpInAppWindow];
+
+    XCTAssertEqual([self displayMessage], window);
+    XCTAssertTrue(CGRectEqualToRect(window.frame, [[UIScreen mainScreen] bounds]));
+    XCTAssertEqual(window.rootViewController, self.controller.viewController);
+    XCTAssertFalse(window.hidden);
+}
+
+- (void)testMemoryPressure_dropsOnlyAnIdleWindow {
+    UIWindow *window = [self displayMessage];
+    [self.controller purgeForMemoryPressure];
+    XCTAssertEqual(self.controller.window, window);
+
+    [self.controller cleanUpInAppWindow];
+    [self.controller purgeForMemoryPressure];
+    XCTAssertNil(self.controller.window);
+
+    // The next display creates it again
+    XCTAssertNotNil([self displayMessage]);
+    XCTAssertNotEqual(self.controller.window, window);
+}
+
+@end
@@ -11,19 +11,114 @@ import Foundation
  You can encode or decode mixed-type values in dictionaries
  and other collections that require `Encodable` or `Decodable` conformance
  by declaring their contained type to be `AnyCodable`.
+
+ JSON values are held as a tagged union rather than an `Any` box, so decoding maps each JSON type straight to a
+ case and encoding, comparing and the `as` accessors switch on the tag instead of casting through every type.
+ Values of any other type are kept as given in `other` and handled as before.
  */
 @frozen public struct AnyCodable: Codable {
-    public let value: Any
+    @usableFromInline
+    enum Storage {
+        case null
+        case bool(Bool)
+        case int(Int)
+        case double(Double)
+        case string(String)
+        case array([AnyCodable])
+        case dictionary([String: AnyCodable])
+        case other(Any)
+
+        init(_ value: Any) {
+            // Only exact Swift types are tagged, so a bridged NSNumber keeps its old casting behavior under `other`
+            switch value {
+            case is NSNull:
+                self = .null
+            case let bool as Bool where type(of: value) == Bool.self:
+                self = .bool(bool)
+            case let int as Int where type(of: value) == Int.self:
+                self = .int(int)
+            case let double as Double where type(of: value) == Double.self:
+                self = .double(double)
+            case let string as String where type(of: value) == String.self:
+                self = .string(string)
+            case let array as [AnyCodable]:
+                self = .array(array)
+            case let dictionary as [String: AnyCodable]:
+                self = .dictionary(dictionary)
+            default:
+                self = .other(value)
+            }
+        }
+    }
+
+    @usableFromInline
+    let storage: Storage
+
+    public var value: Any {
+        switch storage {
+        case .null:
+            return NSNull()
+        case .bool(let bool):
+            return bool
+        case .int(let int):
+            return int
+        case .double(let double):
+            return double
+        case .string(let string):
+            return string
+        case .array(let array):
+            return array
+        case .dictionary(let dictionary):
+            return dictionary
+        case .other(let value):
+            return value
+        }
+    }
+
+    public func asBool() -> Bool? {
+        if case .bool(let bool) = storage { return bool }
+        if case .other(let value) = storage { return value as? Bool }
+        return nil
+    }
+
+    public func asInt() -> Int? {
+        if case .int(let int) = storage { return int }
+        if case .other(let value) = storage { return value as? Int }
+        return nil
+    }
+
+    public func asDouble() -> Double? {
+        if case .double(let double) = storage { return double }
+        if case .other(let value) = storage { return value as? Double }
+        return nil
+    }
+
+    public func asString() -> String? {
+        if case .string(let string) = storage { return string }
+        if case .other(let value) = storage { return value as? String }
+        return nil
+    }
 
-    public func asBool() -> Bool? { return value as? Bool }
-    public func asInt() -> Int? { return value as? Int }
-    public func asDouble() -> Double? { return value as? Double }
-    public func asString() -> String? { return value as? String }
-    public func asArray() -> [AnyCodable]? { return value as? [AnyCodable] }
-    public func asDict() -> [String: AnyCodable]? { return value as? [String: AnyCodable] }
+    public func asArray() -> [AnyCodable]? {
+        if case .array(let array) = storage { return array }
+        return nil
+    }
+
+    public func asDict() -> [String: AnyCodable]? {
+        if case .dictionary(let dictionary) = storage { return dictionary }
+        return nil
+    }
+
+    init(storage: Storage) {
+        self.storage = storage
+    }
 
     public init<T>(_ value: T?) {
-        self.value = value ?? ()
+        if let value = value {
+            self.storage = Storage(value)
+        } else {
+            self.storage = .other(())
+        }
     }
 
     public init(nilLiteral _: ()) {
@@ -61,26 +156,23 @@ import Foundation
     public init(from decoder: Decoder) throws {
         let container = try decoder.singleValueContainer()
 
+        // Strings are tried first as they are the most common value in attribute and content-state payloads
         if container.decodeNil() {
-            #if canImport(Foundation)
-                self.init(NSNull())
-            #else
-                self.init(Optional<Self>.none)
-            #endif
+            self.init(storage: .null)
+        } else if let string = try? container.decode(String.self) {
+            self.init(storage: .string(string))
         } else if let bool = try? container.decode(Bool.self) {
-            self.init(bool)
+            self.init(storage: .bool(bool))
         } else if let int = try? container.decode(Int.self) {
-            self.init(int)
+            self.init(storage: .int(int))
         } else if let uint = try? container.decode(UInt.self) {
-            self.init(uint)
+            self.init(storage: .other(uint))
         } else if let double = try? container.decode(Double.self) {
-            self.init(double)
-        } else if let string = try? container.decode(String.self) {
-            self.init(string)
-        } else if let array = try? container.decode([AnyCodable].self) {
-            self.init(array)
+            self.init(storage: .double(double))
         } else if let dictionary = try? container.decode([String: AnyCodable].self) {
-            self.init(dictionary)
+            self.init(storage: .dictionary(dictionary))
+        } else if let array = try? container.decode([AnyCodable].self) {
+            self.init(storage: .array(array))
         } else {
             throw DecodingError.dataCorruptedError(in: container, debugDescription: "AnyCodable value cannot be decoded")
         }
@@ -91,6 +183,27 @@ import Foundation
     public func encode(to encoder: Encoder) throws {
         var container = encoder.singleValueContainer()
 
+        switch storage {
+        case .null:
+            try container.encodeNil()
+        case .bool(let bool):
+            try container.encode(bool)
+        case .int(let int):
+            try container.encode(int)
+        case .double(let double):
+            try container.encode(double)
+        case .string(let string):
+            try container.encode(string)
+        case .array(let array):
+            try container.encode(array)
+        case .dictionary(let dictionary):
+            try container.encode(dictionary)
+        case .other(let value):
+            try encode(other: value, into: &container, encoder: encoder)
+        }
+    }
+
+    private func encode(other value: Any, into container: inout SingleValueEncodingContainer, encoder: Encoder) throws {
         switch value {
         #if canImport(Foundation)
         case is NSNull:
@@ -181,7 +294,30 @@ import Foundation
 
 extension AnyCodable: Equatable {
     public static func == (lhs: AnyCodable, rhs: AnyCodable) -> Bool {
-        switch (lhs.value, rhs.value) {
+        switch (lhs.storage, rhs.storage) {
+        case (.null, .null):
+            return true
+        case let (.bool(lhs), .bool(rhs)):
+            return lhs == rhs
+        case let (.int(lhs), .int(rhs)):
+            return lhs == rhs
+        case let (.double(lhs), .double(rhs)):
+            return lhs == rhs
+        case let (.string(lhs), .string(rhs)):
+            return lhs == rhs
+        case let (.array(lhs), .array(rhs)):
+            return lhs == rhs
+        case let (.dictionary(lhs), .dictionary(rhs)):
+            return lhs == rhs
+        case (.other, _), (_, .other):
+            return equalValues(lhs.value, rhs.value)
+        default:
+            return false
+        }
+    }
+
+    private static func equalValues(_ lhs: Any, _ rhs: Any) -> Bool {
+        switch (lhs, rhs) {
 #if canImport(Foundation)
         case is (NSNull, NSNull), is (Void, Void):
             return true
@@ -267,6 +403,27 @@ extension AnyCodable: ExpressibleByDictionaryLiteral {}
 
 extension AnyCodable: Hashable {
     public func hash(into hasher: inout Hasher) {
+        switch storage {
+        case .null:
+            break
+        case .bool(let bool):
+            hasher.combine(bool)
+        case .int(let int):
+            hasher.combine(int)
+        case .double(let double):
+            hasher.combine(double)
+        case .string(let string):
+            hasher.combine(string)
+        case .array(let array):
+            hasher.combine(array)
+        case .dictionary(let dictionary):
+            hasher.combine(dictionary)
+        case .other(let value):
+            AnyCodable.hash(other: value, into: &hasher)
+        }
+    }
+
+    private static func hash(other value: Any, into hasher: inout Hasher) {
         switch value {
         case let value as Bool:
             hasher.combine(value)
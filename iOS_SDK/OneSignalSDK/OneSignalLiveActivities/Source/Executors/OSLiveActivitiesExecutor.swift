@@ -29,6 +29,81 @@ import OneSignalCore
 import OneSignalOSCore
 import OneSignalUser
 
+/**
+ Request keys ordered by timestamp, oldest first, so expired and over-limit requests are found with a binary search
+ instead of a scan of the whole cache.
+ */
+struct RequestExpiryIndex {
+    private var entries = [(timestamp: Date, key: String)]()
+    private var timestamps = [String: Date]()
+
+    var count: Int {
+        return entries.count
+    }
+
+    mutating func insert(_ key: String, timestamp: Date) {
+        remove(key)
+        // after any equal timestamps so insertion order is kept
+        var low = 0, high = entries.count
+        while low < high {
+            let mid = (low + high) / 2
+            if entries[mid].timestamp <= timestamp {
+                low = mid + 1
+            } else {
+                high = mid
+            }
+        }
+        entries.insert((timestamp, key), at: low)
+        timestamps[key] = timestamp
+    }
+
+    mutating func remove(_ key: String) {
+        guard let timestamp = timestamps.removeValue(forKey: key) else {
+            return
+        }
+        var index = firstIndex(notBefore: timestamp)
+        while index < entries.count && entries[index].key != key {
+            index += 1
+        }
+        if index < entries.count {
+            entries.remove(at: index)
+        }
+    }
+
+    /// Removes and returns the keys of every entry with a timestamp before `date`.
+    mutating func removeAll(before date: Date) -> [String] {
+        return removeOldest(firstIndex(notBefore: date))
+    }
+
+    /// Every key, oldest first.
+    var oldestKeys: [String] {
+        return entries.map { $0.key }
+    }
+
+    /// Removes and returns the keys of the `count` oldest entries.
+    mutating func removeOldest(_ count: Int) -> [String] {
+        let keys = entries.prefix(count).map { $0.key }
+        entries.removeFirst(keys.count)
+        for key in keys {
+            timestamps.removeValue(forKey: key)
+        }
+        return keys
+    }
+
+    private func firstIndex(notBefore date: Date) -> Int {
+        var low = 0, high = entries.count
+        while low < high {
+            let mid = (low + high) / 2
+            if entries[mid].timestamp < date {
+                low = mid + 1
+            } else {
+                high = mid
+            }
+        }
+        return low
+    }
+}
+
 /**
  A request cache keeps track of all the current update token or start token requests.  There can only be one request
  per OSLiveActivityRequest.key, and each request has either been successfully sent to OneSignal or hasn't.  Requests
@@ -36,31 +111,69 @@ import OneSignalUser
  token updates are called frequently with the same information.
  
  The cache is persisted to disk via the `cacheKey`, and items will remain in the cache until explicitely removed or
- it has existed past the `ttl` provided.
+ it has existed past the `ttl` provided. Each request is archived on its own and only re-archived when it changes,
+ so a save doesn't re-archive the whole cache.
+
+ The keys of requests not yet sent successfully are indexed in `pendingKeys`, so finding outstanding work doesn't
+ require scanning every cached request.
  
  WARNING: This cache is **not** thread safe, synchronization required!
  */
 class RequestCache {
-    var items: [String: OSLiveActivityRequest]
+    private(set) var items = [String: OSLiveActivityRequest]()
+    private(set) var pendingKeys = Set<String>()
+    private var archivedItems = [String: Data]()
+    private var expiryIndex = RequestExpiryIndex()
     private var cacheKey: String
     private var ttl: TimeInterval
 
-    init(cacheKey: String, ttl: TimeInterval) {
+    init(cacheKey: String, legacyCacheKey: String, ttl: TimeInterval) {
         self.cacheKey = cacheKey
         self.ttl = ttl
-        self.items = OneSignalUserDefaults.initShared()
-            .getSavedCodeableData(forKey: cacheKey, defaultValue: nil) as? [String: OSLiveActivityRequest] ?? [String: OSLiveActivityRequest]()
+        let sharedUserDefaults = OneSignalUserDefaults.initShared()
+        if let archivedItems = sharedUserDefaults.getSavedDictionary(forKey: cacheKey, defaultValue: nil) as? [String: Data] {
+            for (key, data) in archivedItems {
+                if let request = NSKeyedUnarchiver.unarchiveObject(with: data) as? OSLiveActivityRequest {
+                    self.items[key] = request
+                    self.archivedItems[key] = data
+                }
+            }
+        } else if let legacyItems = sharedUserDefaults.getSavedCodeableData(forKey: legacyCacheKey, defaultValue: nil) as? [String: OSLiveActivityRequest] {
+            // Earlier versions archived the whole cache as one object, move it over to per-request archives
+            for (key, request) in legacyItems {
+                self.items[key] = request
+                self.archivedItems[key] = NSKeyedArchiver.archivedData(withRootObject: request)
+            }
+            sharedUserDefaults.removeValue(forKey: legacyCacheKey)
+            self.save()
+        }
+        for (key, request) in self.items {
+            self.expiryIndex.insert(key, timestamp: request.timestamp)
+            if !request.requestSuccessful {
+                self.pendingKeys.insert(key)
+            }
+        }
         OneSignalLog.onesignalLog(.LL_VERBOSE, message: "OneSignal.LiveActivities initialized token cache \(self): \(items)")
     }
 
+    var pendingRequests: [OSLiveActivityRequest] {
+        return self.pendingKeys.compactMap { self.items[$0] }
+    }
+
     func add(_ request: OSLiveActivityRequest) {
-        self.items.updateValue(request, forKey: request.key)
+        self.store(request)
+        if request.requestSuccessful {
+            self.pendingKeys.remove(request.key)
+        } else {
+            self.pendingKeys.insert(request.key)
+        }
         self.save()
     }
 
     func remove(_ request: OSLiveActivityRequest) {
-        if self.items.contains(where: { $0.1 == request}) {
-            self.items.removeValue(forKey: request.key)
+        if self.items[request.key] == request {
+            self.expiryIndex.remove(request.key)
+            self.drop(request.key)
             self.save()
         }
     }
@@ -68,30 +181,74 @@ class RequestCache {
     func markAllUnsuccessful() {
         for (_, request) in self.items {
             request.requestSuccessful = false
+            self.archivedItems[request.key] = NSKeyedArchiver.archivedData(withRootObject: request)
         }
+        self.pendingKeys = Set(self.items.keys)
         self.save()
     }
 
     func markSuccessful(_ request: OSLiveActivityRequest) {
-        if self.items.contains(where: { $0.1 == request}) {
+        if self.items[request.key] == request {
             // Save the appropriate cache with the updated request for this request key.
             if request.shouldForgetWhenSuccessful {
-                self.items.removeValue(forKey: request.key)
+                self.expiryIndex.remove(request.key)
+                self.drop(request.key)
             } else {
                 request.requestSuccessful = true
+                self.archivedItems[request.key] = NSKeyedArchiver.archivedData(withRootObject: request)
+                self.pendingKeys.remove(request.key)
             }
             self.save()
         }
     }
 
+    private func store(_ request: OSLiveActivityRequest) {
+        self.items[request.key] = request
+        self.archivedItems[request.key] = NSKeyedArchiver.archivedData(withRootObject: request)
+        self.expiryIndex.insert(request.key, timestamp: request.timestamp)
+    }
+
+    private func drop(_ key: String) {
+        self.items.removeValue(forKey: key)
+        self.archivedItems.removeValue(forKey: key)
+        self.pendingKeys.remove(key)
+    }
+
+    // Maintenance, removes stale requests from a cache that has not been saved since they went stale
+    func removeStaleRequests() {
+        if self.dropStaleRequests() {
+            self.save()
+        }
+    }
+
+    private func dropStaleRequests() -> Bool {
+        let staleKeys = self.expiryIndex.removeAll(before: Date(timeIntervalSinceNow: -ttl))
+        for key in staleKeys {
+            OneSignalLog.onesignalLog(.LL_VERBOSE, message: "OneSignal.LiveActivities remove stale request from token cache \(self): \(key)")
+            self.drop(key)
+        }
+        return !staleKeys.isEmpty
+    }
+
     private func save() {
         // before saving, remove any stale requests from the cache.
-        for (_, request) in self.items where -request.timestamp.timeIntervalSinceNow > ttl {
-            OneSignalLog.onesignalLog(.LL_VERBOSE, message: "OneSignal.LiveActivities remove stale request from token cache \(self): \(request)")
-            self.items.removeValue(forKey: request.key)
+        _ = self.dropStaleRequests()
+        // Bound the cache. Requests already sent only save a redundant request, so the oldest of those are evicted before any pending one.
+        var overflow = self.expiryIndex.count - Int(OS_LIVE_ACTIVITIES_REQUEST_CACHE_LIMIT)
+        if overflow > 0 {
+            let sentKeys = self.expiryIndex.oldestKeys.filter { !self.pendingKeys.contains($0) }
+            let evictedKeys = Array(sentKeys.prefix(overflow))
+            overflow -= evictedKeys.count
+            for key in evictedKeys {
+                self.expiryIndex.remove(key)
+            }
+            for key in evictedKeys + self.expiryIndex.removeOldest(overflow) {
+                OneSignalLog.onesignalLog(.LL_WARN, message: "OneSignal.LiveActivities evicting request over the cache limit from token cache \(self): \(key)")
+                self.drop(key)
+            }
         }
-        OneSignalLog.onesignalLog(.LL_VERBOSE, message: "OneSignal.LiveActivities saving token cache \(self): \(items)")
-        OneSignalUserDefaults.initShared().saveCodeableData(forKey: self.cacheKey, withValue: self.items)
+        OneSignalLog.onesignalLog(.LL_VERBOSE, message: "OneSignal.LiveActivities saving token cache \(self) with \(archivedItems.count) requests")
+        OneSignalUserDefaults.initShared().saveDictionary(forKey: self.cacheKey, withValue: self.archivedItems)
     }
 }
 
@@ -100,7 +257,7 @@ class UpdateRequestCache: RequestCache {
     static let OneDayInSeconds = TimeInterval(60 * 60 * 24 * 365)
 
     init() {
-        super.init(cacheKey: OS_LIVE_ACTIVITIES_EXECUTOR_UPDATE_TOKENS_KEY, ttl: UpdateRequestCache.OneDayInSeconds)
+        super.init(cacheKey: OS_LIVE_ACTIVITIES_EXECUTOR_UPDATE_TOKEN_ENTRIES_KEY, legacyCacheKey: OS_LIVE_ACTIVITIES_EXECUTOR_UPDATE_TOKENS_KEY, ttl: UpdateRequestCache.OneDayInSeconds)
     }
 }
 
@@ -109,29 +266,53 @@ class StartRequestCache: RequestCache {
     static let OneYearInSeconds = TimeInterval(60 * 60 * 24 * 365)
 
     init() {
-        super.init(cacheKey: OS_LIVE_ACTIVITIES_EXECUTOR_START_TOKENS_KEY, ttl: StartRequestCache.OneYearInSeconds)
+        super.init(cacheKey: OS_LIVE_ACTIVITIES_EXECUTOR_START_TOKEN_ENTRIES_KEY, legacyCacheKey: OS_LIVE_ACTIVITIES_EXECUTOR_START_TOKENS_KEY, ttl: StartRequestCache.OneYearInSeconds)
     }
 }
 
 class OSLiveActivitiesExecutor: OSPushSubscriptionObserver {
-    // The currently tracked update and start tokens (key) and their associated request (value). THESE ARE NOT THREAD SAFE
+    // The currently tracked update and start tokens (key) and their associated request (value). Not thread safe, only accessed on `requestDispatch`.
     let updateTokens: UpdateRequestCache = UpdateRequestCache()
     let startTokens: StartRequestCache = StartRequestCache()
 
     // The live activities request dispatch queue, serial.  This synchronizes access to `updateTokens` and `startTokens`.
     private var requestDispatch: OSDispatchQueue
-    private var pollIntervalSeconds = 30
 
-    init(requestDispatch: OSDispatchQueue) {
+    // Failed attempts per request key since it was last appended, drives the backoff. Only accessed on `requestDispatch`.
+    private var retryAttempts = [String: Int]()
+    private let retryBaseDelay: TimeInterval
+    private let retryMaxDelay: TimeInterval
+
+    // Keys with a request waiting for the batch window to close, per cache. Only accessed on `requestDispatch`.
+    private var stagedKeys = [ObjectIdentifier: Set<String>]()
+    private var flushScheduled = false
+    private let batchWindow: TimeInterval
+
+    init(requestDispatch: OSDispatchQueue, retryBaseDelay: TimeInterval = OS_LIVE_ACTIVITIES_RETRY_BASE_DELAY, retryMaxDelay: TimeInterval = OS_LIVE_ACTIVITIES_RETRY_MAX_DELAY, batchWindow: TimeInterval = OS_LIVE_ACTIVITIES_BATCH_WINDOW) {
         self.requestDispatch = requestDispatch
+        self.retryBaseDelay = retryBaseDelay
+        self.retryMaxDelay = retryMaxDelay
+        self.batchWindow = batchWindow
     }
 
     func start() {
         OneSignalLog.onesignalLog(.LL_VERBOSE, message: "OneSignal.LiveActivities starting executor")
         OneSignalUserManagerImpl.sharedInstance.pushSubscriptionImpl.addObserver(self)
 
-        // drive a poll in case there are any outstanding requests in the cache.
-        self.pollPendingRequests()
+        // send any outstanding requests left in the cache by a previous session.
+        self.requestDispatch.async {
+            self.executePendingRequests()
+        }
+    }
+
+    /// The completion is called on `requestDispatch` once every cache has been trimmed.
+    func removeStaleRequests(completion: (() -> Void)? = nil) {
+        self.requestDispatch.async {
+            self.caches { cache in
+                cache.removeStaleRequests()
+            }
+            completion?()
+        }
     }
 
     func onPushSubscriptionDidChange(state: OneSignalUser.OSPushSubscriptionChangedState) {
@@ -144,8 +325,9 @@ class OSLiveActivitiesExecutor: OSPushSubscriptionObserver {
             self.caches { _ in
                 self.startTokens.markAllUnsuccessful()
             }
-
-            self.pollPendingRequests()
+            // a new subscription is a fresh start, and requests waiting on a subscription ID can now go
+            self.retryAttempts.removeAll()
+            self.executePendingRequests()
         }
     }
 
@@ -156,28 +338,87 @@ class OSLiveActivitiesExecutor: OSPushSubscriptionObserver {
 
             if existingRequest == nil || request.supersedes(existingRequest!) {
                 cache.add(request)
-                self.executeRequest(cache, request: request)
+                self.retryAttempts.removeValue(forKey: request.key)
+                self.stage(cache, keys: [request.key])
             } else {
                 OneSignalLog.onesignalLog(.LL_VERBOSE, message: "OneSignal.LiveActivities superseded request not saved/executed: \(request)")
             }
         }
     }
 
-    private func pollPendingRequests() {
-        OneSignalLog.onesignalLog(.LL_VERBOSE, message: "OneSignal.LiveActivities pollPendingRequests")
+    // Must be called on `requestDispatch`
+    private func executePendingRequests() {
+        OneSignalLog.onesignalLog(.LL_VERBOSE, message: "OneSignal.LiveActivities executing outstanding requests")
+        self.caches { cache in
+            self.stage(cache, keys: cache.pendingKeys)
+        }
+    }
+
+    /**
+     Holds requests for `batchWindow` before sending, so a burst of token changes (many activities starting at once,
+     tokens rotating, or a subscription ID change re-sending everything) is sent once per key with only the latest token.
+     Requests superseded inside the window are never sent. Must be called on `requestDispatch`.
+     */
+    private func stage(_ cache: RequestCache, keys: Set<String>) {
+        if self.batchWindow <= 0 {
+            for key in keys {
+                if let request = cache.items[key] {
+                    self.executeRequest(cache, request: request)
+                }
+            }
+            return
+        }
 
-        self.requestDispatch.asyncAfterTime(deadline: .now() + .seconds(pollIntervalSeconds)) { [weak self] in
-            OneSignalLog.onesignalLog(.LL_VERBOSE, message: "OneSignal.LiveActivities executing outstanding requests")
+        self.stagedKeys[ObjectIdentifier(cache), default: []].formUnion(keys)
+        if self.flushScheduled {
+            return
+        }
+        self.flushScheduled = true
+        self.requestDispatch.asyncAfterTime(deadline: .now() + self.batchWindow) { [weak self] in
+            self?.flushStagedRequests()
+        }
+    }
 
-            // execute any request that hasn't been successfully executed.
-            self?.caches { cache in
-                for request in cache.items.values.filter({ !$0.requestSuccessful }) {
-                    self?.executeRequest(cache, request: request)
+    // Must be called on `requestDispatch`
+    private func flushStagedRequests() {
+        self.flushScheduled = false
+        let staged = self.stagedKeys
+        self.stagedKeys.removeAll()
+
+        self.caches { cache in
+            let keys = staged[ObjectIdentifier(cache)] ?? []
+            OneSignalLog.onesignalLog(.LL_VERBOSE, message: "OneSignal.LiveActivities flushing \(keys.count) batched requests from \(cache)")
+            for key in keys where cache.pendingKeys.contains(key) {
+                if let request = cache.items[key] {
+                    self.executeRequest(cache, request: request)
                 }
             }
         }
     }
 
+    /**
+     Retries a request that failed after the client's own reattempts, in an exponentially increasing, jittered interval.
+     The retry is handed to `OSRetryScheduler` so that it is held while the network is unreachable.
+     Must be called on `requestDispatch`.
+     */
+    private func scheduleRetry(_ cache: RequestCache, request: OSLiveActivityRequest) {
+        let attempt = self.retryAttempts[request.key, default: 0]
+        self.retryAttempts[request.key] = attempt + 1
+        let maxDelay = min(self.retryMaxDelay, self.retryBaseDelay * pow(2, Double(min(attempt, 16))))
+        let delay = maxDelay / 2 + Double.random(in: 0...(maxDelay / 2))
+
+        OneSignalLog.onesignalLog(.LL_DEBUG, message: "OneSignal.LiveActivities retrying request in \(delay) seconds: \(request)")
+        OSRetryScheduler.shared().scheduleReattempt({ [weak self] in
+            self?.requestDispatch.async {
+                // the request may have been superseded, sent, or removed in the meantime
+                guard cache.items[request.key] == request, cache.pendingKeys.contains(request.key) else {
+                    return
+                }
+                self?.executeRequest(cache, request: request)
+            }
+        }, afterDelay: delay)
+    }
+
     private func caches(_ block: (RequestCache) -> Void) {
         block(self.startTokens)
         block(self.updateTokens)
@@ -194,7 +435,7 @@ class OSLiveActivitiesExecutor: OSPushSubscriptionObserver {
     private func executeRequest(_ cache: RequestCache, request: OSLiveActivityRequest) {
         if OSPrivacyConsentController.requiresUserPrivacyConsent() {
             OneSignalLog.onesignalLog(.LL_WARN, message: "Cannot send live activity request when the user has not granted privacy permission")
-            self.pollPendingRequests()
+            self.scheduleRetry(cache, request: request)
             return
         }
 
@@ -220,7 +461,10 @@ class OSLiveActivitiesExecutor: OSPushSubscriptionObserver {
                 }
                 return
             }
-            // retryable failures will stay in the cache, and will retry the next time the app starts
+            // retryable failures stay in the cache and are retried with backoff, or the next time the app starts
+            self.requestDispatch.async {
+                self.scheduleRetry(cache, request: request)
+            }
         }
     }
 }
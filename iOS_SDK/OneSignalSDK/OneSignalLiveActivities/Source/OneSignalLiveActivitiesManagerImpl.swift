@@ -38,7 +38,7 @@ enum LiveActivitiesError: Error {
 
 @objc(OneSignalLiveActivitiesManagerImpl)
 public class OneSignalLiveActivitiesManagerImpl: NSObject, OSLiveActivities {
-    private static let _executor: OSLiveActivitiesExecutor = OSLiveActivitiesExecutor(requestDispatch: DispatchQueue(label: "OneSignal.LiveActivities"))
+    private static let _executor: OSLiveActivitiesExecutor = OSLiveActivitiesExecutor(requestDispatch: DispatchQueue(label: "OneSignal.LiveActivities", target: OSDispatchQueues.utility))
 
     @objc
     public static func liveActivities() -> AnyClass {
@@ -48,6 +48,9 @@ public class OneSignalLiveActivitiesManagerImpl: NSObject, OSLiveActivities {
     @objc
     public static func start() {
         _executor.start()
+        OSMaintenanceScheduler.shared().registerJob("remove_stale_live_activity_requests") { completion in
+            _executor.removeStaleRequests(completion: completion)
+        }
     }
 
     @objc
@@ -136,10 +139,21 @@ public class OneSignalLiveActivitiesManagerImpl: NSObject, OSLiveActivities {
 
     @available(iOS 16.1, *)
     public static func setup<Attributes: OneSignalLiveActivityAttributes>(_ activityType: Attributes.Type, options: LiveActivitySetupOptions? = nil) {
-        if #available(iOS 17.2, *) {
-            listenForPushToStart(activityType, options: options)
+        guard beginObserving(activityType) else {
+            OneSignalLog.onesignalLog(.LL_DEBUG, message: "OneSignal.LiveActivities already listening on: \(activityType)")
+            return
         }
-        listenForActivity(activityType, options: options)
+        observe(activityType, options: options)
+    }
+
+    // Attribute types with an observer task, so calling setup again doesn't start a second one
+    private static let observedTypesLock = NSLock()
+    private static var observedTypes = Set<String>()
+
+    static func beginObserving<Attributes>(_ activityType: Attributes.Type) -> Bool { // non-private for unit test access
+        observedTypesLock.lock()
+        defer { observedTypesLock.unlock() }
+        return observedTypes.insert(String(reflecting: activityType)).inserted
     }
 
     @objc
@@ -175,69 +189,84 @@ public class OneSignalLiveActivitiesManagerImpl: NSObject, OSLiveActivities {
         }
     }
 
-    @available(iOS 17.2, *)
-    private static func listenForPushToStart<Attributes: OneSignalLiveActivityAttributes>(_ activityType: Attributes.Type, options: LiveActivitySetupOptions? = nil) {
-        if options == nil || options!.enablePushToStart {
-            Task {
-                OneSignalLog.onesignalLog(.LL_VERBOSE, message: "OneSignal.LiveActivities listening for pushToStart on: \(activityType)")
-                for try await data in Activity<Attributes>.pushToStartTokenUpdates {
-                    let token = data.map {String(format: "%02x", $0)}.joined()
-                    OneSignalLiveActivitiesManagerImpl.setPushToStartToken(Attributes.self, withToken: token)
-                }
-            }
-        }
-    }
-
+    /**
+     The single observer for an attribute type. One task iterates `activityUpdates` and every per-activity sequence
+     (state and push token updates) plus push-to-start runs as a child of it, so the task tree for an attribute type is
+     structured and bounded by its live activities. Events are handed straight to the executor's queue.
+     */
     @available(iOS 16.1, *)
-    private static func listenForActivity<Attributes: OneSignalLiveActivityAttributes>(_ activityType: Attributes.Type, options: LiveActivitySetupOptions? = nil) {
+    private static func observe<Attributes: OneSignalLiveActivityAttributes>(_ activityType: Attributes.Type, options: LiveActivitySetupOptions?) {
         Task {
-            OneSignalLog.onesignalLog(.LL_VERBOSE, message: "OneSignal.LiveActivities listening for activity on: \(activityType)")
-            for await activity in Activity<Attributes>.activityUpdates {
-                if #available(iOS 16.2, *) {
-                    // if there's already an activity with the same OneSignal activityId, dismiss it before
-                    // listening for the new activity's events.
-                    for otherActivity in Activity<Attributes>.activities {
-                        if activity.id != otherActivity.id && otherActivity.attributes.onesignal.activityId == activity.attributes.onesignal.activityId {
-                            await otherActivity.end(nil, dismissalPolicy: ActivityUIDismissalPolicy.immediate)
-                        }
+            await withTaskGroup(of: Void.self) { group in
+                if #available(iOS 17.2, *), options == nil || options!.enablePushToStart {
+                    group.addTask {
+                        await listenForPushToStart(activityType)
                     }
                 }
 
-                listenForActivityStateUpdates(activityType, activity: activity, options: options)
-                listenForActivityPushToUpdate(activityType, activity: activity, options: options)
+                OneSignalLog.onesignalLog(.LL_VERBOSE, message: "OneSignal.LiveActivities listening for activity on: \(activityType)")
+                var observedActivityIds = Set<String>()
+                for await activity in Activity<Attributes>.activityUpdates {
+                    // activityUpdates can report an activity more than once, it only needs one set of listeners
+                    guard observedActivityIds.insert(activity.id).inserted else {
+                        continue
+                    }
+
+                    if #available(iOS 16.2, *) {
+                        // if there's already an activity with the same OneSignal activityId, dismiss it before
+                        // listening for the new activity's events.
+                        for otherActivity in Activity<Attributes>.activities {
+                            if activity.id != otherActivity.id && otherActivity.attributes.onesignal.activityId == activity.attributes.onesignal.activityId {
+                                await otherActivity.end(nil, dismissalPolicy: ActivityUIDismissalPolicy.immediate)
+                            }
+                        }
+                    }
+
+                    group.addTask {
+                        await listenForActivityStateUpdates(activityType, activity: activity)
+                    }
+                    if options == nil || options!.enablePushToUpdate {
+                        group.addTask {
+                            await listenForActivityPushToUpdate(activityType, activity: activity)
+                        }
+                    }
+                }
             }
         }
     }
 
+    @available(iOS 17.2, *)
+    private static func listenForPushToStart<Attributes: OneSignalLiveActivityAttributes>(_ activityType: Attributes.Type) async {
+        OneSignalLog.onesignalLog(.LL_VERBOSE, message: "OneSignal.LiveActivities listening for pushToStart on: \(activityType)")
+        for await data in Activity<Attributes>.pushToStartTokenUpdates {
+            let token = data.map {String(format: "%02x", $0)}.joined()
+            OneSignalLiveActivitiesManagerImpl.setPushToStartToken(Attributes.self, withToken: token)
+        }
+    }
+
     @available(iOS 16.1, *)
-    private static func listenForActivityStateUpdates<Attributes: OneSignalLiveActivityAttributes>(_ activityType: Attributes.Type, activity: Activity<Attributes>, options: LiveActivitySetupOptions? = nil) {
+    private static func listenForActivityStateUpdates<Attributes: OneSignalLiveActivityAttributes>(_ activityType: Attributes.Type, activity: Activity<Attributes>) async {
         // listen for activity dismisses so we can forget about the token
-        Task {
-            OneSignalLog.onesignalLog(.LL_VERBOSE, message: "OneSignal.LiveActivities listening for state update on: \(activityType):\(activity.attributes.onesignal.activityId):\(activity.id)")
-            for await activityState in activity.activityStateUpdates {
-                switch activityState {
-                case .dismissed:
-                    OneSignalLiveActivitiesManagerImpl.exit(activity.attributes.onesignal.activityId)
-                case .active: break
-                case .ended: break
-                case .stale: break
-                default: break
-                }
+        OneSignalLog.onesignalLog(.LL_VERBOSE, message: "OneSignal.LiveActivities listening for state update on: \(activityType):\(activity.attributes.onesignal.activityId):\(activity.id)")
+        for await activityState in activity.activityStateUpdates {
+            switch activityState {
+            case .dismissed:
+                OneSignalLiveActivitiesManagerImpl.exit(activity.attributes.onesignal.activityId)
+            case .active: break
+            case .ended: break
+            case .stale: break
+            default: break
             }
         }
     }
 
     @available(iOS 16.1, *)
-    private static func listenForActivityPushToUpdate<Attributes: OneSignalLiveActivityAttributes>(_ activityType: Attributes.Type, activity: Activity<Attributes>, options: LiveActivitySetupOptions? = nil) {
-        if options == nil || options!.enablePushToUpdate {
-            // listen for activity update token updates so we can tell OneSignal how to update the activity
-            Task {
-                OneSignalLog.onesignalLog(.LL_VERBOSE, message: "OneSignal.LiveActivities listening for pushToUpdate on: \(activityType):\(activity.attributes.onesignal.activityId):\(activity.id)")
-                for await pushToken in activity.pushTokenUpdates {
-                    let token = pushToken.map {String(format: "%02x", $0)}.joined()
-                    OneSignalLiveActivitiesManagerImpl.enter(activity.attributes.onesignal.activityId, withToken: token)
-                }
-            }
+    private static func listenForActivityPushToUpdate<Attributes: OneSignalLiveActivityAttributes>(_ activityType: Attributes.Type, activity: Activity<Attributes>) async {
+        // listen for activity update token updates so we can tell OneSignal how to update the activity
+        OneSignalLog.onesignalLog(.LL_VERBOSE, message: "OneSignal.LiveActivities listening for pushToUpdate on: \(activityType):\(activity.attributes.onesignal.activityId):\(activity.id)")
+        for await pushToken in activity.pushTokenUpdates {
+            let token = pushToken.map {String(format: "%02x", $0)}.joined()
+            OneSignalLiveActivitiesManagerImpl.enter(activity.attributes.onesignal.activityId, withToken: token)
         }
     }
 }
@@ -299,4 +299,56 @@ final class DefaultLiveActivityAttributesTests: XCTestCase {
         let decoder = JSONDecoder()
         XCTAssertThrowsError(try decoder.decode(DefaultLiveActivityAttributes.ContentState.self, from: json))
     }
+
+    func testEncodingRoundTripsDecodedPayload() throws {
+        /* Setup */
+        let json = """
+        {
+            "data": {
+                "stringValue": "this is a string",
+                "intValue": 6,
+                "floatValue": 50.6,
+                "boolValue": true,
+                "nullValue": null,
+                "arrayValue": [ "this", 1, false ],
+                "dictValue": { "anotherDict": { "intValue": 7 } }
+            },
+            "onesignal": {
+                "activityId": "my-activity-id"
+            }
+        }
+        """.data(using: .utf8)!
+        let sut = try JSONDecoder().decode(DefaultLiveActivityAttributes.self, from: json)
+
+        /* When */
+        let encoded = try JSONEncoder().encode(sut)
+        let decoded = try JSONDecoder().decode(DefaultLiveActivityAttributes.self, from: encoded)
+
+        /* Then */
+        XCTAssertEqual(decoded.data, sut.data)
+        XCTAssertEqual(decoded.data["arrayValue"]?.asArray()?[1].asInt(), 1)
+        XCTAssertEqual(decoded.data["arrayValue"]?.asArray()?[2].asBool(), false)
+        XCTAssertTrue(decoded.data["nullValue"]?.value is NSNull)
+        XCTAssertEqual(decoded.onesignal.activityId, "my-activity-id")
+    }
+
+    func testDecodeEncodeLargePayloadPerformance() throws {
+        /* Setup */
+        var data = [String: Any]()
+        for i in 0..<1000 {
+            data["string_\(i)"] = "value \(i)"
+            data["int_\(i)"] = i
+            data["double_\(i)"] = Double(i) + 0.5
+            data["bool_\(i)"] = i % 2 == 0
+            data["dict_\(i)"] = ["nested": ["value \(i)", i]]
+        }
+        let payload: [String: Any] = ["data": data, "onesignal": ["activityId": "my-activity-id"]]
+        let json = try JSONSerialization.data(withJSONObject: payload)
+
+        /* When/Then */
+        measure {
+            let sut = try! JSONDecoder().decode(DefaultLiveActivityAttributes.self, from: json)
+            _ = try! JSONEncoder().encode(sut)
+        }
+    }
 }
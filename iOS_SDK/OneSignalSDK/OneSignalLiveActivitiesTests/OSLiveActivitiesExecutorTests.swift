@@ -398,4 +398,134 @@ final class OSLiveActivitiesExecutorTests: XCTestCase {
         XCTAssertTrue(mockClient.executedRequests[0] == request1)
         XCTAssertTrue(mockClient.executedRequests[1] == request2)
     }
+
+    func testRetryableErrorIsRetriedWithBackoff() throws {
+        /* Setup */
+        let mockDispatchQueue = MockDispatchQueue()
+        let mockClient = MockOneSignalClient()
+        OneSignalCoreImpl.setSharedClient(mockClient)
+        OneSignalUserDefaults.initShared().saveString(forKey: OSUD_LEGACY_PLAYER_ID, withValue: "my-subscription-id")
+        OneSignalUserManagerImpl.sharedInstance.start()
+        // Wait for any user setup requests to complete
+        OneSignalCoreMocks.waitForBackgroundThreads(seconds: 0.2)
+        mockClient.reset()
+
+        let request = OSRequestSetStartToken(key: "my-activity-type", token: "my-token")
+        mockClient.setMockFailureResponseForRequest(request: String(describing: request), error: OneSignalClientError(code: 500, message: "not-important", responseHeaders: nil, response: nil, underlyingError: nil))
+
+        /* When */
+        let executor = OSLiveActivitiesExecutor(requestDispatch: mockDispatchQueue, retryBaseDelay: 0.05, retryMaxDelay: 0.1)
+        executor.append(request)
+        mockDispatchQueue.waitForDispatches(3)
+
+        /* Then */
+        XCTAssertGreaterThan(mockClient.executedRequests.count, 1)
+        XCTAssert(executor.startTokens.items["my-activity-type"] == request)
+        XCTAssertTrue(executor.startTokens.pendingKeys.contains("my-activity-type"))
+        XCTAssertFalse(request.requestSuccessful)
+    }
+
+    func testPendingKeysTrackUnsentRequests() throws {
+        /* Setup */
+        let cache = StartRequestCache()
+        let request1 = OSRequestSetStartToken(key: "my-activity-type-1", token: "my-token-1")
+        let request2 = OSRequestSetStartToken(key: "my-activity-type-2", token: "my-token-2")
+
+        /* When */
+        cache.add(request1)
+        cache.add(request2)
+        cache.markSuccessful(request1)
+
+        /* Then */
+        XCTAssertEqual(cache.pendingKeys, ["my-activity-type-2"])
+        XCTAssertTrue(cache.pendingRequests[0] == request2)
+
+        /* When */
+        cache.markAllUnsuccessful()
+
+        /* Then */
+        XCTAssertEqual(cache.pendingKeys, ["my-activity-type-1", "my-activity-type-2"])
+
+        /* When */
+        cache.remove(request2)
+
+        /* Then */
+        XCTAssertEqual(cache.pendingKeys, ["my-activity-type-1"])
+        // The index is rebuilt from persisted requests
+        XCTAssertEqual(StartRequestCache().pendingKeys, ["my-activity-type-1"])
+    }
+
+    func testBatchWindowSendsOnlyLatestRequestPerKey() throws {
+        /* Setup */
+        let mockDispatchQueue = MockDispatchQueue()
+        let mockClient = MockOneSignalClient()
+        OneSignalCoreImpl.setSharedClient(mockClient)
+        OneSignalUserDefaults.initShared().saveString(forKey: OSUD_LEGACY_PLAYER_ID, withValue: "my-subscription-id")
+        OneSignalUserManagerImpl.sharedInstance.start()
+        // Wait for any user setup requests to complete
+        OneSignalCoreMocks.waitForBackgroundThreads(seconds: 0.2)
+        mockClient.reset()
+
+        let request1 = OSRequestSetUpdateToken(key: "my-activity-id-1", token: "my-token-1")
+        let request2 = OSRequestSetUpdateToken(key: "my-activity-id-1", token: "my-token-2")
+        let request3 = OSRequestSetUpdateToken(key: "my-activity-id-1", token: "my-token-3")
+        let request4 = OSRequestSetUpdateToken(key: "my-activity-id-2", token: "my-token-4")
+        for request in [request1, request2, request3, request4] {
+            mockClient.setMockResponseForRequest(request: String(describing: request), response: [String: Any]())
+        }
+
+        /* When */
+        let executor = OSLiveActivitiesExecutor(requestDispatch: mockDispatchQueue, batchWindow: 0.1)
+        executor.append(request1)
+        executor.append(request2)
+        executor.append(request3)
+        executor.append(request4)
+        // 4 appends, 1 flush, 2 successes
+        mockDispatchQueue.waitForDispatches(7)
+
+        /* Then */
+        XCTAssertEqual(mockClient.executedRequests.count, 2)
+        XCTAssertFalse(mockClient.executedRequests.contains { $0 == request1 || $0 == request2 })
+        XCTAssertTrue(request3.requestSuccessful)
+        XCTAssertTrue(request4.requestSuccessful)
+        XCTAssertTrue(executor.updateTokens.pendingKeys.isEmpty)
+    }
+
+    func testRequestExpiryIndexRemovesOldestFirst() throws {
+        /* Setup */
+        let now = Date()
+        var index = RequestExpiryIndex()
+        index.insert("key-3", timestamp: now.addingTimeInterval(-10))
+        index.insert("key-1", timestamp: now.addingTimeInterval(-30))
+        index.insert("key-2", timestamp: now.addingTimeInterval(-20))
+        index.insert("key-4", timestamp: now)
+
+        /* When */
+        // Re-inserting a key moves it to its new timestamp
+        index.insert("key-1", timestamp: now.addingTimeInterval(-5))
+        let expired = index.removeAll(before: now.addingTimeInterval(-15))
+
+        /* Then */
+        XCTAssertEqual(expired, ["key-2"])
+        XCTAssertEqual(index.count, 3)
+        XCTAssertEqual(index.removeOldest(2), ["key-3", "key-1"])
+        XCTAssertEqual(index.count, 1)
+    }
+
+    func testLegacyRequestCacheIsMigrated() throws {
+        /* Setup */
+        let request = OSRequestSetStartToken(key: "my-activity-type", token: "my-token")
+        request.requestSuccessful = true
+        OneSignalUserDefaults.initShared().saveCodeableData(forKey: OS_LIVE_ACTIVITIES_EXECUTOR_START_TOKENS_KEY, withValue: ["my-activity-type": request])
+
+        /* When */
+        let cache = StartRequestCache()
+
+        /* Then */
+        XCTAssertEqual(cache.items.count, 1)
+        XCTAssertTrue(cache.pendingKeys.isEmpty)
+        XCTAssertFalse(OneSignalUserDefaults.initShared().keyExists(OS_LIVE_ACTIVITIES_EXECUTOR_START_TOKENS_KEY))
+        // Reloads from the per-request archives
+        XCTAssertEqual(StartRequestCache().items.count, 1)
+    }
 }
@@ -35,7 +35,10 @@
 
 //Track time until next location fire event
 const NSTimeInterval foregroundSendLocationWaitTime = 5 * 60.0;
-NSTimer* requestLocationTimer = nil;
+// The send timer and the bookkeeping below are only touched on locationQueue,
+// only CLLocationManager setup and requests go through the main thread
+static dispatch_source_t requestLocationTimer = nil;
+static NSDate *requestLocationFireDate = nil;
 os_last_location *lastLocation;
 bool initialLocationSent = false;
 UIBackgroundTaskIdentifier fcTask;
@@ -45,6 +48,11 @@ static id locationManager = nil;
 static bool started = false;
 static bool hasDelayed = false;
 static bool fallbackToSettings = false;
+static bool startRequested = false;
+
+// The last coordinate turned into a delta, fixes close to it in space or time are coalesced away
+static os_location_coordinate lastSentCords;
+static NSDate *lastSentDate = nil;
 
 // CoreLocation must be statically linked for geotagging to work on iOS 6 and possibly 7.
 // plist NSLocationUsageDescription (iOS 6 & 7) and NSLocationWhenInUseUsageDescription (iOS 8+) keys also required.
@@ -56,6 +64,15 @@ static bool fallbackToSettings = false;
 #pragma clang diagnostic push
 #pragma clang diagnostic ignored "-Wundeclared-selector"
 
++ (dispatch_queue_t)locationQueue {
+    static dispatch_queue_t queue;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        queue = dispatch_queue_create_with_target("com.onesignal.location", DISPATCH_QUEUE_SERIAL, OSDispatchQueues.utility);
+    });
+    return queue;
+}
+
 NSMutableArray *_locationListeners;
 +(NSMutableArray*)locationListeners {
     if (!_locationListeners)
@@ -81,14 +98,61 @@ static OneSignalLocationManager* singleInstance = nil;
     return singleInstance;
 }
 
++ (void)load {
+    [OSModuleRegistry registerModule:OSModuleLocation moduleClass:self];
+}
+
 + (Class<OSLocation>)Location {
     return self;
 }
 
+/*
+ The module stays dormant, with no CoreLocation calls and no timers, until location is both shared
+ (remote params or the app's setShared:) and declared by the app through a usage description.
+ Most apps never declare one, so this keeps location entirely out of their startup.
+ */
 + (void)start {
-    if ([OneSignalConfigManager getAppId] != nil && [self isShared]) {
-        [OneSignalLocationManager getLocation:false fallbackToSettings:false withCompletionHandler:nil];
+    if (startRequested)
+        return;
+    if (![self isLocationNeeded]) {
+        [OneSignalLog onesignalLog:ONE_S_LL_VERBOSE message:@"OneSignalLocation not shared or not declared in the Info.plist, staying dormant"];
+        return;
     }
+    startRequested = true;
+    [OneSignalLocationManager getLocation:false fallbackToSettings:false withCompletionHandler:nil];
+}
+
++ (BOOL)isLocationNeeded {
+    return [OneSignalConfigManager getAppId] != nil && [self isShared] && [self appDeclaresLocationUsage];
+}
+
+// Reads the Info.plist only, the app can't be granted location without one of these so CoreLocation isn't consulted
++ (BOOL)appDeclaresLocationUsage {
+    static BOOL declared;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        NSBundle *bundle = [NSBundle mainBundle];
+        declared = [bundle objectForInfoDictionaryKey:@"NSLocationWhenInUseUsageDescription"] ||
+                   [bundle objectForInfoDictionaryKey:@"NSLocationAlwaysAndWhenInUseUsageDescription"] ||
+                   [bundle objectForInfoDictionaryKey:@"NSLocationAlwaysUsageDescription"];
+    });
+    return declared;
+}
+
+// Puts the module back to sleep once location stops being shared
++ (void)stop {
+    startRequested = false;
+    dispatch_async(self.locationQueue, ^{
+        [self cancelRequestLocationTimer];
+    });
+    dispatch_async(dispatch_get_main_queue(), ^{
+        if (!locationManager)
+            return;
+        [locationManager performSelector:@selector(stopUpdatingLocation)];
+        [locationManager performSelector:@selector(stopMonitoringSignificantLocationChanges)];
+        if ([locationManager respondsToSelector:@selector(stopMonitoringVisits)])
+            [locationManager performSelector:@selector(stopMonitoringVisits)];
+    });
 }
 
 + (void)setShared:(BOOL)enable {
@@ -100,13 +164,17 @@ static OneSignalLocationManager* singleInstance = nil;
 }
 
 + (void)startLocationSharedWithFlag:(BOOL)enable {
-    [OneSignalLog onesignalLog:ONE_S_LL_VERBOSE message:[NSString stringWithFormat:@"startLocationSharedWithFlag called with status: %d", (int) enable]];
+    ONE_S_LOG(ONE_S_LL_VERBOSE, @"startLocationSharedWithFlag called with status: %d", (int) enable);
 
     [[OSRemoteParamController sharedController] saveLocationShared:enable];
 
     if (!enable) {
         [OneSignalLog onesignalLog:ONE_S_LL_VERBOSE message:@"startLocationSharedWithFlag set false, clearing last location!"];
         [OneSignalLocationManager clearLastLocation];
+        [OneSignalLocationManager stop];
+    } else {
+        // Wakes the module if it was left dormant at launch
+        [OneSignalLocationManager start];
     }
 }
 
@@ -138,23 +206,66 @@ static OneSignalLocationManager* singleInstance = nil;
 + (void)clearLastLocation {
     @synchronized(OneSignalLocationManager.mutexObjectForLastLocation) {
        lastLocation = nil;
+       lastSentDate = nil;
     }
 }
 
+// Great-circle distance between two coordinates, avoids linking CoreLocation for -[CLLocation distanceFromLocation:]
++ (double)distanceInMetersFrom:(os_location_coordinate)from to:(os_location_coordinate)to {
+    const double earthRadiusMeters = 6371000.0;
+    double dLat = (to.latitude - from.latitude) * M_PI / 180.0;
+    double dLon = (to.longitude - from.longitude) * M_PI / 180.0;
+    double a = sin(dLat / 2) * sin(dLat / 2) +
+               cos(from.latitude * M_PI / 180.0) * cos(to.latitude * M_PI / 180.0) * sin(dLon / 2) * sin(dLon / 2);
+    return earthRadiusMeters * 2 * atan2(sqrt(a), sqrt(1 - a));
+}
+
++ (BOOL)isSignificantChangeFromLastSent:(os_location_coordinate)cords {
+    return [self isSignificantChangeFrom:lastSentCords sentAt:lastSentDate to:cords];
+}
+
+// Both thresholds widen while OSPowerPolicy is constrained
++ (BOOL)isSignificantChangeFrom:(os_location_coordinate)sentCords sentAt:(NSDate *)sentDate to:(os_location_coordinate)cords {
+    if (!sentDate)
+        return true;
+    if (-[sentDate timeIntervalSinceNow] < [OSPowerPolicy.sharedPolicy scaledDelay:OS_LOCATION_MIN_SEND_INTERVAL])
+        return false;
+    return [self distanceInMetersFrom:sentCords to:cords] >= [OSPowerPolicy.sharedPolicy scaledDistance:OS_LOCATION_MIN_DISTANCE_METERS];
+}
+
++ (void)applyPowerPolicyDistanceFilter {
+    [locationManager setValue:@([OSPowerPolicy.sharedPolicy scaledDistance:OS_LOCATION_MIN_DISTANCE_METERS]) forKey:@"distanceFilter"];
+}
+
+// Significant-change monitoring and visits use the cell and wifi radios instead of GPS, but need "always" permission
++ (BOOL)canUseLowPowerMonitoring {
+    #pragma clang diagnostic push
+    #pragma clang diagnostic ignored "-Wpointer-integer-compare"
+    #pragma clang diagnostic push
+    #pragma clang diagnostic ignored "-Wint-conversion"
+    id clLocationManagerClass = NSClassFromString(@"CLLocationManager");
+    return [clLocationManagerClass performSelector:@selector(authorizationStatus)] == kCLAuthorizationStatusAuthorizedAlways
+        && [clLocationManagerClass performSelector:@selector(significantLocationChangeMonitoringAvailable)];
+    #pragma clang diagnostic pop
+    #pragma clang diagnostic pop
+}
+
 + (void)getLocation:(bool)prompt fallbackToSettings:(BOOL)fallback withCompletionHandler:(void (^)(PromptActionResult result))completionHandler {
-    if (completionHandler)
-        [OneSignalLocationManager.locationListeners addObject:completionHandler];
-
-    if (hasDelayed)
-        [OneSignalLocationManager internalGetLocation:prompt fallbackToSettings:fallback];
-    else {
-        // Delay required for locationServicesEnabled and authorizationStatus return the correct values when CoreLocation is not statically linked.
-        dispatch_time_t popTime = dispatch_time(DISPATCH_TIME_NOW, 2.0 * NSEC_PER_SEC);
-        dispatch_after(popTime, dispatch_get_main_queue(), ^(void) {
-            hasDelayed = true;
+    dispatch_async(self.locationQueue, ^{
+        if (completionHandler)
+            [OneSignalLocationManager.locationListeners addObject:completionHandler];
+        
+        if (hasDelayed)
             [OneSignalLocationManager internalGetLocation:prompt fallbackToSettings:fallback];
-        });
-    }
+        else {
+            // Delay required for locationServicesEnabled and authorizationStatus return the correct values when CoreLocation is not statically linked.
+            dispatch_time_t popTime = dispatch_time(DISPATCH_TIME_NOW, 2.0 * NSEC_PER_SEC);
+            dispatch_after(popTime, self.locationQueue, ^(void) {
+                hasDelayed = true;
+                [OneSignalLocationManager internalGetLocation:prompt fallbackToSettings:fallback];
+            });
+        }
+    });
     // Listen to app going to and from background
 }
 
@@ -176,30 +287,33 @@ static OneSignalLocationManager* singleInstance = nil;
         Otherwise set timer to NULL
     **/
     
-    NSTimeInterval remainingTimerTime = requestLocationTimer.fireDate.timeIntervalSinceNow;
-    NSTimeInterval requiredWaitTime = foregroundSendLocationWaitTime;
-    NSTimeInterval adjustedTime = remainingTimerTime > 0 ? remainingTimerTime : requiredWaitTime;
-
-    if (isActive) {
-        if(requestLocationTimer && initialLocationSent) {
-            //Keep timer going with the remaining time
-            [requestLocationTimer invalidate];
-            requestLocationTimer = [NSTimer scheduledTimerWithTimeInterval:adjustedTime target:self selector:@selector(requestLocation) userInfo:nil repeats:NO];
-        }
-    } else {
-        //Check if always granted
-        #pragma clang diagnostic push
-        #pragma clang diagnostic ignored "-Wpointer-integer-compare"
-        #pragma clang diagnostic push
-        #pragma clang diagnostic ignored "-Wint-conversion"
-        if ([NSClassFromString(@"CLLocationManager") performSelector:@selector(authorizationStatus)] == kCLAuthorizationStatusAuthorizedAlways) {
-            [OneSignalLocationManager beginTask];
-            [requestLocationTimer invalidate];
-            [self requestLocation];
+    dispatch_async(self.locationQueue, ^{
+        NSTimeInterval remainingTimerTime = requestLocationFireDate.timeIntervalSinceNow;
+        NSTimeInterval requiredWaitTime = foregroundSendLocationWaitTime;
+        NSTimeInterval adjustedTime = remainingTimerTime > 0 ? remainingTimerTime : requiredWaitTime;
+        
+        if (isActive) {
+            if (requestLocationTimer && initialLocationSent) {
+                //Keep timer going with the remaining time
+                [self scheduleRequestLocationAfter:adjustedTime];
+            }
         } else {
-            requestLocationTimer = NULL;
+            //Check if always granted
+            #pragma clang diagnostic push
+            #pragma clang diagnostic ignored "-Wpointer-integer-compare"
+            #pragma clang diagnostic push
+            #pragma clang diagnostic ignored "-Wint-conversion"
+            if ([NSClassFromString(@"CLLocationManager") performSelector:@selector(authorizationStatus)] == kCLAuthorizationStatusAuthorizedAlways) {
+                [OneSignalLocationManager beginTask];
+                [self cancelRequestLocationTimer];
+                dispatch_async(dispatch_get_main_queue(), ^{
+                    [self requestLocation];
+                });
+            } else {
+                [self cancelRequestLocationTimer];
+            }
         }
-    }
+    });
 }
 
 + (void)beginTask {
@@ -213,13 +327,19 @@ static OneSignalLocationManager* singleInstance = nil;
     fcTask = UIBackgroundTaskInvalid;
 }
 
+// Must be called on locationQueue, the listeners are app callbacks and are called on the main thread
 + (void)sendAndClearLocationListener:(PromptActionResult)result {
-    [OneSignalLog onesignalLog:ONE_S_LL_DEBUG message:[NSString stringWithFormat:@"OneSignalLocation sendAndClearLocationListener listeners: %@", OneSignalLocationManager.locationListeners]];
-    for (int i = 0; i < OneSignalLocationManager.locationListeners.count; i++) {
-        ((void (^)(PromptActionResult result))[OneSignalLocationManager.locationListeners objectAtIndex:i])(result);
-    }
+    ONE_S_LOG(ONE_S_LL_DEBUG, @"OneSignalLocation sendAndClearLocationListener listeners: %@", OneSignalLocationManager.locationListeners);
+    NSArray *listeners = [OneSignalLocationManager.locationListeners copy];
     // We only call the listeners once
     [OneSignalLocationManager.locationListeners removeAllObjects];
+    if (listeners.count == 0)
+        return;
+    dispatch_async(dispatch_get_main_queue(), ^{
+        for (void (^listener)(PromptActionResult result) in listeners) {
+            listener(result);
+        }
+    });
 }
 
 + (void)sendCurrentAuthStatusToListeners {
@@ -237,7 +357,7 @@ static OneSignalLocationManager* singleInstance = nil;
     /*
      Do permission checking on a background thread to resolve locationServicesEnabled warning.
      */
-    dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+    dispatch_async(self.locationQueue, ^{
         fallbackToSettings = fallback;
         id clLocationManagerClass = NSClassFromString(@"CLLocationManager");
         
@@ -247,7 +367,7 @@ static OneSignalLocationManager* singleInstance = nil;
             // We evaluate the following cases after permissions were asked (denied or given)
             CLAuthorizationStatus permissionStatus = [clLocationManagerClass performSelector:@selector(authorizationStatus)];
             BOOL showSettings = prompt && fallback && permissionStatus == kCLAuthorizationStatusDenied;
-            [OneSignalLog onesignalLog:ONE_S_LL_DEBUG message:[NSString stringWithFormat:@"internalGetLocation called showSettings: %@", showSettings ? @"YES" : @"NO"]];
+            ONE_S_LOG(ONE_S_LL_DEBUG, @"internalGetLocation called showSettings: %@", showSettings ? @"YES" : @"NO");
             // Fallback to settings alert view when the following condition are true:
             //   - On a prompt flow
             //   - Fallback to settings is enabled
@@ -280,6 +400,15 @@ static OneSignalLocationManager* singleInstance = nil;
         dispatch_async(dispatch_get_main_queue(), ^{
             locationManager = [[clLocationManagerClass alloc] init];
             [locationManager setValue:[self sharedInstance] forKey:@"delegate"];
+            // Only lat / long are sent, a hundred meters is plenty and lets CoreLocation avoid powering up GPS
+            [locationManager setValue:@(100.0) forKey:@"desiredAccuracy"];
+            [self applyPowerPolicyDistanceFilter];
+            static dispatch_once_t powerPolicyObserverOnce;
+            dispatch_once(&powerPolicyObserverOnce, ^{
+                [[NSNotificationCenter defaultCenter] addObserverForName:OS_POWER_POLICY_CHANGED_NOTIFICATION object:nil queue:NSOperationQueue.mainQueue usingBlock:^(NSNotification *notification) {
+                    [self applyPowerPolicyDistanceFilter];
+                }];
+            });
             
             
             //Check info plist for request descriptions
@@ -291,7 +420,7 @@ static OneSignalLocationManager* singleInstance = nil;
             BOOL backgroundLocationEnable = backgroundModes && [backgroundModes containsObject:@"location"] && alwaysDescription;
             BOOL permissionEnable = permissionStatus == kCLAuthorizationStatusAuthorizedAlways || prompt;
             
-            [OneSignalLog onesignalLog:ONE_S_LL_DEBUG message:[NSString stringWithFormat:@"internalGetLocation called backgroundLocationEnable: %@ permissionEnable: %@", backgroundLocationEnable ? @"YES" : @"NO", permissionEnable ? @"YES" : @"NO"]];
+            ONE_S_LOG(ONE_S_LL_DEBUG, @"internalGetLocation called backgroundLocationEnable: %@ permissionEnable: %@", backgroundLocationEnable ? @"YES" : @"NO", permissionEnable ? @"YES" : @"NO");
             
             if (backgroundLocationEnable && permissionEnable) {
 #pragma clang diagnostic push
@@ -309,7 +438,9 @@ static OneSignalLocationManager* singleInstance = nil;
             
             else {
                 [OneSignalLog onesignalLog:ONE_S_LL_ERROR message:@"Include a privacy NSLocationAlwaysUsageDescription or NSLocationWhenInUseUsageDescription in your info.plist to request location permissions."];
-                [self sendAndClearLocationListener:LOCATION_PERMISSIONS_MISSING_INFO_PLIST];
+                dispatch_async(self.locationQueue, ^{
+                    [self sendAndClearLocationListener:LOCATION_PERMISSIONS_MISSING_INFO_PLIST];
+                });
             }
             
             // This method is used for getting the location manager to obtain an initial location fix
@@ -332,7 +463,9 @@ static OneSignalLocationManager* singleInstance = nil;
             [[UIApplication sharedApplication] openURL:[NSURL URLWithString:UIApplicationOpenSettingsURLString]];
             #pragma clang diagnostic pop
         }
-        [OneSignalLocationManager sendAndClearLocationListener:false];
+        dispatch_async(OneSignalLocationManager.locationQueue, ^{
+            [OneSignalLocationManager sendAndClearLocationListener:false];
+        });
         return;
     }];
 }
@@ -343,10 +476,11 @@ static OneSignalLocationManager* singleInstance = nil;
 
 + (void)requestLocation {
     [OneSignalLog onesignalLog:ONE_S_LL_DEBUG message:@"OneSignalLocation Requesting Updated Location"];
-    id clLocationManagerClass = NSClassFromString(@"CLLocationManager");
     if ([UIApplication sharedApplication].applicationState == UIApplicationStateBackground
-        && [clLocationManagerClass performSelector:@selector(significantLocationChangeMonitoringAvailable)]) {
+        && [self canUseLowPowerMonitoring]) {
         [locationManager performSelector:@selector(startMonitoringSignificantLocationChanges)];
+        if ([locationManager respondsToSelector:@selector(startMonitoringVisits)])
+            [locationManager performSelector:@selector(startMonitoringVisits)];
         if ([self backgroundTaskIsActive]) {
             [self endTask];
         }
@@ -358,67 +492,111 @@ static OneSignalLocationManager* singleInstance = nil;
 #pragma mark CLLocationManagerDelegate
 
 - (void)locationManager:(id)manager didUpdateLocations:(NSArray *)locations {
+    id location = locations.lastObject;
+    [self handleFix:location fromManager:manager];
+}
+
+- (void)locationManager:(id)manager didVisit:(id)visit {
+    [self handleFix:visit fromManager:manager];
+}
+
+// Shared by CLLocation and CLVisit, which both expose coordinate and accuracies
+- (void)handleFix:(id)fix fromManager:(id)manager {
     // return if the user has not granted privacy permissions or location shared is false
     if (([OSPrivacyConsentController requiresUserPrivacyConsent] || ![OneSignalLocationManager isShared]) && !fallbackToSettings) {
         [OneSignalLog onesignalLog:ONE_S_LL_DEBUG message:@"CLLocationManagerDelegate clear Location listener due to permissions denied or location shared not available"];
-        [OneSignalLocationManager sendAndClearLocationListener:PERMISSION_DENIED];
+        dispatch_async(OneSignalLocationManager.locationQueue, ^{
+            [OneSignalLocationManager sendAndClearLocationListener:PERMISSION_DENIED];
+        });
         return;
     }
+    // Delegate callbacks arrive on main, stop the manager and read the fix here then hand off the rest
     [manager performSelector:@selector(stopUpdatingLocation)];
-    if ([UIApplication sharedApplication].applicationState != UIApplicationStateBackground) {
+    BOOL isBackground = [UIApplication sharedApplication].applicationState == UIApplicationStateBackground;
+    if (!isBackground) {
         [manager performSelector:@selector(stopMonitoringSignificantLocationChanges)];
-        if (!requestLocationTimer)
-            [OneSignalLocationManager resetSendTimer];
+        if ([manager respondsToSelector:@selector(stopMonitoringVisits)])
+            [manager performSelector:@selector(stopMonitoringVisits)];
     }
     
-    id location = locations.lastObject;
-    
     SEL cord_selector = NSSelectorFromString(@"coordinate");
     os_location_coordinate cords;
-    NSInvocation *invocation = [NSInvocation invocationWithMethodSignature:[[location class] instanceMethodSignatureForSelector:cord_selector]];
+    NSInvocation *invocation = [NSInvocation invocationWithMethodSignature:[[fix class] instanceMethodSignatureForSelector:cord_selector]];
     
-    [invocation setTarget:locations.lastObject];
+    [invocation setTarget:fix];
     [invocation setSelector:cord_selector];
     [invocation invoke];
     [invocation getReturnValue:&cords];
+    // CLVisit has no verticalAccuracy
+    double verticalAccuracy = [fix respondsToSelector:@selector(verticalAccuracy)] ? [[fix valueForKey:@"verticalAccuracy"] doubleValue] : -1;
+    double horizontalAccuracy = [[fix valueForKey:@"horizontalAccuracy"] doubleValue];
     
-    @synchronized(OneSignalLocationManager.mutexObjectForLastLocation) {
-        if (!lastLocation)
-            lastLocation = (os_last_location*)malloc(sizeof(os_last_location));
-        if (lastLocation == NULL) {
-            [OneSignalLog onesignalLog:ONE_S_LL_ERROR message:@"OneSignalLocation: unable to allocate memory for os_last_location"];
-            return;
+    dispatch_async(OneSignalLocationManager.locationQueue, ^{
+        if (!isBackground && !requestLocationTimer)
+            [OneSignalLocationManager resetSendTimer];
+        
+        @synchronized(OneSignalLocationManager.mutexObjectForLastLocation) {
+            if (!lastLocation)
+                lastLocation = (os_last_location*)malloc(sizeof(os_last_location));
+            if (lastLocation == NULL) {
+                [OneSignalLog onesignalLog:ONE_S_LL_ERROR message:@"OneSignalLocation: unable to allocate memory for os_last_location"];
+                return;
+            }
+            lastLocation->verticalAccuracy = verticalAccuracy;
+            lastLocation->horizontalAccuracy = horizontalAccuracy;
+            lastLocation->cords = cords;
         }
-        lastLocation->verticalAccuracy = [[location valueForKey:@"verticalAccuracy"] doubleValue];
-        lastLocation->horizontalAccuracy = [[location valueForKey:@"horizontalAccuracy"] doubleValue];
-        lastLocation->cords = cords;
-    }
-    
-    
-    
-    [OneSignalLocationManager sendLocation];
-    
-    [OneSignalLocationManager sendAndClearLocationListener:PERMISSION_GRANTED];
-    if ([OneSignalLocationManager backgroundTaskIsActive]) {
-        [OneSignalLocationManager endTask];
-    }
+        
+        [OneSignalLocationManager sendLocationFromBackground:isBackground];
+        
+        [OneSignalLocationManager sendAndClearLocationListener:PERMISSION_GRANTED];
+        if ([OneSignalLocationManager backgroundTaskIsActive]) {
+            [OneSignalLocationManager endTask];
+        }
+    });
 }
 
 - (void)locationManager:(id)manager didFailWithError:(NSError *)error {
     [OneSignalLog onesignalLog:ONE_S_LL_ERROR message:[NSString stringWithFormat:@"CLLocationManager did fail with error: %@", error]];
-    [OneSignalLocationManager sendAndClearLocationListener:ERROR];
-    if ([OneSignalLocationManager backgroundTaskIsActive]) {
-        [OneSignalLocationManager endTask];
-    }
+    dispatch_async(OneSignalLocationManager.locationQueue, ^{
+        [OneSignalLocationManager sendAndClearLocationListener:ERROR];
+        if ([OneSignalLocationManager backgroundTaskIsActive]) {
+            [OneSignalLocationManager endTask];
+        }
+    });
 }
 
+// Must be called on locationQueue
 + (void)resetSendTimer {
-    [requestLocationTimer invalidate];
-    NSTimeInterval requiredWaitTime = foregroundSendLocationWaitTime;
-    requestLocationTimer = [NSTimer scheduledTimerWithTimeInterval:requiredWaitTime target:self selector:@selector(requestLocation) userInfo:nil repeats:NO];
+    [self scheduleRequestLocationAfter:foregroundSendLocationWaitTime];
+}
+
+// Must be called on locationQueue
++ (void)scheduleRequestLocationAfter:(NSTimeInterval)delay {
+    [self cancelRequestLocationTimer];
+    requestLocationTimer = dispatch_source_create(DISPATCH_SOURCE_TYPE_TIMER, 0, 0, self.locationQueue);
+    requestLocationFireDate = [NSDate dateWithTimeIntervalSinceNow:delay];
+    // Leeway lets the system batch this wake-up with others
+    dispatch_source_set_timer(requestLocationTimer, dispatch_time(DISPATCH_TIME_NOW, (int64_t)(delay * NSEC_PER_SEC)), DISPATCH_TIME_FOREVER, 10 * NSEC_PER_SEC);
+    dispatch_source_set_event_handler(requestLocationTimer, ^{
+        // Left set (but not repeating) so onFocus and the delegate know a request is outstanding, as with the old NSTimer
+        dispatch_async(dispatch_get_main_queue(), ^{
+            [OneSignalLocationManager requestLocation];
+        });
+    });
+    dispatch_resume(requestLocationTimer);
 }
 
-+ (void)sendLocation {
+// Must be called on locationQueue
++ (void)cancelRequestLocationTimer {
+    if (requestLocationTimer)
+        dispatch_source_cancel(requestLocationTimer);
+    requestLocationTimer = nil;
+    requestLocationFireDate = nil;
+}
+
+// Must be called on locationQueue
++ (void)sendLocationFromBackground:(BOOL)isBackground {
     // return if the user has not granted privacy permissions
     if ([OSPrivacyConsentController requiresUserPrivacyConsent])
         return;
@@ -429,11 +607,18 @@ static OneSignalLocationManager* singleInstance = nil;
             return;
         
         //Fired from timer and not initial location fetched
-        if (initialLocationSent && [UIApplication sharedApplication].applicationState != UIApplicationStateBackground)
+        if (initialLocationSent && !isBackground)
             [OneSignalLocationManager resetSendTimer];
         
         initialLocationSent = YES;
         
+        if (![OneSignalLocationManager isSignificantChangeFromLastSent:lastLocation->cords]) {
+            [OneSignalLog onesignalLog:ONE_S_LL_VERBOSE message:@"OneSignalLocation skipping location within distance and time thresholds of the last one sent"];
+            return;
+        }
+        lastSentCords = lastLocation->cords;
+        lastSentDate = [NSDate date];
+        
         CGFloat latitude = lastLocation->cords.latitude;
         CGFloat longitude = lastLocation->cords.longitude;
         [OneSignalUserManagerImpl.sharedInstance setLocationWithLatitude:latitude longitude:longitude];
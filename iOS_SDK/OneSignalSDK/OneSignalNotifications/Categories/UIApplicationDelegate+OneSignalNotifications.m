@@ -52,7 +52,7 @@ static NSMutableSet<Class>* swizzledClasses;
 
 - (void) setOneSignalDelegate:(id<UIApplicationDelegate>)delegate {
     [OneSignalNotificationsAppDelegate traceCall:@"setOneSignalDelegate:"];
-    [OneSignalLog onesignalLog:ONE_S_LL_VERBOSE message:[NSString stringWithFormat:@"ONESIGNAL setOneSignalDelegate CALLED: %@", delegate]];
+    ONE_S_LOG(ONE_S_LL_VERBOSE, @"ONESIGNAL setOneSignalDelegate CALLED: %@", delegate);
     
     if (swizzledClasses == nil)
         swizzledClasses = [NSMutableSet new];
@@ -96,13 +96,13 @@ static NSMutableSet<Class>* swizzledClasses;
 
 + (BOOL)swizzledClassInHeirarchy:(Class)delegateClass {
     if ([swizzledClasses containsObject:delegateClass]) {
-        [OneSignalLog onesignalLog:ONE_S_LL_VERBOSE message:[NSString stringWithFormat:@"OneSignal already swizzled %@", NSStringFromClass(delegateClass)]];
+        ONE_S_LOG(ONE_S_LL_VERBOSE, @"OneSignal already swizzled %@", NSStringFromClass(delegateClass));
         return true;
     }
     Class superClass = class_getSuperclass(delegateClass);
     while(superClass) {
         if ([swizzledClasses containsObject:superClass]) {
-            [OneSignalLog onesignalLog:ONE_S_LL_VERBOSE message:[NSString stringWithFormat:@"OneSignal already swizzled %@ in super class: %@", NSStringFromClass(delegateClass), NSStringFromClass(superClass)]];
+            ONE_S_LOG(ONE_S_LL_VERBOSE, @"OneSignal already swizzled %@ in super class: %@", NSStringFromClass(delegateClass), NSStringFromClass(superClass));
             return true;
         }
         superClass = class_getSuperclass(superClass);
@@ -34,6 +34,7 @@
 + (void)swizzleSelectorsOnDelegate:(id)delegate;
 + (void)registerDelegate;
 + (void)setUseiOS10_2_workaround:(BOOL)enable;
++ (void)processiOS10Open:(UNNotificationResponse *)response;
 
 // Our named swizzling methods on UNNotificationCenter
 - (void)setOneSignalUNDelegate:(id)delegate;
@@ -199,13 +199,13 @@ static NSMutableSet<Class>* swizzledClasses;
 
 + (BOOL)swizzledClassInHeirarchy:(Class)delegateClass {
     if ([swizzledClasses containsObject:delegateClass]) {
-        [OneSignalLog onesignalLog:ONE_S_LL_VERBOSE message:[NSString stringWithFormat:@"OneSignal already swizzled %@", NSStringFromClass(delegateClass)]];
+        ONE_S_LOG(ONE_S_LL_VERBOSE, @"OneSignal already swizzled %@", NSStringFromClass(delegateClass));
         return true;
     }
     Class superClass = class_getSuperclass(delegateClass);
     while(superClass) {
         if ([swizzledClasses containsObject:superClass]) {
-            [OneSignalLog onesignalLog:ONE_S_LL_VERBOSE message:[NSString stringWithFormat:@"OneSignal already swizzled %@ in super class: %@", NSStringFromClass(delegateClass), NSStringFromClass(superClass)]];
+            ONE_S_LOG(ONE_S_LL_VERBOSE, @"OneSignal already swizzled %@ in super class: %@", NSStringFromClass(delegateClass), NSStringFromClass(superClass));
             return true;
         }
         superClass = class_getSuperclass(superClass);
@@ -275,7 +275,7 @@ static NSMutableSet<Class>* swizzledClasses;
         return;
     }
 
-    [OneSignalLog onesignalLog:ONE_S_LL_VERBOSE message:[NSString stringWithFormat:@"onesignalUserNotificationCenter:willPresentNotification:withCompletionHandler: Fired! %@", notification.request.content.body]];
+    ONE_S_LOG(ONE_S_LL_VERBOSE, @"onesignalUserNotificationCenter:willPresentNotification:withCompletionHandler: Fired! %@", notification.request.content.body);
     
     [OSNotificationsManager handleWillPresentNotificationInForegroundWithPayload:notification.request.content.userInfo withCompletion:^(OSNotification *responseNotif) {
         UNNotificationPresentationOptions displayType = responseNotif != nil ? (UNNotificationPresentationOptions)7 : (UNNotificationPresentationOptions)0;
@@ -292,7 +292,7 @@ void finishProcessingNotification(UNNotification *notification,
     [OneSignalLog onesignalLog:ONE_S_LL_VERBOSE message:@"finishProcessingNotification: Fired!"];
     NSUInteger completionHandlerOptions = displayType;
     
-    [OneSignalLog onesignalLog:ONE_S_LL_VERBOSE message:[NSString stringWithFormat:@"Notification display type: %lu", (unsigned long)displayType]];
+    ONE_S_LOG(ONE_S_LL_VERBOSE, @"Notification display type: %lu", (unsigned long)displayType);
     
     if ([OneSignalConfigManager getAppId])
         [OSNotificationsManager notificationReceived:notification.request.content.userInfo wasOpened:NO];
@@ -304,7 +304,7 @@ void finishProcessingNotification(UNNotification *notification,
     //   App dev may have not implented userNotificationCenter:willPresentNotification.
     //   App dev may have implemented this selector but forgot to call completionHandler().
     // Note - iOS only uses the first call to completionHandler().
-    [OneSignalLog onesignalLog:ONE_S_LL_VERBOSE message:[NSString stringWithFormat:@"finishProcessingNotification: call completionHandler with options: %lu",(unsigned long)completionHandlerOptions]];
+    ONE_S_LOG(ONE_S_LL_VERBOSE, @"finishProcessingNotification: call completionHandler with options: %lu",(unsigned long)completionHandlerOptions);
     completionHandler(completionHandlerOptions);
 }
 
@@ -35,6 +35,7 @@
 #import <OneSignalCore/OSDeviceUtils.h>
 #import <OneSignalCore/OSMacros.h>
 #import <OneSignalCore/OneSignalCoreHelper.h>
+#import <OneSignalCore/OSDispatchQueues.h>
 
 @interface OneSignalNotificationSettings ()
 // Used as both an optimization and to prevent queue deadlocks.
@@ -52,7 +53,7 @@ static dispatch_queue_t serialQueue;
 }
 
 - (instancetype)init {
-    serialQueue = dispatch_queue_create("com.onesignal.notification.settings.ios10", DISPATCH_QUEUE_SERIAL);
+    serialQueue = dispatch_queue_create_with_target("com.onesignal.notification.settings.ios10", DISPATCH_QUEUE_SERIAL, OSDispatchQueues.userInitiated);
     return [super init];
 }
 
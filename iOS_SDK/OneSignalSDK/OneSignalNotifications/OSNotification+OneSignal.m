@@ -28,16 +28,122 @@
 #import "OSNotification+OneSignal.h"
 #import <OneSignalCore/OneSignalCore.h>
 #import <UIKit/UIKit.h>
+#import <OneSignalExtension/OneSignalExtensionBadgeHandler.h>
 
 @interface OSNotification ()
 - (void)initWithRawMessage:(NSDictionary*)message;
 @end
 
-@implementation OSDisplayableNotification
+@interface OSDisplayableNotification ()
+- (void)displayTimeoutFired;
+@end
+
+/*
+ Pending display decisions are timed out by one scheduler, ordered by deadline, with a single main queue timer
+ armed for the earliest deadline. A burst of foreground notifications then does not add a run loop timer each.
+ Pending notifications are retained until they complete or time out, as a scheduled NSTimer retained its target.
+ */
+@interface OSDisplayTimeoutScheduler : NSObject
++ (OSDisplayTimeoutScheduler *)sharedScheduler;
+- (void)scheduleTimeoutForNotification:(OSDisplayableNotification *)notification after:(NSTimeInterval)timeout;
+- (void)cancelTimeoutForNotification:(OSDisplayableNotification *)notification;
+@end
+
+@implementation OSDisplayTimeoutScheduler {
+    // Kept in deadline order, deadlines are CFAbsoluteTime. Access is synchronized on self.
+    NSMutableArray<OSDisplayableNotification *> *_notifications;
+    NSMutableArray<NSNumber *> *_deadlines;
+    dispatch_source_t _timer;
+}
+
++ (OSDisplayTimeoutScheduler *)sharedScheduler {
+    static OSDisplayTimeoutScheduler *sharedScheduler;
+    static dispatch_once_t once;
+    dispatch_once(&once, ^{
+        sharedScheduler = [OSDisplayTimeoutScheduler new];
+    });
+    return sharedScheduler;
+}
+
+- (instancetype)init {
+    if (self = [super init]) {
+        _notifications = [NSMutableArray new];
+        _deadlines = [NSMutableArray new];
+        _timer = dispatch_source_create(DISPATCH_SOURCE_TYPE_TIMER, 0, 0, dispatch_get_main_queue());
+        __weak OSDisplayTimeoutScheduler *weakSelf = self;
+        dispatch_source_set_event_handler(_timer, ^{
+            [weakSelf fireExpiredTimeouts];
+        });
+        dispatch_source_set_timer(_timer, DISPATCH_TIME_FOREVER, DISPATCH_TIME_FOREVER, 0);
+        dispatch_resume(_timer);
+    }
+    return self;
+}
+
+- (void)scheduleTimeoutForNotification:(OSDisplayableNotification *)notification after:(NSTimeInterval)timeout {
+    NSNumber *deadline = @(CFAbsoluteTimeGetCurrent() + timeout);
+    @synchronized (self) {
+        [self removeNotification:notification];
+        // Timeouts are usually the same length, so the new deadline is almost always last
+        NSUInteger index = _deadlines.count;
+        while (index > 0 && [_deadlines[index - 1] compare:deadline] == NSOrderedDescending)
+            index--;
+        [_deadlines insertObject:deadline atIndex:index];
+        [_notifications insertObject:notification atIndex:index];
+        if (index == 0)
+            [self armTimer];
+    }
+}
+
+- (void)cancelTimeoutForNotification:(OSDisplayableNotification *)notification {
+    @synchronized (self) {
+        if ([self removeNotification:notification] == 0)
+            [self armTimer];
+    }
+}
+
+// Returns the index the notification was removed from, or NSNotFound. Must be called synchronized on self.
+- (NSUInteger)removeNotification:(OSDisplayableNotification *)notification {
+    NSUInteger index = [_notifications indexOfObjectIdenticalTo:notification];
+    if (index != NSNotFound) {
+        [_notifications removeObjectAtIndex:index];
+        [_deadlines removeObjectAtIndex:index];
+    }
+    return index;
+}
+
+// Must be called synchronized on self
+- (void)armTimer {
+    if (_deadlines.count == 0) {
+        dispatch_source_set_timer(_timer, DISPATCH_TIME_FOREVER, DISPATCH_TIME_FOREVER, 0);
+        return;
+    }
+    NSTimeInterval delay = MAX(0, _deadlines.firstObject.doubleValue - CFAbsoluteTimeGetCurrent());
+    dispatch_source_set_timer(_timer, dispatch_time(DISPATCH_TIME_NOW, (int64_t)(delay * NSEC_PER_SEC)), DISPATCH_TIME_FOREVER, NSEC_PER_SEC / 10);
+}
+
+- (void)fireExpiredTimeouts {
+    NSMutableArray<OSDisplayableNotification *> *expired = [NSMutableArray new];
+    @synchronized (self) {
+        CFAbsoluteTime now = CFAbsoluteTimeGetCurrent();
+        while (_deadlines.count > 0 && _deadlines.firstObject.doubleValue <= now) {
+            [expired addObject:_notifications.firstObject];
+            [_notifications removeObjectAtIndex:0];
+            [_deadlines removeObjectAtIndex:0];
+        }
+        [self armTimer];
+    }
+    // Called outside the lock, completing a notification cancels its timeout
+    for (OSDisplayableNotification *notification in expired)
+        [notification displayTimeoutFired];
+}
+
+@end
 
-OSNotificationDisplayResponse _completion;
-NSTimer *_timeoutTimer;
-BOOL _wantsToDisplay = true;
+@implementation OSDisplayableNotification {
+    OSNotificationDisplayResponse _completion;
+    BOOL _wantsToDisplay;
+}
 
 + (instancetype)parseWithApns:(nonnull NSDictionary*)message {
     if (!message)
@@ -46,16 +152,17 @@ BOOL _wantsToDisplay = true;
     OSDisplayableNotification *osNotification = [OSDisplayableNotification new];
     
     [osNotification initWithRawMessage:message];
-    [osNotification setTimeoutTimer];
     return osNotification;
 }
 
-- (void)setTimeoutTimer {
-    _timeoutTimer = [NSTimer timerWithTimeInterval:CUSTOM_DISPLAY_TYPE_TIMEOUT target:self selector:@selector(timeoutTimerFired:) userInfo:self.notificationId repeats:false];
+- (instancetype)init {
+    if (self = [super init])
+        _wantsToDisplay = true;
+    return self;
 }
 
 - (void)startTimeoutTimer {
-    [[NSRunLoop currentRunLoop] addTimer:_timeoutTimer forMode:NSRunLoopCommonModes];
+    [[OSDisplayTimeoutScheduler sharedScheduler] scheduleTimeoutForNotification:self after:CUSTOM_DISPLAY_TYPE_TIMEOUT];
 }
 
 - (void)setCompletionBlock:(OSNotificationDisplayResponse)completion {
@@ -70,14 +177,14 @@ BOOL _wantsToDisplay = true;
 }
 
 - (void)complete:(OSDisplayableNotification *)notification {
-    [_timeoutTimer invalidate];
+    [[OSDisplayTimeoutScheduler sharedScheduler] cancelTimeoutForNotification:self];
     /*
      If notification is null here then display was cancelled and we need to
      reset the badge count to the value prior to receipt of this notif
      */
     if (!notification) {
         NSInteger previousBadgeCount = [UIApplication sharedApplication].applicationIconBadgeNumber;
-        [OneSignalUserDefaults.initShared saveIntegerForKey:ONESIGNAL_BADGE_KEY withValue:previousBadgeCount];
+        [OneSignalExtensionBadgeHandler setNeedsCachedBadgeValue:previousBadgeCount];
     }
     if (_completion) {
         _completion(notification);
@@ -93,7 +200,7 @@ BOOL _wantsToDisplay = true;
     _wantsToDisplay = display;
 }
 
-- (void)timeoutTimerFired:(NSTimer *)timer {
+- (void)displayTimeoutFired {
     [OneSignalLog onesignalLog:ONE_S_LL_WARN message:[NSString stringWithFormat:@"OSNotificationLifecycleListener:onWillDisplayNotification timed out. Display was not called within %f seconds. Continue with display notification: %d", CUSTOM_DISPLAY_TYPE_TIMEOUT, _wantsToDisplay]];
     if (_wantsToDisplay) {
         [self complete:self];
@@ -101,10 +208,4 @@ BOOL _wantsToDisplay = true;
         [self complete:nil];
     }
 }
-
-- (void)dealloc {
-    if (_timeoutTimer && _completion) {
-        [_timeoutTimer invalidate];
-    }
-}
 @end
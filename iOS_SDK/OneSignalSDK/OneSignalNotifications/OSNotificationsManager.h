@@ -30,6 +30,7 @@
 #import <OneSignalNotifications/OSPermission.h>
 #import <OneSignalCore/OneSignalCore.h>
 #import <UIKit/UIKit.h>
+#import <UserNotifications/UserNotifications.h>
 #import <OneSignalNotifications/OSNotification+OneSignal.h>
 
 @protocol OSNotificationClickListener <NSObject>
@@ -65,6 +66,13 @@ NS_SWIFT_NAME(onClick(event:));
 + (void)addPermissionObserver:(NSObject<OSNotificationPermissionObserver>*_Nonnull)observer NS_REFINED_FOR_SWIFT;
 + (void)removePermissionObserver:(NSObject<OSNotificationPermissionObserver>*_Nonnull)observer NS_REFINED_FOR_SWIFT;
 + (void)clearAll;
+
+// For apps that set OneSignal_disable_swizzling in their Info.plist and forward these delegate calls themselves
++ (void)didRegisterForRemoteNotificationsWithDeviceToken:(NSData *_Nonnull)deviceToken;
++ (void)didFailToRegisterForRemoteNotificationsWithError:(NSError *_Nonnull)error;
++ (void)didReceiveRemoteNotification:(NSDictionary *_Nonnull)userInfo fetchCompletionHandler:(void (^_Nonnull)(UIBackgroundFetchResult))completionHandler;
++ (void)willPresentNotification:(UNNotification *_Nonnull)notification withCompletionHandler:(void (^_Nonnull)(UNNotificationPresentationOptions))completionHandler;
++ (void)didReceiveNotificationResponse:(UNNotificationResponse *_Nonnull)response;
 @end
 
 
@@ -83,6 +91,8 @@ NS_SWIFT_NAME(onClick(event:));
 
 + (Class<OSNotifications> _Nonnull)Notifications;
 + (void)start;
+// Only observes the app lifecycle, the app forwards its delegate calls through the OSNotifications forwarding methods
++ (void)startWithoutSwizzling;
 + (void)setColdStartFromTapOnNotification:(BOOL)coldStartFromTapOnNotification;
 + (BOOL)getColdStartFromTapOnNotification;
 
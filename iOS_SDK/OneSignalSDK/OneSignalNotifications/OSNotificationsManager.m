@@ -31,6 +31,7 @@
 #import <UserNotifications/UserNotifications.h>
 #import "OSNotification+OneSignal.h"
 #import <OneSignalExtension/OneSignalAttachmentHandler.h>
+#import <OneSignalExtension/OneSignalExtensionBadgeHandler.h>
 #import "OneSignalWebViewManager.h"
 #import "UNUserNotificationCenter+OneSignalNotifications.h"
 #import "UIApplicationDelegate+OneSignalNotifications.h"
@@ -112,7 +113,7 @@
 }
 
 - (void)preventDefault {
-    [OneSignalLog onesignalLog:ONE_S_LL_VERBOSE message:[NSString stringWithFormat:@"OSNotificationWillDisplayEvent.preventDefault called."]];
+    ONE_S_LOG(ONE_S_LL_VERBOSE, @"OSNotificationWillDisplayEvent.preventDefault called.");
     _notification.wantsToDisplay = false;
 }
 
@@ -132,10 +133,12 @@ static id<OneSignalNotificationsDelegate> _delegate;
     _delegate = delegate;
 }
 
-static NSMutableArray<NSObject<OSNotificationLifecycleListener> *> *_lifecycleListeners;
-+ (NSMutableArray<NSObject<OSNotificationLifecycleListener> *>*)lifecycleListeners {
-    if (!_lifecycleListeners)
-        _lifecycleListeners = [NSMutableArray new];
++ (OSListenerRegistry<NSObject<OSNotificationLifecycleListener> *> *)lifecycleListeners {
+    static OSListenerRegistry *_lifecycleListeners;
+    static dispatch_once_t once;
+    dispatch_once(&once, ^{
+        _lifecycleListeners = [OSListenerRegistry new];
+    });
     return _lifecycleListeners;
 }
 
@@ -147,10 +150,12 @@ BOOL requestedProvisionalAuthorization = false;
 static int mSubscriptionStatus = -1;
 
 static NSMutableArray<OSNotificationClickEvent*> *_unprocessedClickEvents;
-static NSMutableArray<NSObject<OSNotificationClickListener> *> *_clickListeners;
-+ (NSMutableArray<NSObject<OSNotificationClickListener> *>*)clickListeners {
-    if (!_clickListeners)
-        _clickListeners = [NSMutableArray new];
++ (OSListenerRegistry<NSObject<OSNotificationClickListener> *> *)clickListeners {
+    static OSListenerRegistry *_clickListeners;
+    static dispatch_once_t once;
+    dispatch_once(&once, ^{
+        _clickListeners = [OSListenerRegistry new];
+    });
     return _clickListeners;
 }
 
@@ -188,7 +193,8 @@ static OneSignalNotificationSettings *_osNotificationSettings;
 static ObservablePermissionStateChangesType* _permissionStateChangesObserver;
 + (ObservablePermissionStateChangesType*)permissionStateChangesObserver {
     if (!_permissionStateChangesObserver)
-        _permissionStateChangesObserver = [[OSBoolObservable alloc] initWithChangeSelector:@selector(onNotificationPermissionDidChange:)];
+        // Permission flaps between states while registering, observers only need where it settled
+        _permissionStateChangesObserver = [[OSBoolObservable alloc] initWithChangeSelector:@selector(onNotificationPermissionDidChange:) coalescingInterval:0];
     return _permissionStateChangesObserver;
 }
 
@@ -257,7 +263,63 @@ static NSString *_pushSubscriptionId;
 }
 #pragma clang diagnostic pop
 
++ (void)startWithoutSwizzling {
+    [OneSignalLog onesignalLog:ONE_S_LL_VERBOSE message:@"OSNotificationsManager started without swizzling, the app forwards its delegate calls"];
+    [self registerLifecycleObserver];
+}
+
+#pragma mark Delegate forwarding
+
++ (void)didRegisterForRemoteNotificationsWithDeviceToken:(NSData *)deviceToken {
+    [self didRegisterForRemoteNotifications:[UIApplication sharedApplication] deviceToken:deviceToken];
+}
+
++ (void)didFailToRegisterForRemoteNotificationsWithError:(NSError *)error {
+    if ([OneSignalConfigManager getAppId])
+        [self handleDidFailRegisterForRemoteNotification:error];
+}
+
+// Same handling as the swizzled application:didReceiveRemoteNotification:fetchCompletionHandler:, on iOS 10+
++ (void)didReceiveRemoteNotification:(NSDictionary *)userInfo fetchCompletionHandler:(void (^)(UIBackgroundFetchResult))completionHandler {
+    BOOL startedBackgroundJob = false;
+    if ([OneSignalConfigManager getAppId]) {
+        let application = [UIApplication sharedApplication];
+        if (application.applicationState == UIApplicationStateActive && userInfo[@"aps"][@"alert"] != nil)
+            [self notificationReceived:userInfo wasOpened:NO];
+        else
+            startedBackgroundJob = [self receiveRemoteNotification:application UserInfo:userInfo completionHandler:completionHandler];
+    }
+    
+    if (!startedBackgroundJob)
+        completionHandler(UIBackgroundFetchResultNewData);
+}
+
++ (void)willPresentNotification:(UNNotification *)notification withCompletionHandler:(void (^)(UNNotificationPresentationOptions))completionHandler {
+    let userInfo = notification.request.content.userInfo;
+    if ([OSPrivacyConsentController shouldLogMissingPrivacyConsentErrorWithMethodName:nil] || ![OneSignalCoreHelper isOneSignalPayload:userInfo]) {
+        completionHandler(7);
+        return;
+    }
+    
+    [self handleWillPresentNotificationInForegroundWithPayload:userInfo withCompletion:^(OSNotification *responseNotif) {
+        if ([OneSignalConfigManager getAppId])
+            [self notificationReceived:userInfo wasOpened:NO];
+        completionHandler(responseNotif != nil ? (UNNotificationPresentationOptions)7 : (UNNotificationPresentationOptions)0);
+    }];
+}
+
++ (void)didReceiveNotificationResponse:(UNNotificationResponse *)response {
+    if ([OSPrivacyConsentController shouldLogMissingPrivacyConsentErrorWithMethodName:nil])
+        return;
+    
+    [OneSignalNotificationsUNUserNotificationCenter processiOS10Open:response];
+}
+
 + (void)registerLifecycleObserver {
+    // Submit opens persisted by a launch that was terminated before flushing them
+    if ([OneSignalUserDefaults.initStandard keyExists:OSUD_PENDING_NOTIFICATION_OPENS]) {
+        [self schedulePendingNotificationOpensFlush];
+    }
     // Replacing swizzled lifecycle selectors with notification center observers for scene based Apps
     if ([OSBundleUtils isAppUsingUIScene]) {
         [self registerLifecycleObserverAsUIScene];
@@ -280,7 +342,46 @@ static NSString *_pushSubscriptionId;
 
 + (void)willEnterForeground {
     [OSNotificationsManager clearBadgeCount:false fromClearAll:false];
-    [OSNotificationsManager sendNotificationTypesUpdateToDelegate];
+    [OSNotificationsManager refreshPermissionStateIfNeeded];
+    if ([OneSignalUserDefaults.initStandard keyExists:OSUD_PENDING_NOTIFICATION_OPENS]) {
+        [OSNotificationsManager schedulePendingNotificationOpensFlush];
+    }
+}
+
+static BOOL _notificationOpensFlushScheduled = false;
+static NSUInteger _notificationOpensGeneration = 0;
+// Opens submitted and waiting on their response, so a second flush does not send them again. Synchronized on the class.
+static NSMutableSet<NSString *> *_notificationOpensInFlight;
+
+static BOOL _permissionRefreshInFlight = false;
+static NSTimeInterval _lastPermissionRefreshTime = 0;
+
+/*
+ Notification settings can only change while the app is away, so they are refreshed when it comes back.
+ The query runs asynchronously instead of blocking the foreground transition. A refresh already in flight,
+ or one that finished moments ago, covers rapid background / foreground cycles.
+ The push subscription model ignores notification types that did not change, so nothing fires for those.
+ */
++ (void)refreshPermissionStateIfNeeded {
+    @synchronized (self) {
+        if (_permissionRefreshInFlight || [NSDate date].timeIntervalSince1970 - _lastPermissionRefreshTime < OS_PERMISSION_REFRESH_MIN_INTERVAL) {
+            return;
+        }
+        _permissionRefreshInFlight = true;
+    }
+    [self.osNotificationSettings getNotificationPermissionState:^(OSPermissionStateInternal *state) {
+        // The settings report the cached state while this callback runs, so this does not query them again
+        int notificationTypes = [self getNotificationTypes];
+        @synchronized (self) {
+            _permissionRefreshInFlight = false;
+            _lastPermissionRefreshTime = [NSDate date].timeIntervalSince1970;
+        }
+        [OneSignalCoreHelper dispatch_async_on_main_queue:^{
+            if (self.delegate && [self.delegate respondsToSelector:@selector(setNotificationTypes:)]) {
+                [self.delegate setNotificationTypes:notificationTypes];
+            }
+        }];
+    }];
 }
 
 + (void)resetLocals {
@@ -311,7 +412,7 @@ static NSString *_pushSubscriptionId;
     if ([OSPrivacyConsentController shouldLogMissingPrivacyConsentErrorWithMethodName:@"requestPermission:"])
         return;
     
-    [OneSignalLog onesignalLog:ONE_S_LL_VERBOSE message:[NSString stringWithFormat:@"requestPermission Called"]];
+    ONE_S_LOG(ONE_S_LL_VERBOSE, @"requestPermission Called");
     
     self.currentPermissionState.hasPrompted = true;
     
@@ -411,7 +512,10 @@ static NSString *_pushSubscriptionId;
 }
 
 + (void)clearAll {
-    [[UNUserNotificationCenter currentNotificationCenter] removeAllDeliveredNotifications];
+    // Removing many delivered notifications can take a while, UNUserNotificationCenter is safe to use off the main thread
+    dispatch_async(OSDispatchQueues.utility, ^{
+        [[UNUserNotificationCenter currentNotificationCenter] removeAllDeliveredNotifications];
+    });
     // removing delivered notifications doesn't update the badge count
     [self clearBadgeCount:false fromClearAll:true];
 }
@@ -509,7 +613,7 @@ static NSString *_pushSubscriptionId;
 
 //    User just responed to the iOS native notification permission prompt.
 + (void)updateNotificationTypes:(int)notificationTypes {
-    [OneSignalLog onesignalLog:ONE_S_LL_VERBOSE message:[NSString stringWithFormat:@"updateNotificationTypes called: %d", notificationTypes]];
+    ONE_S_LOG(ONE_S_LL_VERBOSE, @"updateNotificationTypes called: %d", notificationTypes);
     
     // TODO: Dropped support, can remove below?
     if ([OSDeviceUtils isIOSVersionLessThan:@"10.0"])
@@ -517,7 +621,7 @@ static NSString *_pushSubscriptionId;
     
     BOOL startedRegister = [OSNotificationsManager registerForAPNsToken];
     
-    [OneSignalLog onesignalLog:ONE_S_LL_VERBOSE message:[NSString stringWithFormat:@"startedRegister: %d", startedRegister]];
+    ONE_S_LOG(ONE_S_LL_VERBOSE, @"startedRegister: %d", startedRegister);
     
     // TODO: Dropped support, can remove below?
     [self.osNotificationSettings onNotificationPromptResponse:notificationTypes]; // iOS 9 only
@@ -575,6 +679,11 @@ static NSString *_pushSubscriptionId;
 }
 
 + (void)clearStatics {
+    _notificationOpensFlushScheduled = false;
+    _notificationOpensGeneration = 0;
+    _notificationOpensInFlight = nil;
+    _permissionRefreshInFlight = false;
+    _lastPermissionRefreshTime = 0;
     _waitingForApnsResponse = false;
     _currentPermissionState = nil;
     _lastPermissionState = nil;
@@ -608,7 +717,7 @@ static NSString *_lastnonActiveMessageId;
     if (![OneSignalCoreHelper isOneSignalPayload:messageDict])
         return;
     
-    [OneSignalLog onesignalLog:ONE_S_LL_VERBOSE message:[NSString stringWithFormat:@"notificationReceived called! opened: %@", opened ? @"YES" : @"NO"]];
+    ONE_S_LOG(ONE_S_LL_VERBOSE, @"notificationReceived called! opened: %@", opened ? @"YES" : @"NO");
     
     NSDictionary* customDict = [messageDict objectForKey:@"os_data"] ?: [messageDict objectForKey:@"custom"];
     
@@ -640,11 +749,18 @@ static NSString *_lastnonActiveMessageId;
     }
 }
 
+/*
+ The last id catches the common case of the same open reported twice in a row without touching storage.
+ Otherwise the id is claimed in the processed notifications shared with the NSE, which also catches
+ redeliveries and opens replayed on a later launch.
+ */
 + (NSString*)checkForProcessedDups:(NSDictionary*)customDict lastMessageId:(NSString*)lastMessageId {
     if (customDict && customDict[@"i"]) {
         NSString* currentNotificationId = customDict[@"i"];
         if ([currentNotificationId isEqualToString:lastMessageId])
             return @"dup";
+        if (![OSProcessedNotifications claimNotificationId:currentNotificationId kind:OS_PROCESSED_NOTIFICATION_OPENED])
+            return @"dup";
         return customDict[@"i"];
     }
     return nil;
@@ -669,6 +785,9 @@ static NSString *_lastnonActiveMessageId;
 
 + (void)handleWillShowInForegroundForNotification:(OSDisplayableNotification *)notification completion:(OSNotificationDisplayResponse)completion {
     [notification setCompletionBlock:completion];
+    // A notification shown while the app is in use is likely to be tapped right away
+    if (![self shouldSuppressURL])
+        [OSURLPrewarmer prewarmURLString:notification.launchURL];
     if (self.lifecycleListeners.count == 0) {
         completion(notification);
         return;
@@ -677,14 +796,14 @@ static NSString *_lastnonActiveMessageId;
     [notification startTimeoutTimer];
     OSNotificationWillDisplayEvent *event = [[OSNotificationWillDisplayEvent alloc] initWithDisplayableNotification:notification];
     
-    for (NSObject<OSNotificationLifecycleListener> *listener in self.lifecycleListeners) {
+    for (NSObject<OSNotificationLifecycleListener> *listener in self.lifecycleListeners.listeners) {
         if ([listener respondsToSelector:@selector(onWillDisplayNotification:)]) {
             [listener onWillDisplayNotification:event];
         }
     }
 
     if (![event isPreventDefault]) {
-        [OneSignalLog onesignalLog:ONE_S_LL_VERBOSE message:[NSString stringWithFormat:@"OSNotificationWillDisplayEvent's preventDefault not called, now display notification with notificationId %@.", notification.notificationId]];
+        ONE_S_LOG(ONE_S_LL_VERBOSE, @"OSNotificationWillDisplayEvent's preventDefault not called, now display notification with notificationId %@.", notification.notificationId);
         [notification complete:notification];
     }
 }
@@ -701,9 +820,7 @@ static NSString *_lastnonActiveMessageId;
         return;
 
     NSDictionary* customDict = [messageDict objectForKey:@"custom"] ?: [messageDict objectForKey:@"os_data"];
-    // Notify backend that user opened the notification
     NSString* messageId = [customDict objectForKey:@"i"];
-    [self submitNotificationOpened:messageId];
     
     let isActive = [UIApplication sharedApplication].applicationState == UIApplicationStateActive;
     
@@ -714,8 +831,6 @@ static NSString *_lastnonActiveMessageId;
         // Try to fetch the open url to launch
         [self launchWebURL:notification.launchURL]; //TODO: where should this live?
     }
-        
-    [self clearBadgeCount:true fromClearAll:false];
     
     NSString* actionID = NULL;
     if (actionType == OSNotificationActionTypeActionTaken) {
@@ -731,7 +846,15 @@ static NSString *_lastnonActiveMessageId;
         [[OSSessionManager sharedSessionManager] onDirectInfluenceFromNotificationOpen:NOTIFICATION_CLICK withNotificationId:messageId];
     }
 
-    [self handleNotificationActionWithUrl:notification.launchURL actionID:actionID];
+    // The click is delivered before the bookkeeping below, so the app can route the tap as soon as possible.
+    // The direct influence above is set first so outcomes sent from a click listener are attributed to the notification.
+    [self handleNotificationActionWithUrl:notification.launchURL actionID:actionID notification:notification];
+
+    dispatch_async(dispatch_get_main_queue(), ^{
+        // Notify backend that user opened the notification
+        [self submitNotificationOpened:messageId];
+        [self clearBadgeCount:true fromClearAll:false];
+    });
 }
 
 + (void)submitNotificationOpened:(NSString*)messageId {
@@ -745,14 +868,101 @@ static NSString *_lastnonActiveMessageId;
     NSString* lastMessageId = [standardUserDefaults getSavedStringForKey:OSUD_LAST_MESSAGE_OPENED defaultValue:nil];
     //Only submit request if messageId not nil and: (lastMessage is nil or not equal to current one)
     if(messageId && (!lastMessageId || ![lastMessageId isEqualToString:messageId])) {
-        [OneSignalCoreImpl.sharedClient executeRequest:[OSRequestSubmitNotificationOpened withUserId:[self pushSubscriptionId]
-                                                                                             appId:[OneSignalConfigManager getAppId]
+        [standardUserDefaults saveStringForKey:OSUD_LAST_MESSAGE_OPENED withValue:messageId];
+        [self bufferNotificationOpened:messageId];
+    }
+}
+
+/*
+ Opens are persisted and submitted together after OS_NOTIFICATION_OPENS_FLUSH_DELAY without another open,
+ so opening a group of notifications, or replaying clicks on a cold start, is one burst instead of a request each.
+ There is no endpoint taking several opens, each is still its own low priority request.
+ Opens left over from a terminated launch, or whose request failed, are submitted on the next foreground or launch.
+ */
++ (void)bufferNotificationOpened:(NSString *)messageId {
+    @synchronized (self) {
+        let standardUserDefaults = OneSignalUserDefaults.initStandard;
+        NSMutableArray<NSString *> *pending = [[standardUserDefaults getSavedObjectForKey:OSUD_PENDING_NOTIFICATION_OPENS defaultValue:@[]] mutableCopy];
+        if (![pending containsObject:messageId]) {
+            [pending addObject:messageId];
+            [standardUserDefaults saveObjectForKey:OSUD_PENDING_NOTIFICATION_OPENS withValue:pending];
+        }
+        _notificationOpensGeneration++;
+    }
+    [self schedulePendingNotificationOpensFlush];
+}
+
++ (void)schedulePendingNotificationOpensFlush {
+    if (OS_NOTIFICATION_OPENS_FLUSH_DELAY == 0) {
+        [self flushPendingNotificationOpens];
+        return;
+    }
+    NSUInteger generation;
+    @synchronized (self) {
+        _notificationOpensFlushScheduled = true;
+        generation = _notificationOpensGeneration;
+    }
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(OS_NOTIFICATION_OPENS_FLUSH_DELAY * NSEC_PER_SEC)), OSDispatchQueues.utility, ^{
+        @synchronized (self) {
+            // Another open arrived since, its own flush covers this one
+            if (!_notificationOpensFlushScheduled || generation != _notificationOpensGeneration) {
+                return;
+            }
+        }
+        [self flushPendingNotificationOpens];
+    });
+}
+
++ (void)flushPendingNotificationOpens {
+    NSMutableArray<NSString *> *toSubmit = [NSMutableArray new];
+    @synchronized (self) {
+        _notificationOpensFlushScheduled = false;
+        if (!_notificationOpensInFlight)
+            _notificationOpensInFlight = [NSMutableSet new];
+        NSArray<NSString *> *pending = [OneSignalUserDefaults.initStandard getSavedObjectForKey:OSUD_PENDING_NOTIFICATION_OPENS defaultValue:@[]];
+        for (NSString *messageId in pending) {
+            if (![_notificationOpensInFlight containsObject:messageId]) {
+                [_notificationOpensInFlight addObject:messageId];
+                [toSubmit addObject:messageId];
+            }
+        }
+    }
+    if (toSubmit.count == 0)
+        return;
+    
+    // The subscription id is read now rather than at open time, so opens replayed on a cold start are more likely to have it
+    NSString *pushSubscriptionId = [self pushSubscriptionId];
+    NSString *appId = [OneSignalConfigManager getAppId];
+    ONE_S_LOG(ONE_S_LL_VERBOSE, @"Submitting %lu notification opens", (unsigned long)toSubmit.count);
+    for (NSString *messageId in toSubmit) {
+        // An open stays persisted until it is sent, one that fails is submitted again on the next foreground or launch
+        [OneSignalCoreImpl.sharedClient executeRequest:[OSRequestSubmitNotificationOpened withUserId:pushSubscriptionId
+                                                                                             appId:appId
                                                                                          wasOpened:YES
                                                                                          messageId:messageId
                                                                                     withDeviceType:[NSNumber numberWithInt:DEVICE_TYPE_PUSH]]
-                                           onSuccess:nil
-                                           onFailure:nil];
-        [standardUserDefaults saveStringForKey:OSUD_LAST_MESSAGE_OPENED withValue:messageId];
+                                           onSuccess:^(NSDictionary *result) {
+            [self finishSubmittingNotificationOpened:messageId remove:true];
+        } onFailure:^(OneSignalClientError *error) {
+            // Requests the backend rejects would fail the same way on every launch
+            BOOL rejected = error.code >= 400 && error.code < 500 && error.code != 429;
+            [self finishSubmittingNotificationOpened:messageId remove:rejected];
+        }];
+    }
+}
+
++ (void)finishSubmittingNotificationOpened:(NSString *)messageId remove:(BOOL)remove {
+    @synchronized (self) {
+        [_notificationOpensInFlight removeObject:messageId];
+        if (!remove)
+            return;
+        let standardUserDefaults = OneSignalUserDefaults.initStandard;
+        NSMutableArray<NSString *> *pending = [[standardUserDefaults getSavedObjectForKey:OSUD_PENDING_NOTIFICATION_OPENS defaultValue:@[]] mutableCopy];
+        [pending removeObject:messageId];
+        if (pending.count == 0)
+            [standardUserDefaults removeValueForKey:OSUD_PENDING_NOTIFICATION_OPENS];
+        else
+            [standardUserDefaults saveObjectForKey:OSUD_PENDING_NOTIFICATION_OPENS withValue:pending];
     }
 }
 
@@ -762,6 +972,8 @@ static NSString *_lastnonActiveMessageId;
     
     if (toOpenUrl && [OneSignalCoreHelper verifyURL:toOpenUrl]) {
         NSURL *url = [NSURL URLWithString:toOpenUrl];
+        // Resolves the host while waiting below, in case it was not already when the notification was displayed
+        [OSURLPrewarmer prewarmURLString:toOpenUrl];
         // Give the app resume animation time to finish when tapping on a notification from the notification center.
         // Isn't a requirement but improves visual flow.
         [self performSelector:@selector(displayWebView:) withObject:url afterDelay:0.5];
@@ -795,16 +1007,22 @@ static NSString *_lastnonActiveMessageId;
     
     if (_disableBadgeClearing && !fromClearAll) {
         // The customer could have manually changed the badge value. We must ensure our cached value will match the current state.
-        [OneSignalUserDefaults.initShared saveIntegerForKey:ONESIGNAL_BADGE_KEY withValue:[UIApplication sharedApplication].applicationIconBadgeNumber];
+        [OneSignalExtensionBadgeHandler setNeedsCachedBadgeValue:[UIApplication sharedApplication].applicationIconBadgeNumber];
         return false;
     }
     
     bool wasBadgeSet = [UIApplication sharedApplication].applicationIconBadgeNumber > 0;
     
     if (fromNotifOpened || wasBadgeSet) {
-        [OneSignalCoreHelper runOnMainThread:^{
-            [[UIApplication sharedApplication] setApplicationIconBadgeNumber:0];
-        }];
+        if (@available(iOS 16.0, *)) {
+            // Updates the badge without a round trip through the main thread, the swizzled setter is not called so the cache is updated here
+            [[UNUserNotificationCenter currentNotificationCenter] setBadgeCount:0 withCompletionHandler:nil];
+            [OneSignalExtensionBadgeHandler setNeedsCachedBadgeValue:0];
+        } else {
+            dispatch_async(dispatch_get_main_queue(), ^{
+                [[UIApplication sharedApplication] setApplicationIconBadgeNumber:0];
+            });
+        }
     }
 
     return wasBadgeSet;
@@ -821,30 +1039,46 @@ static NSString *_lastnonActiveMessageId;
     return NO;
 }
 
++ (BOOL)handleIAMRefresh:(NSDictionary *)userInfo {
+    if (![OneSignalCoreHelper isOneSignalPayload:userInfo])
+        return NO;
+    OSNotification *notification = [OSNotification parseWithApns:userInfo];
+    if (![notification additionalData][ONESIGNAL_IAM_REFRESH])
+        return NO;
+    [OneSignalLog onesignalLog:ONE_S_LL_VERBOSE message:@"IAM Refresh Detected, Begin Handling"];
+    [[NSNotificationCenter defaultCenter] postNotificationName:ONESIGNAL_POST_REFRESH_IAM object:nil userInfo:nil];
+    return YES;
+}
+
 + (void)handleNotificationActionWithUrl:(NSString*)url actionID:(NSString*)actionID {
+    if (![OneSignalCoreHelper isOneSignalPayload:_lastMessageReceived])
+        return;
+    [self handleNotificationActionWithUrl:url actionID:actionID notification:[OSNotification parseWithApns:_lastMessageReceived]];
+}
+
+// The notification is the already parsed _lastMessageReceived
++ (void)handleNotificationActionWithUrl:(NSString*)url actionID:(NSString*)actionID notification:(OSNotification *)notification {
     if (![OneSignalCoreHelper isOneSignalPayload:_lastMessageReceived])
         return;
     
     OSNotificationClickResult *result = [[OSNotificationClickResult alloc] initWithUrl:url :actionID];
-    OSNotification *notification = [OSNotification parseWithApns:_lastMessageReceived];
     OSNotificationClickEvent *event = [[OSNotificationClickEvent alloc] initWithNotification:notification result:result];
     
     // Prevent duplicate calls to same action
     if ([notification.notificationId isEqualToString:_lastMessageIdFromAction])
         return;
     _lastMessageIdFromAction = notification.notificationId;
-    
-    [OneSignalTrackFirebaseAnalytics trackOpenEvent:event];
   
     if (self.clickListeners.count == 0) {
         [self addUnprocessedClickEvent:event];
-        return;
+    } else {
+        [self fireClickListenersForEvent:event];
     }
-    [self fireClickListenersForEvent:event];
+    [OneSignalTrackFirebaseAnalytics trackOpenEvent:event];
 }
 
 + (void)fireClickListenersForEvent:(OSNotificationClickEvent*)event {
-    for (NSObject<OSNotificationClickListener> *listener in self.clickListeners) {
+    for (NSObject<OSNotificationClickListener> *listener in self.clickListeners.listeners) {
         if ([listener respondsToSelector:@selector(onClickNotification:)]) {
             [listener onClickNotification:event];
         }
@@ -864,23 +1098,23 @@ static NSString *_lastnonActiveMessageId;
 }
 
 + (void)addClickListener:(NSObject<OSNotificationClickListener>*)listener {
-    [self.clickListeners addObject:listener];
+    [self.clickListeners addListener:listener];
     [OneSignalLog onesignalLog:ONE_S_LL_VERBOSE message:@"Notification click listener added successfully"];
     [self fireClickListenersForUnprocessedEvents];
 }
 
 + (void)removeClickListener:(NSObject<OSNotificationClickListener>*)listener {
-    [self.clickListeners removeObject:listener];
+    [self.clickListeners removeListener:listener];
     [OneSignalLog onesignalLog:ONE_S_LL_VERBOSE message:@"Notification click listener removed successfully"];
 }
 
 + (void)addForegroundLifecycleListener:(NSObject<OSNotificationLifecycleListener> *_Nullable)listener {
-    [self.lifecycleListeners addObject:listener];
+    [self.lifecycleListeners addListener:listener];
     [OneSignalLog onesignalLog:ONE_S_LL_VERBOSE message:@"ForegroundLifecycleListener added successfully"];
 }
 
 + (void)removeForegroundLifecycleListener:(NSObject<OSNotificationLifecycleListener> * _Nullable)listener {
-    [self.lifecycleListeners removeObject:listener];
+    [self.lifecycleListeners removeListener:listener];
     [OneSignalLog onesignalLog:ONE_S_LL_VERBOSE message:@"ForegroundLifecycleListener removed successfully"];
 }
 
@@ -906,7 +1140,9 @@ static NSString *_lastnonActiveMessageId;
 
 + (BOOL)receiveRemoteNotification:(UIApplication*)application UserInfo:(NSDictionary*)userInfo completionHandler:(void (^)(UIBackgroundFetchResult))completionHandler {
    var startedBackgroundJob = false;
-   
+
+   [self handleIAMRefresh:userInfo];
+
    NSDictionary* richData = nil;
    // TODO: Look into why the userInfo payload would be different here for displaying vs opening....
    // Check for buttons or attachments pre-2.4.0 version
@@ -943,7 +1179,7 @@ static NSString *_lastnonActiveMessageId;
              completionHandler:(void (^)(UIBackgroundFetchResult))completionHandler {
     
     // Start background thread to download media so we don't lock the main UI thread.
-    dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+    dispatch_async(OSDispatchQueues.utility, ^{
         [self beginBackgroundMediaTask];
         
         let notificationRequest = [self prepareUNNotificationRequest:notification];
@@ -21,6 +21,7 @@
  */
 
 import XCTest
+import OneSignalCore
 import OneSignalNotifications
 import OneSignalCoreMocks
 import UIKit
@@ -80,8 +81,59 @@ final class OneSignalNotificationsTests: XCTestCase {
         // Foreground the app for within 30 seconds
         OneSignalCoreMocks.foregroundApp()
 
-        // Ensure that the delegate is updated with the new notification type
-        XCTAssertEqual(self.notifTypes, ERROR_PUSH_NEVER_PROMPTED)
+        // Ensure that the delegate is updated with the new notification type, the settings are queried asynchronously
+        waitForNotificationTypes(ERROR_PUSH_NEVER_PROMPTED)
+    }
+
+    func testRapidForegroundsStillUpdateNotificationTypes() throws {
+        OSNotificationsManager.start()
+        OSNotificationsManager.delegate = self
+
+        // A foreground while the previous refresh is in flight reuses it
+        OneSignalCoreMocks.backgroundApp()
+        OneSignalCoreMocks.foregroundApp()
+        OneSignalCoreMocks.backgroundApp()
+        OneSignalCoreMocks.foregroundApp()
+        waitForNotificationTypes(ERROR_PUSH_NEVER_PROMPTED)
+
+        // Once it finished, the next foreground queries the settings again
+        self.notifTypes = 0
+        OneSignalCoreMocks.backgroundApp()
+        OneSignalCoreMocks.foregroundApp()
+        waitForNotificationTypes(ERROR_PUSH_NEVER_PROMPTED)
+    }
+
+    func testNotificationOpenIsKeptUntilItsRequestSucceeds() throws {
+        let client = MockOneSignalClient()
+        client.executeInstantaneously = true
+        OneSignalCoreImpl.setSharedClient(client)
+        OSNotificationsManager.clearStatics()
+        let userDefaults = OneSignalUserDefaults.initStandard()
+        userDefaults.removeValue(forKey: OSUD_PENDING_NOTIFICATION_OPENS)
+        let messageId = UUID().uuidString
+
+        // An open that fails to send stays persisted
+        client.isOffline = true
+        (OSNotificationsManager.self as AnyObject).perform(NSSelectorFromString("submitNotificationOpened:"), with: messageId)
+        XCTAssertTrue(client.hasExecutedRequestOfType(OSRequestSubmitNotificationOpened.self))
+        XCTAssertEqual(userDefaults.getSavedObject(forKey: OSUD_PENDING_NOTIFICATION_OPENS, defaultValue: nil) as? [String], [messageId])
+
+        // The next foreground submits it again and it is removed once sent
+        client.isOffline = false
+        client.fireSuccessForAllRequests = true
+        OSNotificationsManager.start()
+        OneSignalCoreMocks.backgroundApp()
+        OneSignalCoreMocks.foregroundApp()
+        XCTAssertEqual(client.executedRequests.filter { $0.isKind(of: OSRequestSubmitNotificationOpened.self) }.count, 2)
+        XCTAssertFalse(userDefaults.keyExists(OSUD_PENDING_NOTIFICATION_OPENS))
+    }
+
+    func waitForNotificationTypes(_ expected: Int32) {
+        let deadline = Date(timeIntervalSinceNow: 2)
+        while self.notifTypes != expected && deadline.timeIntervalSinceNow > 0 {
+            RunLoop.main.run(until: Date(timeIntervalSinceNow: 0.05))
+        }
+        XCTAssertEqual(self.notifTypes, expected)
     }
 
 }
@@ -33,9 +33,9 @@
     // Singleton shared instance initialized with default empty id
     private static var instance: OSIamFetchReadyCondition?
 
-    // Method to get or initialize the shared instance
+    // Method to get or initialize the shared instance, replaced when the id changes (e.g. after a login)
     @objc public static func sharedInstance(withId id: String) -> OSIamFetchReadyCondition {
-        if instance == nil {
+        if instance == nil || instance?.id != id {
             instance = OSIamFetchReadyCondition(id: id)
         }
         return instance!
@@ -28,21 +28,44 @@
 import Foundation
 import OneSignalCore
 
+/**
+ A registered condition and the callback to deliver its token to once it is met, resolved, or times out.
+ */
+private final class OSConditionWaiter {
+    let condition: OSCondition
+    let completion: (OSReadYourWriteData?) -> Void
+    var timeoutWorkItem: DispatchWorkItem?
+
+    init(condition: OSCondition, completion: @escaping (OSReadYourWriteData?) -> Void) {
+        self.condition = condition
+        self.completion = completion
+    }
+}
+
 @objc public class OSConsistencyManager: NSObject {
     // Singleton instance
     @objc public static let shared = OSConsistencyManager()
 
-    private let queue = DispatchQueue(label: "com.consistencyManager.queue")
+    private let queue = DispatchQueue(label: "com.consistencyManager.queue", target: OSDispatchQueues.utility)
+    // Completions run here so callers never execute on, or block, the manager's queue
+    private let callbackQueue = OSDispatchQueues.utility
     private var indexedTokens: [String: [NSNumber: OSReadYourWriteData]] = [:]
-    private var indexedConditions: [String: [(OSCondition, DispatchSemaphore)]] = [:] // Index conditions by condition id
+    private var indexedConditions: [String: [OSConditionWaiter]] = [:] // Index conditions by id (e.g. onesignalId)
+    // Ids with tokens, least recently written first, so tokens for users from past logins are dropped
+    private var indexedIdOrder: [String] = []
+    private let maxIndexedIds = 4
 
     // Private initializer to prevent multiple instances
     private override init() {}
 
     // Used for testing
     public func reset() {
-        indexedTokens = [:]
-        indexedConditions = [:]
+        queue.sync {
+            indexedConditions.values.forEach { $0.forEach { $0.timeoutWorkItem?.cancel() } }
+            indexedTokens = [:]
+            indexedConditions = [:]
+            indexedIdOrder = []
+        }
     }
 
     // Function to set the token in a thread-safe manner
@@ -54,55 +77,103 @@ import OneSignalCore
             }
             self.indexedTokens[id]?[nsKey] = value
             self.checkConditionsAndComplete(forId: id) // Only check conditions for this specific ID
+            self.evictStaleIds(keeping: id)
         }
     }
 
-    // Register a condition and block the caller until the condition is met
+    // Must be called on `queue`, drops the tokens of the least recently written ids past `maxIndexedIds`
+    private func evictStaleIds(keeping id: String) {
+        indexedIdOrder.removeAll { $0 == id }
+        indexedIdOrder.append(id)
+        while indexedIdOrder.count > maxIndexedIds {
+            let staleId = indexedIdOrder.removeFirst()
+            OneSignalLog.onesignalLog(.LL_VERBOSE, message: "OSConsistencyManager dropping tokens for id: \(staleId)")
+            indexedTokens[staleId] = nil
+            // Nothing will write to this id again, so release anything still waiting on it
+            complete(indexedConditions[staleId] ?? [], forId: staleId)
+        }
+    }
+
+    /**
+     Register a condition and block the caller until the condition is met.
+     Prefer the completion based variant, this parks the calling thread for the whole wait.
+     */
     @objc public func getRywTokenFromAwaitableCondition(_ condition: OSCondition, forId id: String) -> OSReadYourWriteData? {
         let semaphore = DispatchSemaphore(value: 0)
-        queue.sync {
+        var result: OSReadYourWriteData?
+        getRywTokenFromAwaitableCondition(condition, forId: id, timeout: 0) { rywData in
+            result = rywData
+            semaphore.signal()
+        }
+        semaphore.wait() // Block until the condition is met
+        return result
+    }
+
+    /**
+     Register a condition without blocking, `completion` is called on a background queue once the condition is met,
+     resolved by `resolveConditionsWithID`, or `timeout` seconds pass. A `timeout` of 0 or less waits indefinitely.
+     On timeout the completion receives the newest token available at that point, which may be nil.
+     */
+    @objc public func getRywTokenFromAwaitableCondition(_ condition: OSCondition, forId id: String, timeout: TimeInterval, completion: @escaping (OSReadYourWriteData?) -> Void) {
+        let waiter = OSConditionWaiter(condition: condition, completion: completion)
+        queue.async {
             if self.indexedConditions[id] == nil {
                 self.indexedConditions[id] = []
             }
-            self.indexedConditions[id]?.append((condition, semaphore))
+            self.indexedConditions[id]?.append(waiter)
+            if timeout > 0 {
+                let timeoutWorkItem = DispatchWorkItem { [weak self, weak waiter] in
+                    guard let self = self, let waiter = waiter else { return }
+                    OneSignalLog.onesignalLog(.LL_DEBUG, message: "Condition timed out after \(timeout)s for id: \(id)")
+                    self.complete([waiter], forId: id)
+                }
+                waiter.timeoutWorkItem = timeoutWorkItem
+                self.queue.asyncAfter(deadline: .now() + timeout, execute: timeoutWorkItem)
+            }
             self.checkConditionsAndComplete(forId: id)
         }
-        semaphore.wait() // Block until the condition is met
-        return queue.sync {
-            return condition.getNewestToken(indexedTokens: self.indexedTokens)
-        }
     }
 
     // Method to resolve conditions by condition ID (e.g. OSIamFetchReadyCondition.ID)
     @objc public func resolveConditionsWithID(id: String) {
-        guard let conditionList = indexedConditions[id] else { return }
-        var completedConditions: [(OSCondition, DispatchSemaphore)] = []
-        for (condition, semaphore) in conditionList {
-            if condition.conditionId == id {
-                semaphore.signal()
-                completedConditions.append((condition, semaphore))
+        queue.async {
+            for (indexedId, waiters) in self.indexedConditions {
+                self.complete(waiters.filter { $0.condition.conditionId == id }, forId: indexedId)
             }
         }
-        indexedConditions[id]?.removeAll { condition, semaphore in
-            completedConditions.contains(where: { $0.0 === condition && $0.1 == semaphore })
+    }
+
+    /// Re-evaluates the conditions waiting on the id, after one of them changed what it waits for.
+    @objc public func recheckConditions(forId id: String) {
+        queue.async {
+            self.checkConditionsAndComplete(forId: id)
         }
     }
 
     // Private method to check conditions for a specific id (unique ID like onesignalId)
     private func checkConditionsAndComplete(forId id: String) {
-        guard let conditionList = indexedConditions[id] else { return }
-        var completedConditions: [(OSCondition, DispatchSemaphore)] = []
-        for (condition, semaphore) in conditionList {
-            if condition.isMet(indexedTokens: indexedTokens) {
-                OneSignalLog.onesignalLog(.LL_INFO, message: "Condition met for id: \(id)")
-                semaphore.signal()
-                completedConditions.append((condition, semaphore))
-            } else {
-                OneSignalLog.onesignalLog(.LL_INFO, message: "Condition not met for id: \(id)")
-            }
+        guard let waiters = indexedConditions[id] else { return }
+        let completedWaiters = waiters.filter { waiter in
+            let isMet = waiter.condition.isMet(indexedTokens: indexedTokens)
+            OneSignalLog.onesignalLog(.LL_INFO, message: "Condition \(isMet ? "met" : "not met") for id: \(id)")
+            return isMet
+        }
+        complete(completedWaiters, forId: id)
+    }
+
+    // Must be called on `queue`, removes the waiters and delivers their newest tokens
+    private func complete(_ waiters: [OSConditionWaiter], forId id: String) {
+        guard !waiters.isEmpty else { return }
+        indexedConditions[id]?.removeAll { waiter in waiters.contains { $0 === waiter } }
+        if indexedConditions[id]?.isEmpty == true {
+            indexedConditions[id] = nil
         }
-        indexedConditions[id]?.removeAll { condition, semaphore in
-            completedConditions.contains(where: { $0.0 === condition && $0.1 == semaphore })
+        for waiter in waiters {
+            waiter.timeoutWorkItem?.cancel()
+            let rywData = waiter.condition.getNewestToken(indexedTokens: indexedTokens)
+            callbackQueue.async {
+                waiter.completion(rywData)
+            }
         }
     }
 }
@@ -0,0 +1,75 @@
+/*
+ Modified MIT License
+
+ Copyright 2024 OneSignal
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ 1. The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ 2. All copies of substantial portions of the Software may only be used in connection
+ with services provided by OneSignal.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ */
+
+import Foundation
+
+/**
+ Reusable condition that is met once a token is set for every one of `requiredKeys` under `id`.
+ Covers reads that only need "my writes have landed", conditions with extra state like
+ `OSIamFetchReadyCondition` implement `OSCondition` directly.
+ */
+@objc public class OSKeyedTokenCondition: NSObject, OSCondition {
+    // the id used to index the token map (e.g. onesignalId)
+    private let id: String
+    private let requiredKeys: [NSNumber]
+    public let conditionId: String
+
+    public init<Key: OSConsistencyKeyEnum>(conditionId: String, id: String, requiredKeys: [Key]) {
+        self.conditionId = conditionId
+        self.id = id
+        self.requiredKeys = requiredKeys.map { NSNumber(value: $0.rawValue) }
+    }
+
+    public func isMet(indexedTokens: [String: [NSNumber: OSReadYourWriteData]]) -> Bool {
+        guard let tokenMap = indexedTokens[id] else { return false }
+        return requiredKeys.allSatisfy { tokenMap[$0] != nil }
+    }
+
+    public func getNewestToken(indexedTokens: [String: [NSNumber: OSReadYourWriteData]]) -> OSReadYourWriteData? {
+        guard let tokenMap = indexedTokens[id] else { return nil }
+        return requiredKeys.compactMap { tokenMap[$0] }.max {
+            ($0.rywToken ?? "") < ($1.rywToken ?? "")
+        }
+    }
+}
+
+// MARK: - Conditions for user reads
+
+extension OSKeyedTokenCondition {
+    @objc public static let TAGS_CONDITIONID = "OSTagsReadyCondition"
+    @objc public static let SUBSCRIPTION_CONDITIONID = "OSSubscriptionReadyCondition"
+
+    // Met once tag writes for the onesignal id are readable, e.g. before rendering liquid templates
+    @objc public static func tagsReadyCondition(onesignalId: String) -> OSKeyedTokenCondition {
+        return OSKeyedTokenCondition(conditionId: TAGS_CONDITIONID, id: onesignalId, requiredKeys: [OSUserReadOffsetKey.tagsUpdate])
+    }
+
+    // Met once subscription writes for the onesignal id are readable
+    @objc public static func subscriptionReadyCondition(onesignalId: String) -> OSKeyedTokenCondition {
+        return OSKeyedTokenCondition(conditionId: SUBSCRIPTION_CONDITIONID, id: onesignalId, requiredKeys: [OSUserReadOffsetKey.subscriptionUpdate])
+    }
+}
@@ -33,6 +33,8 @@ public protocol OSBackgroundTaskHandler {
     func beginBackgroundTask(_ taskIdentifier: String)
     func endBackgroundTask(_ taskIdentifier: String)
     func setTaskInvalid(_ taskIdentifier: String)
+    /// Seconds left before background tasks expire, `Double.greatestFiniteMagnitude` when they do not.
+    @objc optional func backgroundTimeRemaining() -> TimeInterval
 }
 
 // TODO: Migrate more background tasks to use this...
@@ -70,4 +72,16 @@ public class OSBackgroundTaskManager: NSObject {
         }
         delegate.setTaskInvalid(taskIdentifier)
     }
+
+    /**
+     Whether enough background time is left to start more work, such as a request. Work that is not started
+     stays queued for the next flush instead of being cut off when the background task expires.
+     */
+    @objc
+    public static func hasTimeForBackgroundWork() -> Bool {
+        guard let timeRemaining = taskHandler?.backgroundTimeRemaining?() else {
+            return true
+        }
+        return timeRemaining >= Double(OS_BACKGROUND_TASK_MIN_TIME_REMAINING_SECONDS)
+    }
 }
@@ -31,14 +31,88 @@ import OneSignalCore
 // TODO: Known Issue: Since these don't carry the app_id, it may have changed by the time Deltas become Requests, if app_id changes.
 // All requests requiring unique ID's will effectively be dropped.
 
+/**
+ Deltas are persisted in a compact, versioned format.
+ - Version 2 stores the model by `modelId` reference when the model is held by a model store, and only embeds
+   the model otherwise, such as for a removed subscription. The value is stored as a binary property list when possible.
+   A delta whose model is no longer in any store, or whose value cannot be decoded, fails to decode and is dropped,
+   rather than being sent with an empty body.
+ - Version 1, or no version, is the legacy format that always embeds the full model and is still readable.
+ */
 open class OSDelta: NSObject, NSCoding {
+    static let encodingVersion = 2
+
     public let name: String
     public let deltaId: String
     public let timestamp: Date
     public let identityModelId: String
-    public var model: OSModel
     public let property: String
-    public let value: Any
+
+    /// The `modelId` of the model, available without resolving the model itself.
+    public let modelId: String
+
+    /// When the operation repo handed this delta to its executor. Only held in memory, like the completion handlers.
+    public internal(set) var flushedAt: Date?
+
+    /// The timestamps of this delta, for executors to attach to the requests built from it.
+    public var trace: OSDeltaTrace {
+        return OSDeltaTrace(name: name, enqueuedAt: timestamp, flushedAt: flushedAt)
+    }
+
+    private let lock = NSRecursiveLock()
+    private var _model: OSModel
+    private let _value: Any
+    // The value as it was read from the cache, so it is written back without encoding it again
+    private let encodedValue: OSDeltaEncodedValue?
+    // Callers waiting for this delta to be sent. Only held in memory, they are not called for deltas read from the cache.
+    private var completionHandlers: [(Bool) -> Void] = []
+
+    public var model: OSModel {
+        get {
+            lock.withLock {
+                return _model
+            }
+        }
+        set {
+            lock.withLock {
+                _model = newValue
+            }
+        }
+    }
+
+    public var value: Any {
+        return _value
+    }
+
+    /// The new values keyed by property, a delta for a grouped model update carries several of them.
+    public var changedProperties: [String: Any] {
+        if property == OS_MODEL_BATCH_UPDATE_PROPERTY, let changes = value as? [String: Any] {
+            return changes
+        }
+        return [property: value]
+    }
+
+    public func addCompletionHandler(_ handler: @escaping (Bool) -> Void) {
+        lock.withLock {
+            completionHandlers.append(handler)
+        }
+    }
+
+    /// Moves the completion handlers of `other` to this delta, such as when the two deltas are coalesced.
+    public func takeCompletionHandlers(from other: OSDelta) {
+        let handlers = other.removeCompletionHandlers()
+        lock.withLock {
+            completionHandlers.append(contentsOf: handlers)
+        }
+    }
+
+    /// Removes and returns the completion handlers, for the executor to call once the request for this delta completes.
+    public func removeCompletionHandlers() -> [(Bool) -> Void] {
+        lock.withLock {
+            defer { completionHandlers = [] }
+            return completionHandlers
+        }
+    }
 
     override open var description: String {
         return "<OSDelta \(name) with property: \(property) value: \(value)>"
@@ -49,19 +123,31 @@ open class OSDelta: NSObject, NSCoding {
         self.deltaId = UUID().uuidString
         self.timestamp = Date()
         self.identityModelId = identityModelId
-        self.model = model
+        self.modelId = model.modelId
+        self._model = model
         self.property = property
-        self.value = value
+        self._value = value
+        self.encodedValue = nil
     }
 
     public func encode(with coder: NSCoder) {
+        coder.encode(OSDelta.encodingVersion, forKey: "version")
         coder.encode(name, forKey: "name")
         coder.encode(deltaId, forKey: "deltaId")
         coder.encode(timestamp, forKey: "timestamp")
         coder.encode(identityModelId, forKey: "identityModelId")
-        coder.encode(model, forKey: "model")
+        coder.encode(modelId, forKey: "modelId")
         coder.encode(property, forKey: "property")
-        coder.encode(value, forKey: "value")
+
+        lock.withLock {
+            // Only embed the model if it cannot be resolved by reference when decoding
+            if !OSModelStoreRegistry.shared.contains(_model) {
+                coder.encode(_model, forKey: "model")
+            }
+            let encodedValue = self.encodedValue ?? OSDeltaEncodedValue(_value)
+            coder.encode(encodedValue.kind.rawValue, forKey: "valueKind")
+            coder.encode(encodedValue.data, forKey: "valueData")
+        }
     }
 
     public required init?(coder: NSCoder) {
@@ -69,9 +155,7 @@ open class OSDelta: NSObject, NSCoding {
               let deltaId = coder.decodeObject(forKey: "deltaId") as? String,
               let timestamp = coder.decodeObject(forKey: "timestamp") as? Date,
               let identityModelId = coder.decodeObject(forKey: "identityModelId") as? String,
-              let model = coder.decodeObject(forKey: "model") as? OSModel,
-              let property = coder.decodeObject(forKey: "property") as? String,
-              let value = coder.decodeObject(forKey: "value")
+              let property = coder.decodeObject(forKey: "property") as? String
         else {
             OneSignalLog.onesignalLog(.LL_ERROR, message: "Unable to init OSDelta from cache")
             return nil
@@ -81,8 +165,82 @@ open class OSDelta: NSObject, NSCoding {
         self.deltaId = deltaId
         self.timestamp = timestamp
         self.identityModelId = identityModelId
-        self.model = model
         self.property = property
-        self.value = value
+
+        if coder.decodeInteger(forKey: "version") >= 2 {
+            guard let modelId = coder.decodeObject(forKey: "modelId") as? String,
+                  let kindValue = coder.decodeObject(forKey: "valueKind") as? String,
+                  let kind = OSDeltaEncodedValue.Kind(rawValue: kindValue),
+                  let valueData = coder.decodeObject(forKey: "valueData") as? Data
+            else {
+                OneSignalLog.onesignalLog(.LL_ERROR, message: "Unable to init OSDelta from cache")
+                return nil
+            }
+            // Resolve the reference to the live model, unless the model was embedded
+            guard let model = (coder.decodeObject(forKey: "model") as? OSModel) ?? OSModelStoreRegistry.shared.getModel(modelId: modelId) else {
+                OneSignalLog.onesignalLog(.LL_ERROR, message: "Dropping cached OSDelta \(name) for property \(property), its model \(modelId) is no longer in any model store")
+                return nil
+            }
+            let encodedValue = OSDeltaEncodedValue(kind: kind, data: valueData)
+            guard let value = encodedValue.decode() else {
+                OneSignalLog.onesignalLog(.LL_ERROR, message: "Dropping cached OSDelta \(name) for property \(property), its value cannot be decoded")
+                return nil
+            }
+            self.modelId = modelId
+            self._model = model
+            self._value = value
+            self.encodedValue = encodedValue
+        } else {
+            // Migrate from the legacy format, these are re-encoded in the current format on the next write
+            guard let model = coder.decodeObject(forKey: "model") as? OSModel,
+                  let value = coder.decodeObject(forKey: "value")
+            else {
+                OneSignalLog.onesignalLog(.LL_ERROR, message: "Unable to init OSDelta from cache")
+                return nil
+            }
+            self.modelId = model.modelId
+            self._model = model
+            self._value = value
+            self.encodedValue = nil
+        }
+    }
+}
+
+/**
+ A delta's value in encoded form. Property list values are stored as a binary plist, which is smaller and
+ faster to decode than a keyed archive. Other values, such as custom `NSCoding` objects, use a keyed archive.
+ */
+struct OSDeltaEncodedValue {
+    enum Kind: String {
+        case plist
+        case archive
+    }
+
+    let kind: Kind
+    let data: Data
+
+    init(kind: Kind, data: Data) {
+        self.kind = kind
+        self.data = data
+    }
+
+    init(_ value: Any) {
+        if PropertyListSerialization.propertyList(value, isValidFor: .binary),
+           let data = try? PropertyListSerialization.data(fromPropertyList: value, format: .binary, options: 0) {
+            self.kind = .plist
+            self.data = data
+        } else {
+            self.kind = .archive
+            self.data = NSKeyedArchiver.archivedData(withRootObject: value)
+        }
+    }
+
+    func decode() -> Any? {
+        switch kind {
+        case .plist:
+            return try? PropertyListSerialization.propertyList(from: data, options: [], format: nil)
+        case .archive:
+            return try? NSKeyedUnarchiver.unarchiveTopLevelObjectWithData(data)
+        }
     }
 }
@@ -0,0 +1,229 @@
+/*
+ Modified MIT License
+
+ Copyright 2024 OneSignal
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ 1. The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ 2. All copies of substantial portions of the Software may only be used in connection
+ with services provided by OneSignal.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ */
+
+import Foundation
+import OneSignalCore
+
+/**
+ An append-only, length-prefixed log of `OSDelta`s persisted to a file, preferably in the app group container.
+ The file starts with a 1-byte format version, followed by records of a 4-byte big-endian length and an archived delta.
+ Appending a delta is O(1) on disk instead of re-archiving the entire queue.
+ Deltas are not removed record by record; the log is compacted to the remaining deltas after executors pick them up.
+ A delta coalesced into a queued one is appended as a replacement record, an archived pair of the replaced delta's id
+ and the new delta, which takes the replaced delta's place when the log is read.
+ A truncated trailing record, such as from a crash mid-write, is ignored when the log is read.
+ Loading the log rewrites it without that record, so deltas appended afterwards are not written after the partial bytes.
+ */
+class OSDeltaLog {
+    static let formatVersion: UInt8 = 1
+    private static let lengthPrefixSize = 4
+
+    let fileURL: URL
+    private var fileHandle: FileHandle?
+
+    /**
+     Returns nil if no writable directory is available, in which case callers should fall back to UserDefaults.
+     */
+    init?(fileName: String) {
+        let fileManager = FileManager.default
+        guard let baseURL = fileManager.containerURL(forSecurityApplicationGroupIdentifier: OneSignalUserDefaults.appGroupName())
+                ?? fileManager.urls(for: .applicationSupportDirectory, in: .userDomainMask).first
+        else {
+            return nil
+        }
+        let directoryURL = baseURL.appendingPathComponent("OneSignal", isDirectory: true)
+        do {
+            try fileManager.createDirectory(at: directoryURL, withIntermediateDirectories: true, attributes: nil)
+        } catch {
+            OneSignalLog.onesignalLog(.LL_ERROR, message: "OSDeltaLog unable to create directory \(directoryURL) with error: \(error)")
+            return nil
+        }
+        self.fileURL = directoryURL.appendingPathComponent(fileName)
+    }
+
+    deinit {
+        fileHandle?.closeFile()
+    }
+
+    var exists: Bool {
+        return FileManager.default.fileExists(atPath: fileURL.path)
+    }
+
+    /**
+     Replays the log and returns the deltas in the order they were appended.
+     */
+    func readAll() -> [OSDelta] {
+        return read().deltas
+    }
+
+    /**
+     Replays the log to start appending to it. If the log ends in a truncated record, or can not be read at all,
+     it is first compacted to the deltas that could be read.
+     */
+    func load() -> [OSDelta] {
+        let (deltas, isIntact) = read()
+        if !isIntact {
+            compact(deltas)
+        }
+        return deltas
+    }
+
+    /**
+     `isIntact` is false if the log holds bytes that are not whole records, which must not be appended after.
+     */
+    private func read() -> (deltas: [OSDelta], isIntact: Bool) {
+        guard let data = try? Data(contentsOf: fileURL), !data.isEmpty else {
+            return ([], true)
+        }
+        guard data[data.startIndex] == OSDeltaLog.formatVersion else {
+            OneSignalLog.onesignalLog(.LL_ERROR, message: "OSDeltaLog unsupported format version \(data[data.startIndex]), discarding log")
+            return ([], false)
+        }
+
+        var deltas: [OSDelta] = []
+        var offset = data.startIndex + 1
+        while offset + OSDeltaLog.lengthPrefixSize <= data.endIndex {
+            let length = data[offset..<(offset + OSDeltaLog.lengthPrefixSize)].reduce(0) { ($0 << 8) | Int($1) }
+            let payloadStart = offset + OSDeltaLog.lengthPrefixSize
+            guard length > 0, payloadStart + length <= data.endIndex else {
+                OneSignalLog.onesignalLog(.LL_WARN, message: "OSDeltaLog ignoring truncated record at offset \(offset)")
+                return (deltas, false)
+            }
+            let object = try? NSKeyedUnarchiver.unarchiveTopLevelObjectWithData(data[payloadStart..<(payloadStart + length)])
+            if let delta = object as? OSDelta {
+                deltas.append(delta)
+            } else if let replacement = object as? [Any], replacement.count == 2,
+                      let replacedDeltaId = replacement[0] as? String, let delta = replacement[1] as? OSDelta {
+                if let index = deltas.firstIndex(where: { $0.deltaId == replacedDeltaId }) {
+                    deltas[index] = delta
+                } else {
+                    deltas.append(delta)
+                }
+            } else {
+                OneSignalLog.onesignalLog(.LL_ERROR, message: "OSDeltaLog unable to decode record at offset \(offset)")
+            }
+            offset = payloadStart + length
+        }
+        // Fewer bytes than a length prefix are left over from a record cut off as it was written
+        if offset != data.endIndex {
+            OneSignalLog.onesignalLog(.LL_WARN, message: "OSDeltaLog ignoring truncated record at offset \(offset)")
+            return (deltas, false)
+        }
+        return (deltas, true)
+    }
+
+    func append(_ delta: OSDelta) {
+        guard let record = OSDeltaLog.record(for: delta) else {
+            return
+        }
+        if !exists {
+            compact([delta])
+            return
+        }
+        write(record, describing: delta)
+    }
+
+    /**
+     Appends `delta` to take the place of the delta with `replacedDeltaId`, instead of rewriting the whole log.
+     The log must already exist, since the replaced delta is in it.
+     */
+    func replace(_ replacedDeltaId: String, with delta: OSDelta) {
+        guard let record = OSDeltaLog.record(for: [replacedDeltaId, delta] as NSArray, describing: delta) else {
+            return
+        }
+        write(record, describing: delta)
+    }
+
+    private func write(_ record: Data, describing delta: OSDelta) {
+        do {
+            let handle = try openFileHandle()
+            if #available(iOS 13.4, *) {
+                try handle.seekToEnd()
+                try handle.write(contentsOf: record)
+            } else {
+                // These raise an Objective-C exception on I/O failure instead of throwing
+                handle.seekToEndOfFile()
+                handle.write(record)
+            }
+        } catch {
+            OneSignalLog.onesignalLog(.LL_ERROR, message: "OSDeltaLog unable to append \(delta) with error: \(error)")
+        }
+    }
+
+    /**
+     Atomically rewrites the log to contain only these deltas.
+     */
+    func compact(_ deltas: [OSDelta]) {
+        var data = Data([OSDeltaLog.formatVersion])
+        for delta in deltas {
+            if let record = OSDeltaLog.record(for: delta) {
+                data.append(record)
+            }
+        }
+        closeFileHandle()
+        do {
+            try data.write(to: fileURL, options: .atomic)
+        } catch {
+            OneSignalLog.onesignalLog(.LL_ERROR, message: "OSDeltaLog unable to compact with error: \(error)")
+        }
+    }
+
+    func remove() {
+        closeFileHandle()
+        try? FileManager.default.removeItem(at: fileURL)
+    }
+
+    private func openFileHandle() throws -> FileHandle {
+        if let fileHandle = fileHandle {
+            return fileHandle
+        }
+        let handle = try FileHandle(forWritingTo: fileURL)
+        fileHandle = handle
+        return handle
+    }
+
+    private func closeFileHandle() {
+        fileHandle?.closeFile()
+        fileHandle = nil
+    }
+
+    private static func record(for delta: OSDelta) -> Data? {
+        return record(for: delta, describing: delta)
+    }
+
+    private static func record(for object: Any, describing delta: OSDelta) -> Data? {
+        let payload = NSKeyedArchiver.archivedData(withRootObject: object)
+        guard payload.count <= Int(UInt32.max) else {
+            OneSignalLog.onesignalLog(.LL_ERROR, message: "OSDeltaLog dropping oversized \(delta)")
+            return nil
+        }
+        var length = UInt32(payload.count).bigEndian
+        var record = Data(bytes: &length, count: lengthPrefixSize)
+        record.append(payload)
+        return record
+    }
+}
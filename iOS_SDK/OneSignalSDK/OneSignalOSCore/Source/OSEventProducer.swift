@@ -28,24 +28,32 @@
 import Foundation
 import OneSignalCore
 
+/**
+ Delivers events to any number of subscribers, each called synchronously inside `fire`.
+ */
 public class OSEventProducer<THandler>: NSObject {
-    // Not an array as there is at most 1 subsriber per OSEventProducer anyway
-    var subscriber: THandler?
+    private var subscribers: [THandler] = []
+    private let lock = NSRecursiveLock()
 
+    /// Subscribes the handler, replacing any existing subscription of the same handler.
     public func subscribe(_ handler: THandler) {
-        // TODO: UM do we want to synchronize on subscribers
-        subscriber = handler // TODO: UM style, implicit or explicit self?
+        lock.withLock {
+            subscribers.removeAll { $0 as AnyObject === handler as AnyObject }
+            subscribers.append(handler)
+        }
     }
 
     public func unsubscribe(_ handler: THandler) {
         OneSignalLog.onesignalLog(.LL_VERBOSE, message: "OSEventProducer.unsubscribe() called with handler: \(handler)")
-        // TODO: UM do we want to synchronize on subscribers
-        subscriber = nil
+        lock.withLock {
+            subscribers.removeAll { $0 as AnyObject === handler as AnyObject }
+        }
     }
 
     public func fire(callback: (THandler) -> Void) {
         // dump(subscribers) -> uncomment for more verbose log during testing
-        if let subscriber = subscriber {
+        let subscribers = lock.withLock { self.subscribers }
+        for subscriber in subscribers {
             callback(subscriber)
         }
     }
@@ -31,13 +31,45 @@ import Foundation
 open class OSModel: NSObject, NSCoding {
     public let modelId: String
     public var changeNotifier: OSEventProducer<OSModelChangedHandler>
-    private var hydrating = false // TODO: Starts out false?
+
+    /**
+     Hydration is tracked per thread rather than with a shared flag. An executor hydrates a model on its own queue
+     while app threads may be setting properties on the same model, and these app changes must still be reported
+     as changes, not as hydration. Hydrations of the same model are serialized by the `hydrationLock`.
+     Subclasses guard their own storage with their own locks, so readers never wait on a hydration in progress.
+     */
+    private let hydrationLock = NSRecursiveLock()
+    private let hydratingThreadLock = NSLock()
+    private var hydratingThread: Thread?
+
+    private var isHydratingOnCurrentThread: Bool {
+        hydratingThreadLock.withLock {
+            hydratingThread == Thread.current
+        }
+    }
+
+    /**
+     Like hydration, a batch update is tracked per thread so that only the changes made inside it are grouped.
+     Batches of the same model are serialized by the `batchLock`.
+     */
+    private let batchLock = NSRecursiveLock()
+    private let batchingThreadLock = NSLock()
+    private var batchingThread: Thread?
+    private var batchedChanges: [String: Any] = [:]
 
     public init(changeNotifier: OSEventProducer<OSModelChangedHandler>) {
         self.modelId = UUID().uuidString
         self.changeNotifier = changeNotifier
     }
 
+    /**
+     A detached model that only carries an ID, used when a persisted reference can no longer be resolved.
+     */
+    init(modelId: String) {
+        self.modelId = modelId
+        self.changeNotifier = OSEventProducer()
+    }
+
     open func encode(with coder: NSCoder) {
         coder.encode(modelId, forKey: "modelId")
     }
@@ -53,10 +85,54 @@ open class OSModel: NSObject, NSCoding {
 
     // We can add operation name to this... , such as enum of "updated", "deleted", "added"
     public func set<T>(property: String, newValue: T) {
+        let isBatched = batchingThreadLock.withLock { () -> Bool in
+            guard batchingThread == Thread.current else {
+                return false
+            }
+            batchedChanges[property] = newValue
+            return true
+        }
+        guard !isBatched else {
+            return
+        }
+
         let changeArgs = OSModelChangedArgs(model: self, property: property, newValue: newValue)
+        let hydrating = isHydratingOnCurrentThread
 
         changeNotifier.fire { modelChangeHandler in
-            modelChangeHandler.onModelUpdated(args: changeArgs, hydrating: self.hydrating)
+            modelChangeHandler.onModelUpdated(args: changeArgs, hydrating: hydrating)
+        }
+    }
+
+    /**
+     Applies the property changes made in `changes` as one update. Handlers are notified once, with a change whose
+     `changedProperties` holds every property set, so the model is persisted once and only one delta is enqueued.
+     */
+    public func batchUpdate(_ changes: () -> Void) {
+        batchLock.withLock {
+            let isNested = batchingThreadLock.withLock { () -> Bool in
+                guard batchingThread != Thread.current else {
+                    return true
+                }
+                batchingThread = Thread.current
+                return false
+            }
+            changes()
+            guard !isNested else {
+                return
+            }
+            let batchedChanges = batchingThreadLock.withLock { () -> [String: Any] in
+                let batchedChanges = self.batchedChanges
+                self.batchedChanges = [:]
+                batchingThread = nil
+                return batchedChanges
+            }
+
+            if batchedChanges.count == 1, let (property, newValue) = batchedChanges.first {
+                set(property: property, newValue: newValue)
+            } else if !batchedChanges.isEmpty {
+                set(property: OS_MODEL_BATCH_UPDATE_PROPERTY, newValue: batchedChanges)
+            }
         }
     }
 
@@ -64,10 +140,17 @@ open class OSModel: NSObject, NSCoding {
      This function receives a server response and updates the model's properties.
      */
     public func hydrate(_ response: [String: Any]) {
-        // TODO: Thread safety when processing server responses to hydrate models.
-        self.hydrating = true
-        hydrateModel(response) // Calls model-specific hydration logic
-        self.hydrating = false
+        hydrationLock.withLock {
+            let previousThread = hydratingThreadLock.withLock { () -> Thread? in
+                let previousThread = hydratingThread
+                hydratingThread = Thread.current
+                return previousThread
+            }
+            hydrateModel(response) // Calls model-specific hydration logic
+            hydratingThreadLock.withLock {
+                hydratingThread = previousThread
+            }
+        }
     }
 
     open func hydrateModel(_ response: [String: Any]) {
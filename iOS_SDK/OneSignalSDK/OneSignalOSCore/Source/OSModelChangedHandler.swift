@@ -26,6 +26,7 @@
  */
 
 import Foundation
+import OneSignalCore
 
 public class OSModelChangedArgs: NSObject {
     /**
@@ -43,6 +44,16 @@ public class OSModelChangedArgs: NSObject {
      */
     public let newValue: Any
 
+    /**
+     The new values keyed by property. A change grouped by `OSModel.batchUpdate` carries several of them.
+     */
+    public var changedProperties: [String: Any] {
+        if property == OS_MODEL_BATCH_UPDATE_PROPERTY, let changes = newValue as? [String: Any] {
+            return changes
+        }
+        return [property: newValue]
+    }
+
     override public var description: String {
         return "OSModelChangedArgs for model: \(model) with property: \(property) value: \(newValue)"
     }
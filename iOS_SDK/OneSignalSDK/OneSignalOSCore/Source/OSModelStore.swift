@@ -27,28 +27,157 @@
 
 import OneSignalCore
 
+/**
+ Tracks the models currently held by any model store, by `modelId`.
+ This lets persisted deltas reference their model by ID instead of embedding a copy of it.
+ */
+final class OSModelStoreRegistry {
+    static let shared = OSModelStoreRegistry()
+
+    private let models = NSMapTable<NSString, OSModel>.strongToWeakObjects()
+    private let lock = NSLock()
+
+    func register(_ model: OSModel) {
+        lock.withLock {
+            models.setObject(model, forKey: model.modelId as NSString)
+        }
+    }
+
+    func unregister(_ model: OSModel) {
+        lock.withLock {
+            if models.object(forKey: model.modelId as NSString) === model {
+                models.removeObject(forKey: model.modelId as NSString)
+            }
+        }
+    }
+
+    func getModel(modelId: String) -> OSModel? {
+        lock.withLock {
+            models.object(forKey: modelId as NSString)
+        }
+    }
+
+    func contains(_ model: OSModel) -> Bool {
+        return getModel(modelId: model.modelId) === model
+    }
+}
+
+/**
+ Model stores write their dirty models on this serial queue, so model setters return without archiving models inline.
+ */
+public enum OSModelStorePersistence {
+    static let queue = DispatchQueue(label: "OneSignal.OSModelStore.persistence", target: OSDispatchQueues.utility)
+
+    /**
+     Blocks until all scheduled saves have been written, such as before the app may be suspended.
+     */
+    public static func waitForPendingSaves() {
+        queue.sync {}
+    }
+}
+
+/**
+ Lets a caller group many model changes so the store persists its models once, when the outermost batch ends.
+ */
+public protocol OSModelStoreBatching {
+    func beginBatch()
+    func endBatch()
+}
+
 open class OSModelStore<TModel: OSModel>: NSObject {
     let storeKey: String
     let changeSubscription: OSEventProducer<OSModelStoreChangedHandler>
     var models: [String: TModel]
+    // Secondary index from `modelId` to the model's ID in `models`, kept in sync wherever `models` changes
+    private var modelIdsToKeys: [String: String] = [:]
+
+    /**
+     Each model is persisted as its own record, keyed by its ID in this store, alongside an index of the persisted IDs.
+     Changes mark a model dirty so only the changed records are rewritten, instead of re-archiving every model.
+     Dirty models are written on the `OSModelStorePersistence` queue, and not at all while `batchDepth` is above zero.
+     Access to `models`, the index, and this state is synchronized by the `lock`.
+     */
+    private var dirtyModelIds = Set<String>()
+    private var indexIsDirty = false
+    private var persistedModelIds = Set<String>()
+    private var batchDepth = 0
+    private var saveScheduled = false
+    private let lock = NSRecursiveLock()
+
+    private var modelIdsKey: String {
+        return OSModelStore.modelIdsKey(storeKey)
+    }
+
+    private func recordKey(_ id: String) -> String {
+        return OSModelStore.recordKey(storeKey, id)
+    }
+
+    private static func modelIdsKey(_ storeKey: String) -> String {
+        return "\(storeKey)_MODEL_IDS"
+    }
+
+    private static func recordKey(_ storeKey: String, _ id: String) -> String {
+        return "\(storeKey)_MODEL_\(id)"
+    }
+
+    /**
+     The keys of the model records currently persisted for the store, for prefetching them before the store is created.
+     */
+    public static func cachedRecordKeys(storeKey: String) -> [String] {
+        guard let modelIds = OneSignalUserDefaults.initShared().getSavedObject(forKey: modelIdsKey(storeKey), defaultValue: nil) as? [String] else {
+            return []
+        }
+        return modelIds.map { recordKey(storeKey, $0) }
+    }
 
     public init(changeSubscription: OSEventProducer<OSModelStoreChangedHandler>, storeKey: String) {
         self.storeKey = storeKey
         self.changeSubscription = changeSubscription
+        self.models = [:]
+        super.init()
 
         // read models from cache, if any
-        if let models = OneSignalUserDefaults.initShared().getSavedCodeableData(forKey: self.storeKey, defaultValue: [:]) as? [String: TModel] {
-            self.models = models
-        } else {
-            // log error
-            self.models = [:]
+        OSTrace.measure(.cacheLoad, name: "OSModelStore \(storeKey)") {
+            self.models = uncacheModels()
         }
-        super.init()
 
         // listen for changes to the models
-        for model in self.models.values {
+        for (id, model) in self.models {
+            modelIdsToKeys[model.modelId] = id
             model.changeNotifier.subscribe(self)
+            OSModelStoreRegistry.shared.register(model)
+        }
+    }
+
+    /**
+     Reads the per-model records. Models cached as a single dictionary by an earlier SDK version are migrated to records.
+     */
+    private func uncacheModels() -> [String: TModel] {
+        let sharedUserDefaults = OneSignalUserDefaults.initShared()
+        if let modelIds = sharedUserDefaults.getSavedObject(forKey: modelIdsKey, defaultValue: nil) as? [String] {
+            var models: [String: TModel] = [:]
+            for id in modelIds {
+                if let model = sharedUserDefaults.getSavedCodeableData(forKey: recordKey(id), defaultValue: nil) as? TModel {
+                    models[id] = model
+                } else {
+                    OneSignalLog.onesignalLog(.LL_ERROR, message: "OSModelStore \(storeKey) is unable to uncache the model \(id)")
+                }
+            }
+            lock.withLock {
+                persistedModelIds = Set(modelIds)
+            }
+            return models
+        }
+        guard let legacyModels = sharedUserDefaults.getSavedCodeableData(forKey: storeKey, defaultValue: nil) as? [String: TModel] else {
+            return [:]
+        }
+        lock.withLock {
+            dirtyModelIds.formUnion(legacyModels.keys)
+            indexIsDirty = true
+            saveDirtyModels(legacyModels)
         }
+        sharedUserDefaults.removeValue(forKey: storeKey)
+        return legacyModels
     }
 
     public func registerAsUserObserver() -> OSModelStore {
@@ -67,36 +196,47 @@ open class OSModelStore<TModel: OSModel>: NSObject {
      Examples:  "person@example.com" for a subscription model or `OS_IDENTITY_MODEL_KEY` for an identity model.
      */
     public func getModel(key: String) -> TModel? {
-        return self.models[key]
+        lock.withLock {
+            self.models[key]
+        }
     }
 
     /**
      Uses the `modelId` to get the corresponding model in the store's models dictionary.
      */
     public func getModel(modelId: String) -> TModel? {
-        for model in models.values {
-            if model.modelId == modelId {
-                return model
+        lock.withLock {
+            guard let key = modelIdsToKeys[modelId] else {
+                return nil
             }
+            return models[key]
         }
-        return nil
     }
 
     public func getModels() -> [String: TModel] {
-        return self.models
+        lock.withLock {
+            self.models
+        }
     }
 
     public func add(id: String, model: TModel, hydrating: Bool) {
         // TODO: Check if we are adding the same model? Do we replace?
             // For example, calling addEmail multiple times with the same email
             // Check API endpoint for behavior
-        models[id] = model
+        lock.withLock {
+            if let replacedModel = models[id], replacedModel.modelId != model.modelId {
+                modelIdsToKeys.removeValue(forKey: replacedModel.modelId)
+            }
+            models[id] = model
+            modelIdsToKeys[model.modelId] = id
 
-        // persist the models (including new model) to storage
-        OneSignalUserDefaults.initShared().saveCodeableData(forKey: self.storeKey, withValue: self.models)
+            // persist the new model to storage
+            markDirty(id, indexChanged: true)
+        }
 
         // listen for changes to this model
         model.changeNotifier.subscribe(self)
+        OSModelStoreRegistry.shared.register(model)
 
         guard !hydrating else {
             return
@@ -114,14 +254,20 @@ open class OSModelStore<TModel: OSModel>: NSObject {
     public func remove(_ id: String) {
         OneSignalLog.onesignalLog(.LL_VERBOSE, message: "OSModelStore remove() called with model \(id)")
         // TODO: Nothing will happen if model doesn't exist in the store
-        if let model = models[id] {
-            models.removeValue(forKey: id)
-
-            // persist the models (with removed model) to storage
-            OneSignalUserDefaults.initShared().saveCodeableData(forKey: self.storeKey, withValue: self.models)
+        let removedModel = lock.withLock { () -> TModel? in
+            guard let model = models.removeValue(forKey: id) else {
+                return nil
+            }
+            modelIdsToKeys.removeValue(forKey: model.modelId)
 
+            // remove the model from storage
+            markDirty(id, indexChanged: true)
+            return model
+        }
+        if let model = removedModel {
             // no longer listen for changes to this model
             model.changeNotifier.unsubscribe(self)
+            OSModelStoreRegistry.shared.unregister(model)
 
             self.changeSubscription.fire { modelStoreListener in
                 modelStoreListener.onRemoved(model)
@@ -137,7 +283,17 @@ open class OSModelStore<TModel: OSModel>: NSObject {
      */
     @objc func removeModelsFromUserDefaults() {
         // Clear the UserDefaults models cache when OS_ON_USER_WILL_CHANGEclearModelsFromStore() called
-        OneSignalUserDefaults.initShared().removeValue(forKey: self.storeKey)
+        lock.withLock {
+            let sharedUserDefaults = OneSignalUserDefaults.initShared()
+            for id in persistedModelIds {
+                sharedUserDefaults.removeValue(forKey: recordKey(id))
+            }
+            sharedUserDefaults.removeValue(forKey: modelIdsKey)
+            sharedUserDefaults.removeValue(forKey: storeKey)
+            persistedModelIds.removeAll()
+            dirtyModelIds.removeAll()
+            indexIsDirty = false
+        }
     }
 
     /**
@@ -146,14 +302,106 @@ open class OSModelStore<TModel: OSModel>: NSObject {
      In contrast, it is not necessary for the Identity or Properties Model Stores to do so.
      */
     public func clearModelsFromStore() {
-        self.models = [:]
+        let clearedModels = lock.withLock { () -> [String: TModel] in
+            let clearedModels = self.models
+            self.models = [:]
+            self.modelIdsToKeys = [:]
+            return clearedModels
+        }
+        for model in clearedModels.values {
+            OSModelStoreRegistry.shared.unregister(model)
+        }
+    }
+
+    /**
+     Marks the model stored under `id` as changed and schedules a save, unless a batch is in progress,
+     in which case all dirty models are saved when it ends.
+     */
+    func markDirty(_ id: String, indexChanged: Bool = false) {
+        lock.withLock {
+            dirtyModelIds.insert(id)
+            indexIsDirty = indexIsDirty || indexChanged
+            if batchDepth == 0 {
+                scheduleSave()
+            }
+        }
+    }
+
+    /**
+     Coalesces saves: changes made before a scheduled save runs are written by it. Must be called under the `lock`.
+     */
+    private func scheduleSave() {
+        guard !saveScheduled else {
+            return
+        }
+        saveScheduled = true
+        OSModelStorePersistence.queue.async { [weak self] in
+            guard let self = self else {
+                return
+            }
+            self.lock.withLock {
+                self.saveScheduled = false
+                self.saveDirtyModels(self.models)
+            }
+        }
+    }
+
+    /**
+     Rewrites only the dirty records; a dirty ID with no model was removed. Must be called under the `lock`.
+     */
+    private func saveDirtyModels(_ models: [String: TModel]) {
+        OSPerformanceCounters.increment(.modelStoreSaves)
+        let sharedUserDefaults = OneSignalUserDefaults.initShared()
+        for id in dirtyModelIds {
+            if let model = models[id] {
+                sharedUserDefaults.saveCodeableData(forKey: recordKey(id), withValue: model)
+            } else {
+                sharedUserDefaults.removeValue(forKey: recordKey(id))
+            }
+        }
+        dirtyModelIds.removeAll()
+
+        if indexIsDirty {
+            // Drop records of models that left the store without a removal, such as after `clearModelsFromStore`
+            let modelIds = Set(models.keys)
+            for id in persistedModelIds.subtracting(modelIds) {
+                sharedUserDefaults.removeValue(forKey: recordKey(id))
+            }
+            sharedUserDefaults.saveObject(forKey: modelIdsKey, withValue: Array(modelIds))
+            persistedModelIds = modelIds
+            indexIsDirty = false
+        }
+    }
+}
+
+extension OSModelStore: OSModelStoreBatching {
+    public func beginBatch() {
+        lock.withLock {
+            batchDepth += 1
+        }
+    }
+
+    public func endBatch() {
+        lock.withLock {
+            guard batchDepth > 0 else {
+                return
+            }
+            batchDepth -= 1
+            if batchDepth == 0 && (!dirtyModelIds.isEmpty || indexIsDirty) {
+                scheduleSave()
+            }
+        }
     }
 }
 
 extension OSModelStore: OSModelChangedHandler {
     public func onModelUpdated(args: OSModelChangedArgs, hydrating: Bool) {
-        // persist the changed models to storage
-        OneSignalUserDefaults.initShared().saveCodeableData(forKey: self.storeKey, withValue: self.models)
+        // persist the changed model to storage
+        lock.withLock {
+            if let id = modelIdsToKeys[args.model.modelId] {
+                markDirty(id)
+            }
+        }
 
         guard !hydrating else {
             return
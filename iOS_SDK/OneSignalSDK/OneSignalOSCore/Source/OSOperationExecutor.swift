@@ -35,8 +35,48 @@ public protocol OSOperationExecutor {
     var deltaQueue: [OSDelta] { get }
 
     func enqueueDelta(_ delta: OSDelta)
+    /**
+     Appends the deltas and persists the delta queue, equivalent to `enqueueDelta` for each followed by `cacheDeltaQueue`.
+     The Operation Repo hands off each flush this way, so that it costs one hop onto the executor's queue instead of one per delta.
+     */
+    func enqueueDeltas(_ deltas: [OSDelta])
     func cacheDeltaQueue()
     func processDeltaQueue(inBackground: Bool)
 
     func processRequestQueue(inBackground: Bool)
+
+    /**
+     Returns true if this executor has deltas or requests that have not completed yet.
+     The Operation Repo keeps its flush timer armed while any executor has pending work.
+     */
+    func hasPendingWork() -> Bool
+
+    /**
+     Returns a single delta equivalent to applying `existing` and then `newer`, or nil if they cannot be combined.
+     Called by the Operation Repo at enqueue time so its queue is bounded by distinct keys instead of call count.
+     */
+    func coalesce(_ existing: OSDelta, with newer: OSDelta) -> OSDelta?
+
+    /// Snapshots of this executor's queues, reported by `OSOperationRepo.queueDiagnostics()`.
+    func queueDiagnostics() -> [OSQueueDiagnostics]
+}
+
+extension OSOperationExecutor {
+    public func enqueueDeltas(_ deltas: [OSDelta]) {
+        deltas.forEach { enqueueDelta($0) }
+        cacheDeltaQueue()
+    }
+
+    /// Saves the delta queue to the shared user defaults under the executor's key. Call it on the executor's queue.
+    public func persistDeltaQueue(forKey key: String) {
+        OneSignalUserDefaults.initShared().saveCodeableData(forKey: key, withValue: deltaQueue)
+    }
+
+    public func coalesce(_ existing: OSDelta, with newer: OSDelta) -> OSDelta? {
+        return nil
+    }
+
+    public func queueDiagnostics() -> [OSQueueDiagnostics] {
+        return []
+    }
 }
@@ -37,16 +37,79 @@ public class OSOperationRepo: NSObject {
     private var hasCalledStart = false
 
     // The Operation Repo dispatch queue, serial. This synchronizes access to `deltaQueue` and flushing behavior.
-    private let dispatchQueue = DispatchQueue(label: "OneSignal.OSOperationRepo", target: .global())
+    let dispatchQueue = DispatchQueue(label: "OneSignal.OSOperationRepo", target: OSDispatchQueues.utility) // non-private for unit test access
+    // Schedules the delayed flushes, which must run on the `dispatchQueue`. Tests replace it to control time.
+    lazy var scheduler: OSDispatchQueue = dispatchQueue // non-private for unit test access
 
     // Maps delta names to the interfaces for the operation executors
     var deltasToExecutorMap: [String: OSOperationExecutor] = [:]
     var executors: [OSOperationExecutor] = []
-    var deltaQueue: [OSDelta] = [] // non-private for unit test access
+    var deltaQueue: [OSDelta] = [] { // non-private for unit test access
+        didSet {
+            // Kept current on every change, including flushing and dropping deltas
+            OSPerformanceCounters.setGauge(.deltaQueueDepth, value: Int64(deltaQueue.count))
+        }
+    }
+
+    // The on-disk, append-only log backing `deltaQueue`. Nil if no writable directory exists, then UserDefaults is used.
+    lazy var deltaLog: OSDeltaLog? = OSDeltaLog(fileName: OS_OPERATION_REPO_DELTA_LOG_FILE_NAME)
 
-    // TODO: This could come from a config, plist, method, remote params
-    var pollIntervalMilliseconds = Int(POLL_INTERVAL_MS)
-    public var paused = false
+    // Both knobs come from OSTuningConfig unless assigned, which unit tests do to shorten the window
+    private var pollIntervalOverride: Int?
+    private var flushThresholdOverride: Int?
+    // The debounce window between the first delta arriving after idle and the flush, longer while OSPowerPolicy is constrained
+    var pollIntervalMilliseconds: Int {
+        get { pollIntervalOverride ?? Int(OSPowerPolicy.shared().scaledDelay(Double(OSTuningConfig.sharedConfig().operationRepoFlushDelayMilliseconds))) }
+        set { pollIntervalOverride = newValue }
+    }
+    // Flush immediately, without waiting for the debounce window, once this many deltas are queued
+    var flushThreshold: Int {
+        get { flushThresholdOverride ?? OSTuningConfig.sharedConfig().operationRepoFlushThreshold }
+        set { flushThresholdOverride = newValue }
+    }
+    public var paused = false {
+        didSet {
+            if oldValue && !paused {
+                self.dispatchQueue.async {
+                    self.scheduleFlush()
+                }
+            }
+        }
+    }
+
+    /**
+     Deltas and executor requests of these identities stay queued while the rest keep flowing, such as while one user's JWT is refreshed.
+     Each identity maps to the pause holding it, so the timeout of an earlier pause does not end a later one.
+     Unlike `paused`, this is not persisted. Executors check it from their own queues, so access is synchronized by `pausedIdentityModelIdsLock`.
+     */
+    private var pausedIdentityModelIds: [String: UUID] = [:]
+    private let pausedIdentityModelIdsLock = NSLock()
+
+    /**
+     Flushing is event-driven rather than polling forever. A flush is scheduled only while there is work,
+     and the repo becomes idle again once no deltas or executor requests are pending.
+     Access to `flushScheduled` is synchronized by the `dispatchQueue`.
+     */
+    private var flushScheduled = false
+    /**
+     Set while executor requests are pending but the network is unreachable. Rather than flushing on a timer
+     while offline, the repo stays idle and flushes once reachability reports the network is available again.
+     Access is synchronized by the `dispatchQueue`.
+     */
+    private var awaitingNetwork = false
+    // Replaced by unit tests to simulate connectivity
+    var isNetworkReachable: () -> Bool = { OSNetworkingUtils.isReachable() } // non-private for unit test access
+    /**
+     While `batchDepth` is above zero, enqueued deltas are coalesced in memory without being persisted or flushed.
+     The outermost `endBatch` persists the queue once. Access is synchronized by the `dispatchQueue`.
+     */
+    private var batchDepth = 0
+    private var batchRequestedFlush = false
+    // Past this many deltas the oldest are dropped, it is only reached while flushing is paused
+    var deltaQueueLimit = Int(OS_OPERATION_REPO_DELTA_QUEUE_LIMIT)
+    private var droppedDeltaCount = 0
+    /// Observable for metrics via the `OS_OPERATION_REPO_DID_BECOME_IDLE` and `OS_OPERATION_REPO_DID_BECOME_BUSY` notifications.
+    public private(set) var isIdle = true
 
     /**
      Initilize this Operation Repo. Read from the cache. Executors may not be available by this time.
@@ -68,22 +131,208 @@ public class OSOperationRepo: NSObject {
                                                selector: #selector(self.addFlushDeltaQueueToDispatchQueue),
                                                name: Notification.Name(OS_ON_USER_WILL_CHANGE),
                                                object: nil)
+        NotificationCenter.default.addObserver(self,
+                                               selector: #selector(self.reachabilityChanged),
+                                               name: Notification.Name(OS_REACHABILITY_CHANGED_NOTIFICATION),
+                                               object: nil)
         // Read the Deltas from cache, if any...
-        if let deltaQueue = OneSignalUserDefaults.initShared().getSavedCodeableData(forKey: OS_OPERATION_REPO_DELTA_QUEUE_KEY, defaultValue: []) as? [OSDelta] {
+        if let deltaQueue = uncacheDeltaQueue() {
             self.deltaQueue = deltaQueue
             OneSignalLog.onesignalLog(.LL_VERBOSE, message: "OSOperationRepo.start() with deltaQueue: \(deltaQueue)")
         } else {
             OneSignalLog.onesignalLog(.LL_ERROR, message: "OSOperationRepo.start() is unable to uncache the OSDelta queue.")
         }
 
-        pollFlushQueue()
+        self.dispatchQueue.async {
+            // Flush once to pick up work that was cached in a previous session
+            self.scheduleFlush()
+        }
+    }
+
+    /**
+     Reads the delta queue from the log. If the log does not exist yet, deltas cached in UserDefaults by an earlier
+     SDK version are migrated into a new log and removed from UserDefaults.
+     */
+    private func uncacheDeltaQueue() -> [OSDelta]? {
+        guard let deltaLog = deltaLog else {
+            return OneSignalUserDefaults.initShared().getSavedCodeableData(forKey: OS_OPERATION_REPO_DELTA_QUEUE_KEY, defaultValue: []) as? [OSDelta]
+        }
+        if deltaLog.exists {
+            // Rewrites a log left with a partial record by a crash before anything is appended to it
+            return deltaLog.load()
+        }
+        let sharedUserDefaults = OneSignalUserDefaults.initShared()
+        let legacyDeltaQueue = sharedUserDefaults.getSavedCodeableData(forKey: OS_OPERATION_REPO_DELTA_QUEUE_KEY, defaultValue: []) as? [OSDelta] ?? []
+        deltaLog.compact(legacyDeltaQueue)
+        sharedUserDefaults.removeValue(forKey: OS_OPERATION_REPO_DELTA_QUEUE_KEY)
+        return legacyDeltaQueue
+    }
+
+    /// Persists a single newly enqueued delta. Must be called on the `dispatchQueue`.
+    private func cacheEnqueuedDelta(_ delta: OSDelta) {
+        if let deltaLog = deltaLog {
+            deltaLog.append(delta)
+        } else {
+            OneSignalUserDefaults.initShared().saveCodeableData(forKey: OS_OPERATION_REPO_DELTA_QUEUE_KEY, withValue: self.deltaQueue)
+        }
+    }
+
+    /// Persists a delta that took the place of a queued one, without rewriting the log. Must be called on the `dispatchQueue`.
+    private func cacheCoalescedDelta(_ delta: OSDelta, replacing replacedDeltaId: String) {
+        if let deltaLog = deltaLog, deltaLog.exists {
+            deltaLog.replace(replacedDeltaId, with: delta)
+        } else {
+            cacheDeltaQueue()
+        }
+    }
+
+    /// Persists the entire `deltaQueue`, compacting the log. Must be called on the `dispatchQueue`.
+    private func cacheDeltaQueue() {
+        if let deltaLog = deltaLog {
+            deltaLog.compact(self.deltaQueue)
+        } else {
+            OneSignalUserDefaults.initShared().saveCodeableData(forKey: OS_OPERATION_REPO_DELTA_QUEUE_KEY, withValue: self.deltaQueue)
+        }
+    }
+
+    /**
+     Arms the coalescing flush timer if it is not already armed. Must be called on the `dispatchQueue`.
+     */
+    private func scheduleFlush() {
+        guard !flushScheduled else {
+            return
+        }
+        flushScheduled = true
+        setIdle(false)
+        self.scheduler.asyncAfterTime(deadline: .now() + .milliseconds(pollIntervalMilliseconds)) { [weak self] in
+            guard let self = self else {
+                return
+            }
+            self.flushScheduled = false
+            self.flushDeltaQueue()
+            self.rescheduleFlushIfNeeded()
+        }
+    }
+
+    /**
+     Keeps flushing while deltas or executor requests are pending, such as requests awaiting a retry
+     or the post-create delay. Otherwise transitions to idle. Must be called on the `dispatchQueue`.
+     */
+    private func rescheduleFlushIfNeeded() {
+        guard !flushScheduled else {
+            return
+        }
+        // While paused, stay idle; unpausing schedules a flush
+        guard !paused && hasPendingWork() else {
+            setIdle(true)
+            return
+        }
+        // New deltas still schedule a flush, only the re-arming for requests waiting on the network stops
+        if !isNetworkReachable() {
+            awaitingNetwork = true
+            setIdle(true)
+            return
+        }
+        scheduleFlush()
+    }
+
+    @objc func reachabilityChanged() {
+        self.dispatchQueue.async {
+            guard self.awaitingNetwork && self.isNetworkReachable() else {
+                return
+            }
+            self.awaitingNetwork = false
+            self.scheduleFlush()
+        }
+    }
+
+    private func hasPendingWork() -> Bool {
+        return deltaQueue.contains { !isPaused(identityModelId: $0.identityModelId) } || executors.contains { $0.hasPendingWork() }
+    }
+
+    /// Executors leave the requests of a paused identity queued, and do not count them as pending work.
+    public func isPaused(identityModelId: String) -> Bool {
+        pausedIdentityModelIdsLock.withLock { pausedIdentityModelIds[identityModelId] != nil }
+    }
+
+    /**
+     Holds back the deltas and requests of one identity without affecting the others, until `resume(identityModelId:)` is called.
+     If nothing resumes it within `timeoutSeconds`, the identity resumes on its own so its work is not held forever,
+     and `onTimeout` lets the caller execute work that the operation repo does not flush.
+     */
+    public func pause(identityModelId: String, timeoutSeconds: Int = Int(OS_JWT_REFRESH_TIMEOUT_SECONDS), onTimeout: (() -> Void)? = nil) {
+        let pauseId = UUID()
+        pausedIdentityModelIdsLock.withLock { pausedIdentityModelIds[identityModelId] = pauseId }
+        OneSignalLog.onesignalLog(.LL_DEBUG, message: "OSOperationRepo pausing deltas for identity model \(identityModelId)")
+        self.dispatchQueue.async {
+            self.scheduler.asyncAfterTime(deadline: .now() + .seconds(timeoutSeconds)) { [weak self] in
+                guard let self = self,
+                      self.pausedIdentityModelIdsLock.withLock({ self.pausedIdentityModelIds[identityModelId] == pauseId })
+                else {
+                    return
+                }
+                OneSignalLog.onesignalLog(.LL_WARN, message: "OSOperationRepo resuming identity model \(identityModelId) after waiting \(timeoutSeconds) seconds")
+                self.resume(identityModelId: identityModelId)
+                onTimeout?()
+            }
+        }
+    }
+
+    public func resume(identityModelId: String) {
+        guard pausedIdentityModelIdsLock.withLock({ pausedIdentityModelIds.removeValue(forKey: identityModelId) }) != nil else {
+            return
+        }
+        OneSignalLog.onesignalLog(.LL_DEBUG, message: "OSOperationRepo resuming deltas for identity model \(identityModelId)")
+        self.dispatchQueue.async {
+            self.rescheduleFlushIfNeeded()
+        }
     }
 
-    private func pollFlushQueue() {
-        self.dispatchQueue.asyncAfter(deadline: .now() + .milliseconds(pollIntervalMilliseconds)) { [weak self] in
-            self?.flushDeltaQueue()
-            self?.pollFlushQueue()
+    private func setIdle(_ idle: Bool) {
+        guard isIdle != idle else {
+            return
         }
+        isIdle = idle
+        OneSignalLog.onesignalLog(.LL_VERBOSE, message: "OSOperationRepo became \(idle ? "idle" : "busy")")
+        OSFlightRecorder.record(.operationRepoIdleChanged, arg0: idle ? 1 : 0, arg1: 0)
+        NotificationCenter.default.post(name: Notification.Name(idle ? OS_OPERATION_REPO_DID_BECOME_IDLE : OS_OPERATION_REPO_DID_BECOME_BUSY), object: self)
+    }
+
+    /**
+     Drops deltas over `deltaQueueLimit`, returns true if any were dropped. Must be called on the `dispatchQueue`.
+     Property updates go first, oldest first, because a lost subscription or alias change leaves the user wrong on the server.
+     */
+    private func trimDeltaQueue() -> Bool {
+        guard deltaQueue.count > deltaQueueLimit else {
+            return false
+        }
+        let overflow = deltaQueue.count - deltaQueueLimit
+        let dropOrder = deltaQueue.indices.sorted { first, second in
+            let firstIsPropertyUpdate = deltaQueue[first].name == OS_UPDATE_PROPERTIES_DELTA
+            let secondIsPropertyUpdate = deltaQueue[second].name == OS_UPDATE_PROPERTIES_DELTA
+            return firstIsPropertyUpdate != secondIsPropertyUpdate ? firstIsPropertyUpdate : first < second
+        }
+        let droppedIndices = Set(dropOrder.prefix(overflow))
+        OneSignalLog.onesignalLog(.LL_WARN, message: "OSOperationRepo dropping \(overflow) deltas over the limit of \(deltaQueueLimit)")
+        for index in droppedIndices.sorted() {
+            let delta = deltaQueue[index]
+            OneSignalLog.onesignalLog(.LL_WARN, message: "OSOperationRepo dropped \(delta.name) \(delta.deltaId) for model \(delta.modelId)")
+            delta.removeCompletionHandlers().forEach { $0(false) }
+        }
+        deltaQueue = deltaQueue.indices.filter { !droppedIndices.contains($0) }.map { deltaQueue[$0] }
+        droppedDeltaCount += overflow
+        return true
+    }
+
+    /**
+     Returns the depth, size and age of the delta queue and of every executor's queues.
+     Meant for diagnostics on a background thread, sizes are measured by archiving each queue.
+     */
+    public func queueDiagnostics() -> [OSQueueDiagnostics] {
+        let deltaQueueDiagnostics = dispatchQueue.sync {
+            OSQueueDiagnostics(name: "OSOperationRepo.deltaQueue", items: deltaQueue, timestamps: deltaQueue.map { $0.timestamp }, droppedCount: droppedDeltaCount)
+        }
+        return [deltaQueueDiagnostics] + executors.flatMap { $0.queueDiagnostics() }
     }
 
     /**
@@ -98,6 +347,10 @@ public class OSOperationRepo: NSObject {
         for delta in executor.supportedDeltas {
             deltasToExecutorMap[delta] = executor
         }
+        self.dispatchQueue.async {
+            // The executor may have uncached requests to send
+            self.scheduleFlush()
+        }
     }
 
     /**
@@ -112,22 +365,133 @@ public class OSOperationRepo: NSObject {
             return
         }
         start()
+        if let completionGroup = Thread.current.threadDictionary[OSOperationRepo.completionGroupKey] as? OSDeltaCompletionGroup {
+            delta.addCompletionHandler(completionGroup.enter())
+        }
         self.dispatchQueue.async {
-            OneSignalLog.onesignalLog(.LL_VERBOSE, message: "OSOperationRepo enqueueDelta: \(delta)")
-            self.deltaQueue.append(delta)
+            OneSignalLog.onesignalLog(.LL_VERBOSE) { "OSOperationRepo enqueueDelta: \(delta)" }
+            OSPerformanceCounters.increment(.deltasEnqueued)
+            if self.batchDepth > 0 {
+                if self.coalesceDelta(delta) != nil {
+                    OSPerformanceCounters.increment(.deltasCoalesced)
+                } else {
+                    self.deltaQueue.append(delta)
+                }
+                self.batchRequestedFlush = self.batchRequestedFlush || flush
+                return
+            }
+            if let (replacedDeltaId, coalesced) = self.coalesceDelta(delta) {
+                // An existing delta was replaced, so record the replacement in the persisted queue
+                OSPerformanceCounters.increment(.deltasCoalesced)
+                self.cacheCoalescedDelta(coalesced, replacing: replacedDeltaId)
+            } else {
+                self.deltaQueue.append(delta)
+                if self.trimDeltaQueue() {
+                    self.cacheDeltaQueue()
+                } else {
+                    // Persist the new delta to storage
+                    self.cacheEnqueuedDelta(delta)
+                }
+            }
+            OSFlightRecorder.record(.deltaEnqueued, arg0: Int64(self.deltaQueue.count), arg1: 0)
 
-            // Persist the deltas (including new delta) to storage
-            OneSignalUserDefaults.initShared().saveCodeableData(forKey: OS_OPERATION_REPO_DELTA_QUEUE_KEY, withValue: self.deltaQueue)
+            if flush || self.deltaQueue.count >= self.flushThreshold {
+                self.flushDeltaQueue()
+                self.rescheduleFlushIfNeeded()
+            } else {
+                self.scheduleFlush()
+            }
+        }
+    }
+
+    private static let completionGroupKey = "OneSignal.OSOperationRepo.completionGroup"
+
+    /**
+     Calls `completion` once every delta enqueued on this thread during `changes` has been sent, with false if any was
+     dropped or failed without a retry, and with true right away if `changes` enqueued nothing. Only deltas handled by
+     executors that call their completion handlers are supported, currently the properties executor.
+     Deltas of changes made inside a model store batch are enqueued when it ends and are not tracked.
+     */
+    public func trackCompletion(of changes: () -> Void, completion: @escaping (Bool) -> Void) {
+        let completionGroup = OSDeltaCompletionGroup(completion: completion)
+        let threadDictionary = Thread.current.threadDictionary
+        let outerGroup = threadDictionary[OSOperationRepo.completionGroupKey]
+        threadDictionary[OSOperationRepo.completionGroupKey] = completionGroup
+        changes()
+        threadDictionary[OSOperationRepo.completionGroupKey] = outerGroup
+        completionGroup.leave(true)
+    }
+
+    /**
+     Starts a batch of enqueues. Deltas enqueued until the matching `endBatch` are combined, then persisted once.
+     Batches may be nested; only the outermost `endBatch` persists and flushes.
+     */
+    public func beginBatch() {
+        self.dispatchQueue.async {
+            self.batchDepth += 1
+        }
+    }
 
-            if flush {
+    /**
+     Ends a batch of enqueues, persisting the combined delta queue once.
+     Flushes immediately if `flush` is true or any delta in the batch was enqueued with a flush.
+     */
+    public func endBatch(flush: Bool = false) {
+        self.dispatchQueue.async {
+            guard self.batchDepth > 0 else {
+                return
+            }
+            self.batchDepth -= 1
+            self.batchRequestedFlush = self.batchRequestedFlush || flush
+            guard self.batchDepth == 0 else {
+                return
+            }
+            _ = self.trimDeltaQueue()
+            self.cacheDeltaQueue()
+
+            if self.batchRequestedFlush || self.deltaQueue.count >= self.flushThreshold {
                 self.flushDeltaQueue()
+                self.rescheduleFlushIfNeeded()
+            } else if !self.deltaQueue.isEmpty {
+                self.scheduleFlush()
             }
+            self.batchRequestedFlush = false
         }
     }
 
+    /**
+     Attempts to fold the delta into a queued delta with the same user, name, and property, using
+     the merge rules of the executor that handles this delta. Must be called on the `dispatchQueue`.
+     Returns the id of the replaced delta and the delta now in its place, or nil if the delta should be appended.
+     */
+    private func coalesceDelta(_ delta: OSDelta) -> (replacedDeltaId: String, coalesced: OSDelta)? {
+        guard let executor = deltasToExecutorMap[delta.name] else {
+            return nil
+        }
+        for index in deltaQueue.indices.reversed() {
+            let existing = deltaQueue[index]
+            guard existing.name == delta.name,
+                  existing.identityModelId == delta.identityModelId,
+                  existing.property == delta.property
+            else {
+                continue
+            }
+            if let coalesced = executor.coalesce(existing, with: delta) {
+                for original in [existing, delta] where original !== coalesced {
+                    coalesced.takeCompletionHandlers(from: original)
+                }
+                deltaQueue[index] = coalesced
+                return (existing.deltaId, coalesced)
+            }
+            return nil
+        }
+        return nil
+    }
+
     @objc public func addFlushDeltaQueueToDispatchQueue(inBackground: Bool = false) {
         self.dispatchQueue.async {
             self.flushDeltaQueue(inBackground: inBackground)
+            self.rescheduleFlushIfNeeded()
         }
     }
 
@@ -148,25 +512,41 @@ public class OSOperationRepo: NSObject {
         self.start()
 
         if !self.deltaQueue.isEmpty {
-            OneSignalLog.onesignalLog(.LL_VERBOSE, message: "OSOperationRepo flushDeltaQueue in background: \(inBackground) with queue: \(self.deltaQueue)")
+            OneSignalLog.onesignalLog(.LL_VERBOSE) { "OSOperationRepo flushDeltaQueue in background: \(inBackground) with queue: \(self.deltaQueue)" }
         }
+        OSFlightRecorder.record(.deltaQueueFlushed, arg0: Int64(self.deltaQueue.count), arg1: inBackground ? 1 : 0)
 
-        var index = 0
+        // Divvy up the deltas per executor, keeping them in order
+        var handedOffDeltas = [[OSDelta]](repeating: [], count: self.executors.count)
+        var remainingDeltas: [OSDelta] = []
+        let flushedAt = Date()
         for delta in self.deltaQueue {
-            if let executor = self.deltasToExecutorMap[delta.name] {
-                executor.enqueueDelta(delta)
-                self.deltaQueue.remove(at: index)
+            if self.isPaused(identityModelId: delta.identityModelId) {
+                remainingDeltas.append(delta)
+            } else if let executor = self.deltasToExecutorMap[delta.name],
+               let executorIndex = self.executors.firstIndex(where: { $0 as AnyObject === executor as AnyObject }) {
+                delta.flushedAt = flushedAt
+                handedOffDeltas[executorIndex].append(delta)
             } else {
                 // keep in queue if no executor matches, we may not have the executor available yet
-                index += 1
+                remainingDeltas.append(delta)
             }
         }
 
-        // Persist the deltas (including removed deltas) to storage after they are divvy'd up to executors.
-        OneSignalUserDefaults.initShared().saveCodeableData(forKey: OS_OPERATION_REPO_DELTA_QUEUE_KEY, withValue: self.deltaQueue)
+        // Compact the persisted deltas after they are divvy'd up to executors, only if any were picked up.
+        if remainingDeltas.count < self.deltaQueue.count {
+            self.deltaQueue = remainingDeltas
+            self.cacheDeltaQueue()
+        }
 
-        for executor in self.executors {
-            executor.cacheDeltaQueue()
+        /**
+         Each executor owns a serial dispatch queue, and these calls only enqueue work onto it, so the executors
+         process and send their requests concurrently rather than one after another. The only ordering dependency,
+         that requests wait for the user to be created, is enforced per request by `prepareForExecution`.
+         Each executor is handed all of its deltas at once, and only executors that were handed deltas re-persist their delta queue.
+         */
+        for (executorIndex, deltas) in handedOffDeltas.enumerated() where !deltas.isEmpty {
+            self.executors[executorIndex].enqueueDeltas(deltas)
         }
 
         for executor in self.executors {
@@ -178,3 +558,38 @@ public class OSOperationRepo: NSObject {
         }
     }
 }
+
+/**
+ Calls its completion once every delta it was attached to has completed, with true only if all of them succeeded.
+ It starts out entered once by `trackCompletion`, so it cannot complete before all changes were made.
+ */
+private class OSDeltaCompletionGroup {
+    private let lock = NSLock()
+    private var pendingCount = 1
+    private var succeeded = true
+    private let completion: (Bool) -> Void
+
+    init(completion: @escaping (Bool) -> Void) {
+        self.completion = completion
+    }
+
+    func enter() -> (Bool) -> Void {
+        lock.withLock {
+            pendingCount += 1
+        }
+        return { success in
+            self.leave(success)
+        }
+    }
+
+    func leave(_ success: Bool) {
+        let result = lock.withLock { () -> Bool? in
+            succeeded = succeeded && success
+            pendingCount -= 1
+            return pendingCount == 0 ? succeeded : nil
+        }
+        if let result = result {
+            completion(result)
+        }
+    }
+}
@@ -0,0 +1,51 @@
+/*
+ Modified MIT License
+
+ Copyright 2024 OneSignal
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ 1. The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ 2. All copies of substantial portions of the Software may only be used in connection
+ with services provided by OneSignal.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ */
+
+import Foundation
+
+/**
+ A snapshot of one offline queue, for alerting on queue growth.
+ Obtained from `OSOperationRepo.queueDiagnostics()`, which covers the delta queue and every executor's request queues.
+ */
+public struct OSQueueDiagnostics {
+    public let name: String
+    public let depth: Int
+    /// The archived size of the queue, what it takes on disk
+    public let byteSize: Int
+    /// Seconds since the oldest item was created, nil for an empty queue
+    public let oldestItemAge: TimeInterval?
+    /// Items dropped this launch because the queue was over its limit or could not be sent
+    public let droppedCount: Int
+
+    public init(name: String, items: [Any], timestamps: [Date], droppedCount: Int) {
+        self.name = name
+        self.depth = items.count
+        self.byteSize = items.isEmpty ? 0 : NSKeyedArchiver.archivedData(withRootObject: items).count
+        self.oldestItemAge = timestamps.min().map { -$0.timeIntervalSinceNow }
+        self.droppedCount = droppedCount
+    }
+}
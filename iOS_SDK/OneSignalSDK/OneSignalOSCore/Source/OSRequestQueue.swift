@@ -0,0 +1,134 @@
+/*
+ Modified MIT License
+
+ Copyright 2024 OneSignal
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ 1. The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ 2. All copies of substantial portions of the Software may only be used in connection
+ with services provided by OneSignal.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ */
+
+import OneSignalCore
+
+/**
+ Where an `OSRequestQueue` keeps its requests between launches.
+ */
+public protocol OSRequestQueueStorage {
+    func load(forKey key: String) -> [Any]?
+    func save(_ requests: [Any], forKey key: String)
+}
+
+/// Stores request queues in the shared user defaults, which are written behind the caller.
+public struct OSSharedUserDefaultsRequestQueueStorage: OSRequestQueueStorage {
+    public init() { }
+
+    public func load(forKey key: String) -> [Any]? {
+        return OneSignalUserDefaults.initShared().getSavedCodeableData(forKey: key, defaultValue: []) as? [Any]
+    }
+
+    public func save(_ requests: [Any], forKey key: String) {
+        OneSignalUserDefaults.initShared().saveCodeableData(forKey: key, withValue: requests)
+    }
+}
+
+/**
+ A persisted queue of requests owned by an executor.
+ Executors share its uncaching, persisting and removal on completion instead of each repeating it per queue key.
+ It is not synchronized, the owning executor calls it from its own serial dispatch queue.
+ */
+public class OSRequestQueue<Request: OneSignalRequest> {
+    public let cacheKey: String
+    private let name: String
+    private let storage: OSRequestQueueStorage
+    /// Past this many requests some are dropped when the queue is persisted, see `persist`
+    public var maxCount = Int(OS_EXECUTOR_REQUEST_QUEUE_LIMIT)
+
+    public var requests: [Request] = []
+
+    // Metrics for this launch
+    public private(set) var completedCount = 0
+    public private(set) var droppedCount = 0
+
+    /// Whether a request was already handed to the client, these are dropped first when the queue is over `maxCount`
+    private let isSent: (Request) -> Bool
+
+    public init(cacheKey: String, name: String, storage: OSRequestQueueStorage = OSSharedUserDefaultsRequestQueueStorage(), isSent: @escaping (Request) -> Bool = { _ in false }) {
+        self.cacheKey = cacheKey
+        self.name = name
+        self.storage = storage
+        self.isSent = isSent
+    }
+
+    /**
+     Reads the persisted requests, keeping only those `keep` returns true for, and persists the result.
+     `keep` is also where the executor hooks each request back up to the models in its stores.
+     */
+    public func uncache(keep: (Request) -> Bool) {
+        guard let cachedRequests = storage.load(forKey: cacheKey) as? [Request] else {
+            OneSignalLog.onesignalLog(.LL_ERROR, message: "\(name) error encountered reading from cache for \(cacheKey)")
+            return
+        }
+        requests = []
+        for request in cachedRequests {
+            if keep(request) {
+                requests.append(request)
+            } else {
+                OneSignalLog.onesignalLog(.LL_WARN, message: "\(name).init dropped: \(request)")
+                droppedCount += 1
+            }
+        }
+        persist()
+    }
+
+    public func append(_ request: Request) {
+        requests.append(request)
+        persist()
+    }
+
+    /// Removes a request that completed, or failed and will not be retried.
+    public func complete(_ request: Request) {
+        requests.removeAll(where: { $0 == request })
+        completedCount += 1
+        persist()
+    }
+
+    public func persist() {
+        if requests.count > maxCount {
+            let overflow = requests.count - maxCount
+            // Requests already sent to the client can still succeed, so they are dropped before the oldest unsent ones
+            let dropOrder = requests.indices.sorted { first, second in
+                let firstSent = isSent(requests[first]), secondSent = isSent(requests[second])
+                return firstSent != secondSent ? firstSent : first < second
+            }
+            let droppedIndices = Set(dropOrder.prefix(overflow))
+            OneSignalLog.onesignalLog(.LL_WARN, message: "\(name) dropping \(overflow) requests over the limit of \(maxCount) for \(cacheKey)")
+            for index in droppedIndices.sorted() {
+                OneSignalLog.onesignalLog(.LL_WARN, message: "\(name) dropped: \(requests[index])")
+            }
+            requests = requests.indices.filter { !droppedIndices.contains($0) }.map { requests[$0] }
+            droppedCount += overflow
+        }
+        storage.save(requests, forKey: cacheKey)
+    }
+
+    public func diagnostics() -> OSQueueDiagnostics {
+        return OSQueueDiagnostics(name: cacheKey, items: requests, timestamps: requests.map { $0.timestamp }, droppedCount: droppedCount)
+    }
+}
@@ -0,0 +1,70 @@
+/*
+ Modified MIT License
+
+ Copyright 2024 OneSignal
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ 1. The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ 2. All copies of substantial portions of the Software may only be used in connection
+ with services provided by OneSignal.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ */
+
+import OneSignalCore
+
+/**
+ Bounds how many requests an executor has in flight, and keeps requests sharing a key in order.
+ Replaying a large backlog then sends at most `maxInFlight` requests at a time instead of all of them at once,
+ and a request for a user or subscription is only sent after the previous one for it completed.
+ */
+public class OSRequestWindow {
+    public let maxInFlight: Int
+    private var inFlightKeys: Set<String> = []
+    private let lock = NSRecursiveLock()
+
+    public init(maxInFlight: Int) {
+        self.maxInFlight = max(1, maxInFlight)
+    }
+
+    public var hasCapacity: Bool {
+        lock.withLock {
+            inFlightKeys.count < maxInFlight
+        }
+    }
+
+    /**
+     Returns true and counts the request as in flight if the window has room and no request with the same key is in flight.
+     Every successful acquire must be balanced by a `release` once the request completes.
+     A refused request stays queued, the executor sends it when it processes its queue after the next `release`.
+     */
+    public func acquire(_ key: String) -> Bool {
+        lock.withLock {
+            guard inFlightKeys.count < maxInFlight, !inFlightKeys.contains(key) else {
+                return false
+            }
+            inFlightKeys.insert(key)
+            return true
+        }
+    }
+
+    public func release(_ key: String) {
+        lock.withLock {
+            _ = inFlightKeys.remove(key)
+        }
+    }
+}
@@ -42,7 +42,9 @@ extension OSOperationRepo {
      to prevent state from carrying over between tests.
      */
     func reset() {
+        OSModelStorePersistence.waitForPendingSaves()
         deltaQueue.removeAll()
+        deltaLog?.remove()
         executors.removeAll()
         deltasToExecutorMap.removeAll()
         paused = false
@@ -292,6 +292,90 @@ class OSConsistencyManagerTests: XCTestCase {
 
         waitForExpectations(timeout: 2.0, handler: nil)
     }
+
+    func testAsyncConditionCompletesWhenTokenIsSetLater() {
+        let expectation = self.expectation(description: "Condition met asynchronously")
+
+        let id = "test_id"
+        let key = OSIamFetchOffsetKey.userUpdate
+        let value = OSReadYourWriteData(rywToken: "123", rywDelay: 0 as NSNumber)
+        let condition = TestMetCondition(expectedTokens: [id: [NSNumber(value: key.rawValue): value]])
+
+        // Registering must not block the calling thread
+        consistencyManager.getRywTokenFromAwaitableCondition(condition, forId: id, timeout: 0) { rywData in
+            XCTAssertEqual(rywData, value)
+            expectation.fulfill()
+        }
+
+        consistencyManager.setRywTokenAndDelay(id: id, key: key, value: value)
+
+        waitForExpectations(timeout: 2.0, handler: nil)
+    }
+
+    func testAsyncConditionCompletesWithNilOnTimeout() {
+        let expectation = self.expectation(description: "Condition timed out")
+
+        consistencyManager.getRywTokenFromAwaitableCondition(TestUnmetCondition(), forId: "test_id", timeout: 0.1) { rywData in
+            XCTAssertNil(rywData)
+            expectation.fulfill()
+        }
+
+        waitForExpectations(timeout: 2.0, handler: nil)
+    }
+
+    func testResolveConditionsWithIDCompletesWaitingConditions() {
+        let expectation = self.expectation(description: "Condition resolved")
+
+        consistencyManager.getRywTokenFromAwaitableCondition(TestUnmetCondition(), forId: "test_id", timeout: 0) { rywData in
+            XCTAssertNil(rywData)
+            expectation.fulfill()
+        }
+
+        consistencyManager.resolveConditionsWithID(id: TestUnmetCondition.CONDITIONID)
+
+        waitForExpectations(timeout: 2.0, handler: nil)
+    }
+
+    func testKeyedTokenConditionWaitsForAllRequiredKeys() {
+        let expectation = self.expectation(description: "Keyed condition met")
+
+        let id = "test_id"
+        let tagsData = OSReadYourWriteData(rywToken: "100", rywDelay: 0 as NSNumber)
+        let subscriptionData = OSReadYourWriteData(rywToken: "200", rywDelay: 0 as NSNumber)
+        let condition = OSKeyedTokenCondition(conditionId: "TestKeyedCondition", id: id, requiredKeys: [OSUserReadOffsetKey.tagsUpdate, OSUserReadOffsetKey.subscriptionUpdate])
+
+        consistencyManager.setRywTokenAndDelay(id: id, key: OSUserReadOffsetKey.tagsUpdate, value: tagsData)
+        XCTAssertFalse(condition.isMet(indexedTokens: [id: [NSNumber(value: OSUserReadOffsetKey.tagsUpdate.rawValue): tagsData]]))
+
+        consistencyManager.getRywTokenFromAwaitableCondition(condition, forId: id, timeout: 0) { rywData in
+            // The newest of the required tokens is returned
+            XCTAssertEqual(rywData, subscriptionData)
+            expectation.fulfill()
+        }
+        consistencyManager.setRywTokenAndDelay(id: id, key: OSUserReadOffsetKey.subscriptionUpdate, value: subscriptionData)
+
+        waitForExpectations(timeout: 2.0, handler: nil)
+    }
+
+    func testTokensForStaleIdsAreDropped() {
+        let expectation = self.expectation(description: "Stale id condition released")
+
+        let key = OSUserReadOffsetKey.tagsUpdate
+        let staleCondition = OSKeyedTokenCondition.tagsReadyCondition(onesignalId: "stale_id")
+        consistencyManager.setRywTokenAndDelay(id: "stale_id", key: OSIamFetchOffsetKey.userUpdate, value: OSReadYourWriteData(rywToken: "1", rywDelay: 0 as NSNumber))
+
+        consistencyManager.getRywTokenFromAwaitableCondition(staleCondition, forId: "stale_id", timeout: 0) { rywData in
+            XCTAssertNil(rywData)
+            expectation.fulfill()
+        }
+
+        // Writes for newer users (e.g. across logins) push the oldest id out
+        for index in 0..<4 {
+            consistencyManager.setRywTokenAndDelay(id: "user_\(index)", key: key, value: OSReadYourWriteData(rywToken: "\(index)", rywDelay: 0 as NSNumber))
+        }
+
+        waitForExpectations(timeout: 2.0, handler: nil)
+    }
 }
 
 // Mock implementation of OSCondition that simulates a condition that isn't met
@@ -0,0 +1,150 @@
+/*
+ Modified MIT License
+
+ Copyright 2024 OneSignal
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ 1. The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ 2. All copies of substantial portions of the Software may only be used in connection
+ with services provided by OneSignal.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ */
+
+import Foundation
+import XCTest
+@testable import OneSignalOSCore
+
+class OSDeltaLogTests: XCTestCase {
+    var deltaLog: OSDeltaLog!
+
+    override func setUp() {
+        super.setUp()
+        deltaLog = OSDeltaLog(fileName: "OSDeltaLogTests.bin")
+        deltaLog.remove()
+    }
+
+    override func tearDown() {
+        deltaLog.remove()
+        super.tearDown()
+    }
+
+    private func makeDelta(_ value: String) -> OSDelta {
+        return OSDelta(name: "TEST_DELTA", identityModelId: "identityModelId", model: OSModel(changeNotifier: OSEventProducer()), property: "property", value: value)
+    }
+
+    func testAppendedDeltasAreReadBackInOrder() {
+        let deltas = [makeDelta("a"), makeDelta("b"), makeDelta("c")]
+        for delta in deltas {
+            deltaLog.append(delta)
+        }
+
+        let readDeltas = deltaLog.readAll()
+        XCTAssertEqual(readDeltas.map { $0.deltaId }, deltas.map { $0.deltaId })
+        XCTAssertEqual(readDeltas.map { $0.value as? String }, ["a", "b", "c"])
+    }
+
+    func testCompactRewritesLogToRemainingDeltas() {
+        let remaining = makeDelta("b")
+        deltaLog.append(makeDelta("a"))
+        deltaLog.append(remaining)
+
+        deltaLog.compact([remaining])
+
+        XCTAssertEqual(deltaLog.readAll().map { $0.deltaId }, [remaining.deltaId])
+    }
+
+    func testReplacementTakesThePlaceOfTheReplacedDeltaWithoutRewritingTheLog() throws {
+        let first = makeDelta("a")
+        let replaced = makeDelta("b")
+        let last = makeDelta("c")
+        for delta in [first, replaced, last] {
+            deltaLog.append(delta)
+        }
+        let before = try Data(contentsOf: deltaLog.fileURL)
+
+        let coalesced = makeDelta("b2")
+        deltaLog.replace(replaced.deltaId, with: coalesced)
+
+        // The existing records are left as they were, the replacement is appended after them
+        let data = try Data(contentsOf: deltaLog.fileURL)
+        XCTAssertEqual(data.prefix(before.count), before)
+        XCTAssertGreaterThan(data.count, before.count)
+        XCTAssertEqual(deltaLog.readAll().map { $0.deltaId }, [first.deltaId, coalesced.deltaId, last.deltaId])
+        XCTAssertEqual(deltaLog.readAll().map { $0.value as? String }, ["a", "b2", "c"])
+    }
+
+    func testDeltaWhoseModelIsNotInAnyStoreFailsToDecode() throws {
+        let model = OSModel(changeNotifier: OSEventProducer())
+        let delta = OSDelta(name: "TEST_DELTA", identityModelId: "identityModelId", model: model, property: "tags", value: ["a": "1"])
+
+        // While the model is in a store the delta only references it
+        OSModelStoreRegistry.shared.register(model)
+        let data = NSKeyedArchiver.archivedData(withRootObject: delta)
+        XCTAssertNotNil(NSKeyedUnarchiver.unarchiveObject(with: data) as? OSDelta)
+
+        // Once it is removed, the reference cannot be resolved and the delta is dropped instead of sent without a model
+        OSModelStoreRegistry.shared.unregister(model)
+        XCTAssertNil(NSKeyedUnarchiver.unarchiveObject(with: data) as? OSDelta)
+    }
+
+    func testTruncatedTrailingRecordIsIgnored() throws {
+        let delta = makeDelta("a")
+        deltaLog.append(delta)
+        deltaLog.append(makeDelta("b"))
+
+        // Simulate a crash in the middle of writing the last record
+        var data = try Data(contentsOf: deltaLog.fileURL)
+        data.removeLast(10)
+        try data.write(to: deltaLog.fileURL)
+
+        XCTAssertEqual(deltaLog.readAll().map { $0.deltaId }, [delta.deltaId])
+    }
+
+    func testDeltasAppendedAfterLoadingATruncatedLogAreReadBack() throws {
+        let first = makeDelta("a")
+        deltaLog.append(first)
+        deltaLog.append(makeDelta("b"))
+        var data = try Data(contentsOf: deltaLog.fileURL)
+        data.removeLast(10)
+        try data.write(to: deltaLog.fileURL)
+
+        XCTAssertEqual(deltaLog.load().map { $0.deltaId }, [first.deltaId])
+        let appended = makeDelta("c")
+        deltaLog.append(appended)
+
+        // A new launch reads both, the appended record was not written after the partial one
+        let reloaded = OSDeltaLog(fileName: "OSDeltaLogTests.bin")!
+        XCTAssertEqual(reloaded.load().map { $0.deltaId }, [first.deltaId, appended.deltaId])
+        XCTAssertEqual(reloaded.readAll().map { $0.value as? String }, ["a", "c"])
+    }
+
+    func testDeltaEncodingRoundTripsValuesAndDetachedModel() throws {
+        let model = OSModel(changeNotifier: OSEventProducer())
+        let tagsDelta = OSDelta(name: "TEST_DELTA", identityModelId: "identityModelId", model: model, property: "tags", value: ["a": "1", "b": ""])
+        let countDelta = OSDelta(name: "TEST_DELTA", identityModelId: "identityModelId", model: model, property: "session_count", value: 2)
+
+        let data = NSKeyedArchiver.archivedData(withRootObject: [tagsDelta, countDelta])
+        let decoded = try XCTUnwrap(NSKeyedUnarchiver.unarchiveTopLevelObjectWithData(data) as? [OSDelta])
+
+        XCTAssertEqual(decoded[0].value as? [String: String], ["a": "1", "b": ""])
+        XCTAssertEqual(decoded[1].value as? Int, 2)
+        // The model is not in a store, so it was embedded rather than referenced
+        XCTAssertEqual(decoded[0].model.modelId, model.modelId)
+        XCTAssertEqual(decoded[0].modelId, model.modelId)
+    }
+}
@@ -0,0 +1,75 @@
+/*
+ Modified MIT License
+
+ Copyright 2024 OneSignal
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ 1. The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ 2. All copies of substantial portions of the Software may only be used in connection
+ with services provided by OneSignal.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ */
+
+import Foundation
+import XCTest
+@testable import OneSignalOSCore
+
+/**
+ Benchmarks of persisting deltas, which happens on every enqueue and on every launch with a pending queue.
+ */
+class OSDeltaPerformanceTests: XCTestCase {
+    var deltaLog: OSDeltaLog!
+
+    override func setUp() {
+        super.setUp()
+        deltaLog = OSDeltaLog(fileName: "OSDeltaPerformanceTests.bin")
+        deltaLog.remove()
+    }
+
+    override func tearDown() {
+        deltaLog.remove()
+        super.tearDown()
+    }
+
+    private func makeDeltas(_ count: Int) -> [OSDelta] {
+        let model = OSModel(changeNotifier: OSEventProducer())
+        return (0..<count).map {
+            OSDelta(name: "TEST_DELTA", identityModelId: "identityModelId", model: model, property: "tags", value: ["tag\($0)": "value"])
+        }
+    }
+
+    func testEncodingAndDecoding1000Deltas() throws {
+        let deltas = makeDeltas(1000)
+        measure {
+            let data = NSKeyedArchiver.archivedData(withRootObject: deltas)
+            let decoded = try? NSKeyedUnarchiver.unarchiveTopLevelObjectWithData(data) as? [OSDelta]
+            XCTAssertEqual(decoded?.count, 1000)
+        }
+    }
+
+    func testAppendingAndReading1000DeltasFromTheLog() throws {
+        let deltas = makeDeltas(1000)
+        measure {
+            deltaLog.remove()
+            for delta in deltas {
+                deltaLog.append(delta)
+            }
+            XCTAssertEqual(deltaLog.readAll().count, 1000)
+        }
+    }
+}
@@ -0,0 +1,75 @@
+/*
+ Modified MIT License
+
+ Copyright 2024 OneSignal
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ 1. The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ 2. All copies of substantial portions of the Software may only be used in connection
+ with services provided by OneSignal.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ */
+
+import Foundation
+import XCTest
+@testable import OneSignalOSCore
+
+private class ChangeRecorder: OSModelChangedHandler {
+    var changes: [OSModelChangedArgs] = []
+
+    func onModelUpdated(args: OSModelChangedArgs, hydrating: Bool) {
+        changes.append(args)
+    }
+}
+
+class OSModelTests: XCTestCase {
+
+    func testBatchUpdateReportsOneChangeWithEveryProperty() {
+        let recorder = ChangeRecorder()
+        let model = OSModel(changeNotifier: OSEventProducer())
+        model.changeNotifier.subscribe(recorder)
+
+        model.batchUpdate {
+            model.set(property: "deviceOs", newValue: "17.0")
+            model.set(property: "appVersion", newValue: "1.2.3")
+            // A nested batch is part of the outer one
+            model.batchUpdate {
+                model.set(property: "netType", newValue: 0)
+            }
+        }
+
+        XCTAssertEqual(recorder.changes.count, 1)
+        let changedProperties = recorder.changes[0].changedProperties
+        XCTAssertEqual(changedProperties["deviceOs"] as? String, "17.0")
+        XCTAssertEqual(changedProperties["appVersion"] as? String, "1.2.3")
+        XCTAssertEqual(changedProperties["netType"] as? Int, 0)
+    }
+
+    func testBatchUpdateWithOneChangeReportsItAsIs() {
+        let recorder = ChangeRecorder()
+        let model = OSModel(changeNotifier: OSEventProducer())
+        model.changeNotifier.subscribe(recorder)
+
+        model.batchUpdate {
+            model.set(property: "sdk", newValue: "050200")
+        }
+        model.batchUpdate { }
+
+        XCTAssertEqual(recorder.changes.map { $0.property }, ["sdk"])
+    }
+}
@@ -0,0 +1,145 @@
+/*
+ Modified MIT License
+
+ Copyright 2024 OneSignal
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ 1. The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ 2. All copies of substantial portions of the Software may only be used in connection
+ with services provided by OneSignal.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ */
+
+
+import Foundation
+import XCTest
+import OneSignalCore
+@testable import OneSignalOSCore
+
+// An executor that always reports requests waiting to be sent, such as while the network is down
+private class MockPendingExecutor: OSOperationExecutor {
+    var supportedDeltas: [String] = ["MOCK_PENDING_DELTA"]
+    var deltaQueue: [OSDelta] = []
+    private let lock = NSLock()
+    private var _processCount = 0
+    private var _pending = true
+
+    var processCount: Int {
+        lock.withLock { _processCount }
+    }
+
+    var pending: Bool {
+        get { lock.withLock { _pending } }
+        set { lock.withLock { _pending = newValue } }
+    }
+
+    func enqueueDelta(_ delta: OSDelta) { }
+    func cacheDeltaQueue() { }
+    func processRequestQueue(inBackground: Bool) { }
+
+    func processDeltaQueue(inBackground: Bool) {
+        lock.withLock { _processCount += 1 }
+    }
+
+    func hasPendingWork() -> Bool {
+        return pending
+    }
+}
+
+class OSOperationRepoTests: XCTestCase {
+
+    override func setUpWithError() throws {
+        OneSignalConfigManager.setAppId("test-app-id")
+        // Deltas persisted by an earlier test would be read back by the next repo
+        OneSignalUserDefaults.initShared().removeValue(forKey: OS_OPERATION_REPO_DELTA_QUEUE_KEY)
+    }
+
+    private func makeRepo() -> OSOperationRepo {
+        let repo = OSOperationRepo()
+        repo.deltaLog = nil
+        repo.pollIntervalMilliseconds = 10
+        return repo
+    }
+
+    private func settle(_ repo: OSOperationRepo, seconds: TimeInterval = 0.2) {
+        Thread.sleep(forTimeInterval: seconds)
+        repo.dispatchQueue.sync { }
+    }
+
+    func testFlushTimerStopsWhileOfflineAndResumesWhenReachable() {
+        let repo = makeRepo()
+        let lock = NSLock()
+        var reachable = false
+        repo.isNetworkReachable = { lock.withLock { reachable } }
+        let executor = MockPendingExecutor()
+        defer { executor.pending = false }
+
+        repo.addExecutor(executor)
+        settle(repo)
+        let offlineCount = executor.processCount
+
+        // Pending requests no longer re-arm the timer while the network is unreachable
+        settle(repo)
+        XCTAssertEqual(executor.processCount, offlineCount)
+        XCTAssertTrue(repo.isIdle)
+
+        lock.withLock { reachable = true }
+        NotificationCenter.default.post(name: Notification.Name(OS_REACHABILITY_CHANGED_NOTIFICATION), object: nil)
+        settle(repo)
+        XCTAssertGreaterThan(executor.processCount, offlineCount)
+    }
+
+    func testDeltasOverTheLimitDropPropertyUpdatesFirst() {
+        let repo = makeRepo()
+        repo.paused = true
+        repo.flushThreshold = 100
+        repo.deltaQueueLimit = 2
+        let model = OSModel(changeNotifier: OSEventProducer())
+        let subscriptionDelta = OSDelta(name: OS_ADD_SUBSCRIPTION_DELTA, identityModelId: "identity", model: model, property: "subscription", value: "value")
+        let olderPropertyDelta = OSDelta(name: OS_UPDATE_PROPERTIES_DELTA, identityModelId: "identity", model: model, property: "tags", value: "value")
+        let newerPropertyDelta = OSDelta(name: OS_UPDATE_PROPERTIES_DELTA, identityModelId: "identity", model: model, property: "language", value: "value")
+
+        repo.enqueueDelta(subscriptionDelta)
+        repo.enqueueDelta(olderPropertyDelta)
+        repo.enqueueDelta(newerPropertyDelta)
+        repo.dispatchQueue.sync { }
+
+        XCTAssertEqual(repo.deltaQueue.map { $0.deltaId }, [subscriptionDelta.deltaId, newerPropertyDelta.deltaId])
+        XCTAssertEqual(repo.queueDiagnostics().first?.droppedCount, 1)
+    }
+
+    func testDeltaQueueDepthGaugeFollowsFlushes() {
+        OSPerformanceCounters.reset()
+        let repo = makeRepo()
+        let executor = MockPendingExecutor()
+        executor.pending = false
+        repo.addExecutor(executor)
+        repo.paused = true
+        let model = OSModel(changeNotifier: OSEventProducer())
+
+        repo.enqueueDelta(OSDelta(name: "MOCK_PENDING_DELTA", identityModelId: "identity", model: model, property: "first", value: "value"))
+        repo.enqueueDelta(OSDelta(name: "MOCK_PENDING_DELTA", identityModelId: "identity", model: model, property: "second", value: "value"))
+        repo.dispatchQueue.sync { }
+        XCTAssertEqual(OSPerformanceCounters.snapshot()["delta_queue_depth"], 2)
+
+        // The deltas are handed to the executor
+        repo.paused = false
+        settle(repo)
+        XCTAssertEqual(OSPerformanceCounters.snapshot()["delta_queue_depth"], 0)
+    }
+}
@@ -0,0 +1,98 @@
+/*
+ Modified MIT License
+
+ Copyright 2024 OneSignal
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ 1. The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ 2. All copies of substantial portions of the Software may only be used in connection
+ with services provided by OneSignal.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ */
+
+import Foundation
+import XCTest
+import OneSignalCore
+@testable import OneSignalOSCore
+
+private class MockRequestQueueStorage: OSRequestQueueStorage {
+    var saved: [String: [Any]] = [:]
+
+    func load(forKey key: String) -> [Any]? {
+        return saved[key] ?? []
+    }
+
+    func save(_ requests: [Any], forKey key: String) {
+        saved[key] = requests
+    }
+}
+
+class OSRequestQueueTests: XCTestCase {
+
+    func testUncacheDropsRequestsThatAreNotKept() {
+        let storage = MockRequestQueueStorage()
+        let kept = OneSignalRequest()
+        let dropped = OneSignalRequest()
+        storage.saved["key"] = [kept, dropped]
+
+        let queue = OSRequestQueue<OneSignalRequest>(cacheKey: "key", name: "OSRequestQueueTests", storage: storage)
+        queue.uncache { $0 == kept }
+
+        XCTAssertEqual(queue.requests, [kept])
+        XCTAssertEqual(queue.droppedCount, 1)
+        XCTAssertEqual(storage.saved["key"]?.count, 1)
+    }
+
+    func testCompletedRequestsAreRemovedAndPersisted() {
+        let storage = MockRequestQueueStorage()
+        let queue = OSRequestQueue<OneSignalRequest>(cacheKey: "key", name: "OSRequestQueueTests", storage: storage)
+        let first = OneSignalRequest()
+        let second = OneSignalRequest()
+        queue.append(first)
+        queue.append(second)
+        XCTAssertEqual(storage.saved["key"]?.count, 2)
+
+        queue.complete(first)
+
+        XCTAssertEqual(queue.requests, [second])
+        XCTAssertEqual(queue.completedCount, 1)
+        XCTAssertEqual(storage.saved["key"]?.count, 1)
+    }
+
+    func testRequestsOverTheLimitAreDropped_sentOnesFirst() {
+        let storage = MockRequestQueueStorage()
+        let sent = OneSignalRequest()
+        let queue = OSRequestQueue<OneSignalRequest>(cacheKey: "key", name: "OSRequestQueueTests", storage: storage, isSent: { $0 == sent })
+        queue.maxCount = 2
+        let oldest = OneSignalRequest()
+        let newest = OneSignalRequest()
+        queue.append(oldest)
+        queue.append(sent)
+
+        queue.append(newest)
+
+        XCTAssertEqual(queue.requests, [oldest, newest])
+        XCTAssertEqual(queue.droppedCount, 1)
+
+        // Without a sent request, the oldest one goes
+        queue.append(OneSignalRequest())
+        XCTAssertEqual(queue.requests.first, newest)
+        XCTAssertEqual(queue.droppedCount, 2)
+        XCTAssertEqual(storage.saved["key"]?.count, 2)
+    }
+}
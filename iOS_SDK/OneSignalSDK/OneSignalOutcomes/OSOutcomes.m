@@ -62,7 +62,7 @@ static OneSignalOutcomeEventsController *_sharedController;
     let uniqueCacheOutcomeVersion = 21403;
     long sdkVersion = [OneSignalUserDefaults.initShared getSavedIntegerForKey:OSUD_CACHED_SDK_VERSION defaultValue:0];
     if (sdkVersion < influenceVersion) {
-        [OneSignalLog onesignalLog:ONE_S_LL_DEBUG message:[NSString stringWithFormat:@"Migrating OSIndirectNotification from version: %ld", sdkVersion]];
+        ONE_S_LOG(ONE_S_LL_DEBUG, @"Migrating OSIndirectNotification from version: %ld", sdkVersion);
 
         [NSKeyedUnarchiver setClass:[OSIndirectInfluence class] forClassName:@"OSIndirectNotification"];
         NSArray<OSIndirectInfluence *> * indirectInfluenceData = [[OSInfluenceDataRepository sharedInfluenceDataRepository] lastNotificationsReceivedData];
@@ -73,7 +73,7 @@ static OneSignalOutcomeEventsController *_sharedController;
     }
     
     if (sdkVersion < uniqueCacheOutcomeVersion) {
-        [OneSignalLog onesignalLog:ONE_S_LL_DEBUG message:[NSString stringWithFormat:@"Migrating OSUniqueOutcomeNotification from version: %ld", sdkVersion]];
+        ONE_S_LOG(ONE_S_LL_DEBUG, @"Migrating OSUniqueOutcomeNotification from version: %ld", sdkVersion);
         
         [NSKeyedUnarchiver setClass:[OSCachedUniqueOutcome class] forClassName:@"OSUniqueOutcomeNotification"];
         NSArray<OSCachedUniqueOutcome *> * attributedCacheUniqueOutcomeEvents = [[OSOutcomeEventsCache sharedOutcomeEventsCache] getAttributedUniqueOutcomeEventSent];
@@ -37,6 +37,7 @@
 #import "OSCachedUniqueOutcome.h"
 #import "OneSignalOutcomeEventsController.h"
 #import "OSInfluenceDataRepository.h"
+#import "OSInfluenceRingBuffer.h"
 #import "OSOutcomeEventsFactory.h"
 #import "OSTrackerFactory.h"
 #import "OSOutcomeEventsRepository.h"
@@ -45,9 +45,11 @@ THE SOFTWARE.
 - (void)initInfluencedTypeFromCache;
 - (void)cacheState;
 - (void)resetAndInitInfluence;
+- (void)invalidateSessionInfluence;
 
 - (NSArray * _Nonnull)lastReceivedIds;
 - (void)saveLastId:(NSString *_Nullable)lastId;
+- (void)saveLastId:(NSString *_Nullable)lastId timestamp:(NSTimeInterval)timestamp;
 
 - (OSInfluence *_Nonnull)currentSessionInfluence;
 
@@ -29,6 +29,14 @@ THE SOFTWARE.
 #import <OneSignalCore/OneSignalCore.h>
 #import "OSChannelTracker.h"
 #import "OSIndirectInfluence.h"
+#import "OSInfluenceRingBuffer.h"
+
+@interface OSChannelTracker ()
+
+// Built from the tracker state on demand and dropped whenever that state or the influence params change
+@property (strong, nonatomic, nullable) OSInfluence *cachedSessionInfluence;
+
+@end
 
 @implementation OSChannelTracker
 
@@ -40,16 +48,34 @@ THE SOFTWARE.
     return self;
 }
 
+- (void)setInfluenceType:(OSInfluenceType)influenceType {
+    _influenceType = influenceType;
+    _cachedSessionInfluence = nil;
+}
+
+- (void)setDirectId:(NSString *)directId {
+    _directId = directId;
+    _cachedSessionInfluence = nil;
+}
+
+- (void)setIndirectIds:(NSArray *)indirectIds {
+    _indirectIds = indirectIds;
+    _cachedSessionInfluence = nil;
+}
+
+- (void)invalidateSessionInfluence {
+    _cachedSessionInfluence = nil;
+}
+
 /*
  Start Methods implemented by childrens
  */
 - (NSString * _Nonnull)idTag { mustOverride(); }
 - (OSInfluenceChannel)channelType { mustOverride(); }
-- (NSArray * _Nullable)lastChannelObjectsReceivedByNewId:(NSString *)identifier { mustOverride(); }
-- (NSArray * _Nullable)lastChannelObjects { mustOverride(); }
-- (NSInteger)channelLimit { mustOverride(); }
+- (OSInfluenceRingBuffer * _Nonnull)receivedBufferByNewId:(NSString *)identifier { mustOverride(); }
+- (OSInfluenceRingBuffer * _Nonnull)receivedBuffer { mustOverride(); }
 - (NSInteger)indirectAttributionWindow { mustOverride(); }
-- (void)saveChannelObjects:(NSArray * _Nonnull)channelObjects { mustOverride(); }
+- (void)saveReceivedBuffer:(OSInfluenceRingBuffer * _Nonnull)buffer { mustOverride(); }
 - (void)initInfluencedTypeFromCache { mustOverride(); }
 - (void)cacheState { mustOverride(); }
 /*
@@ -72,67 +98,45 @@ THE SOFTWARE.
     _directId = nil;
     _indirectIds = [self lastReceivedIds];
     _influenceType = _indirectIds != nil && _indirectIds.count > 0 ? INDIRECT : UNATTRIBUTED;
+    _cachedSessionInfluence = nil;
     
     [self cacheState];
-    [OneSignalLog onesignalLog:ONE_S_LL_DEBUG message:[NSString stringWithFormat:@"OSChannelTracker resetAndInitInfluence for: %@ finish with influenceType: %@", [self idTag], OS_INFLUENCE_TYPE_TO_STRING(_influenceType)]];
+    ONE_S_LOG(ONE_S_LL_DEBUG, @"OSChannelTracker resetAndInitInfluence for: %@ finish with influenceType: %@", [self idTag], OS_INFLUENCE_TYPE_TO_STRING(_influenceType));
 }
 
 - (NSArray * _Nonnull)lastReceivedIds {
-    NSMutableArray *ids = [NSMutableArray new];
-    NSArray *lastChannelObjectReceived = [self lastChannelObjects];
-    [OneSignalLog onesignalLog:ONE_S_LL_DEBUG message:[NSString stringWithFormat:@"OSChannelTracker for: %@ lastChannelObjectReceived: %@", [self idTag], lastChannelObjectReceived]];
-    if (!lastChannelObjectReceived || lastChannelObjectReceived.count == 0)
-        return ids; // Unattributed session
-     
-    NSInteger attributionWindowInSeconds = [self indirectAttributionWindow];
-    NSTimeInterval currentTime = [[NSDate date] timeIntervalSince1970];
-    
+    let receivedBuffer = [self receivedBuffer];
+    ONE_S_LOG(ONE_S_LL_DEBUG, @"OSChannelTracker for: %@ receivedBuffer: %@", [self idTag], receivedBuffer);
+
     // Add only valid indirectInfluences within the attribution window
-    for (var i = 0; i < lastChannelObjectReceived.count; i++) {
-        OSIndirectInfluence* indirectInfluence = [lastChannelObjectReceived objectAtIndex:i];
-        long difference = currentTime - indirectInfluence.timestamp;
-        if (difference <= attributionWindowInSeconds)
-            [ids addObject:indirectInfluence.influenceId];
-    }
-    return ids;
+    NSTimeInterval currentTime = [[NSDate date] timeIntervalSince1970];
+    return [receivedBuffer idsReceivedSince:currentTime - [self indirectAttributionWindow]];
 }
 
 - (void)saveLastId:(NSString *)lastId {
-    [OneSignalLog onesignalLog:ONE_S_LL_DEBUG message:[NSString stringWithFormat:@"OSChannelTracker for: %@ saveLastId id: %@", [self idTag], lastId]];
-       
-    let channelLimit = [self channelLimit];
-    let lastChannelObjectsReceived = [self lastChannelObjectsReceivedByNewId:lastId];
-
-    [OneSignalLog onesignalLog:ONE_S_LL_DEBUG message:[NSString stringWithFormat:@"OSChannelTracker for: %@ saveLastId with lastChannelObjectReceived: %@", [self idTag], lastChannelObjectsReceived]];
-
-    let timestamp = [NSDate date].timeIntervalSince1970;
-    let indirectInfluence = [[OSIndirectInfluence alloc] initWithParamsInfluenceId:lastId forChannel:[self idTag] timestamp:timestamp];
-       
-    // Create channelObjectToSave to be saved at a limited size, removing any old notifications
-    NSArray *channelObjectToSave;
-    if (!lastChannelObjectsReceived || lastChannelObjectsReceived.count == 0) {
-        channelObjectToSave = [NSArray arrayWithObject:indirectInfluence];
-    } else if (lastChannelObjectsReceived.count < channelLimit) {
-        NSMutableArray *lastChannelObjectsReceivedMutable = [lastChannelObjectsReceived mutableCopy];
-        [lastChannelObjectsReceivedMutable addObject:indirectInfluence];
-        channelObjectToSave = lastChannelObjectsReceivedMutable;
-    } else {
-        NSMutableArray *lastChannelObjectsReceivedMutable = [lastChannelObjectsReceived mutableCopy];
-        [lastChannelObjectsReceivedMutable addObject:indirectInfluence];
-        
-        // Remove old indirectInfluences to keep final indirectInfluence at a limited size
-        let lengthDifference = lastChannelObjectsReceivedMutable.count - channelLimit;
-        for (int i = 0; i < lengthDifference; i++)
-            [lastChannelObjectsReceivedMutable removeObjectAtIndex:0];
-        
-        channelObjectToSave = lastChannelObjectsReceivedMutable;
-    }
-       
-    [OneSignalLog onesignalLog:ONE_S_LL_DEBUG message:[NSString stringWithFormat:@"OSChannelTracker for: %@ with channelObjectToSave: %@", [self idTag], channelObjectToSave]];
-    [self saveChannelObjects:channelObjectToSave];
+    [self saveLastId:lastId timestamp:[NSDate date].timeIntervalSince1970];
+}
+
+- (void)saveLastId:(NSString *)lastId timestamp:(NSTimeInterval)timestamp {
+    ONE_S_LOG(ONE_S_LL_DEBUG, @"OSChannelTracker for: %@ saveLastId id: %@", [self idTag], lastId);
+    if (!lastId)
+        return;
+
+    // The buffer is sized to the channel limit, so adding overwrites the oldest id once full
+    let receivedBuffer = [self receivedBufferByNewId:lastId];
+    [receivedBuffer addId:lastId timestamp:timestamp];
+
+    ONE_S_LOG(ONE_S_LL_DEBUG, @"OSChannelTracker for: %@ with receivedBuffer to save: %@", [self idTag], receivedBuffer);
+    [self saveReceivedBuffer:receivedBuffer];
 }
 
 - (OSInfluence *)currentSessionInfluence {
+    if (!_cachedSessionInfluence)
+        _cachedSessionInfluence = [self buildSessionInfluence];
+    return _cachedSessionInfluence;
+}
+
+- (OSInfluence *)buildSessionInfluence {
     OSInfluenceBuilder *builder = [OSInfluenceBuilder new];
     builder.influenceType = DISABLED;
     builder.influenceChannel = [self channelType];
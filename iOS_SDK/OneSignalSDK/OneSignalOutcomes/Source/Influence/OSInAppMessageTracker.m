@@ -27,7 +27,6 @@ THE SOFTWARE.
 
 #import <Foundation/Foundation.h>
 #import "OSInfluence.h"
-#import "OSIndirectInfluence.h"
 #import "OSInAppMessageTracker.h"
 #import <OneSignalCore/OneSignalCore.h>
 
@@ -47,34 +46,23 @@ THE SOFTWARE.
     return IN_APP_MESSAGE;
 }
 
-- (NSArray * _Nonnull)lastChannelObjectsReceivedByNewId:(NSString *)identifier {
-    NSArray *lastChannelObjectReceived = [self lastChannelObjects];
+- (OSInfluenceRingBuffer * _Nonnull)receivedBufferByNewId:(NSString *)identifier {
+    let receivedBuffer = [self receivedBuffer];
     // For IAM we handle redisplay, we need to remove duplicates for new influence Id
-    NSMutableArray *auxLastChannelObjectReceived = [NSMutableArray new];
-    if (lastChannelObjectReceived) {
-        for (var i = 0; i < lastChannelObjectReceived.count; i++) {
-            OSIndirectInfluence* indirectInfluence = [lastChannelObjectReceived objectAtIndex:i];
-            if (![indirectInfluence.influenceId isEqualToString:identifier])
-                [auxLastChannelObjectReceived addObject:indirectInfluence];
-        }
-    }
-    return auxLastChannelObjectReceived;
+    [receivedBuffer removeId:identifier];
+    return receivedBuffer;
 }
 
-- (NSArray * _Nullable)lastChannelObjects {
-    return [self.dataRepository lastIAMsReceivedData];
-}
-
-- (NSInteger)channelLimit {
-    return [self.dataRepository iamLimit];
+- (OSInfluenceRingBuffer * _Nonnull)receivedBuffer {
+    return [self.dataRepository iamsReceivedBuffer];
 }
 
 - (NSInteger)indirectAttributionWindow {
     return [self.dataRepository iamIndirectAttributionWindow];
 }
 
-- (void)saveChannelObjects:(NSArray * _Nonnull)channelObjects {
-    [self.dataRepository saveIAMs:channelObjects];
+- (void)saveReceivedBuffer:(OSInfluenceRingBuffer * _Nonnull)buffer {
+    [self.dataRepository saveIAMsReceivedBuffer:buffer];
 }
 
 - (void)initInfluencedTypeFromCache {
@@ -82,7 +70,7 @@ THE SOFTWARE.
     if (self.influenceType == INDIRECT)
         self.indirectIds = [self lastReceivedIds];
     
-    [OneSignalLog onesignalLog:ONE_S_LL_DEBUG message:[NSString stringWithFormat:@"InAppMessageTracker initInfluencedTypeFromCache: %@", [self description]]];
+    ONE_S_LOG(ONE_S_LL_DEBUG, @"InAppMessageTracker initInfluencedTypeFromCache: %@", [self description]);
 }
 
 - (void)cacheState {
@@ -26,6 +26,7 @@ THE SOFTWARE.
 */
 
 #import "OSInfluence.h"
+#import "OSInfluenceRingBuffer.h"
 
 @interface OSInfluenceDataRepository : NSObject
 
@@ -43,11 +44,15 @@ THE SOFTWARE.
 - (void)cacheIndirectNotifications:(NSArray * _Nullable)notifications;
 - (NSArray * _Nullable)cachedIndirectNotifications;
 
+// The archived list the received buffer is seeded from, only used by migrations from older SDK versions
 - (void)saveNotifications:(NSArray * _Nullable)notifications;
 - (NSArray * _Nullable)lastNotificationsReceivedData;
 
-- (void)saveIAMs:(NSArray * _Nullable)iams;
-- (NSArray * _Nullable)lastIAMsReceivedData;
+- (OSInfluenceRingBuffer * _Nonnull)notificationsReceivedBuffer;
+- (void)saveNotificationsReceivedBuffer:(OSInfluenceRingBuffer * _Nonnull)buffer;
+
+- (OSInfluenceRingBuffer * _Nonnull)iamsReceivedBuffer;
+- (void)saveIAMsReceivedBuffer:(OSInfluenceRingBuffer * _Nonnull)buffer;
 
 - (NSInteger)notificationLimit;
 - (NSInteger)iamLimit;
@@ -29,8 +29,17 @@ THE SOFTWARE.
 #import "OSInfluenceDataRepository.h"
 #import "OSInfluenceDataDefines.h"
 #import "OSInfluence.h"
+#import "OSWriteThroughCache.h"
 #import <OneSignalCore/OneSignalCore.h>
 
+@interface OSInfluenceDataRepository ()
+// Read on every outcome send and session influence computation. These keys are only written by this repository.
+@property (strong, nonatomic, nonnull) OSWriteThroughCache *cachedValues;
+// Stored received buffer dictionaries, valid while OSSharedStateVersion is at `receivedBuffersVersion`. Synchronized on itself.
+@property (strong, nonatomic, nonnull) NSMutableDictionary<NSString *, id> *receivedBuffers;
+@property (nonatomic) NSUInteger receivedBuffersVersion;
+@end
+
 @implementation OSInfluenceDataRepository
 
 static OSInfluenceDataRepository *_influenceDataRepository;
@@ -40,82 +49,178 @@ static OSInfluenceDataRepository *_influenceDataRepository;
     return _influenceDataRepository;
 }
 
+- (instancetype)init {
+    if (self = [super init]) {
+        _cachedValues = [OSWriteThroughCache new];
+        _receivedBuffers = [NSMutableDictionary new];
+    }
+    return self;
+}
+
 - (void)cacheNotificationInfluenceType:(OSInfluenceType) influenceType {
+    [_cachedValues setCachedValue:OS_INFLUENCE_TYPE_TO_STRING(influenceType) forKey:OSUD_CACHED_NOTIFICATION_INFLUENCE];
     [OneSignalUserDefaults.initShared saveStringForKey:OSUD_CACHED_NOTIFICATION_INFLUENCE withValue:OS_INFLUENCE_TYPE_TO_STRING(influenceType)];
 }
 
 - (OSInfluenceType)notificationCachedInfluenceType {
-    NSString *sessionString = [OneSignalUserDefaults.initShared getSavedStringForKey:OSUD_CACHED_NOTIFICATION_INFLUENCE defaultValue:OS_INFLUENCE_TYPE_TO_STRING(UNATTRIBUTED)];
+    NSString *sessionString = [_cachedValues cachedValueForKey:OSUD_CACHED_NOTIFICATION_INFLUENCE load:^id {
+        return [OneSignalUserDefaults.initShared getSavedStringForKey:OSUD_CACHED_NOTIFICATION_INFLUENCE defaultValue:OS_INFLUENCE_TYPE_TO_STRING(UNATTRIBUTED)];
+    }];
     return OS_INFLUENCE_TYPE_FROM_STRING(sessionString);
 }
 
 - (void)cacheIAMInfluenceType:(OSInfluenceType) influenceType {
+    [_cachedValues setCachedValue:OS_INFLUENCE_TYPE_TO_STRING(influenceType) forKey:OSUD_CACHED_IAM_INFLUENCE];
     [OneSignalUserDefaults.initShared saveStringForKey:OSUD_CACHED_IAM_INFLUENCE withValue:OS_INFLUENCE_TYPE_TO_STRING(influenceType)];
 }
 
 - (OSInfluenceType)iamCachedInfluenceType {
-    NSString *sessionString = [OneSignalUserDefaults.initShared getSavedStringForKey:OSUD_CACHED_IAM_INFLUENCE defaultValue:OS_INFLUENCE_TYPE_TO_STRING(UNATTRIBUTED)];
+    NSString *sessionString = [_cachedValues cachedValueForKey:OSUD_CACHED_IAM_INFLUENCE load:^id {
+        return [OneSignalUserDefaults.initShared getSavedStringForKey:OSUD_CACHED_IAM_INFLUENCE defaultValue:OS_INFLUENCE_TYPE_TO_STRING(UNATTRIBUTED)];
+    }];
     return OS_INFLUENCE_TYPE_FROM_STRING(sessionString);
 }
 
 - (void)cacheNotificationOpenId:(NSString *)notificationId {
+    [_cachedValues setCachedValue:notificationId forKey:OSUD_CACHED_DIRECT_NOTIFICATION_ID];
     [OneSignalUserDefaults.initShared saveStringForKey:OSUD_CACHED_DIRECT_NOTIFICATION_ID withValue:notificationId];
 }
 
 - (NSString *)cachedNotificationOpenId {
-    return [OneSignalUserDefaults.initShared getSavedStringForKey:OSUD_CACHED_DIRECT_NOTIFICATION_ID defaultValue:nil];
+    return [_cachedValues cachedValueForKey:OSUD_CACHED_DIRECT_NOTIFICATION_ID load:^id {
+        return [OneSignalUserDefaults.initShared getSavedStringForKey:OSUD_CACHED_DIRECT_NOTIFICATION_ID defaultValue:nil];
+    }];
 }
 
 - (void)cacheIndirectNotifications:(NSArray *)notifications {
+    [_cachedValues setCachedValue:[notifications copy] forKey:OSUD_CACHED_INDIRECT_NOTIFICATION_IDS];
     [OneSignalUserDefaults.initShared saveObjectForKey:OSUD_CACHED_INDIRECT_NOTIFICATION_IDS withValue:notifications];
 }
 
 - (NSArray * _Nullable)cachedIndirectNotifications {
-    return [OneSignalUserDefaults.initShared getSavedObjectForKey:OSUD_CACHED_INDIRECT_NOTIFICATION_IDS defaultValue:nil];
+    return [_cachedValues cachedValueForKey:OSUD_CACHED_INDIRECT_NOTIFICATION_IDS load:^id {
+        return [OneSignalUserDefaults.initShared getSavedObjectForKey:OSUD_CACHED_INDIRECT_NOTIFICATION_IDS defaultValue:nil];
+    }];
 }
 
+// Received notifications are also saved by the notification service extension, so these are not kept in memory here.
+// The decoded arrays are reused for as long as the stored data is unchanged.
 - (void)saveNotifications:(NSArray *)notifications {
     [OneSignalUserDefaults.initShared saveCodeableDataForKey:OSUD_CACHED_RECEIVED_NOTIFICATION_IDS withValue:notifications];
 }
 
 - (NSArray * _Nullable)lastNotificationsReceivedData {
-    return [OneSignalUserDefaults.initShared getSavedCodeableDataForKey:OSUD_CACHED_RECEIVED_NOTIFICATION_IDS defaultValue:nil];
+    return [OneSignalUserDefaults.initShared getCachedCodeableDataForKey:OSUD_CACHED_RECEIVED_NOTIFICATION_IDS defaultValue:nil];
+}
+
+/*
+ The notification service extension writes the received buffers, so they are only kept in memory
+ until OSSharedStateVersion reports the extension changed the app group.
+ */
+- (NSDictionary *)storedReceivedBufferForKey:(NSString *)key {
+    NSUInteger version = [OSSharedStateVersion currentVersion];
+    @synchronized (_receivedBuffers) {
+        if (version != _receivedBuffersVersion) {
+            [_receivedBuffers removeAllObjects];
+            _receivedBuffersVersion = version;
+        }
+        id dictionary = _receivedBuffers[key];
+        if (!dictionary) {
+            dictionary = [OneSignalUserDefaults.initShared getSavedDictionaryForKey:key defaultValue:nil] ?: [NSNull null];
+            _receivedBuffers[key] = dictionary;
+        }
+        return dictionary == [NSNull null] ? nil : dictionary;
+    }
+}
+
+- (void)saveReceivedBuffer:(OSInfluenceRingBuffer *)buffer forKey:(NSString *)key {
+    let dictionary = [buffer dictionaryValue];
+    @synchronized (_receivedBuffers) {
+        _receivedBuffers[key] = dictionary;
+    }
+    [OneSignalUserDefaults.initShared saveDictionaryForKey:key withValue:dictionary];
+}
+
+/*
+ The received ids are stored as a ring buffer plist so the notification service extension
+ doesn't archive the whole OSIndirectInfluence list on every notification.
+ The archived list is only read once to seed the buffer for installs upgrading from it.
+ */
+- (OSInfluenceRingBuffer *)receivedBufferForKey:(NSString *)key legacyKey:(NSString *)legacyKey capacity:(NSInteger)capacity {
+    NSDictionary *dictionary = [self storedReceivedBufferForKey:key];
+    if (dictionary)
+        return [[OSInfluenceRingBuffer alloc] initWithDictionary:dictionary capacity:capacity];
+
+    NSArray *legacyInfluences = [OneSignalUserDefaults.initShared getSavedCodeableDataForKey:legacyKey defaultValue:nil];
+    let buffer = [[OSInfluenceRingBuffer alloc] initWithIndirectInfluences:legacyInfluences capacity:capacity];
+    if (legacyInfluences) {
+        [self saveReceivedBuffer:buffer forKey:key];
+        [OneSignalUserDefaults.initShared removeValueForKey:legacyKey];
+    }
+    return buffer;
+}
+
+- (OSInfluenceRingBuffer *)notificationsReceivedBuffer {
+    return [self receivedBufferForKey:OSUD_CACHED_RECEIVED_NOTIFICATION_BUFFER legacyKey:OSUD_CACHED_RECEIVED_NOTIFICATION_IDS capacity:[self notificationLimit]];
+}
+
+- (void)saveNotificationsReceivedBuffer:(OSInfluenceRingBuffer *)buffer {
+    [self saveReceivedBuffer:buffer forKey:OSUD_CACHED_RECEIVED_NOTIFICATION_BUFFER];
+}
+
+- (OSInfluenceRingBuffer *)iamsReceivedBuffer {
+    return [self receivedBufferForKey:OSUD_CACHED_RECEIVED_IAM_BUFFER legacyKey:OSUD_CACHED_RECEIVED_IAM_IDS capacity:[self iamLimit]];
+}
+
+- (void)saveIAMsReceivedBuffer:(OSInfluenceRingBuffer *)buffer {
+    [self saveReceivedBuffer:buffer forKey:OSUD_CACHED_RECEIVED_IAM_BUFFER];
+}
+
+- (NSInteger)savedIntegerForKey:(NSString *)key defaultValue:(NSInteger)defaultValue {
+    NSNumber *value = [_cachedValues cachedValueForKey:key load:^id {
+        return @([OneSignalUserDefaults.initShared getSavedIntegerForKey:key defaultValue:defaultValue]);
+    }];
+    return [value integerValue];
 }
 
-- (void)saveIAMs:(NSArray *)iams {
-    [OneSignalUserDefaults.initShared saveCodeableDataForKey:OSUD_CACHED_RECEIVED_IAM_IDS withValue:iams];
+- (void)saveInteger:(NSInteger)value forKey:(NSString *)key {
+    [_cachedValues setCachedValue:@(value) forKey:key];
+    [OneSignalUserDefaults.initShared saveIntegerForKey:key withValue:value];
 }
 
-- (NSArray *)lastIAMsReceivedData {
-    return [OneSignalUserDefaults.initShared getSavedCodeableDataForKey:OSUD_CACHED_RECEIVED_IAM_IDS defaultValue:nil];
+- (BOOL)savedBoolForKey:(NSString *)key {
+    NSNumber *value = [_cachedValues cachedValueForKey:key load:^id {
+        return @([OneSignalUserDefaults.initShared getSavedBoolForKey:key defaultValue:NO]);
+    }];
+    return [value boolValue];
 }
 
 - (NSInteger)notificationLimit {
-    return [OneSignalUserDefaults.initShared getSavedIntegerForKey:OSUD_NOTIFICATION_LIMIT defaultValue:DEFAULT_INDIRECT_NOTIFICATION_LIMIT];
+    return [self savedIntegerForKey:OSUD_NOTIFICATION_LIMIT defaultValue:DEFAULT_INDIRECT_NOTIFICATION_LIMIT];
 }
 
 - (NSInteger)iamLimit {
-    return [OneSignalUserDefaults.initShared getSavedIntegerForKey:OSUD_IAM_LIMIT defaultValue:DEFAULT_INDIRECT_NOTIFICATION_LIMIT];
+    return [self savedIntegerForKey:OSUD_IAM_LIMIT defaultValue:DEFAULT_INDIRECT_NOTIFICATION_LIMIT];
 }
 
 - (NSInteger)notificationIndirectAttributionWindow {
-    return [OneSignalUserDefaults.initShared getSavedIntegerForKey:OSUD_NOTIFICATION_ATTRIBUTION_WINDOW defaultValue:DEFAULT_INDIRECT_ATTRIBUTION_WINDOW];
+    return [self savedIntegerForKey:OSUD_NOTIFICATION_ATTRIBUTION_WINDOW defaultValue:DEFAULT_INDIRECT_ATTRIBUTION_WINDOW];
 }
 
 - (NSInteger)iamIndirectAttributionWindow {
-    return [OneSignalUserDefaults.initShared getSavedIntegerForKey:OSUD_IAM_ATTRIBUTION_WINDOW defaultValue:DEFAULT_INDIRECT_ATTRIBUTION_WINDOW];
+    return [self savedIntegerForKey:OSUD_IAM_ATTRIBUTION_WINDOW defaultValue:DEFAULT_INDIRECT_ATTRIBUTION_WINDOW];
 }
 
 - (BOOL)isDirectInfluenceEnabled {
-    return [OneSignalUserDefaults.initShared getSavedBoolForKey:OSUD_DIRECT_SESSION_ENABLED defaultValue:NO];
+    return [self savedBoolForKey:OSUD_DIRECT_SESSION_ENABLED];
 }
 
 - (BOOL)isIndirectInfluenceEnabled {
-    return [OneSignalUserDefaults.initShared getSavedBoolForKey:OSUD_INDIRECT_SESSION_ENABLED defaultValue:NO];
+    return [self savedBoolForKey:OSUD_INDIRECT_SESSION_ENABLED];
 }
 
 - (BOOL)isUnattributedInfluenceEnabled {
-    return [OneSignalUserDefaults.initShared getSavedBoolForKey:OSUD_UNATTRIBUTED_SESSION_ENABLED defaultValue:NO];
+    return [self savedBoolForKey:OSUD_UNATTRIBUTED_SESSION_ENABLED];
 }
 
 /*
@@ -145,8 +250,8 @@ static OSInfluenceDataRepository *_influenceDataRepository;
                 int minutesLimitValue = minutesLimit ? [minutesLimit intValue] : DEFAULT_INDIRECT_ATTRIBUTION_WINDOW;
                 int notificationLimitValue = notificationLimit ? [notificationLimit intValue] : DEFAULT_INDIRECT_NOTIFICATION_LIMIT;
                 
-                [OneSignalUserDefaults.initShared saveIntegerForKey:OSUD_NOTIFICATION_LIMIT withValue:notificationLimitValue];
-                [OneSignalUserDefaults.initShared saveIntegerForKey:OSUD_NOTIFICATION_ATTRIBUTION_WINDOW withValue:minutesLimitValue];
+                [self saveInteger:notificationLimitValue forKey:OSUD_NOTIFICATION_LIMIT];
+                [self saveInteger:minutesLimitValue forKey:OSUD_NOTIFICATION_ATTRIBUTION_WINDOW];
             }
             
             NSDictionary *iamAttribution = [indirect objectForKey:IAM_ATTRIBUTION_PARAM];
@@ -157,8 +262,8 @@ static OSInfluenceDataRepository *_influenceDataRepository;
                 int minutesLimitValue = minutesLimit ? [minutesLimit intValue] : DEFAULT_INDIRECT_ATTRIBUTION_WINDOW;
                 int iamLimitValue = iamLimit ? [iamLimit intValue] : DEFAULT_INDIRECT_NOTIFICATION_LIMIT;
                 
-                [OneSignalUserDefaults.initShared saveIntegerForKey:OSUD_IAM_LIMIT withValue:iamLimitValue];
-                [OneSignalUserDefaults.initShared saveIntegerForKey:OSUD_IAM_ATTRIBUTION_WINDOW withValue:minutesLimitValue];
+                [self saveInteger:iamLimitValue forKey:OSUD_IAM_LIMIT];
+                [self saveInteger:minutesLimitValue forKey:OSUD_IAM_ATTRIBUTION_WINDOW];
             }
         }
     }
@@ -174,6 +279,7 @@ static OSInfluenceDataRepository *_influenceDataRepository;
     id enabledExists = [dictionary valueForKey:ENABLED_PARAM];
     BOOL enabled = enabledExists ? [enabledExists boolValue] : NO;
     
+    [_cachedValues setCachedValue:@(enabled) forKey:key];
     [OneSignalUserDefaults.initShared saveBoolForKey:key withValue:enabled];
 }
 
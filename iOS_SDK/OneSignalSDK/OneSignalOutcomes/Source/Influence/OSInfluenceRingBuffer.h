@@ -0,0 +1,59 @@
+/**
+Modified MIT License
+
+Copyright 2024 OneSignal
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+1. The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+2. All copies of substantial portions of the Software may only be used in connection
+with services provided by OneSignal.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#import <Foundation/Foundation.h>
+#import "OSIndirectInfluence.h"
+
+#ifndef OSInfluenceRingBuffer_h
+#define OSInfluenceRingBuffer_h
+
+/**
+ Fixed capacity, time ordered history of received influence ids.
+ Ids and timestamps are kept in two parallel arrays so the buffer persists as a small plist
+ dictionary instead of an archived object graph. Once full, a new id overwrites the oldest slot.
+ */
+@interface OSInfluenceRingBuffer : NSObject
+
+@property (nonatomic, readonly) NSInteger capacity;
+@property (nonatomic, readonly) NSInteger count;
+
+- (instancetype _Nonnull)initWithCapacity:(NSInteger)capacity;
+- (instancetype _Nonnull)initWithDictionary:(NSDictionary * _Nullable)dictionary capacity:(NSInteger)capacity;
+- (instancetype _Nonnull)initWithIndirectInfluences:(NSArray<OSIndirectInfluence *> * _Nullable)influences capacity:(NSInteger)capacity;
+
+- (void)addId:(NSString * _Nonnull)influenceId timestamp:(NSTimeInterval)timestamp;
+- (void)removeId:(NSString * _Nonnull)influenceId;
+
+// Ids received at or after the timestamp, oldest first
+- (NSArray<NSString *> * _Nonnull)idsReceivedSince:(NSTimeInterval)timestamp;
+- (NSArray<OSIndirectInfluence *> * _Nonnull)indirectInfluencesForChannel:(NSString * _Nonnull)channelIdTag;
+
+- (NSDictionary * _Nonnull)dictionaryValue;
+
+@end
+
+#endif /* OSInfluenceRingBuffer_h */
@@ -0,0 +1,158 @@
+/**
+Modified MIT License
+
+Copyright 2024 OneSignal
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+1. The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+2. All copies of substantial portions of the Software may only be used in connection
+with services provided by OneSignal.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#import <Foundation/Foundation.h>
+#import <OneSignalCore/OneSignalCore.h>
+#import "OSInfluenceRingBuffer.h"
+
+#define RING_BUFFER_HEAD_KEY @"head"
+#define RING_BUFFER_IDS_KEY @"ids"
+#define RING_BUFFER_TIMESTAMPS_KEY @"timestamps"
+
+@interface OSInfluenceRingBuffer ()
+
+// Physical slots, at most capacity long. Once full, head points at the oldest slot.
+@property (strong, nonatomic, nonnull) NSMutableArray<NSString *> *ids;
+@property (strong, nonatomic, nonnull) NSMutableArray<NSNumber *> *timestamps;
+@property (nonatomic) NSInteger head;
+
+@end
+
+@implementation OSInfluenceRingBuffer
+
+- (instancetype)initWithCapacity:(NSInteger)capacity {
+    self = [super init];
+    if (self) {
+        _capacity = MAX(capacity, 0);
+        _ids = [NSMutableArray new];
+        _timestamps = [NSMutableArray new];
+        _head = 0;
+    }
+    return self;
+}
+
+- (instancetype)initWithDictionary:(NSDictionary *)dictionary capacity:(NSInteger)capacity {
+    self = [self initWithCapacity:capacity];
+    if (self) {
+        NSArray *ids = dictionary[RING_BUFFER_IDS_KEY];
+        NSArray *timestamps = dictionary[RING_BUFFER_TIMESTAMPS_KEY];
+        NSInteger head = [dictionary[RING_BUFFER_HEAD_KEY] integerValue];
+        if (![ids isKindOfClass:[NSArray class]] || ![timestamps isKindOfClass:[NSArray class]] || ids.count != timestamps.count)
+            return self;
+
+        if (head < 0 || head >= ids.count)
+            head = 0;
+
+        // Replay oldest first so a changed channel limit keeps only the newest entries
+        for (NSInteger i = 0; i < ids.count; i++) {
+            NSInteger index = (head + i) % ids.count;
+            [self addId:ids[index] timestamp:[timestamps[index] doubleValue]];
+        }
+    }
+    return self;
+}
+
+- (instancetype)initWithIndirectInfluences:(NSArray<OSIndirectInfluence *> *)influences capacity:(NSInteger)capacity {
+    self = [self initWithCapacity:capacity];
+    if (self) {
+        for (OSIndirectInfluence *influence in influences)
+            [self addId:influence.influenceId timestamp:influence.timestamp];
+    }
+    return self;
+}
+
+- (NSInteger)count {
+    return _ids.count;
+}
+
+- (void)addId:(NSString *)influenceId timestamp:(NSTimeInterval)timestamp {
+    if (!influenceId || _capacity == 0)
+        return;
+
+    if (_ids.count < _capacity) {
+        [_ids addObject:influenceId];
+        [_timestamps addObject:@(timestamp)];
+        return;
+    }
+
+    _ids[_head] = influenceId;
+    _timestamps[_head] = @(timestamp);
+    _head = (_head + 1) % _capacity;
+}
+
+- (void)removeId:(NSString *)influenceId {
+    if (![_ids containsObject:influenceId])
+        return;
+
+    NSMutableArray *ids = [NSMutableArray new];
+    NSMutableArray *timestamps = [NSMutableArray new];
+    for (NSInteger i = 0; i < _ids.count; i++) {
+        NSInteger index = (_head + i) % _ids.count;
+        if ([_ids[index] isEqualToString:influenceId])
+            continue;
+        [ids addObject:_ids[index]];
+        [timestamps addObject:_timestamps[index]];
+    }
+    _ids = ids;
+    _timestamps = timestamps;
+    _head = 0;
+}
+
+- (NSArray<NSString *> *)idsReceivedSince:(NSTimeInterval)timestamp {
+    NSMutableArray *ids = [NSMutableArray new];
+    // Walk back from the newest slot and stop at the first id outside the window
+    for (NSInteger i = _ids.count - 1; i >= 0; i--) {
+        NSInteger index = (_head + i) % _ids.count;
+        if ([_timestamps[index] doubleValue] < timestamp)
+            break;
+        [ids insertObject:_ids[index] atIndex:0];
+    }
+    return ids;
+}
+
+- (NSArray<OSIndirectInfluence *> *)indirectInfluencesForChannel:(NSString *)channelIdTag {
+    NSMutableArray *influences = [NSMutableArray new];
+    for (NSInteger i = 0; i < _ids.count; i++) {
+        NSInteger index = (_head + i) % _ids.count;
+        [influences addObject:[[OSIndirectInfluence alloc] initWithParamsInfluenceId:_ids[index] forChannel:channelIdTag timestamp:[_timestamps[index] doubleValue]]];
+    }
+    return influences;
+}
+
+- (NSDictionary *)dictionaryValue {
+    return @{
+        RING_BUFFER_HEAD_KEY : @(_head),
+        RING_BUFFER_IDS_KEY : [_ids copy],
+        RING_BUFFER_TIMESTAMPS_KEY : [_timestamps copy]
+    };
+}
+
+- (NSString *)description {
+    return [NSString stringWithFormat:@"OSInfluenceRingBuffer capacity: %ld ids: %@", (long)_capacity, [self idsReceivedSince:0]];
+}
+
+@end
@@ -46,24 +46,20 @@ THE SOFTWARE.
     return NOTIFICATION;
 }
 
-- (NSArray * _Nullable)lastChannelObjectsReceivedByNewId:(NSString *)identifier {
-    return [self lastChannelObjects];
+- (OSInfluenceRingBuffer * _Nonnull)receivedBufferByNewId:(NSString *)identifier {
+    return [self receivedBuffer];
 }
 
-- (NSArray * _Nullable)lastChannelObjects {
-    return [self.dataRepository lastNotificationsReceivedData];
-}
-
-- (NSInteger)channelLimit {
-    return [self.dataRepository notificationLimit];
+- (OSInfluenceRingBuffer * _Nonnull)receivedBuffer {
+    return [self.dataRepository notificationsReceivedBuffer];
 }
 
 - (NSInteger)indirectAttributionWindow {
     return [self.dataRepository notificationIndirectAttributionWindow];
 }
 
-- (void)saveChannelObjects:(NSArray * _Nonnull)channelObjects {
-   [self.dataRepository saveNotifications:channelObjects];
+- (void)saveReceivedBuffer:(OSInfluenceRingBuffer * _Nonnull)buffer {
+    [self.dataRepository saveNotificationsReceivedBuffer:buffer];
 }
 
 - (void)initInfluencedTypeFromCache {
@@ -75,7 +71,7 @@ THE SOFTWARE.
     else if (influenceType == DIRECT)
         self.directId = [self.dataRepository cachedNotificationOpenId];
 
-    [OneSignalLog onesignalLog:ONE_S_LL_DEBUG message:[NSString stringWithFormat:@"NotificationTracker initInfluencedTypeFromCache: %@", [self description]]];
+    ONE_S_LOG(ONE_S_LL_DEBUG, @"NotificationTracker initInfluencedTypeFromCache: %@", [self description]);
 }
 
 - (void)cacheState {
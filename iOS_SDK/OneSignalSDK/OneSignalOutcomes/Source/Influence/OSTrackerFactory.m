@@ -56,6 +56,9 @@ static OSTrackerFactory *_trackerFactory;
 
 - (void)saveInfluenceParams:(NSDictionary *)params {
     [_dataRepository saveInfluenceParams:params];
+    // Enabled flags from the params change the influence each tracker reports
+    for (NSString* key in _trackers)
+        [_trackers[key] invalidateSessionInfluence];
 }
 
 - (void)initFromCache {
@@ -30,7 +30,7 @@ THE SOFTWARE.
 #ifndef OSOutcomeEventParams_h
 #define OSOutcomeEventParams_h
 
-@interface OSOutcomeEventParams : NSObject
+@interface OSOutcomeEventParams : NSObject <NSCoding>
 
 @property (strong, nonatomic, readwrite) NSString *outcomeId;
 @property (strong, nonatomic, readwrite) OSOutcomeSource *outcomeSource;
@@ -52,6 +52,23 @@ THE SOFTWARE.
     return params;
 }
 
+- (void)encodeWithCoder:(NSCoder *)encoder {
+    [encoder encodeObject:_outcomeId forKey:@"outcomeId"];
+    [encoder encodeObject:_outcomeSource forKey:@"outcomeSource"];
+    [encoder encodeObject:_weight forKey:@"weight"];
+    [encoder encodeObject:_timestamp forKey:@"timestamp"];
+}
+
+- (id)initWithCoder:(NSCoder *)decoder {
+    if (self = [super init]) {
+        _outcomeId = [decoder decodeObjectForKey:@"outcomeId"];
+        _outcomeSource = [decoder decodeObjectForKey:@"outcomeSource"];
+        _weight = [decoder decodeObjectForKey:@"weight"];
+        _timestamp = [decoder decodeObjectForKey:@"timestamp"];
+    }
+    return self;
+}
+
 - (NSString *)description {
     return [NSString stringWithFormat:@"OSOutcomeEventParams outcomeId: %@ weight: %@ timestamp: %@ outcomeSource: %@", _outcomeId, _weight, _timestamp, _outcomeSource != nil ? _outcomeSource.description : nil];
 }
@@ -30,7 +30,7 @@ THE SOFTWARE.
 #ifndef OSOutcomeSource_h
 #define OSOutcomeSource_h
 
-@interface OSOutcomeSource : NSObject
+@interface OSOutcomeSource : NSObject <NSCoding>
 
 @property (strong, nonatomic, readwrite) OSOutcomeSourceBody *directBody;
 @property (strong, nonatomic, readwrite) OSOutcomeSourceBody *indirectBody;
@@ -51,6 +51,19 @@ THE SOFTWARE.
     return params;
 }
 
+- (void)encodeWithCoder:(NSCoder *)encoder {
+    [encoder encodeObject:_directBody forKey:@"directBody"];
+    [encoder encodeObject:_indirectBody forKey:@"indirectBody"];
+}
+
+- (id)initWithCoder:(NSCoder *)decoder {
+    if (self = [super init]) {
+        _directBody = [decoder decodeObjectForKey:@"directBody"];
+        _indirectBody = [decoder decodeObjectForKey:@"indirectBody"];
+    }
+    return self;
+}
+
 - (NSString *)description {
     return [NSString stringWithFormat:@"OSOutcomeSource directBody: %@ indirectBody: %@", _directBody, _indirectBody];
 }
@@ -28,7 +28,7 @@ THE SOFTWARE.
 #ifndef OSOutcomeSourceBody_h
 #define OSOutcomeSourceBody_h
 
-@interface OSOutcomeSourceBody : NSObject
+@interface OSOutcomeSourceBody : NSObject <NSCoding>
 
 @property (strong, nonatomic, readwrite) NSArray *notificationIds;
 @property (strong, nonatomic, readwrite) NSArray *inAppMessagesIds;
@@ -51,6 +51,19 @@ THE SOFTWARE.
     return params;
 }
 
+- (void)encodeWithCoder:(NSCoder *)encoder {
+    [encoder encodeObject:_notificationIds forKey:@"notificationIds"];
+    [encoder encodeObject:_inAppMessagesIds forKey:@"inAppMessagesIds"];
+}
+
+- (id)initWithCoder:(NSCoder *)decoder {
+    if (self = [super init]) {
+        _notificationIds = [decoder decodeObjectForKey:@"notificationIds"];
+        _inAppMessagesIds = [decoder decodeObjectForKey:@"inAppMessagesIds"];
+    }
+    return self;
+}
+
 - (NSString *)description {
     return [NSString stringWithFormat:@"OSOutcomeSourceBody notificationIds: %@ inAppMessagesIds: %@", _notificationIds, _inAppMessagesIds];
 }
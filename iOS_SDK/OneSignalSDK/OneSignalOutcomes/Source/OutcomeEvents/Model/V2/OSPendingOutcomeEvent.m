@@ -0,0 +1,62 @@
+/**
+Modified MIT License
+
+Copyright 2024 OneSignal
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+1. The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+2. All copies of substantial portions of the Software may only be used in connection
+with services provided by OneSignal.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#import <Foundation/Foundation.h>
+#import "OSPendingOutcomeEvent.h"
+
+@implementation OSPendingOutcomeEvent
+
+- (id)initWithAppId:(NSString *)appId deviceType:(NSNumber *)deviceType eventParams:(OSOutcomeEventParams *)eventParams {
+    self = [super init];
+    if (self) {
+        _appId = appId;
+        _deviceType = deviceType;
+        _eventParams = eventParams;
+    }
+    return self;
+}
+
+- (void)encodeWithCoder:(NSCoder *)encoder {
+    [encoder encodeObject:_appId forKey:@"appId"];
+    [encoder encodeObject:_deviceType forKey:@"deviceType"];
+    [encoder encodeObject:_eventParams forKey:@"eventParams"];
+}
+
+- (id)initWithCoder:(NSCoder *)decoder {
+    if (self = [super init]) {
+        _appId = [decoder decodeObjectForKey:@"appId"];
+        _deviceType = [decoder decodeObjectForKey:@"deviceType"];
+        _eventParams = [decoder decodeObjectForKey:@"eventParams"];
+    }
+    return self;
+}
+
+- (NSString *)description {
+    return [NSString stringWithFormat:@"OSPendingOutcomeEvent appId: %@ deviceType: %@ eventParams: %@", _appId, _deviceType, _eventParams];
+}
+
+@end
@@ -28,6 +28,9 @@ THE SOFTWARE.
 #ifndef OSOutcomeEventsCache_h
 #define OSOutcomeEventsCache_h
 
+#import "OSPendingOutcomeEvent.h"
+#import "OSCachedUniqueOutcome.h"
+
 @interface OSOutcomeEventsCache : NSObject
 
 + (OSOutcomeEventsCache * _Nonnull)sharedOutcomeEventsCache;
@@ -40,6 +43,16 @@ THE SOFTWARE.
 
 - (NSArray * _Nullable)getAttributedUniqueOutcomeEventSent;
 - (void)saveAttributedUniqueOutcomeEventNotificationIds:(NSArray * _Nullable)attributedUniqueOutcomeEventNotificationIdsSent;
+// Constant time checks and additions of attributed unique outcomes, sent outcomes older than OS_UNIQUE_OUTCOMES_WINDOW expire on their own
+- (BOOL)containsAttributedUniqueOutcome:(OSCachedUniqueOutcome * _Nonnull)uniqueOutcome;
+- (void)addAttributedUniqueOutcomes:(NSArray<OSCachedUniqueOutcome *> * _Nonnull)uniqueOutcomes;
+- (void)removeExpiredAttributedUniqueOutcomes;
+
+- (NSArray<OSPendingOutcomeEvent *> * _Nullable)getPendingOutcomeEvents;
+- (void)savePendingOutcomeEvents:(NSArray<OSPendingOutcomeEvent *> * _Nullable)pendingOutcomeEvents;
+
+- (NSArray<OSPendingOutcomeEvent *> * _Nullable)getFailedOutcomeEvents;
+- (void)saveFailedOutcomeEvents:(NSArray<OSPendingOutcomeEvent *> * _Nullable)failedOutcomeEvents;
 
 @end
 
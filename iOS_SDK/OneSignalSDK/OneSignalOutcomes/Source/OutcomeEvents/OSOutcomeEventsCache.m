@@ -27,8 +27,17 @@ THE SOFTWARE.
 
 #import <Foundation/Foundation.h>
 #import "OSOutcomeEventsCache.h"
+#import "OSWriteThroughCache.h"
 #import <OneSignalCore/OneSignalCore.h>
 
+@interface OSOutcomeEventsCache ()
+// Values written through to NSUserDefaults, read on every outcome send
+@property (strong, nonatomic, nonnull) OSWriteThroughCache *cachedValues;
+// Attributed unique outcomes sent, loaded on first use. Equality ignores the timestamp, so lookups are by name, id and channel. Synchronized on self.
+@property (strong, nonatomic, nullable) NSMutableSet<OSCachedUniqueOutcome *> *attributedUniqueOutcomes;
+@property (nonatomic) NSTimeInterval nextAttributedUniqueOutcomesPrune;
+@end
+
 @implementation OSOutcomeEventsCache
 
 static OSOutcomeEventsCache *_sharedOutcomeEventsCache;
@@ -37,34 +46,143 @@ static OSOutcomeEventsCache *_sharedOutcomeEventsCache;
         _sharedOutcomeEventsCache = [OSOutcomeEventsCache new];
     return _sharedOutcomeEventsCache;
 }
+
+- (instancetype)init {
+    if (self = [super init]) {
+        _cachedValues = [OSWriteThroughCache new];
+    }
+    return self;
+}
+
 // Get current outcome service enabled. If V2 enabled return true otherwise false
 - (BOOL)isOutcomesV2ServiceEnabled {
-    return [OneSignalUserDefaults.initShared getSavedBoolForKey:OSUD_OUTCOMES_V2 defaultValue:NO];
+    NSNumber *enabled = [_cachedValues cachedValueForKey:OSUD_OUTCOMES_V2 load:^id {
+        return @([OneSignalUserDefaults.initShared getSavedBoolForKey:OSUD_OUTCOMES_V2 defaultValue:NO]);
+    }];
+    return [enabled boolValue];
 }
 
 // Save iOS param value for outcomes_v2_service_enabled
 - (void)saveOutcomesV2ServiceEnabled:(BOOL)isEnabled {
+    [_cachedValues setCachedValue:@(isEnabled) forKey:OSUD_OUTCOMES_V2];
     [OneSignalUserDefaults.initShared saveBoolForKey:OSUD_OUTCOMES_V2 withValue:isEnabled];
 }
 
 // Save the current set of UNATTRIBUTED unique outcome names to NSUserDefaults
 - (NSSet *)getUnattributedUniqueOutcomeEventsSent {
-    return [OneSignalUserDefaults.initShared getSavedSetForKey:OSUD_CACHED_UNATTRIBUTED_UNIQUE_OUTCOME_EVENTS_SENT defaultValue:nil];
+    return [_cachedValues cachedValueForKey:OSUD_CACHED_UNATTRIBUTED_UNIQUE_OUTCOME_EVENTS_SENT load:^id {
+        return [OneSignalUserDefaults.initShared getSavedSetForKey:OSUD_CACHED_UNATTRIBUTED_UNIQUE_OUTCOME_EVENTS_SENT defaultValue:nil];
+    }];
 }
 
 // Save the current set of UNATTRIBUTED unique outcome names to NSUserDefaults
 - (void)saveUnattributedUniqueOutcomeEventsSent:(NSSet *)unattributedUniqueOutcomeEventsSentSet {
+    [_cachedValues setCachedValue:[unattributedUniqueOutcomeEventsSentSet copy] forKey:OSUD_CACHED_UNATTRIBUTED_UNIQUE_OUTCOME_EVENTS_SENT];
     [OneSignalUserDefaults.initShared saveSetForKey:OSUD_CACHED_UNATTRIBUTED_UNIQUE_OUTCOME_EVENTS_SENT withValue:unattributedUniqueOutcomeEventsSentSet];
 }
 
 // Keeps track of unique outcome events sent for ATTRIBUTED sessions on a per notification level
 - (NSArray *)getAttributedUniqueOutcomeEventSent {
-    return [OneSignalUserDefaults.initShared getSavedCodeableDataForKey:OSUD_CACHED_ATTRIBUTED_UNIQUE_OUTCOME_EVENT_NOTIFICATION_IDS_SENT defaultValue:nil];
+    @synchronized (self) {
+        if (_attributedUniqueOutcomes)
+            return _attributedUniqueOutcomes.allObjects;
+    }
+    return [OneSignalUserDefaults.initShared getCachedCodeableDataForKey:OSUD_CACHED_ATTRIBUTED_UNIQUE_OUTCOME_EVENT_NOTIFICATION_IDS_SENT defaultValue:nil];
 }
 
 // Save the current set of ATTRIBUTED unique outcome names and notificationIds to NSUserDefaults
 - (void)saveAttributedUniqueOutcomeEventNotificationIds:(NSArray *)attributedUniqueOutcomeEventNotificationIdsSent {
+    @synchronized (self) {
+        _attributedUniqueOutcomes = [NSMutableSet setWithArray:attributedUniqueOutcomeEventNotificationIdsSent ?: @[]];
+    }
     [OneSignalUserDefaults.initShared saveCodeableDataForKey:OSUD_CACHED_ATTRIBUTED_UNIQUE_OUTCOME_EVENT_NOTIFICATION_IDS_SENT withValue:attributedUniqueOutcomeEventNotificationIdsSent];
 }
 
+- (BOOL)containsAttributedUniqueOutcome:(OSCachedUniqueOutcome *)uniqueOutcome {
+    @synchronized (self) {
+        [self loadAttributedUniqueOutcomes];
+        if ([self pruneAttributedUniqueOutcomes:NO])
+            [self persistAttributedUniqueOutcomes];
+        return [_attributedUniqueOutcomes containsObject:uniqueOutcome];
+    }
+}
+
+- (void)addAttributedUniqueOutcomes:(NSArray<OSCachedUniqueOutcome *> *)uniqueOutcomes {
+    if (uniqueOutcomes.count == 0)
+        return;
+    @synchronized (self) {
+        [self loadAttributedUniqueOutcomes];
+        [self pruneAttributedUniqueOutcomes:NO];
+        [_attributedUniqueOutcomes addObjectsFromArray:uniqueOutcomes];
+        if (_attributedUniqueOutcomes.count > OS_UNIQUE_OUTCOMES_LIMIT) {
+            // Only reached by apps sending far more unique outcomes than the window is meant for, so sorting is fine here
+            let byAge = [_attributedUniqueOutcomes.allObjects sortedArrayUsingComparator:^NSComparisonResult(OSCachedUniqueOutcome *a, OSCachedUniqueOutcome *b) {
+                return [a.timestamp compare:b.timestamp];
+            }];
+            let excess = _attributedUniqueOutcomes.count - OS_UNIQUE_OUTCOMES_LIMIT;
+            for (NSUInteger i = 0; i < excess; i++)
+                [_attributedUniqueOutcomes removeObject:byAge[i]];
+        }
+        [self persistAttributedUniqueOutcomes];
+    }
+}
+
+- (void)removeExpiredAttributedUniqueOutcomes {
+    @synchronized (self) {
+        [self loadAttributedUniqueOutcomes];
+        if ([self pruneAttributedUniqueOutcomes:YES])
+            [self persistAttributedUniqueOutcomes];
+    }
+}
+
+// Must be synchronized on self
+- (void)loadAttributedUniqueOutcomes {
+    if (_attributedUniqueOutcomes)
+        return;
+    NSArray *saved = [OneSignalUserDefaults.initShared getCachedCodeableDataForKey:OSUD_CACHED_ATTRIBUTED_UNIQUE_OUTCOME_EVENT_NOTIFICATION_IDS_SENT defaultValue:nil];
+    _attributedUniqueOutcomes = [NSMutableSet setWithArray:[saved isKindOfClass:[NSArray class]] ? saved : @[]];
+}
+
+/*
+ Removes outcomes sent longer ago than the window. Unless forced this only scans once per prune interval,
+ an outcome may outlive the window by up to that interval. Must be synchronized on self.
+ Returns whether anything was removed.
+ */
+- (BOOL)pruneAttributedUniqueOutcomes:(BOOL)force {
+    let now = [[NSDate date] timeIntervalSince1970];
+    if (!force && now < _nextAttributedUniqueOutcomesPrune)
+        return NO;
+    _nextAttributedUniqueOutcomesPrune = now + OS_UNIQUE_OUTCOMES_PRUNE_INTERVAL;
+    let expired = [_attributedUniqueOutcomes objectsPassingTest:^BOOL(OSCachedUniqueOutcome *uniqueOutcome, BOOL *stop) {
+        return now - [uniqueOutcome.timestamp doubleValue] > OS_UNIQUE_OUTCOMES_WINDOW;
+    }];
+    if (expired.count == 0)
+        return NO;
+    [_attributedUniqueOutcomes minusSet:expired];
+    return YES;
+}
+
+// Must be synchronized on self
+- (void)persistAttributedUniqueOutcomes {
+    [OneSignalUserDefaults.initShared saveCodeableDataForKey:OSUD_CACHED_ATTRIBUTED_UNIQUE_OUTCOME_EVENT_NOTIFICATION_IDS_SENT withValue:_attributedUniqueOutcomes.allObjects];
+}
+
+// Outcome events buffered to be sent together, kept so they survive the app being terminated
+- (NSArray<OSPendingOutcomeEvent *> *)getPendingOutcomeEvents {
+    return [OneSignalUserDefaults.initShared getSavedCodeableDataForKey:OSUD_PENDING_OUTCOME_EVENTS defaultValue:nil];
+}
+
+- (void)savePendingOutcomeEvents:(NSArray<OSPendingOutcomeEvent *> *)pendingOutcomeEvents {
+    [OneSignalUserDefaults.initShared saveCodeableDataForKey:OSUD_PENDING_OUTCOME_EVENTS withValue:pendingOutcomeEvents];
+}
+
+// Outcome events that failed to send and are waiting for the network to come back or the next session
+- (NSArray<OSPendingOutcomeEvent *> *)getFailedOutcomeEvents {
+    return [OneSignalUserDefaults.initShared getSavedCodeableDataForKey:OSUD_FAILED_OUTCOME_EVENTS defaultValue:nil];
+}
+
+- (void)saveFailedOutcomeEvents:(NSArray<OSPendingOutcomeEvent *> *)failedOutcomeEvents {
+    [OneSignalUserDefaults.initShared saveCodeableDataForKey:OSUD_FAILED_OUTCOME_EVENTS withValue:failedOutcomeEvents];
+}
+
 @end
@@ -50,6 +50,12 @@ THE SOFTWARE.
 - (NSArray * _Nonnull)getNotCachedUniqueInfluencesForOutcome:(NSString * _Nonnull)name influences:(NSArray<OSInfluence *> * _Nonnull)influences;
 - (void)saveUniqueOutcomeEventParams:(OSOutcomeEventParams * _Nonnull)eventParams;
 
+- (NSArray<OSPendingOutcomeEvent *> * _Nullable)getPendingOutcomeEvents;
+- (void)savePendingOutcomeEvents:(NSArray<OSPendingOutcomeEvent *> * _Nullable)pendingOutcomeEvents;
+
+- (NSArray<OSPendingOutcomeEvent *> * _Nullable)getFailedOutcomeEvents;
+- (void)saveFailedOutcomeEvents:(NSArray<OSPendingOutcomeEvent *> * _Nullable)failedOutcomeEvents;
+
 @end
 
 #endif /* OSOutcomeEventsRepository_h */
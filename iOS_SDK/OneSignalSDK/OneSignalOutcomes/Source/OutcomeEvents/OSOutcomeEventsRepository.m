@@ -53,7 +53,6 @@ THE SOFTWARE.
     3. If the array has notifications send the request for only these ids
 */
 - (NSArray *)getNotCachedUniqueInfluencesForOutcome:(NSString *)name influences:(NSArray *)influences {
-    NSArray * attributedUniqueOutcomeEventSent = [self getAttributedUniqueOutcomeEventSent];
     NSMutableArray *uniqueInfluences = [NSMutableArray new];
     for (OSInfluence *influence in influences) {
         NSMutableArray *availableInfluenceIds = [NSMutableArray new];
@@ -65,21 +64,8 @@ THE SOFTWARE.
         for (NSString *indentifier in influenceIds) {
             OSCachedUniqueOutcome *uniqueOutcome = [[OSCachedUniqueOutcome new] initWithParamsName:name uniqueId:indentifier channel:influence.influenceChannel];
             
-            if (attributedUniqueOutcomeEventSent == nil || attributedUniqueOutcomeEventSent.count == 0) {
-                [availableInfluenceIds addObject:uniqueOutcome.uniqueId];
-                continue;
-            }
-            
-            BOOL found = NO;
-            for (OSCachedUniqueOutcome *uniqueOutcomeSent in attributedUniqueOutcomeEventSent) {
-                if ([uniqueOutcome isEqual:uniqueOutcomeSent]) {
-                    found = YES;
-                    break;
-                }
-            }
-            
             // If the outcome hasn't been sent with this influence, then it should be included in the returned NSArray
-            if (!found)
+            if (![_outcomeEventsCache containsAttributedUniqueOutcome:uniqueOutcome])
                 [availableInfluenceIds addObject:uniqueOutcome.uniqueId];
         }
         
@@ -126,7 +112,7 @@ THE SOFTWARE.
 }
 
 - (void)saveUniqueOutcomeEventParams:(OSOutcomeEventParams *)eventParams {
-    [OneSignalLog onesignalLog:ONE_S_LL_DEBUG message:[NSString stringWithFormat:@"OSOutcomeEventsRepository saveUniqueOutcomeEventParams: %@", eventParams.description]];
+    ONE_S_LOG(ONE_S_LL_DEBUG, @"OSOutcomeEventsRepository saveUniqueOutcomeEventParams: %@", eventParams.description);
     if (eventParams.outcomeSource == nil)
         return;
     
@@ -138,11 +124,7 @@ THE SOFTWARE.
     NSArray<OSCachedUniqueOutcome *> *indirectIds = [self getCachedUniqueOutcomesFromSourceBody:indirectBody outcomeName:outcomeName];
 
     NSArray<OSCachedUniqueOutcome *> *newAttributedIds = [directIds arrayByAddingObjectsFromArray:indirectIds];
-    NSArray<OSCachedUniqueOutcome *> *attributedUniqueOutcomeEventSent = [self getAttributedUniqueOutcomeEventSent];
-    
-    NSArray *finalAttributedUniqueOutcomeEventSent = [attributedUniqueOutcomeEventSent arrayByAddingObjectsFromArray:newAttributedIds];
-    
-    [self saveAttributedUniqueOutcomeEventNotificationIds:finalAttributedUniqueOutcomeEventSent];
+    [_outcomeEventsCache addAttributedUniqueOutcomes:newAttributedIds];
 }
 
 - (NSSet *)getUnattributedUniqueOutcomeEventsSent {
@@ -153,6 +135,22 @@ THE SOFTWARE.
     [_outcomeEventsCache saveUnattributedUniqueOutcomeEventsSent:unattributedUniqueOutcomeEventsSentSet];
 }
 
+- (NSArray<OSPendingOutcomeEvent *> *)getPendingOutcomeEvents {
+    return [_outcomeEventsCache getPendingOutcomeEvents];
+}
+
+- (void)savePendingOutcomeEvents:(NSArray<OSPendingOutcomeEvent *> *)pendingOutcomeEvents {
+    [_outcomeEventsCache savePendingOutcomeEvents:pendingOutcomeEvents];
+}
+
+- (NSArray<OSPendingOutcomeEvent *> *)getFailedOutcomeEvents {
+    return [_outcomeEventsCache getFailedOutcomeEvents];
+}
+
+- (void)saveFailedOutcomeEvents:(NSArray<OSPendingOutcomeEvent *> *)failedOutcomeEvents {
+    [_outcomeEventsCache saveFailedOutcomeEvents:failedOutcomeEvents];
+}
+
 - (NSArray *)getAttributedUniqueOutcomeEventSent {
     return [_outcomeEventsCache getAttributedUniqueOutcomeEventSent];
 }
@@ -55,6 +55,8 @@ NSString * const NOTIFICATION_IDS = @"notification_ids";
 
     request.parameters = params;
     request.method = POST;
+    request.priority = OSRequestPriorityLow;
+    request.deferrable = true;
     request.path = @"outcomes/measure";
 
     return request;
@@ -79,6 +81,8 @@ NSString * const NOTIFICATION_IDS = @"notification_ids";
 
     request.parameters = params;
     request.method = POST;
+    request.priority = OSRequestPriorityLow;
+    request.deferrable = true;
     request.path = @"outcomes/measure";
 
     return request;
@@ -100,6 +104,8 @@ NSString * const NOTIFICATION_IDS = @"notification_ids";
 
     request.parameters = params;
     request.method = POST;
+    request.priority = OSRequestPriorityLow;
+    request.deferrable = true;
     request.path = @"outcomes/measure";
 
     return request;
@@ -120,6 +126,8 @@ NSString * const OUTCOME_SOURCE = @"source";
     
     request.parameters = params;
     request.method = POST;
+    request.priority = OSRequestPriorityLow;
+    request.deferrable = true;
     request.path = @"outcomes/measure_sources";
 
     return request;
@@ -154,6 +162,9 @@ NSString * const OUTCOME_SOURCE = @"source";
 
     request.parameters = params;
     request.method = POST;
+    request.priority = OSRequestPriorityLow;
+    request.deferrable = true;
+    request.deferralKey = OS_SESSION_END_DEFERRAL_KEY;
     request.path = @"outcomes/measure";
     
     return request;
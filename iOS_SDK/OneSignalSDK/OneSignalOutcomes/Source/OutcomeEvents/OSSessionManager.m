@@ -99,19 +99,21 @@ static NSTimeInterval lastOpenedTime;
 
 - (void)initSessionFromCache {
     [OneSignalLog onesignalLog:ONE_S_LL_DEBUG message:@"OneSignal SessionManager initSessionFromCache"];
+    [self savePendingReceivedNotifications];
     [_trackerFactory initFromCache];
-    [OneSignalLog onesignalLog:ONE_S_LL_DEBUG message:[NSString stringWithFormat:@"SessionManager restored from cache with influences: %@", [self getInfluences].description]];
+    ONE_S_LOG(ONE_S_LL_DEBUG, @"SessionManager restored from cache with influences: %@", [self getInfluences].description);
 }
 
 - (void)restartSessionIfNeeded {
+    [self savePendingReceivedNotifications];
     NSArray<OSChannelTracker *> *channelTrackers = [_trackerFactory channelsToResetByEntryAction:_appEntryState];
     NSMutableArray<OSInfluence *> *updatedInfluences = [NSMutableArray new];
     
-    [OneSignalLog onesignalLog:ONE_S_LL_DEBUG message:[NSString stringWithFormat:@"OneSignal SessionManager restartSessionIfNeeded with entryAction:: %u channelTrackers: %@", _appEntryState, channelTrackers.description]];
+    ONE_S_LOG(ONE_S_LL_DEBUG, @"OneSignal SessionManager restartSessionIfNeeded with entryAction:: %u channelTrackers: %@", _appEntryState, channelTrackers.description);
 
     for (OSChannelTracker *channelTracker in channelTrackers) {
         NSArray *lastIds = [channelTracker lastReceivedIds];
-        [OneSignalLog onesignalLog:ONE_S_LL_DEBUG message:[NSString stringWithFormat:@"OneSignal SessionManager restartSessionIfNeeded lastIds: %@", lastIds]];
+        ONE_S_LOG(ONE_S_LL_DEBUG, @"OneSignal SessionManager restartSessionIfNeeded lastIds: %@", lastIds);
 
         OSInfluence *influence = [channelTracker currentSessionInfluence];
         BOOL updated;
@@ -130,14 +132,14 @@ static NSTimeInterval lastOpenedTime;
 }
 
 - (void)onInAppMessageReceived:(NSString *)messageId {
-    [OneSignalLog onesignalLog:ONE_S_LL_DEBUG message:[NSString stringWithFormat:@"OneSignal SessionManager onInAppMessageReceived messageId: %@", messageId]];
+    ONE_S_LOG(ONE_S_LL_DEBUG, @"OneSignal SessionManager onInAppMessageReceived messageId: %@", messageId);
     
     OSChannelTracker *inAppMessageTracker = [_trackerFactory iamChannelTracker];
     [inAppMessageTracker saveLastId:messageId];
 }
 
 - (void)onDirectInfluenceFromIAMClick:(NSString *)directIAMId {
-    [OneSignalLog onesignalLog:ONE_S_LL_DEBUG message:[NSString stringWithFormat:@"OneSignal SessionManager onDirectInfluenceFromIAMClick messageId: %@", directIAMId]];
+    ONE_S_LOG(ONE_S_LL_DEBUG, @"OneSignal SessionManager onDirectInfluenceFromIAMClick messageId: %@", directIAMId);
     
     OSChannelTracker *inAppMessageTracker = [_trackerFactory iamChannelTracker];
     // We don't care about ending the session duration because IAM doesn't influence a session
@@ -152,7 +154,7 @@ static NSTimeInterval lastOpenedTime;
 }
 
 - (void)onNotificationReceived:(NSString *)notificationId {
-    [OneSignalLog onesignalLog:ONE_S_LL_DEBUG message:[NSString stringWithFormat:@"OneSignal SessionManager onNotificationReceived notificationId: %@", notificationId]];
+    ONE_S_LOG(ONE_S_LL_DEBUG, @"OneSignal SessionManager onNotificationReceived notificationId: %@", notificationId);
 
     if (!notificationId || notificationId.length == 0)
         return;
@@ -161,9 +163,25 @@ static NSTimeInterval lastOpenedTime;
     [notificationTracker saveLastId:notificationId];
 }
 
+/*
+ The NSE only records the notifications it receives, so it does not have to load the session machinery.
+ They are added to the notification tracker, with the time they were received, the next time the app uses it.
+ */
+- (void)savePendingReceivedNotifications {
+    NSArray<NSDictionary *> *pending = [OSPendingReceivedNotifications takeAll];
+    if (pending.count == 0)
+        return;
+    
+    ONE_S_LOG(ONE_S_LL_DEBUG, @"OneSignal SessionManager saving %lu notifications received by the NSE", (unsigned long)pending.count);
+    
+    OSChannelTracker *notificationTracker = [_trackerFactory notificationChannelTracker];
+    for (NSDictionary *received in pending)
+        [notificationTracker saveLastId:received[@"id"] timestamp:[received[@"timestamp"] doubleValue]];
+}
+
 - (void)onDirectInfluenceFromNotificationOpen:(AppEntryAction)entryAction withNotificationId:(NSString *)directNotificationId {
     _appEntryState = entryAction;
-    [OneSignalLog onesignalLog:ONE_S_LL_DEBUG message:[NSString stringWithFormat:@"OneSignal SessionManager onDirectInfluenceFromNotificationOpen notificationId: %@", directNotificationId]];
+    ONE_S_LOG(ONE_S_LL_DEBUG, @"OneSignal SessionManager onDirectInfluenceFromNotificationOpen notificationId: %@", directNotificationId);
 
     if (!directNotificationId || directNotificationId.length == 0)
         return;
@@ -184,7 +202,7 @@ static NSTimeInterval lastOpenedTime;
 }
 
 - (void)attemptSessionUpgradeWithDirectId:(NSString *)directId {
-    [OneSignalLog onesignalLog:ONE_S_LL_DEBUG message:[NSString stringWithFormat:@"OneSignal SessionManager attemptSessionUpgrade with entryAction: %u", _appEntryState]];
+    ONE_S_LOG(ONE_S_LL_DEBUG, @"OneSignal SessionManager attemptSessionUpgrade with entryAction: %u", _appEntryState);
     
     OSChannelTracker *channelTrackerByAction = [_trackerFactory channelByEntryAction:_appEntryState];
     NSArray<OSChannelTracker *> *channelTrackersToReset = [_trackerFactory channelsToResetByEntryAction:_appEntryState];
@@ -199,7 +217,7 @@ static NSTimeInterval lastOpenedTime;
     }
     
     if (updated) {
-        [OneSignalLog onesignalLog:ONE_S_LL_DEBUG message:[NSString stringWithFormat:@"OneSignal SessionManager attemptSessionUpgrade channel updated, search for ending direct influences on channels: %@", channelTrackersToReset]];
+        ONE_S_LOG(ONE_S_LL_DEBUG, @"OneSignal SessionManager attemptSessionUpgrade channel updated, search for ending direct influences on channels: %@", channelTrackersToReset);
         [influencesToEnd addObject:lastInfluence];
        
         // Only one session influence channel can be DIRECT at the same time
@@ -231,7 +249,7 @@ static NSTimeInterval lastOpenedTime;
         }
     }
     
-    [OneSignalLog onesignalLog:ONE_S_LL_DEBUG message:[NSString stringWithFormat:@"Trackers after update attempt: %@", [_trackerFactory channels].description]];
+    ONE_S_LOG(ONE_S_LL_DEBUG, @"Trackers after update attempt: %@", [_trackerFactory channels].description);
     [self sendSessionEndingWithInfluences:influencesToEnd];
 }
 
@@ -257,7 +275,7 @@ static NSTimeInterval lastOpenedTime;
     channelTracker.indirectIds = indirectIds;
     [channelTracker cacheState];
     
-    [OneSignalLog onesignalLog:ONE_S_LL_DEBUG message:[NSString stringWithFormat:@"Trackers changed to: %@", [_trackerFactory channels].description]];
+    ONE_S_LOG(ONE_S_LL_DEBUG, @"Trackers changed to: %@", [_trackerFactory channels].description);
     
     return YES;
 }
@@ -291,7 +309,7 @@ static NSTimeInterval lastOpenedTime;
 }
 
 - (void)sendSessionEndingWithInfluences:(NSArray<OSInfluence *> *)endingInfluences {
-    [OneSignalLog onesignalLog:ONE_S_LL_DEBUG message:[NSString stringWithFormat:@"OneSignal SessionManager sendSessionEndingWithInfluences with influences: %@", endingInfluences.description]];
+    ONE_S_LOG(ONE_S_LL_DEBUG, @"OneSignal SessionManager sendSessionEndingWithInfluences with influences: %@", endingInfluences.description);
     // Only end session if there are influences available to end
     if (endingInfluences.count > 0 && _delegate && [_delegate respondsToSelector:@selector(onSessionEnding:)])
         [_delegate onSessionEnding:endingInfluences];
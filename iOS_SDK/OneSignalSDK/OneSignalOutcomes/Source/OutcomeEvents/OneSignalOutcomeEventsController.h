@@ -44,6 +44,9 @@
 - (void)addUniqueOutcome:(NSString * _Nonnull)name;
 - (void)addOutcomeWithValue:(NSString * _Nonnull)name value:(NSNumber * _Nonnull)value;
 
+- (void)flushPendingOutcomeEvents;
+- (void)retryFailedOutcomeEvents;
+
 - (void)sendClickActionOutcomes:(NSArray<OSInAppMessageOutcome *> *_Nonnull)outcomes
                           appId:(NSString * _Nonnull)appId
                      deviceType:(NSNumber * _Nonnull)deviceType;
@@ -53,7 +56,9 @@
             pushSubscriptionId:(NSString * _Nonnull)pushSubscriptionId
                    onesignalId:(NSString * _Nonnull)onesignalId
                influenceParams:(NSArray<OSFocusInfluenceParam *> * _Nonnull)influenceParams
+                 deferralDelay:(NSTimeInterval)deferralDelay
                      onSuccess:(OSResultSuccessBlock _Nonnull)successBlock
                      onFailure:(OSFailureBlock _Nonnull)failureBlock;
+- (void)cancelDeferredSessionEndOutcomes;
 
 @end
@@ -40,6 +40,11 @@
 
 @property (strong, nonatomic, readonly, nonnull) OSSessionManager *sessionManager;
 @property (strong, nonatomic, readonly, nonnull) OSOutcomeEventsFactory *outcomeEventsFactory;
+// Outcome events waiting to be sent together. Access to both is synchronized on `pendingOutcomeEvents`.
+@property (strong, nonatomic, nonnull) NSMutableArray<OSPendingOutcomeEvent *> *pendingOutcomeEvents;
+@property (nonatomic) BOOL flushScheduled;
+// Outcome events that failed to send, retried on the next reachability change or session. Synchronized on `pendingOutcomeEvents`.
+@property (strong, nonatomic, nonnull) NSMutableArray<OSPendingOutcomeEvent *> *failedOutcomeEvents;
 
 @end
 
@@ -54,10 +59,28 @@ NSMutableSet *unattributedUniqueOutcomeEventsSentSet;
         _sessionManager = sessionManager;
         _outcomeEventsFactory = outcomeEventsFactory;
         [self initUniqueOutcomeEventsFromCache];
+        [self initPendingOutcomeEventsFromCache];
+        [[NSNotificationCenter defaultCenter] addObserver:self
+                                                 selector:@selector(retryFailedOutcomeEvents)
+                                                     name:OS_REACHABILITY_CHANGED_NOTIFICATION
+                                                   object:nil];
     }
     return self;
 }
 
+- (void)dealloc {
+    [[NSNotificationCenter defaultCenter] removeObserver:self];
+}
+
+- (void)initPendingOutcomeEventsFromCache {
+    _pendingOutcomeEvents = [NSMutableArray arrayWithArray:[_outcomeEventsFactory.repository getPendingOutcomeEvents] ?: @[]];
+    _failedOutcomeEvents = [NSMutableArray arrayWithArray:[_outcomeEventsFactory.repository getFailedOutcomeEvents] ?: @[]];
+    // Events left over from a previous launch go out with the next flush
+    if (_pendingOutcomeEvents.count > 0) {
+        [self schedulePendingOutcomeEventsFlush];
+    }
+}
+
 - (void)initUniqueOutcomeEventsFromCache {
     NSSet *tempUnattributedUniqueOutcomeEventsSentSet = [_outcomeEventsFactory.repository getUnattributedUniqueOutcomeEventsSent];
     if (tempUnattributedUniqueOutcomeEventsSentSet)
@@ -71,22 +94,11 @@ NSMutableSet *unattributedUniqueOutcomeEventsSentSet;
 }
 
 /*
- Iterate through all stored cached OSUniqueOutcomeNotification and clean any items over 7 days old
+ Clean any stored cached OSUniqueOutcomeNotification over 7 days old
+ Checks and additions also expire them on their own, this prunes right away
  */
 - (void)cleanUniqueOutcomeNotifications {
-    NSArray *uniqueOutcomeNotifications = [OneSignalUserDefaults.initShared getSavedCodeableDataForKey:OSUD_CACHED_ATTRIBUTED_UNIQUE_OUTCOME_EVENT_NOTIFICATION_IDS_SENT defaultValue:nil];
-    
-    NSTimeInterval timeInSeconds = [[NSDate date] timeIntervalSince1970];
-    NSMutableArray *finalNotifications = [NSMutableArray new];
-    for (OSCachedUniqueOutcome *notif in uniqueOutcomeNotifications) {
-        
-        // Save notif if it has been stored for less than or equal to a week
-        NSTimeInterval diff = timeInSeconds - [notif.timestamp doubleValue];
-        if (diff <= WEEK_IN_SECONDS)
-            [finalNotifications addObject:notif];
-    }
-
-    [OneSignalUserDefaults.initShared saveCodeableDataForKey:OSUD_CACHED_ATTRIBUTED_UNIQUE_OUTCOME_EVENT_NOTIFICATION_IDS_SENT withValue:finalNotifications];
+    [_outcomeEventsFactory.repository.outcomeEventsCache removeExpiredAttributedUniqueOutcomes];
 }
 
 - (void)sendClickActionOutcomes:(NSArray<OSInAppMessageOutcome *> *)outcomes
@@ -109,14 +121,19 @@ NSMutableSet *unattributedUniqueOutcomeEventsSentSet;
             pushSubscriptionId:(NSString * _Nonnull)pushSubscriptionId
                    onesignalId:(NSString * _Nonnull)onesignalId
                influenceParams:(NSArray<OSFocusInfluenceParam *> * _Nonnull)influenceParams
+                 deferralDelay:(NSTimeInterval)deferralDelay
                      onSuccess:(OSResultSuccessBlock _Nonnull)successBlock
                      onFailure:(OSFailureBlock _Nonnull)failureBlock {
-    [OneSignalCoreImpl.sharedClient executeRequest:[OSRequestSendSessionEndOutcomes
-                                                  withActiveTime:timeElapsed
-                                                  appId:appId
-                                                  pushSubscriptionId:pushSubscriptionId
-                                                  onesignalId:onesignalId
-                                                  influenceParams:influenceParams] onSuccess:^(NSDictionary *result) {
+    // Buffered outcomes go out in the same pass, both as background uploads, rather than waking the radio again
+    [self flushPendingOutcomeEvents];
+    
+    OSRequestSendSessionEndOutcomes *request = [OSRequestSendSessionEndOutcomes withActiveTime:timeElapsed
+                                                                                         appId:appId
+                                                                            pushSubscriptionId:pushSubscriptionId
+                                                                                   onesignalId:onesignalId
+                                                                               influenceParams:influenceParams];
+    request.deferralDelay = deferralDelay;
+    [OneSignalCoreImpl.sharedClient executeRequest:request onSuccess:^(NSDictionary *result) {
         [OneSignalLog onesignalLog:ONE_S_LL_DEBUG message:@"OneSignalOutcomeEventsController:sendSessionEndOutcomes attributed succeed"];
         if (successBlock) {
             successBlock(result);
@@ -129,6 +146,12 @@ NSMutableSet *unattributedUniqueOutcomeEventsSentSet;
     }];
 }
 
+- (void)cancelDeferredSessionEndOutcomes {
+    if ([OneSignalCoreImpl.sharedClient respondsToSelector:@selector(cancelDeferredRequestsWithKey:)]) {
+        [OneSignalCoreImpl.sharedClient cancelDeferredRequestsWithKey:OS_SESSION_END_DEFERRAL_KEY];
+    }
+}
+
 - (void)sendUniqueOutcomeEvent:(NSString * _Nonnull)name
                    appId:(NSString * _Nonnull)appId
               deviceType:(NSNumber * _Nonnull)deviceType
@@ -145,6 +168,10 @@ NSMutableSet *unattributedUniqueOutcomeEventsSentSet;
               deviceType:(NSNumber * _Nonnull)deviceType
             successBlock:(OSSendOutcomeSuccess _Nullable)success {
     NSArray <OSInfluence *>* influences = [_sessionManager getInfluences];
+    if (!success) {
+        [self bufferOutcomeEvent:name weight:@0 appId:appId deviceType:deviceType influences:influences];
+        return;
+    }
     [self sendAndCreateOutcomeEvent:name weight:@0 appId:appId deviceType:deviceType influences:influences successBlock:success];
 }
 
@@ -157,6 +184,10 @@ NSMutableSet *unattributedUniqueOutcomeEventsSentSet;
               deviceType:(NSNumber * _Nonnull)deviceType
             successBlock:(OSSendOutcomeSuccess _Nullable)success {
     NSArray <OSInfluence *>* influences = [_sessionManager getInfluences];
+    if (!success) {
+        [self bufferOutcomeEvent:name weight:weight appId:appId deviceType:deviceType influences:influences];
+        return;
+    }
     [self sendAndCreateOutcomeEvent:name weight:weight appId:appId deviceType:deviceType influences:influences successBlock:success];
 }
 
@@ -197,7 +228,7 @@ Unique outcomes need to validate for UNATTRIBUTED and ATTRIBUTED sessions:
         if (!uniqueInfluences || [uniqueInfluences count] == 0) {
             // Return null within the callback to determine not a failure, but not a success in terms of the request made
             NSString* message = @"Measure endpoint will not send because unique outcome already sent for: SessionInfluences: %@, Outcome name: %@";
-            [OneSignalLog onesignalLog:ONE_S_LL_DEBUG message:[NSString stringWithFormat:message, [influences description], name]];
+            ONE_S_LOG(ONE_S_LL_DEBUG, message, [influences description], name);
 
             if (success)
                 success(nil);
@@ -212,7 +243,7 @@ Unique outcomes need to validate for UNATTRIBUTED and ATTRIBUTED sessions:
         if ([unattributedUniqueOutcomeEventsSentSet containsObject:name]) {
             // Return null within the callback to determine not a failure, but not a success in terms of the request made
             NSString* message = @"Unique outcome already sent for: session: %@, name: %@";
-            [OneSignalLog onesignalLog:ONE_S_LL_DEBUG message:[NSString stringWithFormat:message, OS_INFLUENCE_TYPE_TO_STRING(UNATTRIBUTED), name]];
+            ONE_S_LOG(ONE_S_LL_DEBUG, message, OS_INFLUENCE_TYPE_TO_STRING(UNATTRIBUTED), name);
             
             if (success)
                 success(nil);
@@ -248,6 +279,133 @@ Unique outcomes need to validate for UNATTRIBUTED and ATTRIBUTED sessions:
                        deviceType:(NSNumber * _Nonnull)deviceType
                        influences:(NSArray<OSInfluence *> *)influences
                      successBlock:(OSSendOutcomeSuccess _Nullable)success {
+    OSOutcomeEventParams *eventParams = [self createOutcomeEventParams:name weight:weight influences:influences];
+    if (!eventParams) {
+        return;
+    }
+    [self sendOutcomeEventParams:eventParams appId:appId deviceType:deviceType successBlock:success onFailure:nil];
+}
+
+/*
+ Outcomes sent without a success block are buffered, and flushed together once enough are waiting,
+ after OS_OUTCOME_BUFFER_FLUSH_INTERVAL, scaled by OSPowerPolicy, or when the app is backgrounded.
+ The measure endpoint takes a single event with no count, so events are not merged;
+ flushing them together keeps the radio from waking for each event.
+ The buffer is persisted so events are not lost if the app is terminated before it is flushed.
+ */
+- (void)bufferOutcomeEvent:(NSString * _Nonnull)name
+                    weight:(NSNumber * _Nonnull)weight
+                     appId:(NSString * _Nonnull)appId
+                deviceType:(NSNumber * _Nonnull)deviceType
+                influences:(NSArray<OSInfluence *> *)influences {
+    OSOutcomeEventParams *eventParams = [self createOutcomeEventParams:name weight:weight influences:influences];
+    if (!eventParams) {
+        return;
+    }
+    
+    BOOL flushNow;
+    @synchronized (_pendingOutcomeEvents) {
+        [_pendingOutcomeEvents addObject:[[OSPendingOutcomeEvent alloc] initWithAppId:appId deviceType:deviceType eventParams:eventParams]];
+        [_outcomeEventsFactory.repository savePendingOutcomeEvents:[_pendingOutcomeEvents copy]];
+        flushNow = _pendingOutcomeEvents.count >= OSTuningConfig.sharedConfig.outcomeBatchSize;
+    }
+    
+    if (flushNow) {
+        [self flushPendingOutcomeEvents];
+    } else {
+        [self schedulePendingOutcomeEventsFlush];
+    }
+}
+
+- (void)schedulePendingOutcomeEventsFlush {
+    @synchronized (_pendingOutcomeEvents) {
+        if (_flushScheduled) {
+            return;
+        }
+        _flushScheduled = YES;
+    }
+    NSTimeInterval flushInterval = [OSPowerPolicy.sharedPolicy scaledDelay:OS_OUTCOME_BUFFER_FLUSH_INTERVAL];
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(flushInterval * NSEC_PER_SEC)), OSDispatchQueues.utility, ^{
+        [self flushPendingOutcomeEvents];
+    });
+}
+
+- (void)flushPendingOutcomeEvents {
+    NSArray<OSPendingOutcomeEvent *> *events;
+    @synchronized (_pendingOutcomeEvents) {
+        _flushScheduled = NO;
+        if (_pendingOutcomeEvents.count == 0) {
+            return;
+        }
+        events = [_pendingOutcomeEvents copy];
+        [_pendingOutcomeEvents removeAllObjects];
+        [_outcomeEventsFactory.repository savePendingOutcomeEvents:nil];
+    }
+    
+    ONE_S_LOG(ONE_S_LL_DEBUG, @"Flushing %lu buffered outcome events", (unsigned long)events.count);
+    for (OSPendingOutcomeEvent *event in events) {
+        [self sendOutcomeEventParams:event.eventParams appId:event.appId deviceType:event.deviceType successBlock:nil onFailure:^(NSError *error) {
+            if ([self isRetryableOutcomeError:error]) {
+                [self saveFailedOutcomeEvent:event];
+            }
+        }];
+    }
+}
+
+// No response, or a server error, after the client used up its reattempts
+- (BOOL)isRetryableOutcomeError:(NSError *)error {
+    if ([error.domain isEqualToString:NSURLErrorDomain]) {
+        return true;
+    }
+    return [error.domain isEqualToString:@"OneSignalClientError"] && (error.code == 0 || error.code >= 500);
+}
+
+/*
+ Keep an outcome event that failed to send instead of dropping it. It is not retried right away,
+ which would keep the radio on while the network is down, but on the next reachability change or session.
+ The queue is bounded and drops the oldest events first.
+ */
+- (void)saveFailedOutcomeEvent:(OSPendingOutcomeEvent *)event {
+    @synchronized (_pendingOutcomeEvents) {
+        [_failedOutcomeEvents addObject:event];
+        if (_failedOutcomeEvents.count > OS_FAILED_OUTCOME_EVENTS_LIMIT) {
+            [_failedOutcomeEvents removeObjectsInRange:NSMakeRange(0, _failedOutcomeEvents.count - OS_FAILED_OUTCOME_EVENTS_LIMIT)];
+        }
+        [_outcomeEventsFactory.repository saveFailedOutcomeEvents:[_failedOutcomeEvents copy]];
+    }
+    ONE_S_LOG(ONE_S_LL_DEBUG, @"Saved outcome event to retry later: %@", event.eventParams.outcomeId);
+}
+
+- (void)retryFailedOutcomeEvents {
+    NSTimeInterval expiry = [[NSDate date] timeIntervalSince1970] - OS_FAILED_OUTCOME_EVENTS_TTL;
+    NSUInteger retried = 0;
+    @synchronized (_pendingOutcomeEvents) {
+        if (_failedOutcomeEvents.count == 0) {
+            return;
+        }
+        for (OSPendingOutcomeEvent *event in _failedOutcomeEvents) {
+            // Too old to still be attributed
+            if ([event.eventParams.timestamp doubleValue] < expiry) {
+                continue;
+            }
+            [_pendingOutcomeEvents addObject:event];
+            retried++;
+        }
+        [_failedOutcomeEvents removeAllObjects];
+        [_outcomeEventsFactory.repository saveFailedOutcomeEvents:nil];
+        [_outcomeEventsFactory.repository savePendingOutcomeEvents:[_pendingOutcomeEvents copy]];
+    }
+    ONE_S_LOG(ONE_S_LL_DEBUG, @"Retrying %lu failed outcome events", (unsigned long)retried);
+    [self flushPendingOutcomeEvents];
+}
+
+/*
+ Build the params of an outcome event from the influences of the current session
+ Returns nil if outcomes are disabled for the influences
+ */
+- (OSOutcomeEventParams *)createOutcomeEventParams:(NSString * _Nonnull)name
+                                            weight:(NSNumber * _Nonnull)weight
+                                        influences:(NSArray<OSInfluence *> *)influences {
     NSTimeInterval timestamp = [[NSDate date] timeIntervalSince1970];
     OSOutcomeSourceBody *directSourceBody = nil;
     OSOutcomeSourceBody *indirectSourceBody = nil;
@@ -265,20 +423,26 @@ Unique outcomes need to validate for UNATTRIBUTED and ATTRIBUTED sessions:
                 unattributed = true;
                 break;
             case DISABLED:
-                [OneSignalLog onesignalLog:ONE_S_LL_DEBUG message:[NSString stringWithFormat:@"Outcomes disabled for channel: %@", OS_INFLUENCE_CHANNEL_TO_STRING(influence.influenceChannel)]];
-                return; // finish method
+                ONE_S_LOG(ONE_S_LL_DEBUG, @"Outcomes disabled for channel: %@", OS_INFLUENCE_CHANNEL_TO_STRING(influence.influenceChannel));
+                return nil; // finish method
         }
     }
 
     if (directSourceBody == nil && indirectSourceBody == nil && !unattributed) {
         // Disabled for all channels
         [OneSignalLog onesignalLog:ONE_S_LL_DEBUG message:@"Outcomes disabled for all channels"];
-        return;
+        return nil;
     }
 
     OSOutcomeSource *source = [[OSOutcomeSource alloc] initWithDirectBody:directSourceBody indirectBody:indirectSourceBody];
-    OSOutcomeEventParams *eventParams = [[OSOutcomeEventParams alloc] initWithOutcomeId:name outcomeSource:source weight:weight timestamp:[NSNumber numberWithDouble:timestamp]];
-    
+    return [[OSOutcomeEventParams alloc] initWithOutcomeId:name outcomeSource:source weight:weight timestamp:[NSNumber numberWithDouble:timestamp]];
+}
+
+- (void)sendOutcomeEventParams:(OSOutcomeEventParams * _Nonnull)eventParams
+                         appId:(NSString * _Nonnull)appId
+                    deviceType:(NSNumber * _Nonnull)deviceType
+                  successBlock:(OSSendOutcomeSuccess _Nullable)success
+                     onFailure:(OSFailureBlock _Nullable)failureBlock {
     [_outcomeEventsFactory.repository requestMeasureOutcomeEventWithAppId:appId deviceType:deviceType event:eventParams onSuccess:^(NSDictionary *result) {
         // Cache unique outcomes
         [self saveUniqueOutcome:eventParams];
@@ -290,6 +454,9 @@ Unique outcomes need to validate for UNATTRIBUTED and ATTRIBUTED sessions:
         // Reset unique outcomes
         [self initUniqueOutcomeEventsFromCache];
 
+        if (failureBlock)
+            failureBlock(error);
+
         if (success)
             success(nil);
     }];
@@ -299,7 +466,7 @@ Unique outcomes need to validate for UNATTRIBUTED and ATTRIBUTED sessions:
     NSMutableArray<OSInfluence *> *availableInfluences = [influences mutableCopy];
     for (OSInfluence *influence in influences) {
         if (influence.influenceType == DISABLED) {
-            [OneSignalLog onesignalLog:ONE_S_LL_DEBUG message:[NSString stringWithFormat:@"Outcomes disabled for channel: %@", OS_INFLUENCE_CHANNEL_TO_STRING(influence.influenceChannel)]];
+            ONE_S_LOG(ONE_S_LL_DEBUG, @"Outcomes disabled for channel: %@", OS_INFLUENCE_CHANNEL_TO_STRING(influence.influenceChannel));
             [availableInfluences removeObject:influence];
         }
     }
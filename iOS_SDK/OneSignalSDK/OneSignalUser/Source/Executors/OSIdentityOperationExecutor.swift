@@ -32,19 +32,30 @@ class OSIdentityOperationExecutor: OSOperationExecutor {
     var supportedDeltas: [String] = [OS_ADD_ALIAS_DELTA, OS_REMOVE_ALIAS_DELTA]
     var deltaQueue: [OSDelta] = []
     // To simplify uncaching, we maintain separate request queues for each type
-    var addRequestQueue: [OSRequestAddAliases] = []
-    var removeRequestQueue: [OSRequestRemoveAlias] = []
+    let addRequests = OSRequestQueue<OSRequestAddAliases>(cacheKey: OS_IDENTITY_EXECUTOR_ADD_REQUEST_QUEUE_KEY, name: "OSIdentityOperationExecutor", isSent: { $0.sentToClient })
+    var addRequestQueue: [OSRequestAddAliases] {
+        get { addRequests.requests }
+        set { addRequests.requests = newValue }
+    }
+    let removeRequests = OSRequestQueue<OSRequestRemoveAlias>(cacheKey: OS_IDENTITY_EXECUTOR_REMOVE_REQUEST_QUEUE_KEY, name: "OSIdentityOperationExecutor", isSent: { $0.sentToClient })
+    var removeRequestQueue: [OSRequestRemoveAlias] {
+        get { removeRequests.requests }
+        set { removeRequests.requests = newValue }
+    }
     let newRecordsState: OSNewRecordsState
 
     // The Identity executor dispatch queue, serial. This synchronizes access to the delta and request queues.
-    private let dispatchQueue = DispatchQueue(label: "OneSignal.OSIdentityOperationExecutor", target: .global())
+    private let dispatchQueue = DispatchQueue(label: "OneSignal.OSIdentityOperationExecutor", target: OSDispatchQueues.utility)
+    private let requestWindow = OSRequestWindow(maxInFlight: OSTuningConfig.sharedConfig().executorMaxInFlightRequests)
 
     init(newRecordsState: OSNewRecordsState) {
         self.newRecordsState = newRecordsState
         // Read unfinished deltas and requests from cache, if any...
-        uncacheDeltas()
-        uncacheAddAliasRequests()
-        uncacheRemoveAliasRequests()
+        OSTrace.measure(.cacheLoad, name: "OSIdentityOperationExecutor") {
+            uncacheDeltas()
+            uncacheAddAliasRequests()
+            uncacheRemoveAliasRequests()
+        }
     }
 
     private func uncacheDeltas() {
@@ -61,55 +72,43 @@ class OSIdentityOperationExecutor: OSOperationExecutor {
                 }
             }
             self.deltaQueue = deltaQueue
-            OneSignalUserDefaults.initShared().saveCodeableData(forKey: OS_IDENTITY_EXECUTOR_DELTA_QUEUE_KEY, withValue: self.deltaQueue)
+            self.persistDeltaQueue(forKey: OS_IDENTITY_EXECUTOR_DELTA_QUEUE_KEY)
         } else {
             OneSignalLog.onesignalLog(.LL_ERROR, message: "OSIdentityOperationExecutor error encountered reading from cache for \(OS_IDENTITY_EXECUTOR_DELTA_QUEUE_KEY)")
         }
     }
 
     private func uncacheAddAliasRequests() {
-        if var addRequestQueue = OneSignalUserDefaults.initShared().getSavedCodeableData(forKey: OS_IDENTITY_EXECUTOR_ADD_REQUEST_QUEUE_KEY, defaultValue: []) as? [OSRequestAddAliases] {
-            // Hook each uncached Request to the model in the store
-            for (index, request) in addRequestQueue.enumerated().reversed() {
-                if let identityModel = OneSignalUserManagerImpl.sharedInstance.getIdentityModel(request.identityModel.modelId) {
-                    // 1. The model exists in the repo, so set it to be the Request's models
-                    request.identityModel = identityModel
-                } else if request.prepareForExecution(newRecordsState: newRecordsState) {
-                    // 2. The request can be sent, add the model to the repo
-                      OneSignalUserManagerImpl.sharedInstance.addIdentityModelToRepo(request.identityModel)
-                } else {
-                    // 3. The model do not exist AND this request cannot be sent, drop this Request
-                    OneSignalLog.onesignalLog(.LL_ERROR, message: "OSIdentityOperationExecutor.init dropped \(request)")
-                    addRequestQueue.remove(at: index)
-                }
+        // Hook each uncached Request to the model in the store
+        addRequests.uncache { request in
+            if let identityModel = OneSignalUserManagerImpl.sharedInstance.getIdentityModel(request.identityModel.modelId) {
+                // 1. The model exists in the repo, so set it to be the Request's model
+                request.identityModel = identityModel
+            } else if request.prepareForExecution(newRecordsState: newRecordsState) {
+                // 2. The request can be sent, add the model to the repo
+                OneSignalUserManagerImpl.sharedInstance.addIdentityModelToRepo(request.identityModel)
+            } else {
+                // 3. The model does not exist AND this request cannot be sent, drop this Request
+                return false
             }
-            self.addRequestQueue = addRequestQueue
-            OneSignalUserDefaults.initShared().saveCodeableData(forKey: OS_IDENTITY_EXECUTOR_ADD_REQUEST_QUEUE_KEY, withValue: self.addRequestQueue)
-        } else {
-            OneSignalLog.onesignalLog(.LL_ERROR, message: "OSIdentityOperationExecutor error encountered reading from cache for \(OS_IDENTITY_EXECUTOR_ADD_REQUEST_QUEUE_KEY)")
+            return true
         }
     }
 
     private func uncacheRemoveAliasRequests() {
-        if var removeRequestQueue = OneSignalUserDefaults.initShared().getSavedCodeableData(forKey: OS_IDENTITY_EXECUTOR_REMOVE_REQUEST_QUEUE_KEY, defaultValue: []) as? [OSRequestRemoveAlias] {
-            // Hook each uncached Request to the model in the store
-            for (index, request) in removeRequestQueue.enumerated().reversed() {
-                if let identityModel = OneSignalUserManagerImpl.sharedInstance.getIdentityModel(request.identityModel.modelId) {
-                    // 1. The model exists in the repo, so set it to be the Request's model
-                    request.identityModel = identityModel
-                } else if request.prepareForExecution(newRecordsState: newRecordsState) {
-                    // 2. The request can be sent, add the model to the repo
-                    OneSignalUserManagerImpl.sharedInstance.addIdentityModelToRepo(request.identityModel)
-                } else {
-                    // 3. The model does not exist AND this request cannot be sent, drop this Request
-                    OneSignalLog.onesignalLog(.LL_ERROR, message: "OSIdentityOperationExecutor.init dropped \(request)")
-                    removeRequestQueue.remove(at: index)
-                }
+        // Hook each uncached Request to the model in the store
+        removeRequests.uncache { request in
+            if let identityModel = OneSignalUserManagerImpl.sharedInstance.getIdentityModel(request.identityModel.modelId) {
+                // 1. The model exists in the repo, so set it to be the Request's model
+                request.identityModel = identityModel
+            } else if request.prepareForExecution(newRecordsState: newRecordsState) {
+                // 2. The request can be sent, add the model to the repo
+                OneSignalUserManagerImpl.sharedInstance.addIdentityModelToRepo(request.identityModel)
+            } else {
+                // 3. The model does not exist AND this request cannot be sent, drop this Request
+                return false
             }
-            self.removeRequestQueue = removeRequestQueue
-            OneSignalUserDefaults.initShared().saveCodeableData(forKey: OS_IDENTITY_EXECUTOR_REMOVE_REQUEST_QUEUE_KEY, withValue: self.removeRequestQueue)
-        } else {
-            OneSignalLog.onesignalLog(.LL_ERROR, message: "OSIdentityOperationExecutor error encountered reading from cache for \(OS_IDENTITY_EXECUTOR_REMOVE_REQUEST_QUEUE_KEY)")
+            return true
         }
     }
 
@@ -120,9 +119,32 @@ class OSIdentityOperationExecutor: OSOperationExecutor {
         }
     }
 
+    func enqueueDeltas(_ deltas: [OSDelta]) {
+        self.dispatchQueue.async {
+            OneSignalLog.onesignalLog(.LL_VERBOSE, message: "OSIdentityOperationExecutor enqueueDeltas: \(deltas)")
+            self.deltaQueue.append(contentsOf: deltas)
+            self.persistDeltaQueue(forKey: OS_IDENTITY_EXECUTOR_DELTA_QUEUE_KEY)
+        }
+    }
+
+    /// Requests already sent to the client are not pending, their callbacks will update the queues.
+    func hasPendingWork() -> Bool {
+        self.dispatchQueue.sync {
+            !self.deltaQueue.isEmpty ||
+                self.addRequestQueue.contains { !$0.sentToClient && !$0.isAwaitingNewJwt($0.identityModel) } ||
+                self.removeRequestQueue.contains { !$0.sentToClient && !$0.isAwaitingNewJwt($0.identityModel) }
+        }
+    }
+
+    func queueDiagnostics() -> [OSQueueDiagnostics] {
+        self.dispatchQueue.sync {
+            [OSQueueDiagnostics(name: OS_IDENTITY_EXECUTOR_DELTA_QUEUE_KEY, items: self.deltaQueue, timestamps: self.deltaQueue.map { $0.timestamp }, droppedCount: 0)] + [self.addRequests, self.removeRequests].map { $0.diagnostics() }
+        }
+    }
+
     func cacheDeltaQueue() {
         self.dispatchQueue.async {
-            OneSignalUserDefaults.initShared().saveCodeableData(forKey: OS_IDENTITY_EXECUTOR_DELTA_QUEUE_KEY, withValue: self.deltaQueue)
+            self.persistDeltaQueue(forKey: OS_IDENTITY_EXECUTOR_DELTA_QUEUE_KEY)
         }
     }
 
@@ -142,11 +164,13 @@ class OSIdentityOperationExecutor: OSOperationExecutor {
                 switch delta.name {
                 case OS_ADD_ALIAS_DELTA:
                     let request = OSRequestAddAliases(aliases: aliases, identityModel: model)
+                    request.deltaTraces = [delta.trace]
                     self.addRequestQueue.append(request)
 
                 case OS_REMOVE_ALIAS_DELTA:
                     for (label, _) in aliases {
                         let request = OSRequestRemoveAlias(labelToRemove: label, identityModel: model)
+                        request.deltaTraces = [delta.trace]
                         self.removeRequestQueue.append(request)
                     }
 
@@ -157,16 +181,73 @@ class OSIdentityOperationExecutor: OSOperationExecutor {
 
             self.deltaQueue = [] // TODO: Check that we can simply clear all the deltas in the deltaQueue
 
+            self.foldRequestQueues()
+
             // persist executor's requests (including new request) to storage
-            OneSignalUserDefaults.initShared().saveCodeableData(forKey: OS_IDENTITY_EXECUTOR_ADD_REQUEST_QUEUE_KEY, withValue: self.addRequestQueue)
-            OneSignalUserDefaults.initShared().saveCodeableData(forKey: OS_IDENTITY_EXECUTOR_REMOVE_REQUEST_QUEUE_KEY, withValue: self.removeRequestQueue)
+            self.addRequests.persist()
+            self.removeRequests.persist()
 
-            OneSignalUserDefaults.initShared().saveCodeableData(forKey: OS_IDENTITY_EXECUTOR_DELTA_QUEUE_KEY, withValue: self.deltaQueue) // This should be empty, can remove instead?
+            self.persistDeltaQueue(forKey: OS_IDENTITY_EXECUTOR_DELTA_QUEUE_KEY) // This should be empty, can remove instead?
 
             self.processRequestQueue(inBackground: inBackground)
         }
     }
 
+    /**
+     Collapses the unsent alias requests of each user into one add request and one remove request per label.
+     The last operation on a label wins, so adding then removing a label only removes it and removing then adding only adds it.
+     Removing aliases is one label per call in the API, labels still being removed are not batched further.
+     This method is called by `processDeltaQueue` only and does not need to be added to the dispatchQueue.
+     */
+    func foldRequestQueues() {
+        let pending: [OneSignalRequest] = addRequestQueue.filter { !$0.sentToClient } + removeRequestQueue.filter { !$0.sentToClient }
+        let pendingByModel = Dictionary(grouping: pending) { request -> String in
+            (request as? OSRequestAddAliases)?.identityModel.modelId ?? (request as? OSRequestRemoveAlias)?.identityModel.modelId ?? ""
+        }
+
+        for (_, requests) in pendingByModel where requests.count > 1 {
+            let sorted = requests.sorted { $0.timestamp < $1.timestamp }
+            // The label's final value, or nil when its last operation is a removal
+            var finalAliases: [String: String?] = [:]
+            var identityModel: OSIdentityModel?
+            for request in sorted {
+                if let addRequest = request as? OSRequestAddAliases {
+                    identityModel = addRequest.identityModel
+                    for (label, id) in addRequest.aliases {
+                        finalAliases[label] = .some(id)
+                    }
+                } else if let removeRequest = request as? OSRequestRemoveAlias {
+                    identityModel = removeRequest.identityModel
+                    finalAliases[removeRequest.labelToRemove] = .some(nil)
+                }
+            }
+            guard let identityModel = identityModel, let timestamp = sorted.first?.timestamp else {
+                continue
+            }
+
+            addRequestQueue.removeAll { request in requests.contains { $0 === request } }
+            removeRequestQueue.removeAll { request in requests.contains { $0 === request } }
+
+            let aliasesToAdd = finalAliases.compactMapValues { $0 }
+            if !aliasesToAdd.isEmpty {
+                let request = OSRequestAddAliases(aliases: aliasesToAdd, identityModel: identityModel)
+                request.timestamp = timestamp
+                addRequestQueue.append(request)
+            }
+            for (label, id) in finalAliases where id == nil {
+                let request = OSRequestRemoveAlias(labelToRemove: label, identityModel: identityModel)
+                request.timestamp = timestamp
+                removeRequestQueue.append(request)
+            }
+            OneSignalLog.onesignalLog(.LL_VERBOSE, message: "OSIdentityOperationExecutor folded \(requests.count) alias requests into \(aliasesToAdd.isEmpty ? 0 : 1) add and \(finalAliases.count - aliasesToAdd.count) remove")
+        }
+    }
+
+    private func requestCompleted(_ key: String, inBackground: Bool) {
+        requestWindow.release(key)
+        processRequestQueue(inBackground: inBackground)
+    }
+
     /// This method is called by `processDeltaQueue` only and does not need to be added to the dispatchQueue.
     func processRequestQueue(inBackground: Bool) {
         let requestQueue: [OneSignalRequest] = addRequestQueue + removeRequestQueue
@@ -175,10 +256,18 @@ class OSIdentityOperationExecutor: OSOperationExecutor {
             return
         }
 
+        guard !inBackground || OSBackgroundTaskManager.hasTimeForBackgroundWork() else {
+            OneSignalLog.onesignalLog(.LL_DEBUG, message: "OSIdentityOperationExecutor.processRequestQueue leaving requests for the next flush, background time is running out")
+            return
+        }
+
         // Sort the requestQueue by timestamp
         for request in requestQueue.sorted(by: { first, second in
             return first.timestamp < second.timestamp
         }) {
+            guard requestWindow.hasCapacity else {
+                break
+            }
             if request.isKind(of: OSRequestAddAliases.self), let addAliasesRequest = request as? OSRequestAddAliases {
                 executeAddAliasesRequest(addAliasesRequest, inBackground: inBackground)
             } else if request.isKind(of: OSRequestRemoveAlias.self), let removeAliasRequest = request as? OSRequestRemoveAlias {
@@ -193,9 +282,15 @@ class OSIdentityOperationExecutor: OSOperationExecutor {
         guard !request.sentToClient else {
             return
         }
+        guard !request.isAwaitingNewJwt(request.identityModel) else {
+            return
+        }
         guard request.prepareForExecution(newRecordsState: newRecordsState) else {
             return
         }
+        guard requestWindow.acquire(request.identityModel.modelId) else {
+            return
+        }
         request.sentToClient = true
 
         OneSignalLog.onesignalLog(.LL_VERBOSE, message: "OSIdentityOperationExecutor: executeAddAliasesRequest making request: \(request)")
@@ -209,8 +304,8 @@ class OSIdentityOperationExecutor: OSOperationExecutor {
             // No hydration from response
             // On success, remove request from cache
             self.dispatchQueue.async {
-                self.addRequestQueue.removeAll(where: { $0 == request})
-                OneSignalUserDefaults.initShared().saveCodeableData(forKey: OS_IDENTITY_EXECUTOR_ADD_REQUEST_QUEUE_KEY, withValue: self.addRequestQueue)
+                defer { self.requestCompleted(request.identityModel.modelId, inBackground: inBackground) }
+                self.addRequests.complete(request)
                 if inBackground {
                     OSBackgroundTaskManager.endBackgroundTask(backgroundTaskIdentifier)
                 }
@@ -218,11 +313,13 @@ class OSIdentityOperationExecutor: OSOperationExecutor {
         } onFailure: { error in
             OneSignalLog.onesignalLog(.LL_ERROR, message: "OSIdentityOperationExecutor add aliases request failed with error: \(error.debugDescription)")
             self.dispatchQueue.async {
+                defer { self.requestCompleted(request.identityModel.modelId, inBackground: inBackground) }
                 let responseType = OSNetworkingUtils.getResponseStatusType(error.code)
-                if responseType == .missing {
+                if request.awaitNewJwtIfUnauthorized(responseType, identityModel: request.identityModel) {
+                    // Kept in the queue, sent again with the new JWT
+                } else if responseType == .missing {
                     // Remove from cache and queue
-                    self.addRequestQueue.removeAll(where: { $0 == request})
-                    OneSignalUserDefaults.initShared().saveCodeableData(forKey: OS_IDENTITY_EXECUTOR_ADD_REQUEST_QUEUE_KEY, withValue: self.addRequestQueue)
+                    self.addRequests.complete(request)
                     // Logout if the user in the SDK is the same
                     guard OneSignalUserManagerImpl.sharedInstance.isCurrentUser(request.identityModel)
                     else {
@@ -236,8 +333,7 @@ class OSIdentityOperationExecutor: OSOperationExecutor {
                     OneSignalUserManagerImpl.sharedInstance._logout()
                 } else if responseType != .retryable {
                     // Fail, no retry, remove from cache and queue
-                    self.addRequestQueue.removeAll(where: { $0 == request})
-                    OneSignalUserDefaults.initShared().saveCodeableData(forKey: OS_IDENTITY_EXECUTOR_ADD_REQUEST_QUEUE_KEY, withValue: self.addRequestQueue)
+                    self.addRequests.complete(request)
                 }
                 if inBackground {
                     OSBackgroundTaskManager.endBackgroundTask(backgroundTaskIdentifier)
@@ -250,9 +346,15 @@ class OSIdentityOperationExecutor: OSOperationExecutor {
         guard !request.sentToClient else {
             return
         }
+        guard !request.isAwaitingNewJwt(request.identityModel) else {
+            return
+        }
         guard request.prepareForExecution(newRecordsState: newRecordsState) else {
             return
         }
+        guard requestWindow.acquire(request.identityModel.modelId) else {
+            return
+        }
         request.sentToClient = true
 
         OneSignalLog.onesignalLog(.LL_VERBOSE, message: "OSIdentityOperationExecutor: executeRemoveAliasRequest making request: \(request)")
@@ -266,8 +368,8 @@ class OSIdentityOperationExecutor: OSOperationExecutor {
             // There is nothing to hydrate
             // On success, remove request from cache
             self.dispatchQueue.async {
-                self.removeRequestQueue.removeAll(where: { $0 == request})
-                OneSignalUserDefaults.initShared().saveCodeableData(forKey: OS_IDENTITY_EXECUTOR_REMOVE_REQUEST_QUEUE_KEY, withValue: self.removeRequestQueue)
+                defer { self.requestCompleted(request.identityModel.modelId, inBackground: inBackground) }
+                self.removeRequests.complete(request)
                 if inBackground {
                     OSBackgroundTaskManager.endBackgroundTask(backgroundTaskIdentifier)
                 }
@@ -275,12 +377,14 @@ class OSIdentityOperationExecutor: OSOperationExecutor {
         } onFailure: { error in
             OneSignalLog.onesignalLog(.LL_ERROR, message: "OSIdentityOperationExecutor remove alias request failed with error: \(error.debugDescription)")
             self.dispatchQueue.async {
+                defer { self.requestCompleted(request.identityModel.modelId, inBackground: inBackground) }
                 let responseType = OSNetworkingUtils.getResponseStatusType(error.code)
-                if responseType != .retryable {
+                if request.awaitNewJwtIfUnauthorized(responseType, identityModel: request.identityModel) {
+                    // Kept in the queue, sent again with the new JWT
+                } else if responseType != .retryable {
                     // Fail, no retry, remove from cache and queue
                     // A response of .missing could mean the alias doesn't exist on this user OR this user has been deleted
-                    self.removeRequestQueue.removeAll(where: { $0 == request})
-                    OneSignalUserDefaults.initShared().saveCodeableData(forKey: OS_IDENTITY_EXECUTOR_REMOVE_REQUEST_QUEUE_KEY, withValue: self.removeRequestQueue)
+                    self.removeRequests.complete(request)
                 }
                 if inBackground {
                     OSBackgroundTaskManager.endBackgroundTask(backgroundTaskIdentifier)
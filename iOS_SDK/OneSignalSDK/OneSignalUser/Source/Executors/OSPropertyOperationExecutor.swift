@@ -63,18 +63,25 @@ private struct OSCombinedProperties {
 class OSPropertyOperationExecutor: OSOperationExecutor {
     var supportedDeltas: [String] = [OS_UPDATE_PROPERTIES_DELTA]
     var deltaQueue: [OSDelta] = []
-    var updateRequestQueue: [OSRequestUpdateProperties] = []
+    let updateRequests = OSRequestQueue<OSRequestUpdateProperties>(cacheKey: OS_PROPERTIES_EXECUTOR_UPDATE_REQUEST_QUEUE_KEY, name: "OSPropertyOperationExecutor", isSent: { $0.sentToClient })
+    var updateRequestQueue: [OSRequestUpdateProperties] {
+        get { updateRequests.requests }
+        set { updateRequests.requests = newValue }
+    }
     let newRecordsState: OSNewRecordsState
 
     // The property executor dispatch queue, serial. This synchronizes access to `deltaQueue` and `updateRequestQueue`.
-    private let dispatchQueue = DispatchQueue(label: "OneSignal.OSPropertyOperationExecutor", target: .global())
+    private let dispatchQueue = DispatchQueue(label: "OneSignal.OSPropertyOperationExecutor", target: OSDispatchQueues.utility)
+    private let requestWindow = OSRequestWindow(maxInFlight: OSTuningConfig.sharedConfig().executorMaxInFlightRequests)
 
     init(newRecordsState: OSNewRecordsState) {
         self.newRecordsState = newRecordsState
         // Read unfinished deltas and requests from cache, if any...
         // Note that we should only have deltas for the current user as old ones are flushed..
-        uncacheDeltas()
-        uncacheUpdateRequests()
+        OSTrace.measure(.cacheLoad, name: "OSPropertyOperationExecutor") {
+            uncacheDeltas()
+            uncacheUpdateRequests()
+        }
     }
 
     private func uncacheDeltas() {
@@ -87,33 +94,34 @@ class OSPropertyOperationExecutor: OSOperationExecutor {
                 }
             }
             self.deltaQueue = deltaQueue
-            OneSignalUserDefaults.initShared().saveCodeableData(forKey: OS_PROPERTIES_EXECUTOR_DELTA_QUEUE_KEY, withValue: self.deltaQueue)
+            self.persistDeltaQueue(forKey: OS_PROPERTIES_EXECUTOR_DELTA_QUEUE_KEY)
         } else {
             OneSignalLog.onesignalLog(.LL_ERROR, message: "OSPropertyOperationExecutor error encountered reading from cache for \(OS_PROPERTIES_EXECUTOR_DELTA_QUEUE_KEY)")
         }
     }
 
     private func uncacheUpdateRequests() {
-        if var updateRequestQueue = OneSignalUserDefaults.initShared().getSavedCodeableData(forKey: OS_PROPERTIES_EXECUTOR_UPDATE_REQUEST_QUEUE_KEY, defaultValue: []) as? [OSRequestUpdateProperties] {
-            // Hook each uncached Request to the model in the store
-            for (index, request) in updateRequestQueue.enumerated().reversed() {
-                if let identityModel = OneSignalUserManagerImpl.sharedInstance.getIdentityModel(request.identityModel.modelId) {
-                    // 1. The identity model exist in the repo, set it to be the Request's model
-                    request.identityModel = identityModel
-                } else if request.prepareForExecution(newRecordsState: newRecordsState) {
-                    // 2. The request can be sent, add the model to the repo
-                    OneSignalUserManagerImpl.sharedInstance.addIdentityModelToRepo(request.identityModel)
-                } else {
-                    // 3. The identitymodel do not exist AND this request cannot be sent, drop this Request
-                    OneSignalLog.onesignalLog(.LL_WARN, message: "OSPropertyOperationExecutor.init dropped: \(request)")
-                    updateRequestQueue.remove(at: index)
-                }
+        // Hook each uncached Request to the model in the store
+        updateRequests.uncache { request in
+            if let identityModel = OneSignalUserManagerImpl.sharedInstance.getIdentityModel(request.identityModel.modelId) {
+                // 1. The identity model exist in the repo, set it to be the Request's model
+                request.identityModel = identityModel
+            } else if request.prepareForExecution(newRecordsState: newRecordsState) {
+                // 2. The request can be sent, add the model to the repo
+                OneSignalUserManagerImpl.sharedInstance.addIdentityModelToRepo(request.identityModel)
+            } else {
+                // 3. The identitymodel do not exist AND this request cannot be sent, drop this Request
+                return false
             }
-            self.updateRequestQueue = updateRequestQueue
-            OneSignalUserDefaults.initShared().saveCodeableData(forKey: OS_PROPERTIES_EXECUTOR_UPDATE_REQUEST_QUEUE_KEY, withValue: self.updateRequestQueue)
-        } else {
-            OneSignalLog.onesignalLog(.LL_ERROR, message: "OSPropertyOperationExecutor error encountered reading from cache for \(OS_PROPERTIES_EXECUTOR_UPDATE_REQUEST_QUEUE_KEY)")
+            return true
+        }
+        // Requests persisted by older versions were never merged
+        let uncachedRequests = updateRequestQueue
+        updateRequestQueue = []
+        for request in uncachedRequests {
+            appendOrMergeUpdateRequest(request)
         }
+        updateRequests.persist()
     }
 
     func enqueueDelta(_ delta: OSDelta) {
@@ -123,12 +131,73 @@ class OSPropertyOperationExecutor: OSOperationExecutor {
         }
     }
 
+    func enqueueDeltas(_ deltas: [OSDelta]) {
+        self.dispatchQueue.async {
+            OneSignalLog.onesignalLog(.LL_VERBOSE, message: "OSPropertyOperationExecutor enqueueDeltas: \(deltas)")
+            self.deltaQueue.append(contentsOf: deltas)
+            self.persistDeltaQueue(forKey: OS_PROPERTIES_EXECUTOR_DELTA_QUEUE_KEY)
+        }
+    }
+
+    /// Requests already sent to the client are not pending, their callbacks will update the queues.
+    func hasPendingWork() -> Bool {
+        self.dispatchQueue.sync {
+            !self.deltaQueue.isEmpty || self.updateRequestQueue.contains { !$0.sentToClient && !$0.isAwaitingNewJwt($0.identityModel) }
+        }
+    }
+
+    func queueDiagnostics() -> [OSQueueDiagnostics] {
+        self.dispatchQueue.sync {
+            [OSQueueDiagnostics(name: OS_PROPERTIES_EXECUTOR_DELTA_QUEUE_KEY, items: self.deltaQueue, timestamps: self.deltaQueue.map { $0.timestamp }, droppedCount: 0)] + [self.updateRequests].map { $0.diagnostics() }
+        }
+    }
+
     func cacheDeltaQueue() {
         self.dispatchQueue.async {
-            OneSignalUserDefaults.initShared().saveCodeableData(forKey: OS_PROPERTIES_EXECUTOR_DELTA_QUEUE_KEY, withValue: self.deltaQueue)
+            self.persistDeltaQueue(forKey: OS_PROPERTIES_EXECUTOR_DELTA_QUEUE_KEY)
         }
     }
 
+    /**
+     Folds a newer properties delta into an existing one for the same user and property.
+     Tags merge with last-writer-wins per tag key, session time and count are summed, and other
+     first-level properties take the newest value. Purchases are not coalesced.
+     This mirrors `combineProperties` so the resulting request is unchanged.
+     */
+    func coalesce(_ existing: OSDelta, with newer: OSDelta) -> OSDelta? {
+        guard existing.name == newer.name,
+              existing.identityModelId == newer.identityModelId,
+              existing.property == newer.property,
+              let property = OSPropertiesSupportedProperty(rawValue: newer.property)
+        else {
+            return nil
+        }
+
+        let value: Any
+        switch property {
+        case .tags:
+            guard var tags = existing.value as? [String: String],
+                  let newTags = newer.value as? [String: String]
+            else {
+                return nil
+            }
+            tags.merge(newTags) { _, newValue in newValue }
+            value = tags
+        case .session_time, .session_count:
+            guard let existingValue = existing.value as? Int,
+                  let newValue = newer.value as? Int
+            else {
+                return nil
+            }
+            value = existingValue + newValue
+        case .purchases:
+            return nil
+        default:
+            value = newer.value
+        }
+        return OSDelta(name: newer.name, identityModelId: newer.identityModelId, model: newer.model, property: newer.property, value: value)
+    }
+
     /// The `deltaQueue` should only contain updates for one user.
     /// Even when login -> addTag -> login -> addTag are called in immediate succession.
     func processDeltaQueue(inBackground: Bool) {
@@ -142,16 +211,21 @@ class OSPropertyOperationExecutor: OSOperationExecutor {
 
             // Holds mapping of identity model ID to the updates for it; there should only be one user
             var combinedProperties: [String: OSCombinedProperties] = [:]
+            var completionHandlers: [String: [(Bool) -> Void]] = [:]
+            var deltaTraces: [String: [OSDeltaTrace]] = [:]
 
             // 1. Combined deltas into a single OSCombinedProperties for every user
             for delta in self.deltaQueue {
                 guard let identityModel = OneSignalUserManagerImpl.sharedInstance.getIdentityModel(delta.identityModelId)
                 else {
                     OneSignalLog.onesignalLog(.LL_ERROR, message: "OSPropertyOperationExecutor.processDeltaQueue dropped: \(delta)")
+                    delta.removeCompletionHandlers().forEach { $0(false) }
                     continue
                 }
                 let combinedSoFar: OSCombinedProperties? = combinedProperties[identityModel.modelId]
                 combinedProperties[identityModel.modelId] = self.combineProperties(existing: combinedSoFar, delta: delta)
+                completionHandlers[identityModel.modelId, default: []].append(contentsOf: delta.removeCompletionHandlers())
+                deltaTraces[identityModel.modelId, default: []].append(delta.trace)
             }
 
             if combinedProperties.count > 1 {
@@ -164,25 +238,113 @@ class OSPropertyOperationExecutor: OSOperationExecutor {
                 else {
                     // This should never happen as we already checked this during Deltas processing above
                     OneSignalLog.onesignalLog(.LL_ERROR, message: "OSPropertyOperationExecutor.processDeltaQueue dropped: \(properties)")
+                    completionHandlers[modelId]?.forEach { $0(false) }
                     continue
                 }
                 let request = OSRequestUpdateProperties(
                     params: properties.jsonRepresentation(),
                     identityModel: identityModel
                 )
-                self.updateRequestQueue.append(request)
+                request.completionHandlers = completionHandlers[modelId] ?? []
+                request.deltaTraces = deltaTraces[modelId]
+                self.appendOrMergeUpdateRequest(request)
             }
 
             self.deltaQueue.removeAll()
 
             // Persist executor's requests (including new request) to storage
-            OneSignalUserDefaults.initShared().saveCodeableData(forKey: OS_PROPERTIES_EXECUTOR_UPDATE_REQUEST_QUEUE_KEY, withValue: self.updateRequestQueue)
+            self.updateRequests.persist()
             OneSignalUserDefaults.initShared().saveCodeableData(forKey: OS_PROPERTIES_EXECUTOR_DELTA_QUEUE_KEY, withValue: [])
 
             self.processRequestQueue(inBackground: inBackground)
         }
     }
 
+    /**
+     Adds a request to `updateRequestQueue`, merging it into the last pending request for the same user if it is not yet sent.
+     While offline each flush would otherwise persist and later send its own PATCH.
+     The merged request keeps the position and timestamp of the one already queued.
+     Requests with too many tags are split, see `splitIfOversized`.
+     */
+    private func appendOrMergeUpdateRequest(_ request: OSRequestUpdateProperties) {
+        guard let index = updateRequestQueue.lastIndex(where: { $0.identityModel.modelId == request.identityModel.modelId }),
+              !updateRequestQueue[index].sentToClient,
+              let pendingParams = updateRequestQueue[index].parameters as? [String: Any],
+              let newParams = request.parameters as? [String: Any]
+        else {
+            updateRequestQueue.append(contentsOf: splitIfOversized(request))
+            return
+        }
+        let pending = updateRequestQueue[index]
+        let merged = OSRequestUpdateProperties(
+            params: OSRequestUpdateProperties.mergeParams(pendingParams, newParams),
+            identityModel: pending.identityModel
+        )
+        merged.timestamp = pending.timestamp
+        merged.completionHandlers = pending.completionHandlers + request.completionHandlers
+        merged.deltaTraces = (pending.deltaTraces ?? []) + (request.deltaTraces ?? [])
+        updateRequestQueue.replaceSubrange(index...index, with: splitIfOversized(merged))
+        OneSignalLog.onesignalLog(.LL_VERBOSE, message: "OSPropertyOperationExecutor merged \(request) into \(merged)")
+    }
+
+    /**
+     Splits a request whose tags exceed `OS_UPDATE_PROPERTIES_MAX_TAGS_BYTES` into requests that are each retried on their own.
+     The request window sends requests for the same user one at a time, so the parts reach the server in order.
+     The original completion handlers are called once every part completed, with true only if all of them succeeded.
+     */
+    private func splitIfOversized(_ request: OSRequestUpdateProperties) -> [OSRequestUpdateProperties] {
+        guard let params = request.parameters as? [String: Any] else {
+            return [request]
+        }
+        let partsParams = OSRequestUpdateProperties.splitParams(params, maxTagsBytes: Int(OS_UPDATE_PROPERTIES_MAX_TAGS_BYTES))
+        guard partsParams.count > 1 else {
+            return [request]
+        }
+        OneSignalLog.onesignalLog(.LL_DEBUG, message: "OSPropertyOperationExecutor split \(request) into \(partsParams.count) requests")
+
+        let completionHandlers = request.completionHandlers
+        let lock = NSLock()
+        var remaining = partsParams.count
+        var succeeded = true
+        let partCompleted: (Bool) -> Void = { success in
+            let allSucceeded: Bool? = lock.withLock {
+                succeeded = succeeded && success
+                remaining -= 1
+                return remaining == 0 ? succeeded : nil
+            }
+            if let allSucceeded = allSucceeded {
+                completionHandlers.forEach { $0(allSucceeded) }
+            }
+        }
+        let parts = partsParams.map { partParams in
+            let part = OSRequestUpdateProperties(params: partParams, identityModel: request.identityModel)
+            part.timestamp = request.timestamp
+            part.completionHandlers = completionHandlers.isEmpty ? [] : [partCompleted]
+            return part
+        }
+        // The changes have reached the server once the last part, sent after the others, succeeds
+        parts.last?.deltaTraces = request.deltaTraces
+        return parts
+    }
+
+    /**
+     Removes and returns the unsent requests for the user that only update properties and tags, for the user executor to fuse
+     into the Create User request of that user. Requests carrying session or purchase deltas stay, Create User does not take them.
+     */
+    func takeFusableRequests(identityModelId: String) -> [OSRequestUpdateProperties] {
+        dispatchQueue.sync {
+            let fusable = updateRequestQueue.filter {
+                !$0.sentToClient && $0.identityModel.modelId == identityModelId && $0.parameters?["deltas"] == nil
+            }
+            guard !fusable.isEmpty else {
+                return []
+            }
+            updateRequestQueue.removeAll(where: { request in fusable.contains(where: { $0 === request }) })
+            updateRequests.persist()
+            return fusable
+        }
+    }
+
     /// Helper method to combine the information in an `OSDelta` to the existing `OSCombinedProperties` so far.
     private func combineProperties(existing: OSCombinedProperties?, delta: OSDelta) -> OSCombinedProperties {
         var combinedProperties = existing ?? OSCombinedProperties()
@@ -220,13 +382,33 @@ class OSPropertyOperationExecutor: OSOperationExecutor {
         return combinedProperties
     }
 
+    /// Must be called on the `dispatchQueue`, a request is only completed once.
+    private func callCompletionHandlers(of request: OSRequestUpdateProperties, success: Bool) {
+        let completionHandlers = request.completionHandlers
+        request.completionHandlers = []
+        completionHandlers.forEach { $0(success) }
+    }
+
+    private func requestCompleted(_ key: String, inBackground: Bool) {
+        requestWindow.release(key)
+        processRequestQueue(inBackground: inBackground)
+    }
+
     /// This method is called by `processDeltaQueue` only and does not need to be added to the dispatchQueue.
     func processRequestQueue(inBackground: Bool) {
         if updateRequestQueue.isEmpty {
             return
         }
 
+        guard !inBackground || OSBackgroundTaskManager.hasTimeForBackgroundWork() else {
+            OneSignalLog.onesignalLog(.LL_DEBUG, message: "OSPropertyOperationExecutor.processRequestQueue leaving requests for the next flush, background time is running out")
+            return
+        }
+
         for request in updateRequestQueue {
+            guard requestWindow.hasCapacity else {
+                break
+            }
             executeUpdatePropertiesRequest(request, inBackground: inBackground)
         }
     }
@@ -235,9 +417,15 @@ class OSPropertyOperationExecutor: OSOperationExecutor {
         guard !request.sentToClient else {
             return
         }
+        guard !request.isAwaitingNewJwt(request.identityModel) else {
+            return
+        }
         guard request.prepareForExecution(newRecordsState: newRecordsState) else {
             return
         }
+        guard requestWindow.acquire(request.identityModel.modelId) else {
+            return
+        }
         request.sentToClient = true
 
         let backgroundTaskIdentifier = PROPERTIES_EXECUTOR_BACKGROUND_TASK + UUID().uuidString
@@ -249,8 +437,9 @@ class OSPropertyOperationExecutor: OSOperationExecutor {
             // On success, remove request from cache, and we do need to hydrate
             // TODO: We need to hydrate after all ? What why ?
             self.dispatchQueue.async {
-                self.updateRequestQueue.removeAll(where: { $0 == request})
-                OneSignalUserDefaults.initShared().saveCodeableData(forKey: OS_PROPERTIES_EXECUTOR_UPDATE_REQUEST_QUEUE_KEY, withValue: self.updateRequestQueue)
+                defer { self.requestCompleted(request.identityModel.modelId, inBackground: inBackground) }
+                self.updateRequests.complete(request)
+                self.callCompletionHandlers(of: request, success: true)
                 if inBackground {
                     OSBackgroundTaskManager.endBackgroundTask(backgroundTaskIdentifier)
                 }
@@ -265,19 +454,28 @@ class OSPropertyOperationExecutor: OSOperationExecutor {
                         key: OSIamFetchOffsetKey.userUpdate,
                         value: OSReadYourWriteData(rywToken: rywToken, rywDelay: rywDelay)
                     )
+                    OSConsistencyManager.shared.setRywTokenAndDelay(
+                        id: onesignalId,
+                        key: OSUserReadOffsetKey.tagsUpdate,
+                        value: OSReadYourWriteData(rywToken: rywToken, rywDelay: rywDelay)
+                    )
                 } else {
                     // handle a potential regression where ryw_token is no longer returned by API
                     OSConsistencyManager.shared.resolveConditionsWithID(id: OSIamFetchReadyCondition.CONDITIONID)
+                    OSConsistencyManager.shared.resolveConditionsWithID(id: OSKeyedTokenCondition.TAGS_CONDITIONID)
                 }
             }
         } onFailure: { error in
             OneSignalLog.onesignalLog(.LL_ERROR, message: "OSPropertyOperationExecutor update properties request failed with error: \(error.debugDescription)")
             self.dispatchQueue.async {
+                defer { self.requestCompleted(request.identityModel.modelId, inBackground: inBackground) }
                 let responseType = OSNetworkingUtils.getResponseStatusType(error.code)
-                if responseType == .missing {
+                if request.awaitNewJwtIfUnauthorized(responseType, identityModel: request.identityModel) {
+                    // Kept in the queue, sent again with the new JWT
+                } else if responseType == .missing {
                     // remove from cache and queue
-                    self.updateRequestQueue.removeAll(where: { $0 == request})
-                    OneSignalUserDefaults.initShared().saveCodeableData(forKey: OS_PROPERTIES_EXECUTOR_UPDATE_REQUEST_QUEUE_KEY, withValue: self.updateRequestQueue)
+                    self.updateRequests.complete(request)
+                    self.callCompletionHandlers(of: request, success: false)
                     // Logout if the user in the SDK is the same
                     guard OneSignalUserManagerImpl.sharedInstance.isCurrentUser(request.identityModel)
                     else {
@@ -291,8 +489,8 @@ class OSPropertyOperationExecutor: OSOperationExecutor {
                     OneSignalUserManagerImpl.sharedInstance._logout()
                 } else if responseType != .retryable {
                     // Fail, no retry, remove from cache and queue
-                    self.updateRequestQueue.removeAll(where: { $0 == request})
-                    OneSignalUserDefaults.initShared().saveCodeableData(forKey: OS_PROPERTIES_EXECUTOR_UPDATE_REQUEST_QUEUE_KEY, withValue: self.updateRequestQueue)
+                    self.updateRequests.complete(request)
+                    self.callCompletionHandlers(of: request, success: false)
                 }
                 if inBackground {
                     OSBackgroundTaskManager.endBackgroundTask(backgroundTaskIdentifier)
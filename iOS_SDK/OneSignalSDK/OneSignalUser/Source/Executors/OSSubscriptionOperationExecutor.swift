@@ -32,22 +32,39 @@ class OSSubscriptionOperationExecutor: OSOperationExecutor {
     var supportedDeltas: [String] = [OS_ADD_SUBSCRIPTION_DELTA, OS_REMOVE_SUBSCRIPTION_DELTA, OS_UPDATE_SUBSCRIPTION_DELTA]
     var deltaQueue: [OSDelta] = []
     // To simplify uncaching, we maintain separate request queues for each type
-    var addRequestQueue: [OSRequestCreateSubscription] = []
-    var removeRequestQueue: [OSRequestDeleteSubscription] = []
-    var updateRequestQueue: [OSRequestUpdateSubscription] = []
+    let addRequests = OSRequestQueue<OSRequestCreateSubscription>(cacheKey: OS_SUBSCRIPTION_EXECUTOR_ADD_REQUEST_QUEUE_KEY, name: "OSSubscriptionOperationExecutor", isSent: { $0.sentToClient })
+    var addRequestQueue: [OSRequestCreateSubscription] {
+        get { addRequests.requests }
+        set { addRequests.requests = newValue }
+    }
+    let removeRequests = OSRequestQueue<OSRequestDeleteSubscription>(cacheKey: OS_SUBSCRIPTION_EXECUTOR_REMOVE_REQUEST_QUEUE_KEY, name: "OSSubscriptionOperationExecutor", isSent: { $0.sentToClient })
+    var removeRequestQueue: [OSRequestDeleteSubscription] {
+        get { removeRequests.requests }
+        set { removeRequests.requests = newValue }
+    }
+    let updateRequests = OSRequestQueue<OSRequestUpdateSubscription>(cacheKey: OS_SUBSCRIPTION_EXECUTOR_UPDATE_REQUEST_QUEUE_KEY, name: "OSSubscriptionOperationExecutor", isSent: { $0.sentToClient })
+    var updateRequestQueue: [OSRequestUpdateSubscription] {
+        get { updateRequests.requests }
+        set { updateRequests.requests = newValue }
+    }
     var subscriptionModels: [String: OSSubscriptionModel] = [:]
     let newRecordsState: OSNewRecordsState
+    /// Subscription ID to the fingerprint of the last update payload the server acknowledged. Accessed on the `dispatchQueue`.
+    private lazy var acknowledgedUpdates: [String: String] = OneSignalUserDefaults.initShared().getSavedDictionary(forKey: OS_SUBSCRIPTION_EXECUTOR_ACKNOWLEDGED_UPDATES_KEY, defaultValue: [:]) as? [String: String] ?? [:]
 
     // The Subscription executor dispatch queue, serial. This synchronizes access to the delta and request queues.
-    private let dispatchQueue = DispatchQueue(label: "OneSignal.OSSubscriptionOperationExecutor", target: .global())
+    private let dispatchQueue = DispatchQueue(label: "OneSignal.OSSubscriptionOperationExecutor", target: OSDispatchQueues.utility)
+    private let requestWindow = OSRequestWindow(maxInFlight: OSTuningConfig.sharedConfig().executorMaxInFlightRequests)
 
     init(newRecordsState: OSNewRecordsState) {
         self.newRecordsState = newRecordsState
         // Read unfinished deltas and requests from cache, if any...
-        uncacheDeltas()
-        uncacheCreateSubscriptionRequests()
-        uncacheDeleteSubscriptionRequests()
-        uncacheUpdateSubscriptionRequests()
+        OSTrace.measure(.cacheLoad, name: "OSSubscriptionOperationExecutor") {
+            uncacheDeltas()
+            uncacheCreateSubscriptionRequests()
+            uncacheDeleteSubscriptionRequests()
+            uncacheUpdateSubscriptionRequests()
+        }
     }
 
     private func uncacheDeltas() {
@@ -64,93 +81,77 @@ class OSSubscriptionOperationExecutor: OSOperationExecutor {
                 }
             }
             self.deltaQueue = deltaQueue
-            OneSignalUserDefaults.initShared().saveCodeableData(forKey: OS_SUBSCRIPTION_EXECUTOR_DELTA_QUEUE_KEY, withValue: self.deltaQueue)
+            self.persistDeltaQueue(forKey: OS_SUBSCRIPTION_EXECUTOR_DELTA_QUEUE_KEY)
         } else {
             OneSignalLog.onesignalLog(.LL_ERROR, message: "OSSubscriptionOperationExecutor error encountered reading from cache for \(OS_SUBSCRIPTION_EXECUTOR_DELTA_QUEUE_KEY)")
         }
     }
 
     private func uncacheCreateSubscriptionRequests() {
-        var requestQueue: [OSRequestCreateSubscription] = []
-
-        if let cachedAddRequestQueue = OneSignalUserDefaults.initShared().getSavedCodeableData(forKey: OS_SUBSCRIPTION_EXECUTOR_ADD_REQUEST_QUEUE_KEY, defaultValue: []) as? [OSRequestCreateSubscription] {
-            // Hook each uncached Request to the model in the store
-            for request in cachedAddRequestQueue {
-                // 1. Hook up the subscription model
-                if let subscriptionModel = getSubscriptionModelFromStores(modelId: request.subscriptionModel.modelId) {
-                    // a. The model exist in the store, set it to be the Request's models
-                    request.subscriptionModel = subscriptionModel
-                } else if let subscriptionModel = subscriptionModels[request.subscriptionModel.modelId] {
-                    // b. The model exists in the dictionary of seen models
-                    request.subscriptionModel = subscriptionModel
-                } else {
-                    // c. The model has not been seen yet, add to dict
-                    subscriptionModels[request.subscriptionModel.modelId] = request.subscriptionModel
-                }
-                // 2. Hook up the identity model
-                if let identityModel = OneSignalUserManagerImpl.sharedInstance.getIdentityModel(request.identityModel.modelId) {
-                    // a. The model exist in the repo
-                    request.identityModel = identityModel
-                } else if request.prepareForExecution(newRecordsState: newRecordsState) {
-                    // b. The request can be sent, add the model to the repo
-                    OneSignalUserManagerImpl.sharedInstance.addIdentityModelToRepo(request.identityModel)
-                } else {
-                    // c. The model do not exist AND this request cannot be sent, drop this Request
-                    OneSignalLog.onesignalLog(.LL_WARN, message: "OSSubscriptionOperationExecutor.init dropped: \(request)")
-                    continue
-                }
-                requestQueue.append(request)
+        // Hook each uncached Request to the model in the store
+        addRequests.uncache { request in
+            // 1. Hook up the subscription model
+            if let subscriptionModel = getSubscriptionModelFromStores(modelId: request.subscriptionModel.modelId) {
+                // a. The model exist in the store, set it to be the Request's models
+                request.subscriptionModel = subscriptionModel
+            } else if let subscriptionModel = subscriptionModels[request.subscriptionModel.modelId] {
+                // b. The model exists in the dictionary of seen models
+                request.subscriptionModel = subscriptionModel
+            } else {
+                // c. The model has not been seen yet, add to dict
+                subscriptionModels[request.subscriptionModel.modelId] = request.subscriptionModel
             }
-            self.addRequestQueue = requestQueue
-            OneSignalUserDefaults.initShared().saveCodeableData(forKey: OS_SUBSCRIPTION_EXECUTOR_ADD_REQUEST_QUEUE_KEY, withValue: self.addRequestQueue)
-        } else {
-            OneSignalLog.onesignalLog(.LL_ERROR, message: "OSSubscriptionOperationExecutor error encountered reading from cache for \(OS_SUBSCRIPTION_EXECUTOR_ADD_REQUEST_QUEUE_KEY)")
+            // 2. Hook up the identity model
+            if let identityModel = OneSignalUserManagerImpl.sharedInstance.getIdentityModel(request.identityModel.modelId) {
+                // a. The model exist in the repo
+                request.identityModel = identityModel
+            } else if request.prepareForExecution(newRecordsState: newRecordsState) {
+                // b. The request can be sent, add the model to the repo
+                OneSignalUserManagerImpl.sharedInstance.addIdentityModelToRepo(request.identityModel)
+            } else {
+                // c. The model do not exist AND this request cannot be sent, drop this Request
+                return false
+            }
+            return true
         }
     }
 
     private func uncacheDeleteSubscriptionRequests() {
-        if var removeRequestQueue = OneSignalUserDefaults.initShared().getSavedCodeableData(forKey: OS_SUBSCRIPTION_EXECUTOR_REMOVE_REQUEST_QUEUE_KEY, defaultValue: []) as? [OSRequestDeleteSubscription] {
-            // Hook each uncached Request to the model in the store
-            for (index, request) in removeRequestQueue.enumerated().reversed() {
-                if let subscriptionModel = getSubscriptionModelFromStores(modelId: request.subscriptionModel.modelId) {
-                    // 1. The model exists in the store, set it to be the Request's model
-                    request.subscriptionModel = subscriptionModel
-                } else if let subscriptionModel = subscriptionModels[request.subscriptionModel.modelId] {
-                    // 2. The model exists in the dict of seen subscription models
-                    request.subscriptionModel = subscriptionModel
-                } else if !request.prepareForExecution(newRecordsState: newRecordsState) {
-                    // 3. The model does not exist AND this request cannot be sent, drop this Request
-                    OneSignalLog.onesignalLog(.LL_ERROR, message: "OSSubscriptionOperationExecutor.init dropped \(request)")
-                    removeRequestQueue.remove(at: index)
-                }
+        // Hook each uncached Request to the model in the store
+        removeRequests.uncache { request in
+            if let subscriptionModel = getSubscriptionModelFromStores(modelId: request.subscriptionModel.modelId) {
+                // 1. The model exists in the store, set it to be the Request's model
+                request.subscriptionModel = subscriptionModel
+            } else if let subscriptionModel = subscriptionModels[request.subscriptionModel.modelId] {
+                // 2. The model exists in the dict of seen subscription models
+                request.subscriptionModel = subscriptionModel
+            } else if !request.prepareForExecution(newRecordsState: newRecordsState) {
+                // 3. The model does not exist AND this request cannot be sent, drop this Request
+                return false
             }
-            self.removeRequestQueue = removeRequestQueue
-            OneSignalUserDefaults.initShared().saveCodeableData(forKey: OS_SUBSCRIPTION_EXECUTOR_REMOVE_REQUEST_QUEUE_KEY, withValue: self.removeRequestQueue)
-        } else {
-            OneSignalLog.onesignalLog(.LL_ERROR, message: "OSSubscriptionOperationExecutor error encountered reading from cache for \(OS_SUBSCRIPTION_EXECUTOR_REMOVE_REQUEST_QUEUE_KEY)")
+            return true
         }
     }
 
     private func uncacheUpdateSubscriptionRequests() {
-        if var updateRequestQueue = OneSignalUserDefaults.initShared().getSavedCodeableData(forKey: OS_SUBSCRIPTION_EXECUTOR_UPDATE_REQUEST_QUEUE_KEY, defaultValue: []) as? [OSRequestUpdateSubscription] {
-            // Hook each uncached Request to the model in the store
-            for (index, request) in updateRequestQueue.enumerated().reversed() {
-                if let subscriptionModel = getSubscriptionModelFromStores(modelId: request.subscriptionModel.modelId) {
-                    // 1. The model exists in the store, set it to be the Request's model
-                    request.subscriptionModel = subscriptionModel
-                } else if let subscriptionModel = subscriptionModels[request.subscriptionModel.modelId] {
-                    // 2. The model exists in the dict of seen subscription models
-                    request.subscriptionModel = subscriptionModel
-                } else if !request.prepareForExecution(newRecordsState: newRecordsState) {
-                    // 3. The models do not exist AND this request cannot be sent, drop this Request
-                    OneSignalLog.onesignalLog(.LL_ERROR, message: "OSSubscriptionOperationExecutor.init dropped \(request)")
-                    updateRequestQueue.remove(at: index)
-                }
+        // Hook each uncached Request to the model in the store
+        updateRequests.uncache { request in
+            if let subscriptionModel = getSubscriptionModelFromStores(modelId: request.subscriptionModel.modelId) {
+                // 1. The model exists in the store, set it to be the Request's model
+                request.subscriptionModel = subscriptionModel
+            } else if let subscriptionModel = subscriptionModels[request.subscriptionModel.modelId] {
+                // 2. The model exists in the dict of seen subscription models
+                request.subscriptionModel = subscriptionModel
+            } else if !request.prepareForExecution(newRecordsState: newRecordsState) {
+                // 3. The model does not exist AND this request cannot be sent, drop this Request
+                return false
             }
-            self.updateRequestQueue = updateRequestQueue
-            OneSignalUserDefaults.initShared().saveCodeableData(forKey: OS_SUBSCRIPTION_EXECUTOR_UPDATE_REQUEST_QUEUE_KEY, withValue: self.updateRequestQueue)
-        } else {
-            OneSignalLog.onesignalLog(.LL_ERROR, message: "OSSubscriptionOperationExecutor error encountered reading from cache for \(OS_SUBSCRIPTION_EXECUTOR_UPDATE_REQUEST_QUEUE_KEY)")
+            // The identity model only decides whose RYW token the update sets, so a missing one is kept as decoded
+            if let identityModelId = request.identityModel?.modelId,
+               let identityModel = OneSignalUserManagerImpl.sharedInstance.getIdentityModel(identityModelId) {
+                request.identityModel = identityModel
+            }
+            return true
         }
     }
 
@@ -174,9 +175,35 @@ class OSSubscriptionOperationExecutor: OSOperationExecutor {
         }
     }
 
+    func enqueueDeltas(_ deltas: [OSDelta]) {
+        self.dispatchQueue.async {
+            OneSignalLog.onesignalLog(.LL_VERBOSE, message: "OSSubscriptionOperationExecutor enqueueDeltas: \(deltas)")
+            self.deltaQueue.append(contentsOf: deltas)
+            self.persistDeltaQueue(forKey: OS_SUBSCRIPTION_EXECUTOR_DELTA_QUEUE_KEY)
+        }
+    }
+
+    /// Requests already sent to the client are not pending, their callbacks will update the queues.
+    func hasPendingWork() -> Bool {
+        self.dispatchQueue.sync {
+            !self.deltaQueue.isEmpty ||
+                self.addRequestQueue.contains { !$0.sentToClient && !$0.isAwaitingNewJwt($0.identityModel) } ||
+                self.removeRequestQueue.contains { !$0.sentToClient } ||
+                self.updateRequestQueue.contains { request in
+                    !request.sentToClient && !(request.identityModel.map { request.isAwaitingNewJwt($0) } ?? false)
+                }
+        }
+    }
+
+    func queueDiagnostics() -> [OSQueueDiagnostics] {
+        self.dispatchQueue.sync {
+            [OSQueueDiagnostics(name: OS_SUBSCRIPTION_EXECUTOR_DELTA_QUEUE_KEY, items: self.deltaQueue, timestamps: self.deltaQueue.map { $0.timestamp }, droppedCount: 0)] + [self.addRequests, self.removeRequests, self.updateRequests].map { $0.diagnostics() }
+        }
+    }
+
     func cacheDeltaQueue() {
         self.dispatchQueue.async {
-            OneSignalUserDefaults.initShared().saveCodeableData(forKey: OS_SUBSCRIPTION_EXECUTOR_DELTA_QUEUE_KEY, withValue: self.deltaQueue)
+            self.persistDeltaQueue(forKey: OS_SUBSCRIPTION_EXECUTOR_DELTA_QUEUE_KEY)
         }
     }
 
@@ -200,6 +227,7 @@ class OSSubscriptionOperationExecutor: OSOperationExecutor {
                             subscriptionModel: subModel,
                             identityModel: identityModel
                         )
+                        request.deltaTraces = [delta.trace]
                         self.addRequestQueue.append(request)
                     } else {
                         OneSignalLog.onesignalLog(.LL_ERROR, message: "OSSubscriptionOperationExecutor.processDeltaQueue dropped \(delta)")
@@ -208,13 +236,16 @@ class OSSubscriptionOperationExecutor: OSOperationExecutor {
                     let request = OSRequestDeleteSubscription(
                         subscriptionModel: subModel
                     )
+                    request.deltaTraces = [delta.trace]
                     self.removeRequestQueue.append(request)
 
                 case OS_UPDATE_SUBSCRIPTION_DELTA:
                     let request = OSRequestUpdateSubscription(
-                        subscriptionObject: [delta.property: delta.value],
-                        subscriptionModel: subModel
+                        subscriptionObject: delta.changedProperties,
+                        subscriptionModel: subModel,
+                        identityModel: OneSignalUserManagerImpl.sharedInstance.getIdentityModel(delta.identityModelId)
                     )
+                    request.deltaTraces = [delta.trace]
                     self.updateRequestQueue.append(request)
 
                 default:
@@ -225,26 +256,77 @@ class OSSubscriptionOperationExecutor: OSOperationExecutor {
 
             self.deltaQueue = [] // TODO: Check that we can simply clear all the deltas in the deltaQueue
 
+            self.foldRequestQueues()
+
             // persist executor's requests (including new request) to storage
-            OneSignalUserDefaults.initShared().saveCodeableData(forKey: OS_SUBSCRIPTION_EXECUTOR_ADD_REQUEST_QUEUE_KEY, withValue: self.addRequestQueue)
-            OneSignalUserDefaults.initShared().saveCodeableData(forKey: OS_SUBSCRIPTION_EXECUTOR_REMOVE_REQUEST_QUEUE_KEY, withValue: self.removeRequestQueue)
-            OneSignalUserDefaults.initShared().saveCodeableData(forKey: OS_SUBSCRIPTION_EXECUTOR_UPDATE_REQUEST_QUEUE_KEY, withValue: self.updateRequestQueue)
+            self.addRequests.persist()
+            self.removeRequests.persist()
+            self.updateRequests.persist()
 
-            OneSignalUserDefaults.initShared().saveCodeableData(forKey: OS_SUBSCRIPTION_EXECUTOR_DELTA_QUEUE_KEY, withValue: self.deltaQueue) // This should be empty, can remove instead?
+            self.persistDeltaQueue(forKey: OS_SUBSCRIPTION_EXECUTOR_DELTA_QUEUE_KEY) // This should be empty, can remove instead?
 
             self.processRequestQueue(inBackground: inBackground)
         }
     }
 
+    /**
+     Removes pending requests that would be undone by a later pending request, before any are sent.
+     1. A create followed by a delete of the same model cancels out, along with any updates to it.
+     2. Updates to a model that is about to be deleted are dropped.
+     3. Sequential updates to the same model collapse into the newest one, which already carries the model's latest state.
+     Requests already sent to the client are left alone, their callbacks update the queues.
+     This method is called by `processDeltaQueue` only and does not need to be added to the dispatchQueue.
+     */
+    func foldRequestQueues() {
+        let addCount = addRequestQueue.count, removeCount = removeRequestQueue.count, updateCount = updateRequestQueue.count
+
+        for deleteRequest in removeRequestQueue where !deleteRequest.sentToClient {
+            let modelId = deleteRequest.subscriptionModel.modelId
+            // 1. The subscription was never created on the server, nothing to delete
+            if let createIndex = addRequestQueue.firstIndex(where: { !$0.sentToClient && $0.subscriptionModel.modelId == modelId && $0.timestamp <= deleteRequest.timestamp }) {
+                addRequestQueue.remove(at: createIndex)
+                removeRequestQueue.removeAll(where: { $0 == deleteRequest })
+            }
+            // 2. Updating it first is wasted work
+            updateRequestQueue.removeAll(where: { !$0.sentToClient && $0.subscriptionModel.modelId == modelId && $0.timestamp <= deleteRequest.timestamp })
+        }
+
+        // 3. Keep the newest unsent update per model, carrying over keys only older updates had
+        var newestUpdates: [String: OSRequestUpdateSubscription] = [:]
+        for request in updateRequestQueue.reversed() where !request.sentToClient {
+            let modelId = request.subscriptionModel.modelId
+            guard let newest = newestUpdates[modelId] else {
+                newestUpdates[modelId] = request
+                continue
+            }
+            if var newestParams = newest.parameters?["subscription"] as? [String: Any],
+               let olderParams = request.parameters?["subscription"] as? [String: Any] {
+                newestParams.merge(olderParams) { newestValue, _ in newestValue }
+                newest.parameters = ["subscription": newestParams]
+            }
+            newest.deltaTraces = (request.deltaTraces ?? []) + (newest.deltaTraces ?? [])
+            updateRequestQueue.removeAll(where: { $0 == request })
+        }
+
+        if addCount != addRequestQueue.count || removeCount != removeRequestQueue.count || updateCount != updateRequestQueue.count {
+            OneSignalLog.onesignalLog(.LL_VERBOSE, message: "OSSubscriptionOperationExecutor folded requests, create: \(addCount) -> \(addRequestQueue.count), delete: \(removeCount) -> \(removeRequestQueue.count), update: \(updateCount) -> \(updateRequestQueue.count)")
+        }
+    }
+
     // Bypasses the operation repo to create a push subscription request
     func createPushSubscription(subscriptionModel: OSSubscriptionModel, identityModel: OSIdentityModel) {
         let request = OSRequestCreateSubscription(subscriptionModel: subscriptionModel, identityModel: identityModel)
         self.dispatchQueue.async {
             self.addRequestQueue.append(request)
-            OneSignalUserDefaults.initShared().saveCodeableData(forKey: OS_SUBSCRIPTION_EXECUTOR_ADD_REQUEST_QUEUE_KEY, withValue: self.addRequestQueue)
+            self.addRequests.persist()
         }
     }
 
+    private func requestCompleted(_ key: String, inBackground: Bool) {
+        requestWindow.release(key)
+        processRequestQueue(inBackground: inBackground)
+    }
+
     /// This method is called by `processDeltaQueue` only and does not need to be added to the dispatchQueue.
     func processRequestQueue(inBackground: Bool) {
         let requestQueue: [OneSignalRequest] = addRequestQueue + removeRequestQueue + updateRequestQueue
@@ -253,10 +335,18 @@ class OSSubscriptionOperationExecutor: OSOperationExecutor {
             return
         }
 
+        guard !inBackground || OSBackgroundTaskManager.hasTimeForBackgroundWork() else {
+            OneSignalLog.onesignalLog(.LL_DEBUG, message: "OSSubscriptionOperationExecutor.processRequestQueue leaving requests for the next flush, background time is running out")
+            return
+        }
+
         // Sort the requestQueue by timestamp
         for request in requestQueue.sorted(by: { first, second in
             return first.timestamp < second.timestamp
         }) {
+            guard requestWindow.hasCapacity else {
+                break
+            }
             if request.isKind(of: OSRequestCreateSubscription.self), let createSubscriptionRequest = request as? OSRequestCreateSubscription {
                 executeCreateSubscriptionRequest(createSubscriptionRequest, inBackground: inBackground)
             } else if request.isKind(of: OSRequestDeleteSubscription.self), let deleteSubscriptionRequest = request as? OSRequestDeleteSubscription {
@@ -273,9 +363,15 @@ class OSSubscriptionOperationExecutor: OSOperationExecutor {
         guard !request.sentToClient else {
             return
         }
+        guard !request.isAwaitingNewJwt(request.identityModel) else {
+            return
+        }
         guard request.prepareForExecution(newRecordsState: newRecordsState) else {
             return
         }
+        guard requestWindow.acquire(request.subscriptionModel.modelId) else {
+            return
+        }
         request.sentToClient = true
 
         let backgroundTaskIdentifier = SUBSCRIPTION_EXECUTOR_BACKGROUND_TASK + UUID().uuidString
@@ -287,8 +383,9 @@ class OSSubscriptionOperationExecutor: OSOperationExecutor {
         OneSignalCoreImpl.sharedClient().execute(request) { response in
             // On success, remove request from cache (even if not hydrating model), and hydrate model
             self.dispatchQueue.async {
-                self.addRequestQueue.removeAll(where: { $0 == request})
-                OneSignalUserDefaults.initShared().saveCodeableData(forKey: OS_SUBSCRIPTION_EXECUTOR_ADD_REQUEST_QUEUE_KEY, withValue: self.addRequestQueue)
+                defer { self.requestCompleted(request.subscriptionModel.modelId, inBackground: inBackground) }
+                self.addRequests.complete(request)
+                self.forgetAcknowledgedUpdate(request.subscriptionModel)
 
                 guard let response = response?["subscription"] as? [String: Any] else {
                     OneSignalLog.onesignalLog(.LL_ERROR, message: "Unabled to parse response to create subscription request")
@@ -307,9 +404,15 @@ class OSSubscriptionOperationExecutor: OSOperationExecutor {
                             key: OSIamFetchOffsetKey.subscriptionUpdate,
                             value: OSReadYourWriteData(rywToken: rywToken, rywDelay: rywDelay)
                         )
+                        OSConsistencyManager.shared.setRywTokenAndDelay(
+                            id: onesignalId,
+                            key: OSUserReadOffsetKey.subscriptionUpdate,
+                            value: OSReadYourWriteData(rywToken: rywToken, rywDelay: rywDelay)
+                        )
                     } else {
                         // handle a potential regression where ryw_token is no longer returned by API
                         OSConsistencyManager.shared.resolveConditionsWithID(id: OSIamFetchReadyCondition.CONDITIONID)
+                        OSConsistencyManager.shared.resolveConditionsWithID(id: OSKeyedTokenCondition.SUBSCRIPTION_CONDITIONID)
                     }
                 }
 
@@ -321,10 +424,12 @@ class OSSubscriptionOperationExecutor: OSOperationExecutor {
         } onFailure: { error in
             OneSignalLog.onesignalLog(.LL_ERROR, message: "OSSubscriptionOperationExecutor create subscription request failed with error: \(error.debugDescription)")
             self.dispatchQueue.async {
+                defer { self.requestCompleted(request.subscriptionModel.modelId, inBackground: inBackground) }
                 let responseType = OSNetworkingUtils.getResponseStatusType(error.code)
-                if responseType == .missing {
-                    self.addRequestQueue.removeAll(where: { $0 == request})
-                    OneSignalUserDefaults.initShared().saveCodeableData(forKey: OS_SUBSCRIPTION_EXECUTOR_ADD_REQUEST_QUEUE_KEY, withValue: self.addRequestQueue)
+                if request.awaitNewJwtIfUnauthorized(responseType, identityModel: request.identityModel) {
+                    // Kept in the queue, sent again with the new JWT
+                } else if responseType == .missing {
+                    self.addRequests.complete(request)
                     // Logout if the user in the SDK is the same
                     guard OneSignalUserManagerImpl.sharedInstance.isCurrentUser(request.identityModel)
                     else {
@@ -338,8 +443,7 @@ class OSSubscriptionOperationExecutor: OSOperationExecutor {
                     OneSignalUserManagerImpl.sharedInstance._logout()
                 } else if responseType != .retryable {
                     // Fail, no retry, remove from cache and queue
-                    self.addRequestQueue.removeAll(where: { $0 == request})
-                    OneSignalUserDefaults.initShared().saveCodeableData(forKey: OS_SUBSCRIPTION_EXECUTOR_ADD_REQUEST_QUEUE_KEY, withValue: self.addRequestQueue)
+                    self.addRequests.complete(request)
                 }
                 if inBackground {
                     OSBackgroundTaskManager.endBackgroundTask(backgroundTaskIdentifier)
@@ -355,6 +459,9 @@ class OSSubscriptionOperationExecutor: OSOperationExecutor {
         guard request.prepareForExecution(newRecordsState: newRecordsState) else {
             return
         }
+        guard requestWindow.acquire(request.subscriptionModel.modelId) else {
+            return
+        }
         request.sentToClient = true
 
         let backgroundTaskIdentifier = SUBSCRIPTION_EXECUTOR_BACKGROUND_TASK + UUID().uuidString
@@ -368,8 +475,9 @@ class OSSubscriptionOperationExecutor: OSOperationExecutor {
             // On success, remove request from cache. No model hydration occurs.
             // For example, if app restarts and we read in operations between sending this off and getting the response
             self.dispatchQueue.async {
-                self.removeRequestQueue.removeAll(where: { $0 == request})
-                OneSignalUserDefaults.initShared().saveCodeableData(forKey: OS_SUBSCRIPTION_EXECUTOR_REMOVE_REQUEST_QUEUE_KEY, withValue: self.removeRequestQueue)
+                defer { self.requestCompleted(request.subscriptionModel.modelId, inBackground: inBackground) }
+                self.removeRequests.complete(request)
+                self.forgetAcknowledgedUpdate(request.subscriptionModel)
                 if inBackground {
                     OSBackgroundTaskManager.endBackgroundTask(backgroundTaskIdentifier)
                 }
@@ -377,12 +485,13 @@ class OSSubscriptionOperationExecutor: OSOperationExecutor {
         } onFailure: { error in
             OneSignalLog.onesignalLog(.LL_ERROR, message: "OSSubscriptionOperationExecutor delete subscription request failed with error: \(error.debugDescription)")
             self.dispatchQueue.async {
+                defer { self.requestCompleted(request.subscriptionModel.modelId, inBackground: inBackground) }
                 let responseType = OSNetworkingUtils.getResponseStatusType(error.code)
                 if responseType != .retryable {
                     // Fail, no retry, remove from cache and queue
                     // If this request returns a missing status, that is ok as this is a delete request
-                    self.removeRequestQueue.removeAll(where: { $0 == request})
-                    OneSignalUserDefaults.initShared().saveCodeableData(forKey: OS_SUBSCRIPTION_EXECUTOR_REMOVE_REQUEST_QUEUE_KEY, withValue: self.removeRequestQueue)
+                    self.removeRequests.complete(request)
+                    self.forgetAcknowledgedUpdate(request.subscriptionModel)
                 }
                 if inBackground {
                     OSBackgroundTaskManager.endBackgroundTask(backgroundTaskIdentifier)
@@ -395,9 +504,24 @@ class OSSubscriptionOperationExecutor: OSOperationExecutor {
         guard !request.sentToClient else {
             return
         }
+        if let identityModel = request.identityModel, request.isAwaitingNewJwt(identityModel) {
+            return
+        }
         guard request.prepareForExecution(newRecordsState: newRecordsState) else {
             return
         }
+        let fingerprint = updateFingerprint(request)
+        if let fingerprint = fingerprint,
+           let subscriptionId = request.subscriptionModel.subscriptionId,
+           acknowledgedUpdates[subscriptionId] == fingerprint {
+            OneSignalLog.onesignalLog(.LL_VERBOSE, message: "OSSubscriptionOperationExecutor: skipping update the server already has: \(request)")
+            updateRequests.complete(request)
+            updateSkipped(request)
+            return
+        }
+        guard requestWindow.acquire(request.subscriptionModel.modelId) else {
+            return
+        }
         request.sentToClient = true
 
         let backgroundTaskIdentifier = SUBSCRIPTION_EXECUTOR_BACKGROUND_TASK + UUID().uuidString
@@ -409,14 +533,19 @@ class OSSubscriptionOperationExecutor: OSOperationExecutor {
             // On success, remove request from cache. No model hydration occurs.
             // For example, if app restarts and we read in operations between sending this off and getting the response
             self.dispatchQueue.async {
-                self.updateRequestQueue.removeAll(where: { $0 == request})
-                OneSignalUserDefaults.initShared().saveCodeableData(forKey: OS_SUBSCRIPTION_EXECUTOR_UPDATE_REQUEST_QUEUE_KEY, withValue: self.updateRequestQueue)
+                defer { self.requestCompleted(request.subscriptionModel.modelId, inBackground: inBackground) }
+                self.updateRequests.complete(request)
+                if let fingerprint = fingerprint {
+                    self.rememberAcknowledgedUpdate(request.subscriptionModel, fingerprint: fingerprint)
+                } else {
+                    self.forgetAcknowledgedUpdate(request.subscriptionModel)
+                }
                 if inBackground {
                     OSBackgroundTaskManager.endBackgroundTask(backgroundTaskIdentifier)
                 }
             }
 
-            if let onesignalId = OneSignalUserManagerImpl.sharedInstance.onesignalId {
+            if let onesignalId = request.identityModel?.onesignalId ?? OneSignalUserManagerImpl.sharedInstance.onesignalId {
                 if let rywToken = response?["ryw_token"] as? String
                     {
                         let rywDelay = response?["ryw_delay"] as? NSNumber
@@ -425,19 +554,30 @@ class OSSubscriptionOperationExecutor: OSOperationExecutor {
                             key: OSIamFetchOffsetKey.subscriptionUpdate,
                             value: OSReadYourWriteData(rywToken: rywToken, rywDelay: rywDelay)
                         )
+                        OSConsistencyManager.shared.setRywTokenAndDelay(
+                            id: onesignalId,
+                            key: OSUserReadOffsetKey.subscriptionUpdate,
+                            value: OSReadYourWriteData(rywToken: rywToken, rywDelay: rywDelay)
+                        )
                     } else {
                         // handle a potential regression where ryw_token is no longer returned by API
                         OSConsistencyManager.shared.resolveConditionsWithID(id: OSIamFetchReadyCondition.CONDITIONID)
+                        OSConsistencyManager.shared.resolveConditionsWithID(id: OSKeyedTokenCondition.SUBSCRIPTION_CONDITIONID)
                     }
             }
         } onFailure: { error in
             OneSignalLog.onesignalLog(.LL_ERROR, message: "OSSubscriptionOperationExecutor update subscription request failed with error: \(error.debugDescription)")
             self.dispatchQueue.async {
+                defer { self.requestCompleted(request.subscriptionModel.modelId, inBackground: inBackground) }
                 let responseType = OSNetworkingUtils.getResponseStatusType(error.code)
-                if responseType != .retryable {
+                // The server may have applied part of the update, so the next one is sent even if it matches
+                self.forgetAcknowledgedUpdate(request.subscriptionModel)
+                if let identityModel = request.identityModel,
+                   request.awaitNewJwtIfUnauthorized(responseType, identityModel: identityModel) {
+                    // Kept in the queue, sent again with the new JWT
+                } else if responseType != .retryable {
                     // Fail, no retry, remove from cache and queue
-                    self.updateRequestQueue.removeAll(where: { $0 == request})
-                    OneSignalUserDefaults.initShared().saveCodeableData(forKey: OS_SUBSCRIPTION_EXECUTOR_UPDATE_REQUEST_QUEUE_KEY, withValue: self.updateRequestQueue)
+                    self.updateRequests.complete(request)
                 }
                 if inBackground {
                     OSBackgroundTaskManager.endBackgroundTask(backgroundTaskIdentifier)
@@ -445,4 +585,60 @@ class OSSubscriptionOperationExecutor: OSOperationExecutor {
             }
         }
     }
+
+    /**
+     A fingerprint of the update's payload, nil if it cannot be serialized. The payload always includes the token,
+     device and app metadata, and the enabled state, so an equal fingerprint means the update would change nothing.
+     */
+    private func updateFingerprint(_ request: OSRequestUpdateSubscription) -> String? {
+        guard let payload = request.parameters?["subscription"] as? [String: Any],
+              JSONSerialization.isValidJSONObject(payload),
+              let data = try? JSONSerialization.data(withJSONObject: payload, options: [.sortedKeys]),
+              let json = String(data: data, encoding: .utf8)
+        else {
+            return nil
+        }
+        return OneSignalCoreHelper.hash(usingSha1: json)
+    }
+
+    /// Records the fingerprint of an update the server acknowledged, replacing the subscription's previous one.
+    private func rememberAcknowledgedUpdate(_ subscriptionModel: OSSubscriptionModel, fingerprint: String) {
+        guard let subscriptionId = subscriptionModel.subscriptionId else {
+            return
+        }
+        acknowledgedUpdates[subscriptionId] = fingerprint
+        OneSignalUserDefaults.initShared().saveDictionary(forKey: OS_SUBSCRIPTION_EXECUTOR_ACKNOWLEDGED_UPDATES_KEY, withValue: acknowledgedUpdates)
+    }
+
+    /// Drops the subscription's fingerprint once another request for it completes, after which the server's copy is no longer known.
+    private func forgetAcknowledgedUpdate(_ subscriptionModel: OSSubscriptionModel) {
+        guard let subscriptionId = subscriptionModel.subscriptionId,
+              acknowledgedUpdates.removeValue(forKey: subscriptionId) != nil
+        else {
+            return
+        }
+        OneSignalUserDefaults.initShared().saveDictionary(forKey: OS_SUBSCRIPTION_EXECUTOR_ACKNOWLEDGED_UPDATES_KEY, withValue: acknowledgedUpdates)
+    }
+
+    /**
+     Releases what waits on the RYW token of a subscription update that was not sent, for the user the update was made for.
+     Nothing waits on it once that user is no longer the current one, their IAM fetch condition was replaced at login.
+     If another update for that user is still queued, its response sets the token instead, so nothing is released yet.
+     */
+    private func updateSkipped(_ request: OSRequestUpdateSubscription) {
+        guard let onesignalId = request.identityModel?.onesignalId ?? OneSignalUserManagerImpl.sharedInstance.onesignalId,
+              onesignalId == OneSignalUserManagerImpl.sharedInstance.onesignalId
+        else {
+            return
+        }
+        let hasQueuedUpdate = updateRequestQueue.contains { queued in
+            (queued.identityModel?.onesignalId ?? OneSignalUserManagerImpl.sharedInstance.onesignalId) == onesignalId
+        }
+        guard !hasQueuedUpdate else {
+            return
+        }
+        OSIamFetchReadyCondition.sharedInstance(withId: onesignalId).setSubscriptionUpdatePending(value: false)
+        OSConsistencyManager.shared.recheckConditions(forId: onesignalId)
+        OSConsistencyManager.shared.resolveConditionsWithID(id: OSKeyedTokenCondition.SUBSCRIPTION_CONDITIONID)
+    }
 }
@@ -35,17 +35,40 @@ import OneSignalOSCore
  */
 class OSUserExecutor {
     var userRequestQueue: [OSUserRequest] = []
+    /**
+     `userRequestQueue` is persisted as a log: the queue at the last compaction under `OS_USER_EXECUTOR_USER_REQUEST_QUEUE_KEY`,
+     the requests appended since under `OS_USER_EXECUTOR_APPENDED_REQUESTS_KEY`, and the log positions of requests completed since
+     under `OS_USER_EXECUTOR_COMPLETED_REQUESTS_KEY`. Completing a request then only saves its position instead of re-archiving
+     the queue, and the log is compacted back into one list when the queue drains and on the next launch.
+     */
+    private var requestLog: [OSUserRequest] = []
+    private var compactedCount = 0
+    private var completedPositions: [Int] = []
+    /// Set while a delayed flush is pending, so that blocked partitions don't stack up retries. Read and written on the dispatch queue.
+    private var delayedFlushScheduled = false
+    /// The start time a flush is scheduled for, of the earliest request held by `notBefore`. Read and written on the dispatch queue.
+    private var heldRequestFlushTime: Date?
     private let newRecordsState: OSNewRecordsState
     /// Delay by the "cool down" period plus a buffer of a set amount of milliseconds
     private let flushDelayMilliseconds = Int(OP_REPO_POST_CREATE_DELAY_SECONDS * 1_000 + 200) // TODO: This could come from a config, plist, method, remote params
 
     /// The User executor dispatch queue, serial. This synchronizes access to the request queues.
-    private let dispatchQueue = DispatchQueue(label: "OneSignal.OSUserExecutor", target: .global())
+    /// Login and user creation are waited on by the app, so this runs ahead of the other executors.
+    let dispatchQueue = DispatchQueue(label: "OneSignal.OSUserExecutor", target: OSDispatchQueues.userInitiated) // non-private for unit test access
+    // Schedules the delayed flushes, which must run on the `dispatchQueue`. Tests replace it to control time.
+    lazy var scheduler: OSDispatchQueue = dispatchQueue // non-private for unit test access
+    /// Pending property updates for a user about to be created are fused into its Create User request, see `fusePendingUpdates`.
+    weak var propertyExecutor: OSPropertyOperationExecutor?
 
     init(newRecordsState: OSNewRecordsState) {
         self.newRecordsState = newRecordsState
-        uncacheUserRequests()
-        migrateTransferSubscriptionRequests()
+        OSTrace.measure(.cacheLoad, name: "OSUserExecutor") {
+            uncacheUserRequests()
+        }
+        // Migrating is not needed to start up, and only reads from storage when upgrading from an older version
+        dispatchQueue.async {
+            self.migrateTransferSubscriptionRequests()
+        }
         executePendingRequests()
     }
 
@@ -54,7 +77,7 @@ class OSUserExecutor {
         var userRequestQueue: [OSUserRequest] = []
 
         // Read unfinished Create User + Identify User + Get Identity By Subscription requests from cache, if any...
-        if let cachedRequestQueue = OneSignalUserDefaults.initShared().getSavedCodeableData(forKey: OS_USER_EXECUTOR_USER_REQUEST_QUEUE_KEY, defaultValue: []) as? [OSUserRequest] {
+        if let cachedRequestQueue = readRequestLog() {
             // Hook each uncached Request to the right model reference
             for request in cachedRequestQueue {
                 if request.isKind(of: OSRequestFetchIdentityBySubscription.self), let req = request as? OSRequestFetchIdentityBySubscription {
@@ -106,11 +129,33 @@ class OSUserExecutor {
             }
         }
         self.userRequestQueue = userRequestQueue
-        OneSignalUserDefaults.initShared().saveCodeableData(forKey: OS_USER_EXECUTOR_USER_REQUEST_QUEUE_KEY, withValue: self.userRequestQueue)
+        compactRequestLog()
+    }
+
+    /// Replays the persisted request log, leaving out requests that completed.
+    private func readRequestLog() -> [OSUserRequest]? {
+        let sharedUserDefaults = OneSignalUserDefaults.initShared()
+        guard let compactedRequests = sharedUserDefaults.getSavedCodeableData(forKey: OS_USER_EXECUTOR_USER_REQUEST_QUEUE_KEY, defaultValue: []) as? [OSUserRequest] else {
+            return nil
+        }
+        let appendedRequests = sharedUserDefaults.getSavedCodeableData(forKey: OS_USER_EXECUTOR_APPENDED_REQUESTS_KEY, defaultValue: []) as? [OSUserRequest] ?? []
+        let completedPositions = Set(sharedUserDefaults.getSavedObject(forKey: OS_USER_EXECUTOR_COMPLETED_REQUESTS_KEY, defaultValue: []) as? [Int] ?? [])
+        return (compactedRequests + appendedRequests).enumerated().filter { !completedPositions.contains($0.offset) }.map { $0.element }
+    }
+
+    /// Rewrites the log as the current queue alone. Called on the dispatch queue, or from init.
+    private func compactRequestLog() {
+        requestLog = userRequestQueue
+        compactedCount = requestLog.count
+        completedPositions = []
+        let sharedUserDefaults = OneSignalUserDefaults.initShared()
+        sharedUserDefaults.saveCodeableData(forKey: OS_USER_EXECUTOR_USER_REQUEST_QUEUE_KEY, withValue: userRequestQueue)
+        sharedUserDefaults.removeValue(forKey: OS_USER_EXECUTOR_APPENDED_REQUESTS_KEY)
+        sharedUserDefaults.removeValue(forKey: OS_USER_EXECUTOR_COMPLETED_REQUESTS_KEY)
     }
 
     /**
-     Read Transfer Subscription requests from cache, if any.
+     Read Transfer Subscription requests from cache, if any. Called on the dispatch queue.
      As of `5.2.3`, the SDK will no longer send Transfer Subscription requests, so migrate the request into an equivalent Create User request.
      */
     private func migrateTransferSubscriptionRequests() {
@@ -135,15 +180,30 @@ class OSUserExecutor {
 
     func appendToQueue(_ request: OSUserRequest) {
         self.dispatchQueue.async {
-            self.userRequestQueue.append(request)
-            OneSignalUserDefaults.initShared().saveCodeableData(forKey: OS_USER_EXECUTOR_USER_REQUEST_QUEUE_KEY, withValue: self.userRequestQueue)
+            self._appendToQueue(request)
         }
     }
 
+    /// Must be called on the dispatch queue.
+    private func _appendToQueue(_ request: OSUserRequest) {
+        userRequestQueue.append(request)
+        requestLog.append(request)
+        OneSignalUserDefaults.initShared().saveCodeableData(forKey: OS_USER_EXECUTOR_APPENDED_REQUESTS_KEY, withValue: Array(requestLog[compactedCount...]))
+    }
+
     func removeFromQueue(_ request: OSUserRequest) {
         self.dispatchQueue.async {
             self.userRequestQueue.removeAll(where: { $0 == request})
-            OneSignalUserDefaults.initShared().saveCodeableData(forKey: OS_USER_EXECUTOR_USER_REQUEST_QUEUE_KEY, withValue: self.userRequestQueue)
+            if self.userRequestQueue.isEmpty {
+                // Idle, nothing is left to replay
+                self.compactRequestLog()
+                return
+            }
+            guard let position = self.requestLog.indices.first(where: { self.requestLog[$0] == request && !self.completedPositions.contains($0) }) else {
+                return
+            }
+            self.completedPositions.append(position)
+            OneSignalUserDefaults.initShared().saveObject(forKey: OS_USER_EXECUTOR_COMPLETED_REQUESTS_KEY, withValue: self.completedPositions)
         }
     }
 
@@ -152,8 +212,15 @@ class OSUserExecutor {
      */
     func executePendingRequests(withDelay: Bool = false) {
         if withDelay {
-            self.dispatchQueue.asyncAfter(deadline: .now() + .milliseconds(flushDelayMilliseconds)) { [weak self] in
-                self?._executePendingRequests()
+            self.dispatchQueue.async {
+                guard !self.delayedFlushScheduled else {
+                    return
+                }
+                self.delayedFlushScheduled = true
+                self.scheduler.asyncAfterTime(deadline: .now() + .milliseconds(self.flushDelayMilliseconds)) { [weak self] in
+                    self?.delayedFlushScheduled = false
+                    self?._executePendingRequests()
+                }
             }
         } else {
             self.dispatchQueue.async {
@@ -162,34 +229,119 @@ class OSUserExecutor {
         }
     }
 
+    /**
+     The queue is partitioned by the identity models the requests touch. Requests that share an identity model run in queue order,
+     so a user is created before it is identified or fetched, but a request that cannot execute yet only blocks its own partition.
+     Requests that decide which user owns the push subscription also share one partition, so they keep their queue order across users.
+     */
     private func _executePendingRequests() {
         OneSignalLog.onesignalLog(.LL_VERBOSE, message: "OSUserExecutor.executePendingRequests called with queue \(self.userRequestQueue)")
 
+        var claimedPartitions = Set<String>()
+        var isBlocked = false
+        var earliestHeldStart: Date?
+        let now = Date()
+
         for request in self.userRequestQueue {
-            // Return as soon as we reach an un-executable request
+            // A migration held until its start time keeps its own user's order, but does not hold up the push subscription partition
+            if let fetchIdentityRequest = request as? OSRequestFetchIdentityBySubscription,
+               let notBefore = fetchIdentityRequest.notBefore, notBefore > now {
+                claimedPartitions.insert(fetchIdentityRequest.identityModel.modelId)
+                earliestHeldStart = min(earliestHeldStart ?? notBefore, notBefore)
+                continue
+            }
+
+            let partitions = partitionKeys(request)
+            // An earlier request for the same user or the push subscription has not finished
+            guard claimedPartitions.isDisjoint(with: partitions) else {
+                continue
+            }
+            claimedPartitions.formUnion(partitions)
+
+            if request.sentToClient {
+                continue
+            }
+
+            // Its user is waiting for a new JWT, resuming the operation repo executes the queue again
+            if let identityModel = jwtIdentityModel(request), request.isAwaitingNewJwt(identityModel) {
+                continue
+            }
+
             guard request.prepareForExecution(newRecordsState: self.newRecordsState)
             else {
-                OneSignalLog.onesignalLog(.LL_WARN, message: "OSUserExecutor.executePendingRequests() is blocked by unexecutable request \(request)")
-                executePendingRequests(withDelay: true)
-                return
+                OneSignalLog.onesignalLog(.LL_WARN, message: "OSUserExecutor.executePendingRequests() partition is blocked by unexecutable request \(request)")
+                isBlocked = true
+                continue
             }
 
             if request.isKind(of: OSRequestFetchIdentityBySubscription.self), let fetchIdentityRequest = request as? OSRequestFetchIdentityBySubscription {
                 self.executeFetchIdentityBySubscriptionRequest(fetchIdentityRequest)
-                return
             } else if request.isKind(of: OSRequestCreateUser.self), let createUserRequest = request as? OSRequestCreateUser {
                 self.executeCreateUserRequest(createUserRequest)
-                return
             } else if request.isKind(of: OSRequestIdentifyUser.self), let identifyUserRequest = request as? OSRequestIdentifyUser {
                 self.executeIdentifyUserRequest(identifyUserRequest)
-                return
             } else if request.isKind(of: OSRequestFetchUser.self), let fetchUserRequest = request as? OSRequestFetchUser {
                 self.executeFetchUserRequest(fetchUserRequest)
-                return
             } else {
                 OneSignalLog.onesignalLog(.LL_ERROR, message: "OSUserExecutor met incompatible Request type that cannot be executed.")
             }
         }
+
+        if isBlocked {
+            executePendingRequests(withDelay: true)
+        }
+        if let earliestHeldStart = earliestHeldStart {
+            scheduleFlush(at: earliestHeldStart)
+        }
+    }
+
+    /// Schedules one flush for the start time of the earliest held request, unless one is already scheduled by then.
+    private func scheduleFlush(at startTime: Date) {
+        if let heldRequestFlushTime = heldRequestFlushTime, heldRequestFlushTime <= startTime {
+            return
+        }
+        heldRequestFlushTime = startTime
+        OneSignalLog.onesignalLog(.LL_DEBUG, message: "OSUserExecutor holding a request until \(startTime)")
+        let delayMilliseconds = Int(max(startTime.timeIntervalSinceNow, 0) * 1_000)
+        self.scheduler.asyncAfterTime(deadline: .now() + .milliseconds(delayMilliseconds)) { [weak self] in
+            guard let self = self, self.heldRequestFlushTime == startTime else {
+                return
+            }
+            self.heldRequestFlushTime = nil
+            self._executePendingRequests()
+        }
+    }
+
+    /// Shared by the requests that move the push subscription between users: Create User with the subscription, which also
+    /// replaces a persisted Transfer Subscription, Identify User, and Fetch Identity By Subscription.
+    private static let pushSubscriptionPartition = "push_subscription"
+
+    /// The identity model whose JWT authorizes the request, for Identify User it is the user being identified.
+    private func jwtIdentityModel(_ request: OSUserRequest) -> OSIdentityModel? {
+        if let request = request as? OSRequestIdentifyUser {
+            return request.identityModelToUpdate
+        } else if let request = request as? OSRequestCreateUser {
+            return request.identityModel
+        } else if let request = request as? OSRequestFetchUser {
+            return request.identityModel
+        } else if let request = request as? OSRequestFetchIdentityBySubscription {
+            return request.identityModel
+        }
+        return nil
+    }
+
+    /// The model IDs of the identity models a request reads or hydrates, and the push subscription partition if it uses it.
+    private func partitionKeys(_ request: OSUserRequest) -> Set<String> {
+        if let request = request as? OSRequestIdentifyUser {
+            return [request.identityModelToIdentify.modelId, request.identityModelToUpdate.modelId, Self.pushSubscriptionPartition]
+        } else if let request = request as? OSRequestCreateUser {
+            return request.pushSubscriptionModel != nil ? [request.identityModel.modelId, Self.pushSubscriptionPartition] : [request.identityModel.modelId]
+        } else if let request = request as? OSRequestFetchUser {
+            return [request.identityModel.modelId]
+        } else if let request = request as? OSRequestFetchIdentityBySubscription {
+            return [request.identityModel.modelId, Self.pushSubscriptionPartition]
+        }
+        return []
     }
 }
 
@@ -232,10 +384,12 @@ extension OSUserExecutor {
             return
         }
 
+        fusePendingUpdates(into: request)
         request.sentToClient = true
 
         OneSignalCoreImpl.sharedClient().execute(request) { response in
             self.removeFromQueue(request)
+            request.callFusedCompletionHandlers(success: true)
 
             // Create User's response won't send us the user's complete info if this user already exists
             if let response = response {
@@ -250,7 +404,9 @@ extension OSUserExecutor {
 
                 // If this user already exists and we logged into an external_id, fetch the user data
                 // Fetch the user only if its the current user and non-anonymous
-                if OneSignalUserManagerImpl.sharedInstance.isCurrentUser(request.identityModel),
+                // A 201 means the server created the user from this payload, so there is nothing else to fetch
+                if request.responseStatusCode != 201,
+                   OneSignalUserManagerImpl.sharedInstance.isCurrentUser(request.identityModel),
                    let identity = request.parameters?["identity"] as? [String: String],
                    let onesignalId = request.identityModel.onesignalId,
                    identity[OS_EXTERNAL_ID] != nil {
@@ -284,12 +440,38 @@ extension OSUserExecutor {
                 // We will retry this request on a new session
                 OSOperationRepo.sharedInstance.paused = true
                 request.sentToClient = false
+                // The fused payload is sent again, but like the requests it replaced the completion handlers are not kept
+                request.callFusedCompletionHandlers(success: false)
             }
         }
     }
 
-    func fetchIdentityBySubscription(_ user: OSUserInternal) {
+    /**
+     Moves property updates waiting on the OneSignal ID of a user being created into its Create User request.
+     These requests are otherwise sent as their own round trip right after the user is created.
+     The request log is rewritten so the fused request replaces the persisted one. Called on the dispatch queue.
+     */
+    private func fusePendingUpdates(into request: OSRequestCreateUser) {
+        guard request.canFuseUpdates,
+              let updates = propertyExecutor?.takeFusableRequests(identityModelId: request.identityModel.modelId),
+              !updates.isEmpty
+        else {
+            return
+        }
+        request.fuse(updates)
+        compactRequestLog()
+        OneSignalLog.onesignalLog(.LL_DEBUG, message: "OSUserExecutor fused \(updates.count) update properties requests into \(request)")
+    }
+
+    /**
+     Fetches the user the push subscription belongs to. A migration from a legacy player passes a `maxJitter`, so the devices of
+     an upgrade wave start their requests at random points of that window instead of all on their first launch.
+     */
+    func fetchIdentityBySubscription(_ user: OSUserInternal, maxJitter: TimeInterval = 0) {
         let request = OSRequestFetchIdentityBySubscription(identityModel: user.identityModel, pushSubscriptionModel: user.pushSubscriptionModel)
+        if maxJitter > 0 {
+            request.notBefore = Date(timeIntervalSinceNow: TimeInterval.random(in: 0...maxJitter))
+        }
 
         appendToQueue(request)
         executePendingRequests()
@@ -403,6 +585,8 @@ extension OSUserExecutor {
                     // This will hydrate the OneSignal ID for any pending requests
                     self.createUser(aliasLabel: request.aliasLabel, aliasId: request.aliasId, identityModel: request.identityModelToUpdate)
                 }
+            } else if request.awaitNewJwtIfUnauthorized(responseType, identityModel: request.identityModelToUpdate) {
+                // Kept in the queue, sent again with the new JWT
             } else if responseType == .invalid || responseType == .unauthorized {
                 // Failed, no retry
                 self.removeFromQueue(request)
@@ -422,10 +606,28 @@ extension OSUserExecutor {
         }
     }
 
+    /**
+     Queues a fetch of the user, unless an unsent fetch of the same user is already queued, which will download the same document.
+     A fetch on a new session is only merged into another fetch on a new session, as it also checks the push subscription still exists.
+     */
     func fetchUser(aliasLabel: String, aliasId: String, identityModel: OSIdentityModel, onNewSession: Bool = false) {
-        let request = OSRequestFetchUser(identityModel: identityModel, aliasLabel: aliasLabel, aliasId: aliasId, onNewSession: onNewSession)
-
-        appendToQueue(request)
+        self.dispatchQueue.async {
+            let pending = self.userRequestQueue.contains { request in
+                guard let fetch = request as? OSRequestFetchUser else {
+                    return false
+                }
+                return !fetch.sentToClient &&
+                    fetch.aliasLabel == aliasLabel &&
+                    fetch.aliasId == aliasId &&
+                    fetch.identityModel.modelId == identityModel.modelId &&
+                    (fetch.onNewSession || !onNewSession)
+            }
+            if pending {
+                OneSignalLog.onesignalLog(.LL_VERBOSE, message: "OSUserExecutor.fetchUser merged into the pending fetch of \(aliasLabel): \(aliasId)")
+                return
+            }
+            self._appendToQueue(OSRequestFetchUser(identityModel: identityModel, aliasLabel: aliasLabel, aliasId: aliasId, onNewSession: onNewSession))
+        }
 
         // User fetch will always be called after a delay unless it is to refresh the user state on a new session
         executePendingRequests(withDelay: !onNewSession)
@@ -38,25 +38,37 @@ class OSIdentityModel: OSModel {
         return internalGetAlias(OS_EXTERNAL_ID)
     }
 
-    // All access to aliases should go through helper methods with locking
-    var aliases: [String: String] = [:]
+    // All access to aliases should go through helper methods with locking, reads return a snapshot
+    private var _aliases: [String: String] = [:]
     private let aliasesLock = NSRecursiveLock()
 
+    var aliases: [String: String] {
+        aliasesLock.withLock { _aliases }
+    }
+
     // TODO: We need to make this token secure
-    public var jwtBearerToken: String?
+    private var _jwtBearerToken: String?
+    public var jwtBearerToken: String? {
+        get {
+            aliasesLock.withLock { _jwtBearerToken }
+        }
+        set {
+            aliasesLock.withLock { _jwtBearerToken = newValue }
+        }
+    }
 
     // MARK: - Initialization
 
     // Initialize with aliases, if any
     init(aliases: [String: String]?, changeNotifier: OSEventProducer<OSModelChangedHandler>) {
         super.init(changeNotifier: changeNotifier)
-        self.aliases = aliases ?? [:]
+        self._aliases = aliases ?? [:]
     }
 
     override func encode(with coder: NSCoder) {
         aliasesLock.withLock {
             super.encode(with: coder)
-            coder.encode(aliases, forKey: "aliases")
+            coder.encode(_aliases, forKey: "aliases")
         }
     }
 
@@ -66,13 +78,13 @@ class OSIdentityModel: OSModel {
             // log error
             return nil
         }
-        self.aliases = aliases
+        self._aliases = aliases
     }
 
     /** Threadsafe getter for an alias */
     private func internalGetAlias(_ label: String) -> String? {
         aliasesLock.withLock {
-            return self.aliases[label]
+            return self._aliases[label]
         }
     }
 
@@ -81,7 +93,7 @@ class OSIdentityModel: OSModel {
         aliasesLock.withLock {
             for (label, id) in aliases {
                 // Remove the alias if the ID field is ""
-                self.aliases[label] = id.isEmpty ? nil : id
+                self._aliases[label] = id.isEmpty ? nil : id
             }
         }
         self.set(property: "aliases", newValue: aliases)
@@ -92,7 +104,7 @@ class OSIdentityModel: OSModel {
      */
     func clearData() {
         aliasesLock.withLock {
-            self.aliases = [:]
+            self._aliases = [:]
         }
     }
 
@@ -119,7 +131,14 @@ class OSIdentityModel: OSModel {
         let newOnesignalId = remoteAliases[OS_ONESIGNAL_ID]
         let newExternalId = remoteAliases[OS_EXTERNAL_ID]
 
-        internalAddAliases(remoteAliases)
+        // A fetch usually returns the aliases already on the model, only apply the ones that differ so nothing is persisted for a no-op
+        let currentAliases = aliases
+        let changedAliases = remoteAliases.filter { label, id in
+            currentAliases[label] != (id.isEmpty ? nil : id)
+        }
+        if !changedAliases.isEmpty {
+            internalAddAliases(changedAliases)
+        }
         fireUserStateChanged(newOnesignalId: newOnesignalId, newExternalId: newExternalId)
     }
 
@@ -50,30 +50,83 @@ class OSLocationPoint: NSObject, NSCoding {
     }
 }
 
+/**
+ An immutable view of a user's tags, published whenever they change so readers share one dictionary instead of copying it.
+ Versions increase across every properties model, so a reader can skip work when the version it last saw is unchanged.
+ */
+@objc
+public final class OSTagsSnapshot: NSObject {
+    private static let versionLock = NSLock()
+    private static var lastVersion = 0
+
+    @objc public let tags: NSDictionary
+    @objc public let version: Int
+
+    init(tags: [String: String]) {
+        self.tags = NSDictionary(dictionary: tags)
+        self.version = OSTagsSnapshot.versionLock.withLock {
+            OSTagsSnapshot.lastVersion += 1
+            return OSTagsSnapshot.lastVersion
+        }
+    }
+}
+
 class OSPropertiesModel: OSModel {
-    var language: String? {
+    // All access to stored properties goes through the `propertiesLock`, reads return a snapshot
+    private var _language: String?
+    private var _location: OSLocationPoint?
+    private var _tags: [String: String] = [:] {
         didSet {
-            self.set(property: "language", newValue: language)
+            _tagsSnapshot = nil
+        }
+    }
+    // Built lazily on the first read after a change, so a burst of tag changes publishes one snapshot
+    private var _tagsSnapshot: OSTagsSnapshot?
+    private let propertiesLock = NSRecursiveLock()
+
+    var language: String? {
+        get {
+            propertiesLock.withLock { _language }
+        }
+        set {
+            propertiesLock.withLock { _language = newValue }
+            self.set(property: "language", newValue: newValue)
         }
     }
 
     var location: OSLocationPoint? {
-        didSet {
-            self.set(property: "location", newValue: location)
+        get {
+            propertiesLock.withLock { _location }
+        }
+        set {
+            propertiesLock.withLock { _location = newValue }
+            self.set(property: "location", newValue: newValue)
         }
     }
 
-    var timezoneId = TimeZone.current.identifier
+    let timezoneId = TimeZone.current.identifier
+
+    var tags: [String: String] {
+        propertiesLock.withLock { _tags }
+    }
 
-    var tags: [String: String] = [:]
-    private let tagsLock = NSRecursiveLock()
+    var tagsSnapshot: OSTagsSnapshot {
+        propertiesLock.withLock {
+            if let snapshot = _tagsSnapshot {
+                return snapshot
+            }
+            let snapshot = OSTagsSnapshot(tags: _tags)
+            _tagsSnapshot = snapshot
+            return snapshot
+        }
+    }
 
     // MARK: - Initialization
 
     // We seem to lose access to this init() in superclass after adding init?(coder: NSCoder)
     override init(changeNotifier: OSEventProducer<OSModelChangedHandler>) {
         super.init(changeNotifier: changeNotifier)
-        self.language = getPreferredLanguage()
+        self._language = getPreferredLanguage()
     }
 
     private func getPreferredLanguage() -> String {
@@ -86,22 +139,22 @@ class OSPropertiesModel: OSModel {
     }
 
     override func encode(with coder: NSCoder) {
-        tagsLock.withLock {
+        propertiesLock.withLock {
             super.encode(with: coder)
-            coder.encode(language, forKey: "language")
-            coder.encode(tags, forKey: "tags")
+            coder.encode(_language, forKey: "language")
+            coder.encode(_tags, forKey: "tags")
             // ... and more
         }
     }
 
     required init?(coder: NSCoder) {
         super.init(coder: coder)
-        language = coder.decodeObject(forKey: "language") as? String
+        _language = coder.decodeObject(forKey: "language") as? String
         guard let tags = coder.decodeObject(forKey: "tags") as? [String: String] else {
             // log error
             return
         }
-        self.tags = tags
+        self._tags = tags
 
         // ... and more
     }
@@ -111,17 +164,17 @@ class OSPropertiesModel: OSModel {
      */
     func clearData() {
         // TODO: What about language, lat, long?
-        tagsLock.withLock {
-            self.tags = [:]
+        propertiesLock.withLock {
+            self._tags = [:]
         }
     }
 
     // MARK: - Tag Methods
 
     func addTags(_ tags: [String: String]) {
-        tagsLock.withLock {
+        propertiesLock.withLock {
             for (key, value) in tags {
-                self.tags[key] = value
+                self._tags[key] = value
             }
         }
         self.set(property: "tags", newValue: tags)
@@ -129,9 +182,9 @@ class OSPropertiesModel: OSModel {
 
     func removeTags(_ tags: [String]) {
         var tagsToSend: [String: String] = [:]
-        tagsLock.withLock {
+        propertiesLock.withLock {
             for tag in tags {
-                self.tags.removeValue(forKey: tag)
+                self._tags.removeValue(forKey: tag)
                 tagsToSend[tag] = ""
             }
         }
@@ -139,17 +192,29 @@ class OSPropertiesModel: OSModel {
     }
 
     public override func hydrateModel(_ response: [String: Any]) {
+        var tagsChanged = false
         for property in response {
             switch property.key {
             case "language":
-                self.language = property.value as? String
+                // Setting the language persists the model, skip it when the server has the same value
+                let language = property.value as? String
+                if language != self.language {
+                    self.language = language
+                }
             case "tags":
-                tagsLock.withLock {
-                    self.tags = property.value as? [String: String] ?? [:]
+                let tags = property.value as? [String: String] ?? [:]
+                propertiesLock.withLock {
+                    tagsChanged = self._tags != tags
+                    if tagsChanged {
+                        self._tags = tags
+                    }
                 }
             default:
                 OneSignalLog.onesignalLog(.LL_DEBUG, message: "Not hydrating properties model for property: \(property)")
             }
         }
+        if tagsChanged {
+            NotificationCenter.default.post(name: Notification.Name(OS_ON_USER_TAGS_DID_CHANGE), object: nil)
+        }
     }
 }
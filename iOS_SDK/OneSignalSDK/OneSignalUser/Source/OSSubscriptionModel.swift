@@ -98,14 +98,60 @@ enum OSSubscriptionType: String {
  Internal subscription model.
  */
 class OSSubscriptionModel: OSModel {
-    var type: OSSubscriptionType
+    /**
+     All stored properties live in `state` and are accessed under the `stateLock`. Setters swap the value in under the lock
+     and then run their side effects, such as firing change notifications, outside of it. Reads return a snapshot.
+     */
+    private struct State {
+        var type: OSSubscriptionType
+        var address: String?
+        var subscriptionId: String?
+        var notificationTypes = -1
+        var reachable: Bool
+        var isDisabled: Bool
+        var testType: Int?
+        var deviceOs = UIDevice.current.systemVersion
+        var sdk = ONESIGNAL_VERSION
+        var deviceModel: String? = OSDeviceUtils.getDeviceVariant()
+        var appVersion: String? = Bundle.main.infoDictionary?["CFBundleShortVersionString"] as? String
+        var netType: Int? = OSNetworkingUtils.getNetType() as? Int
+    }
+
+    private var state: State
+    private let stateLock = NSRecursiveLock()
+
+    private func read<T>(_ keyPath: KeyPath<State, T>) -> T {
+        stateLock.withLock { state[keyPath: keyPath] }
+    }
+
+    /// Stores the new value and returns the previous one.
+    private func exchange<T>(_ keyPath: WritableKeyPath<State, T>, _ newValue: T) -> T {
+        stateLock.withLock {
+            let oldValue = state[keyPath: keyPath]
+            state[keyPath: keyPath] = newValue
+            return oldValue
+        }
+    }
+
+    var type: OSSubscriptionType {
+        get {
+            read(\.type)
+        }
+        set {
+            _ = exchange(\.type, newValue)
+        }
+    }
 
     var address: String? { // This is token on push subs so must remain Optional
-        didSet {
-            guard address != oldValue else {
+        get {
+            read(\.address)
+        }
+        set {
+            let oldValue = exchange(\.address, newValue)
+            guard newValue != oldValue else {
                 return
             }
-            self.set(property: "address", newValue: address)
+            self.set(property: "address", newValue: newValue)
 
             guard self.type == .push else {
                 return
@@ -119,18 +165,22 @@ class OSSubscriptionModel: OSModel {
 
     // Set via server response
     var subscriptionId: String? {
-        didSet {
-            guard subscriptionId != oldValue else {
+        get {
+            read(\.subscriptionId)
+        }
+        set {
+            let oldValue = exchange(\.subscriptionId, newValue)
+            guard newValue != oldValue else {
                 return
             }
-            self.set(property: "subscriptionId", newValue: subscriptionId)
+            self.set(property: "subscriptionId", newValue: newValue)
 
             guard self.type == .push else {
                 return
             }
 
             // Cache the subscriptionId as it persists across users on the device??
-            OneSignalUserDefaults.initShared().saveString(forKey: OSUD_PUSH_SUBSCRIPTION_ID, withValue: subscriptionId)
+            OneSignalUserDefaults.initShared().saveString(forKey: OSUD_PUSH_SUBSCRIPTION_ID, withValue: newValue)
 
             firePushSubscriptionChanged(.subscriptionId(oldValue))
         }
@@ -139,32 +189,38 @@ class OSSubscriptionModel: OSModel {
     // Internal property to send to server, not meant for outside access
     var enabled: Bool { // Does not consider subscription_id in the calculation
         get {
-            return calculateIsEnabled(address: address, reachable: _reachable, isDisabled: _isDisabled)
+            let state = stateLock.withLock { self.state }
+            return calculateIsEnabled(address: state.address, reachable: state.reachable, isDisabled: state.isDisabled)
         }
     }
 
     var optedIn: Bool {
         // optedIn = permission + userPreference
         get {
-            return calculateIsOptedIn(reachable: _reachable, isDisabled: _isDisabled)
+            let state = stateLock.withLock { self.state }
+            return calculateIsOptedIn(reachable: state.reachable, isDisabled: state.isDisabled)
         }
     }
 
     // Push Subscription Only
     // Initialize to be -1, so not to deal with unwrapping every time, and simplifies caching
-    var notificationTypes = -1 {
-        didSet {
-            guard self.type == .push && notificationTypes != oldValue else {
+    var notificationTypes: Int {
+        get {
+            read(\.notificationTypes)
+        }
+        set {
+            let oldValue = exchange(\.notificationTypes, newValue)
+            guard self.type == .push && newValue != oldValue else {
                 return
             }
 
             // If _isDisabled is set, this supersedes as the value to send to server.
-            if _isDisabled && notificationTypes != -2 {
+            if _isDisabled && newValue != -2 {
                 notificationTypes = -2
                 return
             }
-            _reachable = notificationTypes > 0
-            self.set(property: "notificationTypes", newValue: notificationTypes)
+            _reachable = newValue > 0
+            self.set(property: "notificationTypes", newValue: newValue)
         }
     }
 
@@ -175,8 +231,12 @@ class OSSubscriptionModel: OSModel {
      Note that this property reflects the `reachable` property of a permission state. As provisional permission is considered to be `optedIn` and `enabled`.
      */
     var _reachable: Bool {
-        didSet {
-            guard self.type == .push && _reachable != oldValue else {
+        get {
+            read(\.reachable)
+        }
+        set {
+            let oldValue = exchange(\.reachable, newValue)
+            guard self.type == .push && newValue != oldValue else {
                 return
             }
             firePushSubscriptionChanged(.reachable(oldValue))
@@ -185,8 +245,12 @@ class OSSubscriptionModel: OSModel {
 
     // Set by the app developer when they call User.pushSubscription.optOut()
     var _isDisabled: Bool { // Default to false for all subscriptions
-        didSet {
-            guard self.type == .push && _isDisabled != oldValue else {
+        get {
+            read(\.isDisabled)
+        }
+        set {
+            let oldValue = exchange(\.isDisabled, newValue)
+            guard self.type == .push && newValue != oldValue else {
                 return
             }
             firePushSubscriptionChanged(.isDisabled(oldValue))
@@ -196,56 +260,74 @@ class OSSubscriptionModel: OSModel {
 
     // Properties for push subscription
     var testType: Int? {
-        didSet {
-            guard testType != oldValue else {
+        get {
+            read(\.testType)
+        }
+        set {
+            guard exchange(\.testType, newValue) != newValue else {
                 return
             }
-            self.set(property: "testType", newValue: testType)
+            self.set(property: "testType", newValue: newValue)
         }
     }
 
-    var deviceOs = UIDevice.current.systemVersion {
-        didSet {
-            guard deviceOs != oldValue else {
+    var deviceOs: String {
+        get {
+            read(\.deviceOs)
+        }
+        set {
+            guard exchange(\.deviceOs, newValue) != newValue else {
                 return
             }
-            self.set(property: "deviceOs", newValue: deviceOs)
+            self.set(property: "deviceOs", newValue: newValue)
         }
     }
 
-    var sdk = ONESIGNAL_VERSION {
-        didSet {
-            guard sdk != oldValue else {
+    var sdk: String {
+        get {
+            read(\.sdk)
+        }
+        set {
+            guard exchange(\.sdk, newValue) != newValue else {
                 return
             }
-            self.set(property: "sdk", newValue: sdk)
+            self.set(property: "sdk", newValue: newValue)
         }
     }
 
-    var deviceModel: String? = OSDeviceUtils.getDeviceVariant() {
-        didSet {
-            guard deviceModel != oldValue else {
+    var deviceModel: String? {
+        get {
+            read(\.deviceModel)
+        }
+        set {
+            guard exchange(\.deviceModel, newValue) != newValue else {
                 return
             }
-            self.set(property: "deviceModel", newValue: deviceModel)
+            self.set(property: "deviceModel", newValue: newValue)
         }
     }
 
-    var appVersion: String? = Bundle.main.infoDictionary?["CFBundleShortVersionString"] as? String {
-        didSet {
-            guard appVersion != oldValue else {
+    var appVersion: String? {
+        get {
+            read(\.appVersion)
+        }
+        set {
+            guard exchange(\.appVersion, newValue) != newValue else {
                 return
             }
-            self.set(property: "appVersion", newValue: appVersion)
+            self.set(property: "appVersion", newValue: newValue)
         }
     }
 
-    var netType: Int? = OSNetworkingUtils.getNetType() as? Int {
-        didSet {
-            guard netType != oldValue else {
+    var netType: Int? {
+        get {
+            read(\.netType)
+        }
+        set {
+            guard exchange(\.netType, newValue) != newValue else {
                 return
             }
-            self.set(property: "netType", newValue: netType)
+            self.set(property: "netType", newValue: newValue)
         }
     }
 
@@ -256,50 +338,48 @@ class OSSubscriptionModel: OSModel {
          reachable: Bool,
          isDisabled: Bool,
          changeNotifier: OSEventProducer<OSModelChangedHandler>) {
-        self.type = type
-        self.address = address
-        self.subscriptionId = subscriptionId
-        _reachable = reachable
-        _isDisabled = isDisabled
+        var state = State(type: type, address: address, subscriptionId: subscriptionId, reachable: reachable, isDisabled: isDisabled)
 
         // Set test_type if subscription model is PUSH, and update notificationTypes
         if type == .push {
             let releaseMode: OSUIApplicationReleaseMode = OneSignalMobileProvision.releaseMode()
             #if targetEnvironment(simulator)
             if releaseMode == OSUIApplicationReleaseMode.UIApplicationReleaseUnknown {
-                self.testType = OSUIApplicationReleaseMode.UIApplicationReleaseDev.rawValue
+                state.testType = OSUIApplicationReleaseMode.UIApplicationReleaseDev.rawValue
             }
             #endif
             // Workaround to unsure how to extract the Int value in 1 step...
             if releaseMode == .UIApplicationReleaseDev {
-                self.testType = OSUIApplicationReleaseMode.UIApplicationReleaseDev.rawValue
+                state.testType = OSUIApplicationReleaseMode.UIApplicationReleaseDev.rawValue
             }
             if releaseMode == .UIApplicationReleaseAdHoc {
-                self.testType = OSUIApplicationReleaseMode.UIApplicationReleaseAdHoc.rawValue
+                state.testType = OSUIApplicationReleaseMode.UIApplicationReleaseAdHoc.rawValue
             }
             if releaseMode == .UIApplicationReleaseWildcard {
-                self.testType = OSUIApplicationReleaseMode.UIApplicationReleaseWildcard.rawValue
+                state.testType = OSUIApplicationReleaseMode.UIApplicationReleaseWildcard.rawValue
             }
-            notificationTypes = Int(OSNotificationsManager.getNotificationTypes(_isDisabled))
+            state.notificationTypes = Int(OSNotificationsManager.getNotificationTypes(isDisabled))
         }
+        self.state = state
 
         super.init(changeNotifier: changeNotifier)
     }
 
     override func encode(with coder: NSCoder) {
+        let state = stateLock.withLock { self.state }
         super.encode(with: coder)
-        coder.encode(type.rawValue, forKey: "type") // Encodes as String
-        coder.encode(address, forKey: "address")
-        coder.encode(subscriptionId, forKey: "subscriptionId")
-        coder.encode(_reachable, forKey: "_reachable")
-        coder.encode(_isDisabled, forKey: "_isDisabled")
-        coder.encode(notificationTypes, forKey: "notificationTypes")
-        coder.encode(testType, forKey: "testType")
-        coder.encode(deviceOs, forKey: "deviceOs")
-        coder.encode(sdk, forKey: "sdk")
-        coder.encode(deviceModel, forKey: "deviceModel")
-        coder.encode(appVersion, forKey: "appVersion")
-        coder.encode(netType, forKey: "netType")
+        coder.encode(state.type.rawValue, forKey: "type") // Encodes as String
+        coder.encode(state.address, forKey: "address")
+        coder.encode(state.subscriptionId, forKey: "subscriptionId")
+        coder.encode(state.reachable, forKey: "_reachable")
+        coder.encode(state.isDisabled, forKey: "_isDisabled")
+        coder.encode(state.notificationTypes, forKey: "notificationTypes")
+        coder.encode(state.testType, forKey: "testType")
+        coder.encode(state.deviceOs, forKey: "deviceOs")
+        coder.encode(state.sdk, forKey: "sdk")
+        coder.encode(state.deviceModel, forKey: "deviceModel")
+        coder.encode(state.appVersion, forKey: "appVersion")
+        coder.encode(state.netType, forKey: "netType")
     }
 
     required init?(coder: NSCoder) {
@@ -310,18 +390,21 @@ class OSSubscriptionModel: OSModel {
             // Log error
             return nil
         }
-        self.type = type
-        self.address = coder.decodeObject(forKey: "address") as? String
-        self.subscriptionId = coder.decodeObject(forKey: "subscriptionId") as? String
-        self._reachable = coder.decodeBool(forKey: "_reachable")
-        self._isDisabled = coder.decodeBool(forKey: "_isDisabled")
-        self.notificationTypes = coder.decodeInteger(forKey: "notificationTypes")
-        self.testType = coder.decodeObject(forKey: "testType") as? Int
-        self.deviceOs = coder.decodeObject(forKey: "deviceOs") as? String ?? UIDevice.current.systemVersion
-        self.sdk = coder.decodeObject(forKey: "sdk") as? String ?? ONESIGNAL_VERSION
-        self.deviceModel = coder.decodeObject(forKey: "deviceModel") as? String
-        self.appVersion = coder.decodeObject(forKey: "appVersion") as? String
-        self.netType = coder.decodeObject(forKey: "netType") as? Int
+        var state = State(
+            type: type,
+            address: coder.decodeObject(forKey: "address") as? String,
+            subscriptionId: coder.decodeObject(forKey: "subscriptionId") as? String,
+            reachable: coder.decodeBool(forKey: "_reachable"),
+            isDisabled: coder.decodeBool(forKey: "_isDisabled")
+        )
+        state.notificationTypes = coder.decodeInteger(forKey: "notificationTypes")
+        state.testType = coder.decodeObject(forKey: "testType") as? Int
+        state.deviceOs = coder.decodeObject(forKey: "deviceOs") as? String ?? UIDevice.current.systemVersion
+        state.sdk = coder.decodeObject(forKey: "sdk") as? String ?? ONESIGNAL_VERSION
+        state.deviceModel = coder.decodeObject(forKey: "deviceModel") as? String
+        state.appVersion = coder.decodeObject(forKey: "appVersion") as? String
+        state.netType = coder.decodeObject(forKey: "netType") as? Int
+        self.state = state
 
         super.init(coder: coder)
     }
@@ -357,20 +440,21 @@ class OSSubscriptionModel: OSModel {
 
     // Using snake_case so we can use this in request bodies
     public func jsonRepresentation() -> [String: Any] {
+        let state = stateLock.withLock { self.state }
         var json: [String: Any] = [:]
-        json["id"] = self.subscriptionId
-        json["type"] = self.type.rawValue
-        json["token"] = self.address
-        json["enabled"] = self.enabled
-        json["test_type"] = self.testType
-        json["device_os"] = self.deviceOs
-        json["sdk"] = self.sdk
-        json["device_model"] = self.deviceModel
-        json["app_version"] = self.appVersion
-        json["net_type"] = self.netType
+        json["id"] = state.subscriptionId
+        json["type"] = state.type.rawValue
+        json["token"] = state.address
+        json["enabled"] = calculateIsEnabled(address: state.address, reachable: state.reachable, isDisabled: state.isDisabled)
+        json["test_type"] = state.testType
+        json["device_os"] = state.deviceOs
+        json["sdk"] = state.sdk
+        json["device_model"] = state.deviceModel
+        json["app_version"] = state.appVersion
+        json["net_type"] = state.netType
         // notificationTypes defaults to -1 instead of nil, don't send if it's -1
-        if self.notificationTypes != -1 {
-            json["notification_types"] = self.notificationTypes
+        if state.notificationTypes != -1 {
+            json["notification_types"] = state.notificationTypes
         }
         return json
     }
@@ -417,12 +501,15 @@ extension OSSubscriptionModel {
     }
 
     func update() {
-        updateTestType()
-        deviceOs = UIDevice.current.systemVersion
-        sdk = ONESIGNAL_VERSION
-        deviceModel = OSDeviceUtils.getDeviceVariant()
-        appVersion = Bundle.main.infoDictionary?["CFBundleShortVersionString"] as? String
-        netType = OSNetworkingUtils.getNetType() as? Int
+        // The device metadata goes out as one subscription update
+        batchUpdate {
+            updateTestType()
+            deviceOs = UIDevice.current.systemVersion
+            sdk = ONESIGNAL_VERSION
+            deviceModel = OSDeviceUtils.getDeviceVariant()
+            appVersion = Bundle.main.infoDictionary?["CFBundleShortVersionString"] as? String
+            netType = OSNetworkingUtils.getNetType() as? Int
+        }
         // sdkType ??
         // isRooted ??
         if type == .push && !(subscriptionId ?? "").isEmpty {
@@ -66,6 +66,16 @@ import OneSignalNotifications
     func addTags(_ tags: [String: String])
     func removeTag(_ tag: String)
     func removeTags(_ tags: [String])
+    /**
+     Adds tags like `addTags`, then calls `completion` on a background thread once they are sent to the server, with false if they could not be.
+     */
+    @objc(addTags:completion:)
+    func addTags(_ tags: [String: String], completion: @escaping (Bool) -> Void)
+    /**
+     Removes tags like `removeTags`, then calls `completion` on a background thread once the removal is sent to the server, with false if it could not be.
+     */
+    @objc(removeTags:completion:)
+    func removeTags(_ tags: [String], completion: @escaping (Bool) -> Void)
     func getTags() -> [String: String]
     // Email
     func addEmail(_ email: String)
@@ -75,12 +85,49 @@ import OneSignalNotifications
     func removeSms(_ number: String)
     // Language
     func setLanguage(_ language: String)
+    // Batch Edits
+    /**
+     Applies all changes made to the user in the `changes` block as a single batch.
+     Changes are persisted once and their deltas are combined before being enqueued, instead of once per change.
+     */
+    func edit(_ changes: (OSUser) -> Void)
+    /**
+     Applies all changes made to the user in the `changes` block as a single batch, then flushes them immediately if `flush` is true.
+     */
+    @objc(editAndFlush:changes:)
+    func edit(flush: Bool, _ changes: (OSUser) -> Void)
     // JWT Token Expire
     typealias OSJwtCompletionBlock = (_ newJwtToken: String) -> Void
     typealias OSJwtExpiredHandler =  (_ externalId: String, _ completion: OSJwtCompletionBlock) -> Void
     func onJwtExpired(expiredHandler: @escaping OSJwtExpiredHandler)
 }
 
+@available(iOS 13.0, *)
+extension OSUser {
+    /**
+     Adds tags and returns once they are sent to the server, false if they could not be.
+     Use it to sequence work that depends on the tags, such as fetching in-app messages targeting them.
+     */
+    public func addTagsAndWait(_ tags: [String: String]) async -> Bool {
+        await withCheckedContinuation { continuation in
+            addTags(tags) { success in
+                continuation.resume(returning: success)
+            }
+        }
+    }
+
+    /**
+     Removes tags and returns once the removal is sent to the server, false if it could not be.
+     */
+    public func removeTagsAndWait(_ tags: [String]) async -> Bool {
+        await withCheckedContinuation { continuation in
+            removeTags(tags) { success in
+                continuation.resume(returning: success)
+            }
+        }
+    }
+}
+
 /**
  This is the push subscription interface exposed to the public.
  */
@@ -97,7 +144,38 @@ import OneSignalNotifications
 
 @objc
 public class OneSignalUserManagerImpl: NSObject, OneSignalUserManager {
-    @objc public static let sharedInstance = OneSignalUserManagerImpl()
+    @objc public static let sharedInstance: OneSignalUserManagerImpl = {
+        prefetchCaches()
+        return OneSignalUserManagerImpl()
+    }()
+
+    /**
+     The model stores and the executors each unarchive their caches one after another as they are created.
+     Decoding them all concurrently up front lets those reads pick up the already decoded objects instead.
+     */
+    private static func prefetchCaches() {
+        var keys = [
+            OS_OPERATION_REPO_DELTA_QUEUE_KEY,
+            OS_USER_EXECUTOR_USER_REQUEST_QUEUE_KEY,
+            OS_USER_EXECUTOR_APPENDED_REQUESTS_KEY,
+            OS_USER_EXECUTOR_TRANSFER_SUBSCRIPTION_REQUEST_QUEUE_KEY,
+            OS_IDENTITY_EXECUTOR_DELTA_QUEUE_KEY,
+            OS_IDENTITY_EXECUTOR_ADD_REQUEST_QUEUE_KEY,
+            OS_IDENTITY_EXECUTOR_REMOVE_REQUEST_QUEUE_KEY,
+            OS_PROPERTIES_EXECUTOR_DELTA_QUEUE_KEY,
+            OS_PROPERTIES_EXECUTOR_UPDATE_REQUEST_QUEUE_KEY,
+            OS_SUBSCRIPTION_EXECUTOR_DELTA_QUEUE_KEY,
+            OS_SUBSCRIPTION_EXECUTOR_ADD_REQUEST_QUEUE_KEY,
+            OS_SUBSCRIPTION_EXECUTOR_REMOVE_REQUEST_QUEUE_KEY,
+            OS_SUBSCRIPTION_EXECUTOR_UPDATE_REQUEST_QUEUE_KEY
+        ]
+        for storeKey in [OS_IDENTITY_MODEL_STORE_KEY, OS_PROPERTIES_MODEL_STORE_KEY, OS_SUBSCRIPTION_MODEL_STORE_KEY, OS_PUSH_SUBSCRIPTION_MODEL_STORE_KEY] {
+            keys.append(contentsOf: OSModelStore<OSModel>.cachedRecordKeys(storeKey: storeKey))
+        }
+        OSTrace.measure(.cacheLoad, name: "Prefetch user caches") {
+            OneSignalUserDefaults.initShared().prefetchCodeableData(forKeys: keys)
+        }
+    }
 
     /**
      Convenience accessor. We access the push subscription model via the model store instead of via`user.pushSubscriptionModel`.
@@ -158,7 +236,8 @@ public class OneSignalUserManagerImpl: NSObject, OneSignalUserManager {
         if let observer = _userStateChangesObserver {
             return observer
         }
-        let userStateChangesObserver = OSObservable<OSUserStateObserver, OSUserChangedState>(change: #selector(OSUserStateObserver.onUserStateDidChange(state:)))
+        // onesignal_id and external_id hydrate through separate paths during a login, observers get the final state once
+        let userStateChangesObserver = OSObservable<OSUserStateObserver, OSUserChangedState>(change: #selector(OSUserStateObserver.onUserStateDidChange(state:)), coalescingInterval: 0)
         _userStateChangesObserver = userStateChangesObserver
 
         return userStateChangesObserver
@@ -232,6 +311,7 @@ public class OneSignalUserManagerImpl: NSObject, OneSignalUserManager {
         let identityExecutor = OSIdentityOperationExecutor(newRecordsState: newRecordsState)
         let subscriptionExecutor = OSSubscriptionOperationExecutor(newRecordsState: newRecordsState)
         self.propertyExecutor = propertyExecutor
+        self.userExecutor?.propertyExecutor = propertyExecutor
         self.identityExecutor = identityExecutor
         self.subscriptionExecutor = subscriptionExecutor
         OSOperationRepo.sharedInstance.addExecutor(identityExecutor)
@@ -279,6 +359,14 @@ public class OneSignalUserManagerImpl: NSObject, OneSignalUserManager {
             return
         }
         OneSignalLog.onesignalLog(.LL_VERBOSE, message: "OneSignal.User login called with externalId: \(externalId)")
+        // Logging into the current user is a no-op, apart from taking a newer token
+        if let user = _user, user.identityModel.externalId == externalId {
+            OneSignalLog.onesignalLog(.LL_VERBOSE, message: "OneSignal.User login called with the current externalId, keeping the current user")
+            if let token = token {
+                user.identityModel.jwtBearerToken = token
+            }
+            return
+        }
         _ = _login(externalId: externalId, token: token)
     }
 
@@ -292,8 +380,8 @@ public class OneSignalUserManagerImpl: NSObject, OneSignalUserManager {
         // 2. Set the internal user
         let newUser = setNewInternalUser(externalId: nil, pushSubscriptionModel: pushSubscriptionModel)
 
-        // 3. Make the request
-        userExecutor!.fetchIdentityBySubscription(newUser)
+        // 3. Make the request, at a random point of the migration window
+        userExecutor!.fetchIdentityBySubscription(newUser, maxJitter: OS_LEGACY_MIGRATION_MAX_JITTER_SECONDS)
     }
 
     private func createNewUser(externalId: String?, token: String?) -> OSUserInternal {
@@ -309,6 +397,8 @@ public class OneSignalUserManagerImpl: NSObject, OneSignalUserManager {
             }
         }
 
+        OSFlightRecorder.record(.userSwitched, arg0: externalId == nil ? 0 : 1, arg1: 0)
+
         let pushSubscriptionModel = pushSubscriptionModelStore.getModel(key: OS_PUSH_SUBSCRIPTION_MODEL_KEY)
 
         // prepareForNewUser may be already called by logout, so we don't want to call it again. Also, there should be no need to call this method if there is no user.
@@ -505,6 +595,24 @@ public class OneSignalUserManagerImpl: NSObject, OneSignalUserManager {
         return user.propertiesModel.tags
     }
 
+    /// The same snapshot is returned until the tags change, for callers such as liquid tag substitution that read them often.
+    @objc
+    public func getTagsSnapshotInternal() -> OSTagsSnapshot? {
+        return _user?.propertiesModel.tagsSnapshot
+    }
+
+    /**
+     Fetches the user in the background so the cached tags catch up with the server.
+     `OS_ON_USER_TAGS_DID_CHANGE` is posted if the fetched tags differ from the cached ones.
+     */
+    @objc
+    public func refreshTagsInternal() {
+        guard let user = _user, let onesignalId = user.identityModel.onesignalId, let userExecutor = userExecutor else {
+            return
+        }
+        userExecutor.fetchUser(aliasLabel: OS_ONESIGNAL_ID, aliasId: onesignalId, identityModel: user.identityModel)
+    }
+
     @objc
     public func setLocation(latitude: Float, longitude: Float) {
         guard !OneSignalConfigManager.shouldAwaitAppIdAndLogMissingPrivacyConsent(forMethod: "setLocation") else {
@@ -525,16 +633,32 @@ public class OneSignalUserManagerImpl: NSObject, OneSignalUserManager {
         updatePropertiesDeltas(property: .purchases, value: purchases)
     }
 
-    private func fireJwtExpired() {
-        guard let externalId = user.identityModel.externalId, let jwtExpiredHandler = self.jwtExpiredHandler else {
-            return
+    /**
+     Only this user's deltas and requests are held back while the app refreshes its token, other users' and unauthenticated work keeps flowing.
+     Returns false if the app cannot provide a new token, either without an external ID or without a JWT expired handler.
+     A user already waiting for a token does not ask the app again, the pause times out if the handler never calls back.
+     */
+    @discardableResult
+    func fireJwtExpired(identityModel: OSIdentityModel) -> Bool {
+        guard let externalId = identityModel.externalId, let jwtExpiredHandler = self.jwtExpiredHandler else {
+            return false
         }
-        jwtExpiredHandler(externalId) { [self] (newToken) in
-            guard user.identityModel.externalId == externalId else {
-                return
+        let identityModelId = identityModel.modelId
+        guard !OSOperationRepo.sharedInstance.isPaused(identityModelId: identityModelId) else {
+            return true
+        }
+        OSOperationRepo.sharedInstance.pause(identityModelId: identityModelId) { [weak self] in
+            self?.userExecutor?.executePendingRequests()
+        }
+        jwtExpiredHandler(externalId) { [weak self] (newToken) in
+            if identityModel.externalId == externalId {
+                identityModel.jwtBearerToken = newToken
             }
-            user.identityModel.jwtBearerToken = newToken
+            OSOperationRepo.sharedInstance.resume(identityModelId: identityModelId)
+            // Requests of the user executor are not flushed by the operation repo
+            self?.userExecutor?.executePendingRequests()
         }
+        return true
     }
 }
 
@@ -602,6 +726,8 @@ extension OneSignalUserManagerImpl {
     @objc
     public func runBackgroundTasks() {
         OSOperationRepo.sharedInstance.addFlushDeltaQueueToDispatchQueue(inBackground: true)
+        // Write any model changes still scheduled so they are included when UserDefaults is flushed
+        OSModelStorePersistence.waitForPendingSaves()
     }
 }
 
@@ -699,6 +825,28 @@ extension OneSignalUserManagerImpl: OSUser {
         user.removeTags(tags)
     }
 
+    public func addTags(_ tags: [String: String], completion: @escaping (Bool) -> Void) {
+        guard !OneSignalConfigManager.shouldAwaitAppIdAndLogMissingPrivacyConsent(forMethod: "addTags") else {
+            completion(false)
+            return
+        }
+        let user = self.user
+        OSOperationRepo.sharedInstance.trackCompletion(of: {
+            user.addTags(tags)
+        }, completion: completion)
+    }
+
+    public func removeTags(_ tags: [String], completion: @escaping (Bool) -> Void) {
+        guard !OneSignalConfigManager.shouldAwaitAppIdAndLogMissingPrivacyConsent(forMethod: "removeTags") else {
+            completion(false)
+            return
+        }
+        let user = self.user
+        OSOperationRepo.sharedInstance.trackCompletion(of: {
+            user.removeTags(tags)
+        }, completion: completion)
+    }
+
     public func getTags() -> [String: String] {
         guard !OneSignalConfigManager.shouldAwaitAppIdAndLogMissingPrivacyConsent(forMethod: "getTags") else {
             return [:]
@@ -782,6 +930,25 @@ extension OneSignalUserManagerImpl: OSUser {
 
         user.setLanguage(language)
     }
+
+    public func edit(_ changes: (OSUser) -> Void) {
+        edit(flush: false, changes)
+    }
+
+    public func edit(flush: Bool, _ changes: (OSUser) -> Void) {
+        guard !OneSignalConfigManager.shouldAwaitAppIdAndLogMissingPrivacyConsent(forMethod: "edit") else {
+            return
+        }
+        let modelStores: [OSModelStoreBatching] = [identityModelStore, propertiesModelStore, subscriptionModelStore, pushSubscriptionModelStore]
+
+        OSOperationRepo.sharedInstance.beginBatch()
+        modelStores.forEach { $0.beginBatch() }
+
+        changes(self)
+
+        modelStores.forEach { $0.endBatch() }
+        OSOperationRepo.sharedInstance.endBatch(flush: flush)
+    }
 }
 
 extension OneSignalUserManagerImpl {
@@ -795,7 +962,13 @@ extension OneSignalUserManagerImpl {
             if let observer = _pushSubscriptionStateChangesObserver {
                 return observer
             }
-            let pushSubscriptionStateChangesObserver = OSObservable<OSPushSubscriptionObserver, OSPushSubscriptionChangedState>(change: #selector(OSPushSubscriptionObserver.onPushSubscriptionDidChange(state:)))
+            // The id, token and opted in state can each change during a login, observers get one change from the first previous state to the last current state
+            let pushSubscriptionStateChangesObserver = OSObservable<OSPushSubscriptionObserver, OSPushSubscriptionChangedState>(change: #selector(OSPushSubscriptionObserver.onPushSubscriptionDidChange(state:)), coalescingInterval: 0) { pending, state in
+                guard !pending.previous.equals(state.current) else {
+                    return nil
+                }
+                return OSPushSubscriptionChangedState(current: state.current, previous: pending.previous)
+            }
             _pushSubscriptionStateChangesObserver = pushSubscriptionStateChangesObserver
 
             return pushSubscriptionStateChangesObserver
@@ -64,6 +64,7 @@ class OSRequestCreateSubscription: OneSignalRequest, OSUserRequest {
         super.init()
         self.parameters = ["subscription": subscriptionModel.jsonRepresentation()]
         self.method = POST
+        self.priority = .high
     }
 
     func encode(with coder: NSCoder) {
@@ -91,6 +92,7 @@ class OSRequestCreateSubscription: OneSignalRequest, OSUserRequest {
         super.init()
         self.parameters = parameters
         self.method = HTTPMethod(rawValue: rawMethod)
+        self.priority = .high
         self.timestamp = timestamp
     }
 }
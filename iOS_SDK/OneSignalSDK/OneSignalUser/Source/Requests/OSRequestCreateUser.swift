@@ -44,6 +44,23 @@ class OSRequestCreateUser: OneSignalRequest, OSUserRequest {
     var identityModel: OSIdentityModel
     var pushSubscriptionModel: OSSubscriptionModel?
     var originalPushToken: String?
+    /// Completion handlers of update requests fused into this request. Only held in memory, like theirs.
+    var fusedCompletionHandlers: [(Bool) -> Void] = []
+
+    /// A fused request is only completed once.
+    func callFusedCompletionHandlers(success: Bool) {
+        let completionHandlers = fusedCompletionHandlers
+        fusedCompletionHandlers = []
+        completionHandlers.forEach { $0(success) }
+    }
+
+    /// Only a user without aliases is certain to be new, the server does not apply the properties of a user that already exists.
+    var canFuseUpdates: Bool {
+        guard pushSubscriptionModel != nil, let identity = parameters?["identity"] as? [String: Any] else {
+            return false
+        }
+        return identity.isEmpty
+    }
 
     /// Checks if the subscription ID can be accessed, if a subscription is being included in the request
     func prepareForExecution(newRecordsState: OSNewRecordsState) -> Bool {
@@ -75,6 +92,32 @@ class OSRequestCreateUser: OneSignalRequest, OSUserRequest {
         self.originalPushToken = pushSubscriptionModel.address
     }
 
+    /**
+     Adds the properties and tags of pending update requests for this user to the payload, so the user is created with them
+     in one round trip instead of being patched after. Later requests win, and removed tags are left out as a new user has none.
+     */
+    func fuse(_ updates: [OSRequestUpdateProperties]) {
+        var properties = parameters?["properties"] as? [String: Any] ?? [:]
+        var tags = properties["tags"] as? [String: String] ?? [:]
+        for update in updates {
+            guard let updateProperties = update.parameters?["properties"] as? [String: Any] else {
+                continue
+            }
+            for (key, value) in updateProperties where key != "tags" {
+                properties[key] = value
+            }
+            if let updateTags = updateProperties["tags"] as? [String: String] {
+                tags.merge(updateTags) { _, newer in newer }
+            }
+            fusedCompletionHandlers.append(contentsOf: update.completionHandlers)
+            update.completionHandlers = []
+            deltaTraces = (deltaTraces ?? []) + (update.deltaTraces ?? [])
+        }
+        tags = tags.filter { !$0.value.isEmpty }
+        properties["tags"] = tags.isEmpty ? nil : tags
+        parameters?["properties"] = properties
+    }
+
     init(identityModel: OSIdentityModel, propertiesModel: OSPropertiesModel, pushSubscriptionModel: OSSubscriptionModel, originalPushToken: String?) {
         self.identityModel = identityModel
         self.pushSubscriptionModel = pushSubscriptionModel
@@ -100,6 +143,7 @@ class OSRequestCreateUser: OneSignalRequest, OSUserRequest {
         self.parameters = params
         self.updatePushSubscriptionModel(pushSubscriptionModel)
         self.method = POST
+        self.priority = .high
     }
 
     init(aliasLabel: String, aliasId: String, identityModel: OSIdentityModel) {
@@ -111,6 +155,7 @@ class OSRequestCreateUser: OneSignalRequest, OSUserRequest {
             "refresh_device_metadata": true
         ]
         self.method = POST
+        self.priority = .high
     }
 
     func encode(with coder: NSCoder) {
@@ -139,6 +184,7 @@ class OSRequestCreateUser: OneSignalRequest, OSUserRequest {
         super.init()
         self.parameters = parameters
         self.method = HTTPMethod(rawValue: rawMethod)
+        self.priority = .high
         self.timestamp = timestamp
     }
 }
@@ -38,6 +38,8 @@ class OSRequestFetchIdentityBySubscription: OneSignalRequest, OSUserRequest {
 
     var identityModel: OSIdentityModel
     var pushSubscriptionModel: OSSubscriptionModel
+    /// The user executor holds the request until then, persisted so a migration interrupted by the app exiting keeps its place in the spread
+    var notBefore: Date?
 
     func prepareForExecution(newRecordsState: OSNewRecordsState) -> Bool {
         // newRecordsState is unused for this request
@@ -70,6 +72,7 @@ class OSRequestFetchIdentityBySubscription: OneSignalRequest, OSUserRequest {
         coder.encode(pushSubscriptionModel, forKey: "pushSubscriptionModel")
         coder.encode(method.rawValue, forKey: "method") // Encodes as String
         coder.encode(timestamp, forKey: "timestamp")
+        coder.encode(notBefore, forKey: "notBefore")
     }
 
     required init?(coder: NSCoder) {
@@ -89,5 +92,6 @@ class OSRequestFetchIdentityBySubscription: OneSignalRequest, OSUserRequest {
         super.init()
         self.method = HTTPMethod(rawValue: rawMethod)
         self.timestamp = timestamp
+        self.notBefore = coder.decodeObject(forKey: "notBefore") as? Date
     }
 }
@@ -53,6 +53,8 @@ class OSRequestFetchUser: OneSignalRequest, OSUserRequest {
         }
         self.addJWTHeader(identityModel: identityModel)
         self.path = "apps/\(appId)/users/by/\(aliasLabel)/\(aliasId)"
+        // Fetches of the same user made in quick succession share one response
+        self.idempotencyKey = self.path
         return true
     }
 
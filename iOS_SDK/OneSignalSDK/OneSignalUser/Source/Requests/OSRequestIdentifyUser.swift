@@ -80,6 +80,7 @@ class OSRequestIdentifyUser: OneSignalRequest, OSUserRequest {
         super.init()
         self.parameters = ["identity": [aliasLabel: aliasId]]
         self.method = PATCH
+        self.priority = .high
     }
 
     func encode(with coder: NSCoder) {
@@ -114,5 +115,6 @@ class OSRequestIdentifyUser: OneSignalRequest, OSUserRequest {
         self.timestamp = timestamp
         self.parameters = parameters
         self.method = HTTPMethod(rawValue: rawMethod)
+        self.priority = .high
     }
 }
@@ -30,6 +30,8 @@ import OneSignalOSCore
 
 class OSRequestUpdateProperties: OneSignalRequest, OSUserRequest {
     var sentToClient = false
+    // Completion handlers of the deltas combined into this request, called once it completes. Not persisted.
+    var completionHandlers: [(Bool) -> Void] = []
     let stringDescription: String
     override var description: String {
         return stringDescription
@@ -61,6 +63,71 @@ class OSRequestUpdateProperties: OneSignalRequest, OSUserRequest {
         self.method = PATCH
     }
 
+    /**
+     Combines the parameters of two pending requests for the same user into the payload of one request.
+     Properties and tags from `newer` win, session time and count are summed, purchases are appended,
+     and device metadata is refreshed if either request asked for it.
+     */
+    static func mergeParams(_ older: [String: Any], _ newer: [String: Any]) -> [String: Any] {
+        var properties = older["properties"] as? [String: Any] ?? [:]
+        let newerProperties = newer["properties"] as? [String: Any] ?? [:]
+        var tags = properties["tags"] as? [String: String] ?? [:]
+        tags.merge(newerProperties["tags"] as? [String: String] ?? [:]) { _, newValue in newValue }
+        properties.merge(newerProperties) { _, newValue in newValue }
+        properties["tags"] = tags.isEmpty ? nil : tags
+
+        var deltas = older["deltas"] as? [String: Any] ?? [:]
+        let newerDeltas = newer["deltas"] as? [String: Any] ?? [:]
+        for key in ["session_count", "session_time"] {
+            let sum = (deltas[key] as? Int ?? 0) + (newerDeltas[key] as? Int ?? 0)
+            deltas[key] = sum > 0 ? sum : nil
+        }
+        let purchases = (deltas["purchases"] as? [[String: AnyObject]] ?? []) + (newerDeltas["purchases"] as? [[String: AnyObject]] ?? [])
+        deltas["purchases"] = purchases.isEmpty ? nil : purchases
+
+        var params: [String: Any] = [:]
+        params["properties"] = properties.isEmpty ? nil : properties
+        params["refresh_device_metadata"] = (older["refresh_device_metadata"] as? Bool ?? false) || (newer["refresh_device_metadata"] as? Bool ?? false)
+        params["deltas"] = deltas.isEmpty ? nil : deltas
+        return params
+    }
+
+    /**
+     Splits the payload so each part carries at most about `maxTagsBytes` of tags, returns it unchanged if it fits.
+     The first part keeps every other field, the rest only carry tags. A tag key is in exactly one part,
+     so the parts can be sent one after another, in order, without a later part undoing an earlier one.
+     */
+    static func splitParams(_ params: [String: Any], maxTagsBytes: Int) -> [[String: Any]] {
+        guard var properties = params["properties"] as? [String: Any],
+              let tags = properties["tags"] as? [String: String]
+        else {
+            return [params]
+        }
+
+        var chunks: [[String: String]] = [[:]]
+        var chunkBytes = 0
+        // Sorted so a persisted and re-split request is split the same way
+        for key in tags.keys.sorted() {
+            let value = tags[key] ?? ""
+            // The quotes, colon and comma around each pair in the JSON body
+            let bytes = key.utf8.count + value.utf8.count + 6
+            if chunkBytes + bytes > maxTagsBytes && !chunks[chunks.count - 1].isEmpty {
+                chunks.append([:])
+                chunkBytes = 0
+            }
+            chunks[chunks.count - 1][key] = value
+            chunkBytes += bytes
+        }
+        guard chunks.count > 1 else {
+            return [params]
+        }
+
+        var first = params
+        properties["tags"] = chunks[0]
+        first["properties"] = properties
+        return [first] + chunks.dropFirst().map { ["properties": ["tags": $0]] }
+    }
+
     func encode(with coder: NSCoder) {
         coder.encode(identityModel, forKey: "identityModel")
         coder.encode(parameters, forKey: "parameters")
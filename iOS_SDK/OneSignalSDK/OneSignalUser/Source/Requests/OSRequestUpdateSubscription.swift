@@ -39,6 +39,8 @@ class OSRequestUpdateSubscription: OneSignalRequest, OSUserRequest {
     }
 
     var subscriptionModel: OSSubscriptionModel
+    /// The user the update was made for, whose RYW token it sets. Nil for requests persisted by earlier versions.
+    var identityModel: OSIdentityModel?
 
     // Need the subscription_id
     func prepareForExecution(newRecordsState: OSNewRecordsState) -> Bool {
@@ -55,8 +57,9 @@ class OSRequestUpdateSubscription: OneSignalRequest, OSUserRequest {
 
     // TODO: just need the sub model and send it
     // But the model may be outdated or not sync with the subscriptionObject
-    init(subscriptionObject: [String: Any], subscriptionModel: OSSubscriptionModel) {
+    init(subscriptionObject: [String: Any], subscriptionModel: OSSubscriptionModel, identityModel: OSIdentityModel? = nil) {
         self.subscriptionModel = subscriptionModel
+        self.identityModel = identityModel
         self.stringDescription = "OSRequestUpdateSubscription with subscriptionObject: \(subscriptionObject)"
         super.init()
 
@@ -84,6 +87,7 @@ class OSRequestUpdateSubscription: OneSignalRequest, OSUserRequest {
 
     func encode(with coder: NSCoder) {
         coder.encode(subscriptionModel, forKey: "subscriptionModel")
+        coder.encode(identityModel, forKey: "identityModel")
         coder.encode(parameters, forKey: "parameters")
         coder.encode(method.rawValue, forKey: "method") // Encodes as String
         coder.encode(timestamp, forKey: "timestamp")
@@ -100,6 +104,7 @@ class OSRequestUpdateSubscription: OneSignalRequest, OSUserRequest {
             return nil
         }
         self.subscriptionModel = subscriptionModel
+        self.identityModel = coder.decodeObject(forKey: "identityModel") as? OSIdentityModel
         self.stringDescription = "OSRequestUpdateSubscription with parameters: \(parameters)"
         super.init()
         self.parameters = parameters
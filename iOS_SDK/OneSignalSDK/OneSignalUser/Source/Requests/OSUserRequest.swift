@@ -33,6 +33,27 @@ protocol OSUserRequest: OneSignalRequest, NSCoding {
     func prepareForExecution(newRecordsState: OSNewRecordsState) -> Bool
 }
 
+internal extension OSUserRequest {
+    /**
+     After a 401 the request stays queued and unsent, and its user's work is paused until the app provides a new JWT.
+     Returns false if no new JWT can be requested, the request is then failed like other errors that are not retried.
+     */
+    func awaitNewJwtIfUnauthorized(_ responseType: OSResponseStatusType, identityModel: OSIdentityModel) -> Bool {
+        guard responseType == .unauthorized,
+              OneSignalUserManagerImpl.sharedInstance.fireJwtExpired(identityModel: identityModel)
+        else {
+            return false
+        }
+        sentToClient = false
+        return true
+    }
+
+    /// While its user's work is paused for a new JWT, the request is neither sent nor counted as pending work.
+    func isAwaitingNewJwt(_ identityModel: OSIdentityModel) -> Bool {
+        return OSOperationRepo.sharedInstance.isPaused(identityModelId: identityModel.modelId)
+    }
+}
+
 internal extension OneSignalRequest {
     func addJWTHeader(identityModel: OSIdentityModel) {
 //        guard let token = identityModel.jwtBearerToken else {
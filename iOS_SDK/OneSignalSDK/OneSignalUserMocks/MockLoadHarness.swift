@@ -0,0 +1,159 @@
+/*
+ Modified MIT License
+
+ Copyright 2024 OneSignal
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ 1. The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ 2. All copies of substantial portions of the Software may only be used in connection
+ with services provided by OneSignal.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ */
+
+import Foundation
+import OneSignalCore
+import OneSignalCoreMocks
+import OneSignalOSCore
+@testable import OneSignalUser
+
+/**
+ A step of a synthetic user session replayed by `MockLoadHarness`.
+ */
+public enum MockLoadStep {
+    /// Sets this many distinct tags, one call each, as an app syncing its state at launch would
+    case tagStorm(tags: Int)
+    /// Logs in to a new external id and back out, this many times
+    case loginLogoutChurn(cycles: Int)
+    /// The network is unreachable for this many seconds while tags keep being set
+    case offline(seconds: Double, tags: Int)
+    /// Nothing is called for this many seconds, letting queues drain
+    case idle(seconds: Double)
+}
+
+public struct MockLoadReport: CustomStringConvertible {
+    public let duration: TimeInterval
+    public let requestCount: Int
+    /// Requests completed per second over the whole run
+    public let throughput: Double
+    /// Total depth of the delta queue and every executor's request queues, sampled during the run
+    public let queueDepthSamples: [(time: TimeInterval, depth: Int)]
+    public let finalQueueDepth: Int
+    /// Bytes written through OneSignalUserDefaults during the run
+    public let bytesWritten: Int64
+
+    public var maxQueueDepth: Int {
+        return queueDepthSamples.map { $0.depth }.max() ?? 0
+    }
+
+    public var description: String {
+        return String(format: "%.2fs, %d requests (%.1f/s), max queue depth %d, final queue depth %d, %lld bytes written",
+                      duration, requestCount, throughput, maxQueueDepth, finalQueueDepth, bytesWritten)
+    }
+}
+
+/**
+ Replays synthetic user sessions against the real user manager, operation repo, executors and model stores,
+ with `MockOneSignalClient` standing in for the server. Configure the client's `latencies`, `errorRate`
+ and `randomSeed` to shape the server's responses.
+ */
+public class MockLoadHarness {
+    let client: MockOneSignalClient
+    let sampleInterval: TimeInterval
+    let lock = NSLock()
+    var samples: [(time: TimeInterval, depth: Int)] = []
+
+    public init(client: MockOneSignalClient, sampleInterval: TimeInterval = 0.05) {
+        self.client = client
+        self.sampleInterval = sampleInterval
+    }
+
+    public func run(_ steps: [MockLoadStep], drainFor drainSeconds: Double = 1) -> MockLoadReport {
+        client.fireSuccessForAllRequests = true
+        let startRequestCount = client.networkRequestCount
+        let startBytes = bytesWritten()
+        let start = Date()
+        samples = []
+
+        let sampler = DispatchSource.makeTimerSource(queue: DispatchQueue(label: "com.onesignal.loadharness.sampler"))
+        sampler.schedule(deadline: .now(), repeating: sampleInterval)
+        sampler.setEventHandler { [weak self] in
+            guard let self = self else {
+                return
+            }
+            let sample = (time: -start.timeIntervalSinceNow, depth: self.queueDepth())
+            self.lock.withLock {
+                self.samples.append(sample)
+            }
+        }
+        sampler.resume()
+
+        for step in steps {
+            perform(step)
+        }
+        OneSignalCoreMocks.waitForBackgroundThreads(seconds: drainSeconds)
+        sampler.cancel()
+
+        let duration = -start.timeIntervalSinceNow
+        let requestCount = client.networkRequestCount - startRequestCount
+        return MockLoadReport(
+            duration: duration,
+            requestCount: requestCount,
+            throughput: duration > 0 ? Double(requestCount) / duration : 0,
+            queueDepthSamples: lock.withLock { samples },
+            finalQueueDepth: queueDepth(),
+            bytesWritten: bytesWritten() - startBytes
+        )
+    }
+
+    func perform(_ step: MockLoadStep) {
+        let userManager = OneSignalUserManagerImpl.sharedInstance
+        switch step {
+        case .tagStorm(let tags):
+            setTags(tags)
+        case .loginLogoutChurn(let cycles):
+            for _ in 0..<cycles {
+                userManager.login(externalId: UUID().uuidString, token: nil)
+                setTags(5)
+                userManager.logout()
+            }
+        case .offline(let seconds, let tags):
+            client.isOffline = true
+            setTags(tags)
+            OneSignalCoreMocks.waitForBackgroundThreads(seconds: seconds)
+            client.isOffline = false
+            OSOperationRepo.sharedInstance.addFlushDeltaQueueToDispatchQueue()
+        case .idle(let seconds):
+            OneSignalCoreMocks.waitForBackgroundThreads(seconds: seconds)
+        }
+    }
+
+    func setTags(_ count: Int) {
+        let run = UUID().uuidString.prefix(8)
+        for num in 0..<count {
+            OneSignalUserManagerImpl.sharedInstance.addTag(key: "load_tag\(num)", value: "\(run)")
+        }
+    }
+
+    func queueDepth() -> Int {
+        return OSOperationRepo.sharedInstance.queueDiagnostics().reduce(0) { $0 + $1.depth }
+    }
+
+    func bytesWritten() -> Int64 {
+        return OSPerformanceCounters.snapshot()["user_defaults_bytes_written"]?.int64Value ?? 0
+    }
+}
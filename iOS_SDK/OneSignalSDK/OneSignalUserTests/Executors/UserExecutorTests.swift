@@ -194,4 +194,227 @@ final class UserExecutorTests: XCTestCase {
         XCTAssertTrue(mocks.client.hasExecutedRequestOfType(OSRequestCreateUser.self))
         XCTAssertTrue(mocks.newRecordsState.records.isEmpty)
     }
+
+    /**
+     An Identify User request waiting on the OneSignal ID of the user it identifies should only hold back
+     requests for that user, not a Create User request for an unrelated user queued behind it.
+     */
+    func testUnexecutableRequest_doesNotBlockRequestsForOtherUsers() {
+        /* Setup */
+        let mocks = Mocks()
+        MockUserRequests.setDefaultCreateUserResponses(with: mocks.client, externalId: userB_EUID)
+
+        // This anonymous user has no OneSignal ID yet, so it cannot be identified
+        let anonIdentityModel = OSIdentityModel(aliases: [:], changeNotifier: OSEventProducer())
+        let newIdentityModel = OSIdentityModel(aliases: [OS_EXTERNAL_ID: userA_EUID], changeNotifier: OSEventProducer())
+        let otherIdentityModel = OSIdentityModel(aliases: [OS_EXTERNAL_ID: userB_EUID], changeNotifier: OSEventProducer())
+
+        /* When */
+        mocks.userExecutor.identifyUser(externalId: userA_EUID, identityModelToIdentify: anonIdentityModel, identityModelToUpdate: newIdentityModel)
+        mocks.userExecutor.createUser(aliasLabel: OS_EXTERNAL_ID, aliasId: userB_EUID, identityModel: otherIdentityModel)
+        OneSignalCoreMocks.waitForBackgroundThreads(seconds: 0.5)
+
+        /* Then */
+        XCTAssertFalse(mocks.client.hasExecutedRequestOfType(OSRequestIdentifyUser.self))
+        XCTAssertTrue(mocks.client.hasExecutedRequestOfType(OSRequestCreateUser.self))
+        XCTAssertEqual(otherIdentityModel.onesignalId, userB_OSID)
+    }
+
+    /**
+     Tags set on an anonymous user before it is created wait on its OneSignal ID in the property executor.
+     They should be sent in the Create User request instead of an Update Properties request after it.
+     */
+    /**
+     Requests that carry the push subscription keep their queue order across users, so a Create User request for another user
+     with the push subscription waits behind an Identify User request that cannot execute yet.
+     */
+    func testUnexecutableRequest_holdsBackCreateUserWithThePushSubscription() {
+        /* Setup */
+        let mocks = Mocks()
+        MockUserRequests.setDefaultCreateUserResponses(with: mocks.client, externalId: userB_EUID)
+
+        // This anonymous user has no OneSignal ID yet, so it cannot be identified
+        let anonIdentityModel = OSIdentityModel(aliases: [:], changeNotifier: OSEventProducer())
+        let newIdentityModel = OSIdentityModel(aliases: [OS_EXTERNAL_ID: userA_EUID], changeNotifier: OSEventProducer())
+        let userB = mocks.createUserInstance(externalId: userB_EUID)
+
+        /* When */
+        mocks.userExecutor.identifyUser(externalId: userA_EUID, identityModelToIdentify: anonIdentityModel, identityModelToUpdate: newIdentityModel)
+        mocks.userExecutor.createUser(userB)
+        OneSignalCoreMocks.waitForBackgroundThreads(seconds: 0.5)
+
+        /* Then */
+        XCTAssertFalse(mocks.client.hasExecutedRequestOfType(OSRequestIdentifyUser.self))
+        XCTAssertFalse(mocks.client.hasExecutedRequestOfType(OSRequestCreateUser.self))
+    }
+
+    func testCreateAnonymousUser_fusesPendingPropertyUpdates() {
+        /* Setup */
+        let mocks = Mocks()
+        MockUserRequests.setDefaultCreateAnonUserResponses(with: mocks.client)
+        let propertyExecutor = OSPropertyOperationExecutor(newRecordsState: mocks.newRecordsState)
+        mocks.userExecutor.propertyExecutor = propertyExecutor
+
+        let user = OSUserInternalImpl(
+            identityModel: OSIdentityModel(aliases: [:], changeNotifier: OSEventProducer()),
+            propertiesModel: OSPropertiesModel(changeNotifier: OSEventProducer()),
+            pushSubscriptionModel: OSSubscriptionModel(type: .push, address: "", subscriptionId: nil, reachable: false, isDisabled: false, changeNotifier: OSEventProducer())
+        )
+        OneSignalUserManagerImpl.sharedInstance.addIdentityModelToRepo(user.identityModel)
+        var tagsSent: Bool?
+        let delta = OSDelta(name: OS_UPDATE_PROPERTIES_DELTA, identityModelId: user.identityModel.modelId, model: user.propertiesModel, property: "tags", value: ["a": "1", "b": ""])
+        delta.addCompletionHandler { tagsSent = $0 }
+        propertyExecutor.enqueueDelta(delta)
+        propertyExecutor.processDeltaQueue(inBackground: false)
+        OneSignalCoreMocks.waitForBackgroundThreads(seconds: 0.5)
+
+        /* When */
+        mocks.userExecutor.createUser(user)
+        OneSignalCoreMocks.waitForBackgroundThreads(seconds: 0.5)
+
+        /* Then */
+        let createUser = mocks.client.executedRequests.first(where: { $0 is OSRequestCreateUser })
+        let properties = createUser?.parameters?["properties"] as? [String: Any]
+        XCTAssertEqual(properties?["tags"] as? [String: String], ["a": "1"])
+        XCTAssertFalse(mocks.client.hasExecutedRequestOfType(OSRequestUpdateProperties.self))
+        XCTAssertTrue(propertyExecutor.updateRequestQueue.isEmpty)
+        XCTAssertEqual(tagsSent, true)
+    }
+
+    func testCreateAnonymousUser_failsFusedPropertyUpdatesWhenCreateFails() {
+        /* Setup */
+        let mocks = Mocks()
+        mocks.client.setMockFailureResponseForRequest(
+            request: "<OSRequestCreateUser with external_id: nil>",
+            error: OneSignalClientError(code: 400, message: "not-important", responseHeaders: nil, response: nil, underlyingError: nil)
+        )
+        let propertyExecutor = OSPropertyOperationExecutor(newRecordsState: mocks.newRecordsState)
+        mocks.userExecutor.propertyExecutor = propertyExecutor
+
+        let user = OSUserInternalImpl(
+            identityModel: OSIdentityModel(aliases: [:], changeNotifier: OSEventProducer()),
+            propertiesModel: OSPropertiesModel(changeNotifier: OSEventProducer()),
+            pushSubscriptionModel: OSSubscriptionModel(type: .push, address: "", subscriptionId: nil, reachable: false, isDisabled: false, changeNotifier: OSEventProducer())
+        )
+        OneSignalUserManagerImpl.sharedInstance.addIdentityModelToRepo(user.identityModel)
+        var tagsSent: Bool?
+        let delta = OSDelta(name: OS_UPDATE_PROPERTIES_DELTA, identityModelId: user.identityModel.modelId, model: user.propertiesModel, property: "tags", value: ["a": "1"])
+        delta.addCompletionHandler { tagsSent = $0 }
+        propertyExecutor.enqueueDelta(delta)
+        propertyExecutor.processDeltaQueue(inBackground: false)
+        OneSignalCoreMocks.waitForBackgroundThreads(seconds: 0.5)
+
+        /* When */
+        mocks.userExecutor.createUser(user)
+        OneSignalCoreMocks.waitForBackgroundThreads(seconds: 0.5)
+
+        /* Then */
+        XCTAssertTrue(mocks.client.hasExecutedRequestOfType(OSRequestCreateUser.self))
+        XCTAssertEqual(tagsSent, false)
+        // The create request is kept for a new session
+        XCTAssertEqual(mocks.userExecutor.userRequestQueue.count, 1)
+        OSOperationRepo.sharedInstance.paused = false
+    }
+
+    func testFetchUser_mergesIntoAPendingFetchOfTheSameUser() {
+        /* Setup */
+        let mocks = Mocks()
+        // The user cannot be fetched yet, so its fetches stay queued
+        let identityModel = OSIdentityModel(aliases: [OS_ONESIGNAL_ID: userA_OSID], changeNotifier: OSEventProducer())
+        mocks.newRecordsState.add(userA_OSID)
+
+        /* When */
+        mocks.userExecutor.fetchUser(aliasLabel: OS_ONESIGNAL_ID, aliasId: userA_OSID, identityModel: identityModel)
+        mocks.userExecutor.fetchUser(aliasLabel: OS_ONESIGNAL_ID, aliasId: userA_OSID, identityModel: identityModel)
+        mocks.userExecutor.fetchUser(aliasLabel: OS_ONESIGNAL_ID, aliasId: userA_OSID, identityModel: identityModel, onNewSession: true)
+        mocks.userExecutor.dispatchQueue.sync {}
+
+        /* Then */
+        let fetches = mocks.userExecutor.userRequestQueue.compactMap { $0 as? OSRequestFetchUser }
+        XCTAssertEqual(fetches.count, 2)
+        XCTAssertEqual(fetches.map { $0.onNewSession }, [false, true])
+    }
+
+    func testFetchIdentityBySubscription_withJitter_isHeldUntilItsStartTime() {
+        /* Setup */
+        let mocks = Mocks()
+        let user = mocks.createUserInstance(externalId: userA_EUID)
+        user.pushSubscriptionModel.subscriptionId = testPushSubId
+
+        /* When */
+        mocks.userExecutor.fetchIdentityBySubscription(user, maxJitter: 600)
+        OneSignalCoreMocks.waitForBackgroundThreads(seconds: 0.5)
+
+        /* Then */
+        XCTAssertFalse(mocks.client.hasExecutedRequestOfType(OSRequestFetchIdentityBySubscription.self))
+        let request = mocks.userExecutor.userRequestQueue.first as? OSRequestFetchIdentityBySubscription
+        XCTAssertNotNil(request?.notBefore)
+        XCTAssertLessThanOrEqual(request?.notBefore ?? .distantFuture, Date(timeIntervalSinceNow: 600))
+    }
+
+    /**
+     A held migration should schedule one flush for its start time rather than retrying, and should not hold back
+     a Create User request of another user that shares the push subscription partition.
+     */
+    func testFetchIdentityBySubscription_withJitter_schedulesOneFlushAndDoesNotBlockThePushSubscription() {
+        /* Setup */
+        let mocks = Mocks()
+        MockUserRequests.setDefaultCreateUserResponses(with: mocks.client, externalId: userB_EUID)
+        let clock = MockVirtualClock()
+        mocks.userExecutor.scheduler = clock.queue(target: mocks.userExecutor.dispatchQueue)
+        let migratingUser = mocks.createUserInstance(externalId: userA_EUID)
+        migratingUser.pushSubscriptionModel.subscriptionId = testPushSubId
+
+        /* When */
+        mocks.userExecutor.fetchIdentityBySubscription(migratingUser, maxJitter: 600)
+        mocks.userExecutor.createUser(mocks.createUserInstance(externalId: userB_EUID))
+        mocks.userExecutor.executePendingRequests()
+        mocks.userExecutor.executePendingRequests()
+        OneSignalCoreMocks.waitForBackgroundThreads(seconds: 0.5)
+
+        /* Then */
+        XCTAssertTrue(mocks.client.hasExecutedRequestOfType(OSRequestCreateUser.self))
+        XCTAssertFalse(mocks.client.hasExecutedRequestOfType(OSRequestFetchIdentityBySubscription.self))
+        XCTAssertEqual(clock.pendingCount, 1)
+
+        /* When */
+        mocks.userExecutor.dispatchQueue.sync {
+            (mocks.userExecutor.userRequestQueue.first as? OSRequestFetchIdentityBySubscription)?.notBefore = Date()
+        }
+        clock.advance(by: 600)
+        OneSignalCoreMocks.waitForBackgroundThreads(seconds: 0.5)
+
+        /* Then */
+        XCTAssertTrue(mocks.client.hasExecutedRequestOfType(OSRequestFetchIdentityBySubscription.self))
+    }
+
+    func testPersistedRequests_areReplayedAfterRelaunch_withoutCompletedOnes() {
+        /* Setup */
+        let mocks = Mocks()
+        let identityModelA = OSIdentityModel(aliases: [OS_EXTERNAL_ID: userA_EUID], changeNotifier: OSEventProducer())
+        let identityModelB = OSIdentityModel(aliases: [OS_EXTERNAL_ID: userB_EUID], changeNotifier: OSEventProducer())
+
+        // No responses are set, so both requests stay in the queue
+        mocks.userExecutor.createUser(aliasLabel: OS_EXTERNAL_ID, aliasId: userA_EUID, identityModel: identityModelA)
+        mocks.userExecutor.createUser(aliasLabel: OS_EXTERNAL_ID, aliasId: userB_EUID, identityModel: identityModelB)
+        mocks.userExecutor.dispatchQueue.sync {}
+        XCTAssertEqual(mocks.userExecutor.userRequestQueue.count, 2)
+
+        /* When */
+        // The first request completes, which only records its position in the log
+        mocks.userExecutor.removeFromQueue(mocks.userExecutor.userRequestQueue[0])
+        mocks.userExecutor.dispatchQueue.sync {}
+        XCTAssertTrue(OneSignalUserDefaults.initShared().keyExists(OS_USER_EXECUTOR_COMPLETED_REQUESTS_KEY))
+
+        let relaunchedExecutor = OSUserExecutor(newRecordsState: mocks.newRecordsState)
+        relaunchedExecutor.dispatchQueue.sync {}
+
+        /* Then */
+        let replayed = relaunchedExecutor.userRequestQueue.compactMap { $0 as? OSRequestCreateUser }
+        XCTAssertEqual(replayed.count, 1)
+        XCTAssertEqual(replayed.first?.identityModel.modelId, identityModelB.modelId)
+        // The log was compacted after replaying it
+        XCTAssertFalse(OneSignalUserDefaults.initShared().keyExists(OS_USER_EXECUTOR_APPENDED_REQUESTS_KEY))
+        XCTAssertFalse(OneSignalUserDefaults.initShared().keyExists(OS_USER_EXECUTOR_COMPLETED_REQUESTS_KEY))
+    }
 }
@@ -33,6 +33,14 @@ import OneSignalUserMocks
 @testable import OneSignalOSCore
 @testable import OneSignalUser
 
+private class ModelChangeCounter: OSModelChangedHandler {
+    var count = 0
+
+    func onModelUpdated(args: OSModelChangedArgs, hydrating: Bool) {
+        count += 1
+    }
+}
+
 final class OneSignalUserTests: XCTestCase {
 
     override func setUpWithError() throws {
@@ -150,4 +158,448 @@ final class OneSignalUserTests: XCTestCase {
             contains: expectedPayload)
         )
     }
+
+    func testRepeatedTagUpdates_areCoalescedInOperationRepo() throws {
+        /* Setup */
+        let client = MockOneSignalClient()
+        MockUserRequests.setDefaultCreateAnonUserResponses(with: client)
+        OneSignalCoreImpl.setSharedClient(client)
+
+        // Increase flush interval so the deltas stay in the Operation Repo
+        OSOperationRepo.sharedInstance.pollIntervalMilliseconds = 1000
+        OneSignalUserManagerImpl.sharedInstance.start()
+        OneSignalCoreMocks.waitForBackgroundThreads(seconds: 0.1)
+
+        /* When */
+        for index in 0..<20 {
+            OneSignalUserManagerImpl.sharedInstance.addTag(key: "tag_\(index % 5)", value: "value_\(index)")
+            OneSignalUserManagerImpl.sharedInstance.sendSessionTime(10)
+        }
+        OneSignalCoreMocks.waitForBackgroundThreads(seconds: 0.1)
+
+        /* Then */
+        let tagDeltas = OSOperationRepo.sharedInstance.deltaQueue.filter { $0.property == "tags" }
+        let sessionTimeDeltas = OSOperationRepo.sharedInstance.deltaQueue.filter { $0.property == "session_time" }
+        XCTAssertEqual(tagDeltas.count, 1)
+        XCTAssertEqual(tagDeltas.first?.value as? [String: String], ["tag_0": "value_15", "tag_1": "value_16", "tag_2": "value_17", "tag_3": "value_18", "tag_4": "value_19"])
+        XCTAssertEqual(sessionTimeDeltas.count, 1)
+        XCTAssertEqual(sessionTimeDeltas.first?.value as? Int, 200)
+    }
+
+    func testEdit_combinesChangesIntoSingleFlush() throws {
+        /* Setup */
+        let client = MockOneSignalClient()
+        MockUserRequests.setDefaultCreateAnonUserResponses(with: client)
+        OneSignalCoreImpl.setSharedClient(client)
+
+        // Increase flush interval so only an explicit flush sends the deltas
+        OSOperationRepo.sharedInstance.pollIntervalMilliseconds = 10000
+        OneSignalUserManagerImpl.sharedInstance.start()
+        OneSignalCoreMocks.waitForBackgroundThreads(seconds: 0.1)
+
+        /* When */
+        OneSignalUserManagerImpl.sharedInstance.edit { user in
+            for index in 0..<40 {
+                user.addTag(key: "tag_\(index)", value: "value_\(index)")
+            }
+            user.setLanguage("fr")
+        }
+        OneSignalCoreMocks.waitForBackgroundThreads(seconds: 0.1)
+
+        /* Then */
+        let tagDeltas = OSOperationRepo.sharedInstance.deltaQueue.filter { $0.property == "tags" }
+        XCTAssertEqual(tagDeltas.count, 1)
+        XCTAssertEqual((tagDeltas.first?.value as? [String: String])?.count, 40)
+        XCTAssertEqual(OSOperationRepo.sharedInstance.deltaQueue.filter { $0.property == "language" }.count, 1)
+
+        /* When */
+        OneSignalUserManagerImpl.sharedInstance.edit(flush: true) { user in
+            user.addTag(key: "tag_40", value: "value_40")
+        }
+        OneSignalCoreMocks.waitForBackgroundThreads(seconds: 0.5)
+
+        /* Then */
+        XCTAssertTrue(OSOperationRepo.sharedInstance.deltaQueue.isEmpty)
+    }
+
+    func testOperationRepoFlush_runsOnVirtualTime() throws {
+        /* Setup */
+        let client = MockOneSignalClient()
+        MockUserRequests.setDefaultCreateAnonUserResponses(with: client)
+        OneSignalCoreImpl.setSharedClient(client)
+
+        // An hour long debounce window is simulated without waiting for it
+        let clock = MockVirtualClock()
+        let operationRepo = OSOperationRepo.sharedInstance
+        operationRepo.scheduler = clock.queue(target: operationRepo.dispatchQueue)
+        defer { operationRepo.scheduler = operationRepo.dispatchQueue }
+        operationRepo.pollIntervalMilliseconds = 3_600_000
+        OneSignalUserManagerImpl.sharedInstance.start()
+        OneSignalCoreMocks.waitForBackgroundThreads(seconds: 0.1)
+
+        /* When */
+        OneSignalUserManagerImpl.sharedInstance.addTag(key: "tag", value: "value")
+        OneSignalCoreMocks.waitForBackgroundThreads(seconds: 0.1)
+        clock.advance(by: 3599)
+        OneSignalCoreMocks.waitForBackgroundThreads(seconds: 0.1)
+
+        /* Then */
+        XCTAssertFalse(client.hasExecutedRequestOfType(OSRequestUpdateProperties.self))
+
+        /* When */
+        clock.advance(by: 1)
+        OneSignalCoreMocks.waitForBackgroundThreads(seconds: 0.1)
+
+        /* Then */
+        XCTAssertTrue(client.hasExecutedRequestOfType(OSRequestUpdateProperties.self))
+    }
+
+    func testOperationRepoPauseIdentity_holdsBackOnlyThatIdentitysDeltas() throws {
+        /* Setup */
+        let client = MockOneSignalClient()
+        MockUserRequests.setDefaultCreateAnonUserResponses(with: client)
+        OneSignalCoreImpl.setSharedClient(client)
+
+        OSOperationRepo.sharedInstance.pollIntervalMilliseconds = 100
+        OneSignalUserManagerImpl.sharedInstance.start()
+        OneSignalCoreMocks.waitForBackgroundThreads(seconds: 0.5)
+        let identityModelId = OneSignalUserManagerImpl.sharedInstance.user.identityModel.modelId
+
+        /* When */
+        OSOperationRepo.sharedInstance.pause(identityModelId: identityModelId)
+        OneSignalUserManagerImpl.sharedInstance.addTag(key: "tag", value: "value")
+        OneSignalCoreMocks.waitForBackgroundThreads(seconds: 0.5)
+
+        /* Then */
+        XCTAssertFalse(client.hasExecutedRequestOfType(OSRequestUpdateProperties.self))
+        XCTAssertFalse(OSOperationRepo.sharedInstance.paused)
+
+        /* When */
+        OSOperationRepo.sharedInstance.resume(identityModelId: identityModelId)
+        OneSignalCoreMocks.waitForBackgroundThreads(seconds: 0.5)
+
+        /* Then */
+        XCTAssertTrue(client.hasExecutedRequestOfType(OSRequestUpdateProperties.self))
+    }
+
+    func testOperationRepoPauseIdentity_resumesOnItsOwnAfterTheTimeout() throws {
+        /* Setup */
+        let client = MockOneSignalClient()
+        MockUserRequests.setDefaultCreateAnonUserResponses(with: client)
+        OneSignalCoreImpl.setSharedClient(client)
+
+        OSOperationRepo.sharedInstance.pollIntervalMilliseconds = 100
+        OneSignalUserManagerImpl.sharedInstance.start()
+        OneSignalCoreMocks.waitForBackgroundThreads(seconds: 0.5)
+        let identityModelId = OneSignalUserManagerImpl.sharedInstance.user.identityModel.modelId
+        var timedOut = false
+
+        /* When */
+        OSOperationRepo.sharedInstance.pause(identityModelId: identityModelId, timeoutSeconds: 1) {
+            timedOut = true
+        }
+        OneSignalUserManagerImpl.sharedInstance.addTag(key: "tag", value: "value")
+        OneSignalCoreMocks.waitForBackgroundThreads(seconds: 0.5)
+
+        /* Then */
+        XCTAssertTrue(OSOperationRepo.sharedInstance.isPaused(identityModelId: identityModelId))
+        XCTAssertFalse(client.hasExecutedRequestOfType(OSRequestUpdateProperties.self))
+
+        /* When */
+        OneSignalCoreMocks.waitForBackgroundThreads(seconds: 1)
+
+        /* Then */
+        XCTAssertTrue(timedOut)
+        XCTAssertFalse(OSOperationRepo.sharedInstance.isPaused(identityModelId: identityModelId))
+        XCTAssertTrue(client.hasExecutedRequestOfType(OSRequestUpdateProperties.self))
+    }
+
+    func testTagsSnapshot_isSharedUntilTheTagsChange() throws {
+        /* Setup */
+        let model = OSPropertiesModel(changeNotifier: OSEventProducer())
+        model.addTags(["a": "1"])
+
+        /* When */
+        let first = model.tagsSnapshot
+        let second = model.tagsSnapshot
+        model.addTags(["b": "2"])
+        let third = model.tagsSnapshot
+
+        /* Then */
+        XCTAssertTrue(first === second)
+        XCTAssertEqual(first.tags as? [String: String], ["a": "1"])
+        XCTAssertGreaterThan(third.version, first.version)
+        XCTAssertEqual(third.tags as? [String: String], ["a": "1", "b": "2"])
+    }
+
+    func testAddTagsCompletion_isCalledOnceTheTagsAreSent() throws {
+        /* Setup */
+        let client = MockOneSignalClient()
+        MockUserRequests.setDefaultCreateAnonUserResponses(with: client)
+        MockUserRequests.setAddTagsResponse(with: client, tags: ["tag": "value"])
+        OneSignalCoreImpl.setSharedClient(client)
+
+        OSOperationRepo.sharedInstance.pollIntervalMilliseconds = 100
+        OneSignalUserManagerImpl.sharedInstance.start()
+        OneSignalCoreMocks.waitForBackgroundThreads(seconds: 0.5)
+
+        /* When */
+        let expectation = expectation(description: "addTags completion is called")
+        OneSignalUserManagerImpl.sharedInstance.addTags(["tag": "value"]) { success in
+            /* Then */
+            XCTAssertTrue(success)
+            XCTAssertTrue(client.hasExecutedRequestOfType(OSRequestUpdateProperties.self))
+            expectation.fulfill()
+        }
+        waitForExpectations(timeout: 2.0)
+    }
+
+    func testOversizedUpdatePropertiesParams_areSplitByTags() throws {
+        /* Setup */
+        var tags: [String: String] = [:]
+        for index in 0..<10 {
+            tags["tag\(index)"] = String(repeating: "v", count: 20)
+        }
+        let params: [String: Any] = [
+            "properties": ["language": "en", "tags": tags],
+            "deltas": ["session_count": 1]
+        ]
+
+        /* When */
+        let parts = OSRequestUpdateProperties.splitParams(params, maxTagsBytes: 100)
+
+        /* Then */
+        XCTAssertEqual(parts.count, 4)
+        let partTags = parts.map { ($0["properties"] as? [String: Any])?["tags"] as? [String: String] ?? [:] }
+        XCTAssertEqual(partTags.reduce(into: [:]) { $0.merge($1) { _, new in new } }, tags)
+        XCTAssertEqual((parts[0]["properties"] as? [String: Any])?["language"] as? String, "en")
+        XCTAssertNotNil(parts[0]["deltas"])
+        XCTAssertNil(parts[1]["deltas"])
+        XCTAssertEqual(OSRequestUpdateProperties.splitParams(params, maxTagsBytes: 10_000).count, 1)
+    }
+
+    func testPendingUpdatePropertiesRequestsMerge() throws {
+        /* Setup */
+        let older: [String: Any] = [
+            "properties": ["language": "en", "tags": ["a": "1", "b": "1"]],
+            "refresh_device_metadata": true,
+            "deltas": ["session_time": 10, "session_count": 1, "purchases": [["sku": "one"]]]
+        ]
+        let newer: [String: Any] = [
+            "properties": ["language": "fr", "tags": ["b": "2", "c": "2"]],
+            "refresh_device_metadata": false,
+            "deltas": ["session_time": 5, "purchases": [["sku": "two"]]]
+        ]
+
+        /* When */
+        let merged = OSRequestUpdateProperties.mergeParams(older, newer)
+
+        /* Then */
+        let properties = merged["properties"] as? [String: Any]
+        XCTAssertEqual(properties?["language"] as? String, "fr")
+        XCTAssertEqual(properties?["tags"] as? [String: String], ["a": "1", "b": "2", "c": "2"])
+        XCTAssertEqual(merged["refresh_device_metadata"] as? Bool, true)
+        let deltas = merged["deltas"] as? [String: Any]
+        XCTAssertEqual(deltas?["session_time"] as? Int, 15)
+        XCTAssertEqual(deltas?["session_count"] as? Int, 1)
+        XCTAssertEqual((deltas?["purchases"] as? [[String: AnyObject]])?.count, 2)
+    }
+
+    func testSubscriptionExecutorFoldsCancellingRequests() throws {
+        /* Setup */
+        let executor = OSSubscriptionOperationExecutor(newRecordsState: OSNewRecordsState())
+        let identityModel = OSIdentityModel(aliases: [OS_ONESIGNAL_ID: UUID().uuidString], changeNotifier: OSEventProducer())
+        let emailModel = OSSubscriptionModel(type: .email, address: "test@example.com", subscriptionId: nil, reachable: true, isDisabled: false, changeNotifier: OSEventProducer())
+        let pushModel = OSSubscriptionModel(type: .push, address: "token", subscriptionId: UUID().uuidString, reachable: true, isDisabled: false, changeNotifier: OSEventProducer())
+
+        /* When */
+        executor.addRequestQueue = [OSRequestCreateSubscription(subscriptionModel: emailModel, identityModel: identityModel)]
+        executor.updateRequestQueue = [
+            OSRequestUpdateSubscription(subscriptionObject: ["enabled": false], subscriptionModel: pushModel),
+            OSRequestUpdateSubscription(subscriptionObject: ["enabled": true], subscriptionModel: pushModel),
+            OSRequestUpdateSubscription(subscriptionObject: ["enabled": true], subscriptionModel: emailModel)
+        ]
+        executor.removeRequestQueue = [OSRequestDeleteSubscription(subscriptionModel: emailModel)]
+        executor.foldRequestQueues()
+
+        /* Then */
+        XCTAssertTrue(executor.addRequestQueue.isEmpty)
+        XCTAssertTrue(executor.removeRequestQueue.isEmpty)
+        XCTAssertEqual(executor.updateRequestQueue.count, 1)
+        XCTAssertEqual(executor.updateRequestQueue.first?.subscriptionModel.modelId, pushModel.modelId)
+    }
+
+    func testSubscriptionExecutorSkipsUpdatesTheServerAlreadyAcknowledged() throws {
+        /* Setup */
+        let client = MockOneSignalClient()
+        client.fireSuccessForAllRequests = true
+        OneSignalCoreImpl.setSharedClient(client)
+        let executor = OSSubscriptionOperationExecutor(newRecordsState: OSNewRecordsState())
+        let pushModel = OSSubscriptionModel(type: .push, address: "token", subscriptionId: UUID().uuidString, reachable: true, isDisabled: false, changeNotifier: OSEventProducer())
+
+        /* When */
+        executor.executeUpdateSubscriptionRequest(OSRequestUpdateSubscription(subscriptionObject: ["enabled": true], subscriptionModel: pushModel), inBackground: false)
+        OneSignalCoreMocks.waitForBackgroundThreads(seconds: 0.5)
+        executor.executeUpdateSubscriptionRequest(OSRequestUpdateSubscription(subscriptionObject: ["enabled": true], subscriptionModel: pushModel), inBackground: false)
+        OneSignalCoreMocks.waitForBackgroundThreads(seconds: 0.5)
+
+        /* Then */
+        XCTAssertEqual(client.executedRequests.count, 1)
+
+        /* When */
+        pushModel.appVersion = "2.0.0"
+        executor.executeUpdateSubscriptionRequest(OSRequestUpdateSubscription(subscriptionObject: ["appVersion": "2.0.0"], subscriptionModel: pushModel), inBackground: false)
+        OneSignalCoreMocks.waitForBackgroundThreads(seconds: 0.5)
+
+        /* Then */
+        XCTAssertEqual(client.executedRequests.count, 2)
+    }
+
+    func testSubscriptionExecutorSkippedUpdateReleasesOnlyItsOwnUsersCondition() throws {
+        /* Setup */
+        let client = MockOneSignalClient()
+        client.fireSuccessForAllRequests = true
+        OneSignalCoreImpl.setSharedClient(client)
+        let pushModel = OSSubscriptionModel(type: .push, address: "token", subscriptionId: UUID().uuidString, reachable: true, isDisabled: false, changeNotifier: OSEventProducer())
+        let user = OneSignalUserManagerImpl.sharedInstance.setNewInternalUser(externalId: userA_EUID, pushSubscriptionModel: pushModel)
+        user.identityModel.hydrate([OS_ONESIGNAL_ID: userA_OSID, OS_EXTERNAL_ID: userA_EUID])
+        let otherIdentityModel = OSIdentityModel(aliases: [OS_ONESIGNAL_ID: userB_OSID], changeNotifier: OSEventProducer())
+        let executor = OSSubscriptionOperationExecutor(newRecordsState: OSNewRecordsState())
+        let userUpdateTokens = [userA_OSID: [NSNumber(value: OSIamFetchOffsetKey.userUpdate.rawValue): OSReadYourWriteData(rywToken: "1", rywDelay: nil)]]
+
+        executor.executeUpdateSubscriptionRequest(OSRequestUpdateSubscription(subscriptionObject: ["enabled": true], subscriptionModel: pushModel, identityModel: user.identityModel), inBackground: false)
+        OneSignalCoreMocks.waitForBackgroundThreads(seconds: 0.5)
+        let condition = OSIamFetchReadyCondition.sharedInstance(withId: userA_OSID)
+        condition.setSubscriptionUpdatePending(value: true)
+
+        /* When */
+        executor.executeUpdateSubscriptionRequest(OSRequestUpdateSubscription(subscriptionObject: ["enabled": true], subscriptionModel: pushModel, identityModel: otherIdentityModel), inBackground: false)
+        OneSignalCoreMocks.waitForBackgroundThreads(seconds: 0.5)
+
+        /* Then */
+        XCTAssertEqual(client.executedRequests.count, 1)
+        XCTAssertFalse(condition.isMet(indexedTokens: userUpdateTokens))
+
+        /* When */
+        executor.executeUpdateSubscriptionRequest(OSRequestUpdateSubscription(subscriptionObject: ["enabled": true], subscriptionModel: pushModel, identityModel: user.identityModel), inBackground: false)
+        OneSignalCoreMocks.waitForBackgroundThreads(seconds: 0.5)
+
+        /* Then */
+        XCTAssertEqual(client.executedRequests.count, 1)
+        XCTAssertTrue(condition.isMet(indexedTokens: userUpdateTokens))
+    }
+
+    func testSubscriptionExecutorSendsAnAcknowledgedUpdateAgainAfterAFailedOne() throws {
+        /* Setup */
+        let client = MockOneSignalClient()
+        client.fireSuccessForAllRequests = true
+        OneSignalCoreImpl.setSharedClient(client)
+        let executor = OSSubscriptionOperationExecutor(newRecordsState: OSNewRecordsState())
+        let pushModel = OSSubscriptionModel(type: .push, address: "token", subscriptionId: UUID().uuidString, reachable: true, isDisabled: false, changeNotifier: OSEventProducer())
+
+        executor.executeUpdateSubscriptionRequest(OSRequestUpdateSubscription(subscriptionObject: ["enabled": true], subscriptionModel: pushModel), inBackground: false)
+        OneSignalCoreMocks.waitForBackgroundThreads(seconds: 0.5)
+
+        /* When */
+        let appVersion = pushModel.appVersion
+        client.errorRate = 1
+        client.simulatedErrorStatusCode = 400
+        pushModel.appVersion = "2.0.0"
+        executor.executeUpdateSubscriptionRequest(OSRequestUpdateSubscription(subscriptionObject: ["appVersion": "2.0.0"], subscriptionModel: pushModel), inBackground: false)
+        OneSignalCoreMocks.waitForBackgroundThreads(seconds: 0.5)
+        client.errorRate = 0
+        pushModel.appVersion = appVersion
+        executor.executeUpdateSubscriptionRequest(OSRequestUpdateSubscription(subscriptionObject: ["enabled": true], subscriptionModel: pushModel), inBackground: false)
+        OneSignalCoreMocks.waitForBackgroundThreads(seconds: 0.5)
+
+        /* Then */
+        XCTAssertEqual(client.executedRequests.count, 3)
+    }
+
+    func testExecutorEnqueueDeltas_persistsTheWholeBatch() throws {
+        /* Setup */
+        let executor = OSPropertyOperationExecutor(newRecordsState: OSNewRecordsState())
+        let identityModel = OSIdentityModel(aliases: [OS_ONESIGNAL_ID: UUID().uuidString], changeNotifier: OSEventProducer())
+        let deltas = ["language", "timezone_id"].map { property in
+            OSDelta(name: OS_UPDATE_PROPERTIES_DELTA, identityModelId: identityModel.modelId, model: OSPropertiesModel(changeNotifier: OSEventProducer()), property: property, value: UUID().uuidString)
+        }
+
+        /* When */
+        executor.enqueueDeltas(deltas)
+        OneSignalCoreMocks.waitForBackgroundThreads(seconds: 0.5)
+
+        /* Then */
+        let persisted = OneSignalUserDefaults.initShared().getSavedCodeableData(forKey: OS_PROPERTIES_EXECUTOR_DELTA_QUEUE_KEY, defaultValue: []) as? [OSDelta]
+        XCTAssertEqual(persisted?.map { $0.property }, ["language", "timezone_id"])
+        XCTAssertEqual(executor.deltaQueue.count, 2)
+    }
+
+    func testIdentityExecutorFoldsAliasRequests() throws {
+        /* Setup */
+        let executor = OSIdentityOperationExecutor(newRecordsState: OSNewRecordsState())
+        let identityModel = OSIdentityModel(aliases: [OS_ONESIGNAL_ID: UUID().uuidString], changeNotifier: OSEventProducer())
+
+        /* When */
+        executor.addRequestQueue = [
+            OSRequestAddAliases(aliases: ["a": "1", "b": "1"], identityModel: identityModel),
+            OSRequestAddAliases(aliases: ["c": "1"], identityModel: identityModel)
+        ]
+        executor.removeRequestQueue = [
+            OSRequestRemoveAlias(labelToRemove: "b", identityModel: identityModel),
+            OSRequestRemoveAlias(labelToRemove: "d", identityModel: identityModel)
+        ]
+        executor.foldRequestQueues()
+
+        /* Then */
+        XCTAssertEqual(executor.addRequestQueue.count, 1)
+        XCTAssertEqual(executor.addRequestQueue.first?.aliases, ["a": "1", "c": "1"])
+        XCTAssertEqual(Set(executor.removeRequestQueue.map { $0.labelToRemove }), ["b", "d"])
+    }
+
+    func testLoginWithCurrentExternalIdKeepsUserAndTakesNewToken() throws {
+        /* Setup */
+        let client = MockOneSignalClient()
+        MockUserRequests.setDefaultCreateUserResponses(with: client, externalId: userA_EUID)
+        OneSignalCoreImpl.setSharedClient(client)
+
+        OneSignalUserManagerImpl.sharedInstance.login(externalId: userA_EUID, token: nil)
+        OneSignalCoreMocks.waitForBackgroundThreads(seconds: 0.5)
+        let identityModel = OneSignalUserManagerImpl.sharedInstance.user.identityModel
+        let requestCount = client.networkRequestCount
+
+        /* When */
+        OneSignalUserManagerImpl.sharedInstance.login(externalId: userA_EUID, token: "new-token")
+        OneSignalCoreMocks.waitForBackgroundThreads(seconds: 0.5)
+
+        /* Then */
+        XCTAssertTrue(OneSignalUserManagerImpl.sharedInstance.user.identityModel === identityModel)
+        XCTAssertEqual(identityModel.jwtBearerToken, "new-token")
+        XCTAssertEqual(client.networkRequestCount, requestCount)
+    }
+
+    func testHydratingUnchangedUserDataFiresNoModelChanges() throws {
+        /* Setup */
+        let counter = ModelChangeCounter()
+        let identityModel = OSIdentityModel(aliases: [OS_ONESIGNAL_ID: userA_OSID, OS_EXTERNAL_ID: userA_EUID], changeNotifier: OSEventProducer())
+        identityModel.changeNotifier.subscribe(counter)
+        let propertiesModel = OSPropertiesModel(changeNotifier: OSEventProducer())
+        propertiesModel.language = "en"
+        propertiesModel.changeNotifier.subscribe(counter)
+
+        /* When */
+        identityModel.hydrate([OS_ONESIGNAL_ID: userA_OSID, OS_EXTERNAL_ID: userA_EUID])
+        propertiesModel.hydrate(["language": "en"])
+
+        /* Then */
+        XCTAssertEqual(counter.count, 0)
+
+        /* When */
+        identityModel.hydrate([OS_ONESIGNAL_ID: userA_OSID, OS_EXTERNAL_ID: userA_EUID, "custom": "alias"])
+        propertiesModel.hydrate(["language": "fr"])
+
+        /* Then */
+        XCTAssertEqual(counter.count, 2)
+        XCTAssertEqual(identityModel.aliases["custom"], "alias")
+        XCTAssertEqual(propertiesModel.language, "fr")
+    }
 }
@@ -0,0 +1,76 @@
+/*
+ Modified MIT License
+
+ Copyright 2024 OneSignal
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ 1. The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ 2. All copies of substantial portions of the Software may only be used in connection
+ with services provided by OneSignal.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ */
+
+import XCTest
+import OneSignalCore
+import OneSignalCoreMocks
+import OneSignalUserMocks
+@testable import OneSignalOSCore
+@testable import OneSignalUser
+
+/**
+ Replays worst-case user sessions through `MockLoadHarness`, checking that the SDK's queues stay bounded and drain.
+ A failing assertion includes the session's report, the numbers to compare when sizing changes to batching, limits or retries.
+ */
+final class UserLoadTests: XCTestCase {
+
+    override func setUpWithError() throws {
+        OneSignalCoreMocks.clearUserDefaults()
+        OneSignalUserMocks.reset()
+        // App ID is set because User Manager has guards against nil App ID
+        OneSignalConfigManager.setAppId("test-app-id")
+        OneSignalLog.setLogLevel(.LL_NONE)
+    }
+
+    override func tearDownWithError() throws {
+        OneSignalLog.setLogLevel(.LL_WARN)
+    }
+
+    func testWorstSessionDrainsWithinTheQueueLimits() throws {
+        /* Setup */
+        let client = MockOneSignalClient()
+        client.randomSeed = 42
+        client.latencies = [20, 50, 80, 150, 400]
+        client.errorRate = 0.05
+        OneSignalCoreImpl.setSharedClient(client)
+        OneSignalUserManagerImpl.sharedInstance.start()
+
+        /* When */
+        let report = MockLoadHarness(client: client).run([
+            .tagStorm(tags: 200),
+            .loginLogoutChurn(cycles: 10),
+            .offline(seconds: 0.5, tags: 100),
+            .tagStorm(tags: 200),
+            .idle(seconds: 1)
+        ], drainFor: 3)
+
+        /* Then */
+        XCTAssertGreaterThan(report.requestCount, 0, "worst session: \(report)")
+        XCTAssertLessThanOrEqual(report.maxQueueDepth, Int(OS_OPERATION_REPO_DELTA_QUEUE_LIMIT + 3 * OS_EXECUTOR_REQUEST_QUEUE_LIMIT), "worst session: \(report)")
+        XCTAssertEqual(report.finalQueueDepth, 0, "worst session: \(report)")
+    }
+}
@@ -0,0 +1,160 @@
+/*
+ Modified MIT License
+
+ Copyright 2024 OneSignal
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ 1. The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ 2. All copies of substantial portions of the Software may only be used in connection
+ with services provided by OneSignal.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ */
+
+import XCTest
+import OneSignalCore
+import OneSignalCoreMocks
+import OneSignalUserMocks
+@testable import OneSignalOSCore
+@testable import OneSignalUser
+
+/**
+ Benchmarks of the user module's hot paths, run against the real operation repo and model stores with a mock client.
+ */
+final class UserPerformanceTests: XCTestCase {
+
+    override func setUpWithError() throws {
+        OneSignalCoreMocks.clearUserDefaults()
+        OneSignalUserMocks.reset()
+        // App ID is set because User Manager has guards against nil App ID
+        OneSignalConfigManager.setAppId("test-app-id")
+        OneSignalCoreImpl.setSharedClient(MockOneSignalClient())
+        // Formatting log messages would dominate the measurements
+        OneSignalLog.setLogLevel(.LL_NONE)
+    }
+
+    override func tearDownWithError() throws {
+        OneSignalLog.setLogLevel(.LL_WARN)
+    }
+
+    func testOperationRepoEnqueueAndFlushOf1000Deltas() throws {
+        let operationRepo = OSOperationRepo.sharedInstance
+        var iteration = 0
+        measure {
+            iteration += 1
+            for num in 0..<1000 {
+                OneSignalUserManagerImpl.sharedInstance.addTag(key: "tag\(num)", value: "value\(iteration)")
+            }
+            operationRepo.addFlushDeltaQueueToDispatchQueue()
+            // Wait for the enqueues and the flush that hands the deltas off to the executors
+            operationRepo.dispatchQueue.sync {}
+        }
+    }
+
+    func testModelStorePersistenceOf500Models() throws {
+        let store = OSModelStore<OSIdentityModel>(changeSubscription: OSEventProducer(), storeKey: "OS_PERFORMANCE_TEST_MODEL_STORE_KEY")
+        measure {
+            for num in 0..<500 {
+                let model = OSIdentityModel(aliases: [OS_ONESIGNAL_ID: UUID().uuidString], changeNotifier: OSEventProducer())
+                store.add(id: "model\(num)", model: model, hydrating: false)
+            }
+            OSModelStorePersistence.queue.sync {}
+            OneSignalUserDefaults.flushPendingWrites()
+        }
+        store.clearModelsFromStore()
+    }
+
+    /**
+     The budget for an idle SDK is no work at all. Once startup settles, the SDK idles on its own dispatch queues and timers while
+     the CPU and clock metrics are reported. The schedulers of the operation repo and user executor count every work item that runs,
+     and a short poll interval would make any polling loop wake up many times within the idle period.
+     */
+    func testIdleSDKStaysWithinItsWakeupBudget() throws {
+        /* Setup */
+        let client = MockOneSignalClient()
+        MockUserRequests.setDefaultCreateAnonUserResponses(with: client)
+        OneSignalCoreImpl.setSharedClient(client)
+        let operationRepo = OSOperationRepo.sharedInstance
+        operationRepo.pollIntervalMilliseconds = 100
+        let operationRepoScheduler = WakeupCountingScheduler(target: operationRepo.dispatchQueue)
+        operationRepo.scheduler = operationRepoScheduler
+        defer { operationRepo.scheduler = operationRepo.dispatchQueue }
+        OneSignalUserManagerImpl.sharedInstance.start()
+        let userExecutor = try XCTUnwrap(OneSignalUserManagerImpl.sharedInstance.userExecutor)
+        let userExecutorScheduler = WakeupCountingScheduler(target: userExecutor.dispatchQueue)
+        userExecutor.scheduler = userExecutorScheduler
+        // Let the startup requests and flushes settle
+        OneSignalCoreMocks.waitForBackgroundThreads(seconds: 1)
+        let requestCount = client.executedRequests.count
+        operationRepoScheduler.reset()
+        userExecutorScheduler.reset()
+        OSFlightRecorder.clear()
+        var busyCount = 0
+        let observer = NotificationCenter.default.addObserver(forName: Notification.Name(OS_OPERATION_REPO_DID_BECOME_BUSY), object: nil, queue: nil) { _ in
+            busyCount += 1
+        }
+        defer { NotificationCenter.default.removeObserver(observer) }
+
+        /* When */
+        let options = XCTMeasureOptions()
+        options.iterationCount = 3
+        measure(metrics: [XCTCPUMetric(), XCTClockMetric()], options: options) {
+            RunLoop.main.run(until: Date(timeIntervalSinceNow: 1))
+        }
+
+        /* Then */
+        XCTAssertEqual(operationRepoScheduler.wakeupCount, 0, "An idle operation repo must not run scheduled work")
+        XCTAssertEqual(userExecutorScheduler.wakeupCount, 0, "An idle user executor must not run scheduled work")
+        XCTAssertEqual(busyCount, 0, "An idle operation repo must not become busy")
+        XCTAssertEqual(client.executedRequests.count, requestCount, "An idle SDK must not send requests")
+        XCTAssertFalse(OSFlightRecorder.events().contains { $0["event"] as? String == "DeltaQueueFlushed" })
+        XCTAssertTrue(operationRepo.isIdle)
+    }
+}
+
+/// Runs work on the real queue, with real timers, and counts the work items that run.
+private class WakeupCountingScheduler: OSDispatchQueue {
+    private let target: DispatchQueue
+    private let lock = NSLock()
+    private var count = 0
+
+    init(target: DispatchQueue) {
+        self.target = target
+    }
+
+    var wakeupCount: Int {
+        lock.withLock { count }
+    }
+
+    func reset() {
+        lock.withLock { count = 0 }
+    }
+
+    func async(execute work: @escaping @convention(block) () -> Void) {
+        target.async {
+            self.lock.withLock { self.count += 1 }
+            work()
+        }
+    }
+
+    func asyncAfterTime(deadline: DispatchTime, execute work: @escaping @Sendable @convention(block) () -> Void) {
+        target.asyncAfter(deadline: deadline) {
+            self.lock.withLock { self.count += 1 }
+            work()
+        }
+    }
+}
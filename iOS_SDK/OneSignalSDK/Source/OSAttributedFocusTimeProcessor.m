@@ -31,11 +31,13 @@
 #import <OneSignalUser/OneSignalUser.h>
 
 @interface OneSignal ()
-+ (void)sendSessionEndOutcomes:(NSNumber*)totalTimeActive params:(OSFocusCallParams *)params onSuccess:(OSResultSuccessBlock _Nonnull)successBlock onFailure:(OSFailureBlock _Nonnull)failureBlock;
++ (void)sendSessionEndOutcomes:(NSNumber*)totalTimeActive params:(OSFocusCallParams *)params deferralDelay:(NSTimeInterval)deferralDelay onSuccess:(OSResultSuccessBlock _Nonnull)successBlock onFailure:(OSFailureBlock _Nonnull)failureBlock;
++ (void)cancelDeferredSessionEndOutcomes;
 @end
 
 @implementation OSAttributedFocusTimeProcessor {
-    NSTimer* restCallTimer;
+    // The session end submitted on background is held by the system until this date, and can be cancelled before it
+    NSDate* deferredSessionEndDate;
 }
 
 static let ATTRIBUTED_MIN_SESSION_TIME_SEC = 1;
@@ -43,7 +45,6 @@ static let DELAY_TIME = 30;
 
 - (instancetype)init {
     self = [super init];
-    [OSBackgroundTaskManager setTaskInvalid:ATTRIBUTED_FOCUS_TASK];
     return self;
 }
 
@@ -63,8 +64,8 @@ static let DELAY_TIME = 30;
     
     [super saveUnsentActiveTime:totalTimeActive];
     
-    [OneSignalLog onesignalLog:ONE_S_LL_DEBUG message:[NSString stringWithFormat:@"OSAttributedFocusTimeProcessor:sendSessionTime of %@", @(params.timeElapsed)]];
-    [OneSignalUserManagerImpl.sharedInstance sendSessionTime:@(params.timeElapsed)];
+    ONE_S_LOG(ONE_S_LL_DEBUG, @"OSAttributedFocusTimeProcessor:bufferSessionTime of %f", params.timeElapsed);
+    [OSBaseFocusTimeProcessor bufferSessionTime:params.timeElapsed];
 
     [self sendOnFocusCallWithParams:params totalTimeActive:totalTimeActive];
 }
@@ -80,54 +81,64 @@ static let DELAY_TIME = 30;
 - (void)sendOnFocusCallWithParams:(OSFocusCallParams *)params totalTimeActive:(NSTimeInterval)totalTimeActive {
     // Don't send influenced session with time < 1 seconds
     if (totalTimeActive < 1) {
-        [OneSignalLog onesignalLog:ONE_S_LL_DEBUG message:[NSString stringWithFormat:@"sendSessionEndOutcomes not sending active time %f", totalTimeActive]];
+        ONE_S_LOG(ONE_S_LL_DEBUG, @"sendSessionEndOutcomes not sending active time %f", totalTimeActive);
         return;
     }
     
-    [OSBackgroundTaskManager beginBackgroundTask:ATTRIBUTED_FOCUS_TASK];
+    // On background the session may still continue if the app returns within DELAY_TIME, so the system holds the upload until then
+    let deferralDelay = params.onSessionEnded ? 0 : DELAY_TIME;
+    [self sendBackgroundAttributedSessionTimeWithParams:params withTotalTimeActive:totalTimeActive deferralDelay:deferralDelay];
+}
 
-    if (params.onSessionEnded) {
-        [self sendBackgroundAttributedSessionTimeWithParams:params withTotalTimeActive:@(totalTimeActive)];
-        return;
+/*
+ The session end is a background upload the system delivers even if the app is suspended or terminated,
+ so no background task is held for it. Once submitted the time is no longer unsent,
+ it is restored by the failure block alone, which is also how a cancel by the app returning to the foreground is reported.
+ */
+- (void)sendBackgroundAttributedSessionTimeWithParams:(OSFocusCallParams *)params withTotalTimeActive:(NSTimeInterval)totalTimeActive deferralDelay:(NSTimeInterval)deferralDelay {
+    [OneSignalLog onesignalLog:ONE_S_LL_DEBUG message:@"OSAttributedFocusTimeProcessor:sendBackgroundAttributedSessionTimeWithParams start"];
+    
+    @synchronized (self) {
+        deferredSessionEndDate = deferralDelay > 0 ? [NSDate dateWithTimeIntervalSinceNow:deferralDelay] : nil;
+        [super saveUnsentActiveTime:0];
     }
     
-    restCallTimer = [NSTimer
-        scheduledTimerWithTimeInterval:DELAY_TIME
-                               target:self
-                             selector:@selector(sendBackgroundAttributedSessionTimeWithNSTimer:)
-                             userInfo:@{@"params": params, @"time": @(totalTimeActive)}
-                              repeats:false];
+    [self sendSessionEndOutcomes:totalTimeActive params:params deferralDelay:deferralDelay onSuccess:^(NSDictionary *result) {
+        [OneSignalLog onesignalLog:ONE_S_LL_DEBUG message:@"sendBackgroundAttributed succeed"];
+    } onFailure:^(NSError *error) {
+        if ([error.domain isEqualToString:NSURLErrorDomain] && error.code == NSURLErrorCancelled) {
+            [OneSignalLog onesignalLog:ONE_S_LL_DEBUG message:@"sendBackgroundAttributed cancelled, the session continues"];
+        } else {
+            [OneSignalLog onesignalLog:ONE_S_LL_ERROR message:@"sendBackgroundAttributed failed, will retry on next open"];
+        }
+        [self restoreUnsentActiveTime:totalTimeActive];
+    }];
 }
 
-- (void)sendBackgroundAttributedSessionTimeWithNSTimer:(NSTimer*)timer {
-    let userInfo = (NSDictionary<NSString*, id>*)timer.userInfo;
-    let params = (OSFocusCallParams*)userInfo[@"params"];
-    let totalTimeActive = (NSNumber*)userInfo[@"time"];
-    [self sendBackgroundAttributedSessionTimeWithParams:params withTotalTimeActive:totalTimeActive];
+- (void)sendSessionEndOutcomes:(NSTimeInterval)totalTimeActive params:(OSFocusCallParams *)params deferralDelay:(NSTimeInterval)deferralDelay onSuccess:(OSResultSuccessBlock _Nonnull)successBlock onFailure:(OSFailureBlock _Nonnull)failureBlock {
+    [OneSignal sendSessionEndOutcomes:@(totalTimeActive) params:params deferralDelay:deferralDelay onSuccess:successBlock onFailure:failureBlock];
 }
 
-- (void)sendBackgroundAttributedSessionTimeWithParams:(OSFocusCallParams *)params withTotalTimeActive:(NSNumber*)totalTimeActive {
-    [OneSignalLog onesignalLog:ONE_S_LL_DEBUG message:@"OSAttributedFocusTimeProcessor:sendBackgroundAttributedSessionTimeWithParams start"];
-
-    dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
-        [OneSignal sendSessionEndOutcomes:totalTimeActive params:params onSuccess:^(NSDictionary *result) {
-            [OneSignalLog onesignalLog:ONE_S_LL_DEBUG message:@"sendBackgroundAttributed succeed"];
-            [super saveUnsentActiveTime:0];
-            [OSBackgroundTaskManager endBackgroundTask:ATTRIBUTED_FOCUS_TASK];
-        } onFailure:^(NSError *error) {
-            [OneSignalLog onesignalLog:ONE_S_LL_ERROR message:@"sendBackgroundAttributed failed, will retry on next open"];
-            [OSBackgroundTaskManager endBackgroundTask:ATTRIBUTED_FOCUS_TASK];
-        }];
-    });
+- (void)restoreUnsentActiveTime:(NSTimeInterval)time {
+    @synchronized (self) {
+        [super saveUnsentActiveTime:[super getUnsentActiveTime] + time];
+    }
 }
 
 - (void)cancelDelayedJob {
-    if (!restCallTimer)
-        return;
+    @synchronized (self) {
+        if (!deferredSessionEndDate)
+            return;
+        
+        let begun = [deferredSessionEndDate timeIntervalSinceNow] <= 0;
+        deferredSessionEndDate = nil;
+        // Past its begin date the upload may already be delivered, leave it to finish
+        if (begun)
+            return;
+    }
     
-    [restCallTimer invalidate];
-    restCallTimer = nil;
-    [OSBackgroundTaskManager endBackgroundTask:ATTRIBUTED_FOCUS_TASK];
+    // The failure block of the cancelled upload restores its time
+    [OneSignal cancelDeferredSessionEndOutcomes];
 }
 
 @end
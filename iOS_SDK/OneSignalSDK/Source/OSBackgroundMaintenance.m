@@ -0,0 +1,116 @@
+/**
+ * Modified MIT License
+ *
+ * Copyright 2024 OneSignal
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * 2. All copies of substantial portions of the Software may only be used in connection
+ * with services provided by OneSignal.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#import "OSBackgroundMaintenance.h"
+#import <BackgroundTasks/BackgroundTasks.h>
+#import <OneSignalCore/OneSignalCore.h>
+#import <OneSignalOSCore/OneSignalOSCore-Swift.h>
+
+#define OS_MAINTENANCE_BACKGROUND_TASK @"maintenance"
+
+static BOOL _taskRegistered = NO;
+
+@implementation OSBackgroundMaintenance
+
++ (BOOL)isTaskPermitted {
+    NSArray *permitted = [NSBundle.mainBundle objectForInfoDictionaryKey:@"BGTaskSchedulerPermittedIdentifiers"];
+    return [permitted isKindOfClass:[NSArray class]] && [permitted containsObject:OS_MAINTENANCE_TASK_IDENTIFIER];
+}
+
++ (void)registerTask {
+    static dispatch_once_t once;
+    dispatch_once(&once, ^{
+        if (@available(iOS 13.0, *)) {
+            if (![self isTaskPermitted]) {
+                [OneSignalLog onesignalLog:ONE_S_LL_DEBUG message:@"OSBackgroundMaintenance: task identifier not permitted, maintenance runs when the app is backgrounded"];
+                return;
+            }
+            @try {
+                _taskRegistered = [BGTaskScheduler.sharedScheduler registerForTaskWithIdentifier:OS_MAINTENANCE_TASK_IDENTIFIER usingQueue:nil launchHandler:^(BGTask *task) {
+                    [self runTask:(BGProcessingTask *)task];
+                }];
+            } @catch (NSException *exception) {
+                // Thrown when registering after the app finished launching, e.g. a late OneSignal.initialize
+                [OneSignalLog onesignalLog:ONE_S_LL_WARN message:[NSString stringWithFormat:@"OSBackgroundMaintenance: could not register task: %@", exception.reason]];
+            }
+        }
+    });
+}
+
++ (void)runTask:(BGProcessingTask *)task API_AVAILABLE(ios(13.0)) {
+    __block BOOL expired = NO;
+    let lock = [NSObject new];
+    task.expirationHandler = ^{
+        @synchronized (lock) {
+            expired = YES;
+        }
+    };
+    [OSMaintenanceScheduler.sharedScheduler runJobsWithShouldContinue:^BOOL{
+        @synchronized (lock) {
+            return !expired;
+        }
+    } completion:^(BOOL finished) {
+        [OneSignalLog onesignalLog:ONE_S_LL_VERBOSE message:[NSString stringWithFormat:@"OSBackgroundMaintenance: task finished: %d", finished]];
+        [task setTaskCompletedWithSuccess:finished];
+        [self submitRequest];
+    }];
+}
+
++ (void)submitRequest API_AVAILABLE(ios(13.0)) {
+    let request = [[BGProcessingTaskRequest alloc] initWithIdentifier:OS_MAINTENANCE_TASK_IDENTIFIER];
+    request.requiresExternalPower = YES;
+    request.requiresNetworkConnectivity = NO;
+    request.earliestBeginDate = [OSMaintenanceScheduler.sharedScheduler nextRunDate];
+    NSError *error;
+    if (![BGTaskScheduler.sharedScheduler submitTaskRequest:request error:&error]) {
+        [OneSignalLog onesignalLog:ONE_S_LL_DEBUG message:[NSString stringWithFormat:@"OSBackgroundMaintenance: could not schedule task: %@", error]];
+    }
+}
+
++ (void)scheduleTask {
+    if (@available(iOS 13.0, *)) {
+        if (_taskRegistered) {
+            // Replaces the pending request, if any
+            [self submitRequest];
+            return;
+        }
+    }
+
+    let scheduler = OSMaintenanceScheduler.sharedScheduler;
+    if (![scheduler isDue]) {
+        return;
+    }
+    [OSBackgroundTaskManager beginBackgroundTask:OS_MAINTENANCE_BACKGROUND_TASK];
+    [scheduler runJobsWithShouldContinue:^BOOL{
+        return [OSBackgroundTaskManager hasTimeForBackgroundWork];
+    } completion:^(BOOL finished) {
+        [OSBackgroundTaskManager endBackgroundTask:OS_MAINTENANCE_BACKGROUND_TASK];
+    }];
+}
+
+@end
@@ -30,13 +30,22 @@
 #import <OneSignalCore/OneSignalCore.h>
 #import <UIKit/UIKit.h>
 
-@implementation OSBackgroundTaskHandlerImpl
-
-NSMutableDictionary<NSString*, NSNumber*> *tasks;
+/*
+ All SDK background tasks share one UIKit background task. Each task identifier holds a reference on it,
+ it begins with the first identifier and ends with the last one, or for all of them at once when it expires.
+ */
+@implementation OSBackgroundTaskHandlerImpl {
+    // Synchronized on self
+    NSMutableSet<NSString *> *_activeTasks;
+    UIBackgroundTaskIdentifier _sharedTask;
+    // When the shared task expires, nil while the app has unlimited time in the foreground
+    NSDate *_expirationDate;
+}
 
 - (instancetype)init {
     self = [super init];
-    tasks = [NSMutableDictionary new];
+    _activeTasks = [NSMutableSet new];
+    _sharedTask = UIBackgroundTaskInvalid;
     return self;
 }
 
@@ -44,26 +53,38 @@ NSMutableDictionary<NSString*, NSNumber*> *tasks;
     [OneSignalLog onesignalLog:ONE_S_LL_DEBUG
                      message:[NSString stringWithFormat:
                               @"OSBackgroundTaskManagerImpl:beginBackgroundTask: %@", taskIdentifier]];
-    UIBackgroundTaskIdentifier uiIdentifier = [UIApplication.sharedApplication beginBackgroundTaskWithExpirationHandler:^{
-        [OneSignalLog onesignalLog:ONE_S_LL_DEBUG
-                         message:[NSString stringWithFormat:
-                                  @"OSBackgroundTaskManagerImpl: expirationHandler called for %@", taskIdentifier]];
-        [self endBackgroundTask:taskIdentifier];
-    }];
-    @synchronized (tasks) {
-        tasks[taskIdentifier] = [NSNumber numberWithUnsignedLong:uiIdentifier];
+    @synchronized (self) {
+        [_activeTasks addObject:taskIdentifier];
+        if (_sharedTask == UIBackgroundTaskInvalid) {
+            _sharedTask = [UIApplication.sharedApplication beginBackgroundTaskWithExpirationHandler:^{
+                [self expireSharedTask];
+            }];
+        }
     }
+    /*
+     Read again on every begin, the time left changes while the shared task is held:
+     it becomes limited when the app backgrounds and unlimited again when it returns to the foreground.
+     backgroundTimeRemaining must be read on the main thread, readers use the resulting date instead.
+     */
+    dispatch_async(dispatch_get_main_queue(), ^{
+        NSTimeInterval timeRemaining = [self applicationBackgroundTimeRemaining];
+        @synchronized (self) {
+            if (self->_sharedTask == UIBackgroundTaskInvalid)
+                return;
+            self->_expirationDate = timeRemaining < DBL_MAX ? [NSDate dateWithTimeIntervalSinceNow:timeRemaining] : nil;
+        }
+    });
+}
+
+// Must be called on the main thread
+- (NSTimeInterval)applicationBackgroundTimeRemaining {
+    return UIApplication.sharedApplication.backgroundTimeRemaining;
 }
 
 - (void)endBackgroundTask:(NSString * _Nonnull)taskIdentifier {
-    @synchronized (tasks) {
-        UIBackgroundTaskIdentifier uiIdentifier = [[tasks objectForKey:taskIdentifier] unsignedLongValue];
-        [OneSignalLog onesignalLog:ONE_S_LL_DEBUG
-                         message:[NSString stringWithFormat:
-                                  @"OSBackgroundTaskManagerImpl:endBackgroundTask: %@ with UIBackgroundTaskIdentifier %lu",
-                                  taskIdentifier, (unsigned long)uiIdentifier]];
-        [UIApplication.sharedApplication endBackgroundTask:uiIdentifier];
-    }
+    [OneSignalLog onesignalLog:ONE_S_LL_DEBUG
+                     message:[NSString stringWithFormat:
+                              @"OSBackgroundTaskManagerImpl:endBackgroundTask: %@", taskIdentifier]];
     [self setTaskInvalid:taskIdentifier];
 }
 
@@ -71,9 +92,36 @@ NSMutableDictionary<NSString*, NSNumber*> *tasks;
  This method is called when the background task ends or directly by other services within the SDK
  */
 - (void)setTaskInvalid:(NSString * _Nonnull)taskIdentifier {
-    @synchronized (tasks) {
-        tasks[taskIdentifier] = [NSNumber numberWithUnsignedLong:UIBackgroundTaskInvalid];
+    @synchronized (self) {
+        [_activeTasks removeObject:taskIdentifier];
+        if (_activeTasks.count == 0)
+            [self endSharedTask];
+    }
+}
+
+- (NSTimeInterval)backgroundTimeRemaining {
+    @synchronized (self) {
+        return _expirationDate ? MAX(0, _expirationDate.timeIntervalSinceNow) : DBL_MAX;
     }
 }
 
+- (void)expireSharedTask {
+    @synchronized (self) {
+        [OneSignalLog onesignalLog:ONE_S_LL_DEBUG
+                         message:[NSString stringWithFormat:
+                                  @"OSBackgroundTaskManagerImpl: expirationHandler called for %@", _activeTasks.allObjects]];
+        [_activeTasks removeAllObjects];
+        [self endSharedTask];
+    }
+}
+
+// Must be synchronized on self
+- (void)endSharedTask {
+    if (_sharedTask == UIBackgroundTaskInvalid)
+        return;
+    [UIApplication.sharedApplication endBackgroundTask:_sharedTask];
+    _sharedTask = UIBackgroundTaskInvalid;
+    _expirationDate = nil;
+}
+
 @end
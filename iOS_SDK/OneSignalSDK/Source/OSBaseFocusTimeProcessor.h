@@ -46,4 +46,8 @@
 - (NSTimeInterval)getUnsentActiveTime;
 - (void)saveUnsentActiveTime:(NSTimeInterval)time;
 
++ (void)bufferSessionTime:(NSTimeInterval)sessionTime;
++ (void)flushPendingSessionTime;
++ (void)clearStatics;
+
 @end
@@ -27,10 +27,17 @@
 
 #import "OSBaseFocusTimeProcessor.h"
 #import "OneSignalInternal.h"
+#import <OneSignalUser/OneSignalUser.h>
+
+// Session time sent by every processor, accumulated until OS_SESSION_TIME_FLUSH_DELAY passes without a focus change
+static NSTimeInterval _pendingSessionTime;
+static BOOL _pendingSessionTimeLoaded;
+static NSUInteger _sessionTimeGeneration;
 
 // This is an abstract class
 @implementation OSBaseFocusTimeProcessor {
-    NSNumber* unsentActiveTime;
+    NSTimeInterval unsentActiveTime;
+    BOOL unsentActiveTimeLoaded;
 }
 
 // Must override
@@ -40,12 +47,14 @@
 }
 
 - (BOOL)hasMinSyncTime:(NSTimeInterval)activeTime {
-    [OneSignalLog onesignalLog:ONE_S_LL_DEBUG message:[NSString stringWithFormat:@"OSBaseFocusTimeProcessor hasMinSyncTime getMinSessionTime: %d activeTime: %f", [self getMinSessionTime], activeTime]];
+    ONE_S_LOG(ONE_S_LL_DEBUG, @"OSBaseFocusTimeProcessor hasMinSyncTime getMinSessionTime: %d activeTime: %f", [self getMinSessionTime], activeTime);
     return activeTime >= [self getMinSessionTime];
 }
 
 - (void)resetUnsentActiveTime {
-    unsentActiveTime = nil;
+    @synchronized (self) {
+        unsentActiveTimeLoaded = NO;
+    }
 }
 
 - (NSString*)unsentActiveTimeUserDefaultsKey {
@@ -54,8 +63,15 @@
 }
 
 - (void)saveUnsentActiveTime:(NSTimeInterval)time {
-    unsentActiveTime = @(time);
-    [OneSignalUserDefaults.initShared saveObjectForKey:self.unsentActiveTimeUserDefaultsKey withValue:unsentActiveTime];
+    @synchronized (self) {
+        // Most focus changes leave this at 0, only touch UserDefaults when it actually changes
+        if (unsentActiveTimeLoaded && unsentActiveTime == time) {
+            return;
+        }
+        unsentActiveTime = time;
+        unsentActiveTimeLoaded = YES;
+        [OneSignalUserDefaults.initShared saveObjectForKey:self.unsentActiveTimeUserDefaultsKey withValue:@(time)];
+    }
 }
 
 // Must override
@@ -77,10 +93,79 @@
 }
 
 - (NSTimeInterval)getUnsentActiveTime {
-    if (!unsentActiveTime)
-        unsentActiveTime = [OneSignalUserDefaults.initShared getSavedObjectForKey:self.unsentActiveTimeUserDefaultsKey defaultValue:@0];
-    
-    return [unsentActiveTime doubleValue];
+    @synchronized (self) {
+        if (!unsentActiveTimeLoaded) {
+            NSNumber *saved = [OneSignalUserDefaults.initShared getSavedObjectForKey:self.unsentActiveTimeUserDefaultsKey defaultValue:@0];
+            unsentActiveTime = [saved doubleValue];
+            unsentActiveTimeLoaded = YES;
+        }
+        return unsentActiveTime;
+    }
+}
+
+/*
+ A flurry of focus changes would otherwise enqueue, and persist, a session_time delta each.
+ The session time is added to a running total instead, persisted so it survives termination,
+ and sent as one delta of whole seconds after OS_SESSION_TIME_FLUSH_DELAY without another focus change.
+ The fraction left over waits for the next flush. Time left over from a terminated launch is added to the next total.
+ Backgrounding flushes right away, see OneSignalTracker's applicationBackgrounded.
+ */
++ (void)bufferSessionTime:(NSTimeInterval)sessionTime {
+    if (sessionTime <= 0) {
+        return;
+    }
+    NSUInteger generation;
+    @synchronized (self) {
+        [self loadPendingSessionTime];
+        _pendingSessionTime += sessionTime;
+        [OneSignalUserDefaults.initShared saveDoubleForKey:OSUD_PENDING_SESSION_TIME withValue:_pendingSessionTime];
+        generation = ++_sessionTimeGeneration;
+    }
+    if (OS_SESSION_TIME_FLUSH_DELAY == 0) {
+        [self flushPendingSessionTime];
+        return;
+    }
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(OS_SESSION_TIME_FLUSH_DELAY * NSEC_PER_SEC)), OSDispatchQueues.utility, ^{
+        @synchronized (self) {
+            // Focus changed again since, its own flush covers this one
+            if (generation != _sessionTimeGeneration) {
+                return;
+            }
+        }
+        [self flushPendingSessionTime];
+    });
+}
+
++ (void)flushPendingSessionTime {
+    int wholeSeconds;
+    @synchronized (self) {
+        [self loadPendingSessionTime];
+        wholeSeconds = (int)_pendingSessionTime;
+        if (wholeSeconds <= 0) {
+            return;
+        }
+        _pendingSessionTime -= wholeSeconds;
+        [OneSignalUserDefaults.initShared saveDoubleForKey:OSUD_PENDING_SESSION_TIME withValue:_pendingSessionTime];
+    }
+    ONE_S_LOG(ONE_S_LL_DEBUG, @"OSBaseFocusTimeProcessor:sendSessionTime of %d", wholeSeconds);
+    [OneSignalUserManagerImpl.sharedInstance sendSessionTime:@(wholeSeconds)];
+}
+
++ (void)clearStatics {
+    @synchronized (self) {
+        _pendingSessionTime = 0;
+        _pendingSessionTimeLoaded = NO;
+        _sessionTimeGeneration++;
+    }
+}
+
+// Must be called while synchronized on the class
++ (void)loadPendingSessionTime {
+    if (_pendingSessionTimeLoaded) {
+        return;
+    }
+    _pendingSessionTime = [OneSignalUserDefaults.initShared getSavedDoubleForKey:OSUD_PENDING_SESSION_TIME defaultValue:0];
+    _pendingSessionTimeLoaded = YES;
 }
 
 @end
@@ -55,6 +55,8 @@
 
     request.parameters = params;
     request.method = POST;
+    request.priority = OSRequestPriorityLow;
+    request.deferrable = true;
     request.path = [NSString stringWithFormat:@"players/%@/on_focus", userId];
 
     return request;
@@ -45,7 +45,7 @@ static NSDictionary<NSString*, OSBaseFocusTimeProcessor*> *_focusTimeProcessors;
         let timeProcesor = [self.focusTimeProcessors objectForKey:key];
         [timeProcesor cancelDelayedJob];
     }
-    [OneSignalLog onesignalLog:ONE_S_LL_DEBUG message:[NSString stringWithFormat:@"cancelFocusCall of %@", self.focusTimeProcessors]];
+    ONE_S_LOG(ONE_S_LL_DEBUG, @"cancelFocusCall of %@", self.focusTimeProcessors);
 }
 
 + (void)resetUnsentActiveTime {
@@ -54,7 +54,7 @@ static NSDictionary<NSString*, OSBaseFocusTimeProcessor*> *_focusTimeProcessors;
         [timeProcesor resetUnsentActiveTime];
     }
     
-    [OneSignalLog onesignalLog:ONE_S_LL_DEBUG message:[NSString stringWithFormat:@"resetUnsentActiveTime of %@", self.focusTimeProcessors]];
+    ONE_S_LOG(ONE_S_LL_DEBUG, @"resetUnsentActiveTime of %@", self.focusTimeProcessors);
 }
 
 + (OSBaseFocusTimeProcessor *)createTimeProcessorWithInfluences:(NSArray<OSInfluence *> *)lastInfluences focusEventType:(FocusEventType)focusEventType {
@@ -37,17 +37,50 @@ THE SOFTWARE.
 + (OSOutcomeEventsCache *)outcomeEventsCache;
 @end
 
+/*
+ Bump this and register a migration for the new version in `migrations` whenever cached data needs converting.
+ */
+#define OS_STORAGE_SCHEMA_VERSION 1
+
+typedef void (^OSMigrationBlock)(void);
+
 @implementation OSMigrationController
 
+/*
+ Each migration newer than the stored storage schema version runs in order, and the version is saved after each one
+ so an interrupted launch resumes where it stopped.
+ The SDK version that last ran is still saved on every upgrade, the module migrations check it.
+ */
 - (void)migrate {
-    [self migrateToVersion_02_14_00_AndGreater];
-    let oneSignalInAppMessages = NSClassFromString(ONE_SIGNAL_IN_APP_MESSAGES_CLASS_NAME);
-    if (oneSignalInAppMessages != nil && [oneSignalInAppMessages respondsToSelector:@selector(migrate)]) {
-        [oneSignalInAppMessages performSelector:@selector(migrate)];
+    let sharedUserDefaults = OneSignalUserDefaults.initShared;
+    NSInteger schemaVersion = [sharedUserDefaults getSavedIntegerForKey:OSUD_STORAGE_SCHEMA_VERSION defaultValue:0];
+    
+    // Migrations rewrite caches that the rest of init reads, so they finish before it continues
+    let migrations = schemaVersion < OS_STORAGE_SCHEMA_VERSION ? [self migrations] : nil;
+    for (NSInteger version = schemaVersion + 1; version <= OS_STORAGE_SCHEMA_VERSION; version++) {
+        OSMigrationBlock migration = migrations[@(version)];
+        if (migration) {
+            ONE_S_LOG(ONE_S_LL_DEBUG, @"Migrating cached data to storage schema version %ld", (long)version);
+            migration();
+        }
+        [sharedUserDefaults saveIntegerForKey:OSUD_STORAGE_SCHEMA_VERSION withValue:version];
     }
     [self saveCurrentSDKVersion];
 }
 
+- (NSDictionary<NSNumber *, OSMigrationBlock> *)migrations {
+    return @{
+        // Installs from before the storage schema existed are migrated by the SDK version they last ran
+        @1: ^{
+            [self migrateToVersion_02_14_00_AndGreater];
+            let oneSignalInAppMessages = [OSModuleRegistry classForModule:OSModuleInAppMessages];
+            if (oneSignalInAppMessages != nil && [oneSignalInAppMessages respondsToSelector:@selector(migrate)]) {
+                [oneSignalInAppMessages performSelector:@selector(migrate)];
+            }
+        }
+    };
+}
+
 /**
  * Support renaming of decodable classes for cached data
  */
@@ -56,7 +89,7 @@ THE SOFTWARE.
     let uniqueCacheOutcomeVersion = 21403;
     long sdkVersion = [OneSignalUserDefaults.initShared getSavedIntegerForKey:OSUD_CACHED_SDK_VERSION defaultValue:0];
     if (sdkVersion < influenceVersion) {
-        [OneSignalLog onesignalLog:ONE_S_LL_DEBUG message:[NSString stringWithFormat:@"Migrating OSIndirectNotification from version: %ld", sdkVersion]];
+        ONE_S_LOG(ONE_S_LL_DEBUG, @"Migrating OSIndirectNotification from version: %ld", sdkVersion);
 
         [NSKeyedUnarchiver setClass:[OSIndirectInfluence class] forClassName:@"OSIndirectNotification"];
         NSArray<OSIndirectInfluence *> * indirectInfluenceData = [[OSInfluenceDataRepository sharedInfluenceDataRepository] lastNotificationsReceivedData];
@@ -67,7 +100,7 @@ THE SOFTWARE.
     }
     
     if (sdkVersion < uniqueCacheOutcomeVersion) {
-        [OneSignalLog onesignalLog:ONE_S_LL_DEBUG message:[NSString stringWithFormat:@"Migrating OSUniqueOutcomeNotification from version: %ld", sdkVersion]];
+        ONE_S_LOG(ONE_S_LL_DEBUG, @"Migrating OSUniqueOutcomeNotification from version: %ld", sdkVersion);
         
         [NSKeyedUnarchiver setClass:[OSCachedUniqueOutcome class] forClassName:@"OSUniqueOutcomeNotification"];
         NSArray<OSCachedUniqueOutcome *> * attributedCacheUniqueOutcomeEvents = [[OSOutcomeEventsCache sharedOutcomeEventsCache] getAttributedUniqueOutcomeEventSent];
@@ -80,7 +113,9 @@ THE SOFTWARE.
 
 - (void)saveCurrentSDKVersion {
     let currentVersion = [[OneSignal sdkVersionRaw] intValue];
-    [OneSignalUserDefaults.initShared saveIntegerForKey:OSUD_CACHED_SDK_VERSION withValue:currentVersion];
+    let sharedUserDefaults = OneSignalUserDefaults.initShared;
+    if ([sharedUserDefaults getSavedIntegerForKey:OSUD_CACHED_SDK_VERSION defaultValue:0] != currentVersion)
+        [sharedUserDefaults saveIntegerForKey:OSUD_CACHED_SDK_VERSION withValue:currentVersion];
 }
 
 @end
@@ -0,0 +1,112 @@
+/**
+ * Modified MIT License
+ *
+ * Copyright 2024 OneSignal
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * 2. All copies of substantial portions of the Software may only be used in connection
+ * with services provided by OneSignal.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#import "OSStartupScheduler.h"
+#import <OneSignalCore/OneSignalCore.h>
+
+// Core Animation commits the frame in a before waiting observer of order 2000000, stages run right after it
+#define OS_STARTUP_STAGE_OBSERVER_ORDER 2000001
+
+@interface OSStartupStage : NSObject
+@property (strong, nonatomic) NSString *name;
+@property (copy, nonatomic) dispatch_block_t block;
+@end
+
+@implementation OSStartupStage
+@end
+
+@interface OSStartupScheduler ()
+// Only accessed on the main thread
+@property (strong, nonatomic) NSMutableArray<OSStartupStage *> *stages;
+@property (nonatomic) CFRunLoopObserverRef observer;
+@end
+
+@implementation OSStartupScheduler
+
++ (OSStartupScheduler *)sharedScheduler {
+    static OSStartupScheduler *sharedScheduler = nil;
+    static dispatch_once_t once;
+    dispatch_once(&once, ^{
+        sharedScheduler = [OSStartupScheduler new];
+    });
+    return sharedScheduler;
+}
+
+- (instancetype)init {
+    if (self = [super init]) {
+        _stages = [NSMutableArray new];
+    }
+    return self;
+}
+
+- (void)deferStage:(NSString *)name block:(dispatch_block_t)block {
+    let stage = [OSStartupStage new];
+    stage.name = name;
+    stage.block = block;
+    
+    if (!NSThread.isMainThread) {
+        dispatch_async(dispatch_get_main_queue(), ^{
+            [self addStage:stage];
+        });
+        return;
+    }
+    [self addStage:stage];
+}
+
+- (void)addStage:(OSStartupStage *)stage {
+    [self.stages addObject:stage];
+    if (self.observer)
+        return;
+    
+    __weak OSStartupScheduler *weakSelf = self;
+    self.observer = CFRunLoopObserverCreateWithHandler(kCFAllocatorDefault, kCFRunLoopBeforeWaiting, true, OS_STARTUP_STAGE_OBSERVER_ORDER, ^(CFRunLoopObserverRef observer, CFRunLoopActivity activity) {
+        [weakSelf runNextStage];
+    });
+    CFRunLoopAddObserver(CFRunLoopGetMain(), self.observer, kCFRunLoopCommonModes);
+}
+
+- (void)runNextStage {
+    OSStartupStage *stage = self.stages.firstObject;
+    if (!stage) {
+        CFRunLoopObserverInvalidate(self.observer);
+        CFRelease(self.observer);
+        self.observer = nil;
+        return;
+    }
+    [self.stages removeObjectAtIndex:0];
+    
+    let start = CFAbsoluteTimeGetCurrent();
+    [OSTrace measureInterval:OSTraceIntervalInitStage name:stage.name block:stage.block];
+    [OneSignalLog onesignalLog:ONE_S_LL_VERBOSE messageBlock:^NSString *{
+        return [NSString stringWithFormat:@"OSStartupScheduler ran %@ in %.1f ms", stage.name, (CFAbsoluteTimeGetCurrent() - start) * 1000];
+    }];
+    
+    // Keeps the run loop turning so the next stage runs on the following pass, even with no other events
+    CFRunLoopWakeUp(CFRunLoopGetMain());
+}
+
+@end
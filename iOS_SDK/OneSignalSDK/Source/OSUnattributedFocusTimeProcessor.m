@@ -51,10 +51,10 @@ static let UNATTRIBUTED_MIN_SESSION_TIME_SEC = 60;
     let unsentActive = [super getUnsentActiveTime];
     let totalTimeActive = unsentActive + params.timeElapsed;
     
-    [OneSignalLog onesignalLog:ONE_S_LL_DEBUG message:[NSString stringWithFormat:@"sendOnFocusCall unattributed with totalTimeActive %f", totalTimeActive]];
+    ONE_S_LOG(ONE_S_LL_DEBUG, @"sendOnFocusCall unattributed with totalTimeActive %f", totalTimeActive);
     
     if (![super hasMinSyncTime:totalTimeActive]) {
-        [OneSignalLog onesignalLog:ONE_S_LL_DEBUG message:[NSString stringWithFormat:@"unattributed influence saveUnsentActiveTime %f", totalTimeActive]];
+        ONE_S_LOG(ONE_S_LL_DEBUG, @"unattributed influence saveUnsentActiveTime %f", totalTimeActive);
         [super saveUnsentActiveTime:totalTimeActive];
         return;
     }
@@ -64,14 +64,14 @@ static let UNATTRIBUTED_MIN_SESSION_TIME_SEC = 60;
 
 - (void)sendUnsentActiveTime:(OSFocusCallParams *)params {
     let unsentActive = [super getUnsentActiveTime];
-    [OneSignalLog onesignalLog:ONE_S_LL_DEBUG message:[NSString stringWithFormat:@"sendUnsentActiveTime unattributed with unsentActive %f", unsentActive]];
+    ONE_S_LOG(ONE_S_LL_DEBUG, @"sendUnsentActiveTime unattributed with unsentActive %f", unsentActive);
     
     [self sendOnFocusCallWithParams:params totalTimeActive:unsentActive];
 }
 
 - (void)sendOnFocusCallWithParams:(OSFocusCallParams *)params totalTimeActive:(NSTimeInterval)totalTimeActive {
-    [OneSignalLog onesignalLog:ONE_S_LL_DEBUG message:[NSString stringWithFormat:@"OSUnattributedFocusTimeProcessor:sendSessionTime of %@", @(totalTimeActive)]];
-    [OneSignalUserManagerImpl.sharedInstance sendSessionTime:@(totalTimeActive)];
+    ONE_S_LOG(ONE_S_LL_DEBUG, @"OSUnattributedFocusTimeProcessor:bufferSessionTime of %f", totalTimeActive);
+    [OSBaseFocusTimeProcessor bufferSessionTime:totalTimeActive];
     [super saveUnsentActiveTime:0];
 }
 
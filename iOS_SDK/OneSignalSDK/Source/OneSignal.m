@@ -38,8 +38,11 @@
 #import "UIApplicationDelegate+OneSignal.h"
 #import "OSNotification+Internal.h"
 #import "OSMigrationController.h"
+#import "OSStartupScheduler.h"
+#import "OSBackgroundMaintenance.h"
 #import "OSBackgroundTaskHandlerImpl.h"
 #import "OSFocusCallParams.h"
+#import "OSBaseFocusTimeProcessor.h"
 
 #import <OneSignalNotifications/OneSignalNotifications.h>
 #import <OneSignalLocation/OneSignalLocationManager.h>
@@ -80,6 +83,27 @@
 @interface OneSignal (SessionStatusDelegate)
 @end
 
+// Implemented in the UIApplication (OneSignal) category at the bottom of this file
+@interface UIApplication (OneSignalSetup)
++ (void)oneSignalSetup;
++ (BOOL)oneSignalDefersSwizzling;
+@end
+
+@implementation OSInitializationOptions
+
+- (instancetype)init {
+    if (self = [super init]) {
+        _inAppMessagesEnabled = YES;
+        _locationEnabled = YES;
+        _liveActivitiesEnabled = YES;
+        _outcomesEnabled = YES;
+        _firebaseAnalyticsEnabled = YES;
+    }
+    return self;
+}
+
+@end
+
 @implementation OneSignal
 
 // Has attempted to register for push notifications with Apple since app was installed.
@@ -101,6 +125,11 @@ static NSDictionary* appSettings;
 // Called after successfully calling setAppId and setLaunchOptions
 static BOOL initDone = false;
 
+// Set from OSInitializationOptions, the disabled module classes are tracked by OSModuleRegistry
+static BOOL didSetInitializationOptions = false;
+static BOOL outcomesDisabled = false;
+static BOOL firebaseAnalyticsDisabled = false;
+
 // Used to track last time SDK was initialized, for whether or not to start a new session
 static NSTimeInterval initializationTime;
 
@@ -161,10 +190,15 @@ static OneSignalReceiveReceiptsController* _receiveReceiptsController;
         
     _downloadedParameters = false;
     _didCallDownloadParameters = false;
+    didSetInitializationOptions = false;
+    outcomesDisabled = false;
+    firebaseAnalyticsDisabled = false;
+    [OSModuleRegistry clearStatics];
     
 //    sessionLaunchTime = [NSDate date];
 
     [OSOutcomes clearStatics];
+    [OSBaseFocusTimeProcessor clearStatics];
     
     [OSSessionManager resetSharedSessionManager];
 }
@@ -207,33 +241,50 @@ static OneSignalReceiveReceiptsController* _receiveReceiptsController;
     return [OSOutcomes Session];
 }
 
+// Apps call these from UI code, the module's namespace is resolved once and then read from a static
+
 + (Class<OSInAppMessages>)InAppMessages {
-    let oneSignalInAppMessages = NSClassFromString(ONE_SIGNAL_IN_APP_MESSAGES_CLASS_NAME);
-    if (oneSignalInAppMessages != nil && [oneSignalInAppMessages respondsToSelector:@selector(InAppMessages)]) {
-        return [oneSignalInAppMessages performSelector:@selector(InAppMessages)];
-    } else {
-        [OneSignalLog onesignalLog:ONE_S_LL_ERROR message:@"OneSignalInAppMessages not found. In order to use OneSignal's In App Messaging features the OneSignalInAppMessages module must be added."];
-        return [OSStubInAppMessages InAppMessages];
+    static Class<OSInAppMessages> inAppMessages;
+    static dispatch_once_t once;
+    dispatch_once(&once, ^{
+        let oneSignalInAppMessages = [OSModuleRegistry classForModule:OSModuleInAppMessages];
+        if (oneSignalInAppMessages != nil && [oneSignalInAppMessages respondsToSelector:@selector(InAppMessages)]) {
+            inAppMessages = [oneSignalInAppMessages performSelector:@selector(InAppMessages)];
+        }
+    });
+    if (inAppMessages || [OSModuleRegistry isModuleDisabled:OSModuleInAppMessages]) {
+        return inAppMessages ?: [OSStubInAppMessages InAppMessages];
     }
+    [OneSignalLog onesignalLog:ONE_S_LL_ERROR message:@"OneSignalInAppMessages not found. In order to use OneSignal's In App Messaging features the OneSignalInAppMessages module must be added."];
+    return [OSStubInAppMessages InAppMessages];
 }
 
 + (Class<OSLiveActivities>)LiveActivities {
-    let oneSignalLiveActivities = NSClassFromString(ONE_SIGNAL_LIVE_ACTIVITIES_CLASS_NAME);
-    if (oneSignalLiveActivities != nil && [oneSignalLiveActivities respondsToSelector:@selector(liveActivities)]) {
-        return [oneSignalLiveActivities performSelector:@selector(liveActivities)];
-    } else {
-        [OneSignalLog onesignalLog:ONE_S_LL_ERROR message:@"oneSignalLiveActivities not found. In order to use OneSignal's LiveActivities features the OneSignalLiveActivities module must be added."];
-        return [OSStubLiveActivities liveActivities];
+    static Class<OSLiveActivities> liveActivities;
+    static dispatch_once_t once;
+    dispatch_once(&once, ^{
+        let oneSignalLiveActivities = [OSModuleRegistry classForModule:OSModuleLiveActivities];
+        if (oneSignalLiveActivities != nil && [oneSignalLiveActivities respondsToSelector:@selector(liveActivities)]) {
+            liveActivities = [oneSignalLiveActivities performSelector:@selector(liveActivities)];
+        }
+    });
+    if (liveActivities || [OSModuleRegistry isModuleDisabled:OSModuleLiveActivities]) {
+        return liveActivities ?: [OSStubLiveActivities liveActivities];
     }
+    [OneSignalLog onesignalLog:ONE_S_LL_ERROR message:@"oneSignalLiveActivities not found. In order to use OneSignal's LiveActivities features the OneSignalLiveActivities module must be added."];
+    return [OSStubLiveActivities liveActivities];
 }
 
 + (Class<OSLocation>)Location {
-    let oneSignalLocationManager = NSClassFromString(ONE_SIGNAL_LOCATION_CLASS_NAME);
-    if (oneSignalLocationManager != nil && [oneSignalLocationManager respondsToSelector:@selector(Location)]) {
-        return [oneSignalLocationManager performSelector:@selector(Location)];
-    } else {
-        return [OSStubLocation Location];
-    }
+    static Class<OSLocation> location;
+    static dispatch_once_t once;
+    dispatch_once(&once, ^{
+        let oneSignalLocationManager = [OSModuleRegistry classForModule:OSModuleLocation];
+        if (oneSignalLocationManager != nil && [oneSignalLocationManager respondsToSelector:@selector(Location)]) {
+            location = [oneSignalLocationManager performSelector:@selector(Location)];
+        }
+    });
+    return location ?: [OSStubLocation Location];
 }
 
 + (Class<OSDebug>)Debug {
@@ -252,6 +303,27 @@ static OneSignalReceiveReceiptsController* _receiveReceiptsController;
     [self init];
 }
 
++ (void)initialize:(nonnull NSString*)newAppId withLaunchOptions:(nullable NSDictionary*)launchOptions options:(nullable OSInitializationOptions*)options {
+    [self setInitializationOptions:options];
+    [self initialize:newAppId withLaunchOptions:launchOptions];
+}
+
++ (void)setInitializationOptions:(OSInitializationOptions *)options {
+    if (!options || didSetInitializationOptions || initDone) {
+        return;
+    }
+    didSetInitializationOptions = true;
+    if (!options.inAppMessagesEnabled)
+        [OSModuleRegistry disableModule:OSModuleInAppMessages];
+    if (!options.locationEnabled)
+        [OSModuleRegistry disableModule:OSModuleLocation];
+    if (!options.liveActivitiesEnabled)
+        [OSModuleRegistry disableModule:OSModuleLiveActivities];
+    outcomesDisabled = !options.outcomesEnabled;
+    firebaseAnalyticsDisabled = !options.firebaseAnalyticsEnabled;
+    ONE_S_LOG(ONE_S_LL_VERBOSE, @"Initializing with modules disabled: in app messages %d, location %d, live activities %d, outcomes %d, firebase analytics %d", !options.inAppMessagesEnabled, !options.locationEnabled, !options.liveActivitiesEnabled, outcomesDisabled, firebaseAnalyticsDisabled);
+}
+
 + (NSString * _Nullable)getCachedAppId {
     let prevAppId = [OneSignalUserDefaults.initStandard getSavedStringForKey:OSUD_APP_ID defaultValue:nil];
     if (!prevAppId) {
@@ -270,7 +342,8 @@ static OneSignalReceiveReceiptsController* _receiveReceiptsController;
 // TODO: For release, note this change in migration guide:
 // No longer reading appID from plist @"OneSignal_APPID" and @"GameThrive_APPID"
 + (void)setAppId:(nullable NSString*)newAppId {
-    [OneSignalLog onesignalLog:ONE_S_LL_VERBOSE message:[NSString stringWithFormat:@"setAppId called with appId: %@!", newAppId]];
+    ONE_S_LOG(ONE_S_LL_VERBOSE, @"setAppId called with appId: %@!", newAppId);
+    [OSTrace event:@"OneSignal setAppId"];
 
     if (!newAppId || newAppId.length == 0) {
         NSString* cachedAppId = [self getCachedAppId];
@@ -309,7 +382,7 @@ static OneSignalReceiveReceiptsController* _receiveReceiptsController;
  Note: While this is called via `initialize`, it is also called directly from wrapper SDKs.
  */
 + (void)setLaunchOptions:(nullable NSDictionary*)newLaunchOptions {
-    [OneSignalLog onesignalLog:ONE_S_LL_VERBOSE message:[NSString stringWithFormat:@"setLaunchOptions() called with launchOptions: %@!", launchOptions.description]];
+    ONE_S_LOG(ONE_S_LL_VERBOSE, @"setLaunchOptions() called with launchOptions: %@!", launchOptions.description);
 
     // Don't continue if the newLaunchOptions are nil
     if (!newLaunchOptions) {
@@ -342,7 +415,7 @@ static OneSignalReceiveReceiptsController* _receiveReceiptsController;
     
     // The SDK hasn't finished initializing yet, init() will start the new session
     if (!initDone) {
-        [OneSignalLog onesignalLog:ONE_S_LL_DEBUG message:[NSString stringWithFormat:@"shouldStartNewSession:initDone: %d", initDone]];
+        ONE_S_LOG(ONE_S_LL_DEBUG, @"shouldStartNewSession:initDone: %d", initDone);
         return false;
     }
     
@@ -354,8 +427,8 @@ static OneSignalReceiveReceiptsController* _receiveReceiptsController;
     NSTimeInterval timeSinceLastClosed = now - lastTimeClosed;
     NSTimeInterval timeSinceInitialization = now - initializationTime;
 
-    [OneSignalLog onesignalLog:ONE_S_LL_DEBUG message:[NSString stringWithFormat:@"shouldStartNewSession:timeSinceLastClosed: %f", timeSinceLastClosed]];
-    [OneSignalLog onesignalLog:ONE_S_LL_DEBUG message:[NSString stringWithFormat:@"shouldStartNewSession:timeSinceInitialization: %f", timeSinceInitialization]];
+    ONE_S_LOG(ONE_S_LL_DEBUG, @"shouldStartNewSession:timeSinceLastClosed: %f", timeSinceLastClosed);
+    ONE_S_LOG(ONE_S_LL_DEBUG, @"shouldStartNewSession:timeSinceInitialization: %f", timeSinceInitialization);
 
     return MIN(timeSinceLastClosed, timeSinceInitialization) >= minTimeThreshold;
 }
@@ -383,13 +456,15 @@ static OneSignalReceiveReceiptsController* _receiveReceiptsController;
         return;
 
     [OSOutcomes.sharedController clearOutcomes];
+    // outcome events that failed to send in a previous session get another attempt
+    [OSOutcomes.sharedController retryFailedOutcomeEvents];
 
     [[OSSessionManager sharedSessionManager] restartSessionIfNeeded];
     
     [OneSignalTrackFirebaseAnalytics trackInfluenceOpenEvent];
     
     // Clear last location after attaching data to user state or not
-    let oneSignalLocation = NSClassFromString(ONE_SIGNAL_LOCATION_CLASS_NAME);
+    let oneSignalLocation = [OSModuleRegistry classForModule:OSModuleLocation];
     if (oneSignalLocation != nil && [oneSignalLocation respondsToSelector:@selector(clearLastLocation)]) {
         [oneSignalLocation performSelector:@selector(clearLastLocation)];
     }
@@ -403,7 +478,7 @@ static OneSignalReceiveReceiptsController* _receiveReceiptsController;
     // The OSMessagingController is an OSPushSubscriptionObserver so that we pull IAMs once we have the sub id
     NSString *subscriptionId = OneSignalUserManagerImpl.sharedInstance.pushSubscriptionId;
     if (subscriptionId) {
-        let oneSignalInAppMessages = NSClassFromString(ONE_SIGNAL_IN_APP_MESSAGES_CLASS_NAME);
+        let oneSignalInAppMessages = [OSModuleRegistry classForModule:OSModuleInAppMessages];
         if (oneSignalInAppMessages != nil && [oneSignalInAppMessages respondsToSelector:@selector(getInAppMessagesFromServer:)]) {
             [oneSignalInAppMessages performSelector:@selector(getInAppMessagesFromServer:) withObject:subscriptionId];
         }
@@ -420,7 +495,7 @@ static OneSignalReceiveReceiptsController* _receiveReceiptsController;
 }
 
 + (void)startInAppMessages {
-    let oneSignalInAppMessages = NSClassFromString(ONE_SIGNAL_IN_APP_MESSAGES_CLASS_NAME);
+    let oneSignalInAppMessages = [OSModuleRegistry classForModule:OSModuleInAppMessages];
     if (oneSignalInAppMessages != nil && [oneSignalInAppMessages respondsToSelector:@selector(start)]) {
         [oneSignalInAppMessages performSelector:@selector(start)];
     }
@@ -428,11 +503,14 @@ static OneSignalReceiveReceiptsController* _receiveReceiptsController;
 
 + (void)startOutcomes {
     [OSOutcomes start];
-    [OSOutcomes.sharedController cleanUniqueOutcomeNotifications]; // TODO: should this actually be in new session instead of init
+    [OSMaintenanceScheduler.sharedScheduler registerJob:@"clean_unique_outcomes" block:^(dispatch_block_t completion) {
+        [OSOutcomes.sharedController cleanUniqueOutcomeNotifications];
+        completion();
+    }];
 }
 
 + (void)startLocation {
-    let oneSignalLocation = NSClassFromString(ONE_SIGNAL_LOCATION_CLASS_NAME);
+    let oneSignalLocation = [OSModuleRegistry classForModule:OSModuleLocation];
     if (oneSignalLocation != nil && [oneSignalLocation respondsToSelector:@selector(start)]) {
         [oneSignalLocation performSelector:@selector(start)];
     }
@@ -459,7 +537,7 @@ static OneSignalReceiveReceiptsController* _receiveReceiptsController;
 }
 
 + (void)startLiveActivitiesManager {
-    let oneSignalLiveActivities = NSClassFromString(ONE_SIGNAL_LIVE_ACTIVITIES_CLASS_NAME);
+    let oneSignalLiveActivities = [OSModuleRegistry classForModule:OSModuleLiveActivities];
     if (oneSignalLiveActivities != nil && [oneSignalLiveActivities respondsToSelector:@selector(start)]) {
         [oneSignalLiveActivities performSelector:@selector(start)];
     } else {
@@ -479,18 +557,34 @@ static OneSignalReceiveReceiptsController* _receiveReceiptsController;
  Called after setAppId and setLaunchOptions, depending on which one is called last (order does not matter)
  */
 + (void)init {
-    [OneSignalLog onesignalLog:ONE_S_LL_VERBOSE message:[NSString stringWithFormat:@"launchOptions is set and appId of %@ is set, initializing OneSignal...", [OneSignalConfigManager getAppId]]];
+    ONE_S_LOG(ONE_S_LL_VERBOSE, @"launchOptions is set and appId of %@ is set, initializing OneSignal...", [OneSignalConfigManager getAppId]);
+    
+    // Already done from +load unless the app defers swizzling
+    [UIApplication oneSignalSetup];
     
     // TODO: We moved this check to the top of this method, we should test this.
     if (initDone) {
         return;
     }
     
-    [[OSMigrationController new] migrate];
+    [OSTrace event:@"OneSignal init"];
+    // The push subscription reads these while the user manager starts
+    [OSDeviceUtils warmEnvironmentInBackground];
+    [OSMemoryPressureCoordinator start];
+    [OSTrace measureInterval:OSTraceIntervalInitStage name:@"migration" block:^{
+        [[OSMigrationController new] migrate];
+    }];
     
     OSBackgroundTaskManager.taskHandler = [OSBackgroundTaskHandlerImpl new];
+    [OSBackgroundMaintenance registerTask];
+    [OSMaintenanceScheduler.sharedScheduler registerJob:@"remove_expired_media" block:^(dispatch_block_t completion) {
+        [OneSignalAttachmentHandler removeExpiredCachedMedia];
+        completion();
+    }];
 
-    [self registerForAPNsToken];
+    [OSTrace measureInterval:OSTraceIntervalInitStage name:@"register_apns" block:^{
+        [self registerForAPNsToken];
+    }];
     
     // Wrapper SDK's call init twice and pass null as the appId on the first call
     //  the app ID is required to download parameters, so do not download params until the appID is provided
@@ -522,21 +616,57 @@ static OneSignalReceiveReceiptsController* _receiveReceiptsController;
      */
     
     [OSNotificationsManager clearBadgeCount:false fromClearAll:false];
-    [self startOutcomes];
-    [self startLocation];
-    [self startTrackIAP];
-    [self startTrackFirebaseAnalytics];
+    // Outcomes are started right away so OneSignal.Session calls made after init are not dropped
+    if (!outcomesDisabled) {
+        [OSTrace measureInterval:OSTraceIntervalInitStage name:@"outcomes" block:^{
+            [self startOutcomes];
+        }];
+    }
     [self startLifecycleObserver];
-    //TODO: Should these be started in Dependency order? e.g. IAM depends on User Manager shared instance
-    [self startUserManager]; // By here, app_id exists, and consent is granted.
-    [self startLiveActivitiesManager];
-    [self startInAppMessages];
-    [self startNewSession:YES];
+    [OSTrace measureInterval:OSTraceIntervalInitStage name:@"user_manager" block:^{
+        [self startUserManager]; // By here, app_id exists, and consent is granted.
+    }];
+    
+    [self deferStartupStagesOnScheduler:OSStartupScheduler.sharedScheduler];
     
     initializationTime = [[NSDate date] timeIntervalSince1970];
     initDone = true;
 }
 
+/*
+ Everything else waits for the first frame, in dependency order: IAM depends on the
+ User Manager shared instance and the new session fetches IAMs and uses outcomes.
+ Modules disabled by OSInitializationOptions get no stage at all.
+ */
++ (void)deferStartupStagesOnScheduler:(OSStartupScheduler *)scheduler {
+    if (![OSModuleRegistry isModuleDisabled:OSModuleLocation]) {
+        [scheduler deferStage:@"location" block:^{
+            [self startLocation];
+        }];
+    }
+    [scheduler deferStage:@"track_iap" block:^{
+        [self startTrackIAP];
+    }];
+    if (!firebaseAnalyticsDisabled) {
+        [scheduler deferStage:@"track_firebase_analytics" block:^{
+            [self startTrackFirebaseAnalytics];
+        }];
+    }
+    if (![OSModuleRegistry isModuleDisabled:OSModuleLiveActivities]) {
+        [scheduler deferStage:@"live_activities" block:^{
+            [self startLiveActivitiesManager];
+        }];
+    }
+    if (![OSModuleRegistry isModuleDisabled:OSModuleInAppMessages]) {
+        [scheduler deferStage:@"in_app_messages" block:^{
+            [self startInAppMessages];
+        }];
+    }
+    [scheduler deferStage:@"new_session" block:^{
+        [self startNewSession:YES];
+    }];
+}
+
 + (NSString *)appGroupKey {
     return [OneSignalUserDefaults appGroupName];
 }
@@ -561,6 +691,7 @@ static OneSignalReceiveReceiptsController* _receiveReceiptsController;
         let sharedUserDefaults = OneSignalUserDefaults.initShared;
         
         [standardUserDefaults saveStringForKey:OSUD_APP_ID withValue:appId];
+        [[OSRemoteParamController sharedController] clearCachedRemoteParams];
         
         // Remove player_id from both standard and shared NSUserDefaults
         [standardUserDefaults removeValueForKey:OSUD_PUSH_SUBSCRIPTION_ID];
@@ -617,47 +748,77 @@ static OneSignalReceiveReceiptsController* _receiveReceiptsController;
     // NSString *userId = OneSignalUserManagerImpl.sharedInstance.pushSubscriptionId;
     NSString *userId = nil;
 
-    [OneSignalCoreImpl.sharedClient executeRequest:[OSRequestGetIosParams withUserId:userId appId:appId] onSuccess:^(NSDictionary *result) {
+    // Apply the params from the last launch right away, the request below only re-applies them if they changed
+    let remoteParamController = [OSRemoteParamController sharedController];
+    NSDictionary *cachedParams = [remoteParamController cachedRemoteParamsForAppId:appId];
+    if (cachedParams) {
+        [OneSignalLog onesignalLog:ONE_S_LL_VERBOSE message:@"Applying cached iOS parameters while they are revalidated"];
+        [self applyIOSParams:cachedParams];
+    }
 
-        if (result[IOS_REQUIRES_USER_ID_AUTHENTICATION]) {
-            OneSignalUserManagerImpl.sharedInstance.requiresUserAuth = [result[IOS_REQUIRES_USER_ID_AUTHENTICATION] boolValue];
+    let request = [OSRequestGetIosParams withUserId:userId appId:appId etag:[remoteParamController cachedRemoteParamsETagForAppId:appId]];
+    [OneSignalCoreImpl.sharedClient executeRequest:request onSuccess:^(NSDictionary *result) {
+        BOOL changed = [remoteParamController cacheRemoteParams:result etag:[self etagFromHeaders:request.responseHeaders] forAppId:appId];
+        if (changed || !cachedParams) {
+            [self applyIOSParams:result];
+        }
+        _downloadedParameters = true;
+    } onFailure:^(OneSignalClientError *error) {
+        if (error.code == 304 && cachedParams) {
+            [OneSignalLog onesignalLog:ONE_S_LL_VERBOSE message:@"iOS parameters not modified, keeping cached parameters"];
+            _downloadedParameters = true;
+            return;
         }
+        _didCallDownloadParameters = false;
+    }];
+}
 
-        if (result[IOS_USES_PROVISIONAL_AUTHORIZATION] != (id)[NSNull null]) {
-            [OneSignalUserDefaults.initStandard saveBoolForKey:OSUD_USES_PROVISIONAL_PUSH_AUTHORIZATION withValue:[result[IOS_USES_PROVISIONAL_AUTHORIZATION] boolValue]];
++ (void)applyIOSParams:(NSDictionary *)result {
+    if (result[IOS_REQUIRES_USER_ID_AUTHENTICATION]) {
+        OneSignalUserManagerImpl.sharedInstance.requiresUserAuth = [result[IOS_REQUIRES_USER_ID_AUTHENTICATION] boolValue];
+    }
 
-            [OSNotificationsManager checkProvisionalAuthorizationStatus];
-        }
+    if (result[IOS_USES_PROVISIONAL_AUTHORIZATION] != (id)[NSNull null]) {
+        [OneSignalUserDefaults.initStandard saveBoolForKey:OSUD_USES_PROVISIONAL_PUSH_AUTHORIZATION withValue:[result[IOS_USES_PROVISIONAL_AUTHORIZATION] boolValue]];
 
-        if (result[IOS_RECEIVE_RECEIPTS_ENABLE] != (id)[NSNull null])
-            [OneSignalUserDefaults.initShared saveBoolForKey:OSUD_RECEIVE_RECEIPTS_ENABLED withValue:[result[IOS_RECEIVE_RECEIPTS_ENABLE] boolValue]];
+        [OSNotificationsManager checkProvisionalAuthorizationStatus];
+    }
 
-        [[OSRemoteParamController sharedController] saveRemoteParams:result];
-        if ([[OSRemoteParamController sharedController] hasLocationKey]) {
-            BOOL shared = [result[IOS_LOCATION_SHARED] boolValue];
-            let oneSignalLocation = NSClassFromString(ONE_SIGNAL_LOCATION_CLASS_NAME);
-            if (oneSignalLocation != nil && [oneSignalLocation respondsToSelector:@selector(startLocationSharedWithFlag:)]) {
-                [OneSignalCoreHelper callSelector:@selector(startLocationSharedWithFlag:) onObject:oneSignalLocation withArg:shared];
-            }
-        }
-        
-        if ([[OSRemoteParamController sharedController] hasPrivacyConsentKey]) {
-            BOOL required = [result[IOS_REQUIRES_USER_PRIVACY_CONSENT] boolValue];
-            [[OSRemoteParamController sharedController] savePrivacyConsentRequired:required];
-            [OSPrivacyConsentController setRequiresPrivacyConsent:required];
+    if (result[IOS_RECEIVE_RECEIPTS_ENABLE] != (id)[NSNull null])
+        [OneSignalUserDefaults.initShared saveBoolForKey:OSUD_RECEIVE_RECEIPTS_ENABLED withValue:[result[IOS_RECEIVE_RECEIPTS_ENABLE] boolValue]];
+
+    [[OSRemoteParamController sharedController] saveRemoteParams:result];
+    [[OSTuningConfig sharedConfig] applyRemoteTuning:result[IOS_SDK_TUNING]];
+    if ([[OSRemoteParamController sharedController] hasLocationKey]) {
+        BOOL shared = [result[IOS_LOCATION_SHARED] boolValue];
+        let oneSignalLocation = [OSModuleRegistry classForModule:OSModuleLocation];
+        if (oneSignalLocation != nil && [oneSignalLocation respondsToSelector:@selector(startLocationSharedWithFlag:)]) {
+            [OneSignalCoreHelper callSelector:@selector(startLocationSharedWithFlag:) onObject:oneSignalLocation withArg:shared];
         }
+    }
+    
+    if ([[OSRemoteParamController sharedController] hasPrivacyConsentKey]) {
+        BOOL required = [result[IOS_REQUIRES_USER_PRIVACY_CONSENT] boolValue];
+        [[OSRemoteParamController sharedController] savePrivacyConsentRequired:required];
+        [OSPrivacyConsentController setRequiresPrivacyConsent:required];
+    }
 
-        if (result[OUTCOMES_PARAM] && result[OUTCOMES_PARAM][IOS_OUTCOMES_V2_SERVICE_ENABLE])
-            [[OSOutcomeEventsCache sharedOutcomeEventsCache] saveOutcomesV2ServiceEnabled:[result[OUTCOMES_PARAM][IOS_OUTCOMES_V2_SERVICE_ENABLE] boolValue]];
+    if (result[OUTCOMES_PARAM] && result[OUTCOMES_PARAM][IOS_OUTCOMES_V2_SERVICE_ENABLE])
+        [[OSOutcomeEventsCache sharedOutcomeEventsCache] saveOutcomesV2ServiceEnabled:[result[OUTCOMES_PARAM][IOS_OUTCOMES_V2_SERVICE_ENABLE] boolValue]];
 
-        [[OSTrackerFactory sharedTrackerFactory] saveInfluenceParams:result];
+    [[OSTrackerFactory sharedTrackerFactory] saveInfluenceParams:result];
+    if (!firebaseAnalyticsDisabled)
         [OneSignalTrackFirebaseAnalytics updateFromDownloadParams:result];
+}
 
-        _downloadedParameters = true;
-
-    } onFailure:^(OneSignalClientError *error) {
-        _didCallDownloadParameters = false;
-    }];
++ (NSString *)etagFromHeaders:(NSDictionary *)headers {
+    // Header field names are case-insensitive
+    for (NSString *name in headers) {
+        if ([name caseInsensitiveCompare:@"ETag"] == NSOrderedSame) {
+            return headers[name];
+        }
+    }
+    return nil;
 }
 
 //TODO: consolidate in one place. Where???
@@ -706,7 +867,7 @@ static OneSignalReceiveReceiptsController* _receiveReceiptsController;
  Start of outcome module
  */
 
-+ (void)sendSessionEndOutcomes:(NSNumber*)totalTimeActive params:(OSFocusCallParams *)params onSuccess:(OSResultSuccessBlock _Nonnull)successBlock onFailure:(OSFailureBlock _Nonnull)failureBlock {
++ (void)sendSessionEndOutcomes:(NSNumber*)totalTimeActive params:(OSFocusCallParams *)params deferralDelay:(NSTimeInterval)deferralDelay onSuccess:(OSResultSuccessBlock _Nonnull)successBlock onFailure:(OSFailureBlock _Nonnull)failureBlock {
     if (![OSOutcomes sharedController]) {
         [OneSignalLog onesignalLog:ONE_S_LL_ERROR message:@"Make sure OneSignal init is called first"];
         if (failureBlock) {
@@ -731,10 +892,15 @@ static OneSignalReceiveReceiptsController* _receiveReceiptsController;
                                      pushSubscriptionId:pushSubscriptionId
                                             onesignalId:onesignalId
                                         influenceParams:params.influenceParams
+                                          deferralDelay:deferralDelay
                                               onSuccess:successBlock
                                               onFailure:failureBlock];
 }
 
++ (void)cancelDeferredSessionEndOutcomes {
+    [OSOutcomes.sharedController cancelDeferredSessionEndOutcomes];
+}
+
 @end
 
 @implementation OneSignal (SessionStatusDelegate)
@@ -763,17 +929,44 @@ static OneSignalReceiveReceiptsController* _receiveReceiptsController;
 //
 //  Note1: Do NOT move this category to it's own file. This is required so when the app developer calls OneSignal.initWithLaunchOptions this load+
 //            will fire along with it. This is due to how iOS loads .m files into memory instead of classes.
+//            Apps can set OneSignal_defer_swizzling in their Info.plist to install it from the first OneSignal init instead, keeping it out of
+//            pre-main time. The delegates set before then are re-assigned so they still get swizzled, as long as init is called from didFinishLaunching.
+//            Apps can set OneSignal_disable_swizzling in their Info.plist and forward the delegate calls through OneSignal.Notifications instead.
 //  Note2: Do NOT directly add swizzled selectors to this category as if this class is loaded into the runtime twice unexpected results will occur.
 //            The oneSignalLoadedTagSelector: selector is used a flag to prevent double swizzling if this library is loaded twice.
 #pragma clang diagnostic push
 #pragma clang diagnostic ignored "-Wincomplete-implementation"
 @implementation UIApplication (OneSignal)
 + (void)load {
+    if ([self oneSignalDefersSwizzling])
+        return;
+    [self oneSignalSetup];
+}
+
++ (BOOL)oneSignalDefersSwizzling {
+    return [[[NSBundle mainBundle] objectForInfoDictionaryKey:ONESIGNAL_DEFER_SWIZZLING_KEY] boolValue];
+}
+
++ (void)oneSignalSetup {
+    static dispatch_once_t once;
+    dispatch_once(&once, ^{
+        [self oneSignalSetupOnce];
+    });
+}
+
++ (void)oneSignalSetupOnce {
+    [OSDialogInstanceManager setSharedOSDialogInstance:[OneSignalDialogController sharedInstance]];
     
     if ([self shouldDisableBasedOnProcessArguments]) {
         [OneSignalLog onesignalLog:ONE_S_LL_WARN message:@"OneSignal method swizzling is disabled. Make sure the feature is enabled for production."];
         return;
     }
+    
+    if ([[[NSBundle mainBundle] objectForInfoDictionaryKey:ONESIGNAL_DISABLE_SWIZZLING_KEY] boolValue]) {
+        [OneSignalLog onesignalLog:ONE_S_LL_VERBOSE message:@"OneSignal swizzling disabled by Info.plist, the app forwards its delegate calls"];
+        [OSNotificationsManager startWithoutSwizzling];
+        return;
+    }
     [OneSignalLog onesignalLog:ONE_S_LL_VERBOSE message:@"UIApplication(OneSignal) LOADED!"];
     
     // Prevent Xcode storyboard rendering process from crashing with custom IBDesignable Views or from hostless unit tests or share-extension.
@@ -802,10 +995,14 @@ static OneSignalReceiveReceiptsController* _receiveReceiptsController;
     [OSNotificationsManager start];
 
     [[OSMigrationController new] migrate];
+    
+    // With deferred swizzling the app delegate is normally set before init, re-assigning it runs the swizzled setDelegate: on it.
+    // Nothing is set yet when this runs from +load.
+    let application = [UIApplication sharedApplication];
+    if (application.delegate)
+        application.delegate = application.delegate;
 //    sessionLaunchTime = [NSDate date];
     // TODO: sessionLaunchTime used to always be set in load
-    
-    [OSDialogInstanceManager setSharedOSDialogInstance:[OneSignalDialogController sharedInstance]];
 }
 
 /*
@@ -813,7 +1010,8 @@ static OneSignalReceiveReceiptsController* _receiveReceiptsController;
     We swizzle the 'setApplicationIconBadgeNumber()' to intercept these calls so we always know the latest count
 */
 - (void)onesignalSetApplicationIconBadgeNumber:(NSInteger)badge {
-    [OneSignalExtensionBadgeHandler updateCachedBadgeValue:badge];
+    // Usually called on the main thread, the cached value is written in the background
+    [OneSignalExtensionBadgeHandler setNeedsCachedBadgeValue:badge];
     [self onesignalSetApplicationIconBadgeNumber:badge];
 }
 
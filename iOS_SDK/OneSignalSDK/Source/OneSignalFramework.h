@@ -59,6 +59,19 @@ typedef void (^OSWebOpenURLResultBlock)(BOOL shouldOpen);
 typedef void (^OSResultSuccessBlock)(NSDictionary* result);
 typedef void (^OSFailureBlock)(NSError* error);
 
+/**
+ Declares which optional modules the app uses, passed to `initialize:withLaunchOptions:options:`.
+ Every module is enabled by default. A disabled module does no startup work, its classes are not even looked up,
+ and its API calls do nothing.
+ */
+@interface OSInitializationOptions : NSObject
+@property (nonatomic) BOOL inAppMessagesEnabled;
+@property (nonatomic) BOOL locationEnabled;
+@property (nonatomic) BOOL liveActivitiesEnabled;
+@property (nonatomic) BOOL outcomesEnabled;
+@property (nonatomic) BOOL firebaseAnalyticsEnabled;
+@end
+
 // ======= OneSignal Class Interface =========
 @interface OneSignal : NSObject
 
@@ -77,6 +90,8 @@ NS_SWIFT_NAME(login(externalId:token:));
 
 #pragma mark Initialization
 + (void)initialize:(nonnull NSString*)newAppId withLaunchOptions:(nullable NSDictionary*)launchOptions;
+// The options are read once, on the first call, later calls can not disable modules that already started
++ (void)initialize:(nonnull NSString*)newAppId withLaunchOptions:(nullable NSDictionary*)launchOptions options:(nullable OSInitializationOptions*)options;
 + (void)setProvidesNotificationSettingsView:(BOOL)providesView;
 
 #pragma mark Live Activity
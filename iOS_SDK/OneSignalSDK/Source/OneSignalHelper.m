@@ -83,14 +83,21 @@ static OneSignal* singleInstance = nil;
 }
 
 + (void)runOnMainThread:(void(^)())block {
+    const void *callSite = __builtin_return_address(0);
     if ([NSThread isMainThread])
-        block();
+        [OSMainThreadWatchdog runBlock:block fromAddress:callSite];
     else
-        dispatch_sync(dispatch_get_main_queue(), block);
+        dispatch_sync(dispatch_get_main_queue(), ^{
+            [OSMainThreadWatchdog runBlock:block fromAddress:callSite];
+        });
 }
 
 + (void)dispatch_async_on_main_queue:(void(^)())block {
-    dispatch_async(dispatch_get_main_queue(), block);
+    // Captured here, the blocks on main are timed against the method that sent them there
+    const void *callSite = __builtin_return_address(0);
+    dispatch_async(dispatch_get_main_queue(), ^{
+        [OSMainThreadWatchdog runBlock:block fromAddress:callSite];
+    });
 }
 
 + (void)performSelector:(SEL)aSelector onMainThreadOnObject:(nullable id)targetObj withObject:(nullable id)anArgument afterDelay:(NSTimeInterval)delay {
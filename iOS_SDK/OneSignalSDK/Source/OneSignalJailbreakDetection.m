@@ -28,7 +28,17 @@
 
 @implementation OneSignalJailbreakDetection
 
+// The filesystem is only probed once per process
 + (BOOL)isJailbroken {
+    static BOOL jailbroken;
+    static dispatch_once_t once;
+    dispatch_once(&once, ^{
+        jailbroken = [self probeJailbroken];
+    });
+    return jailbroken;
+}
+
++ (BOOL)probeJailbroken {
     
 #if !(TARGET_IPHONE_SIMULATOR)
     
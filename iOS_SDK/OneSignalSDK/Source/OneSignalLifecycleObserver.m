@@ -30,6 +30,7 @@ THE SOFTWARE.
 #import "OneSignalInternal.h"
 #import "OneSignalCommonDefines.h"
 #import "OneSignalTracker.h"
+#import "OSBaseFocusTimeProcessor.h"
 #import <OneSignalLocation/OneSignalLocationManager.h>
 #import "UIApplication+OneSignal.h"
 
@@ -81,11 +82,11 @@ static OneSignalLifecycleObserver* _instance = nil;
     
     if ([OneSignalConfigManager getAppId]) {
         [OneSignalTracker onFocus:NO];
-        let oneSignalLocation = NSClassFromString(ONE_SIGNAL_LOCATION_CLASS_NAME);
+        let oneSignalLocation = [OSModuleRegistry classForModule:OSModuleLocation];
         if (oneSignalLocation != nil && [oneSignalLocation respondsToSelector:@selector(onFocus:)]) {
             [OneSignalCoreHelper callSelector:@selector(onFocus:) onObject:oneSignalLocation withArg:YES];
         }
-        let oneSignalInAppMessages = NSClassFromString(ONE_SIGNAL_IN_APP_MESSAGES_CLASS_NAME);
+        let oneSignalInAppMessages = [OSModuleRegistry classForModule:OSModuleInAppMessages];
         if (oneSignalInAppMessages != nil && [oneSignalInAppMessages respondsToSelector:@selector(onApplicationDidBecomeActive)]) {
             [oneSignalInAppMessages performSelector:@selector(onApplicationDidBecomeActive)];
         }
@@ -105,11 +106,15 @@ static OneSignalLifecycleObserver* _instance = nil;
 - (void)didEnterBackground {
     [OneSignalLog onesignalLog:ONE_S_LL_VERBOSE message:@"application/scene didEnterBackground"];
     if ([OneSignalConfigManager getAppId]) {
-        let oneSignalLocation = NSClassFromString(ONE_SIGNAL_LOCATION_CLASS_NAME);
+        let oneSignalLocation = [OSModuleRegistry classForModule:OSModuleLocation];
         if (oneSignalLocation != nil && [oneSignalLocation respondsToSelector:@selector(onFocus:)]) {
             [OneSignalCoreHelper callSelector:@selector(onFocus:) onObject:oneSignalLocation withArg:NO];
         }
+        // Send the session time still waiting out OS_SESSION_TIME_FLUSH_DELAY, the app may be suspended before it passes
+        [OSBaseFocusTimeProcessor flushPendingSessionTime];
     }
+    // Persist any writes still sitting in the write-behind journal before the app may be suspended
+    [OneSignalUserDefaults flushPendingWrites];
 }
 
 - (void)dealloc {
@@ -34,7 +34,17 @@
 static Class skPaymentQueue;
 static Class sKProductsRequestClass;
 static id productsRequest;
-NSMutableDictionary* skusToTrack;
+
+/*
+ Purchased quantities by sku, waiting on the price of their product.
+ A product's price is only requested once per launch and kept in `priceTable`, so purchases of known
+ products, and floods of transactions in one callback, are sent as one purchases delta without another lookup.
+ Access to all three is synchronized on the shared instance.
+ */
+static NSMutableDictionary<NSString *, NSNumber *> *pendingPurchases;
+static NSMutableDictionary<NSString *, NSDictionary *> *priceTable;
+// The skus of the products request in flight
+static NSSet<NSString *> *requestedSkus;
 
 // NSClassFromString and performSelector are used so OneSignal does not depend on StoreKit to link the app.
 // Suppressing undeclared selector warnings
@@ -63,8 +73,12 @@ static OneSignalTrackIAP* singleInstance = nil;
 - (id)init {
     self = [super init];
     
-    if (self)
+    if (self) {
+        pendingPurchases = [NSMutableDictionary new];
+        priceTable = [NSMutableDictionary new];
+        requestedSkus = nil;
         [[skPaymentQueue performSelector:@selector(defaultQueue)] performSelector:@selector(addTransactionObserver:) withObject:self];
+    }
     
     return self;
 }
@@ -83,33 +97,70 @@ static OneSignalTrackIAP* singleInstance = nil;
 }
 
 - (void)paymentQueue:(id)queue updatedTransactions:(NSArray*)transactions {
-    skusToTrack = [NSMutableDictionary new];
-    id skPayment;
+    BOOL hasPurchases = false;
+    
+    @synchronized (self) {
+        for (id transaction in transactions) {
+            NSInteger state = (NSInteger)[transaction performSelector:@selector(transactionState)];
+            // Only SKPaymentTransactionStatePurchased is tracked, restores and failures are skipped without reading their payment
+            if (state != 1)
+                continue;
+            
+            id skPayment = [transaction performSelector:@selector(payment)];
+            NSString* sku = [skPayment performSelector:@selector(productIdentifier)];
+            NSInteger quantity = (NSInteger)[skPayment performSelector:@selector(quantity)];
+            pendingPurchases[sku] = @([pendingPurchases[sku] integerValue] + quantity);
+            hasPurchases = true;
+        }
+    }
+    
+    if (hasPurchases)
+        [self sendPendingPurchases];
+}
+
+// Sends every pending purchase whose price is known as one delta, and requests the prices of the rest together
+- (void)sendPendingPurchases {
+    NSMutableArray* arrayOfPurchases = [NSMutableArray new];
+    NSMutableArray<NSString *>* unpricedSkus = [NSMutableArray new];
     
-    for (id transaction in transactions) {
-        NSInteger state = (NSInteger)[transaction performSelector:@selector(transactionState)];
-        switch (state) {
-            case 1: // SKPaymentTransactionStatePurchased
-                skPayment = [transaction performSelector:@selector(payment)];
-                NSString* sku = [skPayment performSelector:@selector(productIdentifier)];
-                NSInteger quantity = (NSInteger)[skPayment performSelector:@selector(quantity)];
-                
-                if (skusToTrack[sku])
-                    [skusToTrack[sku] setObject:[NSNumber numberWithInt:[skusToTrack[sku][@"count"] intValue] + (int)quantity] forKey:@"count"];
-                else
-                    skusToTrack[sku] = [NSMutableDictionary dictionaryWithObjectsAndKeys:[NSNumber numberWithInteger:quantity], @"count", nil];
-                break;
+    @synchronized (self) {
+        for (NSString *sku in pendingPurchases.allKeys) {
+            NSDictionary *price = priceTable[sku];
+            if (!price) {
+                [unpricedSkus addObject:sku];
+                continue;
+            }
+            
+            NSMutableDictionary* purchase = [price mutableCopy];
+            purchase[@"sku"] = sku;
+            NSInteger count = [pendingPurchases[sku] integerValue];
+            if (count != 1)
+                purchase[@"count"] = @(count);
+            [arrayOfPurchases addObject:purchase];
+            [pendingPurchases removeObjectForKey:sku];
+        }
+        
+        // Skus already being requested are sent when that request completes
+        if (!requestedSkus && unpricedSkus.count > 0) {
+            requestedSkus = [NSSet setWithArray:unpricedSkus];
+            [self getProductInfo:requestedSkus];
         }
     }
     
-    if (skusToTrack.count > 0)
-        [self getProductInfo:[skusToTrack allKeys]];
+    if ([arrayOfPurchases count] > 0) {
+        [self sendPurchases:arrayOfPurchases];
+    }
 }
 
+- (void)sendPurchases:(NSArray *)purchases {
+    [OneSignalUserManagerImpl.sharedInstance sendPurchases:purchases];
+}
 
-- (void)getProductInfo:(NSArray*)productIdentifiers {
-    sKProductsRequestClass = NSClassFromString(@"SKProductsRequest");
-    productsRequest = [[sKProductsRequestClass alloc] performSelector:@selector(initWithProductIdentifiers:) withObject:[NSSet setWithArray:productIdentifiers]];
+// Must be called while synchronized on self
+- (void)getProductInfo:(NSSet<NSString *>*)productIdentifiers {
+    if (!sKProductsRequestClass)
+        sKProductsRequestClass = NSClassFromString(@"SKProductsRequest");
+    productsRequest = [[sKProductsRequestClass alloc] performSelector:@selector(initWithProductIdentifiers:) withObject:productIdentifiers];
     [productsRequest setDelegate:(id)self];
     
     // [productsRequest performSelector:NSSelectorFromString(@"start")];
@@ -118,29 +169,43 @@ static OneSignalTrackIAP* singleInstance = nil;
 }
 
 - (void)productsRequest:(id)request didReceiveResponse:(id)response {
-    NSMutableArray* arrayOfPruchases = [NSMutableArray new];
+    static NSNumberFormatter *formatter;
+    static dispatch_once_t once;
+    dispatch_once(&once, ^{
+        formatter = [NSNumberFormatter new];
+        [formatter setMinimumFractionDigits:2];
+    });
     
-    for(id skProduct in [response performSelector:@selector(products)]) {
-        NSString* productSku = [skProduct performSelector:@selector(productIdentifier)];
-        NSMutableDictionary* purchase = skusToTrack[productSku];
-        if (purchase) { // In rare cases this can be nil when there wasn't a connection to Apple when opening the app but there was when buying an IAP item.
+    @synchronized (self) {
+        for(id skProduct in [response performSelector:@selector(products)]) {
+            NSString* productSku = [skProduct performSelector:@selector(productIdentifier)];
             
             // SKProduct.price is an NSDecimalNumber, but the backend expects a String
-            NSNumberFormatter *formatter = [NSNumberFormatter new];
-            [formatter setMinimumFractionDigits:2];
             NSString *formattedPrice = [formatter stringFromNumber:[skProduct performSelector:@selector(price)]];
-
-            purchase[@"sku"] = productSku;
-            purchase[@"amount"] = formattedPrice;
-            purchase[@"iso"] = [[skProduct performSelector:@selector(priceLocale)] objectForKey:NSLocaleCurrencyCode];
-            if ([purchase[@"count"] intValue] == 1)
-                [purchase removeObjectForKey:@"count"];
-            [arrayOfPruchases addObject:purchase];
+            NSString *iso = [[skProduct performSelector:@selector(priceLocale)] objectForKey:NSLocaleCurrencyCode];
+            if (formattedPrice && iso)
+                priceTable[productSku] = @{@"amount": formattedPrice, @"iso": iso};
+        }
+        
+        // In rare cases a product is missing from the response, such as when there wasn't a connection to Apple
+        // when opening the app but there was when buying an IAP item. Its purchases are dropped.
+        for (NSString *sku in requestedSkus) {
+            if (!priceTable[sku])
+                [pendingPurchases removeObjectForKey:sku];
         }
+        requestedSkus = nil;
+        productsRequest = nil;
     }
     
-    if ([arrayOfPruchases count] > 0) {
-        [OneSignalUserManagerImpl.sharedInstance sendPurchases:arrayOfPruchases];
+    // Also requests any product purchased while this request was in flight
+    [self sendPendingPurchases];
+}
+
+- (void)request:(id)request didFailWithError:(NSError *)error {
+    @synchronized (self) {
+        // The purchases stay pending, their prices are requested again with the next purchase
+        requestedSkus = nil;
+        productsRequest = nil;
     }
 }
 
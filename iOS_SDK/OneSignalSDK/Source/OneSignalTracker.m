@@ -35,6 +35,7 @@
 #import "OSFocusTimeProcessorFactory.h"
 #import "OSFocusCallParams.h"
 #import "OSFocusInfluenceParam.h"
+#import "OSBackgroundMaintenance.h"
 
 @interface OneSignal ()
 
@@ -105,8 +106,17 @@ static BOOL lastOnFocusWasToBackground = YES;
     
     if (timeProcessor)
         [timeProcessor sendOnFocusCall:focusCallParams];
+    /*
+     Everything the session end produced goes out in this one pass instead of on timers that race the background task.
+     The session duration outcome is a background upload, which also carries the buffered outcome events.
+     The session_time delta is enqueued now, so it joins the deltas the user module flushes in its background task,
+     rather than waiting out OS_SESSION_TIME_FLUSH_DELAY past suspension to be sent on the next launch.
+     */
+    [OSBaseFocusTimeProcessor flushPendingSessionTime];
+    [OSOutcomes.sharedController flushPendingOutcomeEvents];
     // user module let them know app is backgrounded
     [OneSignalUserManagerImpl.sharedInstance runBackgroundTasks];
+    [OSBackgroundMaintenance scheduleTask];
 }
 
 // Note: This is not from app backgrounding
@@ -32,6 +32,7 @@
 #import "OneSignalFramework.h"
 #import "OneSignalCommonDefines.h"
 #import "OneSignalTracker.h"
+#import "OSBaseFocusTimeProcessor.h"
 #import "OneSignalSelectorHelpers.h"
 #import "SwizzlingForwarder.h"
 #import <objc/runtime.h>
@@ -55,7 +56,7 @@ static NSMutableSet<Class>* swizzledClasses;
 
 - (void) setOneSignalDelegate:(id<UIApplicationDelegate>)delegate {
     [OneSignalAppDelegate traceCall:@"setOneSignalDelegate:"];
-    [OneSignalLog onesignalLog:ONE_S_LL_VERBOSE message:[NSString stringWithFormat:@"ONESIGNAL setOneSignalDelegate CALLED: %@", delegate]];
+    ONE_S_LOG(ONE_S_LL_VERBOSE, @"ONESIGNAL setOneSignalDelegate CALLED: %@", delegate);
     
     if (swizzledClasses == nil)
         swizzledClasses = [NSMutableSet new];
@@ -82,13 +83,13 @@ static NSMutableSet<Class>* swizzledClasses;
 
 + (BOOL)swizzledClassInHeirarchy:(Class)delegateClass {
     if ([swizzledClasses containsObject:delegateClass]) {
-        [OneSignalLog onesignalLog:ONE_S_LL_VERBOSE message:[NSString stringWithFormat:@"OneSignal already swizzled %@", NSStringFromClass(delegateClass)]];
+        ONE_S_LOG(ONE_S_LL_VERBOSE, @"OneSignal already swizzled %@", NSStringFromClass(delegateClass));
         return true;
     }
     Class superClass = class_getSuperclass(delegateClass);
     while(superClass) {
         if ([swizzledClasses containsObject:superClass]) {
-            [OneSignalLog onesignalLog:ONE_S_LL_VERBOSE message:[NSString stringWithFormat:@"OneSignal already swizzled %@ in super class: %@", NSStringFromClass(delegateClass), NSStringFromClass(superClass)]];
+            ONE_S_LOG(ONE_S_LL_VERBOSE, @"OneSignal already swizzled %@ in super class: %@", NSStringFromClass(delegateClass), NSStringFromClass(superClass));
             return true;
         }
         superClass = class_getSuperclass(superClass);
@@ -99,8 +100,11 @@ static NSMutableSet<Class>* swizzledClasses;
 -(void)oneSignalApplicationWillTerminate:(UIApplication *)application {
     [OneSignalAppDelegate traceCall:@"oneSignalApplicationWillTerminate:"];
     
-    if ([OneSignal appId])
+    if ([OneSignal appId]) {
         [OneSignalTracker onFocus:YES];
+        // onFocus is skipped when the app was already backgrounded, the session time may still be waiting to be sent
+        [OSBaseFocusTimeProcessor flushPendingSessionTime];
+    }
     
     SwizzlingForwarder *forwarder = [[SwizzlingForwarder alloc]
         initWithTarget:self
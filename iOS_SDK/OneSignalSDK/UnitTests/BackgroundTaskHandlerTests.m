@@ -0,0 +1,87 @@
+/**
+ * Modified MIT License
+ *
+ * Copyright 2024 OneSignal
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * 2. All copies of substantial portions of the Software may only be used in connection
+ * with services provided by OneSignal.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#import <XCTest/XCTest.h>
+#import "OSBackgroundTaskHandlerImpl.h"
+
+// Reports the time remaining the test sets instead of the application's
+@interface TimeRemainingBackgroundTaskHandler : OSBackgroundTaskHandlerImpl
+@property (nonatomic) NSTimeInterval timeRemaining;
+@end
+
+@implementation TimeRemainingBackgroundTaskHandler
+- (NSTimeInterval)applicationBackgroundTimeRemaining {
+    return self.timeRemaining;
+}
+@end
+
+@interface BackgroundTaskHandlerTests : XCTestCase
+
+@end
+
+@implementation BackgroundTaskHandlerTests
+
+// The time remaining is read on the main queue after a begin
+- (void)beginTask:(NSString *)taskIdentifier withHandler:(TimeRemainingBackgroundTaskHandler *)handler {
+    [handler beginBackgroundTask:taskIdentifier];
+    [NSRunLoop.currentRunLoop runUntilDate:[NSDate dateWithTimeIntervalSinceNow:0.05]];
+}
+
+- (void)testBegin_readsTheTimeRemainingAgainWhileTheSharedTaskIsHeld {
+    TimeRemainingBackgroundTaskHandler *handler = [TimeRemainingBackgroundTaskHandler new];
+    handler.timeRemaining = DBL_MAX;
+    [self beginTask:@"foreground" withHandler:handler];
+    XCTAssertEqual([handler backgroundTimeRemaining], DBL_MAX);
+
+    // The app backgrounded while the first task was still held
+    handler.timeRemaining = 25;
+    [self beginTask:@"background" withHandler:handler];
+    XCTAssertEqualWithAccuracy([handler backgroundTimeRemaining], 25, 1);
+
+    // And returned to the foreground
+    handler.timeRemaining = DBL_MAX;
+    [self beginTask:@"foreground again" withHandler:handler];
+    XCTAssertEqual([handler backgroundTimeRemaining], DBL_MAX);
+
+    [handler endBackgroundTask:@"foreground"];
+    [handler endBackgroundTask:@"background"];
+    [handler endBackgroundTask:@"foreground again"];
+}
+
+- (void)testEndingTheLastTask_forgetsTheExpirationDate {
+    TimeRemainingBackgroundTaskHandler *handler = [TimeRemainingBackgroundTaskHandler new];
+    handler.timeRemaining = 25;
+    [self beginTask:@"first" withHandler:handler];
+    [self beginTask:@"second" withHandler:handler];
+
+    [handler endBackgroundTask:@"first"];
+    XCTAssertEqualWithAccuracy([handler backgroundTimeRemaining], 25, 1);
+    [handler endBackgroundTask:@"second"];
+    XCTAssertEqual([handler backgroundTimeRemaining], DBL_MAX);
+}
+
+@end
@@ -0,0 +1,78 @@
+/**
+ * Modified MIT License
+ *
+ * Copyright 2024 OneSignal
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * 2. All copies of substantial portions of the Software may only be used in connection
+ * with services provided by OneSignal.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#import <XCTest/XCTest.h>
+#import <OneSignalExtension/OneSignalExtensionBadgeHandler.h>
+
+@interface BadgeCacheTests : XCTestCase
+
+@end
+
+@implementation BadgeCacheTests
+
+- (void)setUp {
+    [OneSignalExtensionBadgeHandler updateCachedBadgeValue:0];
+}
+
+- (void)tearDown {
+    [self setUp];
+}
+
+- (void)waitForBackgroundWrites {
+    XCTestExpectation *expectation = [self expectationWithDescription:@"background writes"];
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(0.5 * NSEC_PER_SEC)), dispatch_get_global_queue(QOS_CLASS_UTILITY, 0), ^{
+        [expectation fulfill];
+    });
+    [self waitForExpectations:@[expectation] timeout:2];
+}
+
+- (void)testSetNeedsCachedBadgeValue_writesTheLatestValueOfABurst {
+    for (NSInteger value = 1; value <= 20; value++)
+        [OneSignalExtensionBadgeHandler setNeedsCachedBadgeValue:value];
+
+    [self waitForBackgroundWrites];
+
+    XCTAssertEqual([OneSignalExtensionBadgeHandler currentCachedBadgeValue], 20);
+}
+
+- (void)testSetNeedsCachedBadgeValue_isReadBeforeItsWriteRuns {
+    [OneSignalExtensionBadgeHandler setNeedsCachedBadgeValue:5];
+
+    XCTAssertEqual([OneSignalExtensionBadgeHandler currentCachedBadgeValue], 5);
+}
+
+- (void)testSetNeedsCachedBadgeValue_isNotAppliedAfterALaterUpdate {
+    [OneSignalExtensionBadgeHandler setNeedsCachedBadgeValue:7];
+    [OneSignalExtensionBadgeHandler updateCachedBadgeValue:2];
+
+    [self waitForBackgroundWrites];
+
+    XCTAssertEqual([OneSignalExtensionBadgeHandler currentCachedBadgeValue], 2);
+}
+
+@end
@@ -0,0 +1,107 @@
+/**
+ * Modified MIT License
+ *
+ * Copyright 2024 OneSignal
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * 2. All copies of substantial portions of the Software may only be used in connection
+ * with services provided by OneSignal.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#import <XCTest/XCTest.h>
+#import <OneSignalNotifications/OneSignalNotifications.h>
+
+@interface OSDisplayableNotification (DisplayTimeoutSchedulerTests)
++ (instancetype)parseWithApns:(nonnull NSDictionary*)message;
+- (void)setCompletionBlock:(OSNotificationDisplayResponse)completion;
+@end
+
+@interface OSDisplayTimeoutScheduler : NSObject
++ (OSDisplayTimeoutScheduler *)sharedScheduler;
+- (void)scheduleTimeoutForNotification:(OSDisplayableNotification *)notification after:(NSTimeInterval)timeout;
+- (void)cancelTimeoutForNotification:(OSDisplayableNotification *)notification;
+@end
+
+@interface DisplayTimeoutSchedulerTests : XCTestCase
+
+@end
+
+@implementation DisplayTimeoutSchedulerTests
+
+- (OSDisplayableNotification *)notificationWithId:(NSString *)notificationId timedOutIds:(NSMutableArray<NSString *> *)timedOutIds {
+    OSDisplayableNotification *notification = [OSDisplayableNotification parseWithApns:@{
+        @"aps" : @{@"alert" : @"Message"},
+        @"custom" : @{@"i" : notificationId}
+    }];
+    [notification setCompletionBlock:^(OSNotification *displayed) {
+        [timedOutIds addObject:notificationId];
+    }];
+    return notification;
+}
+
+- (void)testScheduler_timesOutPendingNotificationsInDeadlineOrder {
+    NSMutableArray<NSString *> *timedOutIds = [NSMutableArray new];
+    OSDisplayableNotification *late = [self notificationWithId:@"late" timedOutIds:timedOutIds];
+    OSDisplayableNotification *early = [self notificationWithId:@"early" timedOutIds:timedOutIds];
+    OSDisplayableNotification *middle = [self notificationWithId:@"middle" timedOutIds:timedOutIds];
+
+    [[OSDisplayTimeoutScheduler sharedScheduler] scheduleTimeoutForNotification:late after:0.6];
+    [[OSDisplayTimeoutScheduler sharedScheduler] scheduleTimeoutForNotification:early after:0.2];
+    [[OSDisplayTimeoutScheduler sharedScheduler] scheduleTimeoutForNotification:middle after:0.4];
+
+    [[NSRunLoop mainRunLoop] runUntilDate:[NSDate dateWithTimeIntervalSinceNow:0.3]];
+    XCTAssertEqualObjects(timedOutIds, @[@"early"]);
+
+    [[NSRunLoop mainRunLoop] runUntilDate:[NSDate dateWithTimeIntervalSinceNow:0.6]];
+    NSArray *expectedIds = @[@"early", @"middle", @"late"];
+    XCTAssertEqualObjects(timedOutIds, expectedIds);
+}
+
+- (void)testScheduler_doesNotTimeOutACompletedNotification {
+    NSMutableArray<NSString *> *timedOutIds = [NSMutableArray new];
+    OSDisplayableNotification *displayed = [self notificationWithId:@"displayed" timedOutIds:timedOutIds];
+    OSDisplayableNotification *pending = [self notificationWithId:@"pending" timedOutIds:timedOutIds];
+    [[OSDisplayTimeoutScheduler sharedScheduler] scheduleTimeoutForNotification:displayed after:0.2];
+    [[OSDisplayTimeoutScheduler sharedScheduler] scheduleTimeoutForNotification:pending after:0.4];
+
+    // Displaying completes the notification, which cancels its timeout and rearms for the next deadline
+    [displayed display];
+    [timedOutIds removeAllObjects];
+    [[NSRunLoop mainRunLoop] runUntilDate:[NSDate dateWithTimeIntervalSinceNow:0.6]];
+
+    XCTAssertEqualObjects(timedOutIds, @[@"pending"]);
+}
+
+- (void)testScheduler_reschedulingANotificationKeepsOneDeadline {
+    NSMutableArray<NSString *> *timedOutIds = [NSMutableArray new];
+    OSDisplayableNotification *notification = [self notificationWithId:@"notification_id" timedOutIds:timedOutIds];
+
+    [[OSDisplayTimeoutScheduler sharedScheduler] scheduleTimeoutForNotification:notification after:0.2];
+    [[OSDisplayTimeoutScheduler sharedScheduler] scheduleTimeoutForNotification:notification after:0.5];
+    [[NSRunLoop mainRunLoop] runUntilDate:[NSDate dateWithTimeIntervalSinceNow:0.3]];
+
+    XCTAssertEqual(timedOutIds.count, 0);
+
+    [[NSRunLoop mainRunLoop] runUntilDate:[NSDate dateWithTimeIntervalSinceNow:0.4]];
+    XCTAssertEqualObjects(timedOutIds, @[@"notification_id"]);
+}
+
+@end
@@ -0,0 +1,138 @@
+/**
+ * Modified MIT License
+ *
+ * Copyright 2024 OneSignal
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * 2. All copies of substantial portions of the Software may only be used in connection
+ * with services provided by OneSignal.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#import <XCTest/XCTest.h>
+#import <OneSignalCore/OneSignalCore.h>
+#import "OSBaseFocusTimeProcessor.h"
+#import "OSAttributedFocusTimeProcessor.h"
+#import "OneSignalLifecycleObserver.h"
+#import "OneSignalTracker.h"
+#import <OneSignalOutcomes/OneSignalOutcomes.h>
+
+@interface OneSignalLifecycleObserver (FocusTimeProcessorTests)
+- (void)didEnterBackground;
+@end
+
+@interface OneSignalTracker (FocusTimeProcessorTests)
++ (void)applicationBackgrounded;
+@end
+
+@interface OSAttributedFocusTimeProcessor (FocusTimeProcessorTests)
+- (void)sendSessionEndOutcomes:(NSTimeInterval)totalTimeActive params:(OSFocusCallParams *)params deferralDelay:(NSTimeInterval)deferralDelay onSuccess:(OSResultSuccessBlock _Nonnull)successBlock onFailure:(OSFailureBlock _Nonnull)failureBlock;
+@end
+
+// Holds on to the session end instead of sending it
+@interface SessionEndHoldingProcessor : OSAttributedFocusTimeProcessor
+@property (nonatomic) OSFailureBlock failureBlock;
+@end
+
+@implementation SessionEndHoldingProcessor
+- (void)sendSessionEndOutcomes:(NSTimeInterval)totalTimeActive params:(OSFocusCallParams *)params deferralDelay:(NSTimeInterval)deferralDelay onSuccess:(OSResultSuccessBlock _Nonnull)successBlock onFailure:(OSFailureBlock _Nonnull)failureBlock {
+    self.failureBlock = failureBlock;
+}
+@end
+
+@interface FocusTimeProcessorTests : XCTestCase
+
+@end
+
+@implementation FocusTimeProcessorTests
+
+- (void)setUp {
+    [OSBaseFocusTimeProcessor clearStatics];
+    [OneSignalConfigManager setAppId:@"test-app-id"];
+}
+
+- (void)tearDown {
+    [OneSignalUserDefaults.initShared removeValueForKey:OSUD_PENDING_SESSION_TIME];
+    [OneSignalUserDefaults.initShared removeValueForKey:OSUD_UNSENT_ACTIVE_TIME_ATTRIBUTED];
+    [OneSignalUserDefaults.initShared removeValueForKey:OSUD_UNSENT_ACTIVE_TIME];
+    [OSBaseFocusTimeProcessor clearStatics];
+    [OneSignalConfigManager setAppId:nil];
+}
+
+- (void)testDidEnterBackground_sendsThePendingSessionTime {
+    // Session time left over from a launch that was suspended before its flush
+    [OneSignalUserDefaults.initShared saveDoubleForKey:OSUD_PENDING_SESSION_TIME withValue:2.5];
+
+    [[OneSignalLifecycleObserver sharedInstance] didEnterBackground];
+
+    // The whole seconds were sent, the fraction waits for the next flush
+    XCTAssertEqualWithAccuracy([OneSignalUserDefaults.initShared getSavedDoubleForKey:OSUD_PENDING_SESSION_TIME defaultValue:0], 0.5, 0.001);
+}
+
+- (void)testApplicationBackgrounded_sendsThePendingSessionTimeWithTheSessionEnd {
+    [OneSignalUserDefaults.initShared saveDoubleForKey:OSUD_PENDING_SESSION_TIME withValue:2.5];
+    // Too short a focus for the unattributed processor to send, only the pending time is left to go out
+    [OSSessionManager.sharedSessionManager setLastOpenedTime:[[NSDate date] timeIntervalSince1970]];
+
+    [OneSignalTracker applicationBackgrounded];
+
+    // Sent in the same pass, before the user module's background flush, not after OS_SESSION_TIME_FLUSH_DELAY
+    XCTAssertEqualWithAccuracy([OneSignalUserDefaults.initShared getSavedDoubleForKey:OSUD_PENDING_SESSION_TIME defaultValue:0], 0.5, 0.001);
+}
+
+- (void)testBufferedSessionTime_carriesTheFractionOver {
+    [OneSignalUserDefaults.initShared saveDoubleForKey:OSUD_PENDING_SESSION_TIME withValue:0];
+
+    [OSBaseFocusTimeProcessor bufferSessionTime:0.75];
+    XCTAssertEqualWithAccuracy([OneSignalUserDefaults.initShared getSavedDoubleForKey:OSUD_PENDING_SESSION_TIME defaultValue:0], 0.75, 0.001);
+
+    [OSBaseFocusTimeProcessor bufferSessionTime:0.75];
+    XCTAssertEqualWithAccuracy([OneSignalUserDefaults.initShared getSavedDoubleForKey:OSUD_PENDING_SESSION_TIME defaultValue:0], 0.5, 0.001);
+}
+
+- (void)testFailedSessionEnd_isRestoredOnceWhenTheAppReturns {
+    let processor = [SessionEndHoldingProcessor new];
+    [processor saveUnsentActiveTime:5];
+    let params = [[OSFocusCallParams alloc] initWithParamsAppId:@"test-app-id" timeElapsed:0 influenceParams:@[] onSessionEnded:false];
+
+    [processor sendUnsentActiveTime:params];
+    XCTAssertEqual([processor getUnsentActiveTime], 0);
+
+    processor.failureBlock([NSError errorWithDomain:NSURLErrorDomain code:NSURLErrorNotConnectedToInternet userInfo:nil]);
+    XCTAssertEqual([processor getUnsentActiveTime], 5);
+
+    // Returning before the upload's begin date cancels it, the failure above already restored the time
+    [processor cancelDelayedJob];
+    XCTAssertEqual([processor getUnsentActiveTime], 5);
+}
+
+- (void)testCancelledSessionEnd_isRestoredByItsFailureBlock {
+    let processor = [SessionEndHoldingProcessor new];
+    [processor saveUnsentActiveTime:5];
+    let params = [[OSFocusCallParams alloc] initWithParamsAppId:@"test-app-id" timeElapsed:0 influenceParams:@[] onSessionEnded:false];
+
+    [processor sendUnsentActiveTime:params];
+    [processor cancelDelayedJob];
+    XCTAssertEqual([processor getUnsentActiveTime], 0);
+
+    processor.failureBlock([NSError errorWithDomain:NSURLErrorDomain code:NSURLErrorCancelled userInfo:nil]);
+    XCTAssertEqual([processor getUnsentActiveTime], 5);
+}
+
+@end
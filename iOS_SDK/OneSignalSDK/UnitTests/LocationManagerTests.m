@@ -0,0 +1,105 @@
+/**
+ * Modified MIT License
+ *
+ * Copyright 2024 OneSignal
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * 2. All copies of substantial portions of the Software may only be used in connection
+ * with services provided by OneSignal.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#import <XCTest/XCTest.h>
+#import <OneSignalCore/OneSignalCore.h>
+#import "OneSignalLocationManager.h"
+
+@interface OneSignalLocationManager (LocationManagerTests)
++ (double)distanceInMetersFrom:(os_location_coordinate)from to:(os_location_coordinate)to;
++ (BOOL)isSignificantChangeFrom:(os_location_coordinate)sentCords sentAt:(NSDate *)sentDate to:(os_location_coordinate)cords;
++ (BOOL)isLocationNeeded;
++ (bool)started;
++ (os_last_location *)lastLocation;
++ (dispatch_queue_t)locationQueue;
++ (NSMutableArray *)locationListeners;
++ (void)sendAndClearLocationListener:(PromptActionResult)result;
+@end
+
+@interface LocationManagerTests : XCTestCase
+
+@end
+
+@implementation LocationManagerTests
+
+- (void)testDistance_isTheGreatCircleDistance {
+    os_location_coordinate paris = {48.8566, 2.3522};
+    os_location_coordinate london = {51.5074, -0.1278};
+    // About 344 km
+    XCTAssertEqualWithAccuracy([OneSignalLocationManager distanceInMetersFrom:paris to:london], 343500, 1500);
+    XCTAssertEqual([OneSignalLocationManager distanceInMetersFrom:paris to:paris], 0);
+}
+
+- (void)testCoalescing_onlyFarAndLateEnoughFixesAreSent {
+    os_location_coordinate sent = {40.0, -74.0};
+    // About 10 m away, jitter around the same place
+    os_location_coordinate near = {40.0001, -74.0};
+    // About 11 km away, past the distance threshold even while the power policy widens it
+    os_location_coordinate far = {40.1, -74.0};
+    NSDate *longAgo = [NSDate dateWithTimeIntervalSinceNow:-24 * 60 * 60];
+
+    // Nothing sent yet
+    XCTAssertTrue([OneSignalLocationManager isSignificantChangeFrom:sent sentAt:nil to:near]);
+    // A burst right after a send is coalesced away, however far it moved
+    XCTAssertFalse([OneSignalLocationManager isSignificantChangeFrom:sent sentAt:[NSDate date] to:far]);
+    // Enough time passed, but it barely moved
+    XCTAssertFalse([OneSignalLocationManager isSignificantChangeFrom:sent sentAt:longAgo to:near]);
+    XCTAssertTrue([OneSignalLocationManager isSignificantChangeFrom:sent sentAt:longAgo to:far]);
+}
+
+- (void)testListeners_areCalledOnceOnTheMainThread {
+    XCTestExpectation *called = [self expectationWithDescription:@"listener called"];
+    __block int calls = 0;
+    dispatch_async(OneSignalLocationManager.locationQueue, ^{
+        [OneSignalLocationManager.locationListeners addObject:^(PromptActionResult result) {
+            XCTAssertTrue(NSThread.isMainThread);
+            XCTAssertEqual(result, PERMISSION_GRANTED);
+            calls++;
+            [called fulfill];
+        }];
+        [OneSignalLocationManager sendAndClearLocationListener:PERMISSION_GRANTED];
+        [OneSignalLocationManager sendAndClearLocationListener:PERMISSION_DENIED];
+    });
+    [self waitForExpectations:@[called] timeout:2];
+    // Let a second, wrong call reach the main queue
+    [[NSRunLoop mainRunLoop] runUntilDate:[NSDate dateWithTimeIntervalSinceNow:0.1]];
+    XCTAssertEqual(calls, 1);
+}
+
+- (void)testStart_staysDormantWhileLocationIsNotShared {
+    [OneSignalConfigManager setAppId:@"test-app-id"];
+    [OneSignalLocationManager startLocationSharedWithFlag:false];
+    XCTAssertFalse([OneSignalLocationManager isLocationNeeded]);
+
+    [OneSignalLocationManager start];
+
+    XCTAssertFalse([OneSignalLocationManager started]);
+    XCTAssertEqual([OneSignalLocationManager lastLocation], NULL);
+}
+
+@end
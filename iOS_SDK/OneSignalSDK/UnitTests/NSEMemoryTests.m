@@ -0,0 +1,89 @@
+/**
+ * Modified MIT License
+ *
+ * Copyright 2024 OneSignal
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * 2. All copies of substantial portions of the Software may only be used in connection
+ * with services provided by OneSignal.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#import <XCTest/XCTest.h>
+#import <UserNotifications/UserNotifications.h>
+#import <OneSignalExtension/OneSignalExtension.h>
+#import "OSMemoryFootprint.h"
+
+/*
+ Memory budget for the Notification Service Extension path. The system kills an NSE at around 24 MB of physical
+ footprint, most of which the app's own extension code and the frameworks it loads already use, so the SDK
+ must add little over a run even when many notifications arrive back to back.
+ Raise the budget only together with the change that needs it, so growth is a deliberate decision.
+ */
+#define OS_NSE_MEMORY_BUDGET_50_NOTIFICATIONS (2 * 1024 * 1024)
+
+@interface NSEMemoryTests : XCTestCase
+
+@end
+
+@implementation NSEMemoryTests
+
+// A notification with action buttons and no attachments, so the run does not depend on the network
+- (UNNotificationRequest *)notificationRequest {
+    UNMutableNotificationContent *content = [UNMutableNotificationContent new];
+    content.title = @"Title";
+    content.body = @"Body";
+    content.userInfo = @{
+        @"aps" : @{@"alert" : @{@"title" : @"Title", @"body" : @"Body"}, @"mutable-content" : @1},
+        @"os_data" : @{
+            @"i" : [NSUUID UUID].UUIDString,
+            @"buttons" : @[@{@"i" : @"button_1", @"n" : @"Open"}, @{@"i" : @"button_2", @"n" : @"Dismiss"}]
+        }
+    };
+    return [UNNotificationRequest requestWithIdentifier:[NSUUID UUID].UUIDString content:content trigger:nil];
+}
+
+- (void)handleNotifications:(NSUInteger)count {
+    for (NSUInteger i = 0; i < count; i++) {
+        @autoreleasepool {
+            UNNotificationRequest *request = [self notificationRequest];
+            [OneSignalNotificationServiceExtensionHandler didReceiveNotificationExtensionRequest:request withMutableNotificationContent:[request.content mutableCopy]];
+        }
+    }
+}
+
+- (void)testHandling50Notifications_staysWithinBudget {
+    // The first run loads the SDK's classes and caches, which an NSE pays for once per process
+    [self handleNotifications:1];
+    uint64_t before = OSPhysicalFootprint();
+    [self handleNotifications:50];
+    uint64_t after = OSPhysicalFootprint();
+    uint64_t growth = after > before ? after - before : 0;
+    XCTAssertLessThanOrEqual(growth, OS_NSE_MEMORY_BUDGET_50_NOTIFICATIONS, @"Handling 50 notifications grew the footprint by %llu bytes", growth);
+}
+
+- (void)testHandlingNotifications_memory {
+    if (@available(iOS 13.0, *)) {
+        [self measureWithMetrics:@[[XCTMemoryMetric new]] block:^{
+            [self handleNotifications:10];
+        }];
+    }
+}
+
+@end
@@ -0,0 +1,136 @@
+/**
+ * Modified MIT License
+ *
+ * Copyright 2024 OneSignal
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * 2. All copies of substantial portions of the Software may only be used in connection
+ * with services provided by OneSignal.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#import <XCTest/XCTest.h>
+#import <UserNotifications/UserNotifications.h>
+#import <OneSignalExtension/OneSignalExtension.h>
+#import "NSURLSessionOverrider.h"
+#import "OSMemoryFootprint.h"
+
+/*
+ Replays a corpus of APNs payloads shaped like real traffic through the Notification Service Extension handler
+ and reports p50 and p99 handling time and peak footprint growth per payload class.
+ Attachments are served by the stub media host of NSURLSessionOverrider, so sizes vary without the network.
+ Every run uses new notification ids and media URLs, so the media cache and duplicate checks do not skip work.
+ */
+#define OS_NSE_REPLAY_ITERATIONS 25
+// Far above what any class should take, it catches a stage that waits on a timeout instead of completing
+#define OS_NSE_REPLAY_P99_BUDGET_SECONDS 2.0
+
+@interface NSEReplayBenchmarkTests : XCTestCase
+
+@end
+
+@implementation NSEReplayBenchmarkTests
+
+- (NSDictionary *)attachmentsWithPixels:(NSArray<NSNumber *> *)pixels {
+    NSMutableDictionary *attachments = [NSMutableDictionary new];
+    for (NSNumber *size in pixels) {
+        NSString *key = [NSString stringWithFormat:@"image_%lu", (unsigned long)attachments.count];
+        attachments[key] = [NSString stringWithFormat:@"https://%@/%@.png?px=%@", NSE_STUB_MEDIA_HOST, [NSUUID UUID].UUIDString, size];
+    }
+    return attachments;
+}
+
+// Each payload class builds a fresh payload per run
+- (NSDictionary<NSString *, NSDictionary *(^)(void)> *)payloadCorpus {
+    NSDictionary *aps = @{@"alert" : @{@"title" : @"Title", @"body" : @"Body"}, @"mutable-content" : @1};
+    NSArray *buttons = @[@{@"i" : @"button_1", @"n" : @"Open"}, @{@"i" : @"button_2", @"n" : @"Dismiss"}];
+    return @{
+        @"plain" : ^NSDictionary *{
+            return @{@"aps" : aps, @"os_data" : @{@"i" : [NSUUID UUID].UUIDString}};
+        },
+        @"buttons" : ^NSDictionary *{
+            return @{@"aps" : aps, @"os_data" : @{@"i" : [NSUUID UUID].UUIDString, @"buttons" : buttons}};
+        },
+        @"badge_increment" : ^NSDictionary *{
+            return @{@"aps" : aps, @"os_data" : @{@"i" : [NSUUID UUID].UUIDString, @"badge_inc" : @1}};
+        },
+        @"attachment_small" : ^NSDictionary *{
+            return @{@"aps" : aps, @"os_data" : @{@"i" : [NSUUID UUID].UUIDString, @"att" : [self attachmentsWithPixels:@[@128]]}};
+        },
+        @"attachment_large" : ^NSDictionary *{
+            return @{@"aps" : aps, @"os_data" : @{@"i" : [NSUUID UUID].UUIDString, @"att" : [self attachmentsWithPixels:@[@2048]]}};
+        },
+        @"attachments_3_mixed_with_buttons" : ^NSDictionary *{
+            return @{@"aps" : aps, @"os_data" : @{@"i" : [NSUUID UUID].UUIDString, @"buttons" : buttons, @"att" : [self attachmentsWithPixels:@[@128, @512, @1024]]}};
+        }
+    };
+}
+
+- (UNNotificationRequest *)requestWithUserInfo:(NSDictionary *)userInfo {
+    UNMutableNotificationContent *content = [UNMutableNotificationContent new];
+    content.title = @"Title";
+    content.body = @"Body";
+    content.userInfo = userInfo;
+    return [UNNotificationRequest requestWithIdentifier:[NSUUID UUID].UUIDString content:content trigger:nil];
+}
+
+static NSTimeInterval percentile(NSArray<NSNumber *> *sortedDurations, double fraction) {
+    NSUInteger index = MIN((NSUInteger)ceil(fraction * sortedDurations.count), sortedDurations.count) - 1;
+    return sortedDurations[index].doubleValue;
+}
+
+- (void)testReplayingThePayloadCorpus_reportsLatencyAndPeakMemoryPerClass {
+    NSDictionary<NSString *, NSDictionary *(^)(void)> *corpus = [self payloadCorpus];
+    NSMutableString *report = [NSMutableString stringWithString:@"class, p50 ms, p99 ms, peak footprint growth KB\n"];
+    
+    // The first run loads the SDK's classes and caches, which an NSE pays for once per process
+    UNNotificationRequest *warmup = [self requestWithUserInfo:corpus[@"plain"]()];
+    [OneSignalNotificationServiceExtensionHandler didReceiveNotificationExtensionRequest:warmup withMutableNotificationContent:[warmup.content mutableCopy] withContentHandler:^(UNNotificationContent *content) {}];
+    
+    for (NSString *payloadClass in [corpus.allKeys sortedArrayUsingSelector:@selector(compare:)]) {
+        NSMutableArray<NSNumber *> *durations = [NSMutableArray new];
+        uint64_t baseline = OSPhysicalFootprint();
+        uint64_t peak = baseline;
+        for (int run = 0; run < OS_NSE_REPLAY_ITERATIONS; run++) {
+            @autoreleasepool {
+                UNNotificationRequest *request = [self requestWithUserInfo:corpus[payloadClass]()];
+                __block BOOL handled = false;
+                CFAbsoluteTime start = CFAbsoluteTimeGetCurrent();
+                [OneSignalNotificationServiceExtensionHandler didReceiveNotificationExtensionRequest:request withMutableNotificationContent:[request.content mutableCopy] withContentHandler:^(UNNotificationContent *content) {
+                    handled = true;
+                }];
+                [durations addObject:@(CFAbsoluteTimeGetCurrent() - start)];
+                XCTAssertTrue(handled, @"%@ did not call the content handler", payloadClass);
+                peak = MAX(peak, OSPhysicalFootprint());
+            }
+        }
+        [durations sortUsingSelector:@selector(compare:)];
+        NSTimeInterval p50 = percentile(durations, 0.5);
+        NSTimeInterval p99 = percentile(durations, 0.99);
+        [report appendFormat:@"%@, %.2f, %.2f, %llu\n", payloadClass, p50 * 1000, p99 * 1000, (peak - baseline) / 1024];
+        XCTAssertLessThan(p99, OS_NSE_REPLAY_P99_BUDGET_SECONDS, @"%@ p99 handling time was %.3f seconds", payloadClass, p99);
+    }
+    
+    XCTAttachment *attachment = [XCTAttachment attachmentWithString:report];
+    attachment.name = @"NSE replay benchmark";
+    attachment.lifetime = XCTAttachmentLifetimeKeepAlways;
+    [self addAttachment:attachment];
+}
+
+@end
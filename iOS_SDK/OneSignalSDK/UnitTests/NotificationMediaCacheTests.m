@@ -0,0 +1,207 @@
+/**
+ * Modified MIT License
+ *
+ * Copyright 2024 OneSignal
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * 2. All copies of substantial portions of the Software may only be used in connection
+ * with services provided by OneSignal.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#import <XCTest/XCTest.h>
+#import <UIKit/UIKit.h>
+#import <ImageIO/ImageIO.h>
+#import <OneSignalCore/OneSignalCore.h>
+
+// OneSignalAttachmentMediaCache is internal to OneSignalExtension, so it is reached through the runtime
+@protocol OSAttachmentMediaCacheTesting
++ (NSString *)cachedMediaPathForURL:(NSString *)urlString;
++ (void)cacheMediaAtPath:(NSString *)path forURL:(NSString *)urlString;
+@end
+
+// Attachment downloads are tracked by the private delegate of the extension's download session
+@protocol OSDirectDownloadTesting
+@property (strong, nonatomic) NSURL *url;
+@property (strong, nonatomic) NSString *localPath;
+@property (strong, nonatomic) dispatch_semaphore_t semaphore;
+@property (strong, atomic) NSError *error;
+@end
+
+@protocol OSDirectDownloadDelegateTesting
+- (void)addDownload:(id)download forTask:(NSURLSessionTask *)task;
+- (void)cancelDownloadsForURLs:(NSSet<NSURL *> *)urls;
+- (void)URLSession:(NSURLSession *)session downloadTask:(NSURLSessionDownloadTask *)downloadTask didFinishDownloadingToURL:(NSURL *)location;
+- (void)URLSession:(NSURLSession *)session task:(NSURLSessionTask *)task didCompleteWithError:(NSError *)error;
+@end
+
+@protocol OSDirectDownloadSessionTesting
++ (NSURLSession *)directDownloadSession;
+@end
+
+@protocol OSAttachmentDownsamplingTesting
++ (void)downsampleImageAtPath:(NSString *)path toMaxPixelSize:(NSInteger)maxPixelSize;
+@end
+
+@interface NotificationMediaCacheTests : XCTestCase
+
+@end
+
+@implementation NotificationMediaCacheTests
+
+- (Class<OSAttachmentMediaCacheTesting>)mediaCache {
+    return (Class<OSAttachmentMediaCacheTesting>)NSClassFromString(@"OneSignalAttachmentMediaCache");
+}
+
+- (NSString *)downloadedFileWithExtension:(NSString *)extension {
+    NSString *path = [[NSTemporaryDirectory() stringByAppendingPathComponent:[NSUUID UUID].UUIDString] stringByAppendingPathExtension:extension];
+    [[@"media" dataUsingEncoding:NSUTF8StringEncoding] writeToFile:path atomically:YES];
+    return path;
+}
+
+- (void)testCachedMedia_isReusedByURL {
+    NSString *url = [NSString stringWithFormat:@"https://example.com/%@.png", [NSUUID UUID].UUIDString];
+    XCTAssertNil([[self mediaCache] cachedMediaPathForURL:url]);
+
+    NSString *downloadedPath = [self downloadedFileWithExtension:@"png"];
+    [[self mediaCache] cacheMediaAtPath:downloadedPath forURL:url];
+    [[NSFileManager defaultManager] removeItemAtPath:downloadedPath error:nil];
+
+    NSString *cachedPath = [[self mediaCache] cachedMediaPathForURL:url];
+    XCTAssertNotNil(cachedPath);
+    XCTAssertEqualObjects(cachedPath.pathExtension, @"png");
+    XCTAssertEqualObjects([NSString stringWithContentsOfFile:cachedPath encoding:NSUTF8StringEncoding error:nil], @"media");
+    [[NSFileManager defaultManager] removeItemAtPath:cachedPath error:nil];
+}
+
+- (void)testCachedMedia_downloadedTooLongAgo_isNotReused {
+    NSString *url = [NSString stringWithFormat:@"https://example.com/%@.png", [NSUUID UUID].UUIDString];
+    NSString *downloadedPath = [self downloadedFileWithExtension:@"png"];
+    [[self mediaCache] cacheMediaAtPath:downloadedPath forURL:url];
+    [[NSFileManager defaultManager] removeItemAtPath:downloadedPath error:nil];
+    NSString *cachedPath = [[self mediaCache] cachedMediaPathForURL:url];
+    XCTAssertNotNil(cachedPath);
+
+    NSDate *downloaded = [NSDate dateWithTimeIntervalSinceNow:-(MAX_NOTIFICATION_MEDIA_CACHE_AGE_SECONDS + 60)];
+    [[NSFileManager defaultManager] setAttributes:@{NSFileCreationDate : downloaded} ofItemAtPath:cachedPath error:nil];
+
+    XCTAssertNil([[self mediaCache] cachedMediaPathForURL:url]);
+    XCTAssertFalse([[NSFileManager defaultManager] fileExistsAtPath:cachedPath]);
+}
+
+- (void)testDirectDownloadSession_isKeptForTheProcessAndStartsFromTheSharedConfiguration {
+    NSURLSession *session = [(Class<OSDirectDownloadSessionTesting>)NSURLSession.class directDownloadSession];
+    XCTAssertEqual([(Class<OSDirectDownloadSessionTesting>)NSURLSession.class directDownloadSession], session);
+
+    NSURLSessionConfiguration *configuration = session.configuration;
+    XCTAssertEqual(configuration.timeoutIntervalForRequest, OSTuningConfig.sharedConfig.requestTimeout);
+    XCTAssertEqual(configuration.HTTPMaximumConnectionsPerHost, OSTuningConfig.sharedConfig.httpMaxConnectionsPerHost);
+    XCTAssertTrue(configuration.HTTPShouldUsePipelining);
+    // Bounded by the download deadline, with the media cache as the only copy of the media
+    XCTAssertEqual(configuration.timeoutIntervalForResource, MAX_NOTIFICATION_MEDIA_DOWNLOAD_SECONDS);
+    XCTAssertFalse(configuration.waitsForConnectivity);
+    XCTAssertNil(configuration.URLCache);
+}
+
+- (void)testDirectDownloads_lateDownloadsAreCancelled {
+    NSURLSession *session = [NSURLSession sessionWithConfiguration:[NSURLSessionConfiguration ephemeralSessionConfiguration]];
+    id<OSDirectDownloadDelegateTesting> delegate = [NSClassFromString(@"DirectDownloadDelegate") new];
+    NSURL *lateURL = [NSURL URLWithString:@"https://example.com/late.png"];
+    NSURL *otherURL = [NSURL URLWithString:@"https://example.com/other.png"];
+
+    NSURLSessionDownloadTask *lateTask = [session downloadTaskWithURL:lateURL];
+    id<OSDirectDownloadTesting> lateDownload = [NSClassFromString(@"DirectDownload") new];
+    lateDownload.url = lateURL;
+    [delegate addDownload:lateDownload forTask:lateTask];
+
+    NSURLSessionDownloadTask *otherTask = [session downloadTaskWithURL:otherURL];
+    id<OSDirectDownloadTesting> otherDownload = [NSClassFromString(@"DirectDownload") new];
+    otherDownload.url = otherURL;
+    [delegate addDownload:otherDownload forTask:otherTask];
+
+    [delegate cancelDownloadsForURLs:[NSSet setWithObject:lateURL]];
+    XCTAssertEqual(lateTask.state, NSURLSessionTaskStateCanceling);
+    XCTAssertEqual(otherTask.state, NSURLSessionTaskStateSuspended);
+
+    // NSE time running out cancels everything still in flight
+    [delegate cancelDownloadsForURLs:nil];
+    XCTAssertEqual(otherTask.state, NSURLSessionTaskStateCanceling);
+    [session invalidateAndCancel];
+}
+
+- (void)testDirectDownloads_finishedDownloadIsMovedIntoPlaceAndWakesTheWaiter {
+    NSURLSession *session = [NSURLSession sessionWithConfiguration:[NSURLSessionConfiguration ephemeralSessionConfiguration]];
+    id<OSDirectDownloadDelegateTesting> delegate = [NSClassFromString(@"DirectDownloadDelegate") new];
+    NSURLSessionDownloadTask *task = [session downloadTaskWithURL:[NSURL URLWithString:@"https://example.com/media.png"]];
+    id<OSDirectDownloadTesting> download = [NSClassFromString(@"DirectDownload") new];
+    download.localPath = [NSTemporaryDirectory() stringByAppendingPathComponent:[NSUUID UUID].UUIDString];
+    download.semaphore = dispatch_semaphore_create(0);
+    [delegate addDownload:download forTask:task];
+
+    NSString *tempPath = [self downloadedFileWithExtension:@"tmp"];
+    [delegate URLSession:session downloadTask:task didFinishDownloadingToURL:[NSURL fileURLWithPath:tempPath]];
+    XCTAssertFalse([[NSFileManager defaultManager] fileExistsAtPath:tempPath]);
+    XCTAssertEqualObjects([NSString stringWithContentsOfFile:download.localPath encoding:NSUTF8StringEncoding error:nil], @"media");
+
+    XCTAssertNotEqual(dispatch_semaphore_wait(download.semaphore, DISPATCH_TIME_NOW), 0);
+    [delegate URLSession:session task:task didCompleteWithError:nil];
+    XCTAssertEqual(dispatch_semaphore_wait(download.semaphore, DISPATCH_TIME_NOW), 0);
+    XCTAssertNil(download.error);
+
+    [[NSFileManager defaultManager] removeItemAtPath:download.localPath error:nil];
+    [session invalidateAndCancel];
+}
+
+- (NSString *)pngFileWithPixels:(NSInteger)pixels {
+    UIGraphicsImageRendererFormat *format = [UIGraphicsImageRendererFormat defaultFormat];
+    format.scale = 1;
+    UIGraphicsImageRenderer *renderer = [[UIGraphicsImageRenderer alloc] initWithSize:CGSizeMake(pixels, pixels) format:format];
+    NSData *data = [renderer PNGDataWithActions:^(UIGraphicsImageRendererContext *context) {
+        [[UIColor redColor] setFill];
+        [context fillRect:CGRectMake(0, 0, pixels, pixels)];
+    }];
+    NSString *path = [[NSTemporaryDirectory() stringByAppendingPathComponent:[NSUUID UUID].UUIDString] stringByAppendingPathExtension:@"png"];
+    [data writeToFile:path atomically:YES];
+    return path;
+}
+
+- (NSInteger)pixelWidthOfImageAtPath:(NSString *)path {
+    CGImageSourceRef source = CGImageSourceCreateWithURL((__bridge CFURLRef)[NSURL fileURLWithPath:path], NULL);
+    NSDictionary *properties = CFBridgingRelease(CGImageSourceCopyPropertiesAtIndex(source, 0, NULL));
+    CFRelease(source);
+    return [properties[(id)kCGImagePropertyPixelWidth] integerValue];
+}
+
+- (void)testDownsampling_oversizedImageIsReencodedAtTheMaxPixelSize {
+    Class<OSAttachmentDownsamplingTesting> handler = (Class<OSAttachmentDownsamplingTesting>)NSClassFromString(@"OneSignalAttachmentHandler");
+    NSString *path = [self pngFileWithPixels:400];
+
+    [handler downsampleImageAtPath:path toMaxPixelSize:100];
+    XCTAssertEqual([self pixelWidthOfImageAtPath:path], 100);
+    XCTAssertFalse([[NSFileManager defaultManager] fileExistsAtPath:[path stringByAppendingString:@".downsampled"]]);
+
+    // Images already within the limit and a disabled limit leave the file as it is
+    [handler downsampleImageAtPath:path toMaxPixelSize:200];
+    XCTAssertEqual([self pixelWidthOfImageAtPath:path], 100);
+    [handler downsampleImageAtPath:path toMaxPixelSize:0];
+    XCTAssertEqual([self pixelWidthOfImageAtPath:path], 100);
+    [[NSFileManager defaultManager] removeItemAtPath:path error:nil];
+}
+
+@end
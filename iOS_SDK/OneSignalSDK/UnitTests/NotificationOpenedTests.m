@@ -0,0 +1,90 @@
+/**
+ * Modified MIT License
+ *
+ * Copyright 2024 OneSignal
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * 2. All copies of substantial portions of the Software may only be used in connection
+ * with services provided by OneSignal.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#import <XCTest/XCTest.h>
+#import <OneSignalCore/OneSignalCore.h>
+#import <OneSignalNotifications/OneSignalNotifications.h>
+
+@interface OSNotificationsManager (NotificationOpenedTests)
++ (void)handleNotificationOpened:(NSDictionary *)messageDict actionType:(OSNotificationActionType)actionType;
++ (void)lastMessageReceived:(NSDictionary *)message;
+@end
+
+// Records what the open bookkeeping had done when the click was delivered
+@interface OpenOrderClickListener : NSObject <OSNotificationClickListener>
+@property (strong, nonatomic, nullable) NSString *clickedNotificationId;
+@property (strong, nonatomic, nullable) NSString *lastOpenedIdAtClick;
+@end
+
+@implementation OpenOrderClickListener
+
+- (void)onClickNotification:(OSNotificationClickEvent *)event {
+    self.clickedNotificationId = event.notification.notificationId;
+    self.lastOpenedIdAtClick = [OneSignalUserDefaults.initStandard getSavedStringForKey:OSUD_LAST_MESSAGE_OPENED defaultValue:nil];
+}
+
+@end
+
+@interface NotificationOpenedTests : XCTestCase
+
+@end
+
+@implementation NotificationOpenedTests
+
+- (void)setUp {
+    [OSNotificationsManager clearStatics];
+    [OneSignalUserDefaults.initStandard removeValueForKey:OSUD_LAST_MESSAGE_OPENED];
+    [OneSignalUserDefaults.initStandard removeValueForKey:OSUD_PENDING_NOTIFICATION_OPENS];
+}
+
+- (void)tearDown {
+    [self setUp];
+}
+
+- (void)testNotificationOpened_deliversTheClickBeforeSubmittingTheOpen {
+    OpenOrderClickListener *listener = [OpenOrderClickListener new];
+    [OSNotificationsManager addClickListener:listener];
+    NSDictionary *userInfo = @{
+        @"aps" : @{@"alert" : @"Message"},
+        @"custom" : @{@"i" : @"notification_id"}
+    };
+    [OSNotificationsManager lastMessageReceived:userInfo];
+
+    [OSNotificationsManager handleNotificationOpened:userInfo actionType:OSNotificationActionTypeOpened];
+
+    XCTAssertEqualObjects(listener.clickedNotificationId, @"notification_id");
+    XCTAssertNil(listener.lastOpenedIdAtClick);
+
+    // The open is submitted on the next main queue turn
+    [[NSRunLoop mainRunLoop] runUntilDate:[NSDate dateWithTimeIntervalSinceNow:0.1]];
+    XCTAssertEqualObjects([OneSignalUserDefaults.initStandard getSavedStringForKey:OSUD_LAST_MESSAGE_OPENED defaultValue:nil], @"notification_id");
+
+    [OSNotificationsManager removeClickListener:listener];
+}
+
+@end
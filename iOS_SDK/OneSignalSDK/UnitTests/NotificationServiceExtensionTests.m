@@ -0,0 +1,118 @@
+/**
+ * Modified MIT License
+ *
+ * Copyright 2024 OneSignal
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * 2. All copies of substantial portions of the Software may only be used in connection
+ * with services provided by OneSignal.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#import <XCTest/XCTest.h>
+#import <UserNotifications/UserNotifications.h>
+#import <OneSignalCore/OneSignalCore.h>
+#import <OneSignalExtension/OneSignalExtensionBadgeHandler.h>
+
+// OneSignalExtensionStageTimer is internal to OneSignalExtension, so it is reached through the runtime
+@protocol OSExtensionStageTimerTesting
+- (instancetype)initWithBudget:(NSTimeInterval)budget;
+- (void)measureStage:(NSString *)stage block:(void (^)(void))block;
+- (void)saveForNotificationId:(NSString *)notificationId;
+@end
+
+@protocol OSNotificationCategoryControllerTesting
++ (instancetype)sharedInstance;
+- (NSString *)registerNotificationCategoryForNotificationId:(NSString *)notificationId;
+- (NSString *)registeredCategoryIdForActionButtons:(NSArray *)actionButtons;
+- (void)saveCategoryId:(NSString *)categoryId forActionButtons:(NSArray *)actionButtons;
+@end
+
+@interface NotificationServiceExtensionTests : XCTestCase
+
+@end
+
+@implementation NotificationServiceExtensionTests
+
+- (void)setUp {
+    [super setUp];
+    [OneSignalUserDefaults setWriteBehindEnabled:YES];
+}
+
+- (void)tearDown {
+    [OneSignalUserDefaults flushPendingWrites];
+    [OneSignalUserDefaults.initShared removeValueForKey:OSUD_NSE_LAST_STAGE_TIMINGS];
+    [OneSignalUserDefaults.initShared removeValueForKey:SHARED_CATEGORY_LIST];
+    [OneSignalUserDefaults.initShared removeValueForKey:SHARED_CATEGORY_LAYOUTS];
+    [OneSignalUserDefaults flushPendingWrites];
+    [super tearDown];
+}
+
+- (id<OSExtensionStageTimerTesting>)stageTimer {
+    return [(id<OSExtensionStageTimerTesting>)[NSClassFromString(@"OneSignalExtensionStageTimer") alloc] initWithBudget:25];
+}
+
+- (void)testStageTimings_savedAfterAnEarlierFlush_reachStorage {
+    id<OSExtensionStageTimerTesting> timer = [self stageTimer];
+    [timer measureStage:@"badge" block:^{}];
+    [timer saveForNotificationId:@"first"];
+    [OneSignalUserDefaults flushPendingWrites];
+
+    // A second save after the handler's own flush is not left for a delayed flush
+    [timer measureStage:@"receipt_wait" block:^{}];
+    [timer saveForNotificationId:@"second"];
+    [OneSignalUserDefaults discardPendingWrites];
+
+    NSDictionary *saved = [OneSignalUserDefaults.initShared.userDefaults dictionaryForKey:OSUD_NSE_LAST_STAGE_TIMINGS];
+    XCTAssertEqualObjects(saved[@"notification_id"], @"second");
+    XCTAssertNotNil(saved[@"stages_ms"][@"receipt_wait"]);
+}
+
+- (void)testCategories_identicalButtonLayoutReusesTheRegisteredCategory {
+    id<OSNotificationCategoryControllerTesting> controller = [(Class<OSNotificationCategoryControllerTesting>)NSClassFromString(@"OneSignalNotificationCategoryController") sharedInstance];
+    NSArray *buttons = @[@{@"id" : @"open", @"text" : @"Open"}, @{@"id" : @"dismiss", @"text" : @"Dismiss"}];
+    XCTAssertNil([controller registeredCategoryIdForActionButtons:buttons]);
+
+    NSString *categoryId = [controller registerNotificationCategoryForNotificationId:@"notification_1"];
+    [controller saveCategoryId:categoryId forActionButtons:buttons];
+
+    // Same buttons from another notification, with their keys in another order
+    NSArray *sameButtons = @[@{@"text" : @"Open", @"id" : @"open"}, @{@"text" : @"Dismiss", @"id" : @"dismiss"}];
+    XCTAssertEqualObjects([controller registeredCategoryIdForActionButtons:sameButtons], categoryId);
+    XCTAssertNil([controller registeredCategoryIdForActionButtons:@[@{@"id" : @"open", @"text" : @"Open"}]]);
+    XCTAssertNil([controller registeredCategoryIdForActionButtons:[[buttons reverseObjectEnumerator] allObjects]]);
+}
+
+- (void)testBadgeCount_concurrentIncrementsAreAllCounted {
+    [OneSignalExtensionBadgeHandler updateCachedBadgeValue:0];
+    OSNotification *notification = [OSNotification parseWithApns:@{
+        @"aps" : @{@"alert" : @"Body", @"mutable-content" : @1},
+        @"os_data" : @{@"i" : [NSUUID UUID].UUIDString, @"badge_inc" : @1}
+    }];
+    UNNotificationRequest *request = [UNNotificationRequest requestWithIdentifier:[NSUUID UUID].UUIDString content:[UNNotificationContent new] trigger:nil];
+
+    dispatch_apply(50, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^(size_t index) {
+        [OneSignalExtensionBadgeHandler handleBadgeCountWithNotificationRequest:request withNotification:notification withMutableNotificationContent:[UNMutableNotificationContent new]];
+    });
+
+    XCTAssertEqual([OneSignalExtensionBadgeHandler currentCachedBadgeValue], 50);
+    [OneSignalExtensionBadgeHandler updateCachedBadgeValue:0];
+}
+
+@end
@@ -0,0 +1,153 @@
+/**
+ * Modified MIT License
+ *
+ * Copyright 2024 OneSignal
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * 2. All copies of substantial portions of the Software may only be used in connection
+ * with services provided by OneSignal.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#import <XCTest/XCTest.h>
+#import <UIKit/UIKit.h>
+#import <OneSignalCore/OneSignalCore.h>
+#import "OneSignalFramework.h"
+#import "OSStartupScheduler.h"
+#import "OSMigrationController.h"
+
+@interface UIApplication (OneSignalSetup)
++ (void)oneSignalSetup;
++ (BOOL)oneSignalDefersSwizzling;
+@end
+
+@interface OneSignal (StartupTests)
++ (void)clearStatics;
++ (void)setInitializationOptions:(OSInitializationOptions *)options;
++ (void)deferStartupStagesOnScheduler:(OSStartupScheduler *)scheduler;
+@end
+
+// Records the stages init defers instead of running them
+@interface StageRecordingScheduler : OSStartupScheduler
+@property (strong, nonatomic) NSMutableArray<NSString *> *stages;
+@end
+
+@implementation StageRecordingScheduler
+- (void)deferStage:(NSString *)name block:(dispatch_block_t)block {
+    if (!self.stages)
+        self.stages = [NSMutableArray new];
+    [self.stages addObject:name];
+}
+@end
+
+@interface SDKStartupTests : XCTestCase
+
+@end
+
+@implementation SDKStartupTests
+
+- (void)setUp {
+    [OneSignal clearStatics];
+}
+
+- (void)tearDown {
+    [OneSignal clearStatics];
+}
+
+- (NSArray<NSString *> *)deferredStartupStages {
+    StageRecordingScheduler *scheduler = [StageRecordingScheduler new];
+    [OneSignal deferStartupStagesOnScheduler:scheduler];
+    return scheduler.stages;
+}
+
+- (void)testStartupScheduler_runsDeferredStagesAfterTheCurrentPassInOrder {
+    OSStartupScheduler *scheduler = [OSStartupScheduler new];
+    NSMutableArray<NSString *> *ran = [NSMutableArray new];
+    [scheduler deferStage:@"first" block:^{ [ran addObject:@"first"]; }];
+    [scheduler deferStage:@"second" block:^{ [ran addObject:@"second"]; }];
+    XCTAssertEqual(ran.count, 0);
+
+    NSDate *timeout = [NSDate dateWithTimeIntervalSinceNow:2];
+    while (ran.count < 2 && [timeout timeIntervalSinceNow] > 0)
+        [[NSRunLoop mainRunLoop] runMode:NSDefaultRunLoopMode beforeDate:[NSDate dateWithTimeIntervalSinceNow:0.05]];
+    XCTAssertEqualObjects(ran, (@[@"first", @"second"]));
+}
+
+- (void)testStartupScheduler_stageDeferredFromABackgroundThreadRunsOnMain {
+    OSStartupScheduler *scheduler = [OSStartupScheduler new];
+    XCTestExpectation *ran = [self expectationWithDescription:@"stage ran"];
+    dispatch_async(dispatch_get_global_queue(QOS_CLASS_UTILITY, 0), ^{
+        [scheduler deferStage:@"background" block:^{
+            XCTAssertTrue(NSThread.isMainThread);
+            [ran fulfill];
+        }];
+    });
+    [self waitForExpectations:@[ran] timeout:2];
+}
+
+- (void)testSwizzling_isInstalledFromLoadUnlessTheAppOptsIntoDeferring {
+    XCTAssertNil([[NSBundle mainBundle] objectForInfoDictionaryKey:@"OneSignal_defer_swizzling"]);
+    XCTAssertFalse([UIApplication oneSignalDefersSwizzling]);
+    // Init calls the setup again, it only ever runs once
+    XCTAssertNoThrow([UIApplication oneSignalSetup]);
+}
+
+- (void)testMigration_savesTheSDKVersionOnUpgradesAfterTheSchemaIsCurrent {
+    OneSignalUserDefaults *sharedUserDefaults = OneSignalUserDefaults.initShared;
+    [[OSMigrationController new] migrate];
+    XCTAssertEqual([sharedUserDefaults getSavedIntegerForKey:OSUD_CACHED_SDK_VERSION defaultValue:0], [[OneSignal sdkVersionRaw] intValue]);
+
+    // An upgrade from an older SDK that already had the current storage schema
+    [sharedUserDefaults saveIntegerForKey:OSUD_CACHED_SDK_VERSION withValue:30700];
+    [[OSMigrationController new] migrate];
+    XCTAssertEqual([sharedUserDefaults getSavedIntegerForKey:OSUD_CACHED_SDK_VERSION defaultValue:0], [[OneSignal sdkVersionRaw] intValue]);
+}
+
+- (void)testDefaultInitialization_defersEveryStartupStage {
+    NSArray<NSString *> *everyStage = @[@"location", @"track_iap", @"track_firebase_analytics", @"live_activities", @"in_app_messages", @"new_session"];
+    [OneSignal setInitializationOptions:nil];
+    XCTAssertEqualObjects([self deferredStartupStages], everyStage);
+
+    // Every module is enabled by default
+    [OneSignal setInitializationOptions:[OSInitializationOptions new]];
+    XCTAssertEqualObjects([self deferredStartupStages], everyStage);
+    XCTAssertFalse([OSModuleRegistry isModuleDisabled:OSModuleInAppMessages]);
+    XCTAssertFalse([OSModuleRegistry isModuleDisabled:OSModuleLocation]);
+    XCTAssertFalse([OSModuleRegistry isModuleDisabled:OSModuleLiveActivities]);
+}
+
+- (void)testDisabledModules_getNoStartupStageAndAreNotLookedUp {
+    OSInitializationOptions *options = [OSInitializationOptions new];
+    options.inAppMessagesEnabled = NO;
+    options.locationEnabled = NO;
+    options.liveActivitiesEnabled = NO;
+    options.firebaseAnalyticsEnabled = NO;
+    [OneSignal setInitializationOptions:options];
+
+    XCTAssertEqualObjects([self deferredStartupStages], (@[@"track_iap", @"new_session"]));
+    XCTAssertNil([OSModuleRegistry classForModule:OSModuleInAppMessages]);
+    XCTAssertNil([OSModuleRegistry classForModule:OSModuleLocation]);
+    XCTAssertNil([OSModuleRegistry classForModule:OSModuleLiveActivities]);
+
+    // The options are only read once, modules that were disabled stay disabled
+    [OneSignal setInitializationOptions:[OSInitializationOptions new]];
+    XCTAssertEqualObjects([self deferredStartupStages], (@[@"track_iap", @"new_session"]));
+}
+
+@end
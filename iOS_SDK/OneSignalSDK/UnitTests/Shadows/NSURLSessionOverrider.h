@@ -27,6 +27,9 @@
 
 #import <Foundation/Foundation.h>
 
+// Media URLs on this host are served as a PNG of `px` by `px` pixels, such as https://nse-stub.onesignal.test/image.png?px=512
+#define NSE_STUB_MEDIA_HOST @"nse-stub.onesignal.test"
+
 @interface NSURLSessionOverrider : NSObject
 
 @end
@@ -25,6 +25,7 @@
  * THE SOFTWARE.
  */
 
+#import <UIKit/UIKit.h>
 #import "NSURLSessionOverrider.h"
 #import "OneSignalSelectorHelpers.h"
 #import "TestHelperFunctions.h"
@@ -48,8 +49,41 @@
    );
 }
 
+// Real PNG data for the stub media host, rendered once per size
++ (NSData *)stubImageDataWithPixels:(NSInteger)pixels {
+    static NSMutableDictionary<NSNumber *, NSData *> *imageData;
+    static dispatch_once_t once;
+    dispatch_once(&once, ^{
+        imageData = [NSMutableDictionary new];
+    });
+    @synchronized (imageData) {
+        if (!imageData[@(pixels)]) {
+            UIGraphicsImageRendererFormat *format = [UIGraphicsImageRendererFormat defaultFormat];
+            format.scale = 1;
+            UIGraphicsImageRenderer *renderer = [[UIGraphicsImageRenderer alloc] initWithSize:CGSizeMake(pixels, pixels) format:format];
+            imageData[@(pixels)] = [renderer PNGDataWithActions:^(UIGraphicsImageRendererContext *context) {
+                // A gradient of rectangles, so the PNG does not compress to nearly nothing
+                for (NSInteger row = 0; row < pixels; row += 8) {
+                    [[UIColor colorWithHue:(CGFloat)row / pixels saturation:0.8 brightness:0.9 alpha:1] setFill];
+                    [context fillRect:CGRectMake(0, row, pixels, 8)];
+                }
+            }];
+        }
+        return imageData[@(pixels)];
+    }
+}
+
 // Override downloading of media attachment
 + (NSString *)overrideDownloadItemAtURL:(NSURL*)url toFile:(NSString*)localPath error:(NSError**)error {
+    if ([url.host isEqualToString:NSE_STUB_MEDIA_HOST]) {
+        NSInteger pixels = 64;
+        for (NSURLQueryItem *item in [NSURLComponents componentsWithURL:url resolvingAgainstBaseURL:NO].queryItems) {
+            if ([item.name isEqualToString:@"px"])
+                pixels = MAX(item.value.integerValue, 1);
+        }
+        [[NSFileManager defaultManager] createFileAtPath:localPath contents:[self stubImageDataWithPixels:pixels] attributes:nil];
+        return @"image/png";
+    }
     NSString *content = @"File Contents";
     NSData *fileContents = [content dataUsingEncoding:NSUTF8StringEncoding];
     [[NSFileManager defaultManager] createFileAtPath:localPath
@@ -28,18 +28,19 @@
 #import <Foundation/Foundation.h>
 #import "OSInAppMessageInternal.h"
 #import "OSMessagingController.h"
+#import "OSInAppMessageRedisplayStore.h"
 
 NS_ASSUME_NONNULL_BEGIN
 
 @interface OSMessagingControllerOverrider : NSObject
 
 + (void)dismissCurrentMessage;
-+ (void)setMessagesForRedisplay:(NSMutableDictionary <NSString *, OSInAppMessageInternal *> *)messagesForRedisplay;
++ (void)setMessagesForRedisplay:(NSArray <OSInAppMessageInternal *> *)messagesForRedisplay;
 + (void)setSeenMessages:(NSMutableSet <NSString *> *)seenMessages;
 + (void)setMockDateGenerator:(NSTimeInterval(^)(void))testDateGenerator;
 + (BOOL)isInAppMessageShowing;
 + (NSArray <OSInAppMessageInternal *> *)messageDisplayQueue;
-+ (NSMutableDictionary <NSString *, OSInAppMessageInternal *> *)messagesForRedisplay;
++ (OSInAppMessageRedisplayStore *)redisplayStore;
 
 @end
 
@@ -51,7 +52,7 @@ NS_ASSUME_NONNULL_BEGIN
 - (void)messageViewControllerWasDismissed:(OSInAppMessageInternal *)message displayed:(BOOL)displayed;
 - (void)setLastTimeGenerator:(NSTimeInterval(^)(void))dateGenerator;
 - (NSArray<OSInAppMessageInternal *> *)getInAppMessages;
-- (NSMutableDictionary <NSString *, OSInAppMessageInternal *> *)getRedisplayedInAppMessages;
+- (OSInAppMessageRedisplayStore *)getRedisplayStore;
 - (NSMutableArray<OSInAppMessageInternal *> *)getDisplayedMessages;
 - (void)onWillDisplayInAppMessage:(OSInAppMessageInternal *)message;
 - (void)onDidDisplayInAppMessage:(OSInAppMessageInternal *)message;
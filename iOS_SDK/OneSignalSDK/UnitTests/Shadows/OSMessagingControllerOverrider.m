@@ -27,6 +27,7 @@
 
 #import "OSMessagingControllerOverrider.h"
 #import "OSMessagingController.h"
+#import "OSInAppMessageStateStore.h"
 #import "OneSignalSelectorHelpers.h"
 #import "TestHelperFunctions.h"
 #import "NSTimerOverrider.h"
@@ -40,10 +41,9 @@
 @interface OSMessagingController ()
 @property (strong, nonatomic, nonnull) NSArray <OSInAppMessageInternal *> *messages;
 @property (strong, nonatomic, nonnull) OSTriggerController *triggerController;
-@property (strong, nonatomic, nonnull) NSMutableSet <NSString *> *seenInAppMessages;
+@property (strong, nonatomic, nonnull) OSInAppMessageStateStore *stateStore;
 @property (strong, nonatomic, nonnull) NSMutableArray <OSInAppMessageInternal *> *messageDisplayQueue;
-@property (strong, nonatomic, nonnull) NSMutableDictionary <NSString *, OSInAppMessageInternal *> *redisplayedInAppMessages;
-@property (strong, nonatomic, nonnull) NSMutableSet <NSString *> *clickedClickIds;
+@property (strong, nonatomic, nonnull) OSInAppMessageRedisplayStore *redisplayStore;
 @property (nonatomic, readwrite) NSTimeInterval (^dateGenerator)(void);
 @property (nonatomic, nullable) NSObject<OSInAppMessagePrompt>*currentPromptAction;
 @end
@@ -55,11 +55,11 @@
 #pragma clang diagnostic pop
 - (void)resetState {
     self.messages = @[];
-    self.redisplayedInAppMessages = [NSMutableDictionary new];
+    [self.redisplayStore removeRecordsDisplayedBefore:DBL_MAX];
     self.triggerController = [OSTriggerController new];
     self.triggerController.delegate = self;
     self.messageDisplayQueue = [NSMutableArray new];
-    self.clickedClickIds = [NSMutableSet new];
+    [self.stateStore removeAllIdsFromSet:OSInAppMessageStateSetClicked];
     self.isInAppMessageShowing = false;
     self.currentPromptAction = nil;
 }
@@ -72,8 +72,8 @@
     return self.messages;
 }
 
-- (NSMutableDictionary <NSString *, OSInAppMessageInternal *> *)getRedisplayedInAppMessages {
-    return self.redisplayedInAppMessages;
+- (OSInAppMessageRedisplayStore *)getRedisplayStore {
+    return self.redisplayStore;
 }
 
 - (NSMutableArray<OSInAppMessageInternal *> *)getDisplayedMessages {
@@ -128,16 +128,22 @@
     return [OSMessagingController.sharedInstance getDisplayedMessages];
 }
 
-+ (NSMutableDictionary <NSString *, OSInAppMessageInternal *> *)messagesForRedisplay {
-    return [OSMessagingController.sharedInstance getRedisplayedInAppMessages];
++ (OSInAppMessageRedisplayStore *)redisplayStore {
+    return [OSMessagingController.sharedInstance getRedisplayStore];
 }
 
-+ (void)setMessagesForRedisplay:(NSMutableDictionary <NSString *, OSInAppMessageInternal *> *)messagesForRedisplay {
-    [OSMessagingController.sharedInstance setRedisplayedInAppMessages:messagesForRedisplay];
++ (void)setMessagesForRedisplay:(NSArray <OSInAppMessageInternal *> *)messagesForRedisplay {
+    for (OSInAppMessageInternal *message in messagesForRedisplay) {
+        [[OSMessagingController.sharedInstance getRedisplayStore] setDisplayQuantity:message.displayStats.displayQuantity lastDisplayTime:message.displayStats.lastDisplayTime forMessageId:message.messageId];
+    }
 }
 
 + (void)setSeenMessages:(NSMutableSet <NSString *> *)seenMessages {
-    [OSMessagingController.sharedInstance setSeenInAppMessages:seenMessages];
+    OSInAppMessageStateStore *stateStore = OSMessagingController.sharedInstance.stateStore;
+    [stateStore removeAllIdsFromSet:OSInAppMessageStateSetSeen];
+    for (NSString *messageId in seenMessages) {
+        [stateStore addId:messageId toSet:OSInAppMessageStateSetSeen];
+    }
 }
 
 + (void)setMockDateGenerator:(NSTimeInterval (^)(void))testDateGenerator {
@@ -0,0 +1,147 @@
+/**
+ * Modified MIT License
+ *
+ * Copyright 2024 OneSignal
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * 2. All copies of substantial portions of the Software may only be used in connection
+ * with services provided by OneSignal.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#import <XCTest/XCTest.h>
+#import "OneSignalTrackIAP.h"
+
+@interface OneSignalTrackIAP (TrackIAPTests)
+- (void)paymentQueue:(id)queue updatedTransactions:(NSArray*)transactions;
+- (void)productsRequest:(id)request didReceiveResponse:(id)response;
+- (void)getProductInfo:(NSSet<NSString *>*)productIdentifiers;
+- (void)sendPurchases:(NSArray *)purchases;
+@end
+
+// Stand-ins for the StoreKit objects, OneSignalTrackIAP only reads them through performSelector
+@interface FakePayment : NSObject
+@property (nonatomic) NSString *productIdentifier;
+@property (nonatomic) NSInteger quantity;
+@end
+@implementation FakePayment
+@end
+
+@interface FakeTransaction : NSObject
+@property (nonatomic) NSInteger transactionState;
+@property (nonatomic) FakePayment *payment;
+@end
+@implementation FakeTransaction
+@end
+
+@interface FakeProduct : NSObject
+@property (nonatomic) NSString *productIdentifier;
+@property (nonatomic) NSDecimalNumber *price;
+@property (nonatomic) NSLocale *priceLocale;
+@end
+@implementation FakeProduct
+@end
+
+@interface FakeProductsResponse : NSObject
+@property (nonatomic) NSArray<FakeProduct *> *products;
+@end
+@implementation FakeProductsResponse
+@end
+
+// Records the price lookups and purchases instead of calling StoreKit and the user module
+@interface RecordingTrackIAP : OneSignalTrackIAP
+@property (nonatomic) NSMutableArray<NSSet<NSString *> *> *requests;
+@property (nonatomic) NSMutableArray<NSArray *> *sent;
+@end
+@implementation RecordingTrackIAP
+- (id)init {
+    if (self = [super init]) {
+        _requests = [NSMutableArray new];
+        _sent = [NSMutableArray new];
+    }
+    return self;
+}
+- (void)getProductInfo:(NSSet<NSString *>*)productIdentifiers {
+    [self.requests addObject:productIdentifiers];
+}
+- (void)sendPurchases:(NSArray *)purchases {
+    [self.sent addObject:purchases];
+}
+@end
+
+@interface TrackIAPTests : XCTestCase
+
+@end
+
+@implementation TrackIAPTests
+
+static const NSInteger SKPaymentTransactionStatePurchased = 1;
+static const NSInteger SKPaymentTransactionStateRestored = 3;
+
+- (FakeTransaction *)transactionOf:(NSString *)sku quantity:(NSInteger)quantity state:(NSInteger)state {
+    FakePayment *payment = [FakePayment new];
+    payment.productIdentifier = sku;
+    payment.quantity = quantity;
+    FakeTransaction *transaction = [FakeTransaction new];
+    transaction.transactionState = state;
+    transaction.payment = payment;
+    return transaction;
+}
+
+- (FakeProductsResponse *)responseWithProduct:(NSString *)sku {
+    FakeProduct *product = [FakeProduct new];
+    product.productIdentifier = sku;
+    product.price = [NSDecimalNumber decimalNumberWithString:@"1.99"];
+    product.priceLocale = [NSLocale localeWithLocaleIdentifier:@"en_US"];
+    FakeProductsResponse *response = [FakeProductsResponse new];
+    response.products = @[product];
+    return response;
+}
+
+- (void)testPurchases_areBatchedAndPricesLookedUpOnce {
+    RecordingTrackIAP *tracker = [RecordingTrackIAP new];
+
+    [tracker paymentQueue:nil updatedTransactions:@[
+        [self transactionOf:@"gems" quantity:1 state:SKPaymentTransactionStatePurchased],
+        [self transactionOf:@"coins" quantity:1 state:SKPaymentTransactionStateRestored],
+        [self transactionOf:@"gems" quantity:2 state:SKPaymentTransactionStatePurchased]
+    ]];
+    XCTAssertEqualObjects(tracker.requests, (@[[NSSet setWithObject:@"gems"]]));
+    XCTAssertEqual(tracker.sent.count, 0);
+
+    // Bought while the lookup is in flight, it waits for it instead of starting another
+    [tracker paymentQueue:nil updatedTransactions:@[[self transactionOf:@"lives" quantity:1 state:SKPaymentTransactionStatePurchased]]];
+    XCTAssertEqual(tracker.requests.count, 1);
+
+    [tracker productsRequest:nil didReceiveResponse:[self responseWithProduct:@"gems"]];
+    XCTAssertEqual(tracker.sent.count, 1);
+    XCTAssertEqualObjects(tracker.sent[0][0][@"sku"], @"gems");
+    XCTAssertEqualObjects(tracker.sent[0][0][@"count"], @3);
+    XCTAssertEqualObjects(tracker.sent[0][0][@"iso"], @"USD");
+    XCTAssertEqualObjects(tracker.requests.lastObject, [NSSet setWithObject:@"lives"]);
+
+    // The price is known now, so another purchase is sent right away
+    [tracker paymentQueue:nil updatedTransactions:@[[self transactionOf:@"gems" quantity:1 state:SKPaymentTransactionStatePurchased]]];
+    XCTAssertEqual(tracker.requests.count, 2);
+    XCTAssertEqual(tracker.sent.count, 2);
+    XCTAssertEqualObjects(tracker.sent[1][0][@"sku"], @"gems");
+    XCTAssertNil(tracker.sent[1][0][@"count"]);
+}
+
+@end
@@ -0,0 +1,95 @@
+/**
+ * Modified MIT License
+ *
+ * Copyright 2024 OneSignal
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * 1. The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * 2. All copies of substantial portions of the Software may only be used in connection
+ * with services provided by OneSignal.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+
+#import <XCTest/XCTest.h>
+#import <OneSignalCore/OneSignalCore.h>
+#import "OSOutcomeEventsCache.h"
+#import "OSCachedUniqueOutcome.h"
+
+@interface UniqueOutcomesCacheTests : XCTestCase
+
+@end
+
+@implementation UniqueOutcomesCacheTests
+
+- (void)setUp {
+    [OneSignalUserDefaults.initShared removeValueForKey:OSUD_CACHED_ATTRIBUTED_UNIQUE_OUTCOME_EVENT_NOTIFICATION_IDS_SENT];
+}
+
+- (void)tearDown {
+    [self setUp];
+}
+
+- (OSCachedUniqueOutcome *)outcomeWithId:(NSString *)uniqueId secondsAgo:(NSTimeInterval)secondsAgo {
+    NSNumber *timestamp = @([[NSDate date] timeIntervalSince1970] - secondsAgo);
+    return [[OSCachedUniqueOutcome alloc] initWithParamsName:@"purchase" uniqueId:uniqueId timestamp:timestamp channel:NOTIFICATION];
+}
+
+- (void)testAttributedUniqueOutcome_isFoundByNameIdAndChannel {
+    OSOutcomeEventsCache *cache = [OSOutcomeEventsCache new];
+
+    [cache addAttributedUniqueOutcomes:@[[self outcomeWithId:@"notification_1" secondsAgo:60]]];
+
+    XCTAssertTrue([cache containsAttributedUniqueOutcome:[self outcomeWithId:@"notification_1" secondsAgo:0]]);
+    XCTAssertFalse([cache containsAttributedUniqueOutcome:[self outcomeWithId:@"notification_2" secondsAgo:0]]);
+    OSCachedUniqueOutcome *otherChannel = [[OSCachedUniqueOutcome alloc] initWithParamsName:@"purchase" uniqueId:@"notification_1" channel:IN_APP_MESSAGE];
+    XCTAssertFalse([cache containsAttributedUniqueOutcome:otherChannel]);
+
+    // Another launch reads what was saved
+    XCTAssertTrue([[OSOutcomeEventsCache new] containsAttributedUniqueOutcome:[self outcomeWithId:@"notification_1" secondsAgo:0]]);
+}
+
+- (void)testAttributedUniqueOutcomes_expireAfterTheWindow {
+    [OneSignalUserDefaults.initShared saveCodeableDataForKey:OSUD_CACHED_ATTRIBUTED_UNIQUE_OUTCOME_EVENT_NOTIFICATION_IDS_SENT withValue:@[
+        [self outcomeWithId:@"expired" secondsAgo:OS_UNIQUE_OUTCOMES_WINDOW + 60],
+        [self outcomeWithId:@"recent" secondsAgo:60]
+    ]];
+    OSOutcomeEventsCache *cache = [OSOutcomeEventsCache new];
+
+    [cache removeExpiredAttributedUniqueOutcomes];
+
+    XCTAssertFalse([cache containsAttributedUniqueOutcome:[self outcomeWithId:@"expired" secondsAgo:0]]);
+    XCTAssertTrue([cache containsAttributedUniqueOutcome:[self outcomeWithId:@"recent" secondsAgo:0]]);
+    NSArray *saved = [OneSignalUserDefaults.initShared getSavedCodeableDataForKey:OSUD_CACHED_ATTRIBUTED_UNIQUE_OUTCOME_EVENT_NOTIFICATION_IDS_SENT defaultValue:nil];
+    XCTAssertEqual(saved.count, 1);
+}
+
+- (void)testAttributedUniqueOutcomes_areCappedDroppingTheOldest {
+    OSOutcomeEventsCache *cache = [OSOutcomeEventsCache new];
+    NSMutableArray<OSCachedUniqueOutcome *> *outcomes = [NSMutableArray new];
+    for (int i = 0; i <= OS_UNIQUE_OUTCOMES_LIMIT; i++)
+        [outcomes addObject:[self outcomeWithId:[NSString stringWithFormat:@"notification_%d", i] secondsAgo:OS_UNIQUE_OUTCOMES_LIMIT - i]];
+
+    [cache addAttributedUniqueOutcomes:outcomes];
+
+    XCTAssertEqual([cache getAttributedUniqueOutcomeEventSent].count, OS_UNIQUE_OUTCOMES_LIMIT);
+    XCTAssertFalse([cache containsAttributedUniqueOutcome:outcomes.firstObject]);
+    XCTAssertTrue([cache containsAttributedUniqueOutcome:outcomes.lastObject]);
+}
+
+@end